@@ -8,17 +8,24 @@
  */
 
 #include "lrg-behavior-tree.h"
+#include "lrg-bt-program-private.h"
 
 #define LRG_LOG_DOMAIN LRG_LOG_DOMAIN_AI
 #include "lrg-log.h"
 
+/* Smaller batches are not worth handing to worker threads */
+#define PARALLEL_MIN_TREES 64
+
 struct _LrgBehaviorTree
 {
-    GObject        parent_instance;
+    GObject            parent_instance;
+
+    LrgBTNode         *root;
+    LrgBlackboard     *blackboard;
+    LrgBTStatus        status;
 
-    LrgBTNode     *root;
-    LrgBlackboard *blackboard;
-    LrgBTStatus    status;
+    LrgBTProgram      *program;
+    LrgBTProgramState  program_state;
 };
 
 #pragma GCC visibility push(default)
@@ -31,6 +38,7 @@ enum
     PROP_ROOT,
     PROP_BLACKBOARD,
     PROP_STATUS,
+    PROP_PROGRAM,
     N_PROPS
 };
 
@@ -51,6 +59,8 @@ lrg_behavior_tree_finalize (GObject *object)
 
     g_clear_object (&self->root);
     g_clear_object (&self->blackboard);
+    g_clear_object (&self->program);
+    lrg_bt_program_state_clear (&self->program_state);
 
     G_OBJECT_CLASS (lrg_behavior_tree_parent_class)->finalize (object);
 }
@@ -77,6 +87,10 @@ lrg_behavior_tree_get_property (GObject    *object,
         g_value_set_enum (value, self->status);
         break;
 
+    case PROP_PROGRAM:
+        g_value_set_object (value, self->program);
+        break;
+
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -96,6 +110,10 @@ lrg_behavior_tree_set_property (GObject      *object,
         lrg_behavior_tree_set_root (self, g_value_get_object (value));
         break;
 
+    case PROP_PROGRAM:
+        lrg_behavior_tree_set_program (self, g_value_get_object (value));
+        break;
+
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -147,6 +165,18 @@ lrg_behavior_tree_class_init (LrgBehaviorTreeClass *klass)
                            LRG_BT_STATUS_INVALID,
                            G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+    /**
+     * LrgBehaviorTree:program:
+     *
+     * The compiled program the tree runs, if any.
+     */
+    properties[PROP_PROGRAM] =
+        g_param_spec_object ("program",
+                             "Program",
+                             "Compiled program the tree runs",
+                             LRG_TYPE_BT_PROGRAM,
+                             G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
     g_object_class_install_properties (object_class, N_PROPS, properties);
 
     /**
@@ -203,6 +233,25 @@ lrg_behavior_tree_new_with_root (LrgBTNode *root)
                          NULL);
 }
 
+/**
+ * lrg_behavior_tree_new_from_program:
+ * @program: (transfer none): A compiled program
+ *
+ * Creates a new behavior tree that runs @program, with its own
+ * blackboard and node state.
+ *
+ * Returns: (transfer full): A new #LrgBehaviorTree
+ */
+LrgBehaviorTree *
+lrg_behavior_tree_new_from_program (LrgBTProgram *program)
+{
+    g_return_val_if_fail (LRG_IS_BT_PROGRAM (program), NULL);
+
+    return g_object_new (LRG_TYPE_BEHAVIOR_TREE,
+                         "program", program,
+                         NULL);
+}
+
 /**
  * lrg_behavior_tree_get_root:
  * @self: an #LrgBehaviorTree
@@ -239,6 +288,13 @@ lrg_behavior_tree_set_root (LrgBehaviorTree *self,
         self->root = root ? g_object_ref (root) : NULL;
         self->status = LRG_BT_STATUS_INVALID;
 
+        if (self->program != NULL)
+        {
+            g_clear_object (&self->program);
+            lrg_bt_program_state_clear (&self->program_state);
+            g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PROGRAM]);
+        }
+
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_ROOT]);
     }
 }
@@ -259,6 +315,111 @@ lrg_behavior_tree_get_blackboard (LrgBehaviorTree *self)
     return self->blackboard;
 }
 
+/**
+ * lrg_behavior_tree_get_program:
+ * @self: an #LrgBehaviorTree
+ *
+ * Gets the compiled program the tree runs.
+ *
+ * Returns: (transfer none) (nullable): The program
+ */
+LrgBTProgram *
+lrg_behavior_tree_get_program (LrgBehaviorTree *self)
+{
+    g_return_val_if_fail (LRG_IS_BEHAVIOR_TREE (self), NULL);
+
+    return self->program;
+}
+
+/**
+ * lrg_behavior_tree_set_program:
+ * @self: an #LrgBehaviorTree
+ * @program: (nullable) (transfer none): A compiled program
+ *
+ * Makes the tree run @program from its initial state.
+ */
+void
+lrg_behavior_tree_set_program (LrgBehaviorTree *self,
+                               LrgBTProgram    *program)
+{
+    LrgBTNode *root;
+
+    g_return_if_fail (LRG_IS_BEHAVIOR_TREE (self));
+    g_return_if_fail (program == NULL || LRG_IS_BT_PROGRAM (program));
+
+    if (self->program == program)
+        return;
+
+    g_clear_object (&self->program);
+    lrg_bt_program_state_clear (&self->program_state);
+
+    if (program != NULL)
+    {
+        self->program = g_object_ref (program);
+        lrg_bt_program_state_init (program, &self->program_state);
+
+        root = lrg_bt_program_get_root (program);
+        if (self->root != root)
+        {
+            g_set_object (&self->root, root);
+            g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_ROOT]);
+        }
+    }
+
+    self->status = LRG_BT_STATUS_INVALID;
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PROGRAM]);
+}
+
+/**
+ * lrg_behavior_tree_compile:
+ * @self: an #LrgBehaviorTree
+ *
+ * Compiles the root node into an #LrgBTProgram and runs that from
+ * now on.
+ */
+void
+lrg_behavior_tree_compile (LrgBehaviorTree *self)
+{
+    g_autoptr(LrgBTProgram) program = NULL;
+
+    g_return_if_fail (LRG_IS_BEHAVIOR_TREE (self));
+    g_return_if_fail (self->root != NULL);
+
+    program = lrg_bt_program_new (self->root);
+    lrg_behavior_tree_set_program (self, program);
+}
+
+/*
+ * Runs one tick without emitting anything, so it is safe on a worker
+ * thread. finish_tick() emits afterwards.
+ */
+static LrgBTStatus
+run_tick (LrgBehaviorTree *self,
+          gfloat           delta_time)
+{
+    if (self->program != NULL)
+    {
+        return lrg_bt_program_tick (self->program, &self->program_state,
+                                    self->blackboard, delta_time);
+    }
+
+    return lrg_bt_node_tick (self->root, self->blackboard, delta_time);
+}
+
+static void
+finish_tick (LrgBehaviorTree *self,
+             LrgBTStatus      prev_status)
+{
+    if (self->status == prev_status)
+        return;
+
+    /* Emit completed signal when tree finishes */
+    if (prev_status == LRG_BT_STATUS_RUNNING)
+        g_signal_emit (self, signals[SIGNAL_COMPLETED], 0, self->status);
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STATUS]);
+}
+
 /**
  * lrg_behavior_tree_tick:
  * @self: an #LrgBehaviorTree
@@ -280,18 +441,107 @@ lrg_behavior_tree_tick (LrgBehaviorTree *self,
         return LRG_BT_STATUS_FAILURE;
 
     prev_status = self->status;
-    self->status = lrg_bt_node_tick (self->root, self->blackboard, delta_time);
+    self->status = run_tick (self, delta_time);
+    finish_tick (self, prev_status);
 
-    /* Emit completed signal when tree finishes */
-    if (prev_status == LRG_BT_STATUS_RUNNING &&
-        self->status != LRG_BT_STATUS_RUNNING)
+    return self->status;
+}
+
+typedef struct
+{
+    LrgBehaviorTree * const *trees;
+    gfloat                   delta_time;
+    guint                    first;
+    guint                    last;
+} TickBatchChunk;
+
+static void
+tick_batch_chunk (gpointer data,
+                  gpointer user_data)
+{
+    TickBatchChunk *chunk = data;
+    guint i;
+
+    for (i = chunk->first; i < chunk->last; i++)
     {
-        g_signal_emit (self, signals[SIGNAL_COMPLETED], 0, self->status);
+        LrgBehaviorTree *tree = chunk->trees[i];
+
+        if (tree->program != NULL && lrg_bt_program_is_shareable (tree->program))
+            tree->status = run_tick (tree, chunk->delta_time);
     }
+}
 
-    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STATUS]);
+/**
+ * lrg_behavior_tree_tick_batch:
+ * @trees: (array length=n_trees): Distinct behavior trees
+ * @n_trees: Number of trees
+ * @delta_time: Time since last tick
+ * @max_threads: Worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Ticks every tree, splitting large batches across worker threads.
+ * Signals and notifications are emitted on the calling thread once
+ * all trees have ticked.
+ */
+void
+lrg_behavior_tree_tick_batch (LrgBehaviorTree * const *trees,
+                              guint                    n_trees,
+                              gfloat                   delta_time,
+                              guint                    max_threads)
+{
+    g_autofree TickBatchChunk *chunks = NULL;
+    g_autofree LrgBTStatus *prev_status = NULL;
+    GThreadPool *pool = NULL;
+    guint n_chunks;
+    guint threads;
+    guint i;
 
-    return self->status;
+    g_return_if_fail (n_trees == 0 || trees != NULL);
+
+    for (i = 0; i < n_trees; i++)
+        g_return_if_fail (LRG_IS_BEHAVIOR_TREE (trees[i]));
+
+    prev_status = g_new (LrgBTStatus, n_trees);
+    for (i = 0; i < n_trees; i++)
+        prev_status[i] = trees[i]->status;
+
+    threads = max_threads != 0 ? max_threads : g_get_num_processors ();
+    n_chunks = n_trees < PARALLEL_MIN_TREES ? 1 : MIN (threads, n_trees);
+    n_chunks = MAX (n_chunks, 1);
+
+    chunks = g_new (TickBatchChunk, n_chunks);
+    for (i = 0; i < n_chunks; i++)
+    {
+        chunks[i].trees = trees;
+        chunks[i].delta_time = delta_time;
+        chunks[i].first = (guint)((guint64)n_trees * i / n_chunks);
+        chunks[i].last = (guint)((guint64)n_trees * (i + 1) / n_chunks);
+    }
+
+    if (n_chunks > 1)
+    {
+        pool = g_thread_pool_new (tick_batch_chunk, NULL, (gint)n_chunks - 1, FALSE, NULL);
+        for (i = 1; i < n_chunks; i++)
+            g_thread_pool_push (pool, &chunks[i], NULL);
+    }
+
+    tick_batch_chunk (&chunks[0], NULL);
+
+    if (pool != NULL)
+        g_thread_pool_free (pool, FALSE, TRUE);
+
+    /* Trees that may share node objects tick here, one at a time */
+    for (i = 0; i < n_trees; i++)
+    {
+        LrgBehaviorTree *tree = trees[i];
+
+        if (tree->root != NULL &&
+            (tree->program == NULL || !lrg_bt_program_is_shareable (tree->program)))
+            tree->status = run_tick (tree, delta_time);
+    }
+
+    for (i = 0; i < n_trees; i++)
+        finish_tick (trees[i], prev_status[i]);
 }
 
 /**
@@ -305,11 +555,16 @@ lrg_behavior_tree_reset (LrgBehaviorTree *self)
 {
     g_return_if_fail (LRG_IS_BEHAVIOR_TREE (self));
 
-    if (self->root)
+    if (self->program)
+        lrg_bt_program_reset (self->program, &self->program_state);
+    else if (self->root)
         lrg_bt_node_reset (self->root);
 
-    self->status = LRG_BT_STATUS_INVALID;
-    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STATUS]);
+    if (self->status != LRG_BT_STATUS_INVALID)
+    {
+        self->status = LRG_BT_STATUS_INVALID;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STATUS]);
+    }
 }
 
 /**
@@ -323,9 +578,24 @@ lrg_behavior_tree_abort (LrgBehaviorTree *self)
 {
     g_return_if_fail (LRG_IS_BEHAVIOR_TREE (self));
 
-    if (self->root && lrg_bt_node_is_running (self->root))
+    if (self->program)
+    {
+        if (self->status != LRG_BT_STATUS_RUNNING)
+            return;
+
+        lrg_bt_program_abort (self->program, &self->program_state);
+    }
+    else if (self->root && lrg_bt_node_is_running (self->root))
     {
         lrg_bt_node_abort (self->root);
+    }
+    else
+    {
+        return;
+    }
+
+    if (self->status != LRG_BT_STATUS_INVALID)
+    {
         self->status = LRG_BT_STATUS_INVALID;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STATUS]);
     }
@@ -16,6 +16,7 @@
 #include "lrg-enums.h"
 #include "lrg-blackboard.h"
 #include "lrg-bt-node.h"
+#include "lrg-bt-program.h"
 
 G_BEGIN_DECLS
 
@@ -44,6 +45,18 @@ LrgBehaviorTree *   lrg_behavior_tree_new            (void);
 LRG_AVAILABLE_IN_ALL
 LrgBehaviorTree *   lrg_behavior_tree_new_with_root  (LrgBTNode *root);
 
+/**
+ * lrg_behavior_tree_new_from_program:
+ * @program: (transfer none): A compiled program
+ *
+ * Creates a new behavior tree that runs @program, with its own
+ * blackboard and node state. Any number of trees can share a program.
+ *
+ * Returns: (transfer full): A new #LrgBehaviorTree
+ */
+LRG_AVAILABLE_IN_ALL
+LrgBehaviorTree *   lrg_behavior_tree_new_from_program (LrgBTProgram *program);
+
 /**
  * lrg_behavior_tree_get_root:
  * @self: an #LrgBehaviorTree
@@ -77,6 +90,42 @@ void                lrg_behavior_tree_set_root       (LrgBehaviorTree *self,
 LRG_AVAILABLE_IN_ALL
 LrgBlackboard *     lrg_behavior_tree_get_blackboard (LrgBehaviorTree *self);
 
+/**
+ * lrg_behavior_tree_get_program:
+ * @self: an #LrgBehaviorTree
+ *
+ * Gets the compiled program the tree runs.
+ *
+ * Returns: (transfer none) (nullable): The program, or %NULL if the
+ *   tree ticks its node objects
+ */
+LRG_AVAILABLE_IN_ALL
+LrgBTProgram *      lrg_behavior_tree_get_program    (LrgBehaviorTree *self);
+
+/**
+ * lrg_behavior_tree_set_program:
+ * @self: an #LrgBehaviorTree
+ * @program: (nullable) (transfer none): A compiled program
+ *
+ * Makes the tree run @program from its initial state. The root becomes
+ * the node @program was compiled from, but ticks no longer reach the
+ * node objects. Setting a different root drops the program.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_behavior_tree_set_program    (LrgBehaviorTree *self,
+                                                      LrgBTProgram    *program);
+
+/**
+ * lrg_behavior_tree_compile:
+ * @self: an #LrgBehaviorTree
+ *
+ * Compiles the root node with lrg_bt_program_new() and runs the
+ * program from now on. A running compiled tree resumes at its running
+ * node on the next tick instead of walking down from the root.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_behavior_tree_compile        (LrgBehaviorTree *self);
+
 /**
  * lrg_behavior_tree_tick:
  * @self: an #LrgBehaviorTree
@@ -90,6 +139,29 @@ LRG_AVAILABLE_IN_ALL
 LrgBTStatus         lrg_behavior_tree_tick           (LrgBehaviorTree *self,
                                                       gfloat           delta_time);
 
+/**
+ * lrg_behavior_tree_tick_batch:
+ * @trees: (array length=n_trees): Distinct behavior trees
+ * @n_trees: Number of trees
+ * @delta_time: Time since last tick
+ * @max_threads: Worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Ticks every tree, splitting large batches across worker threads.
+ * Only trees running a program for which lrg_bt_program_is_shareable()
+ * is %TRUE go to the workers, so their action and condition callbacks
+ * must be safe to call from several threads at once, each with its
+ * own blackboard. Other trees tick on the calling thread.
+ *
+ * The #LrgBehaviorTree::completed signal and status notifications are
+ * emitted on the calling thread after every tree has ticked.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_behavior_tree_tick_batch     (LrgBehaviorTree * const *trees,
+                                                      guint                    n_trees,
+                                                      gfloat                   delta_time,
+                                                      guint                    max_threads);
+
 /**
  * lrg_behavior_tree_reset:
  * @self: an #LrgBehaviorTree
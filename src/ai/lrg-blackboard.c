@@ -9,6 +9,8 @@
 
 #include "lrg-blackboard.h"
 
+#include <string.h>
+
 #define LRG_LOG_DOMAIN LRG_LOG_DOMAIN_AI
 #include "lrg-log.h"
 
@@ -19,6 +21,7 @@
  */
 typedef enum
 {
+    ENTRY_TYPE_NONE,
     ENTRY_TYPE_INT,
     ENTRY_TYPE_FLOAT,
     ENTRY_TYPE_BOOL,
@@ -42,11 +45,17 @@ typedef struct
     GDestroyNotify destroy;
 } BlackboardEntry;
 
+typedef struct
+{
+    guint           slot;
+    BlackboardEntry entry;
+} SlotEntry;
+
 struct _LrgBlackboard
 {
     GObject      parent_instance;
 
-    GHashTable  *entries;  /* gchar* -> BlackboardEntry* */
+    GArray      *entries;  /* SlotEntry, sorted by slot, set keys only */
 };
 
 #pragma GCC visibility push(default)
@@ -54,16 +63,161 @@ G_DEFINE_FINAL_TYPE (LrgBlackboard, lrg_blackboard, G_TYPE_OBJECT)
 #pragma GCC visibility pop
 
 /*
- * entry_free:
+ * Key names are interned process-wide into slots numbered from 1, so
+ * a slot means the same key on every blackboard. Names live until the
+ * process exits.
  *
- * Frees a blackboard entry and its resources.
+ * Finding the slot of a name takes no lock: the open addressing table
+ * is only ever added to, a bucket's name is stored last, and a full
+ * table is replaced by a larger copy. Replaced tables are kept, since
+ * a reader may still be probing one. Registering a name takes
+ * key_lock.
  */
+typedef struct
+{
+    const gchar *name;   /* NULL while the bucket is empty */
+    guint        hash;
+    guint        slot;
+} KeyBucket;
+
+typedef struct
+{
+    guint     mask;
+    KeyBucket buckets[];
+} KeyTable;
+
+#define KEY_TABLE_MIN_SIZE 64
+
+static GMutex      key_lock;
+static KeyTable   *key_table;    /* Current table, read atomically */
+static GSList     *key_retired;  /* Replaced tables */
+static GPtrArray  *key_names;    /* slot - 1 -> gchar*, under key_lock */
+
+static guint
+key_table_find (KeyTable    *table,
+                const gchar *key,
+                guint        hash)
+{
+    guint i;
+
+    for (i = hash & table->mask; ; i = (i + 1) & table->mask)
+    {
+        KeyBucket *bucket = &table->buckets[i];
+        const gchar *name = g_atomic_pointer_get (&bucket->name);
+
+        if (name == NULL)
+            return 0;
+
+        if (bucket->hash == hash && strcmp (name, key) == 0)
+            return bucket->slot;
+    }
+}
+
+/* Called with key_lock held, on a table readers cannot see yet or
+ * with room to spare. The name is published last. */
 static void
-entry_free (BlackboardEntry *entry)
+key_table_insert (KeyTable    *table,
+                  const gchar *name,
+                  guint        hash,
+                  guint        slot)
+{
+    guint i;
+
+    for (i = hash & table->mask; table->buckets[i].name != NULL; i = (i + 1) & table->mask)
+        ;
+
+    table->buckets[i].hash = hash;
+    table->buckets[i].slot = slot;
+    g_atomic_pointer_set (&table->buckets[i].name, name);
+}
+
+static KeyTable *
+key_table_new (guint size)
+{
+    KeyTable *table;
+
+    table = g_malloc0 (sizeof (KeyTable) + size * sizeof (KeyBucket));
+    table->mask = size - 1;
+
+    return table;
+}
+
+static guint
+key_register (const gchar *key,
+              guint        hash)
+{
+    KeyTable *table;
+    gchar *name;
+    guint slot;
+    guint i;
+
+    g_mutex_lock (&key_lock);
+
+    table = key_table;
+    slot = table != NULL ? key_table_find (table, key, hash) : 0;
+    if (slot != 0)
+    {
+        g_mutex_unlock (&key_lock);
+        return slot;
+    }
+
+    if (key_names == NULL)
+        key_names = g_ptr_array_new ();
+
+    name = g_strdup (key);
+    g_ptr_array_add (key_names, name);
+    slot = key_names->len;
+
+    /* Keep the table at most half full so probes stay short */
+    if (table == NULL || slot * 2 > table->mask + 1)
+    {
+        KeyTable *grown;
+
+        grown = key_table_new (table != NULL ? (table->mask + 1) * 2 : KEY_TABLE_MIN_SIZE);
+        for (i = 0; i + 1 < slot; i++)
+        {
+            const gchar *old = g_ptr_array_index (key_names, i);
+            key_table_insert (grown, old, g_str_hash (old), i + 1);
+        }
+        key_table_insert (grown, name, hash, slot);
+
+        if (table != NULL)
+            key_retired = g_slist_prepend (key_retired, table);
+        g_atomic_pointer_set (&key_table, grown);
+    }
+    else
+    {
+        key_table_insert (table, name, hash, slot);
+    }
+
+    g_mutex_unlock (&key_lock);
+
+    return slot;
+}
+
+static guint
+key_lookup (const gchar *key,
+            gboolean     create)
 {
-    if (entry == NULL)
-        return;
+    KeyTable *table = g_atomic_pointer_get (&key_table);
+    guint hash = g_str_hash (key);
+    guint slot;
+
+    slot = table != NULL ? key_table_find (table, key, hash) : 0;
+    if (slot == 0 && create)
+        slot = key_register (key, hash);
 
+    return slot;
+}
+
+/*
+ * entry_clear:
+ *
+ * Frees the resources of a blackboard entry and marks it unset.
+ */
+static void
+entry_clear (BlackboardEntry *entry)
+{
     switch (entry->type)
     {
     case ENTRY_TYPE_STRING:
@@ -83,7 +237,131 @@ entry_free (BlackboardEntry *entry)
         break;
     }
 
-    g_free (entry);
+    memset (entry, 0, sizeof (BlackboardEntry));
+}
+
+static void
+slot_entry_clear (SlotEntry *slot_entry)
+{
+    entry_clear (&slot_entry->entry);
+}
+
+/*
+ * entry_find:
+ *
+ * Binary searches the entries for @slot. Returns whether it is set
+ * and, in @index, where it is or would be inserted.
+ */
+static gboolean
+entry_find (LrgBlackboard *self,
+            guint          slot,
+            guint         *index)
+{
+    guint lo = 0;
+    guint hi = self->entries->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        guint mid_slot = g_array_index (self->entries, SlotEntry, mid).slot;
+
+        if (mid_slot == slot)
+        {
+            *index = mid;
+            return TRUE;
+        }
+
+        if (mid_slot < slot)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    *index = lo;
+    return FALSE;
+}
+
+/*
+ * entry_lookup:
+ *
+ * Returns the entry stored for @slot, or %NULL if it is not set.
+ */
+static BlackboardEntry *
+entry_lookup (LrgBlackboard *self,
+              guint          slot)
+{
+    guint index;
+
+    if (slot == 0 || !entry_find (self, slot, &index))
+        return NULL;
+
+    return &g_array_index (self->entries, SlotEntry, index).entry;
+}
+
+/*
+ * entry_remove:
+ *
+ * Unsets @slot. The old value is released after the entry is gone,
+ * so a destroy function may use the blackboard.
+ */
+static gboolean
+entry_remove (LrgBlackboard *self,
+              guint          slot)
+{
+    BlackboardEntry old;
+    guint index;
+
+    if (slot == 0 || !entry_find (self, slot, &index))
+        return FALSE;
+
+    old = g_array_index (self->entries, SlotEntry, index).entry;
+    memset (&g_array_index (self->entries, SlotEntry, index).entry, 0, sizeof (BlackboardEntry));
+    g_array_remove_index (self->entries, index);
+    entry_clear (&old);
+
+    return TRUE;
+}
+
+/*
+ * entry_replace:
+ *
+ * Clears the entry for @slot, inserting it if needed, and gives it the
+ * new type. The caller fills in the value. The old value is released
+ * before the entry is looked up again, so a destroy function may use
+ * the blackboard.
+ */
+static BlackboardEntry *
+entry_replace (LrgBlackboard *self,
+               guint          slot,
+               EntryType      type)
+{
+    BlackboardEntry old = { 0 };
+    BlackboardEntry *entry;
+    guint index;
+
+    if (entry_find (self, slot, &index))
+    {
+        entry = &g_array_index (self->entries, SlotEntry, index).entry;
+        old = *entry;
+        memset (entry, 0, sizeof (BlackboardEntry));
+
+        entry_clear (&old);
+        entry_find (self, slot, &index);
+    }
+
+    if (index >= self->entries->len ||
+        g_array_index (self->entries, SlotEntry, index).slot != slot)
+    {
+        SlotEntry slot_entry = { 0 };
+
+        slot_entry.slot = slot;
+        g_array_insert_val (self->entries, index, slot_entry);
+    }
+
+    entry = &g_array_index (self->entries, SlotEntry, index).entry;
+    entry->type = type;
+
+    return entry;
 }
 
 static void
@@ -91,7 +369,7 @@ lrg_blackboard_finalize (GObject *object)
 {
     LrgBlackboard *self = LRG_BLACKBOARD (object);
 
-    g_clear_pointer (&self->entries, g_hash_table_unref);
+    g_clear_pointer (&self->entries, g_array_unref);
 
     G_OBJECT_CLASS (lrg_blackboard_parent_class)->finalize (object);
 }
@@ -107,10 +385,8 @@ lrg_blackboard_class_init (LrgBlackboardClass *klass)
 static void
 lrg_blackboard_init (LrgBlackboard *self)
 {
-    self->entries = g_hash_table_new_full (g_str_hash,
-                                           g_str_equal,
-                                           g_free,
-                                           (GDestroyNotify) entry_free);
+    self->entries = g_array_new (FALSE, TRUE, sizeof (SlotEntry));
+    g_array_set_clear_func (self->entries, (GDestroyNotify) slot_entry_clear);
 }
 
 /**
@@ -139,16 +415,10 @@ lrg_blackboard_set_int (LrgBlackboard *self,
                         const gchar   *key,
                         gint           value)
 {
-    BlackboardEntry *entry;
-
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
     g_return_if_fail (key != NULL);
 
-    entry = g_new0 (BlackboardEntry, 1);
-    entry->type = ENTRY_TYPE_INT;
-    entry->value.int_val = value;
-
-    g_hash_table_insert (self->entries, g_strdup (key), entry);
+    lrg_blackboard_set_int_slot (self, key_lookup (key, TRUE), value);
 }
 
 /**
@@ -166,16 +436,10 @@ lrg_blackboard_get_int (LrgBlackboard *self,
                         const gchar   *key,
                         gint           default_value)
 {
-    BlackboardEntry *entry;
-
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), default_value);
     g_return_val_if_fail (key != NULL, default_value);
 
-    entry = g_hash_table_lookup (self->entries, key);
-    if (entry == NULL || entry->type != ENTRY_TYPE_INT)
-        return default_value;
-
-    return entry->value.int_val;
+    return lrg_blackboard_get_int_slot (self, key_lookup (key, FALSE), default_value);
 }
 
 /**
@@ -191,16 +455,10 @@ lrg_blackboard_set_float (LrgBlackboard *self,
                           const gchar   *key,
                           gfloat         value)
 {
-    BlackboardEntry *entry;
-
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
     g_return_if_fail (key != NULL);
 
-    entry = g_new0 (BlackboardEntry, 1);
-    entry->type = ENTRY_TYPE_FLOAT;
-    entry->value.float_val = value;
-
-    g_hash_table_insert (self->entries, g_strdup (key), entry);
+    lrg_blackboard_set_float_slot (self, key_lookup (key, TRUE), value);
 }
 
 /**
@@ -218,16 +476,10 @@ lrg_blackboard_get_float (LrgBlackboard *self,
                           const gchar   *key,
                           gfloat         default_value)
 {
-    BlackboardEntry *entry;
-
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), default_value);
     g_return_val_if_fail (key != NULL, default_value);
 
-    entry = g_hash_table_lookup (self->entries, key);
-    if (entry == NULL || entry->type != ENTRY_TYPE_FLOAT)
-        return default_value;
-
-    return entry->value.float_val;
+    return lrg_blackboard_get_float_slot (self, key_lookup (key, FALSE), default_value);
 }
 
 /**
@@ -243,16 +495,10 @@ lrg_blackboard_set_bool (LrgBlackboard *self,
                          const gchar   *key,
                          gboolean       value)
 {
-    BlackboardEntry *entry;
-
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
     g_return_if_fail (key != NULL);
 
-    entry = g_new0 (BlackboardEntry, 1);
-    entry->type = ENTRY_TYPE_BOOL;
-    entry->value.bool_val = value;
-
-    g_hash_table_insert (self->entries, g_strdup (key), entry);
+    lrg_blackboard_set_bool_slot (self, key_lookup (key, TRUE), value);
 }
 
 /**
@@ -270,16 +516,10 @@ lrg_blackboard_get_bool (LrgBlackboard *self,
                          const gchar   *key,
                          gboolean       default_value)
 {
-    BlackboardEntry *entry;
-
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), default_value);
     g_return_val_if_fail (key != NULL, default_value);
 
-    entry = g_hash_table_lookup (self->entries, key);
-    if (entry == NULL || entry->type != ENTRY_TYPE_BOOL)
-        return default_value;
-
-    return entry->value.bool_val;
+    return lrg_blackboard_get_bool_slot (self, key_lookup (key, FALSE), default_value);
 }
 
 /**
@@ -295,16 +535,10 @@ lrg_blackboard_set_string (LrgBlackboard *self,
                            const gchar   *key,
                            const gchar   *value)
 {
-    BlackboardEntry *entry;
-
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
     g_return_if_fail (key != NULL);
 
-    entry = g_new0 (BlackboardEntry, 1);
-    entry->type = ENTRY_TYPE_STRING;
-    entry->value.string_val = g_strdup (value);
-
-    g_hash_table_insert (self->entries, g_strdup (key), entry);
+    lrg_blackboard_set_string_slot (self, key_lookup (key, TRUE), value);
 }
 
 /**
@@ -320,16 +554,10 @@ const gchar *
 lrg_blackboard_get_string (LrgBlackboard *self,
                            const gchar   *key)
 {
-    BlackboardEntry *entry;
-
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
     g_return_val_if_fail (key != NULL, NULL);
 
-    entry = g_hash_table_lookup (self->entries, key);
-    if (entry == NULL || entry->type != ENTRY_TYPE_STRING)
-        return NULL;
-
-    return entry->value.string_val;
+    return lrg_blackboard_get_string_slot (self, key_lookup (key, FALSE));
 }
 
 /**
@@ -345,17 +573,11 @@ lrg_blackboard_set_object (LrgBlackboard *self,
                            const gchar   *key,
                            GObject       *object)
 {
-    BlackboardEntry *entry;
-
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
     g_return_if_fail (key != NULL);
     g_return_if_fail (object == NULL || G_IS_OBJECT (object));
 
-    entry = g_new0 (BlackboardEntry, 1);
-    entry->type = ENTRY_TYPE_OBJECT;
-    entry->value.object_val = object ? g_object_ref (object) : NULL;
-
-    g_hash_table_insert (self->entries, g_strdup (key), entry);
+    lrg_blackboard_set_object_slot (self, key_lookup (key, TRUE), object);
 }
 
 /**
@@ -371,16 +593,10 @@ GObject *
 lrg_blackboard_get_object (LrgBlackboard *self,
                            const gchar   *key)
 {
-    BlackboardEntry *entry;
-
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
     g_return_val_if_fail (key != NULL, NULL);
 
-    entry = g_hash_table_lookup (self->entries, key);
-    if (entry == NULL || entry->type != ENTRY_TYPE_OBJECT)
-        return NULL;
-
-    return entry->value.object_val;
+    return lrg_blackboard_get_object_slot (self, key_lookup (key, FALSE));
 }
 
 /**
@@ -398,17 +614,10 @@ lrg_blackboard_set_pointer (LrgBlackboard  *self,
                             gpointer        pointer,
                             GDestroyNotify  destroy)
 {
-    BlackboardEntry *entry;
-
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
     g_return_if_fail (key != NULL);
 
-    entry = g_new0 (BlackboardEntry, 1);
-    entry->type = ENTRY_TYPE_POINTER;
-    entry->value.pointer_val = pointer;
-    entry->destroy = destroy;
-
-    g_hash_table_insert (self->entries, g_strdup (key), entry);
+    lrg_blackboard_set_pointer_slot (self, key_lookup (key, TRUE), pointer, destroy);
 }
 
 /**
@@ -424,16 +633,10 @@ gpointer
 lrg_blackboard_get_pointer (LrgBlackboard *self,
                             const gchar   *key)
 {
-    BlackboardEntry *entry;
-
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
     g_return_val_if_fail (key != NULL, NULL);
 
-    entry = g_hash_table_lookup (self->entries, key);
-    if (entry == NULL || entry->type != ENTRY_TYPE_POINTER)
-        return NULL;
-
-    return entry->value.pointer_val;
+    return lrg_blackboard_get_pointer_slot (self, key_lookup (key, FALSE));
 }
 
 /**
@@ -452,7 +655,7 @@ lrg_blackboard_has_key (LrgBlackboard *self,
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), FALSE);
     g_return_val_if_fail (key != NULL, FALSE);
 
-    return g_hash_table_contains (self->entries, key);
+    return entry_lookup (self, key_lookup (key, FALSE)) != NULL;
 }
 
 /**
@@ -471,7 +674,7 @@ lrg_blackboard_remove (LrgBlackboard *self,
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), FALSE);
     g_return_val_if_fail (key != NULL, FALSE);
 
-    return g_hash_table_remove (self->entries, key);
+    return entry_remove (self, key_lookup (key, FALSE));
 }
 
 /**
@@ -485,7 +688,7 @@ lrg_blackboard_clear (LrgBlackboard *self)
 {
     g_return_if_fail (LRG_IS_BLACKBOARD (self));
 
-    g_hash_table_remove_all (self->entries);
+    g_array_set_size (self->entries, 0);
 }
 
 /**
@@ -499,7 +702,361 @@ lrg_blackboard_clear (LrgBlackboard *self)
 GList *
 lrg_blackboard_get_keys (LrgBlackboard *self)
 {
+    GList *keys = NULL;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
+
+    g_mutex_lock (&key_lock);
+
+    for (i = self->entries->len; i > 0; i--)
+    {
+        guint slot = g_array_index (self->entries, SlotEntry, i - 1).slot;
+        keys = g_list_prepend (keys, g_ptr_array_index (key_names, slot - 1));
+    }
+
+    g_mutex_unlock (&key_lock);
+
+    return keys;
+}
+
+/* ==========================================================================
+ * Interned Keys
+ * ========================================================================== */
+
+/**
+ * lrg_blackboard_intern_key:
+ * @key: The key name
+ *
+ * Gets the slot number for a key name, registering the name on first
+ * use.
+ *
+ * Returns: The slot, never 0
+ */
+guint
+lrg_blackboard_intern_key (const gchar *key)
+{
+    g_return_val_if_fail (key != NULL, 0);
+
+    return key_lookup (key, TRUE);
+}
+
+/**
+ * lrg_blackboard_get_key_name:
+ * @slot: A slot returned by lrg_blackboard_intern_key()
+ *
+ * Gets the key name a slot was registered for.
+ *
+ * Returns: (transfer none) (nullable): The key name
+ */
+const gchar *
+lrg_blackboard_get_key_name (guint slot)
+{
+    const gchar *name = NULL;
+
+    g_mutex_lock (&key_lock);
+
+    if (key_names != NULL && slot > 0 && slot <= key_names->len)
+        name = g_ptr_array_index (key_names, slot - 1);
+
+    g_mutex_unlock (&key_lock);
+
+    return name;
+}
+
+/**
+ * lrg_blackboard_set_int_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: The integer value
+ *
+ * Sets an integer value by interned key.
+ */
+void
+lrg_blackboard_set_int_slot (LrgBlackboard *self,
+                             guint          slot,
+                             gint           value)
+{
+    g_return_if_fail (LRG_IS_BLACKBOARD (self));
+    g_return_if_fail (slot != 0);
+
+    entry_replace (self, slot, ENTRY_TYPE_INT)->value.int_val = value;
+}
+
+/**
+ * lrg_blackboard_get_int_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @default_value: Default if the key is not set
+ *
+ * Gets an integer value by interned key.
+ *
+ * Returns: The integer value, or @default_value if not found
+ */
+gint
+lrg_blackboard_get_int_slot (LrgBlackboard *self,
+                             guint          slot,
+                             gint           default_value)
+{
+    BlackboardEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), default_value);
+
+    entry = entry_lookup (self, slot);
+    if (entry == NULL || entry->type != ENTRY_TYPE_INT)
+        return default_value;
+
+    return entry->value.int_val;
+}
+
+/**
+ * lrg_blackboard_set_float_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: The float value
+ *
+ * Sets a float value by interned key.
+ */
+void
+lrg_blackboard_set_float_slot (LrgBlackboard *self,
+                               guint          slot,
+                               gfloat         value)
+{
+    g_return_if_fail (LRG_IS_BLACKBOARD (self));
+    g_return_if_fail (slot != 0);
+
+    entry_replace (self, slot, ENTRY_TYPE_FLOAT)->value.float_val = value;
+}
+
+/**
+ * lrg_blackboard_get_float_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @default_value: Default if the key is not set
+ *
+ * Gets a float value by interned key.
+ *
+ * Returns: The float value, or @default_value if not found
+ */
+gfloat
+lrg_blackboard_get_float_slot (LrgBlackboard *self,
+                               guint          slot,
+                               gfloat         default_value)
+{
+    BlackboardEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), default_value);
+
+    entry = entry_lookup (self, slot);
+    if (entry == NULL || entry->type != ENTRY_TYPE_FLOAT)
+        return default_value;
+
+    return entry->value.float_val;
+}
+
+/**
+ * lrg_blackboard_set_bool_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: The boolean value
+ *
+ * Sets a boolean value by interned key.
+ */
+void
+lrg_blackboard_set_bool_slot (LrgBlackboard *self,
+                              guint          slot,
+                              gboolean       value)
+{
+    g_return_if_fail (LRG_IS_BLACKBOARD (self));
+    g_return_if_fail (slot != 0);
+
+    entry_replace (self, slot, ENTRY_TYPE_BOOL)->value.bool_val = value;
+}
+
+/**
+ * lrg_blackboard_get_bool_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @default_value: Default if the key is not set
+ *
+ * Gets a boolean value by interned key.
+ *
+ * Returns: The boolean value, or @default_value if not found
+ */
+gboolean
+lrg_blackboard_get_bool_slot (LrgBlackboard *self,
+                              guint          slot,
+                              gboolean       default_value)
+{
+    BlackboardEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), default_value);
+
+    entry = entry_lookup (self, slot);
+    if (entry == NULL || entry->type != ENTRY_TYPE_BOOL)
+        return default_value;
+
+    return entry->value.bool_val;
+}
+
+/**
+ * lrg_blackboard_set_string_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: (nullable): The string value
+ *
+ * Sets a string value by interned key.
+ */
+void
+lrg_blackboard_set_string_slot (LrgBlackboard *self,
+                                guint          slot,
+                                const gchar   *value)
+{
+    gchar *copy;
+
+    g_return_if_fail (LRG_IS_BLACKBOARD (self));
+    g_return_if_fail (slot != 0);
+
+    /* Copy first: @value may be the string being replaced */
+    copy = g_strdup (value);
+    entry_replace (self, slot, ENTRY_TYPE_STRING)->value.string_val = copy;
+}
+
+/**
+ * lrg_blackboard_get_string_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Gets a string value by interned key.
+ *
+ * Returns: (transfer none) (nullable): The string value, or %NULL if not found
+ */
+const gchar *
+lrg_blackboard_get_string_slot (LrgBlackboard *self,
+                                guint          slot)
+{
+    BlackboardEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
+
+    entry = entry_lookup (self, slot);
+    if (entry == NULL || entry->type != ENTRY_TYPE_STRING)
+        return NULL;
+
+    return entry->value.string_val;
+}
+
+/**
+ * lrg_blackboard_set_object_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @object: (nullable) (transfer none): The GObject to store
+ *
+ * Sets a GObject reference by interned key.
+ */
+void
+lrg_blackboard_set_object_slot (LrgBlackboard *self,
+                                guint          slot,
+                                GObject       *object)
+{
+    GObject *ref;
+
+    g_return_if_fail (LRG_IS_BLACKBOARD (self));
+    g_return_if_fail (slot != 0);
+    g_return_if_fail (object == NULL || G_IS_OBJECT (object));
+
+    /* Reference first: @object may be the object being replaced */
+    ref = object ? g_object_ref (object) : NULL;
+    entry_replace (self, slot, ENTRY_TYPE_OBJECT)->value.object_val = ref;
+}
+
+/**
+ * lrg_blackboard_get_object_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Gets a GObject by interned key.
+ *
+ * Returns: (transfer none) (nullable): The GObject, or %NULL if not found
+ */
+GObject *
+lrg_blackboard_get_object_slot (LrgBlackboard *self,
+                                guint          slot)
+{
+    BlackboardEntry *entry;
+
     g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
 
-    return g_hash_table_get_keys (self->entries);
+    entry = entry_lookup (self, slot);
+    if (entry == NULL || entry->type != ENTRY_TYPE_OBJECT)
+        return NULL;
+
+    return entry->value.object_val;
+}
+
+/**
+ * lrg_blackboard_set_pointer_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @pointer: (nullable): The pointer to store
+ * @destroy: (nullable): Destroy function for the pointer
+ *
+ * Sets an arbitrary pointer by interned key.
+ */
+void
+lrg_blackboard_set_pointer_slot (LrgBlackboard  *self,
+                                 guint           slot,
+                                 gpointer        pointer,
+                                 GDestroyNotify  destroy)
+{
+    BlackboardEntry *entry;
+
+    g_return_if_fail (LRG_IS_BLACKBOARD (self));
+    g_return_if_fail (slot != 0);
+
+    entry = entry_replace (self, slot, ENTRY_TYPE_POINTER);
+    entry->value.pointer_val = pointer;
+    entry->destroy = destroy;
+}
+
+/**
+ * lrg_blackboard_get_pointer_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Gets a pointer by interned key.
+ *
+ * Returns: (nullable): The pointer, or %NULL if not found
+ */
+gpointer
+lrg_blackboard_get_pointer_slot (LrgBlackboard *self,
+                                 guint          slot)
+{
+    BlackboardEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), NULL);
+
+    entry = entry_lookup (self, slot);
+    if (entry == NULL || entry->type != ENTRY_TYPE_POINTER)
+        return NULL;
+
+    return entry->value.pointer_val;
+}
+
+/**
+ * lrg_blackboard_has_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Checks if an interned key is set in the blackboard.
+ *
+ * Returns: %TRUE if the key is set
+ */
+gboolean
+lrg_blackboard_has_slot (LrgBlackboard *self,
+                         guint          slot)
+{
+    g_return_val_if_fail (LRG_IS_BLACKBOARD (self), FALSE);
+
+    return entry_lookup (self, slot) != NULL;
 }
@@ -240,6 +240,218 @@ void                lrg_blackboard_clear             (LrgBlackboard *self);
 LRG_AVAILABLE_IN_ALL
 GList *             lrg_blackboard_get_keys          (LrgBlackboard *self);
 
+/* ==========================================================================
+ * Interned Keys
+ * ========================================================================== */
+
+/**
+ * lrg_blackboard_intern_key:
+ * @key: The key name
+ *
+ * Gets the slot number for a key name, registering the name on first
+ * use. Slots are shared by every blackboard in the process and never
+ * change, so look them up once and keep them. The slot functions below
+ * skip hashing the key name.
+ *
+ * Key names are never unregistered, so avoid generating an unbounded
+ * number of distinct key names.
+ *
+ * This function is thread-safe.
+ *
+ * Returns: The slot, never 0
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_blackboard_intern_key        (const gchar   *key);
+
+/**
+ * lrg_blackboard_get_key_name:
+ * @slot: A slot returned by lrg_blackboard_intern_key()
+ *
+ * Gets the key name a slot was registered for.
+ *
+ * Returns: (transfer none) (nullable): The key name, or %NULL if @slot
+ *   was never registered
+ */
+LRG_AVAILABLE_IN_ALL
+const gchar *       lrg_blackboard_get_key_name      (guint          slot);
+
+/**
+ * lrg_blackboard_set_int_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: The integer value
+ *
+ * Sets an integer value by interned key.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blackboard_set_int_slot      (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      gint           value);
+
+/**
+ * lrg_blackboard_get_int_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @default_value: Default if the key is not set
+ *
+ * Gets an integer value by interned key.
+ *
+ * Returns: The integer value, or @default_value if not found
+ */
+LRG_AVAILABLE_IN_ALL
+gint                lrg_blackboard_get_int_slot      (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      gint           default_value);
+
+/**
+ * lrg_blackboard_set_float_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: The float value
+ *
+ * Sets a float value by interned key.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blackboard_set_float_slot    (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      gfloat         value);
+
+/**
+ * lrg_blackboard_get_float_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @default_value: Default if the key is not set
+ *
+ * Gets a float value by interned key.
+ *
+ * Returns: The float value, or @default_value if not found
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat              lrg_blackboard_get_float_slot    (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      gfloat         default_value);
+
+/**
+ * lrg_blackboard_set_bool_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: The boolean value
+ *
+ * Sets a boolean value by interned key.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blackboard_set_bool_slot     (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      gboolean       value);
+
+/**
+ * lrg_blackboard_get_bool_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @default_value: Default if the key is not set
+ *
+ * Gets a boolean value by interned key.
+ *
+ * Returns: The boolean value, or @default_value if not found
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_blackboard_get_bool_slot     (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      gboolean       default_value);
+
+/**
+ * lrg_blackboard_set_string_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @value: (nullable): The string value
+ *
+ * Sets a string value by interned key.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blackboard_set_string_slot   (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      const gchar   *value);
+
+/**
+ * lrg_blackboard_get_string_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Gets a string value by interned key.
+ *
+ * Returns: (transfer none) (nullable): The string value, or %NULL if not found
+ */
+LRG_AVAILABLE_IN_ALL
+const gchar *       lrg_blackboard_get_string_slot   (LrgBlackboard *self,
+                                                      guint          slot);
+
+/**
+ * lrg_blackboard_set_object_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @object: (nullable) (transfer none): The GObject to store
+ *
+ * Sets a GObject reference by interned key.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blackboard_set_object_slot   (LrgBlackboard *self,
+                                                      guint          slot,
+                                                      GObject       *object);
+
+/**
+ * lrg_blackboard_get_object_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Gets a GObject by interned key.
+ *
+ * Returns: (transfer none) (nullable): The GObject, or %NULL if not found
+ */
+LRG_AVAILABLE_IN_ALL
+GObject *           lrg_blackboard_get_object_slot   (LrgBlackboard *self,
+                                                      guint          slot);
+
+/**
+ * lrg_blackboard_set_pointer_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ * @pointer: (nullable): The pointer to store
+ * @destroy: (nullable): Destroy function for the pointer
+ *
+ * Sets an arbitrary pointer by interned key.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blackboard_set_pointer_slot  (LrgBlackboard  *self,
+                                                      guint           slot,
+                                                      gpointer        pointer,
+                                                      GDestroyNotify  destroy);
+
+/**
+ * lrg_blackboard_get_pointer_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Gets a pointer by interned key.
+ *
+ * Returns: (nullable): The pointer, or %NULL if not found
+ */
+LRG_AVAILABLE_IN_ALL
+gpointer            lrg_blackboard_get_pointer_slot  (LrgBlackboard *self,
+                                                      guint          slot);
+
+/**
+ * lrg_blackboard_has_slot:
+ * @self: an #LrgBlackboard
+ * @slot: The key slot
+ *
+ * Checks if an interned key is set in the blackboard.
+ *
+ * Returns: %TRUE if the key is set
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_blackboard_has_slot          (LrgBlackboard *self,
+                                                      guint          slot);
+
 G_END_DECLS
 
 #endif /* LRG_BLACKBOARD_H */
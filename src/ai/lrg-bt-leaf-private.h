@@ -0,0 +1,38 @@
+/* lrg-bt-leaf-private.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Leaf node internals read when compiling an LrgBTProgram.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#include "lrg-bt-leaf.h"
+
+G_BEGIN_DECLS
+
+/*
+ * lrg_bt_action_get_func:
+ * @self: an #LrgBTAction
+ * @user_data: (out): return location for the callback's user data
+ *
+ * Returns: the action callback
+ */
+LrgBTActionFunc     lrg_bt_action_get_func     (LrgBTAction    *self,
+                                                gpointer       *user_data);
+
+/*
+ * lrg_bt_condition_get_func:
+ * @self: an #LrgBTCondition
+ * @user_data: (out): return location for the callback's user data
+ *
+ * Returns: the condition callback
+ */
+LrgBTConditionFunc  lrg_bt_condition_get_func  (LrgBTCondition *self,
+                                                gpointer       *user_data);
+
+G_END_DECLS
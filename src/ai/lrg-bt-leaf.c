@@ -8,6 +8,7 @@
  */
 
 #include "lrg-bt-leaf.h"
+#include "lrg-bt-leaf-private.h"
 
 #define LRG_LOG_DOMAIN LRG_LOG_DOMAIN_AI
 #include "lrg-log.h"
@@ -110,6 +111,14 @@ lrg_bt_action_new_simple (LrgBTActionFunc func)
     return lrg_bt_action_new (func, NULL, NULL);
 }
 
+LrgBTActionFunc
+lrg_bt_action_get_func (LrgBTAction *self,
+                        gpointer    *user_data)
+{
+    *user_data = self->user_data;
+    return self->func;
+}
+
 /* ==========================================================================
  * LrgBTCondition - Checks a condition
  * ========================================================================== */
@@ -212,6 +221,14 @@ lrg_bt_condition_new_simple (LrgBTConditionFunc func)
     return lrg_bt_condition_new (func, NULL, NULL);
 }
 
+LrgBTConditionFunc
+lrg_bt_condition_get_func (LrgBTCondition *self,
+                           gpointer       *user_data)
+{
+    *user_data = self->user_data;
+    return self->func;
+}
+
 /* ==========================================================================
  * LrgBTWait - Waits for a duration
  * ========================================================================== */
@@ -0,0 +1,68 @@
+/* lrg-bt-program-private.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Per-tree execution state for LrgBTProgram.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#include "lrg-bt-program.h"
+#include "lrg-blackboard.h"
+
+G_BEGIN_DECLS
+
+/*
+ * LrgBTNodeState:
+ *
+ * Running state of one compiled node: the active child of a sequence
+ * or selector, the finished passes of a repeater or the time spent in
+ * a wait. Zero is the initial state of every node.
+ */
+typedef union
+{
+    guint  child;
+    guint  count;
+    gfloat elapsed;
+} LrgBTNodeState;
+
+/*
+ * LrgBTProgramState:
+ * @nodes: one entry per program node
+ * @resume: node the next tick starts at; 0 (the root) unless the last
+ *   tick returned %LRG_BT_STATUS_RUNNING
+ */
+typedef struct
+{
+    LrgBTNodeState *nodes;
+    guint           resume;
+} LrgBTProgramState;
+
+void         lrg_bt_program_state_init   (LrgBTProgram      *self,
+                                          LrgBTProgramState *state);
+
+void         lrg_bt_program_state_clear  (LrgBTProgramState *state);
+
+/*
+ * lrg_bt_program_tick:
+ *
+ * Ticks one tree. A tree left running resumes at the node that was
+ * running instead of walking down from the root; the nodes above it
+ * would only have passed the tick through.
+ */
+LrgBTStatus  lrg_bt_program_tick         (LrgBTProgram      *self,
+                                          LrgBTProgramState *state,
+                                          LrgBlackboard     *blackboard,
+                                          gfloat             delta_time);
+
+void         lrg_bt_program_reset        (LrgBTProgram      *self,
+                                          LrgBTProgramState *state);
+
+void         lrg_bt_program_abort        (LrgBTProgram      *self,
+                                          LrgBTProgramState *state);
+
+G_END_DECLS
@@ -0,0 +1,617 @@
+/* lrg-bt-program.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Behavior tree compiled into a flat node array.
+ */
+
+#include "lrg-bt-program.h"
+#include "lrg-bt-program-private.h"
+#include "lrg-bt-composite.h"
+#include "lrg-bt-decorator.h"
+#include "lrg-bt-leaf.h"
+#include "lrg-bt-leaf-private.h"
+
+#include <string.h>
+
+#define LRG_LOG_DOMAIN LRG_LOG_DOMAIN_AI
+#include "lrg-log.h"
+
+typedef enum
+{
+    OP_SEQUENCE,
+    OP_SELECTOR,
+    OP_PARALLEL,
+    OP_INVERTER,
+    OP_REPEATER,
+    OP_SUCCEEDER,
+    OP_FAILER,
+    OP_ACTION,
+    OP_CONDITION,
+    OP_WAIT,
+    OP_CUSTOM
+} ProgramOp;
+
+/*
+ * ProgramNode:
+ *
+ * Nodes are stored depth-first, so a node's subtree is the range
+ * [index, end) and the only child of a decorator is index + 1.
+ */
+typedef struct
+{
+    guint8  op;
+    guint8  policy;     /* LrgBTParallelPolicy */
+    guint   n_children;
+    guint   children;   /* first entry in child_index */
+    guint   parent;
+    guint   end;
+    union
+    {
+        guint  count;     /* OP_REPEATER */
+        gfloat duration;  /* OP_WAIT */
+        guint  callback;  /* OP_ACTION, OP_CONDITION: into callbacks */
+        guint  custom;    /* OP_CUSTOM: into custom */
+    } arg;
+} ProgramNode;
+
+typedef struct
+{
+    union
+    {
+        LrgBTActionFunc    action;
+        LrgBTConditionFunc condition;
+    } func;
+    gpointer user_data;
+} ProgramCallback;
+
+struct _LrgBTProgram
+{
+    GObject    parent_instance;
+
+    LrgBTNode *root;
+    GArray    *nodes;        /* ProgramNode */
+    GArray    *child_index;  /* guint */
+    GArray    *callbacks;    /* ProgramCallback */
+    GPtrArray *custom;       /* LrgBTNode */
+};
+
+#pragma GCC visibility push(default)
+G_DEFINE_FINAL_TYPE (LrgBTProgram, lrg_bt_program, G_TYPE_OBJECT)
+#pragma GCC visibility pop
+
+/* ==========================================================================
+ * Compiling
+ * ========================================================================== */
+
+static guint
+compile_node (LrgBTProgram *self,
+              LrgBTNode    *node,
+              guint         parent)
+{
+    ProgramNode     entry = { 0 };
+    ProgramCallback callback = { { NULL }, NULL };
+    LrgBTNode      *child = NULL;
+    GPtrArray      *children = NULL;
+    guint           index;
+    guint           i;
+
+    index = self->nodes->len;
+    entry.parent = parent;
+
+    if (LRG_IS_BT_SEQUENCE (node) || LRG_IS_BT_SELECTOR (node) || LRG_IS_BT_PARALLEL (node))
+    {
+        entry.op = LRG_IS_BT_SEQUENCE (node) ? OP_SEQUENCE
+                 : LRG_IS_BT_SELECTOR (node) ? OP_SELECTOR
+                 : OP_PARALLEL;
+        if (entry.op == OP_PARALLEL)
+            entry.policy = lrg_bt_parallel_get_policy (LRG_BT_PARALLEL (node));
+
+        children = lrg_bt_composite_get_children (LRG_BT_COMPOSITE (node));
+        entry.n_children = children->len;
+        entry.children = self->child_index->len;
+        g_array_set_size (self->child_index, entry.children + children->len);
+    }
+    else if (LRG_IS_BT_INVERTER (node) || LRG_IS_BT_REPEATER (node) ||
+             LRG_IS_BT_SUCCEEDER (node) || LRG_IS_BT_FAILER (node))
+    {
+        entry.op = LRG_IS_BT_INVERTER (node) ? OP_INVERTER
+                 : LRG_IS_BT_REPEATER (node) ? OP_REPEATER
+                 : LRG_IS_BT_SUCCEEDER (node) ? OP_SUCCEEDER
+                 : OP_FAILER;
+        if (entry.op == OP_REPEATER)
+            entry.arg.count = lrg_bt_repeater_get_count (LRG_BT_REPEATER (node));
+
+        child = lrg_bt_decorator_get_child (LRG_BT_DECORATOR (node));
+        entry.n_children = child != NULL ? 1 : 0;
+    }
+    else if (LRG_IS_BT_ACTION (node))
+    {
+        entry.op = OP_ACTION;
+        entry.arg.callback = self->callbacks->len;
+        callback.func.action = lrg_bt_action_get_func (LRG_BT_ACTION (node), &callback.user_data);
+        g_array_append_val (self->callbacks, callback);
+    }
+    else if (LRG_IS_BT_CONDITION (node))
+    {
+        entry.op = OP_CONDITION;
+        entry.arg.callback = self->callbacks->len;
+        callback.func.condition = lrg_bt_condition_get_func (LRG_BT_CONDITION (node), &callback.user_data);
+        g_array_append_val (self->callbacks, callback);
+    }
+    else if (LRG_IS_BT_WAIT (node))
+    {
+        entry.op = OP_WAIT;
+        entry.arg.duration = lrg_bt_wait_get_duration (LRG_BT_WAIT (node));
+    }
+    else
+    {
+        lrg_debug (LRG_LOG_DOMAIN_AI, "Keeping %s node '%s' uncompiled",
+                   G_OBJECT_TYPE_NAME (node),
+                   lrg_bt_node_get_name (node) ? lrg_bt_node_get_name (node) : "(unnamed)");
+
+        entry.op = OP_CUSTOM;
+        entry.arg.custom = self->custom->len;
+        g_ptr_array_add (self->custom, g_object_ref (node));
+    }
+
+    g_array_append_val (self->nodes, entry);
+
+    /* The arrays grow while compiling children, so store by index */
+    if (children != NULL)
+    {
+        for (i = 0; i < children->len; i++)
+        {
+            guint child_node = compile_node (self, g_ptr_array_index (children, i), index);
+
+            g_array_index (self->child_index, guint, entry.children + i) = child_node;
+        }
+    }
+    else if (child != NULL)
+    {
+        compile_node (self, child, index);
+    }
+
+    g_array_index (self->nodes, ProgramNode, index).end = self->nodes->len;
+
+    return index;
+}
+
+/* ==========================================================================
+ * Running
+ * ========================================================================== */
+
+typedef struct
+{
+    LrgBTProgram      *program;
+    const ProgramNode *nodes;
+    const guint       *child_index;
+    LrgBTNodeState    *state;
+    guint             *resume;
+    LrgBlackboard     *blackboard;
+    gfloat             delta_time;
+} Run;
+
+static LrgBTStatus tick_node (const Run *run, guint index);
+
+/*
+ * Anything a callback returns other than SUCCESS or RUNNING counts
+ * as FAILURE, so composites never see INVALID.
+ */
+static inline LrgBTStatus
+leaf_status (LrgBTStatus status)
+{
+    if (status == LRG_BT_STATUS_SUCCESS || status == LRG_BT_STATUS_RUNNING)
+        return status;
+
+    return LRG_BT_STATUS_FAILURE;
+}
+
+/*
+ * Puts the nodes in [first, end) back in their initial state, as
+ * lrg_bt_node_reset() does for the subtree of an object node.
+ */
+static void
+reset_range (LrgBTProgram   *program,
+             LrgBTNodeState *state,
+             guint           first,
+             guint           end)
+{
+    guint i;
+
+    memset (state + first, 0, (end - first) * sizeof (LrgBTNodeState));
+
+    if (program->custom->len == 0)
+        return;
+
+    for (i = first; i < end; i++)
+    {
+        const ProgramNode *node = &g_array_index (program->nodes, ProgramNode, i);
+
+        if (node->op == OP_CUSTOM)
+            lrg_bt_node_reset (g_ptr_array_index (program->custom, node->arg.custom));
+    }
+}
+
+/*
+ * Reacts to the active child of composite or decorator @index having
+ * returned @status, ticking further children where the node moves on.
+ */
+static LrgBTStatus
+resume_node (const Run   *run,
+             guint        index,
+             LrgBTStatus  status)
+{
+    const ProgramNode *node = &run->nodes[index];
+    LrgBTNodeState    *state = &run->state[index];
+
+    switch (node->op)
+    {
+    case OP_SEQUENCE:
+    case OP_SELECTOR:
+        {
+            /* A sequence moves on after SUCCESS, a selector after FAILURE */
+            LrgBTStatus next = node->op == OP_SEQUENCE ? LRG_BT_STATUS_SUCCESS
+                                                       : LRG_BT_STATUS_FAILURE;
+
+            while (status == next)
+            {
+                if (++state->child >= node->n_children)
+                {
+                    state->child = 0;
+                    return next;
+                }
+
+                status = tick_node (run, run->child_index[node->children + state->child]);
+            }
+
+            if (status != LRG_BT_STATUS_RUNNING)
+                state->child = 0;
+
+            return status;
+        }
+
+    case OP_INVERTER:
+        if (status == LRG_BT_STATUS_SUCCESS)
+            return LRG_BT_STATUS_FAILURE;
+        if (status == LRG_BT_STATUS_FAILURE)
+            return LRG_BT_STATUS_SUCCESS;
+        return status;
+
+    case OP_SUCCEEDER:
+        return status == LRG_BT_STATUS_RUNNING ? status : LRG_BT_STATUS_SUCCESS;
+
+    case OP_FAILER:
+        return status == LRG_BT_STATUS_RUNNING ? status : LRG_BT_STATUS_FAILURE;
+
+    case OP_REPEATER:
+        if (status == LRG_BT_STATUS_RUNNING)
+            return status;
+
+        state->count++;
+        if (node->arg.count == 0 || state->count < node->arg.count)
+        {
+            reset_range (run->program, run->state, index + 1, node->end);
+            *run->resume = index;
+            return LRG_BT_STATUS_RUNNING;
+        }
+
+        state->count = 0;
+        return status;
+
+    default:
+        g_assert_not_reached ();
+    }
+
+    return status;
+}
+
+static LrgBTStatus
+tick_parallel (const Run *run,
+               guint      index)
+{
+    const ProgramNode *node = &run->nodes[index];
+    guint success_count = 0;
+    guint failure_count = 0;
+    guint i;
+
+    if (node->n_children == 0)
+        return LRG_BT_STATUS_SUCCESS;
+
+    for (i = 0; i < node->n_children; i++)
+    {
+        switch (tick_node (run, run->child_index[node->children + i]))
+        {
+        case LRG_BT_STATUS_SUCCESS:
+            success_count++;
+            break;
+
+        case LRG_BT_STATUS_FAILURE:
+            failure_count++;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    switch ((LrgBTParallelPolicy) node->policy)
+    {
+    case LRG_BT_PARALLEL_REQUIRE_ONE:
+        if (success_count > 0)
+            return LRG_BT_STATUS_SUCCESS;
+        if (failure_count == node->n_children)
+            return LRG_BT_STATUS_FAILURE;
+        break;
+
+    case LRG_BT_PARALLEL_REQUIRE_ALL:
+        if (failure_count > 0)
+            return LRG_BT_STATUS_FAILURE;
+        if (success_count == node->n_children)
+            return LRG_BT_STATUS_SUCCESS;
+        break;
+    }
+
+    /* Every child is ticked again, so resume here */
+    *run->resume = index;
+    return LRG_BT_STATUS_RUNNING;
+}
+
+static LrgBTStatus
+tick_node (const Run *run,
+           guint      index)
+{
+    const ProgramNode     *node = &run->nodes[index];
+    const ProgramCallback *callback;
+    LrgBTNodeState        *state = &run->state[index];
+    LrgBTStatus            status;
+
+    switch (node->op)
+    {
+    case OP_SEQUENCE:
+    case OP_SELECTOR:
+        if (node->n_children == 0)
+            return node->op == OP_SEQUENCE ? LRG_BT_STATUS_SUCCESS : LRG_BT_STATUS_FAILURE;
+
+        status = tick_node (run, run->child_index[node->children + state->child]);
+        return resume_node (run, index, status);
+
+    case OP_PARALLEL:
+        return tick_parallel (run, index);
+
+    case OP_INVERTER:
+    case OP_REPEATER:
+    case OP_SUCCEEDER:
+    case OP_FAILER:
+        if (node->n_children == 0)
+            return node->op == OP_SUCCEEDER ? LRG_BT_STATUS_SUCCESS : LRG_BT_STATUS_FAILURE;
+
+        return resume_node (run, index, tick_node (run, index + 1));
+
+    case OP_ACTION:
+        callback = &g_array_index (run->program->callbacks, ProgramCallback, node->arg.callback);
+        status = callback->func.action != NULL
+            ? leaf_status (callback->func.action (run->blackboard, run->delta_time, callback->user_data))
+            : LRG_BT_STATUS_FAILURE;
+        break;
+
+    case OP_CONDITION:
+        callback = &g_array_index (run->program->callbacks, ProgramCallback, node->arg.callback);
+        return callback->func.condition != NULL &&
+               callback->func.condition (run->blackboard, callback->user_data)
+            ? LRG_BT_STATUS_SUCCESS
+            : LRG_BT_STATUS_FAILURE;
+
+    case OP_WAIT:
+        state->elapsed += run->delta_time;
+        if (state->elapsed >= node->arg.duration)
+        {
+            state->elapsed = 0.0f;
+            return LRG_BT_STATUS_SUCCESS;
+        }
+        status = LRG_BT_STATUS_RUNNING;
+        break;
+
+    case OP_CUSTOM:
+        status = leaf_status (lrg_bt_node_tick (g_ptr_array_index (run->program->custom, node->arg.custom),
+                                                run->blackboard, run->delta_time));
+        break;
+
+    default:
+        g_assert_not_reached ();
+    }
+
+    if (status == LRG_BT_STATUS_RUNNING)
+        *run->resume = index;
+
+    return status;
+}
+
+/* ==========================================================================
+ * GObject Implementation
+ * ========================================================================== */
+
+static void
+lrg_bt_program_finalize (GObject *object)
+{
+    LrgBTProgram *self = LRG_BT_PROGRAM (object);
+
+    g_clear_object (&self->root);
+    g_clear_pointer (&self->nodes, g_array_unref);
+    g_clear_pointer (&self->child_index, g_array_unref);
+    g_clear_pointer (&self->callbacks, g_array_unref);
+    g_clear_pointer (&self->custom, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (lrg_bt_program_parent_class)->finalize (object);
+}
+
+static void
+lrg_bt_program_class_init (LrgBTProgramClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = lrg_bt_program_finalize;
+}
+
+static void
+lrg_bt_program_init (LrgBTProgram *self)
+{
+    self->nodes = g_array_new (FALSE, FALSE, sizeof (ProgramNode));
+    self->child_index = g_array_new (FALSE, FALSE, sizeof (guint));
+    self->callbacks = g_array_new (FALSE, FALSE, sizeof (ProgramCallback));
+    self->custom = g_ptr_array_new_with_free_func (g_object_unref);
+}
+
+/* ==========================================================================
+ * Public API
+ * ========================================================================== */
+
+/**
+ * lrg_bt_program_new:
+ * @root: (transfer none): The root node of the tree to compile
+ *
+ * Compiles the tree under @root into a flat array of nodes.
+ *
+ * Returns: (transfer full): A new #LrgBTProgram
+ */
+LrgBTProgram *
+lrg_bt_program_new (LrgBTNode *root)
+{
+    LrgBTProgram *self;
+
+    g_return_val_if_fail (LRG_IS_BT_NODE (root), NULL);
+
+    self = g_object_new (LRG_TYPE_BT_PROGRAM, NULL);
+    self->root = g_object_ref (root);
+    compile_node (self, root, 0);
+
+    return self;
+}
+
+/**
+ * lrg_bt_program_get_root:
+ * @self: an #LrgBTProgram
+ *
+ * Gets the node the program was compiled from.
+ *
+ * Returns: (transfer none): The root node
+ */
+LrgBTNode *
+lrg_bt_program_get_root (LrgBTProgram *self)
+{
+    g_return_val_if_fail (LRG_IS_BT_PROGRAM (self), NULL);
+
+    return self->root;
+}
+
+/**
+ * lrg_bt_program_get_node_count:
+ * @self: an #LrgBTProgram
+ *
+ * Gets the number of nodes in the program.
+ *
+ * Returns: The node count
+ */
+guint
+lrg_bt_program_get_node_count (LrgBTProgram *self)
+{
+    g_return_val_if_fail (LRG_IS_BT_PROGRAM (self), 0);
+
+    return self->nodes->len;
+}
+
+/**
+ * lrg_bt_program_is_shareable:
+ * @self: an #LrgBTProgram
+ *
+ * Checks whether every node was compiled.
+ *
+ * Returns: %TRUE if the program wraps no node objects
+ */
+gboolean
+lrg_bt_program_is_shareable (LrgBTProgram *self)
+{
+    g_return_val_if_fail (LRG_IS_BT_PROGRAM (self), FALSE);
+
+    return self->custom->len == 0;
+}
+
+/* ==========================================================================
+ * Private API
+ * ========================================================================== */
+
+void
+lrg_bt_program_state_init (LrgBTProgram      *self,
+                           LrgBTProgramState *state)
+{
+    state->nodes = g_new0 (LrgBTNodeState, self->nodes->len);
+    state->resume = 0;
+}
+
+void
+lrg_bt_program_state_clear (LrgBTProgramState *state)
+{
+    g_clear_pointer (&state->nodes, g_free);
+    state->resume = 0;
+}
+
+LrgBTStatus
+lrg_bt_program_tick (LrgBTProgram      *self,
+                     LrgBTProgramState *state,
+                     LrgBlackboard     *blackboard,
+                     gfloat             delta_time)
+{
+    Run         run;
+    LrgBTStatus status;
+    guint       index;
+
+    run.program = self;
+    run.nodes = (const ProgramNode *) self->nodes->data;
+    run.child_index = (const guint *) self->child_index->data;
+    run.state = state->nodes;
+    run.resume = &state->resume;
+    run.blackboard = blackboard;
+    run.delta_time = delta_time;
+
+    /* Tick the resume node, then hand its result back up the tree */
+    index = state->resume;
+    status = tick_node (&run, index);
+    while (index != 0)
+    {
+        index = run.nodes[index].parent;
+        status = resume_node (&run, index, status);
+    }
+
+    if (status != LRG_BT_STATUS_RUNNING)
+        state->resume = 0;
+
+    return status;
+}
+
+void
+lrg_bt_program_reset (LrgBTProgram      *self,
+                      LrgBTProgramState *state)
+{
+    reset_range (self, state->nodes, 0, self->nodes->len);
+    state->resume = 0;
+}
+
+void
+lrg_bt_program_abort (LrgBTProgram      *self,
+                      LrgBTProgramState *state)
+{
+    guint i;
+
+    /* Object nodes keep their progress when aborted, and so do these */
+    for (i = 0; i < self->custom->len; i++)
+    {
+        LrgBTNode *node = g_ptr_array_index (self->custom, i);
+
+        if (lrg_bt_node_is_running (node))
+            lrg_bt_node_abort (node);
+    }
+
+    state->resume = 0;
+}
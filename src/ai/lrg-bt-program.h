@@ -0,0 +1,80 @@
+/* lrg-bt-program.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Behavior tree compiled into a flat node array.
+ */
+
+#ifndef LRG_BT_PROGRAM_H
+#define LRG_BT_PROGRAM_H
+
+#include <glib-object.h>
+#include "lrg-version.h"
+#include "lrg-types.h"
+#include "lrg-bt-node.h"
+
+G_BEGIN_DECLS
+
+#define LRG_TYPE_BT_PROGRAM (lrg_bt_program_get_type ())
+
+G_DECLARE_FINAL_TYPE (LrgBTProgram, lrg_bt_program, LRG, BT_PROGRAM, GObject)
+
+/**
+ * lrg_bt_program_new:
+ * @root: (transfer none): The root node of the tree to compile
+ *
+ * Compiles the tree under @root into a flat array of nodes in
+ * depth-first order. A program holds no running state, so one program
+ * can drive any number of #LrgBehaviorTree instances, each keeping its
+ * own node state and blackboard.
+ *
+ * Sequences, selectors, parallels, the built-in decorators, actions,
+ * conditions and waits are compiled. Any other node type is kept as
+ * is and ticked through lrg_bt_node_tick(), so its state is shared by
+ * every tree using the program. Changes made to the nodes after
+ * compiling are not seen by the program.
+ *
+ * Returns: (transfer full): A new #LrgBTProgram
+ */
+LRG_AVAILABLE_IN_ALL
+LrgBTProgram *      lrg_bt_program_new               (LrgBTNode    *root);
+
+/**
+ * lrg_bt_program_get_root:
+ * @self: an #LrgBTProgram
+ *
+ * Gets the node the program was compiled from.
+ *
+ * Returns: (transfer none): The root node
+ */
+LRG_AVAILABLE_IN_ALL
+LrgBTNode *         lrg_bt_program_get_root          (LrgBTProgram *self);
+
+/**
+ * lrg_bt_program_get_node_count:
+ * @self: an #LrgBTProgram
+ *
+ * Gets the number of nodes in the program.
+ *
+ * Returns: The node count
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_bt_program_get_node_count    (LrgBTProgram *self);
+
+/**
+ * lrg_bt_program_is_shareable:
+ * @self: an #LrgBTProgram
+ *
+ * Checks whether every node was compiled. Trees using a shareable
+ * program can be ticked on different threads at the same time.
+ *
+ * Returns: %TRUE if the program wraps no node objects
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_bt_program_is_shareable      (LrgBTProgram *self);
+
+G_END_DECLS
+
+#endif /* LRG_BT_PROGRAM_H */
@@ -0,0 +1,55 @@
+/* lrg-animation-clip-private.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Keyframe search shared by LrgAnimationClip and its subclasses.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#include "lrg-animation-clip.h"
+
+G_BEGIN_DECLS
+
+/*
+ * lrg_animation_clip_find_key:
+ * @times: time of the first key
+ * @stride: bytes from one key's time to the next
+ * @n_keys: number of keys, sorted by time
+ * @time: time to look up
+ * @hint: (nullable): where the previous search for this track ended
+ *
+ * Finds the last key at or before @time. With a hint, a search that
+ * moved forward a little only steps over the keys passed; otherwise it
+ * is a binary search. The hint is updated to the result.
+ *
+ * Returns: the key index, or -1 if @time is before the first key
+ */
+gint     lrg_animation_clip_find_key            (const gfloat     *times,
+                                                 gsize             stride,
+                                                 guint             n_keys,
+                                                 gfloat            time,
+                                                 guint            *hint);
+
+/*
+ * lrg_animation_clip_sample_track_local:
+ * @self: an #LrgAnimationClip
+ * @track_index: track to sample
+ * @local_time: time within the clip, already mapped by the loop mode
+ * @hint: (nullable): keyframe search hint for the track
+ * @out_pose: (out): sampled pose
+ *
+ * Samples the keyframes stored in @self, skipping the loop mapping
+ * and the sample_track() virtual method. Used to resample a clip.
+ */
+void     lrg_animation_clip_sample_track_local  (LrgAnimationClip *self,
+                                                 guint             track_index,
+                                                 gfloat            local_time,
+                                                 guint            *hint,
+                                                 LrgBonePose      *out_pose);
+
+G_END_DECLS
@@ -7,7 +7,9 @@
 
 #include "config.h"
 #include "lrg-animation-clip.h"
+#include "lrg-animation-clip-private.h"
 #include <math.h>
+#include <string.h>
 
 /**
  * SECTION:lrg-animation-clip
@@ -19,8 +21,20 @@
  * and each track contains keyframes with transform data.
  *
  * Clips also support animation events that fire at specific times.
+ *
+ * Sampling a track looks up the keyframes around the sample time with
+ * a binary search. Playback code should sample through an
+ * #LrgAnimationClipCursor instead: it remembers where each track's
+ * search ended, so moving forward by a frame costs a step or two per
+ * track regardless of clip length.
  */
 
+/*
+ * How far a cursor walks forward before giving up and doing a binary
+ * search. Normal playback passes at most one or two keys per frame.
+ */
+#define CURSOR_MAX_STEPS 4
+
 /*
  * Animation track structure (internal)
  */
@@ -39,7 +53,16 @@ typedef struct
     GArray              *events;     /* Array of LrgAnimationEvent */
 } LrgAnimationClipPrivate;
 
+struct _LrgAnimationClipCursor
+{
+    LrgAnimationClip *clip;
+    guint             n_tracks;
+    guint            *hints;     /* n_tracks * LRG_ANIMATION_CLIP_CURSOR_SLOTS */
+};
+
 G_DEFINE_TYPE_WITH_PRIVATE (LrgAnimationClip, lrg_animation_clip, G_TYPE_OBJECT)
+G_DEFINE_BOXED_TYPE (LrgAnimationClipCursor, lrg_animation_clip_cursor,
+                     lrg_animation_clip_cursor_copy, lrg_animation_clip_cursor_free)
 
 enum
 {
@@ -97,6 +120,18 @@ lrg_animation_clip_real_sample (LrgAnimationClip *self,
     }
 }
 
+static void
+lrg_animation_clip_real_sample_track (LrgAnimationClip *self,
+                                      guint             track_index,
+                                      gfloat            time,
+                                      guint            *hints,
+                                      LrgBonePose      *out_pose)
+{
+    lrg_animation_clip_sample_track_local (self, track_index,
+                                           lrg_animation_clip_get_local_time (self, time),
+                                           hints, out_pose);
+}
+
 static void
 lrg_animation_clip_finalize (GObject *object)
 {
@@ -195,6 +230,7 @@ lrg_animation_clip_class_init (LrgAnimationClipClass *klass)
     object_class->set_property = lrg_animation_clip_set_property;
 
     klass->sample = lrg_animation_clip_real_sample;
+    klass->sample_track = lrg_animation_clip_real_sample_track;
 
     properties[PROP_NAME] =
         g_param_spec_string ("name",
@@ -377,6 +413,7 @@ lrg_animation_clip_add_keyframe (LrgAnimationClip           *self,
     LrgAnimationClipPrivate *priv;
     LrgAnimationTrack *track;
     LrgAnimationKeyframe kf_copy;
+    guint pos;
 
     g_return_if_fail (LRG_IS_ANIMATION_CLIP (self));
     g_return_if_fail (keyframe != NULL);
@@ -388,8 +425,14 @@ lrg_animation_clip_add_keyframe (LrgAnimationClip           *self,
 
     track = g_ptr_array_index (priv->tracks, track_index);
 
+    /* Keep the track sorted so sampling can binary search it */
+    pos = track->keyframes->len;
+    while (pos > 0 &&
+           g_array_index (track->keyframes, LrgAnimationKeyframe, pos - 1).time > keyframe->time)
+        pos--;
+
     kf_copy = *keyframe;
-    g_array_append_val (track->keyframes, kf_copy);
+    g_array_insert_val (track->keyframes, pos, kf_copy);
 
     /* Update duration if needed */
     if (keyframe->time > priv->duration)
@@ -538,34 +581,30 @@ lrg_animation_clip_sample_track (LrgAnimationClip *self,
                                  gfloat            time,
                                  LrgBonePose      *out_pose)
 {
-    LrgAnimationClipPrivate *priv;
-    LrgAnimationTrack *track;
-    LrgAnimationKeyframe *prev_kf;
-    LrgAnimationKeyframe *next_kf;
-    gfloat local_time;
-    gfloat t;
-    guint i;
+    LrgAnimationClipClass *klass;
 
     g_return_if_fail (LRG_IS_ANIMATION_CLIP (self));
     g_return_if_fail (out_pose != NULL);
 
-    priv = lrg_animation_clip_get_instance_private (self);
+    klass = LRG_ANIMATION_CLIP_GET_CLASS (self);
 
-    if (track_index >= priv->tracks->len)
-    {
+    if (klass->sample_track != NULL)
+        klass->sample_track (self, track_index, time, NULL, out_pose);
+    else
         lrg_bone_pose_set_identity (out_pose);
-        return;
-    }
+}
 
-    track = g_ptr_array_index (priv->tracks, track_index);
+gfloat
+lrg_animation_clip_get_local_time (LrgAnimationClip *self,
+                                   gfloat            time)
+{
+    LrgAnimationClipPrivate *priv;
+    gfloat local_time;
 
-    if (track->keyframes->len == 0)
-    {
-        lrg_bone_pose_set_identity (out_pose);
-        return;
-    }
+    g_return_val_if_fail (LRG_IS_ANIMATION_CLIP (self), time);
+
+    priv = lrg_animation_clip_get_instance_private (self);
 
-    /* Handle looping */
     local_time = time;
     if (priv->duration > 0.0f)
     {
@@ -592,6 +631,87 @@ lrg_animation_clip_sample_track (LrgAnimationClip *self,
         }
     }
 
+    return local_time;
+}
+
+gint
+lrg_animation_clip_find_key (const gfloat *times,
+                             gsize         stride,
+                             guint         n_keys,
+                             gfloat        time,
+                             guint        *hint)
+{
+    const guint8 *base = (const guint8 *)times;
+    guint lo = 0;
+    guint hi;
+    guint steps;
+    gint result;
+
+#define KEY_TIME(i) (*(const gfloat *)(base + (gsize)(i) * stride))
+
+    if (hint != NULL && *hint < n_keys && KEY_TIME (*hint) <= time)
+    {
+        lo = *hint;
+        for (steps = 0; steps < CURSOR_MAX_STEPS; steps++)
+        {
+            if (lo + 1 >= n_keys || KEY_TIME (lo + 1) > time)
+                return (gint)lo;
+            lo++;
+            *hint = lo;
+        }
+    }
+
+    /* First key after @time, searching from the last known key at or before it */
+    hi = n_keys;
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+
+        if (KEY_TIME (mid) <= time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+#undef KEY_TIME
+
+    result = (gint)lo - 1;
+    if (hint != NULL)
+        *hint = result > 0 ? (guint)result : 0;
+
+    return result;
+}
+
+void
+lrg_animation_clip_sample_track_local (LrgAnimationClip *self,
+                                       guint             track_index,
+                                       gfloat            local_time,
+                                       guint            *hint,
+                                       LrgBonePose      *out_pose)
+{
+    LrgAnimationClipPrivate *priv;
+    LrgAnimationTrack *track;
+    LrgAnimationKeyframe *prev_kf;
+    LrgAnimationKeyframe *next_kf;
+    gfloat t;
+    gint key;
+
+    priv = lrg_animation_clip_get_instance_private (self);
+
+    if (track_index >= priv->tracks->len)
+    {
+        lrg_bone_pose_set_identity (out_pose);
+        return;
+    }
+
+    track = g_ptr_array_index (priv->tracks, track_index);
+
+    if (track->keyframes->len == 0)
+    {
+        lrg_bone_pose_set_identity (out_pose);
+        return;
+    }
+
     /* Single keyframe case */
     if (track->keyframes->len == 1)
     {
@@ -603,28 +723,12 @@ lrg_animation_clip_sample_track (LrgAnimationClip *self,
     }
 
     /* Find surrounding keyframes */
-    prev_kf = NULL;
-    next_kf = NULL;
-
-    for (i = 0; i < track->keyframes->len; i++)
-    {
-        LrgAnimationKeyframe *kf;
-
-        kf = &g_array_index (track->keyframes, LrgAnimationKeyframe, i);
-
-        if (kf->time <= local_time)
-        {
-            prev_kf = kf;
-        }
-        else
-        {
-            next_kf = kf;
-            break;
-        }
-    }
+    key = lrg_animation_clip_find_key (&g_array_index (track->keyframes, LrgAnimationKeyframe, 0).time,
+                                       sizeof (LrgAnimationKeyframe),
+                                       track->keyframes->len, local_time, hint);
 
     /* Before first keyframe */
-    if (prev_kf == NULL)
+    if (key < 0)
     {
         LrgAnimationKeyframe *kf;
 
@@ -633,13 +737,17 @@ lrg_animation_clip_sample_track (LrgAnimationClip *self,
         return;
     }
 
+    prev_kf = &g_array_index (track->keyframes, LrgAnimationKeyframe, key);
+
     /* After last keyframe */
-    if (next_kf == NULL)
+    if ((guint)key + 1 >= track->keyframes->len)
     {
         *out_pose = prev_kf->pose;
         return;
     }
 
+    next_kf = &g_array_index (track->keyframes, LrgAnimationKeyframe, key + 1);
+
     /* Interpolate between keyframes */
     if (next_kf->time - prev_kf->time > 0.0001f)
         t = (local_time - prev_kf->time) / (next_kf->time - prev_kf->time);
@@ -681,3 +789,115 @@ lrg_animation_clip_calculate_smooth_tangents (LrgAnimationClip *self)
         }
     }
 }
+
+/*
+ * Cursor
+ */
+
+LrgAnimationClipCursor *
+lrg_animation_clip_cursor_new (LrgAnimationClip *clip)
+{
+    LrgAnimationClipCursor *cursor;
+
+    g_return_val_if_fail (LRG_IS_ANIMATION_CLIP (clip), NULL);
+
+    cursor = g_slice_new0 (LrgAnimationClipCursor);
+    cursor->clip = g_object_ref (clip);
+    cursor->n_tracks = lrg_animation_clip_get_track_count (clip);
+    cursor->hints = g_new0 (guint, cursor->n_tracks * LRG_ANIMATION_CLIP_CURSOR_SLOTS);
+
+    return cursor;
+}
+
+LrgAnimationClipCursor *
+lrg_animation_clip_cursor_copy (const LrgAnimationClipCursor *cursor)
+{
+    LrgAnimationClipCursor *copy;
+
+    g_return_val_if_fail (cursor != NULL, NULL);
+
+    copy = g_slice_new0 (LrgAnimationClipCursor);
+    copy->clip = g_object_ref (cursor->clip);
+    copy->n_tracks = cursor->n_tracks;
+    copy->hints = g_memdup2 (cursor->hints,
+                             sizeof (guint) * cursor->n_tracks * LRG_ANIMATION_CLIP_CURSOR_SLOTS);
+
+    return copy;
+}
+
+void
+lrg_animation_clip_cursor_free (LrgAnimationClipCursor *cursor)
+{
+    if (cursor == NULL)
+        return;
+
+    g_object_unref (cursor->clip);
+    g_free (cursor->hints);
+    g_slice_free (LrgAnimationClipCursor, cursor);
+}
+
+LrgAnimationClip *
+lrg_animation_clip_cursor_get_clip (const LrgAnimationClipCursor *cursor)
+{
+    g_return_val_if_fail (cursor != NULL, NULL);
+
+    return cursor->clip;
+}
+
+void
+lrg_animation_clip_cursor_reset (LrgAnimationClipCursor *cursor)
+{
+    g_return_if_fail (cursor != NULL);
+
+    memset (cursor->hints, 0,
+            sizeof (guint) * cursor->n_tracks * LRG_ANIMATION_CLIP_CURSOR_SLOTS);
+}
+
+void
+lrg_animation_clip_cursor_sample (LrgAnimationClipCursor *cursor,
+                                  gfloat                  time,
+                                  GPtrArray              *out_poses)
+{
+    guint n_tracks;
+    guint i;
+
+    g_return_if_fail (cursor != NULL);
+    g_return_if_fail (out_poses != NULL);
+
+    n_tracks = lrg_animation_clip_get_track_count (cursor->clip);
+
+    for (i = 0; i < n_tracks && i < out_poses->len; i++)
+    {
+        LrgBonePose *pose;
+
+        pose = g_ptr_array_index (out_poses, i);
+        lrg_animation_clip_cursor_sample_track (cursor, i, time, pose);
+    }
+}
+
+void
+lrg_animation_clip_cursor_sample_track (LrgAnimationClipCursor *cursor,
+                                        guint                   track_index,
+                                        gfloat                  time,
+                                        LrgBonePose            *out_pose)
+{
+    LrgAnimationClipClass *klass;
+    guint *hints;
+
+    g_return_if_fail (cursor != NULL);
+    g_return_if_fail (out_pose != NULL);
+
+    klass = LRG_ANIMATION_CLIP_GET_CLASS (cursor->clip);
+    if (klass->sample_track == NULL)
+    {
+        lrg_bone_pose_set_identity (out_pose);
+        return;
+    }
+
+    /* Tracks added after the cursor was made are searched from scratch */
+    hints = track_index < cursor->n_tracks
+        ? &cursor->hints[track_index * LRG_ANIMATION_CLIP_CURSOR_SLOTS]
+        : NULL;
+
+    klass->sample_track (cursor->clip, track_index, time, hints, out_pose);
+}
@@ -27,10 +27,23 @@ G_BEGIN_DECLS
 LRG_AVAILABLE_IN_ALL
 G_DECLARE_DERIVABLE_TYPE (LrgAnimationClip, lrg_animation_clip, LRG, ANIMATION_CLIP, GObject)
 
+/**
+ * LRG_ANIMATION_CLIP_CURSOR_SLOTS:
+ *
+ * Number of search hints an #LrgAnimationClipCursor keeps per track,
+ * so clips that key position, rotation and scale separately can keep
+ * a hint for each.
+ */
+#define LRG_ANIMATION_CLIP_CURSOR_SLOTS (3)
+
 /**
  * LrgAnimationClipClass:
  * @parent_class: Parent class
  * @sample: Virtual method to sample the animation at a time
+ * @sample_track: Virtual method to sample one track. @hints is %NULL or
+ *   points to %LRG_ANIMATION_CLIP_CURSOR_SLOTS keyframe indices kept
+ *   by a cursor between calls; implementations may use them to start
+ *   the keyframe search and must leave valid indices behind.
  *
  * Class structure for #LrgAnimationClip.
  */
@@ -39,14 +52,37 @@ struct _LrgAnimationClipClass
     GObjectClass parent_class;
 
     /* Virtual methods */
-    void (*sample) (LrgAnimationClip *self,
-                    gfloat            time,
-                    GPtrArray        *out_poses);
+    void (*sample)       (LrgAnimationClip *self,
+                          gfloat            time,
+                          GPtrArray        *out_poses);
+    void (*sample_track) (LrgAnimationClip *self,
+                          guint             track_index,
+                          gfloat            time,
+                          guint            *hints,
+                          LrgBonePose      *out_pose);
 
     /*< private >*/
-    gpointer _reserved[8];
+    gpointer _reserved[7];
 };
 
+typedef struct _LrgAnimationClipCursor LrgAnimationClipCursor;
+
+#define LRG_TYPE_ANIMATION_CLIP_CURSOR (lrg_animation_clip_cursor_get_type ())
+
+/**
+ * LrgAnimationClipCursor:
+ *
+ * Per-instance playback state for sampling an #LrgAnimationClip.
+ *
+ * A cursor remembers where each track's keyframe search ended, so
+ * sampling at steadily increasing times only steps over the keyframes
+ * passed since the last sample instead of searching the whole track.
+ * Seeking backwards or far ahead falls back to a binary search. Give
+ * every playing instance of a clip its own cursor.
+ *
+ * Since: 1.0
+ */
+
 /**
  * lrg_animation_clip_new:
  * @name: The clip name
@@ -156,7 +192,8 @@ const gchar *           lrg_animation_clip_get_track_bone_name (LrgAnimationClip
  * @track_index: The track index
  * @keyframe: The keyframe to add
  *
- * Adds a keyframe to a track.
+ * Adds a keyframe to a track. Keyframes are kept sorted by time;
+ * a keyframe at the same time as existing ones goes after them.
  */
 LRG_AVAILABLE_IN_ALL
 void                    lrg_animation_clip_add_keyframe     (LrgAnimationClip       *self,
@@ -262,7 +299,8 @@ void                    lrg_animation_clip_sample           (LrgAnimationClip *s
  * @time: The time in seconds
  * @out_pose: (out): Output pose
  *
- * Samples a single track at a given time.
+ * Samples a single track at a given time. Each call searches the
+ * track's keyframes; use an #LrgAnimationClipCursor for playback.
  */
 LRG_AVAILABLE_IN_ALL
 void                    lrg_animation_clip_sample_track     (LrgAnimationClip *self,
@@ -279,4 +317,106 @@ void                    lrg_animation_clip_sample_track     (LrgAnimationClip *s
 LRG_AVAILABLE_IN_ALL
 void                    lrg_animation_clip_calculate_smooth_tangents (LrgAnimationClip *self);
 
+/**
+ * lrg_animation_clip_get_local_time:
+ * @self: A #LrgAnimationClip
+ * @time: The playback time in seconds
+ *
+ * Maps a playback time into the clip according to its loop mode.
+ *
+ * Returns: The time within the clip
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat                  lrg_animation_clip_get_local_time   (LrgAnimationClip *self,
+                                                             gfloat            time);
+
+/* Cursor */
+
+LRG_AVAILABLE_IN_ALL
+GType                   lrg_animation_clip_cursor_get_type  (void) G_GNUC_CONST;
+
+/**
+ * lrg_animation_clip_cursor_new:
+ * @clip: The clip to play
+ *
+ * Creates a cursor for sampling @clip. The cursor keeps a reference to
+ * the clip and covers the tracks it has now.
+ *
+ * Returns: (transfer full): A new #LrgAnimationClipCursor
+ */
+LRG_AVAILABLE_IN_ALL
+LrgAnimationClipCursor * lrg_animation_clip_cursor_new      (LrgAnimationClip *clip);
+
+/**
+ * lrg_animation_clip_cursor_copy:
+ * @cursor: A #LrgAnimationClipCursor
+ *
+ * Copies a cursor, including its position.
+ *
+ * Returns: (transfer full): A new #LrgAnimationClipCursor
+ */
+LRG_AVAILABLE_IN_ALL
+LrgAnimationClipCursor * lrg_animation_clip_cursor_copy     (const LrgAnimationClipCursor *cursor);
+
+/**
+ * lrg_animation_clip_cursor_free:
+ * @cursor: A #LrgAnimationClipCursor
+ *
+ * Frees a cursor.
+ */
+LRG_AVAILABLE_IN_ALL
+void                    lrg_animation_clip_cursor_free      (LrgAnimationClipCursor *cursor);
+
+/**
+ * lrg_animation_clip_cursor_get_clip:
+ * @cursor: A #LrgAnimationClipCursor
+ *
+ * Gets the clip the cursor plays.
+ *
+ * Returns: (transfer none): The clip
+ */
+LRG_AVAILABLE_IN_ALL
+LrgAnimationClip *      lrg_animation_clip_cursor_get_clip  (const LrgAnimationClipCursor *cursor);
+
+/**
+ * lrg_animation_clip_cursor_reset:
+ * @cursor: A #LrgAnimationClipCursor
+ *
+ * Moves the cursor back to the start of the clip.
+ */
+LRG_AVAILABLE_IN_ALL
+void                    lrg_animation_clip_cursor_reset     (LrgAnimationClipCursor *cursor);
+
+/**
+ * lrg_animation_clip_cursor_sample:
+ * @cursor: A #LrgAnimationClipCursor
+ * @time: The time in seconds
+ * @out_poses: (element-type LrgBonePose): Output array for sampled poses
+ *
+ * Samples every track like lrg_animation_clip_sample(), reusing the
+ * cursor's position. The result is the same as sampling without it.
+ */
+LRG_AVAILABLE_IN_ALL
+void                    lrg_animation_clip_cursor_sample    (LrgAnimationClipCursor *cursor,
+                                                             gfloat                  time,
+                                                             GPtrArray              *out_poses);
+
+/**
+ * lrg_animation_clip_cursor_sample_track:
+ * @cursor: A #LrgAnimationClipCursor
+ * @track_index: The track index
+ * @time: The time in seconds
+ * @out_pose: (out): Output pose
+ *
+ * Samples a single track like lrg_animation_clip_sample_track(),
+ * reusing the cursor's position for that track.
+ */
+LRG_AVAILABLE_IN_ALL
+void                    lrg_animation_clip_cursor_sample_track (LrgAnimationClipCursor *cursor,
+                                                                guint                   track_index,
+                                                                gfloat                  time,
+                                                                LrgBonePose            *out_pose);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (LrgAnimationClipCursor, lrg_animation_clip_cursor_free)
+
 G_END_DECLS
@@ -20,11 +20,12 @@
 
 typedef struct
 {
-    gchar            *name;
-    LrgAnimationClip *clip;
-    gfloat            speed;
-    gboolean          mirror;
-    gfloat            time;
+    gchar                  *name;
+    LrgAnimationClip       *clip;
+    LrgAnimationClipCursor *cursor;
+    gfloat                  speed;
+    gboolean                mirror;
+    gfloat                  time;
 } LrgAnimationStatePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgAnimationState, lrg_animation_state, G_TYPE_OBJECT)
@@ -107,7 +108,15 @@ lrg_animation_state_real_sample (LrgAnimationState *self,
         }
     }
 
-    lrg_animation_clip_sample_track (priv->clip, track_index, priv->time, out_pose);
+    /* Each state keeps its own cursor so playback only steps forward */
+    if (priv->cursor == NULL ||
+        lrg_animation_clip_cursor_get_clip (priv->cursor) != priv->clip)
+    {
+        g_clear_pointer (&priv->cursor, lrg_animation_clip_cursor_free);
+        priv->cursor = lrg_animation_clip_cursor_new (priv->clip);
+    }
+
+    lrg_animation_clip_cursor_sample_track (priv->cursor, track_index, priv->time, out_pose);
 
     /* Apply mirroring if enabled (swap left/right bones, negate X) */
     if (priv->mirror)
@@ -129,6 +138,7 @@ lrg_animation_state_finalize (GObject *object)
     LrgAnimationStatePrivate *priv = lrg_animation_state_get_instance_private (self);
 
     g_free (priv->name);
+    g_clear_pointer (&priv->cursor, lrg_animation_clip_cursor_free);
     g_clear_object (&priv->clip);
 
     G_OBJECT_CLASS (lrg_animation_state_parent_class)->finalize (object);
@@ -20,17 +20,19 @@
 
 typedef struct
 {
-    LrgSkeleton         *skeleton;
-    GHashTable          *clips;         /* name -> LrgAnimationClip */
-    gchar               *current_clip;
-    gchar               *blend_clip;    /* Target clip for crossfade */
-    gfloat               time;
-    gfloat               blend_time;
-    gfloat               blend_duration;
-    gfloat               blend_progress;
-    gfloat               speed;
-    gfloat               prev_time;     /* For event detection */
-    LrgAnimatorState     state;
+    LrgSkeleton            *skeleton;
+    GHashTable             *clips;         /* name -> LrgAnimationClip */
+    gchar                  *current_clip;
+    gchar                  *blend_clip;    /* Target clip for crossfade */
+    LrgAnimationClipCursor *cursor;        /* Playback cursor for current_clip */
+    LrgAnimationClipCursor *blend_cursor;  /* Playback cursor for blend_clip */
+    gfloat                  time;
+    gfloat                  blend_time;
+    gfloat                  blend_duration;
+    gfloat                  blend_progress;
+    gfloat                  speed;
+    gfloat                  prev_time;     /* For event detection */
+    LrgAnimatorState        state;
 } LrgAnimatorPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgAnimator, lrg_animator, G_TYPE_OBJECT)
@@ -52,6 +54,23 @@ enum
 static GParamSpec *properties[N_PROPS];
 static guint       signals[N_SIGNALS];
 
+/*
+ * Returns @cursor if it samples @clip, otherwise replaces it with a
+ * fresh cursor for @clip.
+ */
+static LrgAnimationClipCursor *
+animator_ensure_cursor (LrgAnimationClipCursor **cursor,
+                        LrgAnimationClip        *clip)
+{
+    if (*cursor == NULL || lrg_animation_clip_cursor_get_clip (*cursor) != clip)
+    {
+        g_clear_pointer (cursor, lrg_animation_clip_cursor_free);
+        *cursor = lrg_animation_clip_cursor_new (clip);
+    }
+
+    return *cursor;
+}
+
 static void
 lrg_animator_real_update (LrgAnimator *self,
                           gfloat       delta_time)
@@ -59,6 +78,8 @@ lrg_animator_real_update (LrgAnimator *self,
     LrgAnimatorPrivate *priv;
     LrgAnimationClip *clip;
     LrgAnimationClip *blend_clip;
+    LrgAnimationClipCursor *cursor;
+    LrgAnimationClipCursor *swap;
     gfloat adjusted_time;
     guint i;
     GList *events;
@@ -105,6 +126,15 @@ lrg_animator_real_update (LrgAnimator *self,
             priv->blend_clip = NULL;
             priv->time = priv->blend_time;
             priv->blend_progress = 0.0f;
+
+            /* The blend cursor already sits where the new clip plays */
+            swap = priv->cursor;
+            priv->cursor = priv->blend_cursor;
+            priv->blend_cursor = swap;
+
+            clip = g_hash_table_lookup (priv->clips, priv->current_clip);
+            if (clip == NULL)
+                return;
         }
         else
         {
@@ -118,6 +148,8 @@ lrg_animator_real_update (LrgAnimator *self,
 
     (void)lrg_skeleton_get_bone_count (priv->skeleton);
 
+    cursor = animator_ensure_cursor (&priv->cursor, clip);
+
     /* Sample current clip */
     for (i = 0; i < lrg_animation_clip_get_track_count (clip); i++)
     {
@@ -137,7 +169,7 @@ lrg_animator_real_update (LrgAnimator *self,
             bone_index = lrg_bone_get_index (bone);
         }
 
-        lrg_animation_clip_sample_track (clip, i, priv->time, &pose);
+        lrg_animation_clip_cursor_sample_track (cursor, i, priv->time, &pose);
 
         /* Blend with second clip if crossfading */
         if (priv->blend_clip != NULL && priv->blend_progress > 0.0f)
@@ -156,7 +188,8 @@ lrg_animator_real_update (LrgAnimator *self,
                     blend_bone_name = lrg_animation_clip_get_track_bone_name (blend_clip, j);
                     if (blend_bone_name != NULL && g_strcmp0 (blend_bone_name, bone_name) == 0)
                     {
-                        lrg_animation_clip_sample_track (blend_clip, j, priv->blend_time, &blend_pose);
+                        lrg_animation_clip_cursor_sample_track (animator_ensure_cursor (&priv->blend_cursor, blend_clip),
+                                                                j, priv->blend_time, &blend_pose);
                         lrg_bone_pose_lerp_to (&pose, &blend_pose, priv->blend_progress, &pose);
                         break;
                     }
@@ -181,6 +214,8 @@ lrg_animator_finalize (GObject *object)
     g_clear_pointer (&priv->clips, g_hash_table_unref);
     g_free (priv->current_clip);
     g_free (priv->blend_clip);
+    g_clear_pointer (&priv->cursor, lrg_animation_clip_cursor_free);
+    g_clear_pointer (&priv->blend_cursor, lrg_animation_clip_cursor_free);
 
     G_OBJECT_CLASS (lrg_animator_parent_class)->finalize (object);
 }
@@ -7,6 +7,7 @@
 
 #include "config.h"
 #include "lrg-blend-tree.h"
+#include "lrg-bone.h"
 #include <math.h>
 
 /**
@@ -17,8 +18,19 @@
  * #LrgBlendTree provides smooth blending between multiple animations
  * based on one or two parameters. Supports 1D threshold blending,
  * 2D directional blending, and direct weight control.
+ *
+ * Blend weights are recomputed in lrg_blend_tree_update() only when the
+ * parameters change. lrg_blend_tree_sample_pose() samples a whole
+ * skeleton into an #LrgPoseBuffer, and lrg_blend_tree_sample_batch()
+ * does so for many trees across worker threads.
  */
 
+/* Weights below this are treated as zero and the child is skipped */
+#define MIN_CHILD_WEIGHT 0.0001f
+
+/* Below this many trees a batch is sampled on the calling thread */
+#define PARALLEL_MIN_TREES 32
+
 /*
  * LrgBlendTreeChild boxed type
  */
@@ -75,13 +87,34 @@ lrg_blend_tree_child_free (LrgBlendTreeChild *child)
  * LrgBlendTree
  */
 
+/* Cached lookups for sampling one child over a whole skeleton */
+typedef struct
+{
+    LrgBlendTreeChild      *child;
+    LrgAnimationClip       *clip;     /* Owned by the cursor */
+    LrgAnimationClipCursor *cursor;
+    gint                   *tracks;   /* Track per bone index, or -1 */
+} ChildBinding;
+
 typedef struct
 {
-    LrgBlendType blend_type;
-    GList       *children;
-    gfloat       param_x;
-    gfloat       param_y;
-    gfloat       time;
+    LrgBlendType   blend_type;
+    GList         *children;
+    gfloat         param_x;
+    gfloat         param_y;
+    gfloat         time;
+
+    /* Parameters the current weights were computed for */
+    gboolean       weights_valid;
+    gfloat         weights_x;
+    gfloat         weights_y;
+
+    /* Whole-skeleton sampling */
+    LrgSkeleton   *skeleton;
+    guint          n_bones;
+    GArray        *bindings;   /* ChildBinding, in child order */
+    LrgPoseBuffer *bind_pose;
+    LrgPoseBuffer *scratch;
 } LrgBlendTreePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgBlendTree, lrg_blend_tree, G_TYPE_OBJECT)
@@ -272,19 +305,23 @@ compute_weights_direct (LrgBlendTree *self)
 }
 
 /*
- * Virtual method implementations
+ * Recomputes weights if the parameters moved since the last time.
+ * Direct weights live in the children, which callers edit in place,
+ * so those are always recomputed; it is a single pass anyway.
  */
-
 static void
-lrg_blend_tree_real_update (LrgBlendTree *self,
-                             gfloat        delta_time)
+update_weights (LrgBlendTree *self)
 {
     LrgBlendTreePrivate *priv;
-    GList *l;
 
     priv = lrg_blend_tree_get_instance_private (self);
 
-    /* Compute weights based on blend type */
+    if (priv->weights_valid &&
+        priv->blend_type != LRG_BLEND_TYPE_DIRECT &&
+        priv->weights_x == priv->param_x &&
+        priv->weights_y == priv->param_y)
+        return;
+
     switch (priv->blend_type)
     {
     case LRG_BLEND_TYPE_1D:
@@ -299,6 +336,156 @@ lrg_blend_tree_real_update (LrgBlendTree *self,
         break;
     }
 
+    priv->weights_valid = TRUE;
+    priv->weights_x = priv->param_x;
+    priv->weights_y = priv->param_y;
+}
+
+/*
+ * Whole-skeleton sampling
+ */
+
+static void
+child_binding_clear (gpointer data)
+{
+    ChildBinding *binding = data;
+
+    g_clear_pointer (&binding->cursor, lrg_animation_clip_cursor_free);
+    g_clear_pointer (&binding->tracks, g_free);
+}
+
+static void
+child_binding_init (ChildBinding      *binding,
+                    LrgBlendTreeChild *child,
+                    LrgSkeleton       *skeleton,
+                    guint              n_bones)
+{
+    guint n_tracks;
+    guint i;
+
+    binding->child = child;
+    binding->clip = child->clip;
+    binding->cursor = child->clip != NULL ? lrg_animation_clip_cursor_new (child->clip) : NULL;
+    binding->tracks = g_new (gint, MAX (n_bones, 1));
+
+    for (i = 0; i < n_bones; i++)
+        binding->tracks[i] = -1;
+
+    if (child->clip == NULL)
+        return;
+
+    n_tracks = lrg_animation_clip_get_track_count (child->clip);
+    for (i = 0; i < n_tracks; i++)
+    {
+        const gchar *bone_name;
+        LrgBone *bone;
+        gint index;
+
+        bone_name = lrg_animation_clip_get_track_bone_name (child->clip, i);
+        if (bone_name == NULL)
+            continue;
+
+        bone = lrg_skeleton_get_bone_by_name (skeleton, bone_name);
+        if (bone == NULL)
+            continue;
+
+        /* First track for a bone wins, as in lrg_blend_tree_sample() */
+        index = lrg_bone_get_index (bone);
+        if (index >= 0 && (guint)index < n_bones && binding->tracks[index] < 0)
+            binding->tracks[index] = (gint)i;
+    }
+}
+
+/* One past the largest bone index of @skeleton */
+static guint
+skeleton_index_count (LrgSkeleton *skeleton)
+{
+    GList *l;
+    guint n_bones = 0;
+
+    for (l = lrg_skeleton_get_bones (skeleton); l != NULL; l = l->next)
+    {
+        gint index = lrg_bone_get_index (l->data);
+
+        if (index >= 0)
+            n_bones = MAX (n_bones, (guint)index + 1);
+    }
+
+    return n_bones;
+}
+
+/*
+ * Brings the cached bindings in line with the children and @skeleton,
+ * rebuilding only what changed.
+ */
+static void
+update_bindings (LrgBlendTree *self,
+                 LrgSkeleton  *skeleton)
+{
+    LrgBlendTreePrivate *priv;
+    GList *l;
+    guint n_bones;
+    guint i;
+
+    priv = lrg_blend_tree_get_instance_private (self);
+
+    n_bones = skeleton_index_count (skeleton);
+
+    if (priv->skeleton != skeleton || priv->n_bones != n_bones)
+    {
+        g_set_object (&priv->skeleton, skeleton);
+        priv->n_bones = n_bones;
+        g_array_set_size (priv->bindings, 0);
+
+        lrg_pose_buffer_set_bone_count (priv->bind_pose, n_bones);
+        lrg_pose_buffer_set_bone_count (priv->scratch, n_bones);
+        lrg_pose_buffer_set_identity (priv->bind_pose);
+
+        for (l = lrg_skeleton_get_bones (skeleton); l != NULL; l = l->next)
+        {
+            gint index = lrg_bone_get_index (l->data);
+
+            if (index >= 0)
+                lrg_pose_buffer_set_pose (priv->bind_pose, index,
+                                          lrg_bone_get_bind_pose (l->data));
+        }
+    }
+
+    for (l = priv->children, i = 0; l != NULL; l = l->next, i++)
+    {
+        LrgBlendTreeChild *child = l->data;
+        ChildBinding *binding;
+
+        if (i >= priv->bindings->len)
+            g_array_set_size (priv->bindings, i + 1);
+
+        binding = &g_array_index (priv->bindings, ChildBinding, i);
+        if (binding->child == child && binding->clip == child->clip && binding->tracks != NULL)
+            continue;
+
+        child_binding_clear (binding);
+        child_binding_init (binding, child, skeleton, n_bones);
+    }
+
+    if (i < priv->bindings->len)
+        g_array_set_size (priv->bindings, i);
+}
+
+/*
+ * Virtual method implementations
+ */
+
+static void
+lrg_blend_tree_real_update (LrgBlendTree *self,
+                             gfloat        delta_time)
+{
+    LrgBlendTreePrivate *priv;
+    GList *l;
+
+    priv = lrg_blend_tree_get_instance_private (self);
+
+    update_weights (self);
+
     /* Update child times */
     for (l = priv->children; l != NULL; l = l->next)
     {
@@ -329,7 +516,7 @@ lrg_blend_tree_real_sample (LrgBlendTree *self,
         LrgBlendTreeChild *c = l->data;
         guint i;
 
-        if (c->computed_weight < 0.0001f || c->clip == NULL)
+        if (c->computed_weight < MIN_CHILD_WEIGHT || c->clip == NULL)
             continue;
 
         /* Find track by bone name and sample */
@@ -395,6 +582,10 @@ lrg_blend_tree_finalize (GObject *object)
     LrgBlendTreePrivate *priv = lrg_blend_tree_get_instance_private (self);
 
     g_list_free_full (priv->children, (GDestroyNotify)lrg_blend_tree_child_free);
+    g_array_unref (priv->bindings);
+    g_clear_object (&priv->skeleton);
+    lrg_pose_buffer_free (priv->bind_pose);
+    lrg_pose_buffer_free (priv->scratch);
 
     G_OBJECT_CLASS (lrg_blend_tree_parent_class)->finalize (object);
 }
@@ -467,6 +658,13 @@ lrg_blend_tree_init (LrgBlendTree *self)
     priv->param_x = 0.0f;
     priv->param_y = 0.0f;
     priv->time = 0.0f;
+    priv->weights_valid = FALSE;
+    priv->skeleton = NULL;
+    priv->n_bones = 0;
+    priv->bindings = g_array_new (FALSE, TRUE, sizeof (ChildBinding));
+    g_array_set_clear_func (priv->bindings, child_binding_clear);
+    priv->bind_pose = lrg_pose_buffer_new (0);
+    priv->scratch = lrg_pose_buffer_new (0);
 }
 
 /*
@@ -508,6 +706,7 @@ lrg_blend_tree_add_child (LrgBlendTree     *self,
     child->threshold = threshold;
 
     priv->children = g_list_append (priv->children, child);
+    priv->weights_valid = FALSE;
 }
 
 void
@@ -528,6 +727,7 @@ lrg_blend_tree_add_child_2d (LrgBlendTree     *self,
     child->position_y = y;
 
     priv->children = g_list_append (priv->children, child);
+    priv->weights_valid = FALSE;
 }
 
 void
@@ -541,6 +741,8 @@ lrg_blend_tree_clear_children (LrgBlendTree *self)
 
     g_list_free_full (priv->children, (GDestroyNotify)lrg_blend_tree_child_free);
     priv->children = NULL;
+    priv->weights_valid = FALSE;
+    g_array_set_size (priv->bindings, 0);
 }
 
 GList *
@@ -671,3 +873,146 @@ lrg_blend_tree_set_time (LrgBlendTree *self,
         c->time = time;
     }
 }
+
+void
+lrg_blend_tree_sample_pose (LrgBlendTree  *self,
+                            LrgSkeleton   *skeleton,
+                            LrgPoseBuffer *out_pose)
+{
+    LrgBlendTreePrivate *priv;
+    gfloat total_weight;
+    guint i;
+
+    g_return_if_fail (LRG_IS_BLEND_TREE (self));
+    g_return_if_fail (LRG_IS_SKELETON (skeleton));
+    g_return_if_fail (out_pose != NULL);
+
+    priv = lrg_blend_tree_get_instance_private (self);
+
+    update_weights (self);
+    update_bindings (self, skeleton);
+
+    /* Renormalize over the children that are actually sampled */
+    total_weight = 0.0f;
+    for (i = 0; i < priv->bindings->len; i++)
+    {
+        ChildBinding *binding = &g_array_index (priv->bindings, ChildBinding, i);
+
+        if (binding->cursor != NULL && binding->child->computed_weight >= MIN_CHILD_WEIGHT)
+            total_weight += binding->child->computed_weight;
+    }
+
+    if (total_weight <= 0.0f)
+    {
+        lrg_pose_buffer_set_from (out_pose, priv->bind_pose);
+        return;
+    }
+
+    lrg_pose_buffer_set_bone_count (out_pose, priv->n_bones);
+    lrg_pose_buffer_clear (out_pose);
+
+    for (i = 0; i < priv->bindings->len; i++)
+    {
+        ChildBinding *binding = &g_array_index (priv->bindings, ChildBinding, i);
+        LrgBlendTreeChild *child = binding->child;
+        guint bone;
+
+        if (binding->cursor == NULL || child->computed_weight < MIN_CHILD_WEIGHT)
+            continue;
+
+        lrg_pose_buffer_set_from (priv->scratch, priv->bind_pose);
+        for (bone = 0; bone < priv->n_bones; bone++)
+        {
+            LrgBonePose pose;
+
+            if (binding->tracks[bone] < 0)
+                continue;
+
+            lrg_animation_clip_cursor_sample_track (binding->cursor, binding->tracks[bone],
+                                                    child->time, &pose);
+            lrg_pose_buffer_set_pose (priv->scratch, bone, &pose);
+        }
+
+        lrg_pose_buffer_accumulate (out_pose, priv->scratch, child->computed_weight / total_weight);
+    }
+
+    lrg_pose_buffer_normalize_rotations (out_pose);
+}
+
+typedef struct
+{
+    LrgBlendTree  * const *trees;
+    LrgPoseBuffer * const *out_poses;
+    LrgSkeleton           *skeleton;
+    guint                  first;
+    guint                  last;
+} SampleBatchChunk;
+
+static void
+sample_batch_chunk (gpointer data,
+                    gpointer user_data)
+{
+    SampleBatchChunk *chunk = data;
+    guint i;
+
+    for (i = chunk->first; i < chunk->last; i++)
+        lrg_blend_tree_sample_pose (chunk->trees[i], chunk->skeleton, chunk->out_poses[i]);
+}
+
+void
+lrg_blend_tree_sample_batch (LrgBlendTree  * const *trees,
+                             guint                  n_trees,
+                             LrgSkeleton           *skeleton,
+                             LrgPoseBuffer * const *out_poses,
+                             guint                  max_threads)
+{
+    g_autofree SampleBatchChunk *chunks = NULL;
+    GThreadPool *pool;
+    guint n_chunks;
+    guint threads;
+    guint i;
+
+    g_return_if_fail (n_trees == 0 || trees != NULL);
+    g_return_if_fail (n_trees == 0 || out_poses != NULL);
+    g_return_if_fail (LRG_IS_SKELETON (skeleton));
+
+    threads = max_threads != 0 ? max_threads : g_get_num_processors ();
+    n_chunks = n_trees < PARALLEL_MIN_TREES ? 1 : MIN (threads, n_trees);
+    n_chunks = MAX (n_chunks, 1);
+
+    chunks = g_new (SampleBatchChunk, n_chunks);
+    for (i = 0; i < n_chunks; i++)
+    {
+        chunks[i].trees = trees;
+        chunks[i].out_poses = out_poses;
+        chunks[i].skeleton = skeleton;
+        chunks[i].first = (guint)((guint64)n_trees * i / n_chunks);
+        chunks[i].last = (guint)((guint64)n_trees * (i + 1) / n_chunks);
+    }
+
+    if (n_chunks == 1)
+    {
+        sample_batch_chunk (&chunks[0], NULL);
+        return;
+    }
+
+    /* Per-call pool; the calling thread samples the first chunk itself */
+    pool = g_thread_pool_new (sample_batch_chunk, NULL, (gint)n_chunks - 1, FALSE, NULL);
+    for (i = 1; i < n_chunks; i++)
+        g_thread_pool_push (pool, &chunks[i], NULL);
+
+    sample_batch_chunk (&chunks[0], NULL);
+    g_thread_pool_free (pool, FALSE, TRUE);
+}
+
+void
+lrg_blend_tree_invalidate (LrgBlendTree *self)
+{
+    LrgBlendTreePrivate *priv;
+
+    g_return_if_fail (LRG_IS_BLEND_TREE (self));
+
+    priv = lrg_blend_tree_get_instance_private (self);
+    priv->weights_valid = FALSE;
+    g_array_set_size (priv->bindings, 0);
+}
@@ -18,6 +18,8 @@
 #include "../lrg-enums.h"
 #include "lrg-animation-clip.h"
 #include "lrg-bone-pose.h"
+#include "lrg-pose-buffer.h"
+#include "lrg-skeleton.h"
 
 G_BEGIN_DECLS
 
@@ -243,6 +245,58 @@ void                lrg_blend_tree_sample           (LrgBlendTree   *self,
                                                       LrgBonePose    *out_pose,
                                                       const gchar    *bone_name);
 
+/**
+ * lrg_blend_tree_sample_pose:
+ * @self: A #LrgBlendTree
+ * @skeleton: The skeleton to pose
+ * @out_pose: Return location; resized to the skeleton's bone indices
+ *
+ * Samples the blended pose of every bone of @skeleton at once. Entry
+ * @i of @out_pose is the local pose of the bone with index @i.
+ *
+ * Children with no weight are skipped. The others are sampled through
+ * per-child cursors into a flat #LrgPoseBuffer and blended four bones
+ * at a time. Bones a child's clip has no track for take their bind
+ * pose. Track-to-bone lookups are cached until the children, their
+ * clips or the skeleton change.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blend_tree_sample_pose      (LrgBlendTree   *self,
+                                                      LrgSkeleton    *skeleton,
+                                                      LrgPoseBuffer  *out_pose);
+
+/**
+ * lrg_blend_tree_sample_batch:
+ * @trees: (array length=n_trees): Distinct blend trees
+ * @n_trees: Number of trees
+ * @skeleton: The skeleton every tree poses
+ * @out_poses: (array length=n_trees): One return buffer per tree
+ * @max_threads: Worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Calls lrg_blend_tree_sample_pose() for every tree, splitting large
+ * batches across worker threads. The trees' clips and @skeleton are
+ * only read, so they may be shared between trees; the trees
+ * themselves must all be different.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blend_tree_sample_batch     (LrgBlendTree  * const *trees,
+                                                      guint                  n_trees,
+                                                      LrgSkeleton           *skeleton,
+                                                      LrgPoseBuffer * const *out_poses,
+                                                      guint                  max_threads);
+
+/**
+ * lrg_blend_tree_invalidate:
+ * @self: A #LrgBlendTree
+ *
+ * Drops cached blend weights and track lookups. Blend weights are
+ * only recomputed when the blend parameters change, so call this
+ * after editing a child returned by lrg_blend_tree_get_children().
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_blend_tree_invalidate       (LrgBlendTree   *self);
+
 /**
  * lrg_blend_tree_get_time:
  * @self: A #LrgBlendTree
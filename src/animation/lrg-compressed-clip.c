@@ -0,0 +1,708 @@
+/* lrg-compressed-clip.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "config.h"
+#include "lrg-compressed-clip.h"
+#include "lrg-animation-clip-private.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * SECTION:lrg-compressed-clip
+ * @Title: LrgCompressedClip
+ * @Short_description: Compressed animation clip
+ *
+ * #LrgCompressedClip is a read-only #LrgAnimationClip built from an
+ * ordinary clip. It samples like the clip it was made from, to within
+ * a chosen tolerance, while storing far fewer keys.
+ *
+ * Every track is split into position, rotation and scale channels and
+ * each channel keeps its own keys, so a bone that only rotates stores
+ * a single position and scale key. Keys are chosen greedily: a channel
+ * is resampled densely and each key is stretched as far forward as
+ * linear interpolation stays within the tolerance of the samples.
+ * Rotations are stored as three 15-bit components, leaving out the
+ * largest one, and interpolated with a normalized lerp.
+ *
+ * Key data lives in shared pools laid out structure-of-arrays: one pool
+ * of key times, one of position and scale components and one of
+ * quantized rotations, with the x, y and z components of a channel in
+ * separate runs.
+ *
+ * Sample through an #LrgAnimationClipCursor for playback; the cursor
+ * keeps a search hint per channel.
+ */
+
+/* Rate the source clip is resampled at before key reduction */
+#define RESAMPLE_RATE 60.0f
+
+/* Smallest tolerance; rotation quantization error stays below this */
+#define MIN_TOLERANCE 0.0001f
+
+#define QUAT_RANGE   0.70710678f    /* |component| of all but the largest */
+#define QUAT_BITS    15
+#define QUAT_MAX     ((1 << QUAT_BITS) - 1)
+#define QUAT_MASK    0x7fff
+#define QUAT_TOP_BIT 0x8000
+
+enum
+{
+    CHANNEL_POSITION,
+    CHANNEL_ROTATION,
+    CHANNEL_SCALE,
+    N_CHANNELS
+};
+
+G_STATIC_ASSERT (N_CHANNELS <= LRG_ANIMATION_CLIP_CURSOR_SLOTS);
+
+typedef struct
+{
+    guint n_keys;
+    guint time_offset;   /* into times */
+    guint value_offset;  /* into values, or rotations for CHANNEL_ROTATION */
+} CompressedChannel;
+
+struct _LrgCompressedClip
+{
+    LrgAnimationClip  parent_instance;
+
+    gfloat            tolerance;
+    GArray           *channels;   /* CompressedChannel, N_CHANNELS per track */
+    GArray           *times;      /* gfloat */
+    GArray           *values;     /* gfloat, x run, y run, z run per channel */
+    GArray           *rotations;  /* guint16, same layout */
+};
+
+G_DEFINE_TYPE (LrgCompressedClip, lrg_compressed_clip, LRG_TYPE_ANIMATION_CLIP)
+
+/*
+ * Rotation quantization
+ */
+
+static void
+quat_encode (const gfloat *q,
+             guint16      *out)
+{
+    gfloat sign;
+    guint largest;
+    guint i;
+    guint j;
+
+    largest = 0;
+    for (i = 1; i < 4; i++)
+    {
+        if (fabsf (q[i]) > fabsf (q[largest]))
+            largest = i;
+    }
+
+    /* q and -q are the same rotation; make the dropped component positive */
+    sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+    for (i = 0, j = 0; i < 4; i++)
+    {
+        gfloat v;
+
+        if (i == largest)
+            continue;
+
+        v = CLAMP (q[i] * sign / QUAT_RANGE, -1.0f, 1.0f);
+        out[j++] = (guint16)lrintf ((v * 0.5f + 0.5f) * QUAT_MAX);
+    }
+
+    /* Index of the dropped component goes in the top bits of two words */
+    if (largest & 1)
+        out[0] |= QUAT_TOP_BIT;
+    if (largest & 2)
+        out[1] |= QUAT_TOP_BIT;
+}
+
+static void
+quat_decode (guint16  w0,
+             guint16  w1,
+             guint16  w2,
+             gfloat  *q)
+{
+    guint16 words[3];
+    gfloat sum;
+    guint largest;
+    guint i;
+    guint j;
+
+    largest = ((w0 & QUAT_TOP_BIT) ? 1 : 0) | ((w1 & QUAT_TOP_BIT) ? 2 : 0);
+    words[0] = w0;
+    words[1] = w1;
+    words[2] = w2;
+
+    sum = 0.0f;
+    for (i = 0, j = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+
+        q[i] = (((gfloat)(words[j++] & QUAT_MASK) / QUAT_MAX) * 2.0f - 1.0f) * QUAT_RANGE;
+        sum += q[i] * q[i];
+    }
+
+    q[largest] = sqrtf (MAX (0.0f, 1.0f - sum));
+}
+
+/*
+ * Channel interpolation
+ */
+
+static guint
+channel_dims (guint channel)
+{
+    return channel == CHANNEL_ROTATION ? 4 : 3;
+}
+
+/*
+ * Linear interpolation for position and scale; normalized lerp along
+ * the shorter arc for rotations.
+ */
+static void
+channel_interpolate (guint         channel,
+                     const gfloat *a,
+                     const gfloat *b,
+                     gfloat        t,
+                     gfloat       *out)
+{
+    gfloat sign;
+    gfloat len;
+    guint i;
+
+    if (channel != CHANNEL_ROTATION)
+    {
+        for (i = 0; i < 3; i++)
+            out[i] = a[i] + (b[i] - a[i]) * t;
+        return;
+    }
+
+    sign = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]) < 0.0f ? -1.0f : 1.0f;
+
+    len = 0.0f;
+    for (i = 0; i < 4; i++)
+    {
+        out[i] = a[i] + (b[i] * sign - a[i]) * t;
+        len += out[i] * out[i];
+    }
+
+    len = sqrtf (len);
+    if (len > 0.0f)
+    {
+        for (i = 0; i < 4; i++)
+            out[i] /= len;
+    }
+}
+
+static gfloat
+channel_error (guint         channel,
+               const gfloat *a,
+               const gfloat *b)
+{
+    gfloat sign;
+    gfloat error;
+    guint i;
+
+    sign = 1.0f;
+    if (channel == CHANNEL_ROTATION &&
+        (a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]) < 0.0f)
+        sign = -1.0f;
+
+    error = 0.0f;
+    for (i = 0; i < channel_dims (channel); i++)
+        error = MAX (error, fabsf (a[i] - b[i] * sign));
+
+    return error;
+}
+
+static void
+pose_get_channel (const LrgBonePose *pose,
+                  guint              channel,
+                  gfloat            *out)
+{
+    switch (channel)
+    {
+    case CHANNEL_POSITION:
+        out[0] = pose->position_x;
+        out[1] = pose->position_y;
+        out[2] = pose->position_z;
+        break;
+    case CHANNEL_ROTATION:
+        out[0] = pose->rotation_x;
+        out[1] = pose->rotation_y;
+        out[2] = pose->rotation_z;
+        out[3] = pose->rotation_w;
+        break;
+    case CHANNEL_SCALE:
+        out[0] = pose->scale_x;
+        out[1] = pose->scale_y;
+        out[2] = pose->scale_z;
+        break;
+    }
+}
+
+static void
+pose_set_channel (LrgBonePose  *pose,
+                  guint         channel,
+                  const gfloat *v)
+{
+    switch (channel)
+    {
+    case CHANNEL_POSITION:
+        pose->position_x = v[0];
+        pose->position_y = v[1];
+        pose->position_z = v[2];
+        break;
+    case CHANNEL_ROTATION:
+        pose->rotation_x = v[0];
+        pose->rotation_y = v[1];
+        pose->rotation_z = v[2];
+        pose->rotation_w = v[3];
+        break;
+    case CHANNEL_SCALE:
+        pose->scale_x = v[0];
+        pose->scale_y = v[1];
+        pose->scale_z = v[2];
+        break;
+    }
+}
+
+/*
+ * Compression
+ */
+
+static gint
+compare_floats (gconstpointer a,
+                gconstpointer b)
+{
+    gfloat fa = *(const gfloat *)a;
+    gfloat fb = *(const gfloat *)b;
+
+    return (fa > fb) - (fa < fb);
+}
+
+/*
+ * Times a track is resampled at: a uniform grid over the clip plus the
+ * track's own keyframes, so sharp keys are never smoothed away.
+ */
+static GArray *
+collect_sample_times (LrgAnimationClip *source,
+                      guint             track_index)
+{
+    GArray *times;
+    gfloat end;
+    guint n_keys;
+    guint n_steps;
+    guint i;
+    guint j;
+
+    times = g_array_new (FALSE, FALSE, sizeof (gfloat));
+    n_keys = lrg_animation_clip_get_keyframe_count (source, track_index);
+
+    end = lrg_animation_clip_get_duration (source);
+    if (end <= 0.0f && n_keys > 0)
+        end = lrg_animation_clip_get_keyframe (source, track_index, n_keys - 1)->time;
+
+    n_steps = (guint)ceilf (MAX (end, 0.0f) * RESAMPLE_RATE);
+    for (i = 0; i <= n_steps; i++)
+    {
+        gfloat t = MIN ((gfloat)i / RESAMPLE_RATE, MAX (end, 0.0f));
+
+        g_array_append_val (times, t);
+    }
+
+    for (i = 0; i < n_keys; i++)
+    {
+        gfloat t = lrg_animation_clip_get_keyframe (source, track_index, i)->time;
+
+        if (t >= 0.0f && t <= end)
+            g_array_append_val (times, t);
+    }
+
+    g_array_sort (times, compare_floats);
+
+    /* Drop duplicates */
+    for (i = 1, j = 1; i < times->len; i++)
+    {
+        gfloat t = g_array_index (times, gfloat, i);
+
+        if (t - g_array_index (times, gfloat, j - 1) > 1e-6f)
+            g_array_index (times, gfloat, j++) = t;
+    }
+    g_array_set_size (times, MIN (j, times->len));
+
+    return times;
+}
+
+/*
+ * Whether a straight segment from key @a to key @b reproduces every
+ * sample in between within @tolerance.
+ */
+static gboolean
+segment_fits (guint         channel,
+              const gfloat *times,
+              const gfloat *samples,
+              const gfloat *keys,
+              guint         a,
+              guint         b,
+              gfloat        tolerance)
+{
+    gfloat value[4];
+    guint i;
+
+    for (i = a + 1; i < b; i++)
+    {
+        gfloat t = (times[i] - times[a]) / (times[b] - times[a]);
+
+        channel_interpolate (channel, &keys[a * 4], &keys[b * 4], t, value);
+        if (channel_error (channel, value, &samples[i * 4]) > tolerance)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+compress_channel (LrgCompressedClip *self,
+                  guint              channel,
+                  const gfloat      *times,
+                  const gfloat      *samples,
+                  guint              n_samples)
+{
+    CompressedChannel info;
+    g_autoptr(GArray) picked = NULL;
+    g_autofree gfloat *keys = NULL;
+    guint dims;
+    guint a;
+    guint b;
+    guint i;
+    guint k;
+
+    dims = channel_dims (channel);
+
+    /* The values the sampler will actually see at each key */
+    keys = g_new0 (gfloat, n_samples * 4);
+    for (i = 0; i < n_samples; i++)
+    {
+        if (channel == CHANNEL_ROTATION)
+        {
+            guint16 words[3];
+
+            quat_encode (&samples[i * 4], words);
+            quat_decode (words[0], words[1], words[2], &keys[i * 4]);
+        }
+        else
+        {
+            memcpy (&keys[i * 4], &samples[i * 4], sizeof (gfloat) * 4);
+        }
+    }
+
+    picked = g_array_new (FALSE, FALSE, sizeof (guint));
+
+    if (n_samples > 0)
+    {
+        a = 0;
+        g_array_append_val (picked, a);
+
+        /* A constant channel needs one key */
+        for (i = 1; i < n_samples; i++)
+        {
+            if (channel_error (channel, &keys[0], &samples[i * 4]) > self->tolerance)
+                break;
+        }
+
+        while (i < n_samples && a + 1 < n_samples)
+        {
+            b = a + 1;
+            while (b + 1 < n_samples &&
+                   segment_fits (channel, times, samples, keys, a, b + 1, self->tolerance))
+                b++;
+
+            g_array_append_val (picked, b);
+            a = b;
+        }
+    }
+
+    info.n_keys = picked->len;
+    info.time_offset = self->times->len;
+    info.value_offset = channel == CHANNEL_ROTATION ? self->rotations->len : self->values->len;
+
+    for (k = 0; k < picked->len; k++)
+        g_array_append_val (self->times, times[g_array_index (picked, guint, k)]);
+
+    if (channel == CHANNEL_ROTATION)
+    {
+        guint16 *words;
+
+        g_array_set_size (self->rotations, self->rotations->len + picked->len * 3);
+        words = &g_array_index (self->rotations, guint16, info.value_offset);
+
+        for (k = 0; k < picked->len; k++)
+        {
+            guint16 encoded[3];
+
+            quat_encode (&samples[g_array_index (picked, guint, k) * 4], encoded);
+            words[k] = encoded[0];
+            words[picked->len + k] = encoded[1];
+            words[picked->len * 2 + k] = encoded[2];
+        }
+    }
+    else
+    {
+        gfloat *values;
+
+        g_array_set_size (self->values, self->values->len + picked->len * dims);
+        values = &g_array_index (self->values, gfloat, info.value_offset);
+
+        for (k = 0; k < picked->len; k++)
+        {
+            for (i = 0; i < dims; i++)
+                values[picked->len * i + k] = keys[g_array_index (picked, guint, k) * 4 + i];
+        }
+    }
+
+    g_array_append_val (self->channels, info);
+}
+
+static void
+compress_track (LrgCompressedClip *self,
+                LrgAnimationClip  *source,
+                guint              track_index)
+{
+    g_autoptr(GArray) times = NULL;
+    g_autofree gfloat *samples = NULL;
+    LrgBonePose pose;
+    guint hint = 0;
+    guint channel;
+    guint i;
+
+    if (lrg_animation_clip_get_keyframe_count (source, track_index) == 0)
+    {
+        for (channel = 0; channel < N_CHANNELS; channel++)
+            compress_channel (self, channel, NULL, NULL, 0);
+        return;
+    }
+
+    times = collect_sample_times (source, track_index);
+    samples = g_new0 (gfloat, times->len * 4);
+
+    for (channel = 0; channel < N_CHANNELS; channel++)
+    {
+        hint = 0;
+        for (i = 0; i < times->len; i++)
+        {
+            lrg_animation_clip_sample_track_local (source, track_index,
+                                                   g_array_index (times, gfloat, i),
+                                                   &hint, &pose);
+            pose_get_channel (&pose, channel, &samples[i * 4]);
+        }
+
+        compress_channel (self, channel, (const gfloat *)times->data, samples, times->len);
+    }
+}
+
+/*
+ * Sampling
+ */
+
+static void
+channel_get_key (LrgCompressedClip       *self,
+                 guint                    channel,
+                 const CompressedChannel *info,
+                 guint                    key,
+                 gfloat                  *out)
+{
+    guint i;
+
+    if (channel == CHANNEL_ROTATION)
+    {
+        const guint16 *words = &g_array_index (self->rotations, guint16, info->value_offset);
+
+        quat_decode (words[key], words[info->n_keys + key], words[info->n_keys * 2 + key], out);
+        return;
+    }
+
+    for (i = 0; i < 3; i++)
+        out[i] = g_array_index (self->values, gfloat, info->value_offset + info->n_keys * i + key);
+}
+
+static void
+sample_channel (LrgCompressedClip       *self,
+                guint                    channel,
+                const CompressedChannel *info,
+                gfloat                   time,
+                guint                   *hint,
+                gfloat                  *out)
+{
+    const gfloat *times;
+    gfloat a[4];
+    gfloat b[4];
+    gfloat t;
+    gint key;
+
+    times = &g_array_index (self->times, gfloat, info->time_offset);
+    key = lrg_animation_clip_find_key (times, sizeof (gfloat), info->n_keys, time, hint);
+
+    if (key < 0)
+    {
+        channel_get_key (self, channel, info, 0, out);
+        return;
+    }
+
+    if ((guint)key + 1 >= info->n_keys)
+    {
+        channel_get_key (self, channel, info, key, out);
+        return;
+    }
+
+    channel_get_key (self, channel, info, key, a);
+    channel_get_key (self, channel, info, key + 1, b);
+
+    t = (time - times[key]) / (times[key + 1] - times[key]);
+    channel_interpolate (channel, a, b, t, out);
+}
+
+static void
+lrg_compressed_clip_sample_track (LrgAnimationClip *clip,
+                                  guint             track_index,
+                                  gfloat            time,
+                                  guint            *hints,
+                                  LrgBonePose      *out_pose)
+{
+    LrgCompressedClip *self = LRG_COMPRESSED_CLIP (clip);
+    const CompressedChannel *infos;
+    gfloat local_time;
+    gfloat value[4];
+    guint channel;
+
+    if ((track_index + 1) * N_CHANNELS > self->channels->len)
+    {
+        lrg_bone_pose_set_identity (out_pose);
+        return;
+    }
+
+    infos = &g_array_index (self->channels, CompressedChannel, track_index * N_CHANNELS);
+
+    if (infos[CHANNEL_POSITION].n_keys == 0)
+    {
+        lrg_bone_pose_set_identity (out_pose);
+        return;
+    }
+
+    local_time = lrg_animation_clip_get_local_time (clip, time);
+
+    for (channel = 0; channel < N_CHANNELS; channel++)
+    {
+        sample_channel (self, channel, &infos[channel], local_time,
+                        hints != NULL ? &hints[channel] : NULL, value);
+        pose_set_channel (out_pose, channel, value);
+    }
+}
+
+/*
+ * GObject
+ */
+
+static void
+lrg_compressed_clip_finalize (GObject *object)
+{
+    LrgCompressedClip *self = LRG_COMPRESSED_CLIP (object);
+
+    g_array_unref (self->channels);
+    g_array_unref (self->times);
+    g_array_unref (self->values);
+    g_array_unref (self->rotations);
+
+    G_OBJECT_CLASS (lrg_compressed_clip_parent_class)->finalize (object);
+}
+
+static void
+lrg_compressed_clip_class_init (LrgCompressedClipClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+    LrgAnimationClipClass *clip_class = LRG_ANIMATION_CLIP_CLASS (klass);
+
+    object_class->finalize = lrg_compressed_clip_finalize;
+
+    clip_class->sample_track = lrg_compressed_clip_sample_track;
+}
+
+static void
+lrg_compressed_clip_init (LrgCompressedClip *self)
+{
+    self->tolerance = MIN_TOLERANCE;
+    self->channels = g_array_new (FALSE, FALSE, sizeof (CompressedChannel));
+    self->times = g_array_new (FALSE, FALSE, sizeof (gfloat));
+    self->values = g_array_new (FALSE, FALSE, sizeof (gfloat));
+    self->rotations = g_array_new (FALSE, FALSE, sizeof (guint16));
+}
+
+/*
+ * Public API
+ */
+
+LrgCompressedClip *
+lrg_compressed_clip_new (LrgAnimationClip *source,
+                         gfloat            tolerance)
+{
+    LrgCompressedClip *self;
+    LrgAnimationClip *clip;
+    guint n_tracks;
+    guint n_events;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_ANIMATION_CLIP (source), NULL);
+
+    self = g_object_new (LRG_TYPE_COMPRESSED_CLIP,
+                         "name", lrg_animation_clip_get_name (source),
+                         "duration", lrg_animation_clip_get_duration (source),
+                         "loop-mode", lrg_animation_clip_get_loop_mode (source),
+                         NULL);
+    clip = LRG_ANIMATION_CLIP (self);
+    self->tolerance = MAX (tolerance, MIN_TOLERANCE);
+
+    n_events = lrg_animation_clip_get_event_count (source);
+    for (i = 0; i < n_events; i++)
+        lrg_animation_clip_add_event (clip, lrg_animation_clip_get_event (source, i));
+
+    n_tracks = lrg_animation_clip_get_track_count (source);
+    for (i = 0; i < n_tracks; i++)
+    {
+        lrg_animation_clip_add_track (clip, lrg_animation_clip_get_track_bone_name (source, i));
+        compress_track (self, source, i);
+    }
+
+    return self;
+}
+
+gfloat
+lrg_compressed_clip_get_tolerance (LrgCompressedClip *self)
+{
+    g_return_val_if_fail (LRG_IS_COMPRESSED_CLIP (self), 0.0f);
+
+    return self->tolerance;
+}
+
+guint
+lrg_compressed_clip_get_key_count (LrgCompressedClip *self)
+{
+    g_return_val_if_fail (LRG_IS_COMPRESSED_CLIP (self), 0);
+
+    return self->times->len;
+}
+
+gsize
+lrg_compressed_clip_get_data_size (LrgCompressedClip *self)
+{
+    g_return_val_if_fail (LRG_IS_COMPRESSED_CLIP (self), 0);
+
+    return self->channels->len * sizeof (CompressedChannel) +
+           self->times->len * sizeof (gfloat) +
+           self->values->len * sizeof (gfloat) +
+           self->rotations->len * sizeof (guint16);
+}
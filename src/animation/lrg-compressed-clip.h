@@ -0,0 +1,86 @@
+/* lrg-compressed-clip.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Animation clip stored as reduced, quantized keyframe channels.
+ */
+
+#pragma once
+
+#if !defined(LIBREGNUM_INSIDE) && !defined(LIBREGNUM_COMPILATION)
+#error "Only <libregnum.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include "../lrg-version.h"
+#include "lrg-animation-clip.h"
+
+G_BEGIN_DECLS
+
+#define LRG_TYPE_COMPRESSED_CLIP (lrg_compressed_clip_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgCompressedClip, lrg_compressed_clip, LRG, COMPRESSED_CLIP, LrgAnimationClip)
+
+/**
+ * lrg_compressed_clip_new:
+ * @source: The clip to compress
+ * @tolerance: Largest error allowed per component
+ *
+ * Creates a compressed copy of @source. Each track is resampled at
+ * 60 Hz and at its own keyframes, then split into position, rotation
+ * and scale channels that keep only the keys linear interpolation
+ * needs to stay within @tolerance of the samples. Rotations are
+ * quantized to 48 bits.
+ *
+ * @tolerance applies to each component of position, scale and the
+ * rotation quaternion. Values below 0.0001 are raised to it, since
+ * rotation quantization alone can be off by that much.
+ *
+ * The name, duration, loop mode, events and track bone names are
+ * copied. The tracks of a compressed clip have no editable keyframes;
+ * keyframes added to them are ignored when sampling.
+ *
+ * Returns: (transfer full): A new #LrgCompressedClip
+ */
+LRG_AVAILABLE_IN_ALL
+LrgCompressedClip * lrg_compressed_clip_new            (LrgAnimationClip  *source,
+                                                        gfloat             tolerance);
+
+/**
+ * lrg_compressed_clip_get_tolerance:
+ * @self: A #LrgCompressedClip
+ *
+ * Gets the tolerance the clip was compressed with.
+ *
+ * Returns: The tolerance
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat              lrg_compressed_clip_get_tolerance  (LrgCompressedClip *self);
+
+/**
+ * lrg_compressed_clip_get_key_count:
+ * @self: A #LrgCompressedClip
+ *
+ * Gets the number of keys kept over all channels of all tracks.
+ *
+ * Returns: The key count
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_compressed_clip_get_key_count  (LrgCompressedClip *self);
+
+/**
+ * lrg_compressed_clip_get_data_size:
+ * @self: A #LrgCompressedClip
+ *
+ * Gets the number of bytes used by the compressed keys and the
+ * channel table.
+ *
+ * Returns: The size in bytes
+ */
+LRG_AVAILABLE_IN_ALL
+gsize               lrg_compressed_clip_get_data_size  (LrgCompressedClip *self);
+
+G_END_DECLS
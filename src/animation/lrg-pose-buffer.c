@@ -0,0 +1,447 @@
+/* lrg-pose-buffer.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "config.h"
+#include "lrg-pose-buffer.h"
+#include "lrg-bone.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * SECTION:lrg-pose-buffer
+ * @Title: LrgPoseBuffer
+ * @Short_description: Whole-skeleton pose storage
+ *
+ * #LrgPoseBuffer holds one pose per bone laid out structure-of-arrays.
+ * Each of the ten pose components is a separate run of floats padded to
+ * a multiple of four bones, and the blending functions process four
+ * bones per instruction using GCC vector extensions.
+ *
+ * |[<!-- language="C" -->
+ * g_autoptr(LrgPoseBuffer) result = lrg_pose_buffer_new (n_bones);
+ *
+ * lrg_pose_buffer_clear (result);
+ * lrg_pose_buffer_accumulate (result, walk, 0.25f);
+ * lrg_pose_buffer_accumulate (result, run, 0.75f);
+ * lrg_pose_buffer_normalize_rotations (result);
+ * lrg_pose_buffer_apply (result, skeleton);
+ * ]|
+ */
+
+/* Component runs, in this order */
+enum
+{
+    COMPONENT_POSITION_X,
+    COMPONENT_POSITION_Y,
+    COMPONENT_POSITION_Z,
+    COMPONENT_ROTATION_X,
+    COMPONENT_ROTATION_Y,
+    COMPONENT_ROTATION_Z,
+    COMPONENT_ROTATION_W,
+    COMPONENT_SCALE_X,
+    COMPONENT_SCALE_Y,
+    COMPONENT_SCALE_Z,
+    N_COMPONENTS
+};
+
+#define LANES 4
+
+typedef gfloat Lane  __attribute__ ((vector_size (LANES * sizeof (gfloat))));
+typedef gint32 LaneMask __attribute__ ((vector_size (LANES * sizeof (gint32))));
+
+struct _LrgPoseBuffer
+{
+    guint   n_bones;
+    guint   stride;     /* n_bones rounded up to LANES */
+    gfloat *data;       /* N_COMPONENTS runs of stride floats */
+};
+
+G_DEFINE_BOXED_TYPE (LrgPoseBuffer, lrg_pose_buffer,
+                     lrg_pose_buffer_copy, lrg_pose_buffer_free)
+
+#define COMPONENT(self, c) ((self)->data + (gsize)(c) * (self)->stride)
+
+static inline Lane
+lane_load (const gfloat *p)
+{
+    Lane v;
+
+    memcpy (&v, p, sizeof (v));
+    return v;
+}
+
+static inline void
+lane_store (gfloat *p,
+            Lane    v)
+{
+    memcpy (p, &v, sizeof (v));
+}
+
+static inline Lane
+lane_splat (gfloat x)
+{
+    Lane v = { x, x, x, x };
+
+    return v;
+}
+
+static inline Lane
+lane_sqrt (Lane v)
+{
+    Lane r = { sqrtf (v[0]), sqrtf (v[1]), sqrtf (v[2]), sqrtf (v[3]) };
+
+    return r;
+}
+
+/* @a in lanes where @mask is set, @b elsewhere */
+static inline Lane
+lane_select (LaneMask mask,
+             Lane     a,
+             Lane     b)
+{
+    return (Lane)((mask & (LaneMask)a) | (~mask & (LaneMask)b));
+}
+
+/* @v with its sign flipped in lanes where @dot is negative */
+static inline Lane
+lane_flip_where_negative (Lane v,
+                          Lane dot)
+{
+    LaneMask sign_bit = { G_MININT32, G_MININT32, G_MININT32, G_MININT32 };
+    LaneMask negative = dot < lane_splat (0.0f);
+
+    return (Lane)((LaneMask)v ^ (negative & sign_bit));
+}
+
+static void
+pose_buffer_fill (LrgPoseBuffer *self,
+                  guint          first,
+                  gboolean       identity)
+{
+    guint c;
+
+    for (c = 0; c < N_COMPONENTS; c++)
+    {
+        gfloat value = 0.0f;
+        gfloat *run = COMPONENT (self, c);
+        guint i;
+
+        if (identity &&
+            (c == COMPONENT_ROTATION_W || c >= COMPONENT_SCALE_X))
+            value = 1.0f;
+
+        for (i = first; i < self->n_bones; i++)
+            run[i] = value;
+    }
+}
+
+LrgPoseBuffer *
+lrg_pose_buffer_new (guint n_bones)
+{
+    LrgPoseBuffer *self;
+
+    self = g_slice_new0 (LrgPoseBuffer);
+    self->n_bones = n_bones;
+    self->stride = (n_bones + LANES - 1) / LANES * LANES;
+    self->data = g_new0 (gfloat, (gsize)self->stride * N_COMPONENTS);
+
+    pose_buffer_fill (self, 0, TRUE);
+
+    return self;
+}
+
+LrgPoseBuffer *
+lrg_pose_buffer_copy (const LrgPoseBuffer *self)
+{
+    LrgPoseBuffer *copy;
+
+    g_return_val_if_fail (self != NULL, NULL);
+
+    copy = g_slice_new0 (LrgPoseBuffer);
+    copy->n_bones = self->n_bones;
+    copy->stride = self->stride;
+    copy->data = g_memdup2 (self->data, sizeof (gfloat) * self->stride * N_COMPONENTS);
+
+    return copy;
+}
+
+void
+lrg_pose_buffer_free (LrgPoseBuffer *self)
+{
+    if (self == NULL)
+        return;
+
+    g_free (self->data);
+    g_slice_free (LrgPoseBuffer, self);
+}
+
+guint
+lrg_pose_buffer_get_bone_count (const LrgPoseBuffer *self)
+{
+    g_return_val_if_fail (self != NULL, 0);
+
+    return self->n_bones;
+}
+
+void
+lrg_pose_buffer_set_bone_count (LrgPoseBuffer *self,
+                                guint          n_bones)
+{
+    gfloat *data;
+    guint stride;
+    guint old_count;
+    guint c;
+
+    g_return_if_fail (self != NULL);
+
+    if (n_bones == self->n_bones)
+        return;
+
+    stride = (n_bones + LANES - 1) / LANES * LANES;
+    data = g_new0 (gfloat, (gsize)stride * N_COMPONENTS);
+
+    for (c = 0; c < N_COMPONENTS && MIN (n_bones, self->n_bones) > 0; c++)
+    {
+        memcpy (data + (gsize)c * stride, COMPONENT (self, c),
+                sizeof (gfloat) * MIN (n_bones, self->n_bones));
+    }
+
+    g_free (self->data);
+    old_count = self->n_bones;
+    self->data = data;
+    self->stride = stride;
+    self->n_bones = n_bones;
+
+    if (n_bones > old_count)
+        pose_buffer_fill (self, old_count, TRUE);
+}
+
+void
+lrg_pose_buffer_set_from (LrgPoseBuffer       *self,
+                          const LrgPoseBuffer *src)
+{
+    g_return_if_fail (self != NULL);
+    g_return_if_fail (src != NULL);
+
+    if (self == src)
+        return;
+
+    if (self->stride != src->stride)
+    {
+        g_free (self->data);
+        self->stride = src->stride;
+        self->data = g_new (gfloat, (gsize)self->stride * N_COMPONENTS);
+    }
+
+    self->n_bones = src->n_bones;
+    if (src->stride > 0)
+        memcpy (self->data, src->data, sizeof (gfloat) * src->stride * N_COMPONENTS);
+}
+
+void
+lrg_pose_buffer_set_identity (LrgPoseBuffer *self)
+{
+    g_return_if_fail (self != NULL);
+
+    pose_buffer_fill (self, 0, TRUE);
+}
+
+void
+lrg_pose_buffer_clear (LrgPoseBuffer *self)
+{
+    g_return_if_fail (self != NULL);
+
+    if (self->stride > 0)
+        memset (self->data, 0, sizeof (gfloat) * self->stride * N_COMPONENTS);
+}
+
+void
+lrg_pose_buffer_get_pose (const LrgPoseBuffer *self,
+                          guint                bone_index,
+                          LrgBonePose         *out_pose)
+{
+    g_return_if_fail (self != NULL);
+    g_return_if_fail (out_pose != NULL);
+    g_return_if_fail (bone_index < self->n_bones);
+
+    out_pose->position_x = COMPONENT (self, COMPONENT_POSITION_X)[bone_index];
+    out_pose->position_y = COMPONENT (self, COMPONENT_POSITION_Y)[bone_index];
+    out_pose->position_z = COMPONENT (self, COMPONENT_POSITION_Z)[bone_index];
+    out_pose->rotation_x = COMPONENT (self, COMPONENT_ROTATION_X)[bone_index];
+    out_pose->rotation_y = COMPONENT (self, COMPONENT_ROTATION_Y)[bone_index];
+    out_pose->rotation_z = COMPONENT (self, COMPONENT_ROTATION_Z)[bone_index];
+    out_pose->rotation_w = COMPONENT (self, COMPONENT_ROTATION_W)[bone_index];
+    out_pose->scale_x = COMPONENT (self, COMPONENT_SCALE_X)[bone_index];
+    out_pose->scale_y = COMPONENT (self, COMPONENT_SCALE_Y)[bone_index];
+    out_pose->scale_z = COMPONENT (self, COMPONENT_SCALE_Z)[bone_index];
+}
+
+void
+lrg_pose_buffer_set_pose (LrgPoseBuffer     *self,
+                          guint              bone_index,
+                          const LrgBonePose *pose)
+{
+    g_return_if_fail (self != NULL);
+    g_return_if_fail (pose != NULL);
+    g_return_if_fail (bone_index < self->n_bones);
+
+    COMPONENT (self, COMPONENT_POSITION_X)[bone_index] = pose->position_x;
+    COMPONENT (self, COMPONENT_POSITION_Y)[bone_index] = pose->position_y;
+    COMPONENT (self, COMPONENT_POSITION_Z)[bone_index] = pose->position_z;
+    COMPONENT (self, COMPONENT_ROTATION_X)[bone_index] = pose->rotation_x;
+    COMPONENT (self, COMPONENT_ROTATION_Y)[bone_index] = pose->rotation_y;
+    COMPONENT (self, COMPONENT_ROTATION_Z)[bone_index] = pose->rotation_z;
+    COMPONENT (self, COMPONENT_ROTATION_W)[bone_index] = pose->rotation_w;
+    COMPONENT (self, COMPONENT_SCALE_X)[bone_index] = pose->scale_x;
+    COMPONENT (self, COMPONENT_SCALE_Y)[bone_index] = pose->scale_y;
+    COMPONENT (self, COMPONENT_SCALE_Z)[bone_index] = pose->scale_z;
+}
+
+/* Four bones' rotation dot products between two buffers */
+static inline Lane
+rotation_dot (const LrgPoseBuffer *a,
+              const LrgPoseBuffer *b,
+              guint                i)
+{
+    Lane dot;
+    guint c;
+
+    dot = lane_splat (0.0f);
+    for (c = COMPONENT_ROTATION_X; c <= COMPONENT_ROTATION_W; c++)
+        dot += lane_load (COMPONENT (a, c) + i) * lane_load (COMPONENT (b, c) + i);
+
+    return dot;
+}
+
+void
+lrg_pose_buffer_lerp (const LrgPoseBuffer *a,
+                      const LrgPoseBuffer *b,
+                      gfloat               t,
+                      LrgPoseBuffer       *out)
+{
+    Lane tv;
+    guint i;
+    guint c;
+
+    g_return_if_fail (a != NULL);
+    g_return_if_fail (b != NULL);
+    g_return_if_fail (out != NULL);
+    g_return_if_fail (a->n_bones == b->n_bones && a->n_bones == out->n_bones);
+
+    tv = lane_splat (t);
+
+    for (i = 0; i < a->stride; i += LANES)
+    {
+        Lane dot = rotation_dot (a, b, i);
+
+        for (c = 0; c < N_COMPONENTS; c++)
+        {
+            Lane va = lane_load (COMPONENT (a, c) + i);
+            Lane vb = lane_load (COMPONENT (b, c) + i);
+
+            if (c >= COMPONENT_ROTATION_X && c <= COMPONENT_ROTATION_W)
+                vb = lane_flip_where_negative (vb, dot);
+
+            lane_store (COMPONENT (out, c) + i, va + (vb - va) * tv);
+        }
+    }
+
+    lrg_pose_buffer_normalize_rotations (out);
+}
+
+void
+lrg_pose_buffer_accumulate (LrgPoseBuffer       *self,
+                            const LrgPoseBuffer *src,
+                            gfloat               weight)
+{
+    Lane wv;
+    guint i;
+    guint c;
+
+    g_return_if_fail (self != NULL);
+    g_return_if_fail (src != NULL);
+    g_return_if_fail (self->n_bones == src->n_bones);
+
+    wv = lane_splat (weight);
+
+    for (i = 0; i < self->stride; i += LANES)
+    {
+        Lane rotation_weight = lane_flip_where_negative (wv, rotation_dot (self, src, i));
+
+        for (c = 0; c < N_COMPONENTS; c++)
+        {
+            Lane w = (c >= COMPONENT_ROTATION_X && c <= COMPONENT_ROTATION_W)
+                ? rotation_weight : wv;
+
+            lane_store (COMPONENT (self, c) + i,
+                        lane_load (COMPONENT (self, c) + i) +
+                        lane_load (COMPONENT (src, c) + i) * w);
+        }
+    }
+}
+
+void
+lrg_pose_buffer_normalize_rotations (LrgPoseBuffer *self)
+{
+    Lane zero;
+    Lane one;
+    guint i;
+    guint c;
+
+    g_return_if_fail (self != NULL);
+
+    zero = lane_splat (0.0f);
+    one = lane_splat (1.0f);
+
+    for (i = 0; i < self->stride; i += LANES)
+    {
+        Lane len_sq = lane_splat (0.0f);
+        Lane inv;
+        LaneMask usable;
+
+        for (c = COMPONENT_ROTATION_X; c <= COMPONENT_ROTATION_W; c++)
+        {
+            Lane v = lane_load (COMPONENT (self, c) + i);
+            len_sq += v * v;
+        }
+
+        /* Near-zero (or NaN) rotations fall back to identity */
+        usable = len_sq > lane_splat (0.000001f);
+        inv = one / lane_sqrt (len_sq);
+
+        for (c = COMPONENT_ROTATION_X; c <= COMPONENT_ROTATION_W; c++)
+        {
+            gfloat *p = COMPONENT (self, c) + i;
+
+            lane_store (p, lane_select (usable, lane_load (p) * inv,
+                                        c == COMPONENT_ROTATION_W ? one : zero));
+        }
+    }
+}
+
+void
+lrg_pose_buffer_apply (const LrgPoseBuffer *self,
+                       LrgSkeleton         *skeleton)
+{
+    GList *l;
+
+    g_return_if_fail (self != NULL);
+    g_return_if_fail (LRG_IS_SKELETON (skeleton));
+
+    for (l = lrg_skeleton_get_bones (skeleton); l != NULL; l = l->next)
+    {
+        LrgBone *bone = l->data;
+        gint index = lrg_bone_get_index (bone);
+        LrgBonePose pose;
+
+        if (index < 0 || (guint)index >= self->n_bones)
+            continue;
+
+        lrg_pose_buffer_get_pose (self, index, &pose);
+        lrg_bone_set_local_pose (bone, &pose);
+    }
+}
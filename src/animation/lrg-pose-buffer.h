@@ -0,0 +1,210 @@
+/* lrg-pose-buffer.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Structure-of-arrays pose storage for whole skeletons.
+ */
+
+#pragma once
+
+#if !defined(LIBREGNUM_INSIDE) && !defined(LIBREGNUM_COMPILATION)
+#error "Only <libregnum.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include "../lrg-version.h"
+#include "lrg-bone-pose.h"
+#include "lrg-skeleton.h"
+
+G_BEGIN_DECLS
+
+typedef struct _LrgPoseBuffer LrgPoseBuffer;
+
+#define LRG_TYPE_POSE_BUFFER (lrg_pose_buffer_get_type ())
+
+/**
+ * LrgPoseBuffer:
+ *
+ * The local poses of every bone in a skeleton, stored as one array
+ * per component (position x, position y, ... scale z) rather than one
+ * #LrgBonePose per bone. Blending two buffers walks those arrays four
+ * bones at a time, so it costs the same per bone however the poses
+ * were produced.
+ *
+ * Since: 1.0
+ */
+
+LRG_AVAILABLE_IN_ALL
+GType           lrg_pose_buffer_get_type            (void) G_GNUC_CONST;
+
+/**
+ * lrg_pose_buffer_new:
+ * @n_bones: Number of bones
+ *
+ * Creates a pose buffer with every bone at the identity pose.
+ *
+ * Returns: (transfer full): A new #LrgPoseBuffer
+ */
+LRG_AVAILABLE_IN_ALL
+LrgPoseBuffer * lrg_pose_buffer_new                 (guint               n_bones);
+
+/**
+ * lrg_pose_buffer_copy:
+ * @self: A #LrgPoseBuffer
+ *
+ * Copies a pose buffer.
+ *
+ * Returns: (transfer full): A copy of @self
+ */
+LRG_AVAILABLE_IN_ALL
+LrgPoseBuffer * lrg_pose_buffer_copy                (const LrgPoseBuffer *self);
+
+/**
+ * lrg_pose_buffer_free:
+ * @self: A #LrgPoseBuffer
+ *
+ * Frees a pose buffer.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_free                (LrgPoseBuffer      *self);
+
+/**
+ * lrg_pose_buffer_get_bone_count:
+ * @self: A #LrgPoseBuffer
+ *
+ * Gets the number of bones.
+ *
+ * Returns: The bone count
+ */
+LRG_AVAILABLE_IN_ALL
+guint           lrg_pose_buffer_get_bone_count      (const LrgPoseBuffer *self);
+
+/**
+ * lrg_pose_buffer_set_bone_count:
+ * @self: A #LrgPoseBuffer
+ * @n_bones: Number of bones
+ *
+ * Resizes the buffer. Existing bones keep their poses and new bones
+ * start at the identity pose.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_set_bone_count      (LrgPoseBuffer      *self,
+                                                     guint               n_bones);
+
+/**
+ * lrg_pose_buffer_set_from:
+ * @self: A #LrgPoseBuffer
+ * @src: The buffer to copy
+ *
+ * Copies the bone count and poses of @src into @self.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_set_from            (LrgPoseBuffer      *self,
+                                                     const LrgPoseBuffer *src);
+
+/**
+ * lrg_pose_buffer_set_identity:
+ * @self: A #LrgPoseBuffer
+ *
+ * Resets every bone to the identity pose.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_set_identity        (LrgPoseBuffer      *self);
+
+/**
+ * lrg_pose_buffer_clear:
+ * @self: A #LrgPoseBuffer
+ *
+ * Sets every component of every bone to zero, ready for
+ * lrg_pose_buffer_accumulate().
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_clear               (LrgPoseBuffer      *self);
+
+/**
+ * lrg_pose_buffer_get_pose:
+ * @self: A #LrgPoseBuffer
+ * @bone_index: The bone
+ * @out_pose: (out caller-allocates): Return location for the pose
+ *
+ * Gets the pose of one bone.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_get_pose            (const LrgPoseBuffer *self,
+                                                     guint               bone_index,
+                                                     LrgBonePose        *out_pose);
+
+/**
+ * lrg_pose_buffer_set_pose:
+ * @self: A #LrgPoseBuffer
+ * @bone_index: The bone
+ * @pose: The pose
+ *
+ * Sets the pose of one bone.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_set_pose            (LrgPoseBuffer      *self,
+                                                     guint               bone_index,
+                                                     const LrgBonePose  *pose);
+
+/**
+ * lrg_pose_buffer_lerp:
+ * @a: Pose at @t = 0
+ * @b: Pose at @t = 1
+ * @t: Blend factor
+ * @out: Return location, which may be @a or @b
+ *
+ * Blends two buffers with the same bone count. Positions and scales
+ * are interpolated linearly and rotations with a normalized lerp along
+ * the shorter arc.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_lerp                (const LrgPoseBuffer *a,
+                                                     const LrgPoseBuffer *b,
+                                                     gfloat              t,
+                                                     LrgPoseBuffer      *out);
+
+/**
+ * lrg_pose_buffer_accumulate:
+ * @self: A #LrgPoseBuffer
+ * @src: Pose to add, with the same bone count
+ * @weight: Weight of @src
+ *
+ * Adds @src scaled by @weight to @self. A source rotation pointing
+ * away from the accumulated one is negated first, so blended rotations
+ * take the shorter arc. Call lrg_pose_buffer_clear() before the first
+ * source and lrg_pose_buffer_normalize_rotations() after the last.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_accumulate          (LrgPoseBuffer      *self,
+                                                     const LrgPoseBuffer *src,
+                                                     gfloat              weight);
+
+/**
+ * lrg_pose_buffer_normalize_rotations:
+ * @self: A #LrgPoseBuffer
+ *
+ * Normalizes every rotation quaternion. Zero rotations become the
+ * identity.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_normalize_rotations (LrgPoseBuffer      *self);
+
+/**
+ * lrg_pose_buffer_apply:
+ * @self: A #LrgPoseBuffer
+ * @skeleton: The skeleton to pose
+ *
+ * Sets the local pose of each bone of @skeleton from the buffer entry
+ * with the same index. Call lrg_skeleton_calculate_world_poses()
+ * afterwards.
+ */
+LRG_AVAILABLE_IN_ALL
+void            lrg_pose_buffer_apply               (const LrgPoseBuffer *self,
+                                                     LrgSkeleton        *skeleton);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (LrgPoseBuffer, lrg_pose_buffer_free)
+
+G_END_DECLS
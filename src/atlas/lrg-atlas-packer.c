@@ -7,10 +7,15 @@
  * Build-time texture atlas packer.
  */
 
+#include <math.h>
 #include <gio/gio.h>
 
 #include "lrg-atlas-packer.h"
 
+/* Below this many images the heuristic trials are cheap enough that
+ * handing them to worker threads costs more than it saves. */
+#define PARALLEL_MIN_IMAGES 16
+
 /**
  * LrgAtlasPackerImage:
  *
@@ -24,6 +29,7 @@ struct _LrgAtlasPackerImage
     gpointer  user_data;
 
     /* Packed result (set after pack()) */
+    gint      page;
     gint      packed_x;
     gint      packed_y;
     gboolean  rotated;
@@ -43,6 +49,7 @@ packer_image_new (const gchar *name,
     image->width = width;
     image->height = height;
     image->user_data = user_data;
+    image->page = 0;
     image->packed_x = 0;
     image->packed_y = 0;
     image->rotated = FALSE;
@@ -73,6 +80,17 @@ typedef struct
     gint x_used;  /* How much X space is used */
 } ShelfRow;
 
+/**
+ * PackPage:
+ *
+ * Final size of one packed atlas page.
+ */
+typedef struct
+{
+    gint width;
+    gint height;
+} PackPage;
+
 struct _LrgAtlasPacker
 {
     GObject parent_instance;
@@ -84,6 +102,8 @@ struct _LrgAtlasPacker
     LrgAtlasPackMethod  method;
     gboolean            power_of_two;
     gboolean            allow_rotation;
+    guint               max_pages;      /* 0 = no limit */
+    guint               max_threads;    /* 0 = one per processor */
 
     /* Images to pack */
     GPtrArray  *images;         /* LrgAtlasPackerImage* */
@@ -92,7 +112,14 @@ struct _LrgAtlasPacker
     /* Packed result */
     gint packed_width;
     gint packed_height;
+    GArray *pages;              /* PackPage */
     gboolean is_packed;
+
+    /* Heuristic trials */
+    GThreadPool *pool;
+    GMutex       lock;
+    GCond        cond;
+    guint        pending;
 };
 
 G_DEFINE_FINAL_TYPE (LrgAtlasPacker, lrg_atlas_packer, G_TYPE_OBJECT)
@@ -106,6 +133,7 @@ enum
     PROP_METHOD,
     PROP_POWER_OF_TWO,
     PROP_ALLOW_ROTATION,
+    PROP_MAX_PAGES,
     N_PROPS
 };
 
@@ -116,8 +144,17 @@ lrg_atlas_packer_finalize (GObject *object)
 {
     LrgAtlasPacker *self = LRG_ATLAS_PACKER (object);
 
+    if (self->pool != NULL)
+    {
+        g_thread_pool_free (self->pool, FALSE, TRUE);
+        self->pool = NULL;
+    }
+
     g_clear_pointer (&self->images, g_ptr_array_unref);
     g_clear_pointer (&self->images_by_name, g_hash_table_unref);
+    g_clear_pointer (&self->pages, g_array_unref);
+    g_mutex_clear (&self->lock);
+    g_cond_clear (&self->cond);
 
     G_OBJECT_CLASS (lrg_atlas_packer_parent_class)->finalize (object);
 }
@@ -150,6 +187,9 @@ lrg_atlas_packer_get_property (GObject    *object,
     case PROP_ALLOW_ROTATION:
         g_value_set_boolean (value, self->allow_rotation);
         break;
+    case PROP_MAX_PAGES:
+        g_value_set_uint (value, self->max_pages);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -183,6 +223,9 @@ lrg_atlas_packer_set_property (GObject      *object,
     case PROP_ALLOW_ROTATION:
         self->allow_rotation = g_value_get_boolean (value);
         break;
+    case PROP_MAX_PAGES:
+        self->max_pages = g_value_get_uint (value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -271,6 +314,20 @@ lrg_atlas_packer_class_init (LrgAtlasPackerClass *klass)
                               FALSE,
                               G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
 
+    /**
+     * LrgAtlasPacker:max-pages:
+     *
+     * Maximum number of atlas pages, or 0 for no limit. Images that do
+     * not fit on one page spill onto the next. Defaults to 1, so packing
+     * fails rather than spilling unless more pages are allowed.
+     *
+     * Since: 1.0
+     */
+    properties[PROP_MAX_PAGES] =
+        g_param_spec_uint ("max-pages", NULL, NULL,
+                           0, G_MAXUINT, 1,
+                           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
     g_object_class_install_properties (object_class, N_PROPS, properties);
 }
 
@@ -283,9 +340,17 @@ lrg_atlas_packer_init (LrgAtlasPacker *self)
     self->method = LRG_ATLAS_PACK_METHOD_SHELF;
     self->power_of_two = TRUE;
     self->allow_rotation = FALSE;
+    self->max_pages = 1;
+    self->max_threads = 0;
 
     self->images = g_ptr_array_new_with_free_func ((GDestroyNotify) packer_image_free);
     self->images_by_name = g_hash_table_new (g_str_hash, g_str_equal);
+    self->pages = g_array_new (FALSE, FALSE, sizeof (PackPage));
+
+    self->pool = NULL;
+    g_mutex_init (&self->lock);
+    g_cond_init (&self->cond);
+    self->pending = 0;
 }
 
 /**
@@ -503,6 +568,81 @@ lrg_atlas_packer_get_allow_rotation (LrgAtlasPacker *self)
     return self->allow_rotation;
 }
 
+/**
+ * lrg_atlas_packer_set_max_pages:
+ * @self: A #LrgAtlasPacker
+ * @max_pages: Maximum number of pages, or 0 for no limit
+ *
+ * Sets how many atlas pages images may spill onto when they do not
+ * fit within the maximum size. With a limit of 1, packing fails
+ * instead of spilling.
+ *
+ * Since: 1.0
+ */
+void
+lrg_atlas_packer_set_max_pages (LrgAtlasPacker *self,
+                                guint           max_pages)
+{
+    g_return_if_fail (LRG_IS_ATLAS_PACKER (self));
+
+    self->max_pages = max_pages;
+    self->is_packed = FALSE;
+}
+
+/**
+ * lrg_atlas_packer_get_max_pages:
+ * @self: A #LrgAtlasPacker
+ *
+ * Gets the page limit.
+ *
+ * Returns: Maximum number of pages, or 0 for no limit
+ *
+ * Since: 1.0
+ */
+guint
+lrg_atlas_packer_get_max_pages (LrgAtlasPacker *self)
+{
+    g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), 0);
+    return self->max_pages;
+}
+
+/**
+ * lrg_atlas_packer_set_max_threads:
+ * @self: A #LrgAtlasPacker
+ * @max_threads: Worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Sets how many threads try packing heuristics. The result does not
+ * depend on the thread count.
+ *
+ * Since: 1.0
+ */
+void
+lrg_atlas_packer_set_max_threads (LrgAtlasPacker *self,
+                                  guint           max_threads)
+{
+    g_return_if_fail (LRG_IS_ATLAS_PACKER (self));
+
+    self->max_threads = max_threads;
+}
+
+/**
+ * lrg_atlas_packer_get_max_threads:
+ * @self: A #LrgAtlasPacker
+ *
+ * Gets the thread limit.
+ *
+ * Returns: Thread limit, 0 meaning one per processor
+ *
+ * Since: 1.0
+ */
+guint
+lrg_atlas_packer_get_max_threads (LrgAtlasPacker *self)
+{
+    g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), 0);
+    return self->max_threads;
+}
+
 /**
  * lrg_atlas_packer_add_image:
  * @self: A #LrgAtlasPacker
@@ -599,6 +739,7 @@ lrg_atlas_packer_clear_images (LrgAtlasPacker *self)
     self->is_packed = FALSE;
     self->packed_width = 0;
     self->packed_height = 0;
+    g_array_set_size (self->pages, 0);
 }
 
 /**
@@ -632,135 +773,806 @@ next_power_of_two (gint n)
     return power;
 }
 
+/* ==========================================================================
+ * Packing
+ *
+ * Every method packs pages the same way: images are taken in a sorted
+ * order and placed on the current page if they fit anywhere, otherwise
+ * deferred to the next page. Padding is added to the right and bottom
+ * of each image, so the page size includes it.
+ *
+ * MaxRects and Guillotine have several knobs (placement heuristic,
+ * sort order, page width) and no setting wins on every input, so a
+ * "trial" is run for each combination and the one needing the fewest
+ * pages and the least area is kept. Trials only read the packer and
+ * write their own result, so they run in parallel.
+ * ========================================================================== */
+
+/*
+ * PackHeuristic:
+ *
+ * How MaxRects and Guillotine choose among the free rectangles an
+ * image fits in. Lower scores win; the second score breaks ties.
+ */
+typedef enum
+{
+    PACK_HEURISTIC_BEST_SHORT_SIDE,  /* smallest leftover on the short side */
+    PACK_HEURISTIC_BEST_AREA,        /* smallest leftover area */
+    PACK_HEURISTIC_BOTTOM_LEFT,      /* lowest bottom edge, then leftmost */
+    PACK_N_HEURISTICS
+} PackHeuristic;
+
+typedef enum
+{
+    PACK_SORT_HEIGHT,    /* tallest first */
+    PACK_SORT_MAX_SIDE,  /* longest side first */
+    PACK_SORT_AREA,      /* largest first */
+    PACK_N_SORTS
+} PackSort;
+
+typedef struct
+{
+    gint x;
+    gint y;
+    gint width;
+    gint height;
+} PackRect;
+
+typedef struct
+{
+    gint     page;
+    gint     x;
+    gint     y;
+    gboolean rotated;
+} PackPlacement;
+
+/*
+ * PackBin:
+ *
+ * The page being filled by a trial.
+ */
+typedef struct
+{
+    gint    width;        /* size limit */
+    gint    height;
+    gint    used_width;   /* bounding box of placed images */
+    gint    used_height;
+    GArray *free_rects;   /* PackRect, MaxRects and Guillotine */
+    GArray *pieces;       /* PackRect, MaxRects split scratch */
+    GArray *shelves;      /* ShelfRow, Shelf */
+} PackBin;
+
+typedef struct
+{
+    LrgAtlasPacker     *packer;
+    LrgAtlasPackMethod  method;
+    PackHeuristic       heuristic;
+    PackSort            sort;
+    gint                bin_width;
+    gboolean            allow_rotation;
+
+    /* Result */
+    PackPlacement      *placements;  /* indexed like packer->images */
+    GArray             *pages;       /* PackPage */
+    gint64              area;        /* summed page area */
+    gboolean            ok;
+} PackTrial;
+
+static void
+trial_image_size (PackTrial *trial,
+                  guint      index,
+                  gboolean   rotated,
+                  gint      *out_width,
+                  gint      *out_height)
+{
+    LrgAtlasPackerImage *image = g_ptr_array_index (trial->packer->images, index);
+    gint padding = trial->packer->padding;
+
+    if (rotated)
+    {
+        *out_width = image->height + padding;
+        *out_height = image->width + padding;
+    }
+    else
+    {
+        *out_width = image->width + padding;
+        *out_height = image->height + padding;
+    }
+}
+
+static gboolean
+rects_intersect (const PackRect *a,
+                 const PackRect *b)
+{
+    return a->x < b->x + b->width && b->x < a->x + a->width &&
+           a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+static gboolean
+rect_contains (const PackRect *outer,
+               const PackRect *inner)
+{
+    return inner->x >= outer->x && inner->y >= outer->y &&
+           inner->x + inner->width <= outer->x + outer->width &&
+           inner->y + inner->height <= outer->y + outer->height;
+}
+
+static void
+score_fit (PackHeuristic   heuristic,
+           const PackRect *free_rect,
+           gint            width,
+           gint            height,
+           gint64         *primary,
+           gint64         *secondary)
+{
+    gint64 leftover_w = free_rect->width - width;
+    gint64 leftover_h = free_rect->height - height;
+
+    switch (heuristic)
+    {
+    case PACK_HEURISTIC_BEST_AREA:
+        *primary = (gint64)free_rect->width * free_rect->height - (gint64)width * height;
+        *secondary = MIN (leftover_w, leftover_h);
+        break;
+
+    case PACK_HEURISTIC_BOTTOM_LEFT:
+        /* Y grows downwards, so "bottom" is the edge nearest y = 0 */
+        *primary = (gint64)free_rect->y + height;
+        *secondary = free_rect->x;
+        break;
+
+    case PACK_HEURISTIC_BEST_SHORT_SIDE:
+    default:
+        *primary = MIN (leftover_w, leftover_h);
+        *secondary = MAX (leftover_w, leftover_h);
+        break;
+    }
+}
+
 /*
- * compare_images_by_height_desc:
+ * find_free_rect:
  *
- * Comparison function for sorting images by height (descending).
+ * Finds the best free rectangle for an image of @width x @height,
+ * trying it sideways too when rotation is allowed. Returns the index
+ * of the free rectangle, or -1 if the image fits nowhere.
  */
 static gint
-compare_images_by_height_desc (gconstpointer a,
-                               gconstpointer b)
+find_free_rect (PackTrial *trial,
+                PackBin   *bin,
+                guint      index,
+                gboolean  *out_rotated)
+{
+    gint64 best_primary = G_MAXINT64;
+    gint64 best_secondary = G_MAXINT64;
+    gint best = -1;
+    gint orientations;
+    gint o;
+    guint i;
+
+    orientations = trial->allow_rotation ? 2 : 1;
+
+    for (o = 0; o < orientations; o++)
+    {
+        gint w, h;
+
+        trial_image_size (trial, index, o == 1, &w, &h);
+
+        for (i = 0; i < bin->free_rects->len; i++)
+        {
+            const PackRect *free_rect = &g_array_index (bin->free_rects, PackRect, i);
+            gint64 primary, secondary;
+
+            if (w > free_rect->width || h > free_rect->height)
+                continue;
+
+            score_fit (trial->heuristic, free_rect, w, h, &primary, &secondary);
+            if (primary < best_primary ||
+                (primary == best_primary && secondary < best_secondary))
+            {
+                best_primary = primary;
+                best_secondary = secondary;
+                best = (gint)i;
+                *out_rotated = (o == 1);
+            }
+        }
+    }
+
+    return best;
+}
+
+/*
+ * maxrects_split:
+ *
+ * Carves @used out of the free rectangles. Each free rectangle that
+ * overlaps it is replaced by up to four maximal pieces; pieces inside
+ * another free rectangle are dropped so the list stays small.
+ */
+static void
+maxrects_split (PackBin        *bin,
+                const PackRect *used)
+{
+    guint kept = 0;
+    guint i, j;
+
+    g_array_set_size (bin->pieces, 0);
+
+    for (i = 0; i < bin->free_rects->len; i++)
+    {
+        PackRect f = g_array_index (bin->free_rects, PackRect, i);
+        PackRect piece;
+
+        if (!rects_intersect (&f, used))
+        {
+            g_array_index (bin->free_rects, PackRect, kept++) = f;
+            continue;
+        }
+
+        if (used->x > f.x)
+        {
+            piece = (PackRect){ f.x, f.y, used->x - f.x, f.height };
+            g_array_append_val (bin->pieces, piece);
+        }
+        if (used->x + used->width < f.x + f.width)
+        {
+            piece = (PackRect){ used->x + used->width, f.y,
+                                f.x + f.width - (used->x + used->width), f.height };
+            g_array_append_val (bin->pieces, piece);
+        }
+        if (used->y > f.y)
+        {
+            piece = (PackRect){ f.x, f.y, f.width, used->y - f.y };
+            g_array_append_val (bin->pieces, piece);
+        }
+        if (used->y + used->height < f.y + f.height)
+        {
+            piece = (PackRect){ f.x, used->y + used->height, f.width,
+                                f.y + f.height - (used->y + used->height) };
+            g_array_append_val (bin->pieces, piece);
+        }
+    }
+    g_array_set_size (bin->free_rects, kept);
+
+    /*
+     * Untouched rectangles never contain each other, so only the new
+     * pieces need checking: against the untouched ones, and against
+     * each other (keeping the first of identical pieces).
+     */
+    for (i = 0; i < bin->pieces->len; i++)
+    {
+        const PackRect *piece = &g_array_index (bin->pieces, PackRect, i);
+        gboolean redundant = FALSE;
+
+        for (j = 0; j < kept && !redundant; j++)
+            redundant = rect_contains (&g_array_index (bin->free_rects, PackRect, j), piece);
+
+        for (j = 0; j < bin->pieces->len && !redundant; j++)
+        {
+            const PackRect *other = &g_array_index (bin->pieces, PackRect, j);
+
+            if (j != i && rect_contains (other, piece) &&
+                (j < i || !rect_contains (piece, other)))
+                redundant = TRUE;
+        }
+
+        if (!redundant)
+            g_array_append_val (bin->free_rects, *piece);
+    }
+
+    /* A new piece may in turn swallow an untouched rectangle */
+    for (i = 0; i < kept; )
+    {
+        const PackRect *f = &g_array_index (bin->free_rects, PackRect, i);
+        gboolean redundant = FALSE;
+
+        for (j = kept; j < bin->free_rects->len && !redundant; j++)
+            redundant = rect_contains (&g_array_index (bin->free_rects, PackRect, j), f);
+
+        if (redundant)
+        {
+            g_array_remove_index (bin->free_rects, i);
+            kept--;
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+/*
+ * guillotine_split:
+ *
+ * Places @used in the top-left corner of free rectangle @index and cuts
+ * the rest of it in two along the shorter leftover axis, which keeps
+ * the larger piece as square as possible.
+ */
+static void
+guillotine_split (PackBin        *bin,
+                  guint           index,
+                  const PackRect *used)
 {
-    const LrgAtlasPackerImage *img_a = *(const LrgAtlasPackerImage **)a;
-    const LrgAtlasPackerImage *img_b = *(const LrgAtlasPackerImage **)b;
+    PackRect f = g_array_index (bin->free_rects, PackRect, index);
+    PackRect right, bottom;
+    gint leftover_w = f.width - used->width;
+    gint leftover_h = f.height - used->height;
 
-    return img_b->height - img_a->height;
+    g_array_remove_index_fast (bin->free_rects, index);
+
+    if (leftover_w <= leftover_h)
+    {
+        right = (PackRect){ f.x + used->width, f.y, leftover_w, used->height };
+        bottom = (PackRect){ f.x, f.y + used->height, f.width, leftover_h };
+    }
+    else
+    {
+        right = (PackRect){ f.x + used->width, f.y, leftover_w, f.height };
+        bottom = (PackRect){ f.x, f.y + used->height, used->width, leftover_h };
+    }
+
+    if (right.width > 0 && right.height > 0)
+        g_array_append_val (bin->free_rects, right);
+    if (bottom.width > 0 && bottom.height > 0)
+        g_array_append_val (bin->free_rects, bottom);
 }
 
 /*
- * pack_shelf:
+ * shelf_place:
  *
- * Shelf packing algorithm. Simple but decent results.
- * Sorts images by height and packs into horizontal rows.
+ * Shelf packing. Puts the image on the first shelf with room for it,
+ * or opens a new shelf below the last one.
  */
 static gboolean
-pack_shelf (LrgAtlasPacker  *self,
-            GError         **error)
+shelf_place (PackBin  *bin,
+             gint      width,
+             gint      height,
+             PackRect *out_rect)
 {
-    GArray *shelves;
-    GPtrArray *sorted;
-    gint total_width = 0;
-    gint total_height = 0;
+    ShelfRow new_shelf;
+    gint new_y = 0;
     guint i;
 
-    /* Create sorted copy of images */
-    sorted = g_ptr_array_new ();
-    for (i = 0; i < self->images->len; i++)
+    for (i = 0; i < bin->shelves->len; i++)
+    {
+        ShelfRow *shelf = &g_array_index (bin->shelves, ShelfRow, i);
+
+        if (shelf->x_used + width <= bin->width && height <= shelf->height)
+        {
+            *out_rect = (PackRect){ shelf->x_used, shelf->y, width, height };
+            shelf->x_used += width;
+            return TRUE;
+        }
+    }
+
+    if (bin->shelves->len > 0)
     {
-        g_ptr_array_add (sorted, g_ptr_array_index (self->images, i));
+        ShelfRow *last = &g_array_index (bin->shelves, ShelfRow, bin->shelves->len - 1);
+        new_y = last->y + last->height;
     }
-    g_ptr_array_sort (sorted, compare_images_by_height_desc);
 
-    /* Initialize shelf array */
-    shelves = g_array_new (FALSE, FALSE, sizeof (ShelfRow));
+    if (width > bin->width || new_y + height > bin->height)
+        return FALSE;
 
-    /* Pack each image */
-    for (i = 0; i < sorted->len; i++)
+    new_shelf.y = new_y;
+    new_shelf.height = height;
+    new_shelf.x_used = width;
+    g_array_append_val (bin->shelves, new_shelf);
+
+    *out_rect = (PackRect){ 0, new_y, width, height };
+    return TRUE;
+}
+
+static gboolean
+bin_place (PackTrial *trial,
+           PackBin   *bin,
+           guint      index)
+{
+    PackPlacement *placement = &trial->placements[index];
+    PackRect used;
+
+    if (trial->method == LRG_ATLAS_PACK_METHOD_SHELF)
     {
-        LrgAtlasPackerImage *image = g_ptr_array_index (sorted, i);
-        gint img_w, img_h;
-        gboolean placed = FALSE;
-        guint j;
+        gint w, h;
 
-        img_w = image->width + self->padding;
-        img_h = image->height + self->padding;
+        /* Shelf orientation is fixed before sorting */
+        trial_image_size (trial, index, placement->rotated, &w, &h);
+        if (!shelf_place (bin, w, h, &used))
+            return FALSE;
+    }
+    else
+    {
+        gboolean rotated = FALSE;
+        gint free_index;
+
+        free_index = find_free_rect (trial, bin, index, &rotated);
+        if (free_index < 0)
+            return FALSE;
+
+        used.x = g_array_index (bin->free_rects, PackRect, free_index).x;
+        used.y = g_array_index (bin->free_rects, PackRect, free_index).y;
+        trial_image_size (trial, index, rotated, &used.width, &used.height);
+        placement->rotated = rotated;
+
+        if (trial->method == LRG_ATLAS_PACK_METHOD_GUILLOTINE)
+            guillotine_split (bin, (guint)free_index, &used);
+        else
+            maxrects_split (bin, &used);
+    }
 
-        /* Try to fit in existing shelf */
-        for (j = 0; j < shelves->len; j++)
+    placement->x = used.x;
+    placement->y = used.y;
+    bin->used_width = MAX (bin->used_width, used.x + used.width);
+    bin->used_height = MAX (bin->used_height, used.y + used.height);
+
+    return TRUE;
+}
+
+static void
+bin_reset (PackBin *bin,
+           gint     width,
+           gint     height)
+{
+    PackRect all = { 0, 0, width, height };
+
+    bin->width = width;
+    bin->height = height;
+    bin->used_width = 0;
+    bin->used_height = 0;
+
+    g_array_set_size (bin->free_rects, 0);
+    g_array_append_val (bin->free_rects, all);
+    g_array_set_size (bin->shelves, 0);
+}
+
+/*
+ * compare_trial_order:
+ *
+ * Sort order for a trial's images, largest first. Ties keep the order
+ * the images were added in, so results are reproducible.
+ */
+static gint
+compare_trial_order (gconstpointer a,
+                     gconstpointer b,
+                     gpointer      user_data)
+{
+    PackTrial *trial = user_data;
+    guint ia = *(const guint *)a;
+    guint ib = *(const guint *)b;
+    gint64 key_a = 0, key_b = 0;
+    gint64 tie_a = 0, tie_b = 0;
+    gint aw, ah, bw, bh;
+
+    trial_image_size (trial, ia, trial->placements[ia].rotated, &aw, &ah);
+    trial_image_size (trial, ib, trial->placements[ib].rotated, &bw, &bh);
+
+    switch (trial->sort)
+    {
+    case PACK_SORT_MAX_SIDE:
+        key_a = MAX (aw, ah);
+        key_b = MAX (bw, bh);
+        tie_a = MIN (aw, ah);
+        tie_b = MIN (bw, bh);
+        break;
+
+    case PACK_SORT_AREA:
+        key_a = (gint64)aw * ah;
+        key_b = (gint64)bw * bh;
+        tie_a = MAX (aw, ah);
+        tie_b = MAX (bw, bh);
+        break;
+
+    case PACK_SORT_HEIGHT:
+    default:
+        key_a = ah;
+        key_b = bh;
+        break;
+    }
+
+    if (key_a != key_b)
+        return key_a > key_b ? -1 : 1;
+    if (tie_a != tie_b)
+        return tie_a > tie_b ? -1 : 1;
+
+    return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+/*
+ * run_trial:
+ *
+ * Packs every image with the trial's settings, filling pages one after
+ * another. Fails if an image cannot fit an empty page of the trial's
+ * width or the page limit is reached.
+ */
+static void
+run_trial (PackTrial *trial)
+{
+    LrgAtlasPacker *self = trial->packer;
+    GArray *order;
+    GArray *deferred;
+    GArray *swap;
+    PackBin bin;
+    guint n = self->images->len;
+    guint i;
+
+    trial->placements = g_new0 (PackPlacement, n);
+    trial->pages = g_array_new (FALSE, FALSE, sizeof (PackPage));
+    trial->area = 0;
+    trial->ok = TRUE;
+
+    order = g_array_sized_new (FALSE, FALSE, sizeof (guint), n);
+    deferred = g_array_sized_new (FALSE, FALSE, sizeof (guint), n);
+
+    for (i = 0; i < n; i++)
+    {
+        gint w, h, rw, rh;
+        gboolean fits, fits_rotated;
+
+        trial_image_size (trial, i, FALSE, &w, &h);
+        trial_image_size (trial, i, TRUE, &rw, &rh);
+        fits = w <= trial->bin_width && h <= self->max_height;
+        fits_rotated = trial->allow_rotation &&
+                       rw <= trial->bin_width && rh <= self->max_height;
+
+        if (!fits && !fits_rotated)
         {
-            ShelfRow *shelf = &g_array_index (shelves, ShelfRow, j);
+            trial->ok = FALSE;
+            break;
+        }
 
-            if (shelf->x_used + img_w <= self->max_width &&
-                img_h <= shelf->height)
-            {
-                image->packed_x = shelf->x_used;
-                image->packed_y = shelf->y;
-                image->rotated = FALSE;
-                image->packed = TRUE;
+        /* Shelves stay low when images lie on their long side */
+        if (trial->method == LRG_ATLAS_PACK_METHOD_SHELF)
+            trial->placements[i].rotated = !fits || (fits_rotated && h > w);
 
-                shelf->x_used += img_w;
-                if (shelf->x_used > total_width)
-                    total_width = shelf->x_used;
+        g_array_append_val (order, i);
+    }
 
-                placed = TRUE;
-                break;
-            }
+    if (trial->ok)
+        g_array_sort_with_data (order, compare_trial_order, trial);
+
+    bin.free_rects = g_array_new (FALSE, FALSE, sizeof (PackRect));
+    bin.pieces = g_array_new (FALSE, FALSE, sizeof (PackRect));
+    bin.shelves = g_array_new (FALSE, FALSE, sizeof (ShelfRow));
+
+    while (trial->ok && order->len > 0)
+    {
+        PackPage page;
+
+        if (self->max_pages > 0 && trial->pages->len >= self->max_pages)
+        {
+            trial->ok = FALSE;
+            break;
+        }
+
+        bin_reset (&bin, trial->bin_width, self->max_height);
+        g_array_set_size (deferred, 0);
+
+        for (i = 0; i < order->len; i++)
+        {
+            guint index = g_array_index (order, guint, i);
+
+            if (bin_place (trial, &bin, index))
+                trial->placements[index].page = (gint)trial->pages->len;
+            else
+                g_array_append_val (deferred, index);
         }
 
-        if (!placed)
+        page.width = bin.used_width;
+        page.height = bin.used_height;
+        if (self->power_of_two)
         {
-            /* Create new shelf */
-            ShelfRow new_shelf;
-            gint new_y = 0;
+            page.width = next_power_of_two (page.width);
+            page.height = next_power_of_two (page.height);
+        }
+
+        g_array_append_val (trial->pages, page);
+        trial->area += (gint64)page.width * page.height;
+
+        swap = order;
+        order = deferred;
+        deferred = swap;
+    }
+
+    g_array_unref (bin.free_rects);
+    g_array_unref (bin.pieces);
+    g_array_unref (bin.shelves);
+    g_array_unref (order);
+    g_array_unref (deferred);
+}
 
-            if (shelves->len > 0)
+static void
+pack_trial_clear (PackTrial *trial)
+{
+    g_clear_pointer (&trial->placements, g_free);
+    g_clear_pointer (&trial->pages, g_array_unref);
+}
+
+/*
+ * trial_is_better:
+ *
+ * Fewer pages win, then less total area. Ties keep the earlier trial.
+ */
+static gboolean
+trial_is_better (const PackTrial *a,
+                 const PackTrial *b)
+{
+    if (a->ok != b->ok)
+        return a->ok;
+    if (a->pages->len != b->pages->len)
+        return a->pages->len < b->pages->len;
+
+    return a->area < b->area;
+}
+
+/*
+ * collect_bin_widths:
+ *
+ * Page widths worth trying. A page as wide as allowed is often mostly
+ * empty on the right once the bounding box is taken, so narrower
+ * widths around the square root of the total area are tried too.
+ */
+static void
+collect_bin_widths (LrgAtlasPacker *self,
+                    GArray         *widths)
+{
+    static const gdouble factors[] = { 1.0, 1.25, 1.5, 2.0 };
+    gdouble area = 0.0;
+    gint min_width = 1;
+    gint side;
+    gint width;
+    gint last = 0;
+    guint i;
+
+    for (i = 0; i < self->images->len; i++)
+    {
+        LrgAtlasPackerImage *image = g_ptr_array_index (self->images, i);
+        gint w = image->width + self->padding;
+        gint h = image->height + self->padding;
+
+        min_width = MAX (min_width, self->allow_rotation ? MIN (w, h) : w);
+        area += (gdouble)w * h;
+    }
+
+    side = (gint)ceil (sqrt (area));
+
+    if (self->power_of_two)
+    {
+        for (width = next_power_of_two (MAX (min_width, side / 2));
+             width < self->max_width && width <= G_MAXINT / 2;
+             width <<= 1)
+        {
+            g_array_append_val (widths, width);
+        }
+    }
+    else
+    {
+        for (i = 0; i < G_N_ELEMENTS (factors); i++)
+        {
+            width = CLAMP ((gint)(side * factors[i]), min_width, self->max_width);
+            if (width > last && width < self->max_width)
             {
-                ShelfRow *last = &g_array_index (shelves, ShelfRow, shelves->len - 1);
-                new_y = last->y + last->height;
+                g_array_append_val (widths, width);
+                last = width;
             }
+        }
+    }
+
+    g_array_append_val (widths, self->max_width);
+}
+
+static GArray *
+create_trials (LrgAtlasPacker *self)
+{
+    GArray *trials;
+    GArray *widths;
+    PackTrial trial = { 0 };
+    guint h, s, w, r;
+
+    trials = g_array_new (FALSE, TRUE, sizeof (PackTrial));
+    trial.packer = self;
+    trial.method = self->method;
+    trial.allow_rotation = self->allow_rotation;
+
+    if (self->method != LRG_ATLAS_PACK_METHOD_MAXRECTS &&
+        self->method != LRG_ATLAS_PACK_METHOD_GUILLOTINE)
+    {
+        trial.method = LRG_ATLAS_PACK_METHOD_SHELF;
+        trial.sort = PACK_SORT_HEIGHT;
+        trial.bin_width = self->max_width;
+        g_array_append_val (trials, trial);
+        return trials;
+    }
+
+    widths = g_array_new (FALSE, FALSE, sizeof (gint));
+    collect_bin_widths (self, widths);
 
-            if (new_y + img_h > self->max_height)
+    /*
+     * Rotation is greedy and can make a later image fit worse, so when
+     * it is allowed the unrotated trials run too. That way allowing
+     * rotation never gives a worse result.
+     */
+    for (r = 0; r < (self->allow_rotation ? 2u : 1u); r++)
+    {
+        for (w = 0; w < widths->len; w++)
+        {
+            for (h = 0; h < PACK_N_HEURISTICS; h++)
             {
-                g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
-                             "Image '%s' (%dx%d) does not fit in atlas",
-                             image->name, image->width, image->height);
-                g_array_unref (shelves);
-                g_ptr_array_unref (sorted);
-                return FALSE;
+                for (s = 0; s < PACK_N_SORTS; s++)
+                {
+                    trial.heuristic = (PackHeuristic)h;
+                    trial.sort = (PackSort)s;
+                    trial.bin_width = g_array_index (widths, gint, w);
+                    trial.allow_rotation = (r == 0) && self->allow_rotation;
+                    g_array_append_val (trials, trial);
+                }
             }
+        }
+    }
 
-            new_shelf.y = new_y;
-            new_shelf.height = img_h;
-            new_shelf.x_used = img_w;
+    g_array_unref (widths);
+    return trials;
+}
 
-            image->packed_x = 0;
-            image->packed_y = new_y;
-            image->rotated = FALSE;
-            image->packed = TRUE;
+static void
+run_trial_func (gpointer data,
+                gpointer user_data)
+{
+    PackTrial *trial = data;
+    LrgAtlasPacker *self = trial->packer;
 
-            g_array_append_val (shelves, new_shelf);
+    (void)user_data;
 
-            if (img_w > total_width)
-                total_width = img_w;
+    run_trial (trial);
 
-            total_height = new_y + img_h;
-        }
-    }
+    g_mutex_lock (&self->lock);
+    if (--self->pending == 0)
+        g_cond_signal (&self->cond);
+    g_mutex_unlock (&self->lock);
+}
 
-    /* Set final dimensions */
-    self->packed_width = total_width;
-    self->packed_height = total_height;
+static guint
+resolve_threads (LrgAtlasPacker *self)
+{
+    return self->max_threads > 0 ? self->max_threads
+                                 : (guint)MAX (1, g_get_num_processors ());
+}
 
-    if (self->power_of_two)
+/*
+ * run_trials:
+ *
+ * Runs every trial, across the pool when there is enough work.
+ * Returns once all trials are done.
+ */
+static void
+run_trials (LrgAtlasPacker *self,
+            GArray         *trials)
+{
+    guint threads;
+    guint i;
+
+    threads = resolve_threads (self);
+
+    if (threads <= 1 || trials->len < 2 || self->images->len < PARALLEL_MIN_IMAGES)
     {
-        self->packed_width = next_power_of_two (self->packed_width);
-        self->packed_height = next_power_of_two (self->packed_height);
+        for (i = 0; i < trials->len; i++)
+            run_trial (&g_array_index (trials, PackTrial, i));
+        return;
     }
 
-    g_array_unref (shelves);
-    g_ptr_array_unref (sorted);
+    if (self->pool == NULL)
+        self->pool = g_thread_pool_new (run_trial_func, NULL, threads, FALSE, NULL);
+    else if ((guint)g_thread_pool_get_max_threads (self->pool) != threads)
+        g_thread_pool_set_max_threads (self->pool, threads, NULL);
 
-    return TRUE;
+    g_mutex_lock (&self->lock);
+    self->pending = trials->len;
+    g_mutex_unlock (&self->lock);
+
+    for (i = 0; i < trials->len; i++)
+        g_thread_pool_push (self->pool, &g_array_index (trials, PackTrial, i), NULL);
+
+    g_mutex_lock (&self->lock);
+    while (self->pending > 0)
+        g_cond_wait (&self->cond, &self->lock);
+    g_mutex_unlock (&self->lock);
 }
 
 /**
@@ -771,6 +1583,12 @@ pack_shelf (LrgAtlasPacker  *self,
  * Performs the packing algorithm to arrange all images.
  * After packing, use lrg_atlas_packer_create_atlas() to get the result.
  *
+ * Images that do not fit within the maximum size spill onto further
+ * pages, up to #LrgAtlasPacker:max-pages, which allows a single page
+ * by default. MaxRects and Guillotine try
+ * several heuristics, sort orders and page widths and keep the result
+ * with the fewest pages and the least area.
+ *
  * Returns: %TRUE if packing succeeded
  *
  * Since: 1.0
@@ -779,8 +1597,9 @@ gboolean
 lrg_atlas_packer_pack (LrgAtlasPacker  *self,
                        GError         **error)
 {
+    GArray *trials;
+    PackTrial *best;
     guint i;
-    gboolean result;
 
     g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), FALSE);
 
@@ -800,33 +1619,70 @@ lrg_atlas_packer_pack (LrgAtlasPacker  *self,
 
     self->packed_width = 0;
     self->packed_height = 0;
+    g_array_set_size (self->pages, 0);
+    self->is_packed = FALSE;
+
+    /* An image larger than a page can never be placed */
+    for (i = 0; i < self->images->len; i++)
+    {
+        LrgAtlasPackerImage *image = g_ptr_array_index (self->images, i);
+        gint w = image->width + self->padding;
+        gint h = image->height + self->padding;
+
+        if ((w > self->max_width || h > self->max_height) &&
+            (!self->allow_rotation || h > self->max_width || w > self->max_height))
+        {
+            g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                         "Image '%s' (%dx%d) does not fit in atlas",
+                         image->name, image->width, image->height);
+            return FALSE;
+        }
+    }
 
     /* Run packing algorithm */
-    switch (self->method)
+    trials = create_trials (self);
+    run_trials (self, trials);
+
+    best = &g_array_index (trials, PackTrial, 0);
+    for (i = 1; i < trials->len; i++)
     {
-    case LRG_ATLAS_PACK_METHOD_SHELF:
-        result = pack_shelf (self, error);
-        break;
+        PackTrial *trial = &g_array_index (trials, PackTrial, i);
 
-    case LRG_ATLAS_PACK_METHOD_MAXRECTS:
-        /* TODO: Implement maxrects algorithm */
-        g_warning ("MaxRects algorithm not yet implemented, using Shelf");
-        result = pack_shelf (self, error);
-        break;
+        if (trial_is_better (trial, best))
+            best = trial;
+    }
 
-    case LRG_ATLAS_PACK_METHOD_GUILLOTINE:
-        /* TODO: Implement guillotine algorithm */
-        g_warning ("Guillotine algorithm not yet implemented, using Shelf");
-        result = pack_shelf (self, error);
-        break;
+    if (!best->ok)
+    {
+        g_set_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                     "Images do not fit in %u atlas page(s)", self->max_pages);
+        for (i = 0; i < trials->len; i++)
+            pack_trial_clear (&g_array_index (trials, PackTrial, i));
+        g_array_unref (trials);
+        return FALSE;
+    }
 
-    default:
-        result = pack_shelf (self, error);
-        break;
+    for (i = 0; i < self->images->len; i++)
+    {
+        LrgAtlasPackerImage *image = g_ptr_array_index (self->images, i);
+
+        image->page = best->placements[i].page;
+        image->packed_x = best->placements[i].x;
+        image->packed_y = best->placements[i].y;
+        image->rotated = best->placements[i].rotated;
+        image->packed = TRUE;
     }
 
-    self->is_packed = result;
-    return result;
+    g_array_append_vals (self->pages, best->pages->data, best->pages->len);
+    self->packed_width = g_array_index (self->pages, PackPage, 0).width;
+    self->packed_height = g_array_index (self->pages, PackPage, 0).height;
+
+    for (i = 0; i < trials->len; i++)
+        pack_trial_clear (&g_array_index (trials, PackTrial, i));
+    g_array_unref (trials);
+
+    self->is_packed = TRUE;
+    return TRUE;
 }
 
 /**
@@ -834,6 +1690,7 @@ lrg_atlas_packer_pack (LrgAtlasPacker  *self,
  * @self: A #LrgAtlasPacker
  *
  * Gets the width of the packed atlas (available after pack()).
+ * When images spilled onto several pages, this is the first page.
  *
  * Returns: Packed width in pixels, or 0 if not yet packed
  *
@@ -851,6 +1708,7 @@ lrg_atlas_packer_get_packed_width (LrgAtlasPacker *self)
  * @self: A #LrgAtlasPacker
  *
  * Gets the height of the packed atlas (available after pack()).
+ * When images spilled onto several pages, this is the first page.
  *
  * Returns: Packed height in pixels, or 0 if not yet packed
  *
@@ -867,7 +1725,7 @@ lrg_atlas_packer_get_packed_height (LrgAtlasPacker *self)
  * lrg_atlas_packer_get_efficiency:
  * @self: A #LrgAtlasPacker
  *
- * Gets the packing efficiency (used area / total area).
+ * Gets the packing efficiency (used area / total area), over all pages.
  *
  * Returns: Efficiency as a value 0.0-1.0, or 0 if not yet packed
  *
@@ -876,8 +1734,8 @@ lrg_atlas_packer_get_packed_height (LrgAtlasPacker *self)
 gfloat
 lrg_atlas_packer_get_efficiency (LrgAtlasPacker *self)
 {
-    gint total_area;
-    gint used_area = 0;
+    gdouble total_area = 0.0;
+    gdouble used_area = 0.0;
     guint i;
 
     g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), 0.0f);
@@ -885,8 +1743,13 @@ lrg_atlas_packer_get_efficiency (LrgAtlasPacker *self)
     if (!self->is_packed)
         return 0.0f;
 
-    total_area = self->packed_width * self->packed_height;
-    if (total_area <= 0)
+    for (i = 0; i < self->pages->len; i++)
+    {
+        PackPage *page = &g_array_index (self->pages, PackPage, i);
+        total_area += (gdouble)page->width * page->height;
+    }
+
+    if (total_area <= 0.0)
         return 0.0f;
 
     for (i = 0; i < self->images->len; i++)
@@ -894,11 +1757,63 @@ lrg_atlas_packer_get_efficiency (LrgAtlasPacker *self)
         LrgAtlasPackerImage *image = g_ptr_array_index (self->images, i);
         if (image->packed)
         {
-            used_area += image->width * image->height;
+            used_area += (gdouble)image->width * image->height;
         }
     }
 
-    return (gfloat)used_area / (gfloat)total_area;
+    return (gfloat)(used_area / total_area);
+}
+
+/**
+ * lrg_atlas_packer_get_page_count:
+ * @self: A #LrgAtlasPacker
+ *
+ * Gets the number of atlas pages (available after pack()).
+ *
+ * Returns: Page count, or 0 if not yet packed
+ *
+ * Since: 1.0
+ */
+guint
+lrg_atlas_packer_get_page_count (LrgAtlasPacker *self)
+{
+    g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), 0);
+    return self->is_packed ? self->pages->len : 0;
+}
+
+/**
+ * lrg_atlas_packer_get_page_size:
+ * @self: A #LrgAtlasPacker
+ * @page: Page index
+ * @out_width: (out) (nullable): Return location for the page width
+ * @out_height: (out) (nullable): Return location for the page height
+ *
+ * Gets the size of a packed page.
+ *
+ * Returns: %TRUE if the page exists
+ *
+ * Since: 1.0
+ */
+gboolean
+lrg_atlas_packer_get_page_size (LrgAtlasPacker *self,
+                                guint           page,
+                                gint           *out_width,
+                                gint           *out_height)
+{
+    PackPage *info;
+
+    g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), FALSE);
+
+    if (!self->is_packed || page >= self->pages->len)
+        return FALSE;
+
+    info = &g_array_index (self->pages, PackPage, page);
+    if (out_width != NULL)
+        *out_width = info->width;
+    if (out_height != NULL)
+        *out_height = info->height;
+
+    return TRUE;
 }
 
 /**
@@ -906,8 +1821,9 @@ lrg_atlas_packer_get_efficiency (LrgAtlasPacker *self)
  * @self: A #LrgAtlasPacker
  * @name: Name for the atlas
  *
- * Creates a texture atlas from the packed result.
- * Must call lrg_atlas_packer_pack() first.
+ * Creates a texture atlas from the first packed page.
+ * Must call lrg_atlas_packer_pack() first. When more than one page
+ * was packed, use lrg_atlas_packer_create_page_atlas() for each page.
  *
  * Returns: (transfer full) (nullable): A new #LrgTextureAtlas, or %NULL if not packed
  *
@@ -916,8 +1832,30 @@ lrg_atlas_packer_get_efficiency (LrgAtlasPacker *self)
 LrgTextureAtlas *
 lrg_atlas_packer_create_atlas (LrgAtlasPacker *self,
                                const gchar    *name)
+{
+    return lrg_atlas_packer_create_page_atlas (self, name, 0);
+}
+
+/**
+ * lrg_atlas_packer_create_page_atlas:
+ * @self: A #LrgAtlasPacker
+ * @name: Name for the atlas
+ * @page: Page index
+ *
+ * Creates a texture atlas holding the images packed onto @page.
+ * Must call lrg_atlas_packer_pack() first.
+ *
+ * Returns: (transfer full) (nullable): A new #LrgTextureAtlas, or %NULL if not packed
+ *
+ * Since: 1.0
+ */
+LrgTextureAtlas *
+lrg_atlas_packer_create_page_atlas (LrgAtlasPacker *self,
+                                    const gchar    *name,
+                                    guint           page)
 {
     LrgTextureAtlas *atlas;
+    PackPage *info;
     guint i;
 
     g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), NULL);
@@ -928,22 +1866,26 @@ lrg_atlas_packer_create_atlas (LrgAtlasPacker *self,
         return NULL;
     }
 
+    g_return_val_if_fail (page < self->pages->len, NULL);
+
+    info = &g_array_index (self->pages, PackPage, page);
     atlas = lrg_texture_atlas_new (name);
-    lrg_texture_atlas_set_size (atlas, self->packed_width, self->packed_height);
+    lrg_texture_atlas_set_size (atlas, info->width, info->height);
 
     for (i = 0; i < self->images->len; i++)
     {
         LrgAtlasPackerImage *image = g_ptr_array_index (self->images, i);
 
-        if (image->packed)
+        if (image->packed && image->page == (gint)page)
         {
             LrgAtlasRegion *region;
 
+            /* A rotated image lies height x width on the page */
             region = lrg_texture_atlas_add_region_rect (atlas, image->name,
                                                         image->packed_x,
                                                         image->packed_y,
-                                                        image->width,
-                                                        image->height);
+                                                        image->rotated ? image->height : image->width,
+                                                        image->rotated ? image->width : image->height);
 
             if (image->rotated && region != NULL)
             {
@@ -996,6 +1938,34 @@ lrg_atlas_packer_get_image_position (LrgAtlasPacker *self,
     return TRUE;
 }
 
+/**
+ * lrg_atlas_packer_get_image_page:
+ * @self: A #LrgAtlasPacker
+ * @name: Name of the image
+ *
+ * Gets the page an image was packed onto.
+ * Must call lrg_atlas_packer_pack() first.
+ *
+ * Returns: The page index, or -1 if the image was not found or packed
+ *
+ * Since: 1.0
+ */
+gint
+lrg_atlas_packer_get_image_page (LrgAtlasPacker *self,
+                                 const gchar    *name)
+{
+    LrgAtlasPackerImage *image;
+
+    g_return_val_if_fail (LRG_IS_ATLAS_PACKER (self), -1);
+    g_return_val_if_fail (name != NULL, -1);
+
+    image = g_hash_table_lookup (self->images_by_name, name);
+    if (image == NULL || !image->packed)
+        return -1;
+
+    return image->page;
+}
+
 /**
  * lrg_atlas_packer_get_image_user_data:
  * @self: A #LrgAtlasPacker
@@ -173,6 +173,8 @@ gboolean            lrg_atlas_packer_get_power_of_two       (LrgAtlasPacker *sel
  * @allow: Whether to allow 90-degree rotation
  *
  * Sets whether images can be rotated 90 degrees to fit better.
+ * A rotated image takes up height x width pixels on its page; its
+ * region keeps the unrotated size and is flagged as rotated.
  *
  * Since: 1.0
  */
@@ -193,6 +195,62 @@ void                lrg_atlas_packer_set_allow_rotation     (LrgAtlasPacker *sel
 LRG_AVAILABLE_IN_ALL
 gboolean            lrg_atlas_packer_get_allow_rotation     (LrgAtlasPacker *self);
 
+/**
+ * lrg_atlas_packer_set_max_pages:
+ * @self: A #LrgAtlasPacker
+ * @max_pages: Maximum number of pages, or 0 for no limit
+ *
+ * Sets how many atlas pages images may spill onto when they do not
+ * fit within the maximum size. With a limit of 1, the default, packing
+ * fails instead of spilling.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_atlas_packer_set_max_pages          (LrgAtlasPacker *self,
+                                                             guint           max_pages);
+
+/**
+ * lrg_atlas_packer_get_max_pages:
+ * @self: A #LrgAtlasPacker
+ *
+ * Gets the page limit.
+ *
+ * Returns: Maximum number of pages, or 0 for no limit
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_atlas_packer_get_max_pages          (LrgAtlasPacker *self);
+
+/**
+ * lrg_atlas_packer_set_max_threads:
+ * @self: A #LrgAtlasPacker
+ * @max_threads: Worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Sets how many threads try packing heuristics. The result does not
+ * depend on the thread count. Defaults to 0.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_atlas_packer_set_max_threads        (LrgAtlasPacker *self,
+                                                             guint           max_threads);
+
+/**
+ * lrg_atlas_packer_get_max_threads:
+ * @self: A #LrgAtlasPacker
+ *
+ * Gets the thread limit.
+ *
+ * Returns: Thread limit, 0 meaning one per processor
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_atlas_packer_get_max_threads        (LrgAtlasPacker *self);
+
 /* Image management */
 
 /**
@@ -266,6 +324,12 @@ guint               lrg_atlas_packer_get_image_count        (LrgAtlasPacker *sel
  * Performs the packing algorithm to arrange all images.
  * After packing, use lrg_atlas_packer_create_atlas() to get the result.
  *
+ * Images that do not fit within the maximum size spill onto further
+ * pages, up to #LrgAtlasPacker:max-pages, which allows a single page
+ * by default. MaxRects and Guillotine try
+ * several heuristics, sort orders and page widths and keep the result
+ * with the fewest pages and the least area.
+ *
  * Returns: %TRUE if packing succeeded
  *
  * Since: 1.0
@@ -279,6 +343,7 @@ gboolean            lrg_atlas_packer_pack                   (LrgAtlasPacker  *se
  * @self: A #LrgAtlasPacker
  *
  * Gets the width of the packed atlas (available after pack()).
+ * When images spilled onto several pages, this is the first page.
  *
  * Returns: Packed width in pixels, or 0 if not yet packed
  *
@@ -292,6 +357,7 @@ gint                lrg_atlas_packer_get_packed_width       (LrgAtlasPacker *sel
  * @self: A #LrgAtlasPacker
  *
  * Gets the height of the packed atlas (available after pack()).
+ * When images spilled onto several pages, this is the first page.
  *
  * Returns: Packed height in pixels, or 0 if not yet packed
  *
@@ -304,7 +370,7 @@ gint                lrg_atlas_packer_get_packed_height      (LrgAtlasPacker *sel
  * lrg_atlas_packer_get_efficiency:
  * @self: A #LrgAtlasPacker
  *
- * Gets the packing efficiency (used area / total area).
+ * Gets the packing efficiency (used area / total area), over all pages.
  *
  * Returns: Efficiency as a value 0.0-1.0, or 0 if not yet packed
  *
@@ -313,6 +379,38 @@ gint                lrg_atlas_packer_get_packed_height      (LrgAtlasPacker *sel
 LRG_AVAILABLE_IN_ALL
 gfloat              lrg_atlas_packer_get_efficiency         (LrgAtlasPacker *self);
 
+/**
+ * lrg_atlas_packer_get_page_count:
+ * @self: A #LrgAtlasPacker
+ *
+ * Gets the number of atlas pages (available after pack()).
+ *
+ * Returns: Page count, or 0 if not yet packed
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_atlas_packer_get_page_count         (LrgAtlasPacker *self);
+
+/**
+ * lrg_atlas_packer_get_page_size:
+ * @self: A #LrgAtlasPacker
+ * @page: Page index
+ * @out_width: (out) (nullable): Return location for the page width
+ * @out_height: (out) (nullable): Return location for the page height
+ *
+ * Gets the size of a packed page.
+ *
+ * Returns: %TRUE if the page exists
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_atlas_packer_get_page_size          (LrgAtlasPacker *self,
+                                                             guint           page,
+                                                             gint           *out_width,
+                                                             gint           *out_height);
+
 /* Result access */
 
 /**
@@ -320,7 +418,7 @@ gfloat              lrg_atlas_packer_get_efficiency         (LrgAtlasPacker *sel
  * @self: A #LrgAtlasPacker
  * @name: Name for the atlas
  *
- * Creates a texture atlas from the packed result.
+ * Creates a texture atlas from the first packed page.
  * Must call lrg_atlas_packer_pack() first.
  *
  * Returns: (transfer full) (nullable): A new #LrgTextureAtlas, or %NULL if not packed
@@ -331,6 +429,24 @@ LRG_AVAILABLE_IN_ALL
 LrgTextureAtlas *   lrg_atlas_packer_create_atlas           (LrgAtlasPacker *self,
                                                              const gchar    *name);
 
+/**
+ * lrg_atlas_packer_create_page_atlas:
+ * @self: A #LrgAtlasPacker
+ * @name: Name for the atlas
+ * @page: Page index
+ *
+ * Creates a texture atlas holding the images packed onto @page.
+ * Must call lrg_atlas_packer_pack() first.
+ *
+ * Returns: (transfer full) (nullable): A new #LrgTextureAtlas, or %NULL if not packed
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgTextureAtlas *   lrg_atlas_packer_create_page_atlas      (LrgAtlasPacker *self,
+                                                             const gchar    *name,
+                                                             guint           page);
+
 /**
  * lrg_atlas_packer_get_image_position:
  * @self: A #LrgAtlasPacker
@@ -353,6 +469,22 @@ gboolean            lrg_atlas_packer_get_image_position     (LrgAtlasPacker *sel
                                                              gint           *out_y,
                                                              gboolean       *out_rotated);
 
+/**
+ * lrg_atlas_packer_get_image_page:
+ * @self: A #LrgAtlasPacker
+ * @name: Name of the image
+ *
+ * Gets the page an image was packed onto.
+ * Must call lrg_atlas_packer_pack() first.
+ *
+ * Returns: The page index, or -1 if the image was not found or packed
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint                lrg_atlas_packer_get_image_page         (LrgAtlasPacker *self,
+                                                             const gchar    *name);
+
 /**
  * lrg_atlas_packer_get_image_user_data:
  * @self: A #LrgAtlasPacker
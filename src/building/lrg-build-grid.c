@@ -74,6 +74,20 @@ lrg_build_cell_is_free (const LrgBuildCell *cell)
 /* LrgBuildGrid                                                               */
 /* ========================================================================== */
 
+/*
+ * Summed-area table of the cells a footprint may not cover: occupied,
+ * blocked, or (for a non-zero @mask) of a terrain outside @mask. Any
+ * rectangle is then checked with four lookups. Mutations only record
+ * the first stale row; the table is brought up to date from there on
+ * the next query, so a burst of edits costs one partial rebuild.
+ */
+typedef struct
+{
+    guint    mask;        /* Buildable terrain, 0 to ignore terrain */
+    guint32 *sums;        /* (width + 1) * (height + 1), row 0 and column 0 are zero */
+    gint     dirty_row;   /* First stale row, height when up to date */
+} BuildGridTable;
+
 struct _LrgBuildGrid
 {
     GObject       parent_instance;
@@ -83,6 +97,7 @@ struct _LrgBuildGrid
     gdouble       cell_size;
     LrgBuildCell **cells;      /* 2D array: cells[y * width + x] */
     GPtrArray    *buildings;   /* All buildings on the grid */
+    GHashTable   *tables;      /* terrain mask -> BuildGridTable */
 };
 
 enum
@@ -150,6 +165,127 @@ get_rotated_dimensions (LrgBuildingDef *def,
     }
 }
 
+static void
+build_grid_table_free (gpointer data)
+{
+    BuildGridTable *table = data;
+
+    g_free (table->sums);
+    g_free (table);
+}
+
+/* Marks every occupancy table stale from row @y down */
+static void
+invalidate_tables (LrgBuildGrid *self,
+                   gint          y)
+{
+    GHashTableIter  iter;
+    gpointer        value;
+
+    g_hash_table_iter_init (&iter, self->tables);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        BuildGridTable *table = value;
+
+        table->dirty_row = MIN (table->dirty_row, MAX (y, 0));
+    }
+}
+
+/* Returns the up to date occupancy table for @mask, creating it on first use */
+static BuildGridTable *
+get_table (LrgBuildGrid *self,
+           guint         mask)
+{
+    BuildGridTable *table;
+    gint            stride = self->width + 1;
+    gint            x;
+    gint            y;
+
+    table = g_hash_table_lookup (self->tables, GUINT_TO_POINTER (mask));
+    if (table == NULL)
+    {
+        table = g_new0 (BuildGridTable, 1);
+        table->mask = mask;
+        table->sums = g_new0 (guint32, (gsize)stride * (self->height + 1));
+        table->dirty_row = 0;
+        g_hash_table_insert (self->tables, GUINT_TO_POINTER (mask), table);
+    }
+
+    for (y = table->dirty_row; y < self->height; y++)
+    {
+        const guint32 *above = table->sums + (gsize)y * stride;
+        guint32       *row = table->sums + (gsize)(y + 1) * stride;
+        guint32        run = 0;
+
+        for (x = 0; x < self->width; x++)
+        {
+            const LrgBuildCell *cell = self->cells[cell_index (self, x, y)];
+
+            if (!lrg_build_cell_is_free (cell) ||
+                (mask != 0 && (cell->terrain & mask) == 0))
+                run++;
+
+            row[x + 1] = above[x + 1] + run;
+        }
+    }
+    table->dirty_row = self->height;
+
+    return table;
+}
+
+/* Counts the cells of a table inside a rectangle that lies within bounds */
+static inline guint32
+table_count (LrgBuildGrid         *self,
+             const BuildGridTable *table,
+             gint                  x,
+             gint                  y,
+             gint                  width,
+             gint                  height)
+{
+    gint           stride = self->width + 1;
+    const guint32 *top = table->sums + (gsize)y * stride;
+    const guint32 *bottom = table->sums + (gsize)(y + height) * stride;
+
+    return bottom[x + width] - bottom[x] - top[x + width] + top[x];
+}
+
+static inline gboolean
+rect_in_bounds (LrgBuildGrid *self,
+                gint          x,
+                gint          y,
+                gint          width,
+                gint          height)
+{
+    return (x >= 0 && y >= 0 &&
+            width <= self->width - x && height <= self->height - y);
+}
+
+/* The per-origin test shared by can_place and the placement mask */
+static gboolean
+can_place_with_table (LrgBuildGrid         *self,
+                      const BuildGridTable *table,
+                      LrgBuildingDef       *definition,
+                      gint                  x,
+                      gint                  y,
+                      gint                  eff_width,
+                      gint                  eff_height)
+{
+    LrgBuildCell *cell;
+
+    if (eff_width > 0 && eff_height > 0)
+    {
+        if (!rect_in_bounds (self, x, y, eff_width, eff_height))
+            return FALSE;
+        if (table_count (self, table, x, y, eff_width, eff_height) != 0)
+            return FALSE;
+    }
+
+    /* Also ask the building definition (terrain already validated above) */
+    cell = lrg_build_grid_get_cell (self, x, y);
+    return lrg_building_def_can_build (definition, x, y,
+                                       cell ? cell->terrain : LRG_TERRAIN_NONE);
+}
+
 static void
 lrg_build_grid_dispose (GObject *object)
 {
@@ -176,6 +312,8 @@ lrg_build_grid_finalize (GObject *object)
         g_free (self->cells);
     }
 
+    g_clear_pointer (&self->tables, g_hash_table_unref);
+
     G_OBJECT_CLASS (lrg_build_grid_parent_class)->finalize (object);
 }
 
@@ -377,6 +515,8 @@ static void
 lrg_build_grid_init (LrgBuildGrid *self)
 {
     self->buildings = g_ptr_array_new_with_free_func (g_object_unref);
+    self->tables = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                          NULL, build_grid_table_free);
 }
 
 /* Public API */
@@ -461,6 +601,7 @@ lrg_build_grid_set_terrain (LrgBuildGrid    *self,
     if (cell->terrain != terrain)
     {
         cell->terrain = terrain;
+        invalidate_tables (self, y);
         g_signal_emit (self, signals[SIGNAL_CELL_CHANGED], 0, x, y);
     }
 }
@@ -497,6 +638,7 @@ lrg_build_grid_fill_terrain (LrgBuildGrid    *self,
             self->cells[cell_index (self, x, y)]->terrain = terrain;
         }
     }
+    invalidate_tables (self, 0);
 
     lrg_debug (LRG_LOG_DOMAIN_BUILDING, "Filled grid with terrain %d", terrain);
 }
@@ -540,6 +682,7 @@ lrg_build_grid_set_blocked (LrgBuildGrid *self,
     if (cell->blocked != blocked)
     {
         cell->blocked = blocked;
+        invalidate_tables (self, y);
         g_signal_emit (self, signals[SIGNAL_CELL_CHANGED], 0, x, y);
     }
 }
@@ -567,23 +710,14 @@ lrg_build_grid_is_area_free (LrgBuildGrid *self,
                              gint          width,
                              gint          height)
 {
-    gint          cx;
-    gint          cy;
-    LrgBuildCell *cell;
-
     g_return_val_if_fail (LRG_IS_BUILD_GRID (self), FALSE);
 
-    for (cy = y; cy < y + height; cy++)
-    {
-        for (cx = x; cx < x + width; cx++)
-        {
-            cell = lrg_build_grid_get_cell (self, cx, cy);
-            if (cell == NULL || !lrg_build_cell_is_free (cell))
-                return FALSE;
-        }
-    }
+    if (width <= 0 || height <= 0)
+        return TRUE;
+    if (!rect_in_bounds (self, x, y, width, height))
+        return FALSE;
 
-    return TRUE;
+    return table_count (self, get_table (self, 0), x, y, width, height) == 0;
 }
 
 gboolean
@@ -596,9 +730,6 @@ lrg_build_grid_can_place (LrgBuildGrid   *self,
     gint             eff_width;
     gint             eff_height;
     LrgTerrainType  buildable_on;
-    gint             cx;
-    gint             cy;
-    LrgBuildCell    *cell;
 
     g_return_val_if_fail (LRG_IS_BUILD_GRID (self), FALSE);
     g_return_val_if_fail (LRG_IS_BUILDING_DEF (definition), FALSE);
@@ -606,33 +737,56 @@ lrg_build_grid_can_place (LrgBuildGrid   *self,
     get_rotated_dimensions (definition, rotation, &eff_width, &eff_height);
     buildable_on = lrg_building_def_get_buildable_on (definition);
 
-    /* Check each cell */
-    for (cy = y; cy < y + eff_height; cy++)
-    {
-        for (cx = x; cx < x + eff_width; cx++)
-        {
-            cell = lrg_build_grid_get_cell (self, cx, cy);
+    /* No terrain is buildable; mask 0 would mean "ignore terrain" */
+    if (buildable_on == LRG_TERRAIN_NONE && eff_width > 0 && eff_height > 0)
+        return FALSE;
+
+    return can_place_with_table (self, get_table (self, buildable_on), definition,
+                                 x, y, eff_width, eff_height);
+}
+
+GBytes *
+lrg_build_grid_get_placement_mask (LrgBuildGrid   *self,
+                                   LrgBuildingDef *definition,
+                                   LrgRotation     rotation,
+                                   gint            x,
+                                   gint            y,
+                                   gint            width,
+                                   gint            height)
+{
+    BuildGridTable *table;
+    LrgTerrainType  buildable_on;
+    guint8         *mask;
+    gint            eff_width;
+    gint            eff_height;
+    gint            i;
+    gint            j;
 
-            /* Out of bounds */
-            if (cell == NULL)
-                return FALSE;
+    g_return_val_if_fail (LRG_IS_BUILD_GRID (self), NULL);
+    g_return_val_if_fail (LRG_IS_BUILDING_DEF (definition), NULL);
+    g_return_val_if_fail (width >= 0 && height >= 0, NULL);
+
+    mask = g_malloc0 ((gsize)width * height);
+
+    get_rotated_dimensions (definition, rotation, &eff_width, &eff_height);
+    buildable_on = lrg_building_def_get_buildable_on (definition);
 
-            /* Already occupied or blocked */
-            if (!lrg_build_cell_is_free (cell))
-                return FALSE;
+    if (buildable_on != LRG_TERRAIN_NONE || eff_width <= 0 || eff_height <= 0)
+    {
+        table = get_table (self, buildable_on);
 
-            /* Terrain check */
-            if ((cell->terrain & buildable_on) == 0)
-                return FALSE;
+        for (j = 0; j < height; j++)
+        {
+            for (i = 0; i < width; i++)
+            {
+                mask[(gsize)j * width + i] =
+                    can_place_with_table (self, table, definition,
+                                          x + i, y + j, eff_width, eff_height);
+            }
         }
     }
 
-    /* Also ask the building definition (terrain already validated above) */
-    cell = lrg_build_grid_get_cell (self, x, y);
-    if (!lrg_building_def_can_build (definition, x, y, cell ? cell->terrain : LRG_TERRAIN_NONE))
-        return FALSE;
-
-    return TRUE;
+    return g_bytes_new_take (mask, (gsize)width * height);
 }
 
 void
@@ -723,6 +877,7 @@ lrg_build_grid_place_building (LrgBuildGrid        *self,
             cell->building = building;
         }
     }
+    invalidate_tables (self, y);
 
     /* Add to building list */
     g_ptr_array_add (self->buildings, g_object_ref (building));
@@ -779,6 +934,7 @@ lrg_build_grid_remove_building (LrgBuildGrid        *self,
                 cell->building = NULL;
         }
     }
+    invalidate_tables (self, y);
 
     lrg_debug (LRG_LOG_DOMAIN_BUILDING,
                "Removed building '%s' from (%d, %d)",
@@ -831,6 +987,10 @@ lrg_build_grid_get_buildings_in_area (LrgBuildGrid *self,
                                       gint          height)
 {
     GPtrArray           *result;
+    gint                 x0;
+    gint                 y0;
+    gint                 x1;
+    gint                 y1;
     gint                 cx;
     gint                 cy;
     LrgBuildCell        *cell;
@@ -840,18 +1000,28 @@ lrg_build_grid_get_buildings_in_area (LrgBuildGrid *self,
 
     result = g_ptr_array_new ();
 
-    for (cy = y; cy < y + height; cy++)
+    /* Clip to the grid */
+    x0 = MAX (x, 0);
+    y0 = MAX (y, 0);
+    x1 = MIN (x + width, self->width);
+    y1 = MIN (y + height, self->height);
+
+    for (cy = y0; cy < y1; cy++)
     {
-        for (cx = x; cx < x + width; cx++)
+        for (cx = x0; cx < x1; cx++)
         {
-            cell = lrg_build_grid_get_cell (self, cx, cy);
-            if (cell == NULL || cell->building == NULL)
+            cell = self->cells[cell_index (self, cx, cy)];
+            if (cell->building == NULL)
                 continue;
 
             building = cell->building;
 
-            /* Avoid duplicates */
-            if (!g_ptr_array_find (result, building, NULL))
+            /*
+             * Report each building once, at the first of its cells the
+             * scan reaches: its top-left corner clipped to the area.
+             */
+            if (cx == MAX (lrg_building_instance_get_grid_x (building), x0) &&
+                cy == MAX (lrg_building_instance_get_grid_y (building), y0))
             {
                 g_ptr_array_add (result, building);
             }
@@ -880,6 +1050,7 @@ lrg_build_grid_clear (LrgBuildGrid *self)
 
     /* Clear building list */
     g_ptr_array_set_size (self->buildings, 0);
+    invalidate_tables (self, 0);
 
     lrg_debug (LRG_LOG_DOMAIN_BUILDING, "Cleared all buildings from grid");
 }
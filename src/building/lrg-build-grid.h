@@ -226,7 +226,9 @@ lrg_build_grid_get_cell_size (LrgBuildGrid *self);
  * @x: Cell X coordinate
  * @y: Cell Y coordinate
  *
- * Gets the cell at the given coordinates.
+ * Gets the cell at the given coordinates. The cell is owned by the grid;
+ * change it only through the grid setters so cached placement data
+ * stays in sync.
  *
  * Returns: (transfer none) (nullable): The cell, or %NULL if out of bounds
  *
@@ -415,6 +417,39 @@ lrg_build_grid_can_place (LrgBuildGrid   *self,
                           gint            y,
                           LrgRotation     rotation);
 
+/**
+ * lrg_build_grid_get_placement_mask:
+ * @self: an #LrgBuildGrid
+ * @definition: Building definition to check
+ * @rotation: Building rotation
+ * @x: X of the first candidate origin
+ * @y: Y of the first candidate origin
+ * @width: Number of candidate origins per row
+ * @height: Number of candidate rows
+ *
+ * Evaluates lrg_build_grid_can_place() for every origin in the
+ * @width x @height rectangle at (@x, @y) in one call. Byte
+ * `[j * width + i]` of the result is 1 if @definition fits with its
+ * origin at (@x + i, @y + j) and 0 otherwise.
+ *
+ * Each origin costs O(1) against the grid's cached occupancy table,
+ * so this is suitable for tinting the whole area under a placement
+ * ghost every frame.
+ *
+ * Returns: (transfer full): a #GBytes of @width * @height bytes
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+GBytes *
+lrg_build_grid_get_placement_mask (LrgBuildGrid   *self,
+                                   LrgBuildingDef *definition,
+                                   LrgRotation     rotation,
+                                   gint            x,
+                                   gint            y,
+                                   gint            width,
+                                   gint            height);
+
 /* Coordinate conversion */
 
 /**
@@ -555,6 +555,31 @@ lrg_placement_system_get_current_definition (LrgPlacementSystem *self)
     return self->current_def;
 }
 
+GBytes *
+lrg_placement_system_get_placement_mask (LrgPlacementSystem *self,
+                                         gint                x,
+                                         gint                y,
+                                         gint                width,
+                                         gint                height)
+{
+    g_return_val_if_fail (LRG_IS_PLACEMENT_SYSTEM (self), NULL);
+
+    if (self->state != LRG_PLACEMENT_STATE_PLACING || self->current_def == NULL)
+        return NULL;
+
+    /* Resources don't depend on position, so check them once */
+    if (self->resource_check != NULL &&
+        !self->resource_check (self->current_def, 1, self->resource_check_data))
+    {
+        return g_bytes_new_take (g_malloc0 ((gsize)MAX (width, 0) * MAX (height, 0)),
+                                 (gsize)MAX (width, 0) * MAX (height, 0));
+    }
+
+    return lrg_build_grid_get_placement_mask (self->grid, self->current_def,
+                                              self->rotation, x, y,
+                                              width, height);
+}
+
 LrgBuildingInstance *
 lrg_placement_system_confirm (LrgPlacementSystem *self)
 {
@@ -353,6 +353,31 @@ LRG_AVAILABLE_IN_ALL
 LrgBuildingDef *
 lrg_placement_system_get_current_definition (LrgPlacementSystem *self);
 
+/**
+ * lrg_placement_system_get_placement_mask:
+ * @self: an #LrgPlacementSystem
+ * @x: X of the first candidate origin
+ * @y: Y of the first candidate origin
+ * @width: Number of candidate origins per row
+ * @height: Number of candidate rows
+ *
+ * Gets placement validity of the current definition and rotation for
+ * every origin in the given rectangle, as from
+ * lrg_build_grid_get_placement_mask(). If a resource check is set and
+ * fails, every byte is 0.
+ *
+ * Returns: (transfer full) (nullable): The mask, or %NULL if not placing
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+GBytes *
+lrg_placement_system_get_placement_mask (LrgPlacementSystem *self,
+                                         gint                x,
+                                         gint                y,
+                                         gint                width,
+                                         gint                height);
+
 /* Confirmation */
 
 /**
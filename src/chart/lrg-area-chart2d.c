@@ -370,6 +370,13 @@ lrg_area_chart2d_hit_test (LrgChart        *chart,
     gfloat best_sx = 0, best_sy = 0;
     gfloat hit_radius_sq = self->hit_radius * self->hit_radius;
 
+    /* Unstacked areas sit on the raw values, so the series index applies */
+    if (self->mode == LRG_CHART_AREA_NORMAL)
+    {
+        return lrg_chart2d_hit_test_points (chart2d, x, y,
+                                            self->hit_radius, out_hit);
+    }
+
     if (out_hit != NULL)
         lrg_chart_hit_info_clear (out_hit);
 
@@ -8,6 +8,9 @@
 #include "config.h"
 #include "lrg-chart-data-series.h"
 
+#include <math.h>
+#include <string.h>
+
 /* ==========================================================================
  * Default Colors
  * ========================================================================== */
@@ -32,8 +35,52 @@ struct _LrgChartDataSeries
     gboolean          show_in_legend;
 
     GPtrArray        *points;  /* Array of LrgChartDataPoint* */
+
+    /* Columnar storage, see lrg_chart_data_series_new_columnar() */
+    gboolean          columnar;
+    gboolean          ring;         /* fixed capacity, oldest point dropped */
+    gdouble          *xs;
+    gdouble          *ys;
+    guint             col_capacity;
+    guint             col_head;     /* slot holding logical index 0 */
+    guint             col_count;
+    LrgChartDataPoint *scratch;     /* returned by get_point() when columnar */
+
+    /* Bumped on every change to point values */
+    guint64           generation;
+
+    /* Cached data ranges, maintained incrementally on append */
+    gboolean          range_valid;
+    gdouble           x_min;
+    gdouble           x_max;
+    gdouble           y_min;
+    gdouble           y_max;
+    gboolean          x_sorted;
+
+    GPtrArray        *levels;       /* DecimationLevel*, most recent first */
+
+    /* Nearest-point index, built on first query after a data change */
+    guint            *kd_order;     /* point indices in implicit KD-tree order */
+    guint             kd_len;
+    guint64           kd_generation;
 };
 
+/*
+ * One cached decimation of the index window [start, end) down to about
+ * @target points. Valid while @generation matches the series.
+ */
+typedef struct
+{
+    LrgChartDecimation mode;
+    guint              start;
+    guint              end;
+    guint              target;
+    guint64            generation;
+    GArray            *indices;  /* guint */
+} DecimationLevel;
+
+#define MAX_DECIMATION_LEVELS 4
+
 G_DEFINE_TYPE (LrgChartDataSeries, lrg_chart_data_series, G_TYPE_OBJECT)
 
 /* ==========================================================================
@@ -81,6 +128,241 @@ lrg_chart_data_series_emit_changed (LrgChartDataSeries *self)
     g_signal_emit (self, signals[SIGNAL_CHANGED], 0);
 }
 
+static void
+decimation_level_free (gpointer data)
+{
+    DecimationLevel *level = data;
+
+    g_array_unref (level->indices);
+    g_free (level);
+}
+
+static inline guint
+series_len (LrgChartDataSeries *self)
+{
+    return self->columnar ? self->col_count : self->points->len;
+}
+
+static inline guint
+col_slot (LrgChartDataSeries *self,
+          guint               index)
+{
+    guint slot = self->col_head + index;
+
+    return slot >= self->col_capacity ? slot - self->col_capacity : slot;
+}
+
+static inline gdouble
+series_x (LrgChartDataSeries *self,
+          guint               index)
+{
+    if (self->columnar)
+        return self->xs[col_slot (self, index)];
+
+    return lrg_chart_data_point_get_x (g_ptr_array_index (self->points, index));
+}
+
+static inline gdouble
+series_y (LrgChartDataSeries *self,
+          guint               index)
+{
+    if (self->columnar)
+        return self->ys[col_slot (self, index)];
+
+    return lrg_chart_data_point_get_y (g_ptr_array_index (self->points, index));
+}
+
+/*
+ * Arbitrary edits: drop the cached ranges and decimations. Appends go
+ * through series_note_append() instead, which keeps the ranges.
+ */
+static void
+series_invalidate (LrgChartDataSeries *self)
+{
+    self->generation++;
+    self->range_valid = FALSE;
+}
+
+static void
+series_note_append (LrgChartDataSeries *self,
+                    gdouble             x,
+                    gdouble             y)
+{
+    guint len = series_len (self);
+
+    self->generation++;
+    if (!self->range_valid)
+        return;
+
+    if (len > 1 && x < series_x (self, len - 2))
+        self->x_sorted = FALSE;
+
+    if (len == 1)
+    {
+        self->x_min = self->x_max = x;
+        self->y_min = self->y_max = y;
+        self->x_sorted = TRUE;
+        return;
+    }
+
+    if (x < self->x_min) self->x_min = x;
+    if (x > self->x_max) self->x_max = x;
+    if (y < self->y_min) self->y_min = y;
+    if (y > self->y_max) self->y_max = y;
+}
+
+static void
+series_ensure_ranges (LrgChartDataSeries *self)
+{
+    guint len = series_len (self);
+    gdouble prev_x = -G_MAXDOUBLE;
+    guint i;
+
+    if (self->range_valid)
+        return;
+
+    self->x_min = self->y_min = G_MAXDOUBLE;
+    self->x_max = self->y_max = -G_MAXDOUBLE;
+    self->x_sorted = TRUE;
+
+    for (i = 0; i < len; i++)
+    {
+        gdouble x = series_x (self, i);
+        gdouble y = series_y (self, i);
+
+        if (x < prev_x) self->x_sorted = FALSE;
+        if (x < self->x_min) self->x_min = x;
+        if (x > self->x_max) self->x_max = x;
+        if (y < self->y_min) self->y_min = y;
+        if (y > self->y_max) self->y_max = y;
+        prev_x = x;
+    }
+
+    self->range_valid = TRUE;
+}
+
+/* Moves the ring contents so logical index 0 sits in slot 0. */
+static void
+col_linearize (LrgChartDataSeries *self)
+{
+    gdouble *xs;
+    gdouble *ys;
+    guint first;
+
+    if (self->col_head == 0)
+        return;
+
+    first = MIN (self->col_count, self->col_capacity - self->col_head);
+    xs = g_new (gdouble, self->col_capacity);
+    ys = g_new (gdouble, self->col_capacity);
+
+    memcpy (xs, self->xs + self->col_head, first * sizeof (gdouble));
+    memcpy (ys, self->ys + self->col_head, first * sizeof (gdouble));
+    memcpy (xs + first, self->xs, (self->col_count - first) * sizeof (gdouble));
+    memcpy (ys + first, self->ys, (self->col_count - first) * sizeof (gdouble));
+
+    g_free (self->xs);
+    g_free (self->ys);
+    self->xs = xs;
+    self->ys = ys;
+    self->col_head = 0;
+}
+
+static void
+col_reserve (LrgChartDataSeries *self,
+             guint               needed)
+{
+    guint capacity;
+
+    if (needed <= self->col_capacity)
+        return;
+
+    col_linearize (self);
+
+    capacity = MAX (self->col_capacity, 64);
+    while (capacity < needed)
+        capacity *= 2;
+
+    self->xs = g_renew (gdouble, self->xs, capacity);
+    self->ys = g_renew (gdouble, self->ys, capacity);
+    self->col_capacity = capacity;
+}
+
+/*
+ * col_push:
+ *
+ * Appends one value pair. Returns %TRUE if a full ring dropped its
+ * oldest point to make room.
+ */
+static gboolean
+col_push (LrgChartDataSeries *self,
+          gdouble             x,
+          gdouble             y)
+{
+    gboolean dropped = FALSE;
+    guint slot;
+
+    if (self->ring && self->col_count == self->col_capacity)
+    {
+        gdouble old_x = self->xs[self->col_head];
+        gdouble old_y = self->ys[self->col_head];
+
+        /* The dropped point may have defined a range bound. */
+        if (old_x <= self->x_min || old_x >= self->x_max ||
+            old_y <= self->y_min || old_y >= self->y_max)
+            self->range_valid = FALSE;
+
+        self->col_head = col_slot (self, 1);
+        self->col_count--;
+        dropped = TRUE;
+    }
+    else if (!self->ring)
+    {
+        col_reserve (self, self->col_count + 1);
+    }
+
+    slot = col_slot (self, self->col_count);
+    self->xs[slot] = x;
+    self->ys[slot] = y;
+    self->col_count++;
+
+    return dropped;
+}
+
+/* Common tail of the single-point add functions. */
+static guint
+series_append (LrgChartDataSeries *self,
+               gdouble             x,
+               gdouble             y,
+               LrgChartDataPoint  *point)
+{
+    guint index;
+
+    if (self->columnar)
+    {
+        if (col_push (self, x, y))
+            g_signal_emit (self, signals[SIGNAL_POINT_REMOVED], 0, 0u);
+        /* Columnar storage keeps values only. */
+        if (point != NULL)
+            lrg_chart_data_point_free (point);
+    }
+    else
+    {
+        g_ptr_array_add (self->points, point != NULL
+                                       ? point
+                                       : lrg_chart_data_point_new (x, y));
+    }
+
+    index = series_len (self) - 1;
+    series_note_append (self, x, y);
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
+    g_signal_emit (self, signals[SIGNAL_POINT_ADDED], 0, index);
+    lrg_chart_data_series_emit_changed (self);
+
+    return index;
+}
+
 /* ==========================================================================
  * GObject Implementation
  * ========================================================================== */
@@ -92,6 +374,11 @@ lrg_chart_data_series_finalize (GObject *object)
 
     g_free (self->name);
     g_ptr_array_unref (self->points);
+    g_free (self->xs);
+    g_free (self->ys);
+    g_clear_pointer (&self->scratch, lrg_chart_data_point_free);
+    g_ptr_array_unref (self->levels);
+    g_free (self->kd_order);
 
     G_OBJECT_CLASS (lrg_chart_data_series_parent_class)->finalize (object);
 }
@@ -131,7 +418,7 @@ lrg_chart_data_series_get_property (GObject    *object,
         g_value_set_boolean (value, self->show_in_legend);
         break;
     case PROP_POINT_COUNT:
-        g_value_set_uint (value, self->points->len);
+        g_value_set_uint (value, series_len (self));
         break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -311,6 +598,15 @@ lrg_chart_data_series_init (LrgChartDataSeries *self)
 
     /* Create array with free function for owned data points */
     self->points = g_ptr_array_new_with_free_func ((GDestroyNotify)lrg_chart_data_point_free);
+
+    self->columnar = FALSE;
+    self->ring = FALSE;
+    self->generation = 0;
+    self->range_valid = FALSE;
+    self->levels = g_ptr_array_new_with_free_func (decimation_level_free);
+    self->kd_order = NULL;
+    self->kd_len = 0;
+    self->kd_generation = G_MAXUINT64;
 }
 
 /* ==========================================================================
@@ -344,6 +640,41 @@ lrg_chart_data_series_new_with_color (const gchar    *name,
     return self;
 }
 
+LrgChartDataSeries *
+lrg_chart_data_series_new_columnar (const gchar *name,
+                                     guint        capacity)
+{
+    LrgChartDataSeries *self;
+
+    self = lrg_chart_data_series_new (name);
+    self->columnar = TRUE;
+    self->ring = capacity > 0;
+    self->scratch = lrg_chart_data_point_new (0.0, 0.0);
+
+    if (self->ring)
+    {
+        self->xs = g_new (gdouble, capacity);
+        self->ys = g_new (gdouble, capacity);
+        self->col_capacity = capacity;
+    }
+
+    return self;
+}
+
+gboolean
+lrg_chart_data_series_is_columnar (LrgChartDataSeries *self)
+{
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), FALSE);
+    return self->columnar;
+}
+
+guint
+lrg_chart_data_series_get_capacity (LrgChartDataSeries *self)
+{
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
+    return self->ring ? self->col_capacity : 0;
+}
+
 /* ==========================================================================
  * Name
  * ========================================================================== */
@@ -549,7 +880,7 @@ guint
 lrg_chart_data_series_get_point_count (LrgChartDataSeries *self)
 {
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
-    return self->points->len;
+    return series_len (self);
 }
 
 const LrgChartDataPoint *
@@ -557,31 +888,46 @@ lrg_chart_data_series_get_point (LrgChartDataSeries *self,
                                   guint               index)
 {
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), NULL);
-    g_return_val_if_fail (index < self->points->len, NULL);
+    g_return_val_if_fail (index < series_len (self), NULL);
+
+    if (self->columnar)
+    {
+        lrg_chart_data_point_set_x (self->scratch, series_x (self, index));
+        lrg_chart_data_point_set_y (self->scratch, series_y (self, index));
+        return self->scratch;
+    }
 
     return g_ptr_array_index (self->points, index);
 }
 
+gdouble
+lrg_chart_data_series_get_x (LrgChartDataSeries *self,
+                              guint               index)
+{
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0.0);
+    g_return_val_if_fail (index < series_len (self), 0.0);
+
+    return series_x (self, index);
+}
+
+gdouble
+lrg_chart_data_series_get_y (LrgChartDataSeries *self,
+                              guint               index)
+{
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0.0);
+    g_return_val_if_fail (index < series_len (self), 0.0);
+
+    return series_y (self, index);
+}
+
 guint
 lrg_chart_data_series_add_point (LrgChartDataSeries *self,
                                   gdouble             x,
                                   gdouble             y)
 {
-    LrgChartDataPoint *point;
-    guint index;
-
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
 
-    point = lrg_chart_data_point_new (x, y);
-    g_ptr_array_add (self->points, point);
-
-    index = self->points->len - 1;
-
-    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
-    g_signal_emit (self, signals[SIGNAL_POINT_ADDED], 0, index);
-    lrg_chart_data_series_emit_changed (self);
-
-    return index;
+    return series_append (self, x, y, NULL);
 }
 
 guint
@@ -590,42 +936,68 @@ lrg_chart_data_series_add_point_labeled (LrgChartDataSeries *self,
                                           gdouble             y,
                                           const gchar        *label)
 {
-    LrgChartDataPoint *point;
-    guint index;
-
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
 
-    point = lrg_chart_data_point_new_labeled (x, y, label);
-    g_ptr_array_add (self->points, point);
+    if (self->columnar)
+        return series_append (self, x, y, NULL);
 
-    index = self->points->len - 1;
-
-    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
-    g_signal_emit (self, signals[SIGNAL_POINT_ADDED], 0, index);
-    lrg_chart_data_series_emit_changed (self);
-
-    return index;
+    return series_append (self, x, y, lrg_chart_data_point_new_labeled (x, y, label));
 }
 
 guint
 lrg_chart_data_series_add_point_full (LrgChartDataSeries *self,
                                        LrgChartDataPoint  *point)
 {
-    guint index;
-
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
     g_return_val_if_fail (point != NULL, 0);
 
     /* Takes ownership of point */
-    g_ptr_array_add (self->points, point);
+    return series_append (self,
+                          lrg_chart_data_point_get_x (point),
+                          lrg_chart_data_point_get_y (point),
+                          point);
+}
+
+void
+lrg_chart_data_series_append_values (LrgChartDataSeries *self,
+                                      const gdouble      *x,
+                                      const gdouble      *y,
+                                      guint               n_values)
+{
+    gboolean dropped = FALSE;
+    guint i;
 
-    index = self->points->len - 1;
+    g_return_if_fail (LRG_IS_CHART_DATA_SERIES (self));
+    g_return_if_fail (n_values == 0 || (x != NULL && y != NULL));
+
+    if (n_values == 0)
+        return;
+
+    /* Only the newest capacity values can survive in a ring. */
+    if (self->ring && n_values > self->col_capacity)
+    {
+        x += n_values - self->col_capacity;
+        y += n_values - self->col_capacity;
+        n_values = self->col_capacity;
+    }
+
+    if (self->columnar && !self->ring)
+        col_reserve (self, self->col_count + n_values);
+
+    for (i = 0; i < n_values; i++)
+    {
+        if (self->columnar)
+            dropped |= col_push (self, x[i], y[i]);
+        else
+            g_ptr_array_add (self->points, lrg_chart_data_point_new (x[i], y[i]));
+
+        series_note_append (self, x[i], y[i]);
+    }
 
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
-    g_signal_emit (self, signals[SIGNAL_POINT_ADDED], 0, index);
+    if (dropped)
+        g_signal_emit (self, signals[SIGNAL_POINT_REMOVED], 0, 0u);
     lrg_chart_data_series_emit_changed (self);
-
-    return index;
 }
 
 void
@@ -634,13 +1006,39 @@ lrg_chart_data_series_insert_point (LrgChartDataSeries *self,
                                      gdouble             x,
                                      gdouble             y)
 {
-    LrgChartDataPoint *point;
-
     g_return_if_fail (LRG_IS_CHART_DATA_SERIES (self));
-    g_return_if_fail (index <= self->points->len);
+    g_return_if_fail (index <= series_len (self));
+
+    if (self->columnar)
+    {
+        guint tail;
+
+        /* A full ring drops its oldest point first. */
+        if (self->ring && self->col_count == self->col_capacity)
+        {
+            self->col_head = col_slot (self, 1);
+            self->col_count--;
+            if (index > 0)
+                index--;
+            g_signal_emit (self, signals[SIGNAL_POINT_REMOVED], 0, 0u);
+        }
+
+        col_reserve (self, self->col_count + 1);
+        col_linearize (self);
+
+        tail = self->col_count - index;
+        memmove (self->xs + index + 1, self->xs + index, tail * sizeof (gdouble));
+        memmove (self->ys + index + 1, self->ys + index, tail * sizeof (gdouble));
+        self->xs[index] = x;
+        self->ys[index] = y;
+        self->col_count++;
+    }
+    else
+    {
+        g_ptr_array_insert (self->points, index, lrg_chart_data_point_new (x, y));
+    }
 
-    point = lrg_chart_data_point_new (x, y);
-    g_ptr_array_insert (self->points, index, point);
+    series_invalidate (self);
 
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
     g_signal_emit (self, signals[SIGNAL_POINT_ADDED], 0, index);
@@ -653,10 +1051,26 @@ lrg_chart_data_series_remove_point (LrgChartDataSeries *self,
 {
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), FALSE);
 
-    if (index >= self->points->len)
+    if (index >= series_len (self))
         return FALSE;
 
-    g_ptr_array_remove_index (self->points, index);
+    if (self->columnar)
+    {
+        guint tail;
+
+        col_linearize (self);
+
+        tail = self->col_count - index - 1;
+        memmove (self->xs + index, self->xs + index + 1, tail * sizeof (gdouble));
+        memmove (self->ys + index, self->ys + index + 1, tail * sizeof (gdouble));
+        self->col_count--;
+    }
+    else
+    {
+        g_ptr_array_remove_index (self->points, index);
+    }
+
+    series_invalidate (self);
 
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
     g_signal_emit (self, signals[SIGNAL_POINT_REMOVED], 0, index);
@@ -668,15 +1082,22 @@ lrg_chart_data_series_remove_point (LrgChartDataSeries *self,
 void
 lrg_chart_data_series_clear (LrgChartDataSeries *self)
 {
-    guint old_len;
-
     g_return_if_fail (LRG_IS_CHART_DATA_SERIES (self));
 
-    old_len = self->points->len;
-    if (old_len == 0)
+    if (series_len (self) == 0)
         return;
 
-    g_ptr_array_set_size (self->points, 0);
+    if (self->columnar)
+    {
+        self->col_head = 0;
+        self->col_count = 0;
+    }
+    else
+    {
+        g_ptr_array_set_size (self->points, 0);
+    }
+
+    series_invalidate (self);
 
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POINT_COUNT]);
     lrg_chart_data_series_emit_changed (self);
@@ -688,18 +1109,36 @@ lrg_chart_data_series_set_point_value (LrgChartDataSeries *self,
                                         gdouble             x,
                                         gdouble             y)
 {
-    LrgChartDataPoint *point;
-
     g_return_if_fail (LRG_IS_CHART_DATA_SERIES (self));
-    g_return_if_fail (index < self->points->len);
+    g_return_if_fail (index < series_len (self));
+
+    if (self->columnar)
+    {
+        guint slot = col_slot (self, index);
 
-    point = g_ptr_array_index (self->points, index);
-    lrg_chart_data_point_set_x (point, x);
-    lrg_chart_data_point_set_y (point, y);
+        self->xs[slot] = x;
+        self->ys[slot] = y;
+    }
+    else
+    {
+        LrgChartDataPoint *point = g_ptr_array_index (self->points, index);
+
+        lrg_chart_data_point_set_x (point, x);
+        lrg_chart_data_point_set_y (point, y);
+    }
+
+    series_invalidate (self);
 
     lrg_chart_data_series_emit_changed (self);
 }
 
+guint64
+lrg_chart_data_series_get_generation (LrgChartDataSeries *self)
+{
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
+    return self->generation;
+}
+
 /* ==========================================================================
  * Data Range
  * ========================================================================== */
@@ -709,30 +1148,19 @@ lrg_chart_data_series_get_x_range (LrgChartDataSeries *self,
                                     gdouble            *min,
                                     gdouble            *max)
 {
-    gdouble x_min = G_MAXDOUBLE;
-    gdouble x_max = -G_MAXDOUBLE;
-    guint i;
-
     g_return_if_fail (LRG_IS_CHART_DATA_SERIES (self));
 
-    if (self->points->len == 0)
+    if (series_len (self) == 0)
     {
         if (min != NULL) *min = 0.0;
         if (max != NULL) *max = 0.0;
         return;
     }
 
-    for (i = 0; i < self->points->len; i++)
-    {
-        const LrgChartDataPoint *point = g_ptr_array_index (self->points, i);
-        gdouble x = lrg_chart_data_point_get_x (point);
+    series_ensure_ranges (self);
 
-        if (x < x_min) x_min = x;
-        if (x > x_max) x_max = x;
-    }
-
-    if (min != NULL) *min = x_min;
-    if (max != NULL) *max = x_max;
+    if (min != NULL) *min = self->x_min;
+    if (max != NULL) *max = self->x_max;
 }
 
 void
@@ -740,45 +1168,470 @@ lrg_chart_data_series_get_y_range (LrgChartDataSeries *self,
                                     gdouble            *min,
                                     gdouble            *max)
 {
-    gdouble y_min = G_MAXDOUBLE;
-    gdouble y_max = -G_MAXDOUBLE;
-    guint i;
-
     g_return_if_fail (LRG_IS_CHART_DATA_SERIES (self));
 
-    if (self->points->len == 0)
+    if (series_len (self) == 0)
     {
         if (min != NULL) *min = 0.0;
         if (max != NULL) *max = 0.0;
         return;
     }
 
-    for (i = 0; i < self->points->len; i++)
-    {
-        const LrgChartDataPoint *point = g_ptr_array_index (self->points, i);
-        gdouble y = lrg_chart_data_point_get_y (point);
+    series_ensure_ranges (self);
 
-        if (y < y_min) y_min = y;
-        if (y > y_max) y_max = y;
-    }
-
-    if (min != NULL) *min = y_min;
-    if (max != NULL) *max = y_max;
+    if (min != NULL) *min = self->y_min;
+    if (max != NULL) *max = self->y_max;
 }
 
 gdouble
 lrg_chart_data_series_get_y_sum (LrgChartDataSeries *self)
 {
     gdouble sum = 0.0;
+    guint len;
     guint i;
 
     g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0.0);
 
-    for (i = 0; i < self->points->len; i++)
+    len = series_len (self);
+    for (i = 0; i < len; i++)
+        sum += series_y (self, i);
+
+    return sum;
+}
+
+gboolean
+lrg_chart_data_series_get_x_sorted (LrgChartDataSeries *self)
+{
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), FALSE);
+
+    series_ensure_ranges (self);
+
+    return self->x_sorted;
+}
+
+guint
+lrg_chart_data_series_find_x (LrgChartDataSeries *self,
+                               gdouble             x)
+{
+    guint lo = 0;
+    guint hi;
+
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), 0);
+
+    hi = series_len (self);
+    while (lo < hi)
     {
-        const LrgChartDataPoint *point = g_ptr_array_index (self->points, i);
-        sum += lrg_chart_data_point_get_y (point);
+        guint mid = lo + (hi - lo) / 2;
+
+        if (series_x (self, mid) < x)
+            lo = mid + 1;
+        else
+            hi = mid;
     }
 
-    return sum;
+    return lo;
+}
+
+/* ==========================================================================
+ * Decimation
+ * ========================================================================== */
+
+/*
+ * decimate_min_max:
+ *
+ * Splits [start, end) into target / 2 buckets and keeps each bucket's
+ * lowest and highest point in index order, plus both endpoints, so
+ * every spike survives.
+ */
+static void
+decimate_min_max (LrgChartDataSeries *self,
+                  guint               start,
+                  guint               end,
+                  guint               target,
+                  GArray             *out)
+{
+    guint n = end - start;
+    guint buckets = MAX (target / 2, 1);
+    guint last = end - 1;
+    guint b;
+
+    g_array_append_val (out, start);
+
+    for (b = 0; b < buckets; b++)
+    {
+        guint b0 = start + (guint) (((guint64) n * b) / buckets);
+        guint b1 = start + (guint) (((guint64) n * (b + 1)) / buckets);
+        guint imin;
+        guint imax;
+        gdouble vmin;
+        gdouble vmax;
+        guint i;
+
+        if (b1 <= b0)
+            continue;
+
+        imin = imax = b0;
+        vmin = vmax = series_y (self, b0);
+        for (i = b0 + 1; i < b1; i++)
+        {
+            gdouble v = series_y (self, i);
+
+            if (v < vmin) { vmin = v; imin = i; }
+            if (v > vmax) { vmax = v; imax = i; }
+        }
+
+        if (imin > imax)
+        {
+            guint t = imin;
+            imin = imax;
+            imax = t;
+        }
+
+        if (imin != start && imin != last)
+            g_array_append_val (out, imin);
+        if (imax != imin && imax != start && imax != last)
+            g_array_append_val (out, imax);
+    }
+
+    g_array_append_val (out, last);
+}
+
+/*
+ * decimate_lttb:
+ *
+ * Largest-Triangle-Three-Buckets (Steinarsson 2013): keeps the endpoints
+ * and, per bucket, the point forming the largest triangle with the
+ * previously kept point and the average of the next bucket.
+ */
+static void
+decimate_lttb (LrgChartDataSeries *self,
+               guint               start,
+               guint               end,
+               guint               target,
+               GArray             *out)
+{
+    guint n = end - start;
+    gdouble every = (gdouble) (n - 2) / (gdouble) (target - 2);
+    guint a = start;
+    guint b;
+
+    g_array_append_val (out, a);
+
+    for (b = 0; b < target - 2; b++)
+    {
+        guint r0 = start + (guint) floor (b * every) + 1;
+        guint r1 = start + (guint) floor ((b + 1) * every) + 1;
+        guint n0 = r1;
+        guint n1 = MIN (start + (guint) floor ((b + 2) * every) + 1, end);
+        gdouble avg_x = 0.0;
+        gdouble avg_y = 0.0;
+        gdouble ax;
+        gdouble ay;
+        gdouble best_area = -1.0;
+        guint best = r0;
+        guint i;
+
+        if (n0 >= n1)
+        {
+            n0 = end - 1;
+            n1 = end;
+        }
+
+        for (i = n0; i < n1; i++)
+        {
+            avg_x += series_x (self, i);
+            avg_y += series_y (self, i);
+        }
+        avg_x /= (gdouble) (n1 - n0);
+        avg_y /= (gdouble) (n1 - n0);
+
+        ax = series_x (self, a);
+        ay = series_y (self, a);
+
+        for (i = r0; i < r1 && i < end - 1; i++)
+        {
+            gdouble area = fabs ((ax - avg_x) * (series_y (self, i) - ay) -
+                                 (ax - series_x (self, i)) * (avg_y - ay));
+
+            if (area > best_area)
+            {
+                best_area = area;
+                best = i;
+            }
+        }
+
+        g_array_append_val (out, best);
+        a = best;
+    }
+
+    b = end - 1;
+    g_array_append_val (out, b);
+}
+
+const guint *
+lrg_chart_data_series_get_decimated (LrgChartDataSeries *self,
+                                      LrgChartDecimation  mode,
+                                      guint               start,
+                                      guint               end,
+                                      guint               target,
+                                      guint              *n_indices)
+{
+    DecimationLevel *level;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), NULL);
+    g_return_val_if_fail (n_indices != NULL, NULL);
+
+    end = MIN (end, series_len (self));
+    start = MIN (start, end);
+    *n_indices = end - start;
+
+    if (mode == LRG_CHART_DECIMATION_NONE || target < 3 || end - start <= target)
+        return NULL;
+
+    for (i = 0; i < self->levels->len; i++)
+    {
+        level = g_ptr_array_index (self->levels, i);
+
+        if (level->generation != self->generation)
+        {
+            /* Levels are all stale once the data moves on. */
+            g_ptr_array_set_size (self->levels, 0);
+            break;
+        }
+
+        if (level->mode == mode && level->start == start &&
+            level->end == end && level->target == target)
+        {
+            if (i > 0)
+            {
+                g_ptr_array_steal_index (self->levels, i);
+                g_ptr_array_insert (self->levels, 0, level);
+            }
+            *n_indices = level->indices->len;
+            return (const guint *) level->indices->data;
+        }
+    }
+
+    if (self->levels->len >= MAX_DECIMATION_LEVELS)
+        g_ptr_array_remove_index (self->levels, self->levels->len - 1);
+
+    level = g_new0 (DecimationLevel, 1);
+    level->mode = mode;
+    level->start = start;
+    level->end = end;
+    level->target = target;
+    level->generation = self->generation;
+    level->indices = g_array_sized_new (FALSE, FALSE, sizeof (guint), target + 2);
+
+    if (mode == LRG_CHART_DECIMATION_MIN_MAX)
+        decimate_min_max (self, start, end, target, level->indices);
+    else
+        decimate_lttb (self, start, end, target, level->indices);
+
+    g_ptr_array_insert (self->levels, 0, level);
+
+    *n_indices = level->indices->len;
+    return (const guint *) level->indices->data;
+}
+
+/* ==========================================================================
+ * Nearest-Point Queries
+ * ========================================================================== */
+
+/*
+ * The index is an implicit 2-d tree over a permutation of point indices:
+ * for a range [lo, hi) the median element at (lo + hi) / 2 splits on X at
+ * even depths and Y at odd depths, with the halves on either side.
+ */
+
+static inline gdouble
+kd_coord (LrgChartDataSeries *self,
+          guint               index,
+          guint               axis)
+{
+    return axis == 0 ? series_x (self, index) : series_y (self, index);
+}
+
+/* Quickselect: places the k-th smallest (by @axis) of [lo, hi) at k. */
+static void
+kd_select (LrgChartDataSeries *self,
+           guint              *order,
+           guint               lo,
+           guint               hi,
+           guint               k,
+           guint               axis)
+{
+    while (hi - lo > 1)
+    {
+        gdouble pivot = kd_coord (self, order[lo + (hi - lo) / 2], axis);
+        guint i = lo;
+        guint j = hi - 1;
+
+        while (i <= j)
+        {
+            guint t;
+
+            while (kd_coord (self, order[i], axis) < pivot)
+                i++;
+            while (kd_coord (self, order[j], axis) > pivot)
+                j--;
+            if (i > j)
+                break;
+
+            t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+            i++;
+            if (j == 0)
+                break;
+            j--;
+        }
+
+        if (k <= j)
+            hi = j + 1;
+        else if (k >= i)
+            lo = i;
+        else
+            return;
+    }
+}
+
+static void
+kd_build (LrgChartDataSeries *self,
+          guint              *order,
+          guint               lo,
+          guint               hi,
+          guint               depth)
+{
+    guint mid;
+
+    while (hi - lo > 1)
+    {
+        mid = lo + (hi - lo) / 2;
+        kd_select (self, order, lo, hi, mid, depth & 1);
+        kd_build (self, order, lo, mid, depth + 1);
+
+        /* Loop on the right half instead of recursing. */
+        lo = mid + 1;
+        depth++;
+    }
+}
+
+static void
+series_ensure_kd (LrgChartDataSeries *self)
+{
+    guint len = series_len (self);
+    guint i;
+
+    if (self->kd_generation == self->generation && self->kd_len == len)
+        return;
+
+    if (self->kd_len != len)
+        self->kd_order = g_renew (guint, self->kd_order, MAX (len, 1));
+
+    for (i = 0; i < len; i++)
+        self->kd_order[i] = i;
+
+    kd_build (self, self->kd_order, 0, len, 0);
+
+    self->kd_len = len;
+    self->kd_generation = self->generation;
+}
+
+typedef struct
+{
+    gdouble x;
+    gdouble y;
+    gdouble x_scale;
+    gdouble y_scale;
+    gdouble best_sq;
+    gint    best;
+} KdQuery;
+
+static void
+kd_nearest (LrgChartDataSeries *self,
+            KdQuery            *q,
+            guint               lo,
+            guint               hi,
+            guint               depth)
+{
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        guint index = self->kd_order[mid];
+        gdouble dx = (series_x (self, index) - q->x) * q->x_scale;
+        gdouble dy = (series_y (self, index) - q->y) * q->y_scale;
+        gdouble d_sq = dx * dx + dy * dy;
+        gdouble split = (depth & 1) == 0 ? -dx : -dy;
+
+        if (d_sq < q->best_sq || (d_sq == q->best_sq && q->best >= 0 && (gint) index < q->best))
+        {
+            q->best_sq = d_sq;
+            q->best = (gint) index;
+        }
+
+        /* Search the query's side first, the other only if it can win. */
+        if (split < 0.0)
+        {
+            kd_nearest (self, q, lo, mid, depth + 1);
+            if (split * split <= q->best_sq)
+            {
+                lo = mid + 1;
+                depth++;
+                continue;
+            }
+        }
+        else
+        {
+            kd_nearest (self, q, mid + 1, hi, depth + 1);
+            if (split * split <= q->best_sq)
+            {
+                hi = mid;
+                depth++;
+                continue;
+            }
+        }
+
+        return;
+    }
+}
+
+gboolean
+lrg_chart_data_series_find_nearest (LrgChartDataSeries *self,
+                                     gdouble             x,
+                                     gdouble             y,
+                                     gdouble             x_scale,
+                                     gdouble             y_scale,
+                                     gdouble             max_distance,
+                                     guint              *out_index,
+                                     gdouble            *out_distance)
+{
+    KdQuery q;
+
+    g_return_val_if_fail (LRG_IS_CHART_DATA_SERIES (self), FALSE);
+
+    if (series_len (self) == 0)
+        return FALSE;
+
+    series_ensure_kd (self);
+
+    q.x = x;
+    q.y = y;
+    q.x_scale = fabs (x_scale);
+    q.y_scale = fabs (y_scale);
+    q.best_sq = max_distance * max_distance;
+    q.best = -1;
+
+    kd_nearest (self, &q, 0, self->kd_len, 0);
+
+    if (q.best < 0)
+        return FALSE;
+
+    if (out_index != NULL)
+        *out_index = (guint) q.best;
+    if (out_distance != NULL)
+        *out_distance = sqrt (q.best_sq);
+
+    return TRUE;
 }
@@ -8,6 +8,10 @@
  *
  * A data series represents a collection of data points with
  * associated styling (color, line style, marker) and metadata.
+ *
+ * Columnar series (lrg_chart_data_series_new_columnar()) store plain
+ * X and Y value arrays instead of one allocated point per value, and
+ * can be capped as a ring buffer for streaming data.
  */
 
 #pragma once
@@ -63,6 +67,56 @@ LrgChartDataSeries *
 lrg_chart_data_series_new_with_color (const gchar    *name,
                                        const GrlColor *color);
 
+/**
+ * lrg_chart_data_series_new_columnar:
+ * @name: (nullable): series name for legend
+ * @capacity: ring buffer capacity, or 0 for unbounded
+ *
+ * Creates a new empty series backed by contiguous X and Y value arrays
+ * rather than one #LrgChartDataPoint per value. Use it for large or
+ * streaming data; labels, per-point colors and Z values are not kept.
+ *
+ * With a non-zero @capacity the series is a fixed-size ring buffer:
+ * once full, each append drops the oldest point (emitting
+ * #LrgChartDataSeries::point-removed for index 0) without reallocating.
+ *
+ * Returns: (transfer full): a new #LrgChartDataSeries
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgChartDataSeries *
+lrg_chart_data_series_new_columnar (const gchar *name,
+                                     guint        capacity);
+
+/**
+ * lrg_chart_data_series_is_columnar:
+ * @self: an #LrgChartDataSeries
+ *
+ * Checks whether the series uses columnar storage.
+ *
+ * Returns: %TRUE if created with lrg_chart_data_series_new_columnar()
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_chart_data_series_is_columnar (LrgChartDataSeries *self);
+
+/**
+ * lrg_chart_data_series_get_capacity:
+ * @self: an #LrgChartDataSeries
+ *
+ * Gets the ring buffer capacity of a columnar series.
+ *
+ * Returns: the capacity, or 0 if the series is unbounded
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_chart_data_series_get_capacity (LrgChartDataSeries *self);
+
 /* ==========================================================================
  * Name
  * ========================================================================== */
@@ -324,6 +378,10 @@ lrg_chart_data_series_get_point_count (LrgChartDataSeries *self);
  *
  * Gets a data point by index.
  *
+ * For a columnar series the point is a view owned by the series that
+ * is overwritten by the next call; prefer lrg_chart_data_series_get_x()
+ * and lrg_chart_data_series_get_y() when only the values are needed.
+ *
  * Returns: (transfer none) (nullable): the data point
  *
  * Since: 1.0
@@ -333,6 +391,38 @@ const LrgChartDataPoint *
 lrg_chart_data_series_get_point (LrgChartDataSeries *self,
                                   guint               index);
 
+/**
+ * lrg_chart_data_series_get_x:
+ * @self: an #LrgChartDataSeries
+ * @index: point index
+ *
+ * Gets the X value of a point without going through #LrgChartDataPoint.
+ *
+ * Returns: the X value
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_chart_data_series_get_x (LrgChartDataSeries *self,
+                              guint               index);
+
+/**
+ * lrg_chart_data_series_get_y:
+ * @self: an #LrgChartDataSeries
+ * @index: point index
+ *
+ * Gets the Y value of a point without going through #LrgChartDataPoint.
+ *
+ * Returns: the Y value
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_chart_data_series_get_y (LrgChartDataSeries *self,
+                              guint               index);
+
 /**
  * lrg_chart_data_series_add_point:
  * @self: an #LrgChartDataSeries
@@ -387,6 +477,26 @@ guint
 lrg_chart_data_series_add_point_full (LrgChartDataSeries *self,
                                        LrgChartDataPoint  *point);
 
+/**
+ * lrg_chart_data_series_append_values:
+ * @self: an #LrgChartDataSeries
+ * @x: (array length=n_values): X values
+ * @y: (array length=n_values): Y values
+ * @n_values: number of values
+ *
+ * Appends many points at once. Emits #LrgChartDataSeries::changed once
+ * instead of #LrgChartDataSeries::point-added per point, which makes it
+ * the preferred way to stream samples into a columnar series.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_chart_data_series_append_values (LrgChartDataSeries *self,
+                                      const gdouble      *x,
+                                      const gdouble      *y,
+                                      guint               n_values);
+
 /**
  * lrg_chart_data_series_insert_point:
  * @self: an #LrgChartDataSeries
@@ -451,6 +561,21 @@ lrg_chart_data_series_set_point_value (LrgChartDataSeries *self,
                                         gdouble             x,
                                         gdouble             y);
 
+/**
+ * lrg_chart_data_series_get_generation:
+ * @self: an #LrgChartDataSeries
+ *
+ * Gets a counter that increases whenever point data changes (but not
+ * styling). Consumers caching derived data compare it to detect staleness.
+ *
+ * Returns: the data generation
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint64
+lrg_chart_data_series_get_generation (LrgChartDataSeries *self);
+
 /* ==========================================================================
  * Data Range
  * ========================================================================== */
@@ -501,4 +626,111 @@ LRG_AVAILABLE_IN_ALL
 gdouble
 lrg_chart_data_series_get_y_sum (LrgChartDataSeries *self);
 
+/**
+ * lrg_chart_data_series_get_x_sorted:
+ * @self: an #LrgChartDataSeries
+ *
+ * Checks whether X values never decrease with the point index, as for
+ * time series. Cached alongside the data ranges.
+ *
+ * Returns: %TRUE if X is sorted
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_chart_data_series_get_x_sorted (LrgChartDataSeries *self);
+
+/**
+ * lrg_chart_data_series_find_x:
+ * @self: an #LrgChartDataSeries
+ * @x: X value to search for
+ *
+ * Binary-searches a series whose X values are sorted (see
+ * lrg_chart_data_series_get_x_sorted()) for the first point with
+ * X >= @x. The result is meaningless for unsorted series.
+ *
+ * Returns: the point index, or the point count if every X is < @x
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_chart_data_series_find_x (LrgChartDataSeries *self,
+                               gdouble             x);
+
+/* ==========================================================================
+ * Decimation
+ * ========================================================================== */
+
+/**
+ * lrg_chart_data_series_get_decimated:
+ * @self: an #LrgChartDataSeries
+ * @mode: the decimation algorithm
+ * @start: first point index of the window
+ * @end: one past the last point index of the window
+ * @target: approximate number of points wanted
+ * @n_indices: (out): return location for the number of indices
+ *
+ * Reduces the points in [@start, @end) to about @target representative
+ * points, for drawing dense series at screen resolution. The endpoints
+ * of the window are always kept.
+ *
+ * Results are cached per (@mode, window, @target) for the last few
+ * requests and reused until the point data changes, so redrawing an
+ * unchanged series costs nothing.
+ *
+ * Returns: (transfer none) (array length=n_indices) (nullable): sorted
+ *   point indices, valid until the data changes, or %NULL if the window
+ *   needs no decimation (then @n_indices is the window length and every
+ *   point should be drawn)
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+const guint *
+lrg_chart_data_series_get_decimated (LrgChartDataSeries *self,
+                                      LrgChartDecimation  mode,
+                                      guint               start,
+                                      guint               end,
+                                      guint               target,
+                                      guint              *n_indices);
+
+/* ==========================================================================
+ * Nearest-Point Queries
+ * ========================================================================== */
+
+/**
+ * lrg_chart_data_series_find_nearest:
+ * @self: an #LrgChartDataSeries
+ * @x: query X in data coordinates
+ * @y: query Y in data coordinates
+ * @x_scale: length of one X data unit in the distance metric (e.g. pixels)
+ * @y_scale: length of one Y data unit in the distance metric
+ * @max_distance: only points closer than this (in scaled units) match
+ * @out_index: (out) (optional): return location for the point index
+ * @out_distance: (out) (optional): return location for the scaled distance
+ *
+ * Finds the point nearest to (@x, @y), measuring distance as
+ * sqrt ((@x_scale * dx)^2 + (@y_scale * dy)^2) so that passing a chart's
+ * pixels-per-unit gives screen-space distances. Ties go to the lowest index.
+ *
+ * The first query after a data change builds a 2-d tree over the points
+ * in O(n log n); later queries are O(log n) until the data changes again.
+ *
+ * Returns: %TRUE if a point lies within @max_distance
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_chart_data_series_find_nearest (LrgChartDataSeries *self,
+                                     gdouble             x,
+                                     gdouble             y,
+                                     gdouble             x_scale,
+                                     gdouble             y_scale,
+                                     gdouble             max_distance,
+                                     guint              *out_index,
+                                     gdouble            *out_distance);
+
 G_END_DECLS
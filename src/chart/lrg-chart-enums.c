@@ -266,3 +266,28 @@ lrg_legend_orientation_get_type (void)
 
     return g_define_type_id__volatile;
 }
+
+/* ==========================================================================
+ * LrgChartDecimation
+ * ========================================================================== */
+
+GType
+lrg_chart_decimation_get_type (void)
+{
+    static gsize g_define_type_id__volatile = 0;
+
+    if (g_once_init_enter (&g_define_type_id__volatile))
+    {
+        static const GEnumValue values[] = {
+            { LRG_CHART_DECIMATION_NONE,    "LRG_CHART_DECIMATION_NONE",    "none" },
+            { LRG_CHART_DECIMATION_MIN_MAX, "LRG_CHART_DECIMATION_MIN_MAX", "min-max" },
+            { LRG_CHART_DECIMATION_LTTB,    "LRG_CHART_DECIMATION_LTTB",    "lttb" },
+            { 0, NULL, NULL }
+        };
+        GType g_define_type_id =
+            g_enum_register_static (g_intern_static_string ("LrgChartDecimation"), values);
+        g_once_init_leave (&g_define_type_id__volatile, g_define_type_id);
+    }
+
+    return g_define_type_id__volatile;
+}
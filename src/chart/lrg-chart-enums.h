@@ -271,4 +271,29 @@ LRG_AVAILABLE_IN_ALL
 GType lrg_chart_orientation_get_type (void) G_GNUC_CONST;
 #define LRG_TYPE_CHART_ORIENTATION (lrg_chart_orientation_get_type ())
 
+/* ==========================================================================
+ * Decimation
+ * ========================================================================== */
+
+/**
+ * LrgChartDecimation:
+ * @LRG_CHART_DECIMATION_NONE: Draw every point
+ * @LRG_CHART_DECIMATION_MIN_MAX: Keep the minimum and maximum of each
+ *   pixel-wide bucket (preserves spikes exactly)
+ * @LRG_CHART_DECIMATION_LTTB: Largest-Triangle-Three-Buckets: keep the one
+ *   point per bucket that best preserves the visual shape
+ *
+ * How dense series are reduced to the chart's pixel width before drawing.
+ */
+typedef enum
+{
+    LRG_CHART_DECIMATION_NONE    = 0,
+    LRG_CHART_DECIMATION_MIN_MAX = 1,
+    LRG_CHART_DECIMATION_LTTB    = 2
+} LrgChartDecimation;
+
+LRG_AVAILABLE_IN_ALL
+GType lrg_chart_decimation_get_type (void) G_GNUC_CONST;
+#define LRG_TYPE_CHART_DECIMATION (lrg_chart_decimation_get_type ())
+
 G_END_DECLS
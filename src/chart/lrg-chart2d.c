@@ -982,6 +982,135 @@ lrg_chart2d_screen_to_data (LrgChart2D *self,
         klass->screen_to_data (self, screen_x, screen_y, data_x, data_y);
 }
 
+/* ==========================================================================
+ * Hit Testing
+ * ========================================================================== */
+
+gboolean
+lrg_chart2d_hit_test_points (LrgChart2D      *self,
+                             gfloat           x,
+                             gfloat           y,
+                             gfloat           radius,
+                             LrgChartHitInfo *out_hit)
+{
+    LrgChart2DPrivate *priv;
+    LrgChart *chart;
+    GrlRectangle bounds;
+    guint series_count;
+    guint i, j;
+    gboolean linear;
+    gdouble x_scale = 0.0;
+    gdouble y_scale = 0.0;
+    gdouble query_x = 0.0;
+    gdouble query_y = 0.0;
+    gdouble best_dist = radius;
+    gint best_series = -1;
+    guint best_point = 0;
+
+    g_return_val_if_fail (LRG_IS_CHART2D (self), FALSE);
+
+    priv = lrg_chart2d_get_instance_private (self);
+    chart = LRG_CHART (self);
+
+    if (out_hit != NULL)
+        lrg_chart_hit_info_clear (out_hit);
+
+    lrg_chart_get_content_bounds (chart, &bounds);
+    series_count = lrg_chart_get_series_count (chart);
+
+    /*
+     * The per-series index answers queries in data space with per-axis
+     * pixel scales, which is exact for the default linear mapping. A
+     * subclass with its own mapping, or a degenerate axis, gets a scan.
+     */
+    linear = LRG_CHART2D_GET_CLASS (self)->data_to_screen == lrg_chart2d_real_data_to_screen &&
+             priv->x_max != priv->x_min && priv->y_max != priv->y_min;
+
+    if (linear)
+    {
+        x_scale = bounds.width / (priv->x_max - priv->x_min);
+        y_scale = bounds.height / (priv->y_max - priv->y_min);
+        lrg_chart2d_screen_to_data (self, x, y, &query_x, &query_y);
+    }
+
+    /* Find nearest point within hit radius; earlier series win ties */
+    for (i = 0; i < series_count; i++)
+    {
+        LrgChartDataSeries *series = lrg_chart_get_series (chart, i);
+        guint point_count;
+
+        if (!lrg_chart_data_series_get_visible (series))
+            continue;
+
+        if (linear)
+        {
+            guint index;
+            gdouble dist;
+
+            if (lrg_chart_data_series_find_nearest (series, query_x, query_y,
+                                                    x_scale, y_scale, best_dist,
+                                                    &index, &dist))
+            {
+                best_dist = dist;
+                best_series = i;
+                best_point = index;
+            }
+            continue;
+        }
+
+        point_count = lrg_chart_data_series_get_point_count (series);
+        for (j = 0; j < point_count; j++)
+        {
+            gfloat sx, sy;
+            gdouble dist;
+
+            lrg_chart2d_data_to_screen (self,
+                                        lrg_chart_data_series_get_x (series, j),
+                                        lrg_chart_data_series_get_y (series, j),
+                                        &sx, &sy);
+            dist = sqrt ((sx - x) * (sx - x) + (sy - y) * (sy - y));
+
+            if (dist < best_dist)
+            {
+                best_dist = dist;
+                best_series = i;
+                best_point = j;
+            }
+        }
+    }
+
+    if (best_series < 0)
+        return FALSE;
+
+    if (out_hit != NULL)
+    {
+        LrgChartDataSeries *series = lrg_chart_get_series (chart, best_series);
+        GrlRectangle hit_bounds;
+        gfloat sx, sy;
+
+        lrg_chart2d_data_to_screen (self,
+                                    lrg_chart_data_series_get_x (series, best_point),
+                                    lrg_chart_data_series_get_y (series, best_point),
+                                    &sx, &sy);
+
+        lrg_chart_hit_info_set_series_index (out_hit, best_series);
+        lrg_chart_hit_info_set_point_index (out_hit, (gint) best_point);
+        lrg_chart_hit_info_set_screen_x (out_hit, sx);
+        lrg_chart_hit_info_set_screen_y (out_hit, sy);
+        lrg_chart_hit_info_set_data_point (out_hit,
+                                           lrg_chart_data_series_get_point (series, best_point));
+
+        /* Create bounds around the hit point */
+        hit_bounds.x = sx - radius;
+        hit_bounds.y = sy - radius;
+        hit_bounds.width = radius * 2.0f;
+        hit_bounds.height = radius * 2.0f;
+        lrg_chart_hit_info_set_bounds (out_hit, &hit_bounds);
+    }
+
+    return TRUE;
+}
+
 /* ==========================================================================
  * Drawing Helper Wrappers
  * ========================================================================== */
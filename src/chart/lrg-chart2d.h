@@ -360,6 +360,38 @@ lrg_chart2d_screen_to_data (LrgChart2D *self,
                             gdouble    *data_x,
                             gdouble    *data_y);
 
+/* ==========================================================================
+ * Hit Testing
+ * ========================================================================== */
+
+/**
+ * lrg_chart2d_hit_test_points:
+ * @self: an #LrgChart2D
+ * @x: X position in screen coordinates
+ * @y: Y position in screen coordinates
+ * @radius: hit radius in pixels
+ * @out_hit: (out) (optional): hit information
+ *
+ * Finds the data point of any visible series nearest to (@x, @y) within
+ * @radius pixels, for charts that draw one marker per point. Subclasses
+ * call this from their #LrgChartClass.hit_test implementation.
+ *
+ * Queries go through each series' lazily built spatial index (see
+ * lrg_chart_data_series_find_nearest()), so hovering costs O(log n) per
+ * series rather than a scan of every point.
+ *
+ * Returns: %TRUE if a point was hit
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_chart2d_hit_test_points (LrgChart2D      *self,
+                             gfloat           x,
+                             gfloat           y,
+                             gfloat           radius,
+                             LrgChartHitInfo *out_hit);
+
 /* ==========================================================================
  * Drawing Helper Wrappers
  * ========================================================================== */
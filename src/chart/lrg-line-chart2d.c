@@ -32,6 +32,9 @@ struct _LrgLineChart2D
 
     /* Hit testing */
     gfloat         hit_radius;
+
+    /* Dense series */
+    LrgChartDecimation decimation;
 };
 
 G_DEFINE_TYPE (LrgLineChart2D, lrg_line_chart2d, LRG_TYPE_CHART2D)
@@ -50,6 +53,7 @@ enum
     PROP_SHOW_MARKERS,
     PROP_DEFAULT_MARKER,
     PROP_HIT_RADIUS,
+    PROP_DECIMATION,
     N_PROPS
 };
 
@@ -160,14 +164,6 @@ draw_dashed_line (gfloat          x1,
     }
 }
 
-static gfloat
-distance_sq (gfloat x1, gfloat y1, gfloat x2, gfloat y2)
-{
-    gfloat dx = x2 - x1;
-    gfloat dy = y2 - y1;
-    return dx * dx + dy * dy;
-}
-
 /* ==========================================================================
  * Virtual Method Overrides
  * ========================================================================== */
@@ -180,10 +176,13 @@ lrg_line_chart2d_draw_data (LrgChart2D *chart2d)
     GrlRectangle bounds;
     guint series_count;
     guint i, j;
+    gdouble x_min, x_max;
     gdouble y_min;
 
     lrg_chart_get_content_bounds (chart, &bounds);
     series_count = lrg_chart_get_series_count (chart);
+    x_min = lrg_chart2d_get_x_min (chart2d);
+    x_max = lrg_chart2d_get_x_max (chart2d);
     y_min = lrg_chart2d_get_y_min (chart2d);
 
     if (series_count == 0)
@@ -199,6 +198,9 @@ lrg_line_chart2d_draw_data (LrgChart2D *chart2d)
         gfloat line_width;
         gfloat marker_size;
         guint point_count;
+        guint start, end;
+        guint target;
+        const guint *indices;
         GrlVector2 *points;
         gfloat *screen_x;
         gfloat *screen_y;
@@ -219,16 +221,41 @@ lrg_line_chart2d_draw_data (LrgChart2D *chart2d)
         if (point_count == 0)
             continue;
 
-        /* Convert all points to screen coordinates */
+        /*
+         * Only draw the visible window of sorted series, keeping one point
+         * past each edge so the line runs off the plot.
+         */
+        start = 0;
+        end = point_count;
+        if (lrg_chart_data_series_get_x_sorted (series))
+        {
+            start = lrg_chart_data_series_find_x (series, x_min);
+            end = lrg_chart_data_series_find_x (series, x_max);
+            start = start > 0 ? start - 1 : 0;
+            end = MIN (end + 1, point_count);
+        }
+
+        /* Reduce dense series to the plot's pixel width. */
+        target = (guint) MAX (bounds.width, 0.0f);
+        if (self->decimation == LRG_CHART_DECIMATION_MIN_MAX)
+            target *= 2;
+        indices = lrg_chart_data_series_get_decimated (series, self->decimation,
+                                                       start, end, target,
+                                                       &point_count);
+
+        if (point_count == 0)
+            continue;
+
+        /* Convert the drawn points to screen coordinates */
         screen_x = g_new (gfloat, point_count);
         screen_y = g_new (gfloat, point_count);
         points = g_new (GrlVector2, point_count);
 
         for (j = 0; j < point_count; j++)
         {
-            const LrgChartDataPoint *point = lrg_chart_data_series_get_point (series, j);
-            gdouble dx = lrg_chart_data_point_get_x (point);
-            gdouble dy = lrg_chart_data_point_get_y (point);
+            guint idx = indices != NULL ? indices[j] : start + j;
+            gdouble dx = lrg_chart_data_series_get_x (series, idx);
+            gdouble dy = lrg_chart_data_series_get_y (series, idx);
 
             lrg_chart2d_data_to_screen (chart2d, dx, dy, &screen_x[j], &screen_y[j]);
             points[j].x = screen_x[j];
@@ -324,78 +351,9 @@ lrg_line_chart2d_hit_test (LrgChart        *chart,
                            LrgChartHitInfo *out_hit)
 {
     LrgLineChart2D *self = LRG_LINE_CHART2D (chart);
-    LrgChart2D *chart2d = LRG_CHART2D (chart);
-    guint series_count;
-    guint i, j;
-    gfloat best_dist_sq = G_MAXFLOAT;
-    gint best_series = -1;
-    gint best_point = -1;
-    gfloat best_sx = 0, best_sy = 0;
-    gfloat hit_radius_sq = self->hit_radius * self->hit_radius;
-
-    if (out_hit != NULL)
-        lrg_chart_hit_info_clear (out_hit);
-
-    series_count = lrg_chart_get_series_count (chart);
-
-    /* Find nearest point within hit radius */
-    for (i = 0; i < series_count; i++)
-    {
-        LrgChartDataSeries *series = lrg_chart_get_series (chart, i);
-        guint point_count;
-
-        if (!lrg_chart_data_series_get_visible (series))
-            continue;
-
-        point_count = lrg_chart_data_series_get_point_count (series);
-
-        for (j = 0; j < point_count; j++)
-        {
-            const LrgChartDataPoint *point = lrg_chart_data_series_get_point (series, j);
-            gdouble dx = lrg_chart_data_point_get_x (point);
-            gdouble dy = lrg_chart_data_point_get_y (point);
-            gfloat sx, sy;
-            gfloat dist_sq;
 
-            lrg_chart2d_data_to_screen (chart2d, dx, dy, &sx, &sy);
-            dist_sq = distance_sq (x, y, sx, sy);
-
-            if (dist_sq < hit_radius_sq && dist_sq < best_dist_sq)
-            {
-                best_dist_sq = dist_sq;
-                best_series = i;
-                best_point = j;
-                best_sx = sx;
-                best_sy = sy;
-            }
-        }
-    }
-
-    if (best_series >= 0)
-    {
-        if (out_hit != NULL)
-        {
-            LrgChartDataSeries *series = lrg_chart_get_series (chart, best_series);
-            const LrgChartDataPoint *point = lrg_chart_data_series_get_point (series, best_point);
-            GrlRectangle bounds;
-
-            lrg_chart_hit_info_set_series_index (out_hit, best_series);
-            lrg_chart_hit_info_set_point_index (out_hit, best_point);
-            lrg_chart_hit_info_set_screen_x (out_hit, best_sx);
-            lrg_chart_hit_info_set_screen_y (out_hit, best_sy);
-            lrg_chart_hit_info_set_data_point (out_hit, point);
-
-            /* Create bounds around the hit point */
-            bounds.x = best_sx - self->hit_radius;
-            bounds.y = best_sy - self->hit_radius;
-            bounds.width = self->hit_radius * 2.0f;
-            bounds.height = self->hit_radius * 2.0f;
-            lrg_chart_hit_info_set_bounds (out_hit, &bounds);
-        }
-        return TRUE;
-    }
-
-    return FALSE;
+    return lrg_chart2d_hit_test_points (LRG_CHART2D (chart), x, y,
+                                        self->hit_radius, out_hit);
 }
 
 /* ==========================================================================
@@ -433,6 +391,9 @@ lrg_line_chart2d_get_property (GObject    *object,
     case PROP_HIT_RADIUS:
         g_value_set_float (value, self->hit_radius);
         break;
+    case PROP_DECIMATION:
+        g_value_set_enum (value, self->decimation);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -469,6 +430,9 @@ lrg_line_chart2d_set_property (GObject      *object,
     case PROP_HIT_RADIUS:
         lrg_line_chart2d_set_hit_radius (self, g_value_get_float (value));
         break;
+    case PROP_DECIMATION:
+        lrg_line_chart2d_set_decimation (self, g_value_get_enum (value));
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -541,6 +505,14 @@ lrg_line_chart2d_class_init (LrgLineChart2DClass *klass)
                             1.0f, 50.0f, 10.0f,
                             G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
 
+    properties[PROP_DECIMATION] =
+        g_param_spec_enum ("decimation",
+                           "Decimation",
+                           "How series denser than the plot width are reduced",
+                           LRG_TYPE_CHART_DECIMATION,
+                           LRG_CHART_DECIMATION_LTTB,
+                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS);
+
     g_object_class_install_properties (object_class, N_PROPS, properties);
 }
 
@@ -554,6 +526,7 @@ lrg_line_chart2d_init (LrgLineChart2D *self)
     self->show_markers = TRUE;
     self->default_marker = LRG_CHART_MARKER_CIRCLE;
     self->hit_radius = 10.0f;
+    self->decimation = LRG_CHART_DECIMATION_LTTB;
 }
 
 /* ==========================================================================
@@ -748,3 +721,28 @@ lrg_line_chart2d_set_hit_radius (LrgLineChart2D *self,
 
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_HIT_RADIUS]);
 }
+
+/* ==========================================================================
+ * Decimation
+ * ========================================================================== */
+
+LrgChartDecimation
+lrg_line_chart2d_get_decimation (LrgLineChart2D *self)
+{
+    g_return_val_if_fail (LRG_IS_LINE_CHART2D (self), LRG_CHART_DECIMATION_NONE);
+    return self->decimation;
+}
+
+void
+lrg_line_chart2d_set_decimation (LrgLineChart2D     *self,
+                                 LrgChartDecimation  decimation)
+{
+    g_return_if_fail (LRG_IS_LINE_CHART2D (self));
+
+    if (self->decimation == decimation)
+        return;
+
+    self->decimation = decimation;
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_DECIMATION]);
+}
@@ -273,4 +273,41 @@ void
 lrg_line_chart2d_set_hit_radius (LrgLineChart2D *self,
                                  gfloat          radius);
 
+/* ==========================================================================
+ * Decimation
+ * ========================================================================== */
+
+/**
+ * lrg_line_chart2d_get_decimation:
+ * @self: an #LrgLineChart2D
+ *
+ * Gets how series with more points than the plot is wide are reduced
+ * before drawing.
+ *
+ * Returns: the decimation mode
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgChartDecimation
+lrg_line_chart2d_get_decimation (LrgLineChart2D *self);
+
+/**
+ * lrg_line_chart2d_set_decimation:
+ * @self: an #LrgLineChart2D
+ * @decimation: the decimation mode
+ *
+ * Sets how dense series are reduced before drawing. With LTTB each
+ * series is drawn with at most one point per pixel column; with min/max
+ * with at most two. Series with X sorted are first clipped to the
+ * visible X range. Decimated points are cached by the series until its
+ * data changes. Defaults to %LRG_CHART_DECIMATION_LTTB.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_line_chart2d_set_decimation (LrgLineChart2D     *self,
+                                 LrgChartDecimation  decimation);
+
 G_END_DECLS
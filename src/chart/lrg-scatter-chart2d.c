@@ -128,14 +128,6 @@ draw_marker (gfloat          x,
     }
 }
 
-static gfloat
-distance_sq (gfloat x1, gfloat y1, gfloat x2, gfloat y2)
-{
-    gfloat dx = x2 - x1;
-    gfloat dy = y2 - y1;
-    return dx * dx + dy * dy;
-}
-
 /*
  * Calculate linear regression coefficients using least squares.
  * Returns FALSE if regression cannot be calculated.
@@ -332,78 +324,9 @@ lrg_scatter_chart2d_hit_test (LrgChart        *chart,
                               LrgChartHitInfo *out_hit)
 {
     LrgScatterChart2D *self = LRG_SCATTER_CHART2D (chart);
-    LrgChart2D *chart2d = LRG_CHART2D (chart);
-    guint series_count;
-    guint i, j;
-    gfloat best_dist_sq = G_MAXFLOAT;
-    gint best_series = -1;
-    gint best_point = -1;
-    gfloat best_sx = 0, best_sy = 0;
-    gfloat hit_radius_sq = self->hit_radius * self->hit_radius;
-
-    if (out_hit != NULL)
-        lrg_chart_hit_info_clear (out_hit);
-
-    series_count = lrg_chart_get_series_count (chart);
-
-    /* Find nearest point within hit radius */
-    for (i = 0; i < series_count; i++)
-    {
-        LrgChartDataSeries *series = lrg_chart_get_series (chart, i);
-        guint point_count;
-
-        if (!lrg_chart_data_series_get_visible (series))
-            continue;
-
-        point_count = lrg_chart_data_series_get_point_count (series);
-
-        for (j = 0; j < point_count; j++)
-        {
-            const LrgChartDataPoint *point = lrg_chart_data_series_get_point (series, j);
-            gdouble dx = lrg_chart_data_point_get_x (point);
-            gdouble dy = lrg_chart_data_point_get_y (point);
-            gfloat sx, sy;
-            gfloat dist_sq;
-
-            lrg_chart2d_data_to_screen (chart2d, dx, dy, &sx, &sy);
-            dist_sq = distance_sq (x, y, sx, sy);
-
-            if (dist_sq < hit_radius_sq && dist_sq < best_dist_sq)
-            {
-                best_dist_sq = dist_sq;
-                best_series = i;
-                best_point = j;
-                best_sx = sx;
-                best_sy = sy;
-            }
-        }
-    }
-
-    if (best_series >= 0)
-    {
-        if (out_hit != NULL)
-        {
-            LrgChartDataSeries *series = lrg_chart_get_series (chart, best_series);
-            const LrgChartDataPoint *point = lrg_chart_data_series_get_point (series, best_point);
-            GrlRectangle bounds;
-
-            lrg_chart_hit_info_set_series_index (out_hit, best_series);
-            lrg_chart_hit_info_set_point_index (out_hit, best_point);
-            lrg_chart_hit_info_set_screen_x (out_hit, best_sx);
-            lrg_chart_hit_info_set_screen_y (out_hit, best_sy);
-            lrg_chart_hit_info_set_data_point (out_hit, point);
-
-            /* Create bounds around the hit point */
-            bounds.x = best_sx - self->hit_radius;
-            bounds.y = best_sy - self->hit_radius;
-            bounds.width = self->hit_radius * 2.0f;
-            bounds.height = self->hit_radius * 2.0f;
-            lrg_chart_hit_info_set_bounds (out_hit, &bounds);
-        }
-        return TRUE;
-    }
 
-    return FALSE;
+    return lrg_chart2d_hit_test_points (LRG_CHART2D (chart), x, y,
+                                        self->hit_radius, out_hit);
 }
 
 /* ==========================================================================
@@ -0,0 +1,2021 @@
+/* lrg-combat-simulator.c
+ *
+ * Copyright 2025 Libregnum Authors
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "lrg-combat-simulator.h"
+#include "lrg-card-effect.h"
+#include "lrg-card-instance.h"
+#include "lrg-card-pile.h"
+#include "lrg-hand.h"
+#include "lrg-combatant.h"
+#include "lrg-combat-rules.h"
+#include "lrg-player-combatant.h"
+#include "lrg-enemy-def.h"
+#include "lrg-enemy-instance.h"
+#include "lrg-enemy-intent.h"
+#include "lrg-status-effect-def.h"
+#include "lrg-status-effect-registry.h"
+#include "../lrg-log.h"
+
+#include <math.h>
+#include <string.h>
+
+/**
+ * SECTION:lrg-combat-simulator
+ * @title: LrgCombatSimulator
+ * @short_description: Headless Monte Carlo combat simulation
+ *
+ * #LrgCombatSimulator plays thousands of combats from a snapshot of a
+ * #LrgCombatContext to measure how a deck fares against an encounter:
+ * win rate, turns to win and the spread of damage taken.
+ *
+ * The snapshot is compiled into plain structures, so forking a combat
+ * is a single copy and combats run on worker threads without touching
+ * any GObject. Cards are simulated from their #LrgCardEffect lists and
+ * enemies from their intent patterns; card and enemy subclasses that
+ * override on_play() or decide_intent() are simulated from that data
+ * all the same.
+ *
+ * Since: 1.0
+ */
+
+#define MAX_ENEMIES          (8)
+#define MAX_STATUSES         (16)
+#define MAX_PLAYS_PER_TURN   (64)
+#define NO_INTENT            (G_MAXUINT16)
+#define PARALLEL_MIN_COMBATS (256)
+#define DEFAULT_MAX_TURNS    (50)
+
+/* Statuses the combat rules read; always interned first */
+enum
+{
+    STATUS_STRENGTH,
+    STATUS_DEXTERITY,
+    STATUS_WEAK,
+    STATUS_VULNERABLE,
+    STATUS_FRAIL,
+    STATUS_INTANGIBLE,
+    STATUS_BARRICADE,
+    N_RULE_STATUSES
+};
+
+static const gchar * const rule_statuses[N_RULE_STATUSES] = {
+    "strength", "dexterity", "weak", "vulnerable", "frail", "intangible", "barricade"
+};
+
+typedef enum
+{
+    OP_DAMAGE,
+    OP_BLOCK,
+    OP_DRAW,
+    OP_STATUS,
+    OP_HEAL,
+    OP_ENERGY
+} EffectOp;
+
+typedef struct
+{
+    guint8 op;
+    guint8 target;  /* LrgCardTargetType */
+    guint8 status;
+    guint8 flags;   /* LrgEffectFlags */
+    gint   amount;
+    gint   times;
+} SimEffect;
+
+typedef struct
+{
+    LrgCardDef *def;
+    gint        cost;
+    guint       keywords;
+    guint8      target;
+    guint       first_effect;
+    guint       n_effects;
+} SimCard;
+
+typedef struct
+{
+    LrgEnemyIntent *intent;
+    guint8          type;
+    guint8          status;
+    gint            damage;
+    gint            times;
+    gint            block;
+    gint            stacks;
+} SimIntent;
+
+typedef struct
+{
+    guint16 intent;
+    gint    weight;
+} SimPattern;
+
+typedef struct
+{
+    guint first_pattern;
+    guint n_patterns;
+    gint  total_weight;
+} SimEnemy;
+
+typedef struct
+{
+    gint   health;
+    gint   max_health;
+    gint   block;
+    gint16 status[MAX_STATUSES];
+} SimFighter;
+
+/*
+ * The whole state of a combat in progress. The four piles follow the
+ * header, n_cards entries each, so forking a combat is one memcpy().
+ * Draw piles are drawn from the end, like #LrgCardPile.
+ */
+struct _LrgCombatSimState
+{
+    const LrgCombatSimulator *sim;
+    guint64                   rng;
+    LrgCombatResult           result;
+    gint                      turn;
+    gint                      energy;
+    gint                      damage_dealt;
+    guint16                   n_draw;
+    guint16                   n_hand;
+    guint16                   n_discard;
+    guint16                   n_exhaust;
+    guint16                   intent[MAX_ENEMIES];
+    SimFighter                player;
+    SimFighter                enemies[MAX_ENEMIES];
+    guint16                   cards[];
+};
+
+struct _LrgCombatSimReport
+{
+    guint   combats;
+    guint   wins;
+    guint   losses;
+    guint   timeouts;
+    guint64 turns_to_win_total;
+    guint64 damage_taken_total;
+    guint64 damage_dealt_total;
+    guint  *turns_to_win;
+    guint   n_turns;
+    guint  *damage_taken;
+    guint   n_damage;
+};
+
+struct _LrgCombatSimulator
+{
+    GObject                 parent_instance;
+
+    GArray                 *cards;      /* SimCard */
+    GArray                 *effects;    /* SimEffect */
+    GArray                 *intents;    /* SimIntent */
+    GArray                 *patterns;   /* SimPattern */
+    SimEnemy                enemies[MAX_ENEMIES];
+    guint                   n_enemies;
+
+    GPtrArray              *statuses;   /* status ids, index = slot */
+    gboolean                decays[MAX_STATUSES];
+
+    gint                    energy_per_turn;
+    gint                    cards_per_turn;
+    guint                   hand_limit;
+
+    /* Snapshot every combat starts from */
+    LrgCombatSimState      *initial;
+    gsize                   state_size;
+    gboolean                from_setup;
+
+    LrgCombatSimPolicy      policy;
+    LrgCombatSimPolicyFunc  policy_func;
+    gpointer                policy_data;
+    GDestroyNotify          policy_destroy;
+    guint                   max_turns;
+};
+
+G_DEFINE_FINAL_TYPE (LrgCombatSimulator, lrg_combat_simulator, G_TYPE_OBJECT)
+
+G_DEFINE_BOXED_TYPE (LrgCombatSimReport, lrg_combat_sim_report,
+                     lrg_combat_sim_report_copy,
+                     lrg_combat_sim_report_free)
+
+enum
+{
+    PROP_0,
+    PROP_POLICY,
+    PROP_MAX_TURNS,
+    N_PROPS
+};
+
+static GParamSpec *properties[N_PROPS];
+
+/* ==========================================================================
+ * Random numbers
+ * ========================================================================== */
+
+/* SplitMix64: cheap, and any seed gives a good stream */
+static inline guint32
+sim_random (LrgCombatSimState *state)
+{
+    guint64 z;
+
+    state->rng += G_GUINT64_CONSTANT (0x9E3779B97F4A7C15);
+    z = state->rng;
+    z = (z ^ (z >> 30)) * G_GUINT64_CONSTANT (0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * G_GUINT64_CONSTANT (0x94D049BB133111EB);
+
+    return (guint32)((z ^ (z >> 31)) >> 32);
+}
+
+/* Uniform in [0, n) */
+static inline guint
+sim_random_range (LrgCombatSimState *state,
+                  guint              n)
+{
+    return (guint)(((guint64)sim_random (state) * n) >> 32);
+}
+
+/* ==========================================================================
+ * State helpers
+ * ========================================================================== */
+
+static inline guint16 *
+state_draw (LrgCombatSimState *state)
+{
+    return state->cards;
+}
+
+static inline guint16 *
+state_hand (LrgCombatSimState *state)
+{
+    return state->cards + state->sim->cards->len;
+}
+
+static inline guint16 *
+state_discard (LrgCombatSimState *state)
+{
+    return state->cards + 2 * state->sim->cards->len;
+}
+
+static inline guint16 *
+state_exhaust (LrgCombatSimState *state)
+{
+    return state->cards + 3 * state->sim->cards->len;
+}
+
+static inline const SimCard *
+sim_card (const LrgCombatSimulator *self,
+          guint16                   card)
+{
+    return &g_array_index (self->cards, SimCard, card);
+}
+
+static inline gboolean
+enemy_alive (const LrgCombatSimState *state,
+             guint                    index)
+{
+    return state->enemies[index].health > 0;
+}
+
+static void
+shuffle (LrgCombatSimState *state,
+         guint16           *cards,
+         guint              n_cards)
+{
+    guint i;
+
+    for (i = n_cards; i > 1; i--)
+    {
+        guint j = sim_random_range (state, i);
+        guint16 tmp = cards[i - 1];
+
+        cards[i - 1] = cards[j];
+        cards[j] = tmp;
+    }
+}
+
+static void
+check_result (LrgCombatSimState *state)
+{
+    guint i;
+
+    if (state->player.health <= 0)
+    {
+        state->result = LRG_COMBAT_RESULT_DEFEAT;
+        return;
+    }
+
+    for (i = 0; i < state->sim->n_enemies; i++)
+    {
+        if (enemy_alive (state, i))
+            return;
+    }
+
+    state->result = LRG_COMBAT_RESULT_VICTORY;
+}
+
+/* ==========================================================================
+ * Combat rules
+ * ========================================================================== */
+
+/* Mirrors the default LrgCombatRules damage formula */
+static gint
+calculate_damage (gint              base,
+                  const SimFighter *attacker,
+                  const SimFighter *defender)
+{
+    gdouble damage;
+
+    damage = (gdouble)base + attacker->status[STATUS_STRENGTH];
+
+    if (attacker->status[STATUS_WEAK] > 0)
+        damage *= 0.75;
+
+    if (defender->status[STATUS_VULNERABLE] > 0)
+        damage *= 1.5;
+
+    damage = floor (damage);
+
+    if (defender->status[STATUS_INTANGIBLE] > 0 && damage > 1.0)
+        damage = 1.0;
+
+    return MAX (0, (gint)damage);
+}
+
+/* Mirrors the default LrgCombatRules block formula */
+static gint
+calculate_block (gint              base,
+                 const SimFighter *blocker)
+{
+    gdouble block;
+
+    block = (gdouble)base + blocker->status[STATUS_DEXTERITY];
+
+    if (blocker->status[STATUS_FRAIL] > 0)
+        block *= 0.75;
+
+    return MAX (0, (gint)floor (block));
+}
+
+/* Returns the health @defender lost */
+static gint
+deal_damage (const SimFighter *attacker,
+             SimFighter       *defender,
+             gint              base,
+             guint             flags)
+{
+    gint amount;
+    gint lost;
+
+    if (flags & LRG_EFFECT_FLAG_TRUE_DAMAGE)
+        amount = MAX (0, base);
+    else
+        amount = calculate_damage (base, attacker, defender);
+
+    if (!(flags & (LRG_EFFECT_FLAG_HP_LOSS | LRG_EFFECT_FLAG_UNBLOCKABLE)))
+    {
+        gint blocked = MIN (defender->block, amount);
+
+        defender->block -= blocked;
+        amount -= blocked;
+    }
+
+    lost = MIN (amount, defender->health);
+    defender->health -= lost;
+
+    return lost;
+}
+
+static void
+apply_status (SimFighter *fighter,
+              guint       status,
+              gint        stacks)
+{
+    if (stacks > 0)
+        fighter->status[status] = (gint16)MIN (G_MAXINT16, fighter->status[status] + stacks);
+}
+
+/* Duration statuses lose a stack at the end of their owner's turn */
+static void
+decay_statuses (const LrgCombatSimulator *self,
+                SimFighter               *fighter)
+{
+    guint i;
+
+    for (i = 0; i < self->statuses->len; i++)
+    {
+        if (self->decays[i] && fighter->status[i] > 0)
+            fighter->status[i]--;
+    }
+}
+
+static void
+draw_cards (LrgCombatSimState *state,
+            gint               count)
+{
+    const LrgCombatSimulator *self = state->sim;
+    guint16 *draw = state_draw (state);
+    gint i;
+
+    for (i = 0; i < count; i++)
+    {
+        guint16 card;
+
+        if (state->n_draw == 0)
+        {
+            if (state->n_discard == 0)
+                break;
+
+            memcpy (draw, state_discard (state), state->n_discard * sizeof (guint16));
+            state->n_draw = state->n_discard;
+            state->n_discard = 0;
+            shuffle (state, draw, state->n_draw);
+        }
+
+        card = draw[--state->n_draw];
+
+        if (state->n_hand < self->hand_limit)
+            state_hand (state)[state->n_hand++] = card;
+        else
+            state_discard (state)[state->n_discard++] = card;
+    }
+}
+
+/* Picks a living enemy for an effect; returns FALSE if none is left */
+static gboolean
+pick_enemy (LrgCombatSimState *state,
+            guint8             target_type,
+            guint              chosen,
+            guint             *out_enemy)
+{
+    guint n_enemies = state->sim->n_enemies;
+    guint alive[MAX_ENEMIES];
+    guint n_alive = 0;
+    guint i;
+
+    for (i = 0; i < n_enemies; i++)
+    {
+        if (enemy_alive (state, i))
+            alive[n_alive++] = i;
+    }
+
+    if (n_alive == 0)
+        return FALSE;
+
+    if (target_type == LRG_CARD_TARGET_RANDOM_ENEMY)
+        *out_enemy = alive[sim_random_range (state, n_alive)];
+    else if (chosen < n_enemies && enemy_alive (state, chosen))
+        *out_enemy = chosen;
+    else
+        *out_enemy = alive[0];
+
+    return TRUE;
+}
+
+static void
+apply_effect (LrgCombatSimState *state,
+              const SimEffect   *effect,
+              guint              chosen)
+{
+    const LrgCombatSimulator *self = state->sim;
+    guint enemy;
+    guint i;
+
+    switch ((EffectOp)effect->op)
+    {
+    case OP_DAMAGE:
+        if (effect->target == LRG_CARD_TARGET_SELF)
+        {
+            deal_damage (&state->player, &state->player, effect->amount, effect->flags);
+        }
+        else if (effect->target == LRG_CARD_TARGET_ALL_ENEMIES)
+        {
+            for (i = 0; i < self->n_enemies; i++)
+            {
+                if (enemy_alive (state, i))
+                    state->damage_dealt += deal_damage (&state->player, &state->enemies[i],
+                                                        effect->amount, effect->flags);
+            }
+        }
+        else if (pick_enemy (state, effect->target, chosen, &enemy))
+        {
+            state->damage_dealt += deal_damage (&state->player, &state->enemies[enemy],
+                                                effect->amount, effect->flags);
+        }
+        break;
+
+    case OP_BLOCK:
+        state->player.block += calculate_block (effect->amount, &state->player);
+        break;
+
+    case OP_DRAW:
+        draw_cards (state, effect->amount);
+        break;
+
+    case OP_STATUS:
+        if (effect->target == LRG_CARD_TARGET_SELF || effect->target == LRG_CARD_TARGET_NONE)
+        {
+            apply_status (&state->player, effect->status, effect->amount);
+        }
+        else if (effect->target == LRG_CARD_TARGET_ALL_ENEMIES)
+        {
+            for (i = 0; i < self->n_enemies; i++)
+            {
+                if (enemy_alive (state, i))
+                    apply_status (&state->enemies[i], effect->status, effect->amount);
+            }
+        }
+        else if (pick_enemy (state, effect->target, chosen, &enemy))
+        {
+            apply_status (&state->enemies[enemy], effect->status, effect->amount);
+        }
+        break;
+
+    case OP_HEAL:
+        state->player.health = MIN (state->player.max_health,
+                                    state->player.health + MAX (0, effect->amount));
+        break;
+
+    case OP_ENERGY:
+        state->energy = MAX (0, state->energy + effect->amount);
+        break;
+
+    default:
+        g_assert_not_reached ();
+    }
+}
+
+static gboolean
+can_play (const LrgCombatSimState *state,
+          guint                    index)
+{
+    const SimCard *card;
+
+    if (index >= state->n_hand)
+        return FALSE;
+
+    card = sim_card (state->sim, state_hand ((LrgCombatSimState *)state)[index]);
+
+    if (card->keywords & LRG_CARD_KEYWORD_UNPLAYABLE)
+        return FALSE;
+
+    if (!(card->keywords & LRG_CARD_KEYWORD_X_COST) && card->cost > state->energy)
+        return FALSE;
+
+    return TRUE;
+}
+
+/* Plays the card at @index of the hand, like lrg_combat_manager_play_card() */
+static void
+play_card (LrgCombatSimState *state,
+           guint              index,
+           guint              target)
+{
+    const LrgCombatSimulator *self = state->sim;
+    guint16 *hand = state_hand (state);
+    const SimCard *card;
+    guint16 card_index;
+    gint repeats;
+    gint r;
+    guint i;
+
+    card_index = hand[index];
+    card = sim_card (self, card_index);
+
+    if (card->keywords & LRG_CARD_KEYWORD_X_COST)
+    {
+        repeats = state->energy;
+        state->energy = 0;
+    }
+    else
+    {
+        repeats = 1;
+        state->energy -= card->cost;
+    }
+
+    memmove (hand + index, hand + index + 1, (state->n_hand - index - 1) * sizeof (guint16));
+    state->n_hand--;
+
+    for (r = 0; r < repeats; r++)
+    {
+        for (i = 0; i < card->n_effects; i++)
+        {
+            const SimEffect *effect;
+            gint t;
+
+            effect = &g_array_index (self->effects, SimEffect, card->first_effect + i);
+            for (t = 0; t < effect->times; t++)
+                apply_effect (state, effect, target);
+        }
+    }
+
+    if (card->keywords & LRG_CARD_KEYWORD_EXHAUST)
+        state_exhaust (state)[state->n_exhaust++] = card_index;
+    else
+        state_discard (state)[state->n_discard++] = card_index;
+
+    check_result (state);
+}
+
+static void
+decide_intent (LrgCombatSimState *state,
+               guint              index)
+{
+    const SimEnemy *enemy = &state->sim->enemies[index];
+    gint roll;
+    guint i;
+
+    state->intent[index] = NO_INTENT;
+
+    if (enemy->total_weight <= 0)
+        return;
+
+    roll = (gint)sim_random_range (state, (guint)enemy->total_weight);
+
+    for (i = 0; i < enemy->n_patterns; i++)
+    {
+        const SimPattern *pattern;
+
+        pattern = &g_array_index (state->sim->patterns, SimPattern, enemy->first_pattern + i);
+        roll -= pattern->weight;
+        if (roll < 0)
+        {
+            state->intent[index] = pattern->intent;
+            return;
+        }
+    }
+}
+
+static void
+execute_intent (LrgCombatSimState *state,
+                guint              index)
+{
+    SimFighter *enemy = &state->enemies[index];
+    const SimIntent *intent;
+    gint t;
+
+    if (state->intent[index] == NO_INTENT)
+        return;
+
+    intent = &g_array_index (state->sim->intents, SimIntent, state->intent[index]);
+
+    switch (intent->type)
+    {
+    case LRG_INTENT_ATTACK:
+    case LRG_INTENT_ATTACK_BUFF:
+    case LRG_INTENT_ATTACK_DEBUFF:
+        for (t = 0; t < intent->times && state->player.health > 0; t++)
+            deal_damage (enemy, &state->player, intent->damage, LRG_EFFECT_FLAG_NONE);
+        break;
+    default:
+        break;
+    }
+
+    if (intent->block > 0)
+        enemy->block += calculate_block (intent->block, enemy);
+
+    switch (intent->type)
+    {
+    case LRG_INTENT_BUFF:
+    case LRG_INTENT_ATTACK_BUFF:
+        apply_status (enemy, intent->status, intent->stacks);
+        break;
+    case LRG_INTENT_DEBUFF:
+    case LRG_INTENT_ATTACK_DEBUFF:
+    case LRG_INTENT_STRONG_DEBUFF:
+        apply_status (&state->player, intent->status, intent->stacks);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+start_player_turn (LrgCombatSimState *state)
+{
+    const LrgCombatSimulator *self = state->sim;
+
+    state->turn++;
+
+    if (state->player.status[STATUS_BARRICADE] <= 0)
+        state->player.block = 0;
+
+    state->energy = self->energy_per_turn;
+    draw_cards (state, self->cards_per_turn);
+}
+
+static void
+end_player_turn (LrgCombatSimState *state)
+{
+    const LrgCombatSimulator *self = state->sim;
+    guint16 *hand = state_hand (state);
+    guint kept = 0;
+    guint i;
+
+    /* Retained cards stay, ethereal cards are exhausted */
+    for (i = 0; i < state->n_hand; i++)
+    {
+        guint16 card_index = hand[i];
+        guint keywords = sim_card (self, card_index)->keywords;
+
+        if (keywords & LRG_CARD_KEYWORD_RETAIN)
+            hand[kept++] = card_index;
+        else if (keywords & LRG_CARD_KEYWORD_ETHEREAL)
+            state_exhaust (state)[state->n_exhaust++] = card_index;
+        else
+            state_discard (state)[state->n_discard++] = card_index;
+    }
+    state->n_hand = (guint16)kept;
+
+    decay_statuses (self, &state->player);
+
+    for (i = 0; i < self->n_enemies; i++)
+    {
+        if (!enemy_alive (state, i))
+            continue;
+
+        state->enemies[i].block = 0;
+        execute_intent (state, i);
+        decay_statuses (self, &state->enemies[i]);
+        decide_intent (state, i);
+
+        if (state->player.health <= 0)
+            break;
+    }
+
+    check_result (state);
+}
+
+/* ==========================================================================
+ * Policies
+ * ========================================================================== */
+
+/*
+ * Scores a position for the greedy policy: enemy health and block count
+ * against it, as does the damage the enemies' intents would get past
+ * the player's block. Energy and cards left over break ties.
+ */
+static gint
+evaluate (const LrgCombatSimState *state)
+{
+    const LrgCombatSimulator *self = state->sim;
+    gint incoming = 0;
+    gint score;
+    guint i;
+
+    if (state->result == LRG_COMBAT_RESULT_VICTORY)
+        return G_MAXINT / 2;
+
+    if (state->result == LRG_COMBAT_RESULT_DEFEAT)
+        return G_MININT / 2;
+
+    score = 3 * state->player.health + state->energy + state->n_hand;
+
+    for (i = 0; i < self->n_enemies; i++)
+    {
+        const SimIntent *intent;
+
+        if (!enemy_alive (state, i))
+            continue;
+
+        score -= 2 * (state->enemies[i].health + state->enemies[i].block);
+
+        if (state->intent[i] == NO_INTENT)
+            continue;
+
+        intent = &g_array_index (self->intents, SimIntent, state->intent[i]);
+        if (intent->type == LRG_INTENT_ATTACK ||
+            intent->type == LRG_INTENT_ATTACK_BUFF ||
+            intent->type == LRG_INTENT_ATTACK_DEBUFF)
+        {
+            incoming += intent->times * calculate_damage (intent->damage,
+                                                          &state->enemies[i],
+                                                          &state->player);
+        }
+    }
+
+    return score - 3 * MAX (0, incoming - state->player.block);
+}
+
+static gint
+choose_random (LrgCombatSimState *state,
+               guint             *target)
+{
+    const LrgCombatSimulator *self = state->sim;
+    guint playable[G_MAXUINT8 + 1];
+    guint n_playable = 0;
+    guint alive[MAX_ENEMIES];
+    guint n_alive = 0;
+    guint i;
+
+    for (i = 0; i < state->n_hand && n_playable < G_N_ELEMENTS (playable); i++)
+    {
+        if (can_play (state, i))
+            playable[n_playable++] = i;
+    }
+
+    if (n_playable == 0)
+        return -1;
+
+    for (i = 0; i < self->n_enemies; i++)
+    {
+        if (enemy_alive (state, i))
+            alive[n_alive++] = i;
+    }
+
+    *target = n_alive > 0 ? alive[sim_random_range (state, n_alive)] : 0;
+
+    return (gint)playable[sim_random_range (state, n_playable)];
+}
+
+static gint
+choose_greedy (LrgCombatSimState *state,
+               LrgCombatSimState *scratch,
+               guint             *target)
+{
+    const LrgCombatSimulator *self = state->sim;
+    gint best_score;
+    gint best = -1;
+    guint i;
+
+    best_score = evaluate (state);
+
+    for (i = 0; i < state->n_hand; i++)
+    {
+        const SimCard *card;
+        guint n_targets;
+        guint t;
+
+        if (!can_play (state, i))
+            continue;
+
+        /* Only single-target cards care which enemy is chosen */
+        card = sim_card (self, state_hand (state)[i]);
+        n_targets = card->target == LRG_CARD_TARGET_SINGLE_ENEMY ? self->n_enemies : 1;
+
+        for (t = 0; t < n_targets; t++)
+        {
+            gint score;
+
+            if (n_targets > 1 && !enemy_alive (state, t))
+                continue;
+
+            memcpy (scratch, state, self->state_size);
+            play_card (scratch, i, t);
+            score = evaluate (scratch);
+
+            if (score > best_score)
+            {
+                best_score = score;
+                best = (gint)i;
+                *target = t;
+            }
+        }
+    }
+
+    return best;
+}
+
+static void
+play_turn (LrgCombatSimState *state,
+           LrgCombatSimState *scratch)
+{
+    const LrgCombatSimulator *self = state->sim;
+    guint plays;
+
+    for (plays = 0; plays < MAX_PLAYS_PER_TURN; plays++)
+    {
+        guint target = 0;
+        gint index;
+
+        switch (self->policy)
+        {
+        case LRG_COMBAT_SIM_POLICY_RANDOM:
+            index = choose_random (state, &target);
+            break;
+        case LRG_COMBAT_SIM_POLICY_GREEDY:
+            index = choose_greedy (state, scratch, &target);
+            break;
+        case LRG_COMBAT_SIM_POLICY_SCRIPTED:
+            index = self->policy_func != NULL
+                    ? self->policy_func (state, &target, self->policy_data)
+                    : -1;
+            break;
+        default:
+            index = -1;
+            break;
+        }
+
+        if (index < 0 || !can_play (state, (guint)index))
+            return;
+
+        play_card (state, (guint)index, target);
+
+        if (state->result != LRG_COMBAT_RESULT_IN_PROGRESS)
+            return;
+    }
+}
+
+/* ==========================================================================
+ * Playouts
+ * ========================================================================== */
+
+typedef struct
+{
+    guint8  result;
+    guint16 turns;
+    gint    damage_taken;
+    gint    damage_dealt;
+} CombatOutcome;
+
+static void
+play_combat (const LrgCombatSimulator *self,
+             LrgCombatSimState        *state,
+             LrgCombatSimState        *scratch,
+             guint32                   seed,
+             guint                    index,
+             CombatOutcome            *outcome)
+{
+    guint i;
+
+    memcpy (state, self->initial, self->state_size);
+    state->rng = ((guint64)seed << 32) ^ ((guint64)index * G_GUINT64_CONSTANT (0xD1B54A32D192ED03));
+
+    if (self->from_setup)
+    {
+        shuffle (state, state_draw (state), state->n_draw);
+        for (i = 0; i < self->n_enemies; i++)
+            decide_intent (state, i);
+    }
+    else
+    {
+        for (i = 0; i < self->n_enemies; i++)
+        {
+            if (state->intent[i] == NO_INTENT)
+                decide_intent (state, i);
+        }
+    }
+
+    check_result (state);
+
+    if (self->from_setup && state->result == LRG_COMBAT_RESULT_IN_PROGRESS)
+        start_player_turn (state);
+
+    while (state->result == LRG_COMBAT_RESULT_IN_PROGRESS)
+    {
+        play_turn (state, scratch);
+        if (state->result != LRG_COMBAT_RESULT_IN_PROGRESS)
+            break;
+
+        end_player_turn (state);
+        if (state->result != LRG_COMBAT_RESULT_IN_PROGRESS ||
+            (guint)state->turn >= self->max_turns)
+            break;
+
+        start_player_turn (state);
+    }
+
+    outcome->result = (guint8)state->result;
+    outcome->turns = (guint16)MIN (state->turn, G_MAXUINT16);
+    outcome->damage_taken = MAX (0, self->initial->player.health - state->player.health);
+    outcome->damage_dealt = state->damage_dealt;
+}
+
+typedef struct
+{
+    const LrgCombatSimulator *self;
+    CombatOutcome            *outcomes;
+    guint32                   seed;
+    guint                     first;
+    guint                     last;
+} RunChunk;
+
+static void
+run_chunk (gpointer data,
+           gpointer user_data)
+{
+    RunChunk *chunk = data;
+    LrgCombatSimState *state;
+    LrgCombatSimState *scratch;
+    guint i;
+
+    (void)user_data;
+
+    state = g_malloc (chunk->self->state_size);
+    scratch = g_malloc (chunk->self->state_size);
+
+    for (i = chunk->first; i < chunk->last; i++)
+        play_combat (chunk->self, state, scratch, chunk->seed, i, &chunk->outcomes[i]);
+
+    g_free (state);
+    g_free (scratch);
+}
+
+/* ==========================================================================
+ * Compiling the snapshot
+ * ========================================================================== */
+
+static void
+sim_card_clear (gpointer data)
+{
+    SimCard *card = data;
+
+    g_clear_object (&card->def);
+}
+
+static void
+sim_intent_clear (gpointer data)
+{
+    SimIntent *intent = data;
+
+    g_clear_pointer (&intent->intent, lrg_enemy_intent_free);
+}
+
+static gboolean
+intern_status (LrgCombatSimulator  *self,
+               const gchar         *status_id,
+               guint8              *out_slot,
+               GError             **error)
+{
+    LrgStatusEffectDef *def;
+    guint slot;
+    guint i;
+
+    for (i = 0; i < self->statuses->len; i++)
+    {
+        if (g_strcmp0 (g_ptr_array_index (self->statuses, i), status_id) == 0)
+        {
+            *out_slot = (guint8)i;
+            return TRUE;
+        }
+    }
+
+    if (self->statuses->len >= MAX_STATUSES)
+    {
+        g_set_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_FAILED,
+                     "Cannot simulate more than %d different statuses", MAX_STATUSES);
+        return FALSE;
+    }
+
+    /* Unregistered debuffs of the combat rules wear off like duration statuses */
+    slot = self->statuses->len;
+    def = lrg_status_effect_registry_lookup (lrg_status_effect_registry_get_default (),
+                                             status_id);
+    if (def != NULL)
+        self->decays[slot] = lrg_status_effect_def_get_stack_behavior (def) == LRG_STATUS_STACK_DURATION;
+    else
+        self->decays[slot] = slot >= STATUS_WEAK && slot <= STATUS_INTANGIBLE;
+
+    *out_slot = (guint8)slot;
+    g_ptr_array_add (self->statuses, g_strdup (status_id));
+
+    return TRUE;
+}
+
+static gboolean
+compile_effect (LrgCombatSimulator  *self,
+                LrgCardEffect       *effect,
+                const SimCard       *card,
+                GArray              *effects,
+                GError             **error)
+{
+    const gchar *type;
+    SimEffect sim = { 0 };
+    gint target;
+
+    type = lrg_card_effect_get_effect_type (effect);
+
+    target = lrg_card_effect_get_target_type (effect);
+    target = lrg_card_effect_get_param_int (effect, "target", target);
+    if (target == LRG_CARD_TARGET_NONE)
+        target = card->target;
+
+    sim.target = (guint8)target;
+    sim.flags = (guint8)lrg_card_effect_get_flags (effect);
+    sim.times = 1;
+
+    if (g_strcmp0 (type, "damage") == 0)
+    {
+        sim.op = OP_DAMAGE;
+        sim.amount = lrg_card_effect_get_param_int (effect, "amount", 0);
+        sim.times = lrg_card_effect_get_param_int (effect, "times", 1);
+    }
+    else if (g_strcmp0 (type, "block") == 0)
+    {
+        sim.op = OP_BLOCK;
+        sim.amount = lrg_card_effect_get_param_int (effect, "amount", 0);
+    }
+    else if (g_strcmp0 (type, "draw") == 0)
+    {
+        sim.op = OP_DRAW;
+        sim.amount = lrg_card_effect_get_param_int (effect, "count",
+                         lrg_card_effect_get_param_int (effect, "amount", 0));
+    }
+    else if (g_strcmp0 (type, "apply_status") == 0 || g_strcmp0 (type, "apply-status") == 0)
+    {
+        const gchar *status_id;
+
+        status_id = lrg_card_effect_get_param_string (effect, "status",
+                        lrg_card_effect_get_param_string (effect, "status_id", NULL));
+        if (status_id == NULL)
+        {
+            g_set_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_FAILED,
+                         "Card '%s' applies a status without naming it",
+                         lrg_card_def_get_id (card->def));
+            return FALSE;
+        }
+
+        if (!intern_status (self, status_id, &sim.status, error))
+            return FALSE;
+
+        sim.op = OP_STATUS;
+        sim.amount = lrg_card_effect_get_param_int (effect, "stacks",
+                         lrg_card_effect_get_param_int (effect, "amount", 0));
+    }
+    else if (g_strcmp0 (type, "heal") == 0)
+    {
+        sim.op = OP_HEAL;
+        sim.amount = lrg_card_effect_get_param_int (effect, "amount", 0);
+    }
+    else if (g_strcmp0 (type, "energy") == 0)
+    {
+        sim.op = OP_ENERGY;
+        sim.amount = lrg_card_effect_get_param_int (effect, "amount", 0);
+    }
+    else
+    {
+        g_set_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_EXECUTOR_NOT_FOUND,
+                     "Cannot simulate effect '%s' of card '%s'",
+                     type, lrg_card_def_get_id (card->def));
+        return FALSE;
+    }
+
+    g_array_append_val (effects, sim);
+    return TRUE;
+}
+
+static gboolean
+compile_card (LrgCombatSimulator  *self,
+              LrgCardInstance     *instance,
+              GArray              *cards,
+              GArray              *effects,
+              GError             **error)
+{
+    SimCard card = { 0 };
+    GPtrArray *card_effects;
+    guint i;
+
+    if (cards->len >= G_MAXUINT16)
+    {
+        g_set_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_DECK_TOO_LARGE,
+                     "Cannot simulate more than %d cards", G_MAXUINT16);
+        return FALSE;
+    }
+
+    card.def = lrg_card_instance_get_def (instance);
+    card.cost = lrg_card_instance_get_effective_cost (instance, NULL);
+    card.keywords = lrg_card_instance_get_all_keywords (instance);
+    card.target = (guint8)lrg_card_def_get_target_type (card.def);
+    card.first_effect = effects->len;
+
+    card_effects = lrg_card_def_get_effects (card.def);
+    for (i = 0; card_effects != NULL && i < card_effects->len; i++)
+    {
+        if (!compile_effect (self, g_ptr_array_index (card_effects, i), &card, effects, error))
+            return FALSE;
+    }
+
+    card.n_effects = effects->len - card.first_effect;
+    g_object_ref (card.def);
+    g_array_append_val (cards, card);
+
+    return TRUE;
+}
+
+static gboolean
+compile_pile (LrgCombatSimulator  *self,
+              GPtrArray           *pile,
+              GArray              *cards,
+              GArray              *effects,
+              GError             **error)
+{
+    guint i;
+
+    for (i = 0; i < pile->len; i++)
+    {
+        if (!compile_card (self, g_ptr_array_index (pile, i), cards, effects, error))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static gboolean
+compile_intent (LrgCombatSimulator    *self,
+                const LrgEnemyIntent  *intent,
+                guint16               *out_index,
+                GError               **error)
+{
+    SimIntent sim = { 0 };
+
+    if (self->intents->len >= NO_INTENT)
+    {
+        g_set_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_FAILED,
+                     "Cannot simulate more than %d enemy intents", NO_INTENT);
+        return FALSE;
+    }
+
+    sim.type = (guint8)lrg_enemy_intent_get_intent_type (intent);
+    sim.damage = lrg_enemy_intent_get_damage (intent);
+    sim.times = MAX (1, lrg_enemy_intent_get_times (intent));
+    sim.block = lrg_enemy_intent_get_block (intent);
+    sim.stacks = lrg_enemy_intent_get_stacks (intent);
+
+    if (lrg_enemy_intent_get_status_id (intent) != NULL &&
+        !intern_status (self, lrg_enemy_intent_get_status_id (intent), &sim.status, error))
+        return FALSE;
+
+    sim.intent = lrg_enemy_intent_copy (intent);
+    *out_index = (guint16)self->intents->len;
+    g_array_append_val (self->intents, sim);
+
+    return TRUE;
+}
+
+static gboolean
+compile_enemy (LrgCombatSimulator  *self,
+               LrgEnemyInstance    *instance,
+               guint                index,
+               GError             **error)
+{
+    LrgEnemyDef *def;
+    SimEnemy *enemy = &self->enemies[index];
+    guint n_patterns;
+    guint i;
+
+    def = lrg_enemy_instance_get_def (instance);
+    n_patterns = def != NULL ? lrg_enemy_def_get_intent_pattern_count (def) : 0;
+
+    enemy->first_pattern = self->patterns->len;
+    enemy->n_patterns = n_patterns;
+    enemy->total_weight = 0;
+
+    for (i = 0; i < n_patterns; i++)
+    {
+        SimPattern pattern;
+        const LrgEnemyIntent *intent;
+
+        intent = lrg_enemy_def_get_intent_pattern (def, i, &pattern.weight);
+        if (!compile_intent (self, intent, &pattern.intent, error))
+            return FALSE;
+
+        enemy->total_weight += pattern.weight;
+        g_array_append_val (self->patterns, pattern);
+    }
+
+    return TRUE;
+}
+
+static void
+snapshot_fighter (LrgCombatSimulator *self,
+                  LrgCombatant       *combatant,
+                  SimFighter         *fighter)
+{
+    guint i;
+
+    memset (fighter, 0, sizeof (SimFighter));
+    fighter->health = lrg_combatant_get_current_health (combatant);
+    fighter->max_health = lrg_combatant_get_max_health (combatant);
+    fighter->block = lrg_combatant_get_block (combatant);
+
+    for (i = 0; i < self->statuses->len; i++)
+    {
+        gint stacks = lrg_combatant_get_status_stacks (combatant,
+                                                       g_ptr_array_index (self->statuses, i));
+
+        fighter->status[i] = (gint16)CLAMP (stacks, 0, G_MAXINT16);
+    }
+}
+
+/* Allocates a state for @n_cards cards, copying the combatants of @from */
+static LrgCombatSimState *
+state_new (LrgCombatSimulator      *self,
+           guint                    n_cards,
+           const LrgCombatSimState *from)
+{
+    LrgCombatSimState *state;
+
+    self->state_size = G_STRUCT_OFFSET (LrgCombatSimState, cards) + 4 * n_cards * sizeof (guint16);
+    state = g_malloc0 (self->state_size);
+    state->sim = self;
+    state->result = LRG_COMBAT_RESULT_IN_PROGRESS;
+
+    if (from != NULL)
+    {
+        memcpy (state->intent, from->intent, sizeof (state->intent));
+        state->player = from->player;
+        memcpy (state->enemies, from->enemies, sizeof (state->enemies));
+    }
+
+    return state;
+}
+
+/* ==========================================================================
+ * GObject
+ * ========================================================================== */
+
+static void
+lrg_combat_simulator_finalize (GObject *object)
+{
+    LrgCombatSimulator *self = LRG_COMBAT_SIMULATOR (object);
+
+    if (self->policy_destroy != NULL)
+        self->policy_destroy (self->policy_data);
+
+    g_array_unref (self->cards);
+    g_array_unref (self->effects);
+    g_array_unref (self->intents);
+    g_array_unref (self->patterns);
+    g_ptr_array_unref (self->statuses);
+    g_free (self->initial);
+
+    G_OBJECT_CLASS (lrg_combat_simulator_parent_class)->finalize (object);
+}
+
+static void
+lrg_combat_simulator_get_property (GObject    *object,
+                                   guint       prop_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+    LrgCombatSimulator *self = LRG_COMBAT_SIMULATOR (object);
+
+    switch (prop_id)
+    {
+    case PROP_POLICY:
+        g_value_set_enum (value, self->policy);
+        break;
+    case PROP_MAX_TURNS:
+        g_value_set_uint (value, self->max_turns);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+lrg_combat_simulator_set_property (GObject      *object,
+                                   guint         prop_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+    LrgCombatSimulator *self = LRG_COMBAT_SIMULATOR (object);
+
+    switch (prop_id)
+    {
+    case PROP_POLICY:
+        lrg_combat_simulator_set_policy (self, g_value_get_enum (value));
+        break;
+    case PROP_MAX_TURNS:
+        lrg_combat_simulator_set_max_turns (self, g_value_get_uint (value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+lrg_combat_simulator_class_init (LrgCombatSimulatorClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = lrg_combat_simulator_finalize;
+    object_class->get_property = lrg_combat_simulator_get_property;
+    object_class->set_property = lrg_combat_simulator_set_property;
+
+    /**
+     * LrgCombatSimulator:policy:
+     *
+     * How simulated combats choose the cards to play.
+     *
+     * Since: 1.0
+     */
+    properties[PROP_POLICY] =
+        g_param_spec_enum ("policy",
+                           "Policy",
+                           "How cards are chosen",
+                           LRG_TYPE_COMBAT_SIM_POLICY,
+                           LRG_COMBAT_SIM_POLICY_GREEDY,
+                           G_PARAM_READWRITE |
+                           G_PARAM_EXPLICIT_NOTIFY |
+                           G_PARAM_STATIC_STRINGS);
+
+    /**
+     * LrgCombatSimulator:max-turns:
+     *
+     * The turn after which undecided combats stop.
+     *
+     * Since: 1.0
+     */
+    properties[PROP_MAX_TURNS] =
+        g_param_spec_uint ("max-turns",
+                           "Max Turns",
+                           "Turn limit per combat",
+                           1, G_MAXUINT16, DEFAULT_MAX_TURNS,
+                           G_PARAM_READWRITE |
+                           G_PARAM_EXPLICIT_NOTIFY |
+                           G_PARAM_STATIC_STRINGS);
+
+    g_object_class_install_properties (object_class, N_PROPS, properties);
+}
+
+static void
+lrg_combat_simulator_init (LrgCombatSimulator *self)
+{
+    self->cards = g_array_new (FALSE, TRUE, sizeof (SimCard));
+    g_array_set_clear_func (self->cards, sim_card_clear);
+    self->effects = g_array_new (FALSE, TRUE, sizeof (SimEffect));
+    self->intents = g_array_new (FALSE, TRUE, sizeof (SimIntent));
+    g_array_set_clear_func (self->intents, sim_intent_clear);
+    self->patterns = g_array_new (FALSE, TRUE, sizeof (SimPattern));
+    self->statuses = g_ptr_array_new_with_free_func (g_free);
+    self->policy = LRG_COMBAT_SIM_POLICY_GREEDY;
+    self->max_turns = DEFAULT_MAX_TURNS;
+}
+
+/* ==========================================================================
+ * Public API
+ * ========================================================================== */
+
+LrgCombatSimulator *
+lrg_combat_simulator_new (LrgCombatContext  *context,
+                          GError           **error)
+{
+    g_autoptr(LrgCombatSimulator) self = NULL;
+    g_autoptr(GArray) cards = NULL;
+    g_autoptr(GArray) effects = NULL;
+    LrgCombatRules *rules;
+    LrgPlayerCombatant *player;
+    GPtrArray *enemies;
+    LrgCardPile *piles[3];
+    LrgCombatSimState *state;
+    guint16 current_intents[MAX_ENEMIES];
+    guint n_cards;
+    guint16 *dest;
+    guint offset;
+    guint i;
+    guint p;
+
+    g_return_val_if_fail (LRG_IS_COMBAT_CONTEXT (context), NULL);
+    g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+    self = g_object_new (LRG_TYPE_COMBAT_SIMULATOR, NULL);
+
+    enemies = lrg_combat_context_get_enemies (context);
+    if (enemies->len > MAX_ENEMIES)
+    {
+        g_set_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_FAILED,
+                     "Cannot simulate more than %d enemies", MAX_ENEMIES);
+        return NULL;
+    }
+
+    for (i = 0; i < N_RULE_STATUSES; i++)
+    {
+        guint8 slot;
+
+        intern_status (self, rule_statuses[i], &slot, NULL);
+    }
+
+    /* Intents first: their statuses must be interned before the snapshot */
+    self->n_enemies = enemies->len;
+    for (i = 0; i < enemies->len; i++)
+    {
+        LrgEnemyInstance *enemy = g_ptr_array_index (enemies, i);
+        const LrgEnemyIntent *intent = lrg_enemy_instance_get_intent (enemy);
+
+        if (!compile_enemy (self, enemy, i, error))
+            return NULL;
+
+        /* The current intent may use a status no pattern does */
+        current_intents[i] = NO_INTENT;
+        if (intent != NULL && !compile_intent (self, intent, &current_intents[i], error))
+            return NULL;
+    }
+
+    cards = g_array_new (FALSE, TRUE, sizeof (SimCard));
+    g_array_set_clear_func (cards, sim_card_clear);
+    effects = g_array_new (FALSE, TRUE, sizeof (SimEffect));
+
+    piles[0] = lrg_combat_context_get_draw_pile (context);
+    piles[1] = lrg_combat_context_get_discard_pile (context);
+    piles[2] = lrg_combat_context_get_exhaust_pile (context);
+
+    if (!compile_pile (self, lrg_card_pile_get_cards (piles[0]), cards, effects, error) ||
+        !compile_pile (self, lrg_hand_get_cards (lrg_combat_context_get_hand (context)),
+                       cards, effects, error) ||
+        !compile_pile (self, lrg_card_pile_get_cards (piles[1]), cards, effects, error) ||
+        !compile_pile (self, lrg_card_pile_get_cards (piles[2]), cards, effects, error))
+        return NULL;
+
+    g_array_unref (self->cards);
+    g_array_unref (self->effects);
+    self->cards = g_steal_pointer (&cards);
+    self->effects = g_steal_pointer (&effects);
+    n_cards = self->cards->len;
+
+    rules = lrg_combat_context_get_rules (context);
+    player = lrg_combat_context_get_player (context);
+    if (rules != NULL)
+    {
+        self->energy_per_turn = lrg_combat_rules_get_energy_per_turn (rules, LRG_COMBATANT (player));
+        self->cards_per_turn = lrg_combat_rules_get_cards_per_turn (rules, LRG_COMBATANT (player));
+    }
+    else
+    {
+        self->energy_per_turn = 3;
+        self->cards_per_turn = 5;
+    }
+    self->hand_limit = lrg_hand_get_max_size (lrg_combat_context_get_hand (context));
+    self->from_setup = lrg_combat_context_get_phase (context) == LRG_COMBAT_PHASE_SETUP;
+
+    state = state_new (self, n_cards, NULL);
+    snapshot_fighter (self, LRG_COMBATANT (player), &state->player);
+
+    for (i = 0; i < self->n_enemies; i++)
+    {
+        snapshot_fighter (self, LRG_COMBATANT (g_ptr_array_index (enemies, i)),
+                          &state->enemies[i]);
+        state->intent[i] = current_intents[i];
+    }
+
+    /* Cards were compiled pile by pile: draw, hand, discard, exhaust */
+    offset = 0;
+    for (p = 0; p < 4; p++)
+    {
+        guint count;
+
+        if (p == 0)
+        {
+            count = lrg_card_pile_get_count (piles[0]);
+            dest = state_draw (state);
+            state->n_draw = (guint16)count;
+        }
+        else if (p == 1)
+        {
+            count = lrg_hand_get_count (lrg_combat_context_get_hand (context));
+            dest = state_hand (state);
+            state->n_hand = (guint16)count;
+        }
+        else if (p == 2)
+        {
+            count = lrg_card_pile_get_count (piles[1]);
+            dest = state_discard (state);
+            state->n_discard = (guint16)count;
+        }
+        else
+        {
+            count = lrg_card_pile_get_count (piles[2]);
+            dest = state_exhaust (state);
+            state->n_exhaust = (guint16)count;
+        }
+
+        for (i = 0; i < count; i++)
+            dest[i] = (guint16)(offset + i);
+        offset += count;
+    }
+
+    state->turn = lrg_combat_context_get_turn (context);
+    state->energy = lrg_combat_context_get_energy (context);
+    self->initial = state;
+
+    return g_steal_pointer (&self);
+}
+
+gboolean
+lrg_combat_simulator_set_deck (LrgCombatSimulator  *self,
+                               GPtrArray           *cards,
+                               GError             **error)
+{
+    g_autoptr(GArray) sim_cards = NULL;
+    g_autoptr(GArray) effects = NULL;
+    LrgCombatSimState *state;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_COMBAT_SIMULATOR (self), FALSE);
+    g_return_val_if_fail (cards != NULL, FALSE);
+    g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+    sim_cards = g_array_new (FALSE, TRUE, sizeof (SimCard));
+    g_array_set_clear_func (sim_cards, sim_card_clear);
+    effects = g_array_new (FALSE, TRUE, sizeof (SimEffect));
+
+    if (!compile_pile (self, cards, sim_cards, effects, error))
+        return FALSE;
+
+    g_array_unref (self->cards);
+    g_array_unref (self->effects);
+    self->cards = g_steal_pointer (&sim_cards);
+    self->effects = g_steal_pointer (&effects);
+
+    state = state_new (self, self->cards->len, self->initial);
+    for (i = 0; i < self->cards->len; i++)
+        state_draw (state)[i] = (guint16)i;
+    state->n_draw = (guint16)self->cards->len;
+
+    g_free (self->initial);
+    self->initial = state;
+    self->from_setup = TRUE;
+
+    return TRUE;
+}
+
+LrgCombatSimPolicy
+lrg_combat_simulator_get_policy (LrgCombatSimulator *self)
+{
+    g_return_val_if_fail (LRG_IS_COMBAT_SIMULATOR (self), LRG_COMBAT_SIM_POLICY_GREEDY);
+    return self->policy;
+}
+
+void
+lrg_combat_simulator_set_policy (LrgCombatSimulator *self,
+                                 LrgCombatSimPolicy  policy)
+{
+    g_return_if_fail (LRG_IS_COMBAT_SIMULATOR (self));
+    g_return_if_fail (policy != LRG_COMBAT_SIM_POLICY_SCRIPTED || self->policy_func != NULL);
+
+    if (self->policy == policy)
+        return;
+
+    self->policy = policy;
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_POLICY]);
+}
+
+void
+lrg_combat_simulator_set_policy_func (LrgCombatSimulator     *self,
+                                      LrgCombatSimPolicyFunc  func,
+                                      gpointer                user_data,
+                                      GDestroyNotify          destroy)
+{
+    g_return_if_fail (LRG_IS_COMBAT_SIMULATOR (self));
+    g_return_if_fail (func != NULL);
+
+    if (self->policy_destroy != NULL)
+        self->policy_destroy (self->policy_data);
+
+    self->policy_func = func;
+    self->policy_data = user_data;
+    self->policy_destroy = destroy;
+
+    lrg_combat_simulator_set_policy (self, LRG_COMBAT_SIM_POLICY_SCRIPTED);
+}
+
+guint
+lrg_combat_simulator_get_max_turns (LrgCombatSimulator *self)
+{
+    g_return_val_if_fail (LRG_IS_COMBAT_SIMULATOR (self), 0);
+    return self->max_turns;
+}
+
+void
+lrg_combat_simulator_set_max_turns (LrgCombatSimulator *self,
+                                    guint               max_turns)
+{
+    g_return_if_fail (LRG_IS_COMBAT_SIMULATOR (self));
+    g_return_if_fail (max_turns >= 1 && max_turns <= G_MAXUINT16);
+
+    if (self->max_turns == max_turns)
+        return;
+
+    self->max_turns = max_turns;
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MAX_TURNS]);
+}
+
+LrgCombatSimReport *
+lrg_combat_simulator_run (LrgCombatSimulator *self,
+                          guint               n_combats,
+                          guint32             seed,
+                          guint               max_threads)
+{
+    g_autofree CombatOutcome *outcomes = NULL;
+    g_autofree RunChunk *chunks = NULL;
+    LrgCombatSimReport *report;
+    GThreadPool *pool = NULL;
+    guint max_damage = 0;
+    guint n_chunks;
+    guint threads;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_COMBAT_SIMULATOR (self), NULL);
+
+    outcomes = g_new (CombatOutcome, MAX (n_combats, 1));
+
+    threads = max_threads != 0 ? max_threads : g_get_num_processors ();
+    n_chunks = n_combats < PARALLEL_MIN_COMBATS ? 1 : MIN (threads, n_combats);
+    n_chunks = MAX (n_chunks, 1);
+
+    chunks = g_new (RunChunk, n_chunks);
+    for (i = 0; i < n_chunks; i++)
+    {
+        chunks[i].self = self;
+        chunks[i].outcomes = outcomes;
+        chunks[i].seed = seed;
+        chunks[i].first = (guint)((guint64)n_combats * i / n_chunks);
+        chunks[i].last = (guint)((guint64)n_combats * (i + 1) / n_chunks);
+    }
+
+    if (n_chunks > 1)
+    {
+        pool = g_thread_pool_new (run_chunk, NULL, (gint)n_chunks - 1, FALSE, NULL);
+        for (i = 1; i < n_chunks; i++)
+            g_thread_pool_push (pool, &chunks[i], NULL);
+    }
+
+    run_chunk (&chunks[0], NULL);
+
+    if (pool != NULL)
+        g_thread_pool_free (pool, FALSE, TRUE);
+
+    /* Reduce in combat order so the report does not depend on threads */
+    report = g_new0 (LrgCombatSimReport, 1);
+    report->combats = n_combats;
+    report->n_turns = self->max_turns + 1;
+    report->turns_to_win = g_new0 (guint, report->n_turns);
+
+    for (i = 0; i < n_combats; i++)
+        max_damage = MAX (max_damage, (guint)outcomes[i].damage_taken);
+
+    report->n_damage = max_damage + 1;
+    report->damage_taken = g_new0 (guint, report->n_damage);
+
+    for (i = 0; i < n_combats; i++)
+    {
+        const CombatOutcome *outcome = &outcomes[i];
+
+        switch (outcome->result)
+        {
+        case LRG_COMBAT_RESULT_VICTORY:
+            report->wins++;
+            report->turns_to_win_total += outcome->turns;
+            report->turns_to_win[MIN (outcome->turns, report->n_turns - 1)]++;
+            break;
+        case LRG_COMBAT_RESULT_DEFEAT:
+            report->losses++;
+            break;
+        default:
+            report->timeouts++;
+            break;
+        }
+
+        report->damage_taken[outcome->damage_taken]++;
+        report->damage_taken_total += (guint)outcome->damage_taken;
+        report->damage_dealt_total += (guint)outcome->damage_dealt;
+    }
+
+    lrg_debug (LRG_LOG_DOMAIN_DECKBUILDER,
+               "Simulated %u combats: %u wins, %u losses, %u timeouts",
+               n_combats, report->wins, report->losses, report->timeouts);
+
+    return report;
+}
+
+/* ==========================================================================
+ * LrgCombatSimState
+ * ========================================================================== */
+
+gint
+lrg_combat_sim_state_get_turn (const LrgCombatSimState *state)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    return state->turn;
+}
+
+gint
+lrg_combat_sim_state_get_energy (const LrgCombatSimState *state)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    return state->energy;
+}
+
+gint
+lrg_combat_sim_state_get_player_health (const LrgCombatSimState *state)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    return state->player.health;
+}
+
+gint
+lrg_combat_sim_state_get_player_block (const LrgCombatSimState *state)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    return state->player.block;
+}
+
+guint
+lrg_combat_sim_state_get_hand_size (const LrgCombatSimState *state)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    return state->n_hand;
+}
+
+LrgCardDef *
+lrg_combat_sim_state_get_hand_card (const LrgCombatSimState *state,
+                                    guint                    index)
+{
+    g_return_val_if_fail (state != NULL, NULL);
+
+    if (index >= state->n_hand)
+        return NULL;
+
+    return sim_card (state->sim, state_hand ((LrgCombatSimState *)state)[index])->def;
+}
+
+gboolean
+lrg_combat_sim_state_can_play (const LrgCombatSimState *state,
+                               guint                    index)
+{
+    g_return_val_if_fail (state != NULL, FALSE);
+    return can_play (state, index);
+}
+
+guint
+lrg_combat_sim_state_get_enemy_count (const LrgCombatSimState *state)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    return state->sim->n_enemies;
+}
+
+gint
+lrg_combat_sim_state_get_enemy_health (const LrgCombatSimState *state,
+                                       guint                    index)
+{
+    g_return_val_if_fail (state != NULL, 0);
+    g_return_val_if_fail (index < state->sim->n_enemies, 0);
+
+    return state->enemies[index].health;
+}
+
+const LrgEnemyIntent *
+lrg_combat_sim_state_get_enemy_intent (const LrgCombatSimState *state,
+                                       guint                    index)
+{
+    g_return_val_if_fail (state != NULL, NULL);
+    g_return_val_if_fail (index < state->sim->n_enemies, NULL);
+
+    if (state->intent[index] == NO_INTENT)
+        return NULL;
+
+    return g_array_index (state->sim->intents, SimIntent, state->intent[index]).intent;
+}
+
+/* ==========================================================================
+ * LrgCombatSimReport
+ * ========================================================================== */
+
+LrgCombatSimReport *
+lrg_combat_sim_report_copy (const LrgCombatSimReport *self)
+{
+    LrgCombatSimReport *copy;
+
+    g_return_val_if_fail (self != NULL, NULL);
+
+    copy = g_memdup2 (self, sizeof (LrgCombatSimReport));
+    copy->turns_to_win = g_memdup2 (self->turns_to_win, self->n_turns * sizeof (guint));
+    copy->damage_taken = g_memdup2 (self->damage_taken, self->n_damage * sizeof (guint));
+
+    return copy;
+}
+
+void
+lrg_combat_sim_report_free (LrgCombatSimReport *self)
+{
+    if (self == NULL)
+        return;
+
+    g_free (self->turns_to_win);
+    g_free (self->damage_taken);
+    g_free (self);
+}
+
+guint
+lrg_combat_sim_report_get_combats (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0);
+    return self->combats;
+}
+
+guint
+lrg_combat_sim_report_get_wins (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0);
+    return self->wins;
+}
+
+guint
+lrg_combat_sim_report_get_losses (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0);
+    return self->losses;
+}
+
+guint
+lrg_combat_sim_report_get_timeouts (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0);
+    return self->timeouts;
+}
+
+gdouble
+lrg_combat_sim_report_get_win_rate (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0.0);
+
+    if (self->combats == 0)
+        return 0.0;
+
+    return (gdouble)self->wins / self->combats;
+}
+
+gdouble
+lrg_combat_sim_report_get_mean_turns_to_win (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0.0);
+
+    if (self->wins == 0)
+        return 0.0;
+
+    return (gdouble)self->turns_to_win_total / self->wins;
+}
+
+const guint *
+lrg_combat_sim_report_get_turns_to_win (const LrgCombatSimReport *self,
+                                        guint                    *n_turns)
+{
+    g_return_val_if_fail (self != NULL, NULL);
+    g_return_val_if_fail (n_turns != NULL, NULL);
+
+    *n_turns = self->n_turns;
+    return self->turns_to_win;
+}
+
+gdouble
+lrg_combat_sim_report_get_mean_damage_taken (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0.0);
+
+    if (self->combats == 0)
+        return 0.0;
+
+    return (gdouble)self->damage_taken_total / self->combats;
+}
+
+const guint *
+lrg_combat_sim_report_get_damage_taken (const LrgCombatSimReport *self,
+                                        guint                    *n_amounts)
+{
+    g_return_val_if_fail (self != NULL, NULL);
+    g_return_val_if_fail (n_amounts != NULL, NULL);
+
+    *n_amounts = self->n_damage;
+    return self->damage_taken;
+}
+
+gint
+lrg_combat_sim_report_get_damage_taken_percentile (const LrgCombatSimReport *self,
+                                                   gdouble                   percentile)
+{
+    guint64 needed;
+    guint64 seen = 0;
+    guint i;
+
+    g_return_val_if_fail (self != NULL, 0);
+
+    if (self->combats == 0)
+        return 0;
+
+    percentile = CLAMP (percentile, 0.0, 100.0);
+    needed = (guint64)ceil (percentile / 100.0 * self->combats);
+    needed = MAX (needed, 1);
+
+    for (i = 0; i < self->n_damage; i++)
+    {
+        seen += self->damage_taken[i];
+        if (seen >= needed)
+            return (gint)i;
+    }
+
+    return (gint)self->n_damage - 1;
+}
+
+gdouble
+lrg_combat_sim_report_get_mean_damage_dealt (const LrgCombatSimReport *self)
+{
+    g_return_val_if_fail (self != NULL, 0.0);
+
+    if (self->combats == 0)
+        return 0.0;
+
+    return (gdouble)self->damage_dealt_total / self->combats;
+}
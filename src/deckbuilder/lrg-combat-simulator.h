@@ -0,0 +1,526 @@
+/* lrg-combat-simulator.h
+ *
+ * Copyright 2025 Libregnum Authors
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Headless Monte Carlo combat simulation.
+ */
+
+#ifndef LRG_COMBAT_SIMULATOR_H
+#define LRG_COMBAT_SIMULATOR_H
+
+#include <glib-object.h>
+#include "../lrg-version.h"
+#include "../lrg-enums.h"
+#include "lrg-combat-context.h"
+#include "lrg-card-def.h"
+
+G_BEGIN_DECLS
+
+/**
+ * LrgCombatSimState:
+ *
+ * A simulated combat in progress, as seen by a #LrgCombatSimPolicyFunc.
+ * Only valid for the duration of the call.
+ *
+ * Since: 1.0
+ */
+typedef struct _LrgCombatSimState LrgCombatSimState;
+
+/**
+ * LrgCombatSimPolicyFunc:
+ * @state: the combat being played
+ * @target: (out): return location for the index of the enemy to target
+ * @user_data: user data
+ *
+ * Chooses the next card to play. Called from worker threads, several
+ * times at once, so it must not touch shared state without locking.
+ *
+ * Returns: the hand index of the card to play, or -1 to end the turn
+ *
+ * Since: 1.0
+ */
+typedef gint (*LrgCombatSimPolicyFunc) (const LrgCombatSimState *state,
+                                        guint                   *target,
+                                        gpointer                 user_data);
+
+/* LrgCombatSimState */
+
+/**
+ * lrg_combat_sim_state_get_turn:
+ * @state: a #LrgCombatSimState
+ *
+ * Returns: the current turn, starting at 1
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_combat_sim_state_get_turn (const LrgCombatSimState *state);
+
+/**
+ * lrg_combat_sim_state_get_energy:
+ * @state: a #LrgCombatSimState
+ *
+ * Returns: the energy left this turn
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_combat_sim_state_get_energy (const LrgCombatSimState *state);
+
+/**
+ * lrg_combat_sim_state_get_player_health:
+ * @state: a #LrgCombatSimState
+ *
+ * Returns: the player's current health
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_combat_sim_state_get_player_health (const LrgCombatSimState *state);
+
+/**
+ * lrg_combat_sim_state_get_player_block:
+ * @state: a #LrgCombatSimState
+ *
+ * Returns: the player's current block
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_combat_sim_state_get_player_block (const LrgCombatSimState *state);
+
+/**
+ * lrg_combat_sim_state_get_hand_size:
+ * @state: a #LrgCombatSimState
+ *
+ * Returns: the number of cards in hand
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_sim_state_get_hand_size (const LrgCombatSimState *state);
+
+/**
+ * lrg_combat_sim_state_get_hand_card:
+ * @state: a #LrgCombatSimState
+ * @index: hand index
+ *
+ * Gets the definition of a card in hand.
+ *
+ * Returns: (transfer none) (nullable): the card definition, or %NULL
+ *   if @index is out of range
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgCardDef *
+lrg_combat_sim_state_get_hand_card (const LrgCombatSimState *state,
+                                    guint                    index);
+
+/**
+ * lrg_combat_sim_state_can_play:
+ * @state: a #LrgCombatSimState
+ * @index: hand index
+ *
+ * Checks whether a card in hand is playable with the energy left.
+ *
+ * Returns: %TRUE if the card can be played
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_combat_sim_state_can_play (const LrgCombatSimState *state,
+                               guint                    index);
+
+/**
+ * lrg_combat_sim_state_get_enemy_count:
+ * @state: a #LrgCombatSimState
+ *
+ * Returns: the number of enemies, dead or alive
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_sim_state_get_enemy_count (const LrgCombatSimState *state);
+
+/**
+ * lrg_combat_sim_state_get_enemy_health:
+ * @state: a #LrgCombatSimState
+ * @index: enemy index
+ *
+ * Returns: the enemy's current health, 0 once it is dead
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_combat_sim_state_get_enemy_health (const LrgCombatSimState *state,
+                                       guint                    index);
+
+/**
+ * lrg_combat_sim_state_get_enemy_intent:
+ * @state: a #LrgCombatSimState
+ * @index: enemy index
+ *
+ * Gets the intent the enemy will carry out on its next turn.
+ *
+ * Returns: (transfer none) (nullable): the intent, or %NULL if the
+ *   enemy has none
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+const LrgEnemyIntent *
+lrg_combat_sim_state_get_enemy_intent (const LrgCombatSimState *state,
+                                       guint                    index);
+
+/* LrgCombatSimReport */
+
+#define LRG_TYPE_COMBAT_SIM_REPORT (lrg_combat_sim_report_get_type ())
+
+/**
+ * LrgCombatSimReport:
+ *
+ * Aggregated results of a batch of simulated combats.
+ *
+ * Since: 1.0
+ */
+typedef struct _LrgCombatSimReport LrgCombatSimReport;
+
+LRG_AVAILABLE_IN_ALL
+GType
+lrg_combat_sim_report_get_type (void) G_GNUC_CONST;
+
+/**
+ * lrg_combat_sim_report_copy:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: (transfer full): a copy of @self
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgCombatSimReport *
+lrg_combat_sim_report_copy (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_free:
+ * @self: a #LrgCombatSimReport
+ *
+ * Frees a report.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_combat_sim_report_free (LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_combats:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the number of combats simulated
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_sim_report_get_combats (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_wins:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the number of combats won
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_sim_report_get_wins (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_losses:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the number of combats lost
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_sim_report_get_losses (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_timeouts:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the number of combats still undecided after the turn limit
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_sim_report_get_timeouts (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_win_rate:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the fraction of combats won, from 0 to 1
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_combat_sim_report_get_win_rate (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_mean_turns_to_win:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the average number of turns of the combats won, or 0
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_combat_sim_report_get_mean_turns_to_win (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_turns_to_win:
+ * @self: a #LrgCombatSimReport
+ * @n_turns: (out): return location for the array length
+ *
+ * Gets how many combats were won on each turn: element @i counts the
+ * wins on turn @i.
+ *
+ * Returns: (array length=n_turns) (transfer none): the counts
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+const guint *
+lrg_combat_sim_report_get_turns_to_win (const LrgCombatSimReport *self,
+                                        guint                    *n_turns);
+
+/**
+ * lrg_combat_sim_report_get_mean_damage_taken:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the average health the player lost per combat
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_combat_sim_report_get_mean_damage_taken (const LrgCombatSimReport *self);
+
+/**
+ * lrg_combat_sim_report_get_damage_taken:
+ * @self: a #LrgCombatSimReport
+ * @n_amounts: (out): return location for the array length
+ *
+ * Gets the distribution of health lost: element @i counts the combats
+ * in which the player lost @i health.
+ *
+ * Returns: (array length=n_amounts) (transfer none): the counts
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+const guint *
+lrg_combat_sim_report_get_damage_taken (const LrgCombatSimReport *self,
+                                        guint                    *n_amounts);
+
+/**
+ * lrg_combat_sim_report_get_damage_taken_percentile:
+ * @self: a #LrgCombatSimReport
+ * @percentile: percentile from 0 to 100
+ *
+ * Gets the health lost in the given share of combats or fewer, so
+ * the 50th percentile is the median.
+ *
+ * Returns: the health lost
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_combat_sim_report_get_damage_taken_percentile (const LrgCombatSimReport *self,
+                                                   gdouble                   percentile);
+
+/**
+ * lrg_combat_sim_report_get_mean_damage_dealt:
+ * @self: a #LrgCombatSimReport
+ *
+ * Returns: the average health the enemies lost per combat
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_combat_sim_report_get_mean_damage_dealt (const LrgCombatSimReport *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (LrgCombatSimReport, lrg_combat_sim_report_free)
+
+/* LrgCombatSimulator */
+
+#define LRG_TYPE_COMBAT_SIMULATOR (lrg_combat_simulator_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgCombatSimulator, lrg_combat_simulator, LRG, COMBAT_SIMULATOR, GObject)
+
+/**
+ * lrg_combat_simulator_new:
+ * @context: the combat to snapshot
+ * @error: return location for a #GError
+ *
+ * Takes a snapshot of @context: the player, the enemies with their
+ * current intents and intent patterns, and every card in the draw
+ * pile, hand, discard and exhaust piles. A context still in
+ * %LRG_COMBAT_PHASE_SETUP is simulated from the start of combat;
+ * any other phase resumes in the middle of the current player turn.
+ *
+ * Cards are simulated from their effects, which must be of the types
+ * listed in the module documentation. Later changes to @context are
+ * not seen by the simulator.
+ *
+ * Returns: (transfer full) (nullable): a new #LrgCombatSimulator, or
+ *   %NULL if the combat uses effects that cannot be simulated
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgCombatSimulator *
+lrg_combat_simulator_new (LrgCombatContext  *context,
+                          GError           **error);
+
+/**
+ * lrg_combat_simulator_set_deck:
+ * @self: a #LrgCombatSimulator
+ * @cards: (element-type LrgCardInstance): the cards of the new deck
+ * @error: return location for a #GError
+ *
+ * Replaces the cards of the snapshot with @cards, all in the draw
+ * pile, and restarts the simulated combat from its setup. Use it to
+ * compare decks against the same encounter.
+ *
+ * Returns: %TRUE on success; on failure the deck is unchanged
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_combat_simulator_set_deck (LrgCombatSimulator  *self,
+                               GPtrArray           *cards,
+                               GError             **error);
+
+/**
+ * lrg_combat_simulator_get_policy:
+ * @self: a #LrgCombatSimulator
+ *
+ * Returns: how cards are chosen
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgCombatSimPolicy
+lrg_combat_simulator_get_policy (LrgCombatSimulator *self);
+
+/**
+ * lrg_combat_simulator_set_policy:
+ * @self: a #LrgCombatSimulator
+ * @policy: how cards are chosen
+ *
+ * Sets the built-in policy. %LRG_COMBAT_SIM_POLICY_SCRIPTED requires
+ * lrg_combat_simulator_set_policy_func() instead.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_combat_simulator_set_policy (LrgCombatSimulator *self,
+                                 LrgCombatSimPolicy  policy);
+
+/**
+ * lrg_combat_simulator_set_policy_func:
+ * @self: a #LrgCombatSimulator
+ * @func: (scope notified): the policy
+ * @user_data: (closure): user data for @func
+ * @destroy: (nullable): destroy notify for @user_data
+ *
+ * Chooses cards with @func and sets the policy to
+ * %LRG_COMBAT_SIM_POLICY_SCRIPTED.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_combat_simulator_set_policy_func (LrgCombatSimulator     *self,
+                                      LrgCombatSimPolicyFunc  func,
+                                      gpointer                user_data,
+                                      GDestroyNotify          destroy);
+
+/**
+ * lrg_combat_simulator_get_max_turns:
+ * @self: a #LrgCombatSimulator
+ *
+ * Returns: the turn after which undecided combats stop
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_combat_simulator_get_max_turns (LrgCombatSimulator *self);
+
+/**
+ * lrg_combat_simulator_set_max_turns:
+ * @self: a #LrgCombatSimulator
+ * @max_turns: turn limit, at least 1
+ *
+ * Sets the turn after which undecided combats stop and count as
+ * timeouts.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_combat_simulator_set_max_turns (LrgCombatSimulator *self,
+                                    guint               max_turns);
+
+/**
+ * lrg_combat_simulator_run:
+ * @self: a #LrgCombatSimulator
+ * @n_combats: number of combats to play
+ * @seed: base seed
+ * @max_threads: worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Plays @n_combats combats from the snapshot. Combat @i is seeded
+ * from @seed and @i alone, so the report depends only on the snapshot,
+ * the policy and @seed, whatever the number of threads.
+ *
+ * Returns: (transfer full): the aggregated results
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgCombatSimReport *
+lrg_combat_simulator_run (LrgCombatSimulator *self,
+                          guint               n_combats,
+                          guint32             seed,
+                          guint               max_threads);
+
+G_END_DECLS
+
+#endif /* LRG_COMBAT_SIMULATOR_H */
@@ -690,3 +690,59 @@ lrg_enemy_def_clear_intent_patterns (LrgEnemyDef *self)
     priv = lrg_enemy_def_get_instance_private (self);
     g_ptr_array_set_size (priv->patterns, 0);
 }
+
+/**
+ * lrg_enemy_def_get_intent_pattern_count:
+ * @self: an #LrgEnemyDef
+ *
+ * Gets the number of intents in the weighted selection pool.
+ *
+ * Returns: the number of intent patterns
+ *
+ * Since: 1.0
+ */
+guint
+lrg_enemy_def_get_intent_pattern_count (LrgEnemyDef *self)
+{
+    LrgEnemyDefPrivate *priv;
+
+    g_return_val_if_fail (LRG_IS_ENEMY_DEF (self), 0);
+
+    priv = lrg_enemy_def_get_instance_private (self);
+    return priv->patterns->len;
+}
+
+/**
+ * lrg_enemy_def_get_intent_pattern:
+ * @self: an #LrgEnemyDef
+ * @index: pattern index
+ * @weight: (out) (optional): return location for the selection weight
+ *
+ * Gets an intent from the weighted selection pool.
+ *
+ * Returns: (transfer none) (nullable): the intent, or %NULL if @index
+ *   is out of range
+ *
+ * Since: 1.0
+ */
+const LrgEnemyIntent *
+lrg_enemy_def_get_intent_pattern (LrgEnemyDef *self,
+                                  guint        index,
+                                  gint        *weight)
+{
+    LrgEnemyDefPrivate *priv;
+    IntentPattern *pattern;
+
+    g_return_val_if_fail (LRG_IS_ENEMY_DEF (self), NULL);
+
+    priv = lrg_enemy_def_get_instance_private (self);
+
+    if (index >= priv->patterns->len)
+        return NULL;
+
+    pattern = g_ptr_array_index (priv->patterns, index);
+    if (weight != NULL)
+        *weight = pattern->weight;
+
+    return pattern->intent;
+}
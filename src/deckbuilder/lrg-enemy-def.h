@@ -242,6 +242,39 @@ LRG_AVAILABLE_IN_ALL
 void
 lrg_enemy_def_clear_intent_patterns (LrgEnemyDef *self);
 
+/**
+ * lrg_enemy_def_get_intent_pattern_count:
+ * @self: an #LrgEnemyDef
+ *
+ * Gets the number of intents in the weighted selection pool.
+ *
+ * Returns: the number of intent patterns
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_enemy_def_get_intent_pattern_count (LrgEnemyDef *self);
+
+/**
+ * lrg_enemy_def_get_intent_pattern:
+ * @self: an #LrgEnemyDef
+ * @index: pattern index
+ * @weight: (out) (optional): return location for the selection weight
+ *
+ * Gets an intent from the weighted selection pool.
+ *
+ * Returns: (transfer none) (nullable): the intent, or %NULL if @index
+ *   is out of range
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+const LrgEnemyIntent *
+lrg_enemy_def_get_intent_pattern (LrgEnemyDef *self,
+                                  guint        index,
+                                  gint        *weight);
+
 G_END_DECLS
 
 #endif /* LRG_ENEMY_DEF_H */
@@ -39,14 +39,19 @@
  * Since: 1.0
  */
 
+/*
+ * Rank layers: bit (rank - 1) of layer k is set when the rank appears
+ * more than k times. The last layer only tells six or more apart from
+ * exactly five, which ranks as nothing.
+ */
+#define N_RANK_LAYERS (6)
+#define ALL_RANKS     (0x1FFF)
+
 typedef struct
 {
     GPtrArray   *cards;          /* Current cards to evaluate */
     GPtrArray   *scoring_cards;  /* Cards that contribute to hand */
     LrgHandType  hand_type;      /* Result of last evaluation */
-    gint         rank_counts[14]; /* Count of each rank (1-13, 0 unused) */
-    gint         suit_counts[5];  /* Count of each suit */
-    gboolean     has_wild;        /* Whether any card is wild */
 } LrgScoringHandPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgScoringHand, lrg_scoring_hand, G_TYPE_OBJECT)
@@ -69,325 +74,238 @@ static const gint chip_values[] = {
     10   /* KING */
 };
 
-/* Forward declarations for helper functions */
-static void count_ranks_and_suits (LrgScoringHand *self);
-static gboolean check_flush (LrgScoringHand *self, LrgCardSuit *flush_suit);
-static gboolean check_straight (LrgScoringHand *self, gint *high_rank);
-static void find_scoring_cards_for_hand (LrgScoringHand *self, LrgHandType type);
-
-static void
-lrg_scoring_hand_finalize (GObject *object)
+/*
+ * Hand shape key, the index into hand_table:
+ * bit 0     a rank appears exactly five times
+ * bit 1     a rank appears exactly four times
+ * bit 2     a rank appears exactly three times
+ * bits 3-4  ranks appearing exactly twice: 0, 1, or 2 for two or more
+ * bits 5-6  straight kind from straight_table
+ * bit 7     flush
+ */
+#define KEY_FIVE           (1 << 0)
+#define KEY_FOUR           (1 << 1)
+#define KEY_THREE          (1 << 2)
+#define KEY_PAIRS_SHIFT    (3)
+#define KEY_STRAIGHT_SHIFT (5)
+#define KEY_FLUSH          (1 << 7)
+
+enum
 {
-    LrgScoringHand *self = LRG_SCORING_HAND (object);
-    LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
+    STRAIGHT_NONE,
+    STRAIGHT_LOW,       /* Any straight but 10-J-Q-K-A */
+    STRAIGHT_ACE_HIGH
+};
 
-    g_clear_pointer (&priv->cards, g_ptr_array_unref);
-    g_clear_pointer (&priv->scoring_cards, g_ptr_array_unref);
+/* Straight kind of every set of ranks, indexed by rank bitmask */
+static guint8 straight_table[ALL_RANKS + 1];
 
-    G_OBJECT_CLASS (lrg_scoring_hand_parent_class)->finalize (object);
-}
+/* Hand type of every hand shape key */
+static guint8 hand_table[1 << 8];
 
-static LrgHandType
-lrg_scoring_hand_real_evaluate (LrgScoringHand *self)
+static guint8
+classify_straight (guint ranks)
 {
-    LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
-    gint pairs = 0;
-    gint three_of_kind = 0;
-    gint four_of_kind = 0;
-    gint five_of_kind = 0;
-    gboolean is_flush = FALSE;
-    gboolean is_straight = FALSE;
-    LrgCardSuit flush_suit = LRG_CARD_SUIT_NONE;
-    gint straight_high = 0;
-    gint i;
-
-    if (priv->cards == NULL || priv->cards->len == 0)
-    {
-        priv->hand_type = LRG_HAND_TYPE_NONE;
-        return priv->hand_type;
-    }
+    guint run = 0x1F;
+    guint i;
 
-    /* Count ranks and suits */
-    count_ranks_and_suits (self);
+    /* Ace-high straight (10-J-Q-K-A), the only one counted as royal */
+    if ((ranks & 0x1E01) == 0x1E01)
+        return STRAIGHT_ACE_HIGH;
 
-    /* Count pairs, three of a kind, etc. */
-    for (i = 1; i <= 13; i++)
+    /* Five consecutive ranks, the ace playing low (A-2-3-4-5) */
+    for (i = 0; i + 5 <= 13; i++)
     {
-        switch (priv->rank_counts[i])
-        {
-        case 2:
-            pairs++;
-            break;
-        case 3:
-            three_of_kind++;
-            break;
-        case 4:
-            four_of_kind++;
-            break;
-        case 5:
-            five_of_kind++;
-            break;
-        }
+        if ((ranks & (run << i)) == (run << i))
+            return STRAIGHT_LOW;
     }
 
-    /* Check for flush and straight */
-    is_flush = check_flush (self, &flush_suit);
-    is_straight = check_straight (self, &straight_high);
-
-    /* Determine hand type (check from highest to lowest) */
-
-    /* Flush Five: 5 of a kind, all same suit */
-    if (five_of_kind > 0 && is_flush)
-    {
-        priv->hand_type = LRG_HAND_TYPE_FLUSH_FIVE;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+    return STRAIGHT_NONE;
+}
 
-    /* Flush House: full house, all same suit */
-    if (three_of_kind > 0 && pairs > 0 && is_flush)
-    {
-        priv->hand_type = LRG_HAND_TYPE_FLUSH_HOUSE;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+/* Checks from the strongest hand to the weakest */
+static LrgHandType
+classify_shape (guint key)
+{
+    gboolean five = (key & KEY_FIVE) != 0;
+    gboolean four = (key & KEY_FOUR) != 0;
+    gboolean three = (key & KEY_THREE) != 0;
+    guint pairs = (key >> KEY_PAIRS_SHIFT) & 0x3;
+    guint straight = (key >> KEY_STRAIGHT_SHIFT) & 0x3;
+    gboolean flush = (key & KEY_FLUSH) != 0;
+
+    if (five && flush)
+        return LRG_HAND_TYPE_FLUSH_FIVE;
+    if (three && pairs > 0 && flush)
+        return LRG_HAND_TYPE_FLUSH_HOUSE;
+    if (five)
+        return LRG_HAND_TYPE_FIVE_OF_A_KIND;
+    if (flush && straight == STRAIGHT_ACE_HIGH)
+        return LRG_HAND_TYPE_ROYAL_FLUSH;
+    if (flush && straight != STRAIGHT_NONE)
+        return LRG_HAND_TYPE_STRAIGHT_FLUSH;
+    if (four)
+        return LRG_HAND_TYPE_FOUR_OF_A_KIND;
+    if (three && pairs > 0)
+        return LRG_HAND_TYPE_FULL_HOUSE;
+    if (flush)
+        return LRG_HAND_TYPE_FLUSH;
+    if (straight != STRAIGHT_NONE)
+        return LRG_HAND_TYPE_STRAIGHT;
+    if (three)
+        return LRG_HAND_TYPE_THREE_OF_A_KIND;
+    if (pairs >= 2)
+        return LRG_HAND_TYPE_TWO_PAIR;
+    if (pairs == 1)
+        return LRG_HAND_TYPE_PAIR;
 
-    /* Five of a Kind */
-    if (five_of_kind > 0)
-    {
-        priv->hand_type = LRG_HAND_TYPE_FIVE_OF_A_KIND;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+    return LRG_HAND_TYPE_HIGH_CARD;
+}
 
-    /* Royal Flush: A-K-Q-J-10 of same suit */
-    if (is_flush && is_straight && straight_high == 14)
-    {
-        priv->hand_type = LRG_HAND_TYPE_ROYAL_FLUSH;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+static void
+ensure_tables (void)
+{
+    static gsize tables_ready = 0;
+    guint i;
 
-    /* Straight Flush */
-    if (is_flush && is_straight)
-    {
-        priv->hand_type = LRG_HAND_TYPE_STRAIGHT_FLUSH;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+    if (!g_once_init_enter (&tables_ready))
+        return;
 
-    /* Four of a Kind */
-    if (four_of_kind > 0)
-    {
-        priv->hand_type = LRG_HAND_TYPE_FOUR_OF_A_KIND;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+    for (i = 0; i < G_N_ELEMENTS (straight_table); i++)
+        straight_table[i] = classify_straight (i);
 
-    /* Full House */
-    if (three_of_kind > 0 && pairs > 0)
-    {
-        priv->hand_type = LRG_HAND_TYPE_FULL_HOUSE;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+    for (i = 0; i < G_N_ELEMENTS (hand_table); i++)
+        hand_table[i] = (guint8)classify_shape (i);
 
-    /* Flush */
-    if (is_flush)
-    {
-        priv->hand_type = LRG_HAND_TYPE_FLUSH;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+    g_once_init_leave (&tables_ready, 1);
+}
 
-    /* Straight */
-    if (is_straight)
-    {
-        priv->hand_type = LRG_HAND_TYPE_STRAIGHT;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+/* Packed card: rank in bits 0-3, suit in bits 4-6, bit 7 for wild */
+#define PACKED_RANK_MASK  (0x0F)
+#define PACKED_SUIT_SHIFT (4)
+#define PACKED_SUIT_MASK  (0x07)
+#define PACKED_WILD       (0x80)
 
-    /* Three of a Kind */
-    if (three_of_kind > 0)
-    {
-        priv->hand_type = LRG_HAND_TYPE_THREE_OF_A_KIND;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+typedef struct
+{
+    guint layers[N_RANK_LAYERS];
+    guint suit_counts[PACKED_SUIT_MASK + 1];
+    guint n_wild;
+} HandShape;
+
+static inline void
+hand_shape_add (HandShape *shape,
+                guint8     card)
+{
+    guint rank = card & PACKED_RANK_MASK;
+    gint k;
 
-    /* Two Pair */
-    if (pairs >= 2)
+    if (rank != 0 && rank <= LRG_CARD_RANK_KING)
     {
-        priv->hand_type = LRG_HAND_TYPE_TWO_PAIR;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
-    }
+        guint bit = 1u << (rank - 1);
 
-    /* Pair */
-    if (pairs == 1)
-    {
-        priv->hand_type = LRG_HAND_TYPE_PAIR;
-        find_scoring_cards_for_hand (self, priv->hand_type);
-        return priv->hand_type;
+        for (k = N_RANK_LAYERS - 1; k > 0; k--)
+            shape->layers[k] |= shape->layers[k - 1] & bit;
+        shape->layers[0] |= bit;
     }
 
-    /* High Card */
-    priv->hand_type = LRG_HAND_TYPE_HIGH_CARD;
-    find_scoring_cards_for_hand (self, priv->hand_type);
-    return priv->hand_type;
+    /* Wild cards count for every suit, making flushes easier to form */
+    if (card & PACKED_WILD)
+        shape->n_wild++;
+    else
+        shape->suit_counts[(card >> PACKED_SUIT_SHIFT) & PACKED_SUIT_MASK]++;
 }
 
-static void
-lrg_scoring_hand_class_init (LrgScoringHandClass *klass)
+static inline LrgHandType
+hand_shape_classify (const HandShape *shape)
 {
-    GObjectClass *object_class = G_OBJECT_CLASS (klass);
-
-    object_class->finalize = lrg_scoring_hand_finalize;
-
-    klass->evaluate = lrg_scoring_hand_real_evaluate;
+    const guint *layers = shape->layers;
+    guint max_suit;
+    guint pairs;
+    guint key;
+
+    max_suit = MAX (MAX (shape->suit_counts[1], shape->suit_counts[2]),
+                    MAX (shape->suit_counts[3], shape->suit_counts[4]));
+
+    /* Ranks appearing exactly twice, capped at two */
+    pairs = layers[1] & ~layers[2];
+    pairs = pairs == 0 ? 0 : (pairs & (pairs - 1)) == 0 ? 1 : 2;
+
+    key = pairs << KEY_PAIRS_SHIFT;
+    key |= (guint)straight_table[layers[0]] << KEY_STRAIGHT_SHIFT;
+    if (layers[4] & ~layers[5])
+        key |= KEY_FIVE;
+    if (layers[3] & ~layers[4])
+        key |= KEY_FOUR;
+    if (layers[2] & ~layers[3])
+        key |= KEY_THREE;
+    if (max_suit + shape->n_wild >= 5)
+        key |= KEY_FLUSH;
+
+    return (LrgHandType)hand_table[key];
 }
 
+/* Forward declarations for helper functions */
+static void find_scoring_cards_for_hand (LrgScoringHand *self, LrgHandType type);
+
 static void
-lrg_scoring_hand_init (LrgScoringHand *self)
+lrg_scoring_hand_finalize (GObject *object)
 {
+    LrgScoringHand *self = LRG_SCORING_HAND (object);
     LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
 
-    priv->cards = NULL;
-    priv->scoring_cards = g_ptr_array_new ();
-    priv->hand_type = LRG_HAND_TYPE_NONE;
-    priv->has_wild = FALSE;
+    g_clear_pointer (&priv->cards, g_ptr_array_unref);
+    g_clear_pointer (&priv->scoring_cards, g_ptr_array_unref);
+
+    G_OBJECT_CLASS (lrg_scoring_hand_parent_class)->finalize (object);
 }
 
 /*
- * Helper: Count the occurrence of each rank and suit
+ * Builds the shape of the hand in one pass over the cards, then looks
+ * the hand type up instead of testing every hand type in turn.
  */
-static void
-count_ranks_and_suits (LrgScoringHand *self)
+static LrgHandType
+lrg_scoring_hand_real_evaluate (LrgScoringHand *self)
 {
     LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
+    HandShape shape = { { 0 } };
     guint i;
 
-    /* Reset counts */
-    memset (priv->rank_counts, 0, sizeof (priv->rank_counts));
-    memset (priv->suit_counts, 0, sizeof (priv->suit_counts));
-    priv->has_wild = FALSE;
-
-    for (i = 0; i < priv->cards->len; i++)
+    if (priv->cards == NULL || priv->cards->len == 0)
     {
-        LrgCardInstance *card = g_ptr_array_index (priv->cards, i);
-        LrgCardDef *def = lrg_card_instance_get_def (card);
-        LrgCardRank rank = lrg_card_def_get_rank (def);
-        LrgCardSuit suit = lrg_card_def_get_suit (def);
-
-        if (rank > 0 && rank <= 13)
-            priv->rank_counts[rank]++;
-
-        if (suit > 0 && suit <= 4)
-            priv->suit_counts[suit]++;
-
-        /* Check for wild card enhancement.
-         * Wild cards count for all suits, making flushes easier to form.
-         */
-        if (lrg_card_def_has_tag (def, "wild"))
-        {
-            gint s;
-            priv->has_wild = TRUE;
-            for (s = 1; s <= 4; s++)
-            {
-                if (s != (gint)suit)
-                    priv->suit_counts[s]++;
-            }
-        }
+        priv->hand_type = LRG_HAND_TYPE_NONE;
+        return priv->hand_type;
     }
-}
 
-/*
- * Helper: Check if cards form a flush (5+ same suit)
- */
-static gboolean
-check_flush (LrgScoringHand *self, LrgCardSuit *flush_suit)
-{
-    LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
-    gint i;
+    for (i = 0; i < priv->cards->len; i++)
+        hand_shape_add (&shape, lrg_scoring_hand_pack_card (g_ptr_array_index (priv->cards, i)));
 
-    for (i = 1; i <= 4; i++)
-    {
-        if (priv->suit_counts[i] >= 5)
-        {
-            if (flush_suit != NULL)
-                *flush_suit = (LrgCardSuit)i;
-            return TRUE;
-        }
-    }
+    priv->hand_type = hand_shape_classify (&shape);
+    find_scoring_cards_for_hand (self, priv->hand_type);
 
-    return FALSE;
+    return priv->hand_type;
 }
 
-/*
- * Helper: Check if cards form a straight (5 consecutive ranks)
- */
-static gboolean
-check_straight (LrgScoringHand *self, gint *high_rank)
+static void
+lrg_scoring_hand_class_init (LrgScoringHandClass *klass)
 {
-    LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
-    gint consecutive = 0;
-    gint i;
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
-    /*
-     * Check for regular straight (2-A).
-     * Ace can be high (10-J-Q-K-A) or low (A-2-3-4-5).
-     */
+    object_class->finalize = lrg_scoring_hand_finalize;
 
-    /* Check high straight ending at Ace (10-A) */
-    for (i = 10; i <= 13; i++)
-    {
-        if (priv->rank_counts[i] > 0)
-            consecutive++;
-        else
-            break;
-    }
-    if (consecutive == 4 && priv->rank_counts[1] > 0)
-    {
-        /* Ace-high straight (Royal) */
-        if (high_rank != NULL)
-            *high_rank = 14;
-        return TRUE;
-    }
+    klass->evaluate = lrg_scoring_hand_real_evaluate;
 
-    /* Check for regular straights */
-    consecutive = 0;
-    for (i = 1; i <= 13; i++)
-    {
-        if (priv->rank_counts[i] > 0)
-        {
-            consecutive++;
-            if (consecutive >= 5)
-            {
-                if (high_rank != NULL)
-                    *high_rank = i;
-                return TRUE;
-            }
-        }
-        else
-        {
-            consecutive = 0;
-        }
-    }
+    ensure_tables ();
+}
 
-    /* Check for low straight (A-2-3-4-5) */
-    if (priv->rank_counts[1] > 0 &&  /* Ace */
-        priv->rank_counts[2] > 0 &&
-        priv->rank_counts[3] > 0 &&
-        priv->rank_counts[4] > 0 &&
-        priv->rank_counts[5] > 0)
-    {
-        if (high_rank != NULL)
-            *high_rank = 5;
-        return TRUE;
-    }
+static void
+lrg_scoring_hand_init (LrgScoringHand *self)
+{
+    LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
 
-    return FALSE;
+    priv->cards = NULL;
+    priv->scoring_cards = g_ptr_array_new ();
+    priv->hand_type = LRG_HAND_TYPE_NONE;
 }
 
 /*
@@ -398,20 +316,15 @@ static void
 find_scoring_cards_for_hand (LrgScoringHand *self, LrgHandType type)
 {
     LrgScoringHandPrivate *priv = lrg_scoring_hand_get_instance_private (self);
-    guint i;
-
-    g_ptr_array_set_size (priv->scoring_cards, 0);
 
     /*
      * For simplicity, we include all cards in scoring_cards.
      * A more sophisticated implementation would only include
      * the cards that actually contribute to the hand.
      */
-    for (i = 0; i < priv->cards->len; i++)
-    {
-        g_ptr_array_add (priv->scoring_cards,
-                         g_ptr_array_index (priv->cards, i));
-    }
+    g_ptr_array_set_size (priv->scoring_cards, priv->cards->len);
+    memcpy (priv->scoring_cards->pdata, priv->cards->pdata,
+            priv->cards->len * sizeof (gpointer));
 }
 
 /**
@@ -566,6 +479,97 @@ lrg_scoring_hand_get_scoring_cards (LrgScoringHand *self)
     return priv->scoring_cards;
 }
 
+/**
+ * lrg_scoring_hand_pack:
+ * @rank: a #LrgCardRank
+ * @suit: a #LrgCardSuit
+ * @wild: whether the card counts for every suit
+ *
+ * Packs a card into the byte lrg_scoring_hand_evaluate_packed() reads.
+ * Out of range ranks and suits are packed as none.
+ *
+ * Returns: the packed card
+ *
+ * Since: 1.0
+ */
+guint8
+lrg_scoring_hand_pack (LrgCardRank rank,
+                       LrgCardSuit suit,
+                       gboolean    wild)
+{
+    guint8 card = 0;
+
+    if (rank > LRG_CARD_RANK_NONE && rank <= LRG_CARD_RANK_KING)
+        card |= (guint8)rank;
+
+    if (suit > LRG_CARD_SUIT_NONE && suit <= LRG_CARD_SUIT_CLUBS)
+        card |= (guint8)(suit << PACKED_SUIT_SHIFT);
+
+    if (wild)
+        card |= PACKED_WILD;
+
+    return card;
+}
+
+/**
+ * lrg_scoring_hand_pack_card:
+ * @card: a #LrgCardInstance
+ *
+ * Packs the rank and suit of @card, and whether its definition is
+ * tagged "wild", into the byte lrg_scoring_hand_evaluate_packed() reads.
+ *
+ * Returns: the packed card
+ *
+ * Since: 1.0
+ */
+guint8
+lrg_scoring_hand_pack_card (LrgCardInstance *card)
+{
+    LrgCardDef *def;
+
+    g_return_val_if_fail (LRG_IS_CARD_INSTANCE (card), 0);
+
+    def = lrg_card_instance_get_def (card);
+
+    return lrg_scoring_hand_pack (lrg_card_def_get_rank (def),
+                                  lrg_card_def_get_suit (def),
+                                  lrg_card_def_has_tag (def, "wild"));
+}
+
+/**
+ * lrg_scoring_hand_evaluate_packed:
+ * @cards: (array length=n_cards): packed cards
+ * @n_cards: number of cards
+ *
+ * Classifies a hand of packed cards the way the default
+ * lrg_scoring_hand_evaluate() classifies card instances, without
+ * touching any object. Pack the candidate cards once with
+ * lrg_scoring_hand_pack_card() to evaluate many hands drawn from them.
+ *
+ * Returns: the #LrgHandType formed by the cards
+ *
+ * Since: 1.0
+ */
+LrgHandType
+lrg_scoring_hand_evaluate_packed (const guint8 *cards,
+                                  guint         n_cards)
+{
+    HandShape shape = { { 0 } };
+    guint i;
+
+    g_return_val_if_fail (cards != NULL || n_cards == 0, LRG_HAND_TYPE_NONE);
+
+    if (n_cards == 0)
+        return LRG_HAND_TYPE_NONE;
+
+    ensure_tables ();
+
+    for (i = 0; i < n_cards; i++)
+        hand_shape_add (&shape, cards[i]);
+
+    return hand_shape_classify (&shape);
+}
+
 /**
  * lrg_scoring_hand_get_rank_value:
  * @rank: a #LrgCardRank
@@ -158,6 +158,61 @@ LRG_AVAILABLE_IN_ALL
 GPtrArray *
 lrg_scoring_hand_get_scoring_cards (LrgScoringHand *self);
 
+/* Packed Evaluation */
+
+/**
+ * lrg_scoring_hand_pack:
+ * @rank: a #LrgCardRank
+ * @suit: a #LrgCardSuit
+ * @wild: whether the card counts for every suit
+ *
+ * Packs a card into the byte lrg_scoring_hand_evaluate_packed() reads.
+ * Out of range ranks and suits are packed as none.
+ *
+ * Returns: the packed card
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint8
+lrg_scoring_hand_pack (LrgCardRank rank,
+                       LrgCardSuit suit,
+                       gboolean    wild);
+
+/**
+ * lrg_scoring_hand_pack_card:
+ * @card: a #LrgCardInstance
+ *
+ * Packs the rank and suit of @card, and whether its definition is
+ * tagged "wild", into the byte lrg_scoring_hand_evaluate_packed() reads.
+ *
+ * Returns: the packed card
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint8
+lrg_scoring_hand_pack_card (LrgCardInstance *card);
+
+/**
+ * lrg_scoring_hand_evaluate_packed:
+ * @cards: (array length=n_cards): packed cards
+ * @n_cards: number of cards
+ *
+ * Classifies a hand of packed cards the way the default
+ * lrg_scoring_hand_evaluate() classifies card instances, without
+ * touching any object. Pack the candidate cards once with
+ * lrg_scoring_hand_pack_card() to evaluate many hands drawn from them.
+ *
+ * Returns: the #LrgHandType formed by the cards
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgHandType
+lrg_scoring_hand_evaluate_packed (const guint8 *cards,
+                                  guint         n_cards);
+
 /* Utility Functions */
 
 /**
@@ -10,6 +10,7 @@
 #include "config.h"
 #include "lrg-offline-calculator.h"
 #include "../lrg-log.h"
+#include <math.h>
 
 struct _LrgOfflineCalculator
 {
@@ -326,26 +327,157 @@ lrg_offline_calculator_set_snapshot_time (LrgOfflineCalculator *self,
  * ========================================================================== */
 
 /*
- * Helper to simulate one producer for a given duration.
- * Calculates how many complete production cycles would occur
- * and adds the outputs to the result pool.
+ * The tracked producers are solved as one production graph. Each
+ * stock is one resource in one pool; a producer draws its inputs from
+ * the stocks of its input pool and fills the stocks of its output pool.
+ * Production is treated as a fluid: a producer running at full speed
+ * completes efficiency * rate multiplier / production time cycles per
+ * second, and chances are taken at their expected value.
+ *
+ * Between events every rate is constant, so stock levels move linearly.
+ * A segment ends when a stock runs dry or fills up to the resource's
+ * maximum value; the rates are then solved again and integration goes
+ * on from there. An offline period of any length takes one segment per
+ * such event instead of one step per tick.
  */
+
+#define OFFLINE_EPSILON      (1e-9)
+#define OFFLINE_MAX_PASSES   (256)
+#define OFFLINE_MAX_SEGMENTS (4096)
+
+typedef enum
+{
+    STOCK_FREE,
+    STOCK_EMPTY,
+    STOCK_FULL
+} StockState;
+
+typedef struct
+{
+    LrgResourcePool *pool;       /* NULL when a producer has no pool */
+    LrgResource     *resource;
+    gdouble          initial;
+    gdouble          level;
+    gdouble          min_value;
+    gdouble          max_value;
+    gdouble          drift;      /* Net change per second this segment */
+    gdouble          share;      /* Fraction of demand met while empty */
+    StockState       state;
+    guint            first_consumer;
+    guint            n_consumers;
+    guint            first_supplier;
+    guint            n_suppliers;
+} OfflineStock;
+
+typedef struct
+{
+    guint    node;
+    guint    stock;
+    gdouble  amount;             /* Per cycle */
+    gboolean is_input;
+} OfflineFlow;
+
+typedef struct
+{
+    gdouble max_rate;            /* Cycles per second at full speed */
+    gdouble rate;
+    guint   first_input;
+    guint   n_inputs;
+    guint   first_output;
+    guint   n_outputs;
+} OfflineNode;
+
+typedef struct
+{
+    gdouble weight;
+    gdouble limit;
+} OfflineDemand;
+
+typedef struct
+{
+    GArray *stocks;              /* OfflineStock */
+    GArray *nodes;               /* OfflineNode */
+    GArray *flows;               /* OfflineFlow, inputs then outputs per node */
+    GArray *consumers;           /* Flow indices grouped by stock */
+    GArray *suppliers;           /* Flow indices grouped by stock */
+    GArray *order;               /* Node indices, upstream first */
+    GArray *demand;              /* Scratch for fill_stock() */
+} OfflineGraph;
+
 static void
-simulate_producer (LrgProducer     *producer,
-                   gdouble          duration,
-                   gdouble          efficiency,
-                   LrgResourcePool *result_pool)
+offline_graph_init (OfflineGraph *graph)
+{
+    graph->stocks = g_array_new (FALSE, FALSE, sizeof (OfflineStock));
+    graph->nodes = g_array_new (FALSE, FALSE, sizeof (OfflineNode));
+    graph->flows = g_array_new (FALSE, FALSE, sizeof (OfflineFlow));
+    graph->consumers = g_array_new (FALSE, FALSE, sizeof (guint));
+    graph->suppliers = g_array_new (FALSE, FALSE, sizeof (guint));
+    graph->order = g_array_new (FALSE, FALSE, sizeof (guint));
+    graph->demand = g_array_new (FALSE, FALSE, sizeof (OfflineDemand));
+}
+
+static void
+offline_graph_clear (OfflineGraph *graph)
+{
+    g_array_unref (graph->stocks);
+    g_array_unref (graph->nodes);
+    g_array_unref (graph->flows);
+    g_array_unref (graph->consumers);
+    g_array_unref (graph->suppliers);
+    g_array_unref (graph->order);
+    g_array_unref (graph->demand);
+}
+
+static guint
+offline_graph_stock (OfflineGraph    *graph,
+                     LrgResourcePool *pool,
+                     LrgResource     *resource)
+{
+    OfflineStock stock = { 0 };
+    guint i;
+
+    for (i = 0; i < graph->stocks->len; i++)
+    {
+        OfflineStock *s = &g_array_index (graph->stocks, OfflineStock, i);
+
+        if (s->pool == pool && s->resource == resource)
+            return i;
+    }
+
+    stock.pool = pool;
+    stock.resource = resource;
+    stock.min_value = lrg_resource_get_min_value (resource);
+    stock.max_value = lrg_resource_get_max_value (resource);
+    stock.initial = (pool != NULL) ? lrg_resource_pool_get (pool, resource) : 0.0;
+    stock.initial = CLAMP (stock.initial, stock.min_value, stock.max_value);
+    stock.level = stock.initial;
+    g_array_append_val (graph->stocks, stock);
+
+    return graph->stocks->len - 1;
+}
+
+/*
+ * Adds one producer to the graph. Producers that could not finish a
+ * single cycle over the whole duration are left out, as before.
+ */
+static void
+offline_graph_add_producer (OfflineGraph *graph,
+                            LrgProducer  *producer,
+                            gdouble       duration,
+                            gdouble       efficiency)
 {
     LrgProductionRecipe *recipe;
+    LrgResourcePool *output_pool;
+    LrgResourcePool *input_pool;
+    OfflineNode node = { 0 };
+    g_autoptr(GList) inputs = NULL;
+    g_autoptr(GList) outputs = NULL;
     gdouble production_time;
     gdouble rate_multiplier;
-    gdouble effective_duration;
-    gdouble cycles;
-    g_autoptr(GList) outputs = NULL;
     GList *l;
 
     recipe = lrg_producer_get_recipe (producer);
-    if (recipe == NULL)
+    if (recipe == NULL || !lrg_production_recipe_get_enabled (recipe))
         return;
 
     production_time = lrg_production_recipe_get_production_time (recipe);
@@ -356,38 +488,481 @@ simulate_producer (LrgProducer     *producer,
     if (rate_multiplier <= 0.0)
         return;
 
-    /* Apply efficiency and rate multiplier to duration */
-    effective_duration = duration * efficiency * rate_multiplier;
-
-    /* Calculate complete cycles */
-    cycles = effective_duration / production_time;
-    if (cycles < 1.0)
+    node.max_rate = efficiency * rate_multiplier / production_time;
+    if (node.max_rate * duration < 1.0)
         return;
 
-    /* Add outputs for each cycle */
+    output_pool = lrg_producer_get_resource_pool (producer);
+    input_pool = lrg_producer_get_input_pool (producer);
+    if (input_pool == NULL)
+        input_pool = output_pool;
+
+    node.first_input = graph->flows->len;
+    inputs = lrg_production_recipe_get_inputs (recipe);
+    for (l = inputs; l != NULL; l = l->next)
+    {
+        LrgResource *resource = LRG_RESOURCE (l->data);
+        OfflineFlow flow;
+
+        flow.amount = lrg_production_recipe_get_input_amount (recipe, resource);
+        if (flow.amount <= 0.0)
+            continue;
+
+        flow.node = graph->nodes->len;
+        flow.stock = offline_graph_stock (graph, input_pool, resource);
+        flow.is_input = TRUE;
+        g_array_append_val (graph->flows, flow);
+    }
+    node.n_inputs = graph->flows->len - node.first_input;
+
+    node.first_output = graph->flows->len;
     outputs = lrg_production_recipe_get_outputs (recipe);
     for (l = outputs; l != NULL; l = l->next)
     {
         LrgResource *resource = LRG_RESOURCE (l->data);
-        gdouble amount = lrg_production_recipe_get_output_amount (recipe, resource);
-        gdouble chance = lrg_production_recipe_get_output_chance (recipe, resource);
+        OfflineFlow flow;
+
+        /* Expected value smooths out the randomness over long periods */
+        flow.amount = lrg_production_recipe_get_output_amount (recipe, resource) *
+                      lrg_production_recipe_get_output_chance (recipe, resource);
+        if (flow.amount <= 0.0)
+            continue;
+
+        flow.node = graph->nodes->len;
+        flow.stock = offline_graph_stock (graph, output_pool, resource);
+        flow.is_input = FALSE;
+        g_array_append_val (graph->flows, flow);
+    }
+    node.n_outputs = graph->flows->len - node.first_output;
+
+    g_array_append_val (graph->nodes, node);
+}
 
-        /*
-         * For offline calculation, we use expected value:
-         * total = cycles * amount * chance
-         * This smooths out the randomness over long periods.
-         */
-        gdouble total = cycles * amount * chance;
+/*
+ * Groups the flow indices by stock, so the consumers and the suppliers
+ * of a stock can be walked without scanning every flow.
+ */
+static void
+offline_graph_index_flows (OfflineGraph *graph)
+{
+    guint consumers = 0;
+    guint suppliers = 0;
+    guint i;
 
-        lrg_resource_pool_add (result_pool, resource, total);
+    for (i = 0; i < graph->flows->len; i++)
+    {
+        OfflineFlow *flow = &g_array_index (graph->flows, OfflineFlow, i);
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, flow->stock);
 
-        lrg_debug (LRG_LOG_DOMAIN_ECONOMY,
-                   "Offline: %.2f cycles of %s -> %.2f %s",
-                   cycles,
-                   lrg_production_recipe_get_id (recipe),
-                   total,
-                   lrg_resource_get_id (resource));
+        if (flow->is_input)
+            stock->n_consumers++;
+        else
+            stock->n_suppliers++;
+    }
+
+    for (i = 0; i < graph->stocks->len; i++)
+    {
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, i);
+
+        stock->first_consumer = consumers;
+        stock->first_supplier = suppliers;
+        consumers += stock->n_consumers;
+        suppliers += stock->n_suppliers;
+        stock->n_consumers = 0;
+        stock->n_suppliers = 0;
+    }
+
+    g_array_set_size (graph->consumers, consumers);
+    g_array_set_size (graph->suppliers, suppliers);
+
+    for (i = 0; i < graph->flows->len; i++)
+    {
+        OfflineFlow *flow = &g_array_index (graph->flows, OfflineFlow, i);
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, flow->stock);
+
+        if (flow->is_input)
+            g_array_index (graph->consumers, guint, stock->first_consumer + stock->n_consumers++) = i;
+        else
+            g_array_index (graph->suppliers, guint, stock->first_supplier + stock->n_suppliers++) = i;
+    }
+}
+
+/*
+ * Orders the nodes so that every producer comes after the producers
+ * filling its input stocks. Producers caught in a loop keep their
+ * registration order at the end; the solver iterates over them.
+ */
+static void
+offline_graph_sort (OfflineGraph *graph)
+{
+    g_autofree guint *pending = NULL;
+    g_autofree guint *waiting = NULL;
+    g_autofree gboolean *placed = NULL;
+    guint head;
+    guint i;
+
+    pending = g_new0 (guint, graph->stocks->len);
+    waiting = g_new0 (guint, graph->nodes->len);
+    placed = g_new0 (gboolean, graph->nodes->len);
+
+    for (i = 0; i < graph->stocks->len; i++)
+        pending[i] = g_array_index (graph->stocks, OfflineStock, i).n_suppliers;
+
+    for (i = 0; i < graph->nodes->len; i++)
+    {
+        OfflineNode *node = &g_array_index (graph->nodes, OfflineNode, i);
+        guint f;
+
+        for (f = node->first_input; f < node->first_input + node->n_inputs; f++)
+        {
+            if (pending[g_array_index (graph->flows, OfflineFlow, f).stock] > 0)
+                waiting[i]++;
+        }
+
+        if (waiting[i] == 0)
+        {
+            g_array_append_val (graph->order, i);
+            placed[i] = TRUE;
+        }
+    }
+
+    for (head = 0; head < graph->order->len; head++)
+    {
+        OfflineNode *node;
+        guint f;
+
+        node = &g_array_index (graph->nodes, OfflineNode,
+                               g_array_index (graph->order, guint, head));
+
+        for (f = node->first_output; f < node->first_output + node->n_outputs; f++)
+        {
+            guint k = g_array_index (graph->flows, OfflineFlow, f).stock;
+            OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, k);
+            guint c;
+
+            if (--pending[k] > 0)
+                continue;
+
+            for (c = 0; c < stock->n_consumers; c++)
+            {
+                guint fc = g_array_index (graph->consumers, guint, stock->first_consumer + c);
+                guint n = g_array_index (graph->flows, OfflineFlow, fc).node;
+
+                if (!placed[n] && --waiting[n] == 0)
+                {
+                    g_array_append_val (graph->order, n);
+                    placed[n] = TRUE;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < graph->nodes->len; i++)
+    {
+        if (!placed[i])
+            g_array_append_val (graph->order, i);
+    }
+}
+
+/*
+ * Share of its full speed a node may run at, given the empty input
+ * stocks it draws from. @skip leaves one stock out.
+ */
+static gdouble
+node_limit (OfflineGraph *graph,
+            OfflineNode  *node,
+            guint         skip)
+{
+    gdouble limit = 1.0;
+    guint f;
+
+    for (f = node->first_input; f < node->first_input + node->n_inputs; f++)
+    {
+        guint k = g_array_index (graph->flows, OfflineFlow, f).stock;
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, k);
+
+        if (k != skip && stock->state == STOCK_EMPTY)
+            limit = MIN (limit, stock->share);
+    }
+
+    return limit;
+}
+
+static gint
+compare_demand (gconstpointer a,
+                gconstpointer b)
+{
+    const OfflineDemand *da = a;
+    const OfflineDemand *db = b;
+
+    return (da->limit > db->limit) - (da->limit < db->limit);
+}
+
+/*
+ * Splits what flows into an empty stock among its consumers. Every
+ * consumer gets the same share of its full speed, except those held
+ * back further by another empty input; what they leave is passed on
+ * to the others.
+ */
+static gdouble
+fill_stock (OfflineGraph *graph,
+            guint         k)
+{
+    OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, k);
+    gdouble inflow = 0.0;
+    gdouble wanted = 0.0;
+    gdouble weight = 0.0;
+    gdouble used = 0.0;
+    guint i;
+
+    for (i = 0; i < stock->n_suppliers; i++)
+    {
+        guint f = g_array_index (graph->suppliers, guint, stock->first_supplier + i);
+        OfflineFlow *flow = &g_array_index (graph->flows, OfflineFlow, f);
+
+        inflow += flow->amount * g_array_index (graph->nodes, OfflineNode, flow->node).rate;
+    }
+
+    g_array_set_size (graph->demand, stock->n_consumers);
+    for (i = 0; i < stock->n_consumers; i++)
+    {
+        guint f = g_array_index (graph->consumers, guint, stock->first_consumer + i);
+        OfflineFlow *flow = &g_array_index (graph->flows, OfflineFlow, f);
+        OfflineNode *node = &g_array_index (graph->nodes, OfflineNode, flow->node);
+        OfflineDemand *demand = &g_array_index (graph->demand, OfflineDemand, i);
+
+        demand->weight = flow->amount * node->max_rate;
+        demand->limit = node_limit (graph, node, k);
+        wanted += demand->weight * demand->limit;
+        weight += demand->weight;
+    }
+
+    if (wanted <= inflow)
+        return 1.0;
+
+    g_array_sort (graph->demand, compare_demand);
+    for (i = 0; i < graph->demand->len; i++)
+    {
+        OfflineDemand *demand = &g_array_index (graph->demand, OfflineDemand, i);
+
+        if (used + weight * demand->limit >= inflow)
+            break;
+
+        used += demand->weight * demand->limit;
+        weight -= demand->weight;
     }
+
+    return (weight > 0.0) ? (inflow - used) / weight : 1.0;
+}
+
+/*
+ * Finds the rate of every node for the current stock states. Walking
+ * the nodes upstream first settles an acyclic graph in one pass; loops
+ * and consumers sharing several empty stocks take a few more. Empty
+ * stocks start with nothing to share, so a loop with no stock left in
+ * it stays stalled, as the producers themselves would.
+ */
+static void
+offline_graph_solve_rates (OfflineGraph *graph)
+{
+    guint pass;
+    guint i;
+
+    for (i = 0; i < graph->stocks->len; i++)
+        g_array_index (graph->stocks, OfflineStock, i).share = 0.0;
+
+    for (i = 0; i < graph->nodes->len; i++)
+        g_array_index (graph->nodes, OfflineNode, i).rate = 0.0;
+
+    for (pass = 0; pass < OFFLINE_MAX_PASSES; pass++)
+    {
+        gdouble change = 0.0;
+
+        for (i = 0; i < graph->order->len; i++)
+        {
+            OfflineNode *node;
+            gdouble rate;
+            guint f;
+
+            node = &g_array_index (graph->nodes, OfflineNode,
+                                   g_array_index (graph->order, guint, i));
+
+            for (f = node->first_input; f < node->first_input + node->n_inputs; f++)
+            {
+                guint k = g_array_index (graph->flows, OfflineFlow, f).stock;
+                OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, k);
+
+                if (stock->state == STOCK_EMPTY)
+                    stock->share = fill_stock (graph, k);
+            }
+
+            rate = node->max_rate * node_limit (graph, node, G_MAXUINT);
+            change = MAX (change, fabs (rate - node->rate) / node->max_rate);
+            node->rate = rate;
+        }
+
+        if (change < 1e-12)
+            break;
+    }
+}
+
+/*
+ * Sets the state of every stock and the net change of its level at
+ * the solved rates. A full stock throws away what it cannot hold.
+ */
+static void
+offline_graph_update_drift (OfflineGraph *graph)
+{
+    guint i;
+
+    for (i = 0; i < graph->stocks->len; i++)
+        g_array_index (graph->stocks, OfflineStock, i).drift = 0.0;
+
+    for (i = 0; i < graph->flows->len; i++)
+    {
+        OfflineFlow *flow = &g_array_index (graph->flows, OfflineFlow, i);
+        OfflineNode *node = &g_array_index (graph->nodes, OfflineNode, flow->node);
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, flow->stock);
+
+        if (flow->is_input)
+            stock->drift -= flow->amount * node->rate;
+        else
+            stock->drift += flow->amount * node->rate;
+    }
+
+    for (i = 0; i < graph->stocks->len; i++)
+    {
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, i);
+
+        if (stock->state == STOCK_FULL && stock->drift > 0.0)
+            stock->drift = 0.0;
+        else if (stock->state == STOCK_EMPTY && stock->drift < 0.0)
+            stock->drift = 0.0;
+    }
+}
+
+static void
+offline_graph_classify (OfflineGraph *graph)
+{
+    guint i;
+
+    for (i = 0; i < graph->stocks->len; i++)
+    {
+        OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, i);
+
+        if (stock->level <= stock->min_value + OFFLINE_EPSILON)
+        {
+            stock->level = stock->min_value;
+            stock->state = STOCK_EMPTY;
+        }
+        else if (stock->level >= stock->max_value - OFFLINE_EPSILON)
+        {
+            stock->level = stock->max_value;
+            stock->state = STOCK_FULL;
+        }
+        else
+        {
+            stock->state = STOCK_FREE;
+        }
+    }
+}
+
+/*
+ * Integrates the graph over @duration, one segment per stock running
+ * dry or filling up.
+ */
+static guint
+offline_graph_run (OfflineGraph *graph,
+                   gdouble       duration)
+{
+    gdouble remaining = duration;
+    guint segments = 0;
+    guint i;
+
+    while (remaining > 0.0)
+    {
+        gdouble step = remaining;
+
+        offline_graph_classify (graph);
+        offline_graph_solve_rates (graph);
+        offline_graph_update_drift (graph);
+
+        if (++segments < OFFLINE_MAX_SEGMENTS)
+        {
+            for (i = 0; i < graph->stocks->len; i++)
+            {
+                OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, i);
+
+                if (stock->drift < 0.0 && stock->state != STOCK_EMPTY)
+                    step = MIN (step, (stock->level - stock->min_value) / -stock->drift);
+                else if (stock->drift > 0.0 && stock->state != STOCK_FULL)
+                    step = MIN (step, (stock->max_value - stock->level) / stock->drift);
+            }
+        }
+
+        for (i = 0; i < graph->stocks->len; i++)
+        {
+            OfflineStock *stock = &g_array_index (graph->stocks, OfflineStock, i);
+
+            stock->level += stock->drift * step;
+            stock->level = CLAMP (stock->level, stock->min_value, stock->max_value);
+        }
+
+        remaining -= step;
+    }
+
+    return segments;
+}
+
+static void
+offline_graph_build (LrgOfflineCalculator *self,
+                     OfflineGraph         *graph,
+                     gdouble               duration)
+{
+    guint i;
+
+    offline_graph_init (graph);
+
+    for (i = 0; i < self->producers->len; i++)
+    {
+        offline_graph_add_producer (graph,
+                                    g_ptr_array_index (self->producers, i),
+                                    duration,
+                                    self->efficiency);
+    }
+
+    offline_graph_index_flows (graph);
+    offline_graph_sort (graph);
+}
+
+/*
+ * Solves the tracked producers over @duration. Returns FALSE, leaving
+ * @graph unset, when there is nothing to solve.
+ */
+static gboolean
+offline_calculator_solve (LrgOfflineCalculator *self,
+                          gdouble               duration,
+                          OfflineGraph         *graph)
+{
+    guint segments;
+
+    if (duration == 0.0)
+        return FALSE;
+
+    if (self->producers->len == 0)
+    {
+        lrg_debug (LRG_LOG_DOMAIN_ECONOMY, "No producers to simulate offline");
+        return FALSE;
+    }
+
+    offline_graph_build (self, graph, duration);
+    segments = offline_graph_run (graph, duration);
+
+    lrg_debug (LRG_LOG_DOMAIN_ECONOMY,
+               "Solved offline progress for %.2fs: %u producers, %u stocks, %u segments",
+               duration, graph->nodes->len, graph->stocks->len, segments);
+
+    return TRUE;
 }
 
 gdouble
@@ -443,31 +1018,64 @@ lrg_offline_calculator_calculate_duration (LrgOfflineCalculator *self,
                                            gdouble               duration,
                                            LrgResourcePool      *result_pool)
 {
+    OfflineGraph graph;
     guint i;
 
     g_return_if_fail (LRG_IS_OFFLINE_CALCULATOR (self));
     g_return_if_fail (duration >= 0.0);
     g_return_if_fail (LRG_IS_RESOURCE_POOL (result_pool));
 
-    if (duration == 0.0)
+    if (!offline_calculator_solve (self, duration, &graph))
         return;
 
-    if (self->producers->len == 0)
+    /* Report what each stock gained; drawn down stocks report nothing */
+    for (i = 0; i < graph.stocks->len; i++)
     {
-        lrg_debug (LRG_LOG_DOMAIN_ECONOMY, "No producers to simulate offline");
-        return;
+        OfflineStock *stock = &g_array_index (graph.stocks, OfflineStock, i);
+        gdouble gained = stock->level - stock->initial;
+
+        if (gained <= 0.0)
+            continue;
+
+        lrg_resource_pool_add (result_pool, stock->resource, gained);
+
+        lrg_debug (LRG_LOG_DOMAIN_ECONOMY,
+                   "Offline: %.2f %s",
+                   gained,
+                   lrg_resource_get_id (stock->resource));
     }
 
-    lrg_debug (LRG_LOG_DOMAIN_ECONOMY,
-               "Calculating offline progress for %.2fs with %u producers",
-               duration, self->producers->len);
+    offline_graph_clear (&graph);
+}
 
-    /* Simulate each producer */
-    for (i = 0; i < self->producers->len; i++)
+void
+lrg_offline_calculator_advance (LrgOfflineCalculator *self,
+                                gdouble               duration)
+{
+    OfflineGraph graph;
+    guint i;
+
+    g_return_if_fail (LRG_IS_OFFLINE_CALCULATOR (self));
+    g_return_if_fail (duration >= 0.0);
+
+    if (!offline_calculator_solve (self, duration, &graph))
+        return;
+
+    for (i = 0; i < graph.stocks->len; i++)
     {
-        LrgProducer *producer = g_ptr_array_index (self->producers, i);
-        simulate_producer (producer, duration, self->efficiency, result_pool);
+        OfflineStock *stock = &g_array_index (graph.stocks, OfflineStock, i);
+        gdouble change = stock->level - stock->initial;
+
+        if (stock->pool == NULL)
+            continue;
+
+        if (change > 0.0)
+            lrg_resource_pool_add (stock->pool, stock->resource, change);
+        else if (change < 0.0)
+            lrg_resource_pool_remove_clamped (stock->pool, stock->resource, -change);
     }
+
+    offline_graph_clear (&graph);
 }
 
 gdouble
@@ -172,6 +172,13 @@ lrg_offline_calculator_calculate (LrgOfflineCalculator *self,
  *
  * Calculates resources for a specific duration.
  *
+ * The tracked producers are solved together: a producer whose inputs
+ * are made by other producers runs no faster than they supply them,
+ * and starts drawing down or stops once the stocks in its input pool
+ * run dry. Stocks stop growing at their resource's maximum value. The
+ * pools themselves are not changed; each resource that ends up higher
+ * than it started is added to @result_pool by the amount it gained.
+ *
  * Since: 1.0
  */
 LRG_AVAILABLE_IN_ALL
@@ -180,6 +187,25 @@ lrg_offline_calculator_calculate_duration (LrgOfflineCalculator *self,
                                            gdouble               duration,
                                            LrgResourcePool      *result_pool);
 
+/**
+ * lrg_offline_calculator_advance:
+ * @self: an #LrgOfflineCalculator
+ * @duration: offline duration in seconds
+ *
+ * Solves the tracked producers like
+ * lrg_offline_calculator_calculate_duration() and writes the outcome
+ * into the producers' own pools: inputs consumed over @duration are
+ * removed and outputs are added. Use this when producers feed each
+ * other, so the stocks between them end where ticking the producers
+ * for @duration would have left them.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_offline_calculator_advance (LrgOfflineCalculator *self,
+                                gdouble               duration);
+
 /**
  * lrg_offline_calculator_apply:
  * @self: an #LrgOfflineCalculator
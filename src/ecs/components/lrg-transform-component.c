@@ -23,12 +23,8 @@
 
 typedef struct
 {
-    /* Local transform (relative to parent) */
-    gfloat                 local_x;
-    gfloat                 local_y;
-    gfloat                 local_rotation;  /* Degrees */
-    gfloat                 scale_x;
-    gfloat                 scale_y;
+    /* Local transform (relative to parent), exposed by get_data() */
+    LrgTransformData       data;
 
     /* Hierarchy */
     LrgTransformComponent *parent;          /* Weak reference */
@@ -103,19 +99,19 @@ lrg_transform_component_get_property (GObject    *object,
     switch (prop_id)
     {
     case PROP_LOCAL_X:
-        g_value_set_float (value, priv->local_x);
+        g_value_set_float (value, priv->data.local_x);
         break;
     case PROP_LOCAL_Y:
-        g_value_set_float (value, priv->local_y);
+        g_value_set_float (value, priv->data.local_y);
         break;
     case PROP_LOCAL_ROTATION:
-        g_value_set_float (value, priv->local_rotation);
+        g_value_set_float (value, priv->data.local_rotation);
         break;
     case PROP_SCALE_X:
-        g_value_set_float (value, priv->scale_x);
+        g_value_set_float (value, priv->data.scale_x);
         break;
     case PROP_SCALE_Y:
-        g_value_set_float (value, priv->scale_y);
+        g_value_set_float (value, priv->data.scale_y);
         break;
     case PROP_PARENT:
         g_value_set_object (value, priv->parent);
@@ -148,9 +144,9 @@ lrg_transform_component_set_property (GObject      *object,
         {
             LrgTransformComponentPrivate *priv = lrg_transform_component_get_instance_private (self);
             gfloat new_value = g_value_get_float (value);
-            if (priv->scale_x != new_value)
+            if (priv->data.scale_x != new_value)
             {
-                priv->scale_x = new_value;
+                priv->data.scale_x = new_value;
                 g_object_notify_by_pspec (object, properties[PROP_SCALE_X]);
             }
         }
@@ -159,9 +155,9 @@ lrg_transform_component_set_property (GObject      *object,
         {
             LrgTransformComponentPrivate *priv = lrg_transform_component_get_instance_private (self);
             gfloat new_value = g_value_get_float (value);
-            if (priv->scale_y != new_value)
+            if (priv->data.scale_y != new_value)
             {
-                priv->scale_y = new_value;
+                priv->data.scale_y = new_value;
                 g_object_notify_by_pspec (object, properties[PROP_SCALE_Y]);
             }
         }
@@ -276,11 +272,11 @@ lrg_transform_component_init (LrgTransformComponent *self)
 {
     LrgTransformComponentPrivate *priv = lrg_transform_component_get_instance_private (self);
 
-    priv->local_x = 0.0f;
-    priv->local_y = 0.0f;
-    priv->local_rotation = 0.0f;
-    priv->scale_x = 1.0f;
-    priv->scale_y = 1.0f;
+    priv->data.local_x = 0.0f;
+    priv->data.local_y = 0.0f;
+    priv->data.local_rotation = 0.0f;
+    priv->data.scale_x = 1.0f;
+    priv->data.scale_y = 1.0f;
     priv->parent = NULL;
     priv->children = NULL;
 }
@@ -373,7 +369,7 @@ lrg_transform_component_get_local_position (LrgTransformComponent *self)
     g_return_val_if_fail (LRG_IS_TRANSFORM_COMPONENT (self), NULL);
 
     priv = lrg_transform_component_get_instance_private (self);
-    return grl_vector2_new (priv->local_x, priv->local_y);
+    return grl_vector2_new (priv->data.local_x, priv->data.local_y);
 }
 
 /**
@@ -414,17 +410,17 @@ lrg_transform_component_set_local_position_xy (LrgTransformComponent *self,
 
     priv = lrg_transform_component_get_instance_private (self);
 
-    x_changed = (priv->local_x != x);
-    y_changed = (priv->local_y != y);
+    x_changed = (priv->data.local_x != x);
+    y_changed = (priv->data.local_y != y);
 
     if (x_changed)
     {
-        priv->local_x = x;
+        priv->data.local_x = x;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOCAL_X]);
     }
     if (y_changed)
     {
-        priv->local_y = y;
+        priv->data.local_y = y;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOCAL_Y]);
     }
 }
@@ -445,7 +441,7 @@ lrg_transform_component_get_local_x (LrgTransformComponent *self)
     g_return_val_if_fail (LRG_IS_TRANSFORM_COMPONENT (self), 0.0f);
 
     priv = lrg_transform_component_get_instance_private (self);
-    return priv->local_x;
+    return priv->data.local_x;
 }
 
 /**
@@ -465,9 +461,9 @@ lrg_transform_component_set_local_x (LrgTransformComponent *self,
 
     priv = lrg_transform_component_get_instance_private (self);
 
-    if (priv->local_x != x)
+    if (priv->data.local_x != x)
     {
-        priv->local_x = x;
+        priv->data.local_x = x;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOCAL_X]);
     }
 }
@@ -488,7 +484,7 @@ lrg_transform_component_get_local_y (LrgTransformComponent *self)
     g_return_val_if_fail (LRG_IS_TRANSFORM_COMPONENT (self), 0.0f);
 
     priv = lrg_transform_component_get_instance_private (self);
-    return priv->local_y;
+    return priv->data.local_y;
 }
 
 /**
@@ -508,9 +504,9 @@ lrg_transform_component_set_local_y (LrgTransformComponent *self,
 
     priv = lrg_transform_component_get_instance_private (self);
 
-    if (priv->local_y != y)
+    if (priv->data.local_y != y)
     {
-        priv->local_y = y;
+        priv->data.local_y = y;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOCAL_Y]);
     }
 }
@@ -531,7 +527,7 @@ lrg_transform_component_get_local_rotation (LrgTransformComponent *self)
     g_return_val_if_fail (LRG_IS_TRANSFORM_COMPONENT (self), 0.0f);
 
     priv = lrg_transform_component_get_instance_private (self);
-    return priv->local_rotation;
+    return priv->data.local_rotation;
 }
 
 /**
@@ -551,9 +547,9 @@ lrg_transform_component_set_local_rotation (LrgTransformComponent *self,
 
     priv = lrg_transform_component_get_instance_private (self);
 
-    if (priv->local_rotation != rotation)
+    if (priv->data.local_rotation != rotation)
     {
-        priv->local_rotation = rotation;
+        priv->data.local_rotation = rotation;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOCAL_ROTATION]);
     }
 }
@@ -574,7 +570,7 @@ lrg_transform_component_get_local_scale (LrgTransformComponent *self)
     g_return_val_if_fail (LRG_IS_TRANSFORM_COMPONENT (self), NULL);
 
     priv = lrg_transform_component_get_instance_private (self);
-    return grl_vector2_new (priv->scale_x, priv->scale_y);
+    return grl_vector2_new (priv->data.scale_x, priv->data.scale_y);
 }
 
 /**
@@ -615,17 +611,17 @@ lrg_transform_component_set_local_scale_xy (LrgTransformComponent *self,
 
     priv = lrg_transform_component_get_instance_private (self);
 
-    x_changed = (priv->scale_x != scale_x);
-    y_changed = (priv->scale_y != scale_y);
+    x_changed = (priv->data.scale_x != scale_x);
+    y_changed = (priv->data.scale_y != scale_y);
 
     if (x_changed)
     {
-        priv->scale_x = scale_x;
+        priv->data.scale_x = scale_x;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SCALE_X]);
     }
     if (y_changed)
     {
-        priv->scale_y = scale_y;
+        priv->data.scale_y = scale_y;
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SCALE_Y]);
     }
 }
@@ -670,7 +666,7 @@ lrg_transform_component_get_world_position (LrgTransformComponent *self)
     if (priv->parent == NULL)
     {
         /* No parent - local is world */
-        return grl_vector2_new (priv->local_x, priv->local_y);
+        return grl_vector2_new (priv->data.local_x, priv->data.local_y);
     }
     else
     {
@@ -685,8 +681,8 @@ lrg_transform_component_get_world_position (LrgTransformComponent *self)
         gfloat sin_r = sinf (rad);
 
         /* Scale first, then rotate */
-        gfloat scaled_x = priv->local_x * parent_scale->x;
-        gfloat scaled_y = priv->local_y * parent_scale->y;
+        gfloat scaled_x = priv->data.local_x * parent_scale->x;
+        gfloat scaled_y = priv->data.local_y * parent_scale->y;
 
         gfloat rotated_x = scaled_x * cos_r - scaled_y * sin_r;
         gfloat rotated_y = scaled_x * sin_r + scaled_y * cos_r;
@@ -718,11 +714,11 @@ lrg_transform_component_get_world_rotation (LrgTransformComponent *self)
 
     if (priv->parent == NULL)
     {
-        return priv->local_rotation;
+        return priv->data.local_rotation;
     }
     else
     {
-        return lrg_transform_component_get_world_rotation (priv->parent) + priv->local_rotation;
+        return lrg_transform_component_get_world_rotation (priv->parent) + priv->data.local_rotation;
     }
 }
 
@@ -745,13 +741,13 @@ lrg_transform_component_get_world_scale (LrgTransformComponent *self)
 
     if (priv->parent == NULL)
     {
-        return grl_vector2_new (priv->scale_x, priv->scale_y);
+        return grl_vector2_new (priv->data.scale_x, priv->data.scale_y);
     }
     else
     {
         g_autoptr(GrlVector2) parent_scale = lrg_transform_component_get_world_scale (priv->parent);
-        return grl_vector2_new (priv->scale_x * parent_scale->x,
-                                priv->scale_y * parent_scale->y);
+        return grl_vector2_new (priv->data.scale_x * parent_scale->x,
+                                priv->data.scale_y * parent_scale->y);
     }
 }
 
@@ -915,8 +911,8 @@ lrg_transform_component_translate (LrgTransformComponent *self,
     priv = lrg_transform_component_get_instance_private (self);
 
     lrg_transform_component_set_local_position_xy (self,
-                                                   priv->local_x + offset->x,
-                                                   priv->local_y + offset->y);
+                                                   priv->data.local_x + offset->x,
+                                                   priv->data.local_y + offset->y);
 }
 
 /**
@@ -936,7 +932,7 @@ lrg_transform_component_rotate (LrgTransformComponent *self,
 
     priv = lrg_transform_component_get_instance_private (self);
 
-    lrg_transform_component_set_local_rotation (self, priv->local_rotation + degrees);
+    lrg_transform_component_set_local_rotation (self, priv->data.local_rotation + degrees);
 }
 
 /**
@@ -1040,7 +1036,7 @@ lrg_transform_component_get_rotation_quaternion (LrgTransformComponent *self)
      * Convert 2D rotation (around Z) to quaternion.
      * For rotation around Z axis: q = (0, 0, sin(angle/2), cos(angle/2))
      */
-    rad = deg_to_rad (priv->local_rotation);
+    rad = deg_to_rad (priv->data.local_rotation);
     return grl_quaternion_new (0.0f, 0.0f, sinf (rad / 2.0f), cosf (rad / 2.0f));
 }
 
@@ -1135,3 +1131,31 @@ lrg_transform_component_slerp_rotation (LrgTransformComponent *self,
     grl_quaternion_to_euler (result, &pitch, &yaw, &roll);
     lrg_transform_component_set_local_rotation (self, roll * (180.0f / G_PI));
 }
+
+/* ==========================================================================
+ * Public API - Direct Data Access
+ * ========================================================================== */
+
+/**
+ * lrg_transform_component_get_data:
+ * @self: an #LrgTransformComponent
+ *
+ * Gets the storage backing the local transform.
+ *
+ * Writes through the returned pointer take effect immediately but
+ * bypass property notification. World-space getters read it on
+ * demand, so they see the new values.
+ *
+ * Returns: (transfer none): the local transform data, valid for the
+ *   lifetime of @self
+ */
+LrgTransformData *
+lrg_transform_component_get_data (LrgTransformComponent *self)
+{
+    LrgTransformComponentPrivate *priv;
+
+    g_return_val_if_fail (LRG_IS_TRANSFORM_COMPONENT (self), NULL);
+
+    priv = lrg_transform_component_get_instance_private (self);
+    return &priv->data;
+}
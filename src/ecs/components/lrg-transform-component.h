@@ -35,6 +35,27 @@ LRG_AVAILABLE_IN_ALL
 G_DECLARE_DERIVABLE_TYPE (LrgTransformComponent, lrg_transform_component,
                           LRG, TRANSFORM_COMPONENT, LrgComponent)
 
+/**
+ * LrgTransformData:
+ * @local_x: local X position
+ * @local_y: local Y position
+ * @local_rotation: local rotation in degrees
+ * @scale_x: X scale factor
+ * @scale_y: Y scale factor
+ *
+ * The local transform of an #LrgTransformComponent, laid out as
+ * plain floats so scripting backends can map it directly (see
+ * lrg_transform_component_get_data()).
+ */
+typedef struct
+{
+    gfloat local_x;
+    gfloat local_y;
+    gfloat local_rotation;
+    gfloat scale_x;
+    gfloat scale_y;
+} LrgTransformData;
+
 /**
  * LrgTransformComponentClass:
  * @parent_class: The parent class
@@ -436,4 +457,24 @@ void         lrg_transform_component_slerp_rotation          (LrgTransformCompon
                                                                const GrlQuaternion   *target,
                                                                gfloat                 amount);
 
+/*
+ * Direct Data Access
+ */
+
+/**
+ * lrg_transform_component_get_data:
+ * @self: an #LrgTransformComponent
+ *
+ * Gets the storage backing the local transform.
+ *
+ * Writes through the returned pointer take effect immediately but
+ * bypass property notification. World-space getters read it on
+ * demand, so they see the new values.
+ *
+ * Returns: (transfer none): the local transform data, valid for the
+ *   lifetime of @self
+ */
+LRG_AVAILABLE_IN_ALL
+LrgTransformData * lrg_transform_component_get_data         (LrgTransformComponent *self);
+
 G_END_DECLS
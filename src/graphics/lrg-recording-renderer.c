@@ -0,0 +1,177 @@
+/* lrg-recording-renderer.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Headless renderer that records render queue batches.
+ */
+
+#include "config.h"
+#include "lrg-recording-renderer.h"
+
+/**
+ * SECTION:lrg-recording-renderer
+ * @title: LrgRecordingRenderer
+ * @short_description: Headless render queue backend
+ *
+ * #LrgRecordingRenderer overrides the draw_batch() virtual method of
+ * #LrgRenderer to keep a copy of every batch instead of drawing it. It
+ * needs no window or graphics context, so tests and benchmarks can
+ * check how queued sprites were sorted and merged.
+ *
+ * |[<!-- language="C" -->
+ * g_autoptr(LrgRecordingRenderer) recorder = lrg_recording_renderer_new ();
+ * LrgRenderer *renderer = LRG_RENDERER (recorder);
+ *
+ * lrg_renderer_begin_frame (renderer);
+ * lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_WORLD);
+ * // lrg_renderer_submit_sprite (renderer, ...);
+ * lrg_renderer_end_layer (renderer);
+ * lrg_renderer_end_frame (renderer);
+ *
+ * g_assert_cmpuint (lrg_recording_renderer_get_n_batches (recorder), ==, 1);
+ * ]|
+ */
+
+struct _LrgRecordingRenderer
+{
+	LrgRenderer  parent_instance;
+
+	GArray      *batches;        /* LrgRenderBatch */
+	GArray      *first_sprites;  /* guint, offset of each batch's sprites */
+	GArray      *sprites;        /* LrgRenderSprite */
+};
+
+G_DEFINE_TYPE (LrgRecordingRenderer, lrg_recording_renderer, LRG_TYPE_RENDERER)
+
+/* ==========================================================================
+ * LrgRenderer Overrides
+ * ========================================================================== */
+
+static void
+lrg_recording_renderer_begin_frame (LrgRenderer *renderer)
+{
+	lrg_recording_renderer_clear (LRG_RECORDING_RENDERER (renderer));
+
+	LRG_RENDERER_CLASS (lrg_recording_renderer_parent_class)->begin_frame (renderer);
+}
+
+static void
+lrg_recording_renderer_draw_batch (LrgRenderer          *renderer,
+                                   const LrgRenderBatch *batch)
+{
+	LrgRecordingRenderer *self = LRG_RECORDING_RENDERER (renderer);
+	LrgRenderBatch        copy;
+	guint                 first;
+
+	copy = *batch;
+	copy.sprites = NULL;
+	if (copy.drawable != NULL)
+		g_object_ref (copy.drawable);
+
+	first = self->sprites->len;
+	if (batch->n_sprites > 0)
+		g_array_append_vals (self->sprites, batch->sprites, batch->n_sprites);
+
+	g_array_append_val (self->batches, copy);
+	g_array_append_val (self->first_sprites, first);
+}
+
+/* ==========================================================================
+ * GObject Implementation
+ * ========================================================================== */
+
+static void
+lrg_recording_renderer_dispose (GObject *object)
+{
+	lrg_recording_renderer_clear (LRG_RECORDING_RENDERER (object));
+
+	G_OBJECT_CLASS (lrg_recording_renderer_parent_class)->dispose (object);
+}
+
+static void
+lrg_recording_renderer_finalize (GObject *object)
+{
+	LrgRecordingRenderer *self = LRG_RECORDING_RENDERER (object);
+
+	g_array_unref (self->batches);
+	g_array_unref (self->first_sprites);
+	g_array_unref (self->sprites);
+
+	G_OBJECT_CLASS (lrg_recording_renderer_parent_class)->finalize (object);
+}
+
+static void
+lrg_recording_renderer_class_init (LrgRecordingRendererClass *klass)
+{
+	GObjectClass     *object_class = G_OBJECT_CLASS (klass);
+	LrgRendererClass *renderer_class = LRG_RENDERER_CLASS (klass);
+
+	object_class->dispose = lrg_recording_renderer_dispose;
+	object_class->finalize = lrg_recording_renderer_finalize;
+
+	renderer_class->begin_frame = lrg_recording_renderer_begin_frame;
+	renderer_class->draw_batch = lrg_recording_renderer_draw_batch;
+}
+
+static void
+lrg_recording_renderer_init (LrgRecordingRenderer *self)
+{
+	self->batches = g_array_new (FALSE, FALSE, sizeof (LrgRenderBatch));
+	self->first_sprites = g_array_new (FALSE, FALSE, sizeof (guint));
+	self->sprites = g_array_new (FALSE, FALSE, sizeof (LrgRenderSprite));
+}
+
+/* ==========================================================================
+ * Public API
+ * ========================================================================== */
+
+LrgRecordingRenderer *
+lrg_recording_renderer_new (void)
+{
+	return g_object_new (LRG_TYPE_RECORDING_RENDERER, NULL);
+}
+
+guint
+lrg_recording_renderer_get_n_batches (LrgRecordingRenderer *self)
+{
+	g_return_val_if_fail (LRG_IS_RECORDING_RENDERER (self), 0);
+
+	return self->batches->len;
+}
+
+const LrgRenderBatch *
+lrg_recording_renderer_get_batch (LrgRecordingRenderer *self,
+                                  guint                 index)
+{
+	LrgRenderBatch *batch;
+	guint           first;
+
+	g_return_val_if_fail (LRG_IS_RECORDING_RENDERER (self), NULL);
+	g_return_val_if_fail (index < self->batches->len, NULL);
+
+	/* The sprite array may have moved since the batch was recorded */
+	batch = &g_array_index (self->batches, LrgRenderBatch, index);
+	first = g_array_index (self->first_sprites, guint, index);
+	batch->sprites = batch->n_sprites > 0
+		? &g_array_index (self->sprites, LrgRenderSprite, first)
+		: NULL;
+
+	return batch;
+}
+
+void
+lrg_recording_renderer_clear (LrgRecordingRenderer *self)
+{
+	guint i;
+
+	g_return_if_fail (LRG_IS_RECORDING_RENDERER (self));
+
+	for (i = 0; i < self->batches->len; i++)
+		g_clear_object (&g_array_index (self->batches, LrgRenderBatch, i).drawable);
+
+	g_array_set_size (self->batches, 0);
+	g_array_set_size (self->first_sprites, 0);
+	g_array_set_size (self->sprites, 0);
+}
@@ -0,0 +1,76 @@
+/* lrg-recording-renderer.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Headless renderer that records render queue batches.
+ */
+
+#pragma once
+
+#if !defined(LIBREGNUM_INSIDE) && !defined(LIBREGNUM_COMPILATION)
+#error "Only <libregnum.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include "../lrg-version.h"
+#include "../lrg-types.h"
+#include "lrg-renderer.h"
+
+G_BEGIN_DECLS
+
+#define LRG_TYPE_RECORDING_RENDERER (lrg_recording_renderer_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgRecordingRenderer, lrg_recording_renderer, LRG, RECORDING_RENDERER, LrgRenderer)
+
+/**
+ * lrg_recording_renderer_new:
+ *
+ * Create a renderer without a window. Batches flushed from the render
+ * queue are recorded instead of drawn, and drawables are not drawn.
+ * Recordings are cleared when a frame begins.
+ *
+ * Don't set a camera: camera transforms still go to graylib.
+ *
+ * Returns: (transfer full): a new #LrgRecordingRenderer
+ */
+LRG_AVAILABLE_IN_ALL
+LrgRecordingRenderer * lrg_recording_renderer_new (void);
+
+/**
+ * lrg_recording_renderer_get_n_batches:
+ * @self: an #LrgRecordingRenderer
+ *
+ * Get the number of batches recorded.
+ *
+ * Returns: the batch count
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_recording_renderer_get_n_batches (LrgRecordingRenderer *self);
+
+/**
+ * lrg_recording_renderer_get_batch:
+ * @self: an #LrgRecordingRenderer
+ * @index: the batch index, in draw order
+ *
+ * Get a recorded batch. The sprites are copies owned by @self.
+ *
+ * Returns: (transfer none): the batch, valid until the next recording
+ *   or clear
+ */
+LRG_AVAILABLE_IN_ALL
+const LrgRenderBatch * lrg_recording_renderer_get_batch (LrgRecordingRenderer *self,
+                                                         guint                 index);
+
+/**
+ * lrg_recording_renderer_clear:
+ * @self: an #LrgRecordingRenderer
+ *
+ * Drop every recorded batch.
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_recording_renderer_clear (LrgRecordingRenderer *self);
+
+G_END_DECLS
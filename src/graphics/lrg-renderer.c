@@ -10,6 +10,8 @@
 #include "config.h"
 #include "lrg-renderer.h"
 
+#include <string.h>
+
 /**
  * SECTION:lrg-renderer
  * @title: LrgRenderer
@@ -61,8 +63,65 @@
  *     lrg_renderer_end_frame (renderer);
  * }
  * ]|
+ *
+ * ## Render Queue
+ *
+ * Drawing a sprite immediately costs a texture bind and a draw call
+ * whenever the texture differs from the previous sprite's. Sprites
+ * submitted with lrg_renderer_submit_sprite() are instead queued with
+ * a 64-bit sort key (sort layer, blend mode, shader, texture, depth).
+ * lrg_renderer_end_layer() radix-sorts the layer's queue once and
+ * hands runs of sprites that share state to the draw_batch() virtual
+ * method, which draws each run as a single quad stream.
+ *
+ * |[<!-- language="C" -->
+ * lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_WORLD);
+ * for (i = 0; i < n_sprites; i++)
+ * {
+ *     guint64 key = lrg_renderer_make_sort_key (renderer, 0, GRL_BLEND_ALPHA,
+ *                                               NULL, sprites[i].texture,
+ *                                               sprites[i].y);
+ *
+ *     lrg_renderer_submit_sprite (renderer, key, NULL, sprites[i].texture,
+ *                                 &sprites[i].source, &sprites[i].dest,
+ *                                 NULL, 0.0f, NULL);
+ * }
+ * lrg_renderer_end_layer (renderer);
+ * ]|
  */
 
+/* Key layout, most significant first */
+#define KEY_DEPTH_BITS      (24)
+#define KEY_TEXTURE_SHIFT   (24)
+#define KEY_SHADER_SHIFT    (40)
+#define KEY_BLEND_SHIFT     (52)
+#define KEY_LAYER_SHIFT     (56)
+#define KEY_STATE_MASK      (~((G_GUINT64_CONSTANT (1) << KEY_DEPTH_BITS) - 1))
+
+#define MAX_TEXTURE_ID      (0xffff)
+#define MAX_SHADER_ID       (0xfff)
+
+/* Matches rlgl's default vertex buffer, which flushes at this size */
+#define MAX_BATCH_SPRITES   (8192)
+
+/* Below this, insertion sort beats the radix passes */
+#define RADIX_SORT_MIN      (64)
+
+typedef struct
+{
+	guint64      key;
+	GrlShader   *shader;
+	LrgDrawable *drawable;   /* owned; NULL for sprites */
+	gfloat       delta;
+	guint        sprite;     /* index into queue_sprites */
+} RenderItem;
+
+typedef struct
+{
+	guint64 key;
+	guint   item;
+} RenderSortEntry;
+
 typedef struct
 {
 	LrgWindow      *window;
@@ -72,6 +131,21 @@ typedef struct
 	gboolean        in_frame;
 	gboolean        in_layer;
 	gboolean        camera_active;
+
+	/* Render queue for the current layer */
+	GArray         *queue_items;
+	GArray         *queue_sprites;
+	GArray         *sort_entries;
+	GArray         *sort_scratch;
+	GArray         *batch_sprites;
+
+	/* Pointer -> small id for sort keys */
+	GHashTable     *texture_ids;
+	GHashTable     *shader_ids;
+
+	/* Per-frame statistics */
+	guint           batch_count;
+	guint           sprite_count;
 } LrgRendererPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgRenderer, lrg_renderer, G_TYPE_OBJECT)
@@ -97,6 +171,212 @@ enum
 
 static guint signals[N_SIGNALS];
 
+/* ==========================================================================
+ * Render Queue
+ * ========================================================================== */
+
+/* Maps a float to 24 bits that sort in the same order as the float */
+static guint32
+depth_to_bits (gfloat depth)
+{
+	union
+	{
+		gfloat  f;
+		guint32 u;
+	} v;
+
+	v.f = depth;
+	v.u = (v.u & 0x80000000u) ? ~v.u : (v.u | 0x80000000u);
+
+	return v.u >> (32 - KEY_DEPTH_BITS);
+}
+
+static void
+insertion_sort (RenderSortEntry *entries,
+                guint            n)
+{
+	guint i;
+
+	for (i = 1; i < n; i++)
+	{
+		RenderSortEntry entry = entries[i];
+		guint           j = i;
+
+		while (j > 0 && entries[j - 1].key > entry.key)
+		{
+			entries[j] = entries[j - 1];
+			j--;
+		}
+		entries[j] = entry;
+	}
+}
+
+/*
+ * Stable LSD radix sort on the 64-bit keys, one byte per pass. Passes
+ * where every key has the same byte are skipped, which is most of
+ * them: a layer rarely uses more than a few sort layers, blend modes
+ * or shaders.
+ */
+static void
+radix_sort (RenderSortEntry *entries,
+            RenderSortEntry *scratch,
+            guint            n)
+{
+	RenderSortEntry *src = entries;
+	RenderSortEntry *dst = scratch;
+	guint            counts[256];
+	guint            shift;
+	guint            i;
+
+	if (n < RADIX_SORT_MIN)
+	{
+		insertion_sort (entries, n);
+		return;
+	}
+
+	for (shift = 0; shift < 64; shift += 8)
+	{
+		RenderSortEntry *tmp;
+		guint            offset;
+
+		memset (counts, 0, sizeof (counts));
+		for (i = 0; i < n; i++)
+			counts[(src[i].key >> shift) & 0xff]++;
+
+		if (counts[(src[0].key >> shift) & 0xff] == n)
+			continue;
+
+		offset = 0;
+		for (i = 0; i < 256; i++)
+		{
+			guint count = counts[i];
+
+			counts[i] = offset;
+			offset += count;
+		}
+
+		for (i = 0; i < n; i++)
+			dst[counts[(src[i].key >> shift) & 0xff]++] = src[i];
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != entries)
+		memcpy (entries, src, n * sizeof (RenderSortEntry));
+}
+
+static void
+clear_queue (LrgRendererPrivate *priv)
+{
+	guint i;
+
+	for (i = 0; i < priv->queue_items->len; i++)
+		g_clear_object (&g_array_index (priv->queue_items, RenderItem, i).drawable);
+
+	g_array_set_size (priv->queue_items, 0);
+	g_array_set_size (priv->queue_sprites, 0);
+}
+
+static void
+emit_batch (LrgRenderer    *self,
+            LrgRenderBatch *batch)
+{
+	LrgRendererPrivate *priv = lrg_renderer_get_instance_private (self);
+	LrgRendererClass   *klass = LRG_RENDERER_GET_CLASS (self);
+
+	priv->batch_count++;
+	priv->sprite_count += batch->n_sprites;
+
+	if (klass->draw_batch != NULL)
+		klass->draw_batch (self, batch);
+}
+
+/*
+ * Sorts the current layer's queue and draws it as batches. Adjacent
+ * sprites merge when their keys match above the depth bits and they
+ * use the same texture and shader.
+ */
+static void
+flush_queue (LrgRenderer *self)
+{
+	LrgRendererPrivate *priv = lrg_renderer_get_instance_private (self);
+	RenderSortEntry    *entries;
+	guint               n;
+	guint               i;
+
+	n = priv->queue_items->len;
+	if (n == 0)
+		return;
+
+	g_array_set_size (priv->sort_entries, n);
+	g_array_set_size (priv->sort_scratch, n);
+	entries = (RenderSortEntry *)(gpointer)priv->sort_entries->data;
+
+	for (i = 0; i < n; i++)
+	{
+		entries[i].key = g_array_index (priv->queue_items, RenderItem, i).key;
+		entries[i].item = i;
+	}
+
+	radix_sort (entries, (RenderSortEntry *)(gpointer)priv->sort_scratch->data, n);
+
+	for (i = 0; i < n;)
+	{
+		const RenderItem *first;
+		const LrgRenderSprite *first_sprite;
+		LrgRenderBatch    batch;
+		guint             end;
+
+		first = &g_array_index (priv->queue_items, RenderItem, entries[i].item);
+
+		batch.layer = priv->current_layer;
+		batch.key = first->key;
+		batch.shader = first->shader;
+		batch.sprites = NULL;
+		batch.n_sprites = 0;
+		batch.drawable = first->drawable;
+		batch.delta = first->delta;
+
+		if (first->drawable != NULL)
+		{
+			emit_batch (self, &batch);
+			i++;
+			continue;
+		}
+
+		first_sprite = &g_array_index (priv->queue_sprites, LrgRenderSprite, first->sprite);
+		g_array_set_size (priv->batch_sprites, 0);
+
+		for (end = i; end < n && end - i < MAX_BATCH_SPRITES; end++)
+		{
+			const RenderItem      *item;
+			const LrgRenderSprite *sprite;
+
+			item = &g_array_index (priv->queue_items, RenderItem, entries[end].item);
+			if (item->drawable != NULL ||
+			    item->shader != first->shader ||
+			    (item->key & KEY_STATE_MASK) != (first->key & KEY_STATE_MASK))
+				break;
+
+			sprite = &g_array_index (priv->queue_sprites, LrgRenderSprite, item->sprite);
+			if (sprite->texture != first_sprite->texture)
+				break;
+
+			g_array_append_vals (priv->batch_sprites, sprite, 1);
+		}
+
+		batch.sprites = (const LrgRenderSprite *)(gconstpointer)priv->batch_sprites->data;
+		batch.n_sprites = end - i;
+		emit_batch (self, &batch);
+
+		i = end;
+	}
+
+	clear_queue (priv);
+}
+
 /* ==========================================================================
  * Default Virtual Method Implementations
  * ========================================================================== */
@@ -117,20 +397,17 @@ lrg_renderer_real_end_frame (LrgRenderer *self)
 {
 	LrgRendererPrivate *priv = lrg_renderer_get_instance_private (self);
 
-	/* Make sure any active layer is ended */
+	/* Make sure any active layer is ended and its queue drawn */
 	if (priv->in_layer)
-	{
-		if (priv->camera_active && priv->camera != NULL)
-		{
-			lrg_camera_end (priv->camera);
-			priv->camera_active = FALSE;
-		}
-		priv->in_layer = FALSE;
-	}
+		lrg_renderer_end_layer (self);
 
 	if (priv->window != NULL)
 		lrg_window_end_frame (priv->window);
 
+	/* Ids only need to be stable while the frame's queues are sorted */
+	g_hash_table_remove_all (priv->texture_ids);
+	g_hash_table_remove_all (priv->shader_ids);
+
 	priv->in_frame = FALSE;
 }
 
@@ -153,6 +430,54 @@ lrg_renderer_real_clear (LrgRenderer *self,
 		lrg_window_clear (priv->window, color);
 }
 
+static void
+lrg_renderer_real_draw_batch (LrgRenderer          *self,
+                              const LrgRenderBatch *batch)
+{
+	guint blend_mode;
+	guint i;
+
+	(void)self;
+
+	if (batch->drawable != NULL)
+	{
+		lrg_drawable_draw (batch->drawable, batch->delta);
+		return;
+	}
+
+	/*
+	 * rlgl only starts a new draw call when the texture, shader or
+	 * blend mode changes, so the quads of a batch become one call.
+	 */
+	blend_mode = (guint)((batch->key >> KEY_BLEND_SHIFT) & 0xf);
+	if (blend_mode != GRL_BLEND_ALPHA)
+		grl_draw_begin_blend_mode (blend_mode);
+	if (batch->shader != NULL)
+		grl_shader_begin (batch->shader);
+
+	for (i = 0; i < batch->n_sprites; i++)
+	{
+		const LrgRenderSprite *sprite = &batch->sprites[i];
+
+		if (sprite->texture != NULL)
+		{
+			grl_draw_texture_pro (sprite->texture,
+			                      &sprite->source, &sprite->dest, &sprite->origin,
+			                      sprite->rotation, &sprite->tint);
+		}
+		else
+		{
+			grl_draw_rectangle_pro (&sprite->dest, &sprite->origin,
+			                        sprite->rotation, &sprite->tint);
+		}
+	}
+
+	if (batch->shader != NULL)
+		grl_shader_end ();
+	if (blend_mode != GRL_BLEND_ALPHA)
+		grl_draw_end_blend_mode ();
+}
+
 /* ==========================================================================
  * GObject Implementation
  * ========================================================================== */
@@ -167,6 +492,15 @@ lrg_renderer_finalize (GObject *object)
 	g_clear_object (&priv->camera);
 	g_clear_pointer (&priv->background_color, grl_color_free);
 
+	clear_queue (priv);
+	g_array_unref (priv->queue_items);
+	g_array_unref (priv->queue_sprites);
+	g_array_unref (priv->sort_entries);
+	g_array_unref (priv->sort_scratch);
+	g_array_unref (priv->batch_sprites);
+	g_hash_table_unref (priv->texture_ids);
+	g_hash_table_unref (priv->shader_ids);
+
 	G_OBJECT_CLASS (lrg_renderer_parent_class)->finalize (object);
 }
 
@@ -235,6 +569,7 @@ lrg_renderer_class_init (LrgRendererClass *klass)
 	klass->end_frame = lrg_renderer_real_end_frame;
 	klass->render_layer = lrg_renderer_real_render_layer;
 	klass->clear = lrg_renderer_real_clear;
+	klass->draw_batch = lrg_renderer_real_draw_batch;
 
 	/**
 	 * LrgRenderer:window:
@@ -338,6 +673,16 @@ lrg_renderer_init (LrgRenderer *self)
 	priv->in_frame = FALSE;
 	priv->in_layer = FALSE;
 	priv->camera_active = FALSE;
+
+	priv->queue_items = g_array_new (FALSE, FALSE, sizeof (RenderItem));
+	priv->queue_sprites = g_array_new (FALSE, FALSE, sizeof (LrgRenderSprite));
+	priv->sort_entries = g_array_new (FALSE, FALSE, sizeof (RenderSortEntry));
+	priv->sort_scratch = g_array_new (FALSE, FALSE, sizeof (RenderSortEntry));
+	priv->batch_sprites = g_array_new (FALSE, FALSE, sizeof (LrgRenderSprite));
+	priv->texture_ids = g_hash_table_new (g_direct_hash, g_direct_equal);
+	priv->shader_ids = g_hash_table_new (g_direct_hash, g_direct_equal);
+	priv->batch_count = 0;
+	priv->sprite_count = 0;
 }
 
 /* ==========================================================================
@@ -357,10 +702,15 @@ lrg_renderer_new (LrgWindow *window)
 void
 lrg_renderer_begin_frame (LrgRenderer *self)
 {
-	LrgRendererClass *klass;
+	LrgRendererClass   *klass;
+	LrgRendererPrivate *priv;
 
 	g_return_if_fail (LRG_IS_RENDERER (self));
 
+	priv = lrg_renderer_get_instance_private (self);
+	priv->batch_count = 0;
+	priv->sprite_count = 0;
+
 	klass = LRG_RENDERER_GET_CLASS (self);
 	if (klass->begin_frame != NULL)
 		klass->begin_frame (self);
@@ -486,6 +836,9 @@ lrg_renderer_end_layer (LrgRenderer *self)
 	if (!priv->in_layer)
 		return;
 
+	/* Draw queued work while the layer's camera is still active */
+	flush_queue (self);
+
 	/* End camera transform if it was active */
 	if (priv->camera_active && priv->camera != NULL)
 	{
@@ -529,6 +882,165 @@ lrg_renderer_render_drawable (LrgRenderer *self,
 	lrg_drawable_draw (drawable, delta);
 }
 
+guint64
+lrg_renderer_pack_sort_key (guint   sort_layer,
+                            guint   blend_mode,
+                            guint   shader_id,
+                            guint   texture_id,
+                            gfloat  depth)
+{
+	return ((guint64)(sort_layer & 0xff) << KEY_LAYER_SHIFT) |
+	       ((guint64)(blend_mode & 0xf) << KEY_BLEND_SHIFT) |
+	       ((guint64)(shader_id & MAX_SHADER_ID) << KEY_SHADER_SHIFT) |
+	       ((guint64)(texture_id & MAX_TEXTURE_ID) << KEY_TEXTURE_SHIFT) |
+	       (guint64)depth_to_bits (depth);
+}
+
+/*
+ * Small ids keep keys compact. The tables are emptied at the end of
+ * every frame, so ids only run out when one frame uses more objects
+ * than fit; those then share the last id, and since batching still
+ * compares pointers they only group less tightly.
+ */
+static guint
+lookup_id (GHashTable *ids,
+           gpointer    object,
+           guint       max_id)
+{
+	gpointer id;
+
+	if (object == NULL)
+		return 0;
+
+	id = g_hash_table_lookup (ids, object);
+	if (id == NULL)
+	{
+		id = GUINT_TO_POINTER (MIN (g_hash_table_size (ids) + 1, max_id));
+		g_hash_table_insert (ids, object, id);
+	}
+
+	return GPOINTER_TO_UINT (id);
+}
+
+guint64
+lrg_renderer_make_sort_key (LrgRenderer  *self,
+                            guint         sort_layer,
+                            GrlBlendMode  blend_mode,
+                            GrlShader    *shader,
+                            GrlTexture   *texture,
+                            gfloat        depth)
+{
+	LrgRendererPrivate *priv;
+
+	g_return_val_if_fail (LRG_IS_RENDERER (self), 0);
+
+	priv = lrg_renderer_get_instance_private (self);
+
+	return lrg_renderer_pack_sort_key (sort_layer,
+	                                   (guint)blend_mode,
+	                                   lookup_id (priv->shader_ids, shader, MAX_SHADER_ID),
+	                                   lookup_id (priv->texture_ids, texture, MAX_TEXTURE_ID),
+	                                   depth);
+}
+
+void
+lrg_renderer_submit_sprite (LrgRenderer        *self,
+                            guint64             key,
+                            GrlShader          *shader,
+                            GrlTexture         *texture,
+                            const GrlRectangle *source,
+                            const GrlRectangle *dest,
+                            const GrlVector2   *origin,
+                            gfloat              rotation,
+                            const GrlColor     *tint)
+{
+	LrgRendererPrivate *priv;
+	LrgRenderSprite     sprite;
+	RenderItem          item;
+
+	g_return_if_fail (LRG_IS_RENDERER (self));
+	g_return_if_fail (source != NULL);
+	g_return_if_fail (dest != NULL);
+
+	priv = lrg_renderer_get_instance_private (self);
+
+	g_return_if_fail (priv->in_layer);
+
+	sprite.texture = texture;
+	sprite.source = *source;
+	sprite.dest = *dest;
+	sprite.origin.x = origin != NULL ? origin->x : 0.0f;
+	sprite.origin.y = origin != NULL ? origin->y : 0.0f;
+	sprite.rotation = rotation;
+	if (tint != NULL)
+	{
+		sprite.tint = *tint;
+	}
+	else
+	{
+		sprite.tint.r = 255;
+		sprite.tint.g = 255;
+		sprite.tint.b = 255;
+		sprite.tint.a = 255;
+	}
+
+	item.key = key;
+	item.shader = shader;
+	item.drawable = NULL;
+	item.delta = 0.0f;
+	item.sprite = priv->queue_sprites->len;
+
+	g_array_append_val (priv->queue_sprites, sprite);
+	g_array_append_val (priv->queue_items, item);
+}
+
+void
+lrg_renderer_submit_drawable (LrgRenderer *self,
+                              guint64      key,
+                              LrgDrawable *drawable,
+                              gfloat       delta)
+{
+	LrgRendererPrivate *priv;
+	RenderItem          item;
+
+	g_return_if_fail (LRG_IS_RENDERER (self));
+	g_return_if_fail (LRG_IS_DRAWABLE (drawable));
+
+	priv = lrg_renderer_get_instance_private (self);
+
+	g_return_if_fail (priv->in_layer);
+
+	item.key = key;
+	item.shader = NULL;
+	item.drawable = g_object_ref (drawable);
+	item.delta = delta;
+	item.sprite = 0;
+
+	g_array_append_val (priv->queue_items, item);
+}
+
+guint
+lrg_renderer_get_batch_count (LrgRenderer *self)
+{
+	LrgRendererPrivate *priv;
+
+	g_return_val_if_fail (LRG_IS_RENDERER (self), 0);
+
+	priv = lrg_renderer_get_instance_private (self);
+	return priv->batch_count;
+}
+
+guint
+lrg_renderer_get_sprite_count (LrgRenderer *self)
+{
+	LrgRendererPrivate *priv;
+
+	g_return_val_if_fail (LRG_IS_RENDERER (self), 0);
+
+	priv = lrg_renderer_get_instance_private (self);
+	return priv->sprite_count;
+}
+
 void
 lrg_renderer_set_background_color (LrgRenderer *self,
                                    GrlColor    *color)
@@ -24,6 +24,57 @@
 
 G_BEGIN_DECLS
 
+/* ==========================================================================
+ * Render Queue Types
+ * ========================================================================== */
+
+/**
+ * LrgRenderSprite:
+ * @texture: (nullable): the texture, or %NULL for a solid rectangle
+ * @source: region of @texture to draw
+ * @dest: destination rectangle
+ * @origin: rotation origin, relative to @dest
+ * @rotation: rotation in degrees
+ * @tint: tint color
+ *
+ * One queued textured quad, with the same meaning as the arguments
+ * of grl_draw_texture_pro().
+ */
+typedef struct
+{
+	GrlTexture   *texture;
+	GrlRectangle  source;
+	GrlRectangle  dest;
+	GrlVector2    origin;
+	gfloat        rotation;
+	GrlColor      tint;
+} LrgRenderSprite;
+
+/**
+ * LrgRenderBatch:
+ * @layer: the layer the batch was submitted to
+ * @key: sort key of the first item in the batch
+ * @shader: (nullable): shader the batch is drawn with
+ * @sprites: (array length=n_sprites): sprites sharing texture, blend
+ *   mode and shader, in draw order
+ * @n_sprites: number of sprites, 0 for a drawable batch
+ * @drawable: (nullable): the drawable, for a drawable batch
+ * @delta: time delta passed to @drawable
+ *
+ * A run of queued work that is drawn with one state change. A batch
+ * holds either sprites or a single #LrgDrawable.
+ */
+typedef struct
+{
+	LrgRenderLayer          layer;
+	guint64                 key;
+	GrlShader              *shader;
+	const LrgRenderSprite  *sprites;
+	guint                   n_sprites;
+	LrgDrawable            *drawable;
+	gfloat                  delta;
+} LrgRenderBatch;
+
 #define LRG_TYPE_RENDERER (lrg_renderer_get_type ())
 
 LRG_AVAILABLE_IN_ALL
@@ -36,6 +87,7 @@ G_DECLARE_DERIVABLE_TYPE (LrgRenderer, lrg_renderer, LRG, RENDERER, GObject)
  * @end_frame: End the current frame
  * @render_layer: Render a specific layer
  * @clear: Clear the screen with a color
+ * @draw_batch: Draw one batch from the render queue
  *
  * Class for render management. Can be subclassed for custom
  * rendering pipelines or post-processing effects.
@@ -82,8 +134,20 @@ struct _LrgRendererClass
 	void (*clear) (LrgRenderer *self,
 	               GrlColor    *color);
 
+	/**
+	 * LrgRendererClass::draw_batch:
+	 * @self: an #LrgRenderer
+	 * @batch: the batch to draw
+	 *
+	 * Draw one batch when the render queue is flushed. The default
+	 * implementation draws through graylib; override it to record
+	 * or redirect queued work.
+	 */
+	void (*draw_batch) (LrgRenderer          *self,
+	                    const LrgRenderBatch *batch);
+
 	/*< private >*/
-	gpointer _reserved[8];
+	gpointer _reserved[7];
 };
 
 /**
@@ -180,8 +244,9 @@ void lrg_renderer_begin_layer (LrgRenderer    *self,
  * lrg_renderer_end_layer:
  * @self: an #LrgRenderer
  *
- * End rendering the current layer. This will restore the
- * previous rendering state (e.g., end camera mode if applicable).
+ * End rendering the current layer. Work queued on the layer is
+ * sorted and drawn first, then the previous rendering state is
+ * restored (e.g., end camera mode if applicable).
  */
 LRG_AVAILABLE_IN_ALL
 void lrg_renderer_end_layer (LrgRenderer *self);
@@ -229,6 +294,125 @@ void lrg_renderer_render_drawable (LrgRenderer *self,
                                    LrgDrawable *drawable,
                                    gfloat       delta);
 
+/* ==========================================================================
+ * Render Queue
+ * ========================================================================== */
+
+/**
+ * lrg_renderer_pack_sort_key:
+ * @sort_layer: explicit draw order within a layer, 0-255
+ * @blend_mode: blend mode, 0-15
+ * @shader_id: shader identifier, 0-4095, 0 for the default shader
+ * @texture_id: texture identifier, 0-65535
+ * @depth: order among items with the same state, lower first
+ *
+ * Packs a render queue sort key. From the most significant bits the
+ * key holds the sort layer (8 bits), blend mode (4), shader (12),
+ * texture (16) and depth (24), so within a sort layer items sharing
+ * state end up next to each other and can be batched. Put sprites
+ * that must overlap in a fixed order on different sort layers.
+ *
+ * Returns: the packed key
+ */
+LRG_AVAILABLE_IN_ALL
+guint64 lrg_renderer_pack_sort_key (guint   sort_layer,
+                                    guint   blend_mode,
+                                    guint   shader_id,
+                                    guint   texture_id,
+                                    gfloat  depth);
+
+/**
+ * lrg_renderer_make_sort_key:
+ * @self: an #LrgRenderer
+ * @sort_layer: explicit draw order within a layer, 0-255
+ * @blend_mode: the blend mode
+ * @shader: (nullable): the shader, or %NULL for the default
+ * @texture: (nullable): the texture
+ * @depth: order among items with the same state, lower first
+ *
+ * Packs a sort key like lrg_renderer_pack_sort_key(), assigning
+ * small identifiers to @shader and @texture the first time each is
+ * seen in the current frame. Identifiers are reassigned after
+ * lrg_renderer_end_frame(), so keys are only valid until then.
+ *
+ * Returns: the packed key
+ */
+LRG_AVAILABLE_IN_ALL
+guint64 lrg_renderer_make_sort_key (LrgRenderer  *self,
+                                    guint         sort_layer,
+                                    GrlBlendMode  blend_mode,
+                                    GrlShader    *shader,
+                                    GrlTexture   *texture,
+                                    gfloat        depth);
+
+/**
+ * lrg_renderer_submit_sprite:
+ * @self: an #LrgRenderer
+ * @key: sort key, see lrg_renderer_make_sort_key()
+ * @shader: (nullable): shader to draw with
+ * @texture: (nullable): the texture, or %NULL for a solid rectangle
+ * @source: region of @texture to draw
+ * @dest: destination rectangle
+ * @origin: (nullable): rotation origin relative to @dest
+ * @rotation: rotation in degrees
+ * @tint: (nullable): tint color, white if %NULL
+ *
+ * Queues a sprite on the current layer. Queued work is sorted by key
+ * and drawn in batches by lrg_renderer_end_layer(). The blend mode is
+ * taken from @key. @texture and @shader are not referenced and must
+ * stay alive until the layer ends.
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_renderer_submit_sprite (LrgRenderer        *self,
+                                 guint64             key,
+                                 GrlShader          *shader,
+                                 GrlTexture         *texture,
+                                 const GrlRectangle *source,
+                                 const GrlRectangle *dest,
+                                 const GrlVector2   *origin,
+                                 gfloat              rotation,
+                                 const GrlColor     *tint);
+
+/**
+ * lrg_renderer_submit_drawable:
+ * @self: an #LrgRenderer
+ * @key: sort key, see lrg_renderer_pack_sort_key()
+ * @drawable: (transfer none): the drawable
+ * @delta: the time delta passed to lrg_drawable_draw()
+ *
+ * Queues a drawable on the current layer. It is drawn on its own
+ * between the sprite batches around it in key order.
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_renderer_submit_drawable (LrgRenderer *self,
+                                   guint64      key,
+                                   LrgDrawable *drawable,
+                                   gfloat       delta);
+
+/**
+ * lrg_renderer_get_batch_count:
+ * @self: an #LrgRenderer
+ *
+ * Get the number of batches drawn from the render queue since the
+ * current frame began. Each batch is one draw call.
+ *
+ * Returns: the batch count
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_renderer_get_batch_count (LrgRenderer *self);
+
+/**
+ * lrg_renderer_get_sprite_count:
+ * @self: an #LrgRenderer
+ *
+ * Get the number of sprites drawn from the render queue since the
+ * current frame began.
+ *
+ * Returns: the sprite count
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_renderer_get_sprite_count (LrgRenderer *self);
+
 /* ==========================================================================
  * Background Color
  * ========================================================================== */
@@ -55,6 +55,26 @@
  *
  *   This matches the order in which the GrlImage rasterizer applies the
  *   stack (innermost last-pushed = applied first to shape vertices).
+ *
+ * Raster cache
+ * ~~~~~~~~~~~~
+ * The shapes never change after loading, so a raster depends only on the
+ * target size, the transform class (stretch or letterbox) and the
+ * background colour.  Those form the RasterKey.  Entries live in a hash
+ * table and a GQueue ordered by last use; inserting past the byte budget
+ * evicts from the tail.  render() hands out copies so callers may draw on
+ * the result; render_to_texture() uploads once per entry and hands out
+ * references to the shared texture.  Texture bytes count against the
+ * budget too.
+ *
+ * Tiled rasterization
+ * ~~~~~~~~~~~~~~~~~~~
+ * With a tile size set, targets larger than one tile are split into
+ * tile_size squares.  Each tile is rasterized into its own small image
+ * with an extra translation by the tile origin, then its rows are copied
+ * into the target.  Tiles write disjoint pixels, so workers share the
+ * target buffer without locking; the shapes are only read.  The result is
+ * the same whatever the thread count.
  */
 
 /* Use the same log domain string as the other graphics-module sources */
@@ -64,9 +84,47 @@
 
 #include "lrg-vector-image.h"
 #include "../lrg-log.h"
+#include <raylib.h>
+
+/* Raster cache budget of a new image, in bytes */
+#define DEFAULT_CACHE_BUDGET    (4 * 1024 * 1024)
+
+/* Rasters are RGBA8 */
+#define BYTES_PER_PIXEL         (4)
 
 /* -------------------------------------------------------------------------- */
 
+typedef struct
+{
+    gint     width;
+    gint     height;
+    guint32  background;      /* packed RGBA; NULL means transparent */
+    gboolean preserve_aspect;
+} RasterKey;
+
+typedef struct
+{
+    RasterKey   key;
+    GrlImage   *image;
+    GrlTexture *texture;      /* uploaded on first render_to_texture() */
+    gsize       bytes;
+    GList       link;
+} RasterEntry;
+
+typedef struct
+{
+    LrgVectorImage *self;
+    const GrlColor *bg;
+    gboolean        preserve_aspect;
+    gint            width;    /* whole target */
+    gint            height;
+    gint            x;        /* tile origin and size within the target */
+    gint            y;
+    gint            tile_w;
+    gint            tile_h;
+    guint8         *dest;     /* target pixels */
+} RasterTile;
+
 struct _LrgVectorImage
 {
     GObject parent_instance;
@@ -78,6 +136,22 @@ struct _LrgVectorImage
     /* Union bounding box of all shapes (SVG user units) */
     GrlRectangle     src_bounds;
     gboolean         src_bounds_valid;
+
+    /* Raster cache, most recently used at the head */
+    GHashTable      *cache;
+    GQueue           cache_lru;
+    gsize            cache_bytes;
+    gsize            cache_budget;
+    guint            cache_hits;
+    guint            cache_misses;
+
+    /* Tiled rasterization; tile_size 0 disables it */
+    gint             tile_size;
+    guint            max_threads;
+    GThreadPool     *pool;
+    GMutex           lock;
+    GCond            cond;
+    guint            pending;
 };
 
 G_DEFINE_TYPE (LrgVectorImage, lrg_vector_image, G_TYPE_OBJECT)
@@ -311,47 +385,27 @@ init_from_shapes (LrgVectorImage *self,
 }
 
 /*
- * do_render:
+ * setup_transform:
  *
- * Internal rasterization.  Creates a @width × @height RGBA GrlImage,
- * optionally fills it with @bg, sets up the coordinate transform, and
- * calls grl_image_draw_svg_shapes().
+ * Pushes the source-to-target transform onto @img (see the design notes).
+ * @offset_x/@offset_y shift the target so that @img holds the window of
+ * the full @width × @height render starting at that pixel.
  */
-static GrlImage *
-do_render (LrgVectorImage  *self,
-           gint             width,
-           gint             height,
-           const GrlColor  *bg_or_null,
-           gboolean         preserve_aspect)
+static void
+setup_transform (LrgVectorImage *self,
+                 GrlImage       *img,
+                 gint            width,
+                 gint            height,
+                 gboolean        preserve_aspect,
+                 gint            offset_x,
+                 gint            offset_y)
 {
-    g_autoptr(GrlImage) img  = NULL;
-    g_autoptr(GrlColor) fill = NULL;
-    gfloat              src_x;
-    gfloat              src_y;
-    gfloat              src_w;
-    gfloat              src_h;
-    gfloat              sx;
-    gfloat              sy;
-
-    /*
-     * grl_image_new_color() takes a GrlColor* (non-const) and uses it only
-     * for the initial fill; it does not take ownership.  We either copy the
-     * caller's colour or create a fully-transparent one.
-     */
-    if (bg_or_null != NULL)
-        fill = grl_color_copy (bg_or_null);
-    else
-        fill = grl_color_new (0, 0, 0, 0);
-
-    img = grl_image_new_color (width, height, fill);
-
-    if (img == NULL)
-    {
-        lrg_log_debug ("LrgVectorImage: grl_image_new_color returned NULL");
-        return NULL;
-    }
-
-    grl_image_set_antialias (img, TRUE);
+    gfloat src_x;
+    gfloat src_y;
+    gfloat src_w;
+    gfloat src_h;
+    gfloat sx;
+    gfloat sy;
 
     /* Determine source extent.  Fall back to (0,0,1,1) so we do not
      * divide by zero even with a degenerate SVG. */
@@ -397,7 +451,7 @@ do_render (LrgVectorImage  *self,
          * The rasterizer applies the stack from bottom to top (last-set
          * innermost), so vertices are processed as: T_origin · S · T_centre.
          */
-        grl_image_translate (img, ox,     oy);
+        grl_image_translate (img, ox - (gfloat) offset_x, oy - (gfloat) offset_y);
         grl_image_scale     (img, scale,  scale);
         grl_image_translate (img, -src_x, -src_y);
     }
@@ -407,19 +461,358 @@ do_render (LrgVectorImage  *self,
         sx = (gfloat) width  / src_w;
         sy = (gfloat) height / src_h;
 
+        if (offset_x != 0 || offset_y != 0)
+            grl_image_translate (img, (gfloat) -offset_x, (gfloat) -offset_y);
         grl_image_scale     (img, sx,     sy);
         grl_image_translate (img, -src_x, -src_y);
     }
+}
+
+/*
+ * rasterize_region:
+ *
+ * Creates a @region_w × @region_h RGBA GrlImage, fills it with @bg (or
+ * transparent), and draws the shapes as they fall in the window at
+ * (@x, @y) of a @width × @height render.
+ */
+static GrlImage *
+rasterize_region (LrgVectorImage  *self,
+                  gint             width,
+                  gint             height,
+                  gint             x,
+                  gint             y,
+                  gint             region_w,
+                  gint             region_h,
+                  const GrlColor  *bg_or_null,
+                  gboolean         preserve_aspect)
+{
+    g_autoptr(GrlImage) img  = NULL;
+    g_autoptr(GrlColor) fill = NULL;
+
+    /*
+     * grl_image_new_color() takes a GrlColor* (non-const) and uses it only
+     * for the initial fill; it does not take ownership.  We either copy the
+     * caller's colour or create a fully-transparent one.
+     */
+    if (bg_or_null != NULL)
+        fill = grl_color_copy (bg_or_null);
+    else
+        fill = grl_color_new (0, 0, 0, 0);
+
+    img = grl_image_new_color (region_w, region_h, fill);
+
+    if (img == NULL)
+    {
+        lrg_log_debug ("LrgVectorImage: grl_image_new_color returned NULL");
+        return NULL;
+    }
+
+    grl_image_set_antialias (img, TRUE);
+    setup_transform (self, img, width, height, preserve_aspect, x, y);
 
     grl_image_draw_svg_shapes (img,
                                (GrlVectorShape * const *) self->shapes,
                                self->n_shapes);
 
+    return g_steal_pointer (&img);
+}
+
+static void
+draw_tile (RasterTile *tile)
+{
+    g_autoptr(GrlImage) img = NULL;
+    const guint8       *src;
+    gsize               row_bytes;
+    gint                row;
+
+    img = rasterize_region (tile->self, tile->width, tile->height,
+                            tile->x, tile->y, tile->tile_w, tile->tile_h,
+                            tile->bg, tile->preserve_aspect);
+    if (img == NULL)
+        return;
+
+    src = ((Image *) grl_image_get_handle (img))->data;
+    row_bytes = (gsize) tile->tile_w * BYTES_PER_PIXEL;
+
+    for (row = 0; row < tile->tile_h; row++)
+    {
+        gsize dest_offset;
+
+        dest_offset = ((gsize) (tile->y + row) * (gsize) tile->width + (gsize) tile->x)
+                      * BYTES_PER_PIXEL;
+        memcpy (tile->dest + dest_offset, src + (gsize) row * row_bytes, row_bytes);
+    }
+}
+
+static void
+run_tile (gpointer data,
+          gpointer user_data)
+{
+    RasterTile     *tile = data;
+    LrgVectorImage *self = tile->self;
+
+    (void) user_data;
+
+    draw_tile (tile);
+
+    g_mutex_lock (&self->lock);
+    if (--self->pending == 0)
+        g_cond_signal (&self->cond);
+    g_mutex_unlock (&self->lock);
+}
+
+/*
+ * render_tiled:
+ *
+ * Rasterizes tile by tile, on the worker pool when more than one thread
+ * is allowed.  Returns %NULL if the target is not RGBA8, in which case
+ * the caller renders in one piece.
+ */
+static GrlImage *
+render_tiled (LrgVectorImage  *self,
+              gint             width,
+              gint             height,
+              const GrlColor  *bg_or_null,
+              gboolean         preserve_aspect)
+{
+    g_autoptr(GrlImage) img  = NULL;
+    g_autoptr(GrlColor) fill = NULL;
+    RasterTile         *tiles;
+    guint8             *dest;
+    guint               threads;
+    gint                cols;
+    gint                rows;
+    gint                n_tiles;
+    gint                i;
+
+    if (bg_or_null != NULL)
+        fill = grl_color_copy (bg_or_null);
+    else
+        fill = grl_color_new (0, 0, 0, 0);
+
+    img = grl_image_new_color (width, height, fill);
+    if (img == NULL ||
+        grl_image_get_format (img) != GRL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+        return NULL;
+
+    dest = ((Image *) grl_image_get_handle (img))->data;
+
+    cols = (width  + self->tile_size - 1) / self->tile_size;
+    rows = (height + self->tile_size - 1) / self->tile_size;
+    n_tiles = cols * rows;
+    tiles = g_new (RasterTile, n_tiles);
+
+    for (i = 0; i < n_tiles; i++)
+    {
+        RasterTile *tile = &tiles[i];
+
+        tile->self = self;
+        tile->bg = bg_or_null;
+        tile->preserve_aspect = preserve_aspect;
+        tile->width = width;
+        tile->height = height;
+        tile->x = (i % cols) * self->tile_size;
+        tile->y = (i / cols) * self->tile_size;
+        tile->tile_w = MIN (self->tile_size, width  - tile->x);
+        tile->tile_h = MIN (self->tile_size, height - tile->y);
+        tile->dest = dest;
+    }
+
+    threads = self->max_threads > 0 ? self->max_threads
+                                    : (guint) MAX (1, g_get_num_processors ());
+
+    if (threads <= 1)
+    {
+        for (i = 0; i < n_tiles; i++)
+            draw_tile (&tiles[i]);
+    }
+    else
+    {
+        if (self->pool == NULL)
+            self->pool = g_thread_pool_new (run_tile, NULL, threads, FALSE, NULL);
+        else if ((guint) g_thread_pool_get_max_threads (self->pool) != threads)
+            g_thread_pool_set_max_threads (self->pool, threads, NULL);
+
+        g_mutex_lock (&self->lock);
+        self->pending = n_tiles;
+        g_mutex_unlock (&self->lock);
+
+        for (i = 0; i < n_tiles; i++)
+            g_thread_pool_push (self->pool, &tiles[i], NULL);
+
+        g_mutex_lock (&self->lock);
+        while (self->pending > 0)
+            g_cond_wait (&self->cond, &self->lock);
+        g_mutex_unlock (&self->lock);
+    }
+
+    g_free (tiles);
+
+    return g_steal_pointer (&img);
+}
+
+/*
+ * do_render:
+ *
+ * Internal rasterization of the whole @width × @height target, tiled
+ * when a tile size is set and the target exceeds one tile.
+ */
+static GrlImage *
+do_render (LrgVectorImage  *self,
+           gint             width,
+           gint             height,
+           const GrlColor  *bg_or_null,
+           gboolean         preserve_aspect)
+{
+    GrlImage *img = NULL;
+
+    if (self->tile_size > 0 &&
+        (width > self->tile_size || height > self->tile_size))
+        img = render_tiled (self, width, height, bg_or_null, preserve_aspect);
+
+    if (img == NULL)
+        img = rasterize_region (self, width, height, 0, 0, width, height,
+                                bg_or_null, preserve_aspect);
+
     lrg_log_debug ("LrgVectorImage: rendered %ux%u (preserve_aspect=%s)",
                    (guint) width, (guint) height,
                    preserve_aspect ? "yes" : "no");
 
-    return g_steal_pointer (&img);
+    return img;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Raster cache                                                                */
+/* -------------------------------------------------------------------------- */
+
+static guint
+raster_key_hash (gconstpointer data)
+{
+    const RasterKey *key = data;
+    guint            hash;
+
+    hash = (guint) key->width;
+    hash = hash * 31u + (guint) key->height;
+    hash = hash * 31u + key->background;
+    hash = hash * 31u + (key->preserve_aspect ? 1u : 0u);
+
+    return hash;
+}
+
+static gboolean
+raster_key_equal (gconstpointer a,
+                  gconstpointer b)
+{
+    const RasterKey *ka = a;
+    const RasterKey *kb = b;
+
+    return ka->width == kb->width &&
+           ka->height == kb->height &&
+           ka->background == kb->background &&
+           ka->preserve_aspect == kb->preserve_aspect;
+}
+
+static void
+raster_entry_free (gpointer data)
+{
+    RasterEntry *entry = data;
+
+    g_clear_object (&entry->image);
+    g_clear_object (&entry->texture);
+    g_slice_free (RasterEntry, entry);
+}
+
+static void
+raster_key_init (RasterKey      *key,
+                 gint            width,
+                 gint            height,
+                 const GrlColor *bg_or_null,
+                 gboolean        preserve_aspect)
+{
+    key->width = width;
+    key->height = height;
+    key->background = 0;
+    if (bg_or_null != NULL)
+        key->background = ((guint32) bg_or_null->r << 24) |
+                          ((guint32) bg_or_null->g << 16) |
+                          ((guint32) bg_or_null->b << 8) |
+                          (guint32) bg_or_null->a;
+    key->preserve_aspect = preserve_aspect ? TRUE : FALSE;
+}
+
+static void
+cache_remove (LrgVectorImage *self,
+              RasterEntry    *entry)
+{
+    g_queue_unlink (&self->cache_lru, &entry->link);
+    self->cache_bytes -= entry->bytes;
+    g_hash_table_remove (self->cache, &entry->key);
+}
+
+static void
+cache_trim (LrgVectorImage *self)
+{
+    while (self->cache_bytes > self->cache_budget && self->cache_lru.tail != NULL)
+        cache_remove (self, self->cache_lru.tail->data);
+}
+
+/*
+ * cache_lookup:
+ *
+ * Returns the entry for @key and marks it most recently used, or %NULL
+ * on a miss.  Counts the hit or miss.
+ */
+static RasterEntry *
+cache_lookup (LrgVectorImage  *self,
+              const RasterKey *key)
+{
+    RasterEntry *entry;
+
+    entry = g_hash_table_lookup (self->cache, key);
+    if (entry == NULL)
+    {
+        self->cache_misses++;
+        return NULL;
+    }
+
+    g_queue_unlink (&self->cache_lru, &entry->link);
+    g_queue_push_head_link (&self->cache_lru, &entry->link);
+    self->cache_hits++;
+
+    return entry;
+}
+
+/*
+ * cache_insert:
+ *
+ * Caches a reference to @image under @key, evicting least recently used
+ * entries to stay in budget.  Returns %NULL without caching when @image
+ * alone exceeds the budget.
+ */
+static RasterEntry *
+cache_insert (LrgVectorImage  *self,
+              const RasterKey *key,
+              GrlImage        *image)
+{
+    RasterEntry *entry;
+    gsize        bytes;
+
+    bytes = (gsize) key->width * (gsize) key->height * BYTES_PER_PIXEL;
+    if (bytes > self->cache_budget)
+        return NULL;
+
+    entry = g_slice_new0 (RasterEntry);
+    entry->key = *key;
+    entry->image = g_object_ref (image);
+    entry->bytes = bytes;
+    entry->link.data = entry;
+
+    g_hash_table_insert (self->cache, &entry->key, entry);
+    g_queue_push_head_link (&self->cache_lru, &entry->link);
+    self->cache_bytes += bytes;
+    cache_trim (self);
+
+    return entry;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -432,6 +825,16 @@ lrg_vector_image_finalize (GObject *object)
     LrgVectorImage *self = LRG_VECTOR_IMAGE (object);
     guint           i;
 
+    if (self->pool != NULL)
+    {
+        g_thread_pool_free (self->pool, FALSE, TRUE);
+        self->pool = NULL;
+    }
+
+    g_hash_table_unref (self->cache);
+    g_mutex_clear (&self->lock);
+    g_cond_clear (&self->cond);
+
     if (self->shapes != NULL)
     {
         for (i = 0; i < self->n_shapes; i++)
@@ -462,6 +865,21 @@ lrg_vector_image_init (LrgVectorImage *self)
     self->src_bounds.width  = 0.0f;
     self->src_bounds.height = 0.0f;
     self->src_bounds_valid  = FALSE;
+
+    self->cache = g_hash_table_new_full (raster_key_hash, raster_key_equal,
+                                         NULL, raster_entry_free);
+    g_queue_init (&self->cache_lru);
+    self->cache_bytes  = 0;
+    self->cache_budget = DEFAULT_CACHE_BUDGET;
+    self->cache_hits   = 0;
+    self->cache_misses = 0;
+
+    self->tile_size   = 0;
+    self->max_threads = 0;
+    self->pool        = NULL;
+    g_mutex_init (&self->lock);
+    g_cond_init (&self->cond);
+    self->pending     = 0;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -620,7 +1038,8 @@ lrg_vector_image_get_shape_count (LrgVectorImage *self)
  * @bg_or_null: (nullable): background fill colour
  * @preserve_aspect: if %TRUE, letterbox the artwork
  *
- * Rasterizes the vector image to a new #GrlImage.
+ * Rasterizes the vector image to a new #GrlImage, or copies a cached
+ * raster of the same size, background and aspect mode.
  *
  * Returns: (transfer full) (nullable): a new #GrlImage, or %NULL on error
  */
@@ -631,6 +1050,10 @@ lrg_vector_image_render (LrgVectorImage  *self,
                          const GrlColor  *bg_or_null,
                          gboolean         preserve_aspect)
 {
+    g_autoptr(GrlImage) image = NULL;
+    RasterEntry        *entry;
+    RasterKey           key;
+
     g_return_val_if_fail (LRG_IS_VECTOR_IMAGE (self), NULL);
 
     if (width <= 0 || height <= 0)
@@ -640,7 +1063,20 @@ lrg_vector_image_render (LrgVectorImage  *self,
         return NULL;
     }
 
-    return do_render (self, width, height, bg_or_null, preserve_aspect);
+    raster_key_init (&key, width, height, bg_or_null, preserve_aspect);
+    entry = cache_lookup (self, &key);
+    if (entry != NULL)
+        return grl_image_copy (entry->image);
+
+    image = do_render (self, width, height, bg_or_null, preserve_aspect);
+    if (image == NULL)
+        return NULL;
+
+    /* The cache keeps the original; callers get a copy they may draw on */
+    if (cache_insert (self, &key, image) == NULL)
+        return g_steal_pointer (&image);
+
+    return grl_image_copy (image);
 }
 
 /**
@@ -652,8 +1088,9 @@ lrg_vector_image_render (LrgVectorImage  *self,
  * @preserve_aspect: if %TRUE, letterbox the artwork
  *
  * Rasterizes the vector image and uploads it to the GPU as a #GrlTexture.
+ * Cached rasters are uploaded once and the texture is shared.
  *
- * Returns: (transfer full) (nullable): a new #GrlTexture, or %NULL on error
+ * Returns: (transfer full) (nullable): a #GrlTexture, or %NULL on error
  */
 GrlTexture *
 lrg_vector_image_render_to_texture (LrgVectorImage  *self,
@@ -662,7 +1099,10 @@ lrg_vector_image_render_to_texture (LrgVectorImage  *self,
                                     const GrlColor  *bg_or_null,
                                     gboolean         preserve_aspect)
 {
-    g_autoptr(GrlImage) image = NULL;
+    g_autoptr(GrlImage)   image   = NULL;
+    g_autoptr(GrlTexture) texture = NULL;
+    RasterEntry          *entry;
+    RasterKey             key;
 
     g_return_val_if_fail (LRG_IS_VECTOR_IMAGE (self), NULL);
 
@@ -673,9 +1113,166 @@ lrg_vector_image_render_to_texture (LrgVectorImage  *self,
         return NULL;
     }
 
-    image = do_render (self, width, height, bg_or_null, preserve_aspect);
-    if (image == NULL)
+    raster_key_init (&key, width, height, bg_or_null, preserve_aspect);
+    entry = cache_lookup (self, &key);
+    if (entry == NULL)
+    {
+        image = do_render (self, width, height, bg_or_null, preserve_aspect);
+        if (image == NULL)
+            return NULL;
+
+        entry = cache_insert (self, &key, image);
+        if (entry == NULL)
+            return grl_texture_new_from_image (image);
+    }
+
+    if (entry->texture != NULL)
+        return g_object_ref (entry->texture);
+
+    texture = grl_texture_new_from_image (entry->image);
+    if (texture == NULL)
         return NULL;
 
-    return grl_texture_new_from_image (image);
+    /* The texture counts against the budget and may evict this entry */
+    entry->texture = g_object_ref (texture);
+    self->cache_bytes += (gsize) width * (gsize) height * BYTES_PER_PIXEL;
+    entry->bytes += (gsize) width * (gsize) height * BYTES_PER_PIXEL;
+    cache_trim (self);
+
+    return g_steal_pointer (&texture);
+}
+
+/**
+ * lrg_vector_image_set_cache_budget:
+ * @self: an #LrgVectorImage
+ * @bytes: raster cache budget in bytes, 0 to disable caching
+ *
+ * Sets the raster cache budget, evicting least recently used rasters
+ * that no longer fit.
+ */
+void
+lrg_vector_image_set_cache_budget (LrgVectorImage *self,
+                                   gsize           bytes)
+{
+    g_return_if_fail (LRG_IS_VECTOR_IMAGE (self));
+
+    self->cache_budget = bytes;
+    cache_trim (self);
+}
+
+/**
+ * lrg_vector_image_get_cache_budget:
+ * @self: an #LrgVectorImage
+ *
+ * Returns: the raster cache budget in bytes
+ */
+gsize
+lrg_vector_image_get_cache_budget (LrgVectorImage *self)
+{
+    g_return_val_if_fail (LRG_IS_VECTOR_IMAGE (self), 0);
+
+    return self->cache_budget;
+}
+
+/**
+ * lrg_vector_image_clear_cache:
+ * @self: an #LrgVectorImage
+ *
+ * Drops every cached raster.  The hit and miss counters are kept.
+ */
+void
+lrg_vector_image_clear_cache (LrgVectorImage *self)
+{
+    g_return_if_fail (LRG_IS_VECTOR_IMAGE (self));
+
+    g_hash_table_remove_all (self->cache);
+    g_queue_init (&self->cache_lru);
+    self->cache_bytes = 0;
+}
+
+/**
+ * lrg_vector_image_get_cache_stats:
+ * @self: an #LrgVectorImage
+ * @out_hits: (out) (nullable): return location for the hit count
+ * @out_misses: (out) (nullable): return location for the miss count
+ * @out_bytes: (out) (nullable): return location for the bytes cached
+ *
+ * Reports raster cache usage since the image was loaded.
+ */
+void
+lrg_vector_image_get_cache_stats (LrgVectorImage *self,
+                                  guint          *out_hits,
+                                  guint          *out_misses,
+                                  gsize          *out_bytes)
+{
+    g_return_if_fail (LRG_IS_VECTOR_IMAGE (self));
+
+    if (out_hits != NULL)
+        *out_hits = self->cache_hits;
+    if (out_misses != NULL)
+        *out_misses = self->cache_misses;
+    if (out_bytes != NULL)
+        *out_bytes = self->cache_bytes;
+}
+
+/**
+ * lrg_vector_image_set_tile_size:
+ * @self: an #LrgVectorImage
+ * @tile_size: tile edge in pixels, 0 to rasterize in one piece
+ *
+ * Sets the tile size used to split large rasters across worker threads.
+ */
+void
+lrg_vector_image_set_tile_size (LrgVectorImage *self,
+                                gint            tile_size)
+{
+    g_return_if_fail (LRG_IS_VECTOR_IMAGE (self));
+    g_return_if_fail (tile_size >= 0);
+
+    self->tile_size = tile_size;
+}
+
+/**
+ * lrg_vector_image_get_tile_size:
+ * @self: an #LrgVectorImage
+ *
+ * Returns: the tile edge in pixels, 0 when tiling is off
+ */
+gint
+lrg_vector_image_get_tile_size (LrgVectorImage *self)
+{
+    g_return_val_if_fail (LRG_IS_VECTOR_IMAGE (self), 0);
+
+    return self->tile_size;
+}
+
+/**
+ * lrg_vector_image_set_max_threads:
+ * @self: an #LrgVectorImage
+ * @max_threads: worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Sets how many threads rasterize tiles.
+ */
+void
+lrg_vector_image_set_max_threads (LrgVectorImage *self,
+                                  guint           max_threads)
+{
+    g_return_if_fail (LRG_IS_VECTOR_IMAGE (self));
+
+    self->max_threads = max_threads;
+}
+
+/**
+ * lrg_vector_image_get_max_threads:
+ * @self: an #LrgVectorImage
+ *
+ * Returns: the thread limit, 0 meaning one per processor
+ */
+guint
+lrg_vector_image_get_max_threads (LrgVectorImage *self)
+{
+    g_return_val_if_fail (LRG_IS_VECTOR_IMAGE (self), 0);
+
+    return self->max_threads;
 }
@@ -9,6 +9,8 @@
  * Loads an SVG asset via graylib's SVG path rasterizer and renders it
  * to a GrlImage or GrlTexture at an arbitrary target size.  Games can
  * ship scalable icon and UI assets that render crisp at any resolution.
+ * Rasters are cached per size, so redrawing an icon every frame does not
+ * rasterize it again.
  */
 
 #pragma once
@@ -160,6 +162,10 @@ lrg_vector_image_get_shape_count (LrgVectorImage *self);
  * Rasterizes the vector image into a new RGBA #GrlImage at the requested
  * pixel dimensions.  Antialiasing is enabled automatically.
  *
+ * Rasters are cached by size, background and @preserve_aspect; a cache
+ * hit returns a copy of the cached raster, so the result may be modified
+ * freely.  See lrg_vector_image_set_cache_budget().
+ *
  * When @preserve_aspect is %FALSE the artwork is stretched to fill the
  * entire @width × @height rectangle.  When %TRUE the artwork is scaled
  * uniformly to fit within the rectangle (letterboxed); pixels outside the
@@ -189,7 +195,11 @@ lrg_vector_image_render (LrgVectorImage  *self,
  * GPU as a #GrlTexture.  Equivalent to calling lrg_vector_image_render()
  * followed by grl_texture_new_from_image().
  *
- * Returns: (transfer full) (nullable): a new #GrlTexture, or %NULL on error
+ * When the raster is cached, the texture is uploaded once and later calls
+ * with the same arguments return a new reference to the same texture.
+ * Don't change its parameters (filtering, wrapping) in that case.
+ *
+ * Returns: (transfer full) (nullable): a #GrlTexture, or %NULL on error
  *
  * Since: 1.0
  */
@@ -201,4 +211,141 @@ lrg_vector_image_render_to_texture (LrgVectorImage  *self,
                                     const GrlColor  *bg_or_null,
                                     gboolean         preserve_aspect);
 
+/* ==========================================================================
+ * Raster Cache
+ * ========================================================================== */
+
+/**
+ * lrg_vector_image_set_cache_budget:
+ * @self: an #LrgVectorImage
+ * @bytes: cache budget in bytes, or 0 to disable caching
+ *
+ * Sets how much memory cached rasters of this image may use.  Each raster
+ * costs width × height × 4 bytes, twice that once uploaded by
+ * lrg_vector_image_render_to_texture().  When the budget is exceeded the
+ * least recently used rasters are dropped; rasters larger than the whole
+ * budget are never cached.  Defaults to 4 MiB.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_vector_image_set_cache_budget (LrgVectorImage *self,
+                                   gsize           bytes);
+
+/**
+ * lrg_vector_image_get_cache_budget:
+ * @self: an #LrgVectorImage
+ *
+ * Gets the raster cache budget.
+ *
+ * Returns: the budget in bytes
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gsize
+lrg_vector_image_get_cache_budget (LrgVectorImage *self);
+
+/**
+ * lrg_vector_image_clear_cache:
+ * @self: an #LrgVectorImage
+ *
+ * Drops every cached raster and texture.  Textures already returned stay
+ * valid.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_vector_image_clear_cache (LrgVectorImage *self);
+
+/**
+ * lrg_vector_image_get_cache_stats:
+ * @self: an #LrgVectorImage
+ * @out_hits: (out) (nullable): return location for the number of renders
+ *   served from the cache, or %NULL
+ * @out_misses: (out) (nullable): return location for the number of
+ *   renders that rasterized, or %NULL
+ * @out_bytes: (out) (nullable): return location for the bytes currently
+ *   cached, or %NULL
+ *
+ * Reports raster cache usage.  Hit and miss counts accumulate over the
+ * image's lifetime.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_vector_image_get_cache_stats (LrgVectorImage *self,
+                                  guint          *out_hits,
+                                  guint          *out_misses,
+                                  gsize          *out_bytes);
+
+/* ==========================================================================
+ * Tiled Rasterization
+ * ========================================================================== */
+
+/**
+ * lrg_vector_image_set_tile_size:
+ * @self: an #LrgVectorImage
+ * @tile_size: tile edge in pixels, or 0 to rasterize in one piece
+ *
+ * Splits renders larger than one tile into @tile_size squares that are
+ * rasterized in parallel (see lrg_vector_image_set_max_threads()).  Worth
+ * it for large backgrounds and splash art; small icons are better left in
+ * one piece.  Output does not depend on the number of threads.  Defaults
+ * to 0.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_vector_image_set_tile_size (LrgVectorImage *self,
+                                gint            tile_size);
+
+/**
+ * lrg_vector_image_get_tile_size:
+ * @self: an #LrgVectorImage
+ *
+ * Gets the tile size.
+ *
+ * Returns: the tile edge in pixels, 0 when tiling is off
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_vector_image_get_tile_size (LrgVectorImage *self);
+
+/**
+ * lrg_vector_image_set_max_threads:
+ * @self: an #LrgVectorImage
+ * @max_threads: worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Sets how many threads rasterize tiles.  Has no effect unless a tile
+ * size is set.  Defaults to 0.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_vector_image_set_max_threads (LrgVectorImage *self,
+                                  guint           max_threads);
+
+/**
+ * lrg_vector_image_get_max_threads:
+ * @self: an #LrgVectorImage
+ *
+ * Gets the thread limit.
+ *
+ * Returns: the thread limit, 0 meaning one per processor
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_vector_image_get_max_threads (LrgVectorImage *self);
+
 G_END_DECLS
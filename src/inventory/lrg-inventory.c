@@ -11,11 +11,45 @@
 #include "lrg-inventory.h"
 #include "../lrg-log.h"
 
+#include <string.h>
+
+#define BITS_PER_WORD  (GLIB_SIZEOF_LONG * 8)
+#define N_WORDS(n)     (((n) + BITS_PER_WORD - 1) / BITS_PER_WORD)
+
+/*
+ * Per item ID index: which slots hold the item and how many there are
+ * in total. Entries are never dropped, so an item that drains and
+ * refills every tick doesn't reallocate its bitmap.
+ */
+typedef struct
+{
+    gulong *slots;      /* One bit per slot holding this item */
+    guint   n_slots;    /* Bits set in @slots */
+    guint   total;      /* Quantity summed over those slots */
+} ItemIndex;
+
+typedef struct
+{
+    guint         slot;
+    LrgItemStack *stack;
+} PendingRemoval;
+
 /* Private data structure */
 typedef struct
 {
-    GPtrArray *slots;       /* LrgItemStack* or NULL */
-    guint      capacity;
+    GPtrArray  *slots;       /* LrgItemStack* or NULL */
+    guint       capacity;
+
+    /* Kept in sync by every mutator */
+    GHashTable *index;       /* item id -> ItemIndex */
+    gulong     *occupied;    /* One bit per non-empty slot */
+    guint       used;
+
+    /* Notifications held back by lrg_inventory_begin_batch() */
+    guint       batch_depth;
+    gulong     *pending_added;    /* Slots owing item-added */
+    gulong     *pending_changed;  /* Slots owing slot-changed */
+    GArray     *pending_removed;  /* PendingRemoval */
 } LrgInventoryPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgInventory, lrg_inventory, G_TYPE_OBJECT)
@@ -40,6 +74,284 @@ enum
 
 static guint signals[N_SIGNALS];
 
+/* ==========================================================================
+ * Slot Bitmaps
+ * ========================================================================== */
+
+static inline void
+bitmap_set (gulong *bits,
+            guint   bit)
+{
+    bits[bit / BITS_PER_WORD] |= 1UL << (bit % BITS_PER_WORD);
+}
+
+static inline void
+bitmap_clear (gulong *bits,
+              guint   bit)
+{
+    bits[bit / BITS_PER_WORD] &= ~(1UL << (bit % BITS_PER_WORD));
+}
+
+static inline gboolean
+bitmap_test (const gulong *bits,
+             guint         bit)
+{
+    return (bits[bit / BITS_PER_WORD] & (1UL << (bit % BITS_PER_WORD))) != 0;
+}
+
+/*
+ * Finds the first set (or, with @invert, clear) bit at or after @from.
+ * Returns -1 if there is none below @n_bits.
+ */
+static gint
+bitmap_next (const gulong *bits,
+             guint         n_bits,
+             guint         from,
+             gboolean      invert)
+{
+    guint  word;
+    guint  n_words;
+    gulong w;
+
+    if (from >= n_bits)
+        return -1;
+
+    n_words = N_WORDS (n_bits);
+    word = from / BITS_PER_WORD;
+    w = (invert ? ~bits[word] : bits[word]) & (~0UL << (from % BITS_PER_WORD));
+
+    for (;;)
+    {
+        if (w != 0)
+        {
+            guint bit = word * BITS_PER_WORD + g_bit_nth_lsf (w, -1);
+
+            return bit < n_bits ? (gint)bit : -1;
+        }
+
+        if (++word >= n_words)
+            return -1;
+        w = invert ? ~bits[word] : bits[word];
+    }
+}
+
+static gulong *
+bitmap_resize (gulong *bits,
+               guint   old_bits,
+               guint   new_bits)
+{
+    guint old_words = N_WORDS (old_bits);
+    guint new_words = N_WORDS (new_bits);
+    guint i;
+
+    bits = g_renew (gulong, bits, MAX (new_words, 1));
+
+    for (i = old_words; i < new_words; i++)
+        bits[i] = 0;
+
+    /* Bits past the end must stay clear for bitmap_next () */
+    if (new_bits < old_bits && new_bits % BITS_PER_WORD != 0)
+        bits[new_words - 1] &= ~(~0UL << (new_bits % BITS_PER_WORD));
+
+    return bits;
+}
+
+/* ==========================================================================
+ * Item Index
+ * ========================================================================== */
+
+static void
+item_index_free (gpointer data)
+{
+    ItemIndex *entry = data;
+
+    g_free (entry->slots);
+    g_free (entry);
+}
+
+static ItemIndex *
+index_lookup (LrgInventoryPrivate *priv,
+              const gchar         *item_id,
+              gboolean             create)
+{
+    ItemIndex *entry;
+
+    entry = g_hash_table_lookup (priv->index, item_id);
+    if (entry == NULL && create)
+    {
+        entry = g_new0 (ItemIndex, 1);
+        entry->slots = g_new0 (gulong, MAX (N_WORDS (priv->capacity), 1));
+        g_hash_table_insert (priv->index, g_strdup (item_id), entry);
+    }
+
+    return entry;
+}
+
+static inline const gchar *
+stack_item_id (LrgItemStack *stack)
+{
+    return lrg_item_def_get_id (lrg_item_stack_get_def (stack));
+}
+
+/* Records @stack as now living in @slot */
+static void
+index_insert (LrgInventoryPrivate *priv,
+              guint                slot,
+              LrgItemStack        *stack)
+{
+    const gchar *item_id = stack_item_id (stack);
+
+    bitmap_set (priv->occupied, slot);
+    priv->used++;
+
+    if (item_id != NULL)
+    {
+        ItemIndex *entry = index_lookup (priv, item_id, TRUE);
+
+        bitmap_set (entry->slots, slot);
+        entry->n_slots++;
+        entry->total += lrg_item_stack_get_quantity (stack);
+    }
+}
+
+/* Forgets @stack in @slot, using its current quantity */
+static void
+index_remove (LrgInventoryPrivate *priv,
+              guint                slot,
+              LrgItemStack        *stack)
+{
+    const gchar *item_id = stack_item_id (stack);
+
+    bitmap_clear (priv->occupied, slot);
+    priv->used--;
+
+    if (item_id != NULL)
+    {
+        ItemIndex *entry = index_lookup (priv, item_id, FALSE);
+
+        g_return_if_fail (entry != NULL);
+
+        bitmap_clear (entry->slots, slot);
+        entry->n_slots--;
+        entry->total -= lrg_item_stack_get_quantity (stack);
+    }
+}
+
+/* Accounts for a quantity change of an indexed stack */
+static void
+index_adjust (LrgInventoryPrivate *priv,
+              LrgItemStack        *stack,
+              gint                 delta)
+{
+    const gchar *item_id = stack_item_id (stack);
+    ItemIndex   *entry;
+
+    if (item_id == NULL || delta == 0)
+        return;
+
+    entry = index_lookup (priv, item_id, FALSE);
+    g_return_if_fail (entry != NULL);
+
+    entry->total += delta;
+}
+
+static void
+index_rebuild (LrgInventoryPrivate *priv)
+{
+    GHashTableIter iter;
+    gpointer       value;
+    guint          n_words = MAX (N_WORDS (priv->capacity), 1);
+    guint          i;
+
+    g_hash_table_iter_init (&iter, priv->index);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        ItemIndex *entry = value;
+
+        memset (entry->slots, 0, n_words * sizeof (gulong));
+        entry->n_slots = 0;
+        entry->total = 0;
+    }
+    memset (priv->occupied, 0, n_words * sizeof (gulong));
+    priv->used = 0;
+
+    for (i = 0; i < priv->capacity; i++)
+    {
+        LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
+
+        if (stack != NULL)
+            index_insert (priv, i, stack);
+    }
+}
+
+/* ==========================================================================
+ * Notifications
+ * ========================================================================== */
+
+static void
+emit_item_added (LrgInventory *self,
+                 guint         slot,
+                 LrgItemStack *stack)
+{
+    LrgInventoryPrivate *priv = lrg_inventory_get_instance_private (self);
+    LrgInventoryClass *klass = LRG_INVENTORY_GET_CLASS (self);
+
+    if (priv->batch_depth > 0)
+    {
+        bitmap_set (priv->pending_added, slot);
+        return;
+    }
+
+    if (klass->on_item_added != NULL)
+        klass->on_item_added (self, slot, stack);
+    g_signal_emit (self, signals[SIGNAL_ITEM_ADDED], 0, slot, stack);
+}
+
+static void
+emit_item_removed (LrgInventory *self,
+                   guint         slot,
+                   LrgItemStack *stack)
+{
+    LrgInventoryPrivate *priv = lrg_inventory_get_instance_private (self);
+    LrgInventoryClass *klass = LRG_INVENTORY_GET_CLASS (self);
+
+    if (priv->batch_depth > 0)
+    {
+        PendingRemoval removal;
+
+        /* Added and removed within the batch: nobody needs to know */
+        if (bitmap_test (priv->pending_added, slot))
+        {
+            bitmap_clear (priv->pending_added, slot);
+            return;
+        }
+
+        removal.slot = slot;
+        removal.stack = lrg_item_stack_ref (stack);
+        g_array_append_val (priv->pending_removed, removal);
+        return;
+    }
+
+    if (klass->on_item_removed != NULL)
+        klass->on_item_removed (self, slot, stack);
+    g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0, slot, stack);
+}
+
+static void
+emit_slot_changed (LrgInventory *self,
+                   guint         slot)
+{
+    LrgInventoryPrivate *priv = lrg_inventory_get_instance_private (self);
+
+    if (priv->batch_depth > 0)
+    {
+        bitmap_set (priv->pending_changed, slot);
+        return;
+    }
+
+    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+}
+
 /* ==========================================================================
  * Default Virtual Function Implementations
  * ========================================================================== */
@@ -90,6 +402,11 @@ lrg_inventory_finalize (GObject *object)
     LrgInventoryPrivate *priv = lrg_inventory_get_instance_private (self);
 
     g_clear_pointer (&priv->slots, g_ptr_array_unref);
+    g_clear_pointer (&priv->index, g_hash_table_unref);
+    g_clear_pointer (&priv->occupied, g_free);
+    g_clear_pointer (&priv->pending_added, g_free);
+    g_clear_pointer (&priv->pending_changed, g_free);
+    g_clear_pointer (&priv->pending_removed, g_array_unref);
 
     G_OBJECT_CLASS (lrg_inventory_parent_class)->finalize (object);
 }
@@ -246,6 +563,13 @@ lrg_inventory_init (LrgInventory *self)
     priv->capacity = 20;
     priv->slots = g_ptr_array_new_with_free_func (item_stack_free_func);
     g_ptr_array_set_size (priv->slots, priv->capacity);
+
+    priv->index = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                         g_free, item_index_free);
+    priv->occupied = g_new0 (gulong, N_WORDS (priv->capacity));
+    priv->pending_added = g_new0 (gulong, N_WORDS (priv->capacity));
+    priv->pending_changed = g_new0 (gulong, N_WORDS (priv->capacity));
+    priv->pending_removed = g_array_new (FALSE, FALSE, sizeof (PendingRemoval));
 }
 
 /* ==========================================================================
@@ -288,6 +612,30 @@ lrg_inventory_set_capacity (LrgInventory *self,
 
     if (priv->capacity != capacity)
     {
+        GHashTableIter iter;
+        gpointer       value;
+        guint          i;
+
+        /* Stacks past the new end are dropped */
+        for (i = capacity; i < priv->capacity; i++)
+        {
+            LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
+
+            if (stack != NULL)
+                index_remove (priv, i, stack);
+        }
+
+        g_hash_table_iter_init (&iter, priv->index);
+        while (g_hash_table_iter_next (&iter, NULL, &value))
+        {
+            ItemIndex *entry = value;
+
+            entry->slots = bitmap_resize (entry->slots, priv->capacity, capacity);
+        }
+        priv->occupied = bitmap_resize (priv->occupied, priv->capacity, capacity);
+        priv->pending_added = bitmap_resize (priv->pending_added, priv->capacity, capacity);
+        priv->pending_changed = bitmap_resize (priv->pending_changed, priv->capacity, capacity);
+
         priv->capacity = capacity;
         g_ptr_array_set_size (priv->slots, capacity);
         g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_CAPACITY]);
@@ -298,20 +646,11 @@ guint
 lrg_inventory_get_used_slots (LrgInventory *self)
 {
     LrgInventoryPrivate *priv;
-    guint count = 0;
-    guint i;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), 0);
 
     priv = lrg_inventory_get_instance_private (self);
-
-    for (i = 0; i < priv->capacity; i++)
-    {
-        if (g_ptr_array_index (priv->slots, i) != NULL)
-            count++;
-    }
-
-    return count;
+    return priv->used;
 }
 
 guint
@@ -322,7 +661,7 @@ lrg_inventory_get_free_slots (LrgInventory *self)
     g_return_val_if_fail (LRG_IS_INVENTORY (self), 0);
 
     priv = lrg_inventory_get_instance_private (self);
-    return priv->capacity - lrg_inventory_get_used_slots (self);
+    return priv->capacity - priv->used;
 }
 
 gboolean
@@ -367,13 +706,11 @@ lrg_inventory_set_slot (LrgInventory *self,
                         LrgItemStack *stack)
 {
     LrgInventoryPrivate *priv;
-    LrgInventoryClass *klass;
     LrgItemStack *old_stack;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), FALSE);
 
     priv = lrg_inventory_get_instance_private (self);
-    klass = LRG_INVENTORY_GET_CLASS (self);
 
     if (slot >= priv->capacity)
         return FALSE;
@@ -383,9 +720,8 @@ lrg_inventory_set_slot (LrgInventory *self,
     /* Emit removal signal if replacing */
     if (old_stack != NULL)
     {
-        if (klass->on_item_removed != NULL)
-            klass->on_item_removed (self, slot, old_stack);
-        g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0, slot, old_stack);
+        index_remove (priv, slot, old_stack);
+        emit_item_removed (self, slot, old_stack);
     }
 
     /* Set new stack */
@@ -401,12 +737,11 @@ lrg_inventory_set_slot (LrgInventory *self,
     /* Emit addition signal */
     if (stack != NULL)
     {
-        if (klass->on_item_added != NULL)
-            klass->on_item_added (self, slot, stack);
-        g_signal_emit (self, signals[SIGNAL_ITEM_ADDED], 0, slot, stack);
+        index_insert (priv, slot, stack);
+        emit_item_added (self, slot, stack);
     }
 
-    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+    emit_slot_changed (self, slot);
 
     return TRUE;
 }
@@ -416,13 +751,11 @@ lrg_inventory_clear_slot (LrgInventory *self,
                           guint         slot)
 {
     LrgInventoryPrivate *priv;
-    LrgInventoryClass *klass;
     LrgItemStack *old_stack;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), NULL);
 
     priv = lrg_inventory_get_instance_private (self);
-    klass = LRG_INVENTORY_GET_CLASS (self);
 
     if (slot >= priv->capacity)
         return NULL;
@@ -432,11 +765,10 @@ lrg_inventory_clear_slot (LrgInventory *self,
         return NULL;
 
     g_ptr_array_index (priv->slots, slot) = NULL;
+    index_remove (priv, slot, old_stack);
 
-    if (klass->on_item_removed != NULL)
-        klass->on_item_removed (self, slot, old_stack);
-    g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0, slot, old_stack);
-    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+    emit_item_removed (self, slot, old_stack);
+    emit_slot_changed (self, slot);
 
     return old_stack;  /* Transfer ownership to caller */
 }
@@ -461,19 +793,12 @@ gint
 lrg_inventory_find_empty_slot (LrgInventory *self)
 {
     LrgInventoryPrivate *priv;
-    guint i;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), -1);
 
     priv = lrg_inventory_get_instance_private (self);
 
-    for (i = 0; i < priv->capacity; i++)
-    {
-        if (g_ptr_array_index (priv->slots, i) == NULL)
-            return (gint)i;
-    }
-
-    return -1;
+    return bitmap_next (priv->occupied, priv->capacity, 0, TRUE);
 }
 
 /* ==========================================================================
@@ -487,8 +812,9 @@ lrg_inventory_add_item (LrgInventory *self,
 {
     LrgInventoryPrivate *priv;
     LrgInventoryClass *klass;
+    ItemIndex *entry;
     guint remaining;
-    guint i;
+    gint i;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), 0);
     g_return_val_if_fail (LRG_IS_ITEM_DEF (def), 0);
@@ -501,21 +827,31 @@ lrg_inventory_add_item (LrgInventory *self,
 
     remaining = quantity;
 
-    /* First try to add to existing stacks (even if inventory is "full") */
-    if (lrg_item_def_get_stackable (def))
+    /*
+     * First try to add to existing stacks (even if inventory is "full").
+     * Only slots already holding this item ID are candidates.
+     */
+    entry = NULL;
+    if (lrg_item_def_get_stackable (def) && lrg_item_def_get_id (def) != NULL)
+        entry = index_lookup (priv, lrg_item_def_get_id (def), FALSE);
+
+    if (entry != NULL)
     {
-        for (i = 0; i < priv->capacity && remaining > 0; i++)
+        for (i = bitmap_next (entry->slots, priv->capacity, 0, FALSE);
+             i >= 0 && remaining > 0;
+             i = bitmap_next (entry->slots, priv->capacity, i + 1, FALSE))
         {
             LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
-            if (stack != NULL)
+            LrgItemDef *stack_def = lrg_item_stack_get_def (stack);
+
+            if (lrg_item_def_can_stack_with (def, stack_def))
             {
-                LrgItemDef *stack_def = lrg_item_stack_get_def (stack);
-                if (lrg_item_def_can_stack_with (def, stack_def))
+                guint added = lrg_item_stack_add (stack, remaining);
+                remaining -= added;
+                if (added > 0)
                 {
-                    guint added = lrg_item_stack_add (stack, remaining);
-                    remaining -= added;
-                    if (added > 0)
-                        g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, i);
+                    index_adjust (priv, stack, added);
+                    emit_slot_changed (self, i);
                 }
             }
         }
@@ -545,11 +881,10 @@ lrg_inventory_add_item (LrgInventory *self,
         remaining -= added;
 
         g_ptr_array_index (priv->slots, slot) = new_stack;
+        index_insert (priv, slot, new_stack);
 
-        if (klass->on_item_added != NULL)
-            klass->on_item_added (self, slot, new_stack);
-        g_signal_emit (self, signals[SIGNAL_ITEM_ADDED], 0, slot, new_stack);
-        g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+        emit_item_added (self, slot, new_stack);
+        emit_slot_changed (self, slot);
     }
 
     return quantity - remaining;
@@ -603,6 +938,7 @@ lrg_inventory_add_to_slot (LrgInventory *self,
             return 0;
 
         added = lrg_item_stack_add (existing, quantity);
+        index_adjust (priv, existing, added);
     }
     else
     {
@@ -610,14 +946,13 @@ lrg_inventory_add_to_slot (LrgInventory *self,
         LrgItemStack *new_stack = lrg_item_stack_new (def, quantity);
         added = lrg_item_stack_get_quantity (new_stack);
         g_ptr_array_index (priv->slots, slot) = new_stack;
+        index_insert (priv, slot, new_stack);
 
-        if (klass->on_item_added != NULL)
-            klass->on_item_added (self, slot, new_stack);
-        g_signal_emit (self, signals[SIGNAL_ITEM_ADDED], 0, slot, new_stack);
+        emit_item_added (self, slot, new_stack);
     }
 
     if (added > 0)
-        g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+        emit_slot_changed (self, slot);
 
     return added;
 }
@@ -632,9 +967,9 @@ lrg_inventory_remove_item (LrgInventory *self,
                            guint         quantity)
 {
     LrgInventoryPrivate *priv;
-    LrgInventoryClass *klass;
+    ItemIndex *entry;
     guint remaining;
-    guint i;
+    gint i;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), 0);
     g_return_val_if_fail (item_id != NULL, 0);
@@ -643,32 +978,31 @@ lrg_inventory_remove_item (LrgInventory *self,
         return 0;
 
     priv = lrg_inventory_get_instance_private (self);
-    klass = LRG_INVENTORY_GET_CLASS (self);
     remaining = quantity;
 
-    for (i = 0; i < priv->capacity && remaining > 0; i++)
+    entry = index_lookup (priv, item_id, FALSE);
+    if (entry == NULL)
+        return 0;
+
+    for (i = bitmap_next (entry->slots, priv->capacity, 0, FALSE);
+         i >= 0 && remaining > 0;
+         i = bitmap_next (entry->slots, priv->capacity, i + 1, FALSE))
     {
         LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
-        if (stack != NULL)
-        {
-            LrgItemDef *def = lrg_item_stack_get_def (stack);
-            if (g_strcmp0 (lrg_item_def_get_id (def), item_id) == 0)
-            {
-                guint removed = lrg_item_stack_remove (stack, remaining);
-                remaining -= removed;
+        guint removed = lrg_item_stack_remove (stack, remaining);
 
-                if (lrg_item_stack_is_empty (stack))
-                {
-                    g_ptr_array_index (priv->slots, i) = NULL;
-                    if (klass->on_item_removed != NULL)
-                        klass->on_item_removed (self, i, stack);
-                    g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0, i, stack);
-                    lrg_item_stack_unref (stack);
-                }
+        remaining -= removed;
+        index_adjust (priv, stack, -(gint)removed);
 
-                g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, i);
-            }
+        if (lrg_item_stack_is_empty (stack))
+        {
+            g_ptr_array_index (priv->slots, i) = NULL;
+            index_remove (priv, i, stack);
+            emit_item_removed (self, i, stack);
+            lrg_item_stack_unref (stack);
         }
+
+        emit_slot_changed (self, i);
     }
 
     return quantity - remaining;
@@ -680,14 +1014,12 @@ lrg_inventory_remove_from_slot (LrgInventory *self,
                                 guint         quantity)
 {
     LrgInventoryPrivate *priv;
-    LrgInventoryClass *klass;
     LrgItemStack *stack;
     guint removed;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), 0);
 
     priv = lrg_inventory_get_instance_private (self);
-    klass = LRG_INVENTORY_GET_CLASS (self);
 
     if (slot >= priv->capacity)
         return 0;
@@ -697,18 +1029,18 @@ lrg_inventory_remove_from_slot (LrgInventory *self,
         return 0;
 
     removed = lrg_item_stack_remove (stack, quantity);
+    index_adjust (priv, stack, -(gint)removed);
 
     if (lrg_item_stack_is_empty (stack))
     {
         g_ptr_array_index (priv->slots, slot) = NULL;
-        if (klass->on_item_removed != NULL)
-            klass->on_item_removed (self, slot, stack);
-        g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0, slot, stack);
+        index_remove (priv, slot, stack);
+        emit_item_removed (self, slot, stack);
         lrg_item_stack_unref (stack);
     }
 
     if (removed > 0)
-        g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+        emit_slot_changed (self, slot);
 
     return removed;
 }
@@ -721,26 +1053,16 @@ LrgItemStack *
 lrg_inventory_find_item (LrgInventory *self,
                          const gchar  *item_id)
 {
-    LrgInventoryPrivate *priv;
-    guint i;
+    gint slot;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), NULL);
     g_return_val_if_fail (item_id != NULL, NULL);
 
-    priv = lrg_inventory_get_instance_private (self);
-
-    for (i = 0; i < priv->capacity; i++)
-    {
-        LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
-        if (stack != NULL)
-        {
-            LrgItemDef *def = lrg_item_stack_get_def (stack);
-            if (g_strcmp0 (lrg_item_def_get_id (def), item_id) == 0)
-                return stack;
-        }
-    }
+    slot = lrg_inventory_find_item_slot (self, item_id);
+    if (slot < 0)
+        return NULL;
 
-    return NULL;
+    return lrg_inventory_get_slot (self, slot);
 }
 
 gint
@@ -748,25 +1070,18 @@ lrg_inventory_find_item_slot (LrgInventory *self,
                               const gchar  *item_id)
 {
     LrgInventoryPrivate *priv;
-    guint i;
+    ItemIndex *entry;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), -1);
     g_return_val_if_fail (item_id != NULL, -1);
 
     priv = lrg_inventory_get_instance_private (self);
 
-    for (i = 0; i < priv->capacity; i++)
-    {
-        LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
-        if (stack != NULL)
-        {
-            LrgItemDef *def = lrg_item_stack_get_def (stack);
-            if (g_strcmp0 (lrg_item_def_get_id (def), item_id) == 0)
-                return (gint)i;
-        }
-    }
+    entry = index_lookup (priv, item_id, FALSE);
+    if (entry == NULL || entry->n_slots == 0)
+        return -1;
 
-    return -1;
+    return bitmap_next (entry->slots, priv->capacity, 0, FALSE);
 }
 
 guint
@@ -774,26 +1089,15 @@ lrg_inventory_count_item (LrgInventory *self,
                           const gchar  *item_id)
 {
     LrgInventoryPrivate *priv;
-    guint count = 0;
-    guint i;
+    ItemIndex *entry;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), 0);
     g_return_val_if_fail (item_id != NULL, 0);
 
     priv = lrg_inventory_get_instance_private (self);
 
-    for (i = 0; i < priv->capacity; i++)
-    {
-        LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
-        if (stack != NULL)
-        {
-            LrgItemDef *def = lrg_item_stack_get_def (stack);
-            if (g_strcmp0 (lrg_item_def_get_id (def), item_id) == 0)
-                count += lrg_item_stack_get_quantity (stack);
-        }
-    }
-
-    return count;
+    entry = index_lookup (priv, item_id, FALSE);
+    return entry != NULL ? entry->total : 0;
 }
 
 gboolean
@@ -817,7 +1121,8 @@ lrg_inventory_swap_slots (LrgInventory *self,
                           guint         slot_b)
 {
     LrgInventoryPrivate *priv;
-    LrgItemStack *temp;
+    LrgItemStack *stack_a;
+    LrgItemStack *stack_b;
 
     g_return_val_if_fail (LRG_IS_INVENTORY (self), FALSE);
 
@@ -829,12 +1134,24 @@ lrg_inventory_swap_slots (LrgInventory *self,
     if (slot_a == slot_b)
         return TRUE;
 
-    temp = g_ptr_array_index (priv->slots, slot_a);
-    g_ptr_array_index (priv->slots, slot_a) = g_ptr_array_index (priv->slots, slot_b);
-    g_ptr_array_index (priv->slots, slot_b) = temp;
+    stack_a = g_ptr_array_index (priv->slots, slot_a);
+    stack_b = g_ptr_array_index (priv->slots, slot_b);
+
+    if (stack_a != NULL)
+        index_remove (priv, slot_a, stack_a);
+    if (stack_b != NULL)
+        index_remove (priv, slot_b, stack_b);
 
-    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot_a);
-    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot_b);
+    g_ptr_array_index (priv->slots, slot_a) = stack_b;
+    g_ptr_array_index (priv->slots, slot_b) = stack_a;
+
+    if (stack_a != NULL)
+        index_insert (priv, slot_b, stack_a);
+    if (stack_b != NULL)
+        index_insert (priv, slot_a, stack_b);
+
+    emit_slot_changed (self, slot_a);
+    emit_slot_changed (self, slot_b);
 
     return TRUE;
 }
@@ -880,6 +1197,8 @@ lrg_inventory_move_to_slot (LrgInventory *self,
 
             lrg_item_stack_remove (from_stack, moved);
             lrg_item_stack_add (to_stack, moved);
+            index_adjust (priv, from_stack, -(gint)moved);
+            index_adjust (priv, to_stack, moved);
         }
         else
         {
@@ -901,8 +1220,10 @@ lrg_inventory_move_to_slot (LrgInventory *self,
         if ((guint)quantity >= lrg_item_stack_get_quantity (from_stack))
         {
             /* Move entire stack */
+            index_remove (priv, from_slot, from_stack);
             g_ptr_array_index (priv->slots, to_slot) = from_stack;
             g_ptr_array_index (priv->slots, from_slot) = NULL;
+            index_insert (priv, to_slot, from_stack);
             moved = lrg_item_stack_get_quantity (from_stack);
         }
         else
@@ -913,6 +1234,8 @@ lrg_inventory_move_to_slot (LrgInventory *self,
                 return 0;
             g_ptr_array_index (priv->slots, to_slot) = split;
             moved = lrg_item_stack_get_quantity (split);
+            index_adjust (priv, from_stack, -(gint)moved);
+            index_insert (priv, to_slot, split);
         }
     }
 
@@ -921,11 +1244,12 @@ lrg_inventory_move_to_slot (LrgInventory *self,
     if (from_stack != NULL && lrg_item_stack_is_empty (from_stack))
     {
         g_ptr_array_index (priv->slots, from_slot) = NULL;
+        index_remove (priv, from_slot, from_stack);
         lrg_item_stack_unref (from_stack);
     }
 
-    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, from_slot);
-    g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, to_slot);
+    emit_slot_changed (self, from_slot);
+    emit_slot_changed (self, to_slot);
 
     return moved;
 }
@@ -998,39 +1322,274 @@ lrg_inventory_sort (LrgInventory *self)
 
     /* Sort the array */
     g_ptr_array_sort (priv->slots, compare_stacks);
+    index_rebuild (priv);
 
     /* Emit slot changed for all slots */
     for (i = 0; i < priv->capacity; i++)
     {
-        g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, i);
+        emit_slot_changed (self, i);
     }
 }
 
 void
 lrg_inventory_clear (LrgInventory *self)
+{
+    LrgInventoryPrivate *priv;
+    gint i;
+
+    g_return_if_fail (LRG_IS_INVENTORY (self));
+
+    priv = lrg_inventory_get_instance_private (self);
+
+    for (i = bitmap_next (priv->occupied, priv->capacity, 0, FALSE);
+         i >= 0;
+         i = bitmap_next (priv->occupied, priv->capacity, i + 1, FALSE))
+    {
+        LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
+
+        g_ptr_array_index (priv->slots, i) = NULL;
+        index_remove (priv, i, stack);
+        emit_item_removed (self, i, stack);
+        emit_slot_changed (self, i);
+        lrg_item_stack_unref (stack);
+    }
+}
+
+/* ==========================================================================
+ * Batches
+ * ========================================================================== */
+
+void
+lrg_inventory_begin_batch (LrgInventory *self)
+{
+    LrgInventoryPrivate *priv;
+
+    g_return_if_fail (LRG_IS_INVENTORY (self));
+
+    priv = lrg_inventory_get_instance_private (self);
+    priv->batch_depth++;
+}
+
+void
+lrg_inventory_end_batch (LrgInventory *self)
 {
     LrgInventoryPrivate *priv;
     LrgInventoryClass *klass;
+    g_autofree gulong *added = NULL;
+    g_autofree gulong *changed = NULL;
+    g_autoptr(GArray) removed = NULL;
+    guint n_words;
+    guint capacity;
     guint i;
+    gint slot;
 
     g_return_if_fail (LRG_IS_INVENTORY (self));
 
     priv = lrg_inventory_get_instance_private (self);
     klass = LRG_INVENTORY_GET_CLASS (self);
 
-    for (i = 0; i < priv->capacity; i++)
+    g_return_if_fail (priv->batch_depth > 0);
+
+    if (--priv->batch_depth > 0)
+        return;
+
+    /* Take the pending state first; handlers may start another batch */
+    capacity = priv->capacity;
+    n_words = MAX (N_WORDS (capacity), 1);
+    added = g_memdup2 (priv->pending_added, n_words * sizeof (gulong));
+    changed = g_memdup2 (priv->pending_changed, n_words * sizeof (gulong));
+    memset (priv->pending_added, 0, n_words * sizeof (gulong));
+    memset (priv->pending_changed, 0, n_words * sizeof (gulong));
+    removed = priv->pending_removed;
+    priv->pending_removed = g_array_new (FALSE, FALSE, sizeof (PendingRemoval));
+
+    g_object_ref (self);
+
+    for (i = 0; i < removed->len; i++)
     {
-        LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
+        PendingRemoval *removal = &g_array_index (removed, PendingRemoval, i);
+
+        if (klass->on_item_removed != NULL)
+            klass->on_item_removed (self, removal->slot, removal->stack);
+        g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0,
+                       removal->slot, removal->stack);
+        lrg_item_stack_unref (removal->stack);
+    }
+
+    for (slot = bitmap_next (added, capacity, 0, FALSE);
+         slot >= 0;
+         slot = bitmap_next (added, capacity, slot + 1, FALSE))
+    {
+        LrgItemStack *stack = lrg_inventory_get_slot (self, slot);
+
         if (stack != NULL)
         {
-            g_ptr_array_index (priv->slots, i) = NULL;
-            if (klass->on_item_removed != NULL)
-                klass->on_item_removed (self, i, stack);
-            g_signal_emit (self, signals[SIGNAL_ITEM_REMOVED], 0, i, stack);
-            g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, i);
-            lrg_item_stack_unref (stack);
+            if (klass->on_item_added != NULL)
+                klass->on_item_added (self, slot, stack);
+            g_signal_emit (self, signals[SIGNAL_ITEM_ADDED], 0, slot, stack);
         }
     }
+
+    for (slot = bitmap_next (changed, capacity, 0, FALSE);
+         slot >= 0;
+         slot = bitmap_next (changed, capacity, slot + 1, FALSE))
+    {
+        g_signal_emit (self, signals[SIGNAL_SLOT_CHANGED], 0, slot);
+    }
+
+    g_object_unref (self);
+}
+
+typedef struct
+{
+    LrgItemDef *def;
+    guint       quantity;
+} TransferPlan;
+
+static void
+transfer_plan_free (gpointer data)
+{
+    TransferPlan *plan = data;
+
+    g_object_unref (plan->def);
+    g_free (plan);
+}
+
+/* Number of new slots @dest would need to take @plan via add_item () */
+static guint
+slots_needed (LrgInventory       *dest,
+              const TransferPlan *plan)
+{
+    LrgInventoryPrivate *priv = lrg_inventory_get_instance_private (dest);
+    ItemIndex *entry;
+    guint space = 0;
+    guint remaining;
+    guint max_stack;
+    gint i;
+
+    entry = NULL;
+    if (lrg_item_def_get_stackable (plan->def))
+        entry = index_lookup (priv, lrg_item_def_get_id (plan->def), FALSE);
+
+    if (entry != NULL)
+    {
+        for (i = bitmap_next (entry->slots, priv->capacity, 0, FALSE);
+             i >= 0 && space < plan->quantity;
+             i = bitmap_next (entry->slots, priv->capacity, i + 1, FALSE))
+        {
+            LrgItemStack *stack = g_ptr_array_index (priv->slots, i);
+
+            if (lrg_item_def_can_stack_with (plan->def, lrg_item_stack_get_def (stack)))
+                space += lrg_item_stack_get_space_remaining (stack);
+        }
+    }
+
+    if (space >= plan->quantity)
+        return 0;
+
+    remaining = plan->quantity - space;
+    max_stack = MAX (lrg_item_def_get_max_stack (plan->def), 1);
+
+    return (remaining + max_stack - 1) / max_stack;
+}
+
+gboolean
+lrg_inventory_transfer_items (LrgInventory          *self,
+                              LrgInventory          *dest,
+                              const LrgItemTransfer *transfers,
+                              guint                  n_transfers)
+{
+    LrgInventoryPrivate *priv;
+    LrgInventoryPrivate *dest_priv;
+    LrgInventoryClass *dest_klass;
+    g_autoptr(GHashTable) plans = NULL;
+    GHashTableIter iter;
+    gpointer value;
+    guint new_slots = 0;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_INVENTORY (self), FALSE);
+    g_return_val_if_fail (LRG_IS_INVENTORY (dest), FALSE);
+    g_return_val_if_fail (self != dest, FALSE);
+    g_return_val_if_fail (transfers != NULL || n_transfers == 0, FALSE);
+
+    priv = lrg_inventory_get_instance_private (self);
+    dest_priv = lrg_inventory_get_instance_private (dest);
+    dest_klass = LRG_INVENTORY_GET_CLASS (dest);
+
+    /* Validate everything up front, merging repeated IDs */
+    plans = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, transfer_plan_free);
+
+    for (i = 0; i < n_transfers; i++)
+    {
+        TransferPlan *plan;
+
+        g_return_val_if_fail (transfers[i].item_id != NULL, FALSE);
+
+        if (transfers[i].quantity == 0)
+            continue;
+
+        plan = g_hash_table_lookup (plans, transfers[i].item_id);
+        if (plan == NULL)
+        {
+            ItemIndex *entry = index_lookup (priv, transfers[i].item_id, FALSE);
+            LrgItemStack *stack;
+
+            if (entry == NULL || entry->n_slots == 0)
+                return FALSE;
+
+            stack = g_ptr_array_index (priv->slots,
+                                       bitmap_next (entry->slots, priv->capacity, 0, FALSE));
+
+            plan = g_new0 (TransferPlan, 1);
+            plan->def = g_object_ref (lrg_item_stack_get_def (stack));
+            g_hash_table_insert (plans, (gpointer)lrg_item_def_get_id (plan->def), plan);
+        }
+
+        if (plan->quantity > G_MAXUINT - transfers[i].quantity)
+            return FALSE;
+        plan->quantity += transfers[i].quantity;
+    }
+
+    g_hash_table_iter_init (&iter, plans);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        TransferPlan *plan = value;
+        guint needed;
+
+        if (lrg_inventory_count_item (self, lrg_item_def_get_id (plan->def)) < plan->quantity)
+            return FALSE;
+
+        needed = slots_needed (dest, plan);
+        if (needed > 0 && !dest_klass->can_accept (dest, plan->def, -1))
+            return FALSE;
+        new_slots += needed;
+    }
+
+    if (new_slots > dest_priv->capacity - dest_priv->used)
+        return FALSE;
+
+    /* Everything fits: move it with notifications held until the end */
+    lrg_inventory_begin_batch (self);
+    lrg_inventory_begin_batch (dest);
+
+    g_hash_table_iter_init (&iter, plans);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        TransferPlan *plan = value;
+        guint removed;
+        guint added;
+
+        removed = lrg_inventory_remove_item (self, lrg_item_def_get_id (plan->def),
+                                             plan->quantity);
+        added = lrg_inventory_add_item (dest, plan->def, removed);
+        g_warn_if_fail (added == plan->quantity);
+    }
+
+    lrg_inventory_end_batch (dest);
+    lrg_inventory_end_batch (self);
+
+    return TRUE;
 }
 
 /* ==========================================================================
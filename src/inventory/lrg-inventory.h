@@ -87,6 +87,21 @@ struct _LrgInventoryClass
     gpointer _reserved[8];
 };
 
+/**
+ * LrgItemTransfer:
+ * @item_id: the item ID to move
+ * @quantity: how many to move
+ *
+ * One entry of a lrg_inventory_transfer_items() batch.
+ *
+ * Since: 1.0
+ */
+typedef struct
+{
+    const gchar *item_id;
+    guint        quantity;
+} LrgItemTransfer;
+
 /* Construction */
 
 /**
@@ -196,7 +211,9 @@ lrg_inventory_is_empty (LrgInventory *self);
  * @self: an #LrgInventory
  * @slot: the slot index
  *
- * Gets the item stack in a slot.
+ * Gets the item stack in a slot. Change its quantity through the
+ * inventory (add, remove, move) rather than on the stack directly, or
+ * the cached item totals go stale.
  *
  * Returns: (transfer none) (nullable): the item stack, or %NULL if empty
  *
@@ -374,7 +391,8 @@ lrg_inventory_remove_from_slot (LrgInventory *self,
  * @self: an #LrgInventory
  * @item_id: the item ID to find
  *
- * Finds the first stack containing the specified item.
+ * Finds the first stack containing the specified item. Lookups by ID
+ * go through a per-item index, so they don't scan the slots.
  *
  * Returns: (transfer none) (nullable): the item stack, or %NULL if not found
  *
@@ -406,7 +424,8 @@ lrg_inventory_find_item_slot (LrgInventory *self,
  * @self: an #LrgInventory
  * @item_id: the item ID to count
  *
- * Counts the total quantity of an item across all slots.
+ * Counts the total quantity of an item across all slots. The total is
+ * cached and kept current by every mutator, so this is O(1).
  *
  * Returns: total quantity
  *
@@ -500,6 +519,66 @@ LRG_AVAILABLE_IN_ALL
 void
 lrg_inventory_clear (LrgInventory *self);
 
+/* Batches */
+
+/**
+ * lrg_inventory_begin_batch:
+ * @self: an #LrgInventory
+ *
+ * Holds back #LrgInventory::item-added, #LrgInventory::item-removed
+ * and #LrgInventory::slot-changed (and the matching virtual functions)
+ * until the matching lrg_inventory_end_batch(). Batches nest.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_inventory_begin_batch (LrgInventory *self);
+
+/**
+ * lrg_inventory_end_batch:
+ * @self: an #LrgInventory
+ *
+ * Ends a batch started with lrg_inventory_begin_batch(). When the
+ * outermost batch ends, each removed stack gets one
+ * #LrgInventory::item-removed, each slot that gained a stack one
+ * #LrgInventory::item-added, and each touched slot one
+ * #LrgInventory::slot-changed, however many operations hit it. A stack
+ * added and removed again within the batch is not reported.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_inventory_end_batch (LrgInventory *self);
+
+/**
+ * lrg_inventory_transfer_items:
+ * @self: the source #LrgInventory
+ * @dest: the destination #LrgInventory
+ * @transfers: (array length=n_transfers): the items to move
+ * @n_transfers: number of entries in @transfers
+ *
+ * Moves every entry of @transfers from @self to @dest as one
+ * transaction. All entries are validated first: @self must hold the
+ * requested quantities and @dest must have room for all of them
+ * together. If any check fails nothing is moved.
+ *
+ * Items are moved like lrg_inventory_remove_item() followed by
+ * lrg_inventory_add_item(), inside a batch on both inventories, so
+ * listeners see one notification per touched slot.
+ *
+ * Returns: %TRUE if everything was moved, %FALSE if nothing was
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_inventory_transfer_items (LrgInventory          *self,
+                              LrgInventory          *dest,
+                              const LrgItemTransfer *transfers,
+                              guint                  n_transfers);
+
 /* Virtual Function Wrappers */
 
 /**
@@ -51,6 +51,7 @@
 #include "graphics/lrg-camera-firstperson.h"
 #include "graphics/lrg-camera-thirdperson.h"
 #include "graphics/lrg-renderer.h"
+#include "graphics/lrg-recording-renderer.h"
 #include "graphics/lrg-image-canvas.h"
 #include "graphics/lrg-vector-image.h"
 
@@ -165,6 +166,7 @@
 #include "ai/lrg-bt-composite.h"
 #include "ai/lrg-bt-decorator.h"
 #include "ai/lrg-bt-leaf.h"
+#include "ai/lrg-bt-program.h"
 #include "ai/lrg-behavior-tree.h"
 
 /* Physics module */
@@ -193,6 +195,7 @@
 #include "world3d/lrg-sector.h"
 #include "world3d/lrg-level3d.h"
 #include "world3d/lrg-portal-system.h"
+#include "world3d/lrg-sector-streamer.h"
 
 /* Scene module */
 #include "scene/lrg-mesh-data.h"
@@ -261,6 +264,7 @@
 #include "scripting/lrg-script-module.h"
 #ifdef LRG_HAS_LUAJIT
 #include "scripting/lrg-scripting-lua.h"
+#include "scripting/lrg-script-job-system.h"
 #endif
 #ifdef LRG_HAS_GI
 #include "scripting/lrg-scripting-gi.h"
@@ -272,6 +276,9 @@
 #ifdef LRG_HAS_GJS
 #include "scripting/lrg-scripting-gjs.h"
 #endif
+#ifdef LRG_HAS_CRISPY
+#include "scripting/lrg-scripting-crispy.h"
+#endif
 
 /* Settings module (Phase 1) */
 #include "settings/lrg-settings-group.h"
@@ -339,6 +346,7 @@
 #include "vehicle/lrg-road.h"
 #include "vehicle/lrg-road-network.h"
 #include "vehicle/lrg-traffic-agent.h"
+#include "vehicle/lrg-traffic-manager.h"
 
 /* Particles module (Phase 3) */
 #include "particles/lrg-particle.h"
@@ -365,10 +373,12 @@
 #include "animation/lrg-animation-keyframe.h"
 #include "animation/lrg-animation-event.h"
 #include "animation/lrg-animation-clip.h"
+#include "animation/lrg-compressed-clip.h"
 #include "animation/lrg-animator.h"
 #include "animation/lrg-animation-state.h"
 #include "animation/lrg-animation-transition.h"
 #include "animation/lrg-animation-state-machine.h"
+#include "animation/lrg-pose-buffer.h"
 #include "animation/lrg-blend-tree.h"
 #include "animation/lrg-animation-layer.h"
 #include "animation/lrg-ik-chain.h"
@@ -595,6 +605,7 @@
 #include "deckbuilder/lrg-player-combatant.h"
 #include "deckbuilder/lrg-combat-context.h"
 #include "deckbuilder/lrg-combat-manager.h"
+#include "deckbuilder/lrg-combat-simulator.h"
 
 /* Deckbuilder module (Phase 6.5 - Run/Map System) */
 #include "deckbuilder/lrg-map-node.h"
@@ -3976,6 +3976,27 @@ lrg_combat_result_get_type (void)
     return g_define_type_id__volatile;
 }
 
+GType
+lrg_combat_sim_policy_get_type (void)
+{
+    static volatile gsize g_define_type_id__volatile = 0;
+
+    if (g_once_init_enter (&g_define_type_id__volatile))
+    {
+        static const GEnumValue values[] = {
+            { LRG_COMBAT_SIM_POLICY_RANDOM, "LRG_COMBAT_SIM_POLICY_RANDOM", "random" },
+            { LRG_COMBAT_SIM_POLICY_GREEDY, "LRG_COMBAT_SIM_POLICY_GREEDY", "greedy" },
+            { LRG_COMBAT_SIM_POLICY_SCRIPTED, "LRG_COMBAT_SIM_POLICY_SCRIPTED", "scripted" },
+            { 0, NULL, NULL }
+        };
+        GType g_define_type_id =
+            g_enum_register_static (g_intern_static_string ("LrgCombatSimPolicy"), values);
+        g_once_init_leave (&g_define_type_id__volatile, g_define_type_id);
+    }
+
+    return g_define_type_id__volatile;
+}
+
 GType
 lrg_run_state_get_type (void)
 {
@@ -4601,6 +4622,26 @@ lrg_reel_video_codec_get_type (void)
     return g_define_type_id__volatile;
 }
 
+GType
+lrg_reel_video_pipe_format_get_type (void)
+{
+    static volatile gsize g_define_type_id__volatile = 0;
+
+    if (g_once_init_enter (&g_define_type_id__volatile))
+    {
+        static const GEnumValue values[] = {
+            { LRG_REEL_VIDEO_PIPE_FORMAT_RAW, "LRG_REEL_VIDEO_PIPE_FORMAT_RAW", "raw" },
+            { LRG_REEL_VIDEO_PIPE_FORMAT_PNG, "LRG_REEL_VIDEO_PIPE_FORMAT_PNG", "png" },
+            { 0, NULL, NULL }
+        };
+        GType g_define_type_id =
+            g_enum_register_static (g_intern_static_string ("LrgReelVideoPipeFormat"), values);
+        g_once_init_leave (&g_define_type_id__volatile, g_define_type_id);
+    }
+
+    return g_define_type_id__volatile;
+}
+
 GType
 lrg_reel_audio_format_get_type (void)
 {
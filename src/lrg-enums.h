@@ -4179,6 +4179,27 @@ LRG_AVAILABLE_IN_ALL
 GType lrg_combat_result_get_type (void) G_GNUC_CONST;
 #define LRG_TYPE_COMBAT_RESULT (lrg_combat_result_get_type ())
 
+/**
+ * LrgCombatSimPolicy:
+ * @LRG_COMBAT_SIM_POLICY_RANDOM: Play random playable cards until none is left
+ * @LRG_COMBAT_SIM_POLICY_GREEDY: Play whichever card improves the position most
+ * @LRG_COMBAT_SIM_POLICY_SCRIPTED: Ask a #LrgCombatSimPolicyFunc
+ *
+ * How simulated combats choose the cards to play.
+ *
+ * Since: 1.0
+ */
+typedef enum
+{
+    LRG_COMBAT_SIM_POLICY_RANDOM,
+    LRG_COMBAT_SIM_POLICY_GREEDY,
+    LRG_COMBAT_SIM_POLICY_SCRIPTED
+} LrgCombatSimPolicy;
+
+LRG_AVAILABLE_IN_ALL
+GType lrg_combat_sim_policy_get_type (void) G_GNUC_CONST;
+#define LRG_TYPE_COMBAT_SIM_POLICY (lrg_combat_sim_policy_get_type ())
+
 /**
  * LrgRunState:
  * @LRG_RUN_STATE_NOT_STARTED: Run has not started yet
@@ -4889,6 +4910,28 @@ LRG_AVAILABLE_IN_ALL
 GType lrg_reel_video_codec_get_type (void) G_GNUC_CONST;
 #define LRG_TYPE_REEL_VIDEO_CODEC (lrg_reel_video_codec_get_type ())
 
+/**
+ * LrgReelVideoPipeFormat:
+ * @LRG_REEL_VIDEO_PIPE_FORMAT_RAW: frames are written to ffmpeg as raw RGBA8
+ *   pixels (`-f rawvideo`); no per-frame encoding on the caller's side.
+ * @LRG_REEL_VIDEO_PIPE_FORMAT_PNG: frames are PNG-encoded and written as an
+ *   image sequence (`-f image2pipe`).
+ *
+ * How the video exporter hands frames to ffmpeg.  Raw is much cheaper per
+ * frame; PNG moves less data through the pipe.
+ *
+ * Since: 1.0
+ */
+typedef enum
+{
+    LRG_REEL_VIDEO_PIPE_FORMAT_RAW,
+    LRG_REEL_VIDEO_PIPE_FORMAT_PNG
+} LrgReelVideoPipeFormat;
+
+LRG_AVAILABLE_IN_ALL
+GType lrg_reel_video_pipe_format_get_type (void) G_GNUC_CONST;
+#define LRG_TYPE_REEL_VIDEO_PIPE_FORMAT (lrg_reel_video_pipe_format_get_type ())
+
 /**
  * LrgReelAudioFormat:
  * @LRG_REEL_AUDIO_FORMAT_WAV: uncompressed PCM WAV.
@@ -233,6 +233,7 @@ typedef struct _LrgBTDecoratorClass  LrgBTDecoratorClass;
 /* Final types - no class typedef needed */
 typedef struct _LrgBlackboard     LrgBlackboard;
 typedef struct _LrgBehaviorTree   LrgBehaviorTree;
+typedef struct _LrgBTProgram      LrgBTProgram;
 
 /* ==========================================================================
  * Pathfinding Module
@@ -330,6 +331,9 @@ typedef struct _LrgCameraThirdPersonClass  LrgCameraThirdPersonClass;
 typedef struct _LrgRenderer       LrgRenderer;
 typedef struct _LrgRendererClass  LrgRendererClass;
 
+/* LrgRecordingRenderer is a final type - no Class forward declaration needed */
+typedef struct _LrgRecordingRenderer  LrgRecordingRenderer;
+
 /* LrgImageCanvas is a final type - no Class forward declaration needed */
 typedef struct _LrgImageCanvas    LrgImageCanvas;
 
@@ -385,6 +389,7 @@ typedef struct _LrgSector         LrgSector;
 typedef struct _LrgOctree        LrgOctree;
 typedef struct _LrgLevel3D       LrgLevel3D;
 typedef struct _LrgPortalSystem  LrgPortalSystem;
+typedef struct _LrgSectorStreamer LrgSectorStreamer;
 
 /* ==========================================================================
  * Scene Module
@@ -494,6 +499,9 @@ typedef struct _LrgScriptingClass  LrgScriptingClass;
 /* LrgScriptingLua is a final type - no Class forward declaration needed */
 typedef struct _LrgScriptingLua  LrgScriptingLua;
 
+/* LrgScriptJobSystem is a final type - no Class forward declaration needed */
+typedef struct _LrgScriptJobSystem  LrgScriptJobSystem;
+
 /* LrgScriptingGI is a derivable type (intermediate base for GI-based languages) */
 typedef struct _LrgScriptingGI       LrgScriptingGI;
 typedef struct _LrgScriptingGIClass  LrgScriptingGIClass;
@@ -632,6 +640,9 @@ typedef struct _LrgRoad  LrgRoad;
 /* LrgRoadNetwork is a final type - no Class forward declaration needed */
 typedef struct _LrgRoadNetwork  LrgRoadNetwork;
 
+/* LrgTrafficManager is a final type - no Class forward declaration needed */
+typedef struct _LrgTrafficManager  LrgTrafficManager;
+
 /* ==========================================================================
  * Particles Module (Phase 3)
  * ========================================================================== */
@@ -699,6 +710,8 @@ typedef struct _LrgFilmGrain        LrgFilmGrain;
 typedef struct _LrgBonePose           LrgBonePose;
 typedef struct _LrgAnimationKeyframe  LrgAnimationKeyframe;
 typedef struct _LrgAnimationEvent     LrgAnimationEvent;
+typedef struct _LrgAnimationClipCursor  LrgAnimationClipCursor;
+typedef struct _LrgPoseBuffer         LrgPoseBuffer;
 
 /* LrgBone is a final type - no Class forward declaration needed */
 typedef struct _LrgBone  LrgBone;
@@ -711,6 +724,9 @@ typedef struct _LrgSkeletonClass  LrgSkeletonClass;
 typedef struct _LrgAnimationClip       LrgAnimationClip;
 typedef struct _LrgAnimationClipClass  LrgAnimationClipClass;
 
+/* LrgCompressedClip is a final type - no Class forward declaration needed */
+typedef struct _LrgCompressedClip  LrgCompressedClip;
+
 /* LrgAnimator is a derivable type */
 typedef struct _LrgAnimator       LrgAnimator;
 typedef struct _LrgAnimatorClass  LrgAnimatorClass;
@@ -1016,6 +1032,9 @@ typedef struct _LrgCombatContext  LrgCombatContext;
 typedef struct _LrgCombatManager       LrgCombatManager;
 typedef struct _LrgCombatManagerClass  LrgCombatManagerClass;
 
+/* LrgCombatSimulator is a final type - no Class forward declaration needed */
+typedef struct _LrgCombatSimulator LrgCombatSimulator;
+
 /* LrgRun is a final type - no Class forward declaration needed */
 typedef struct _LrgRun  LrgRun;
 
@@ -1347,6 +1366,9 @@ typedef struct _LrgReelGradientClip  LrgReelGradientClip;
 typedef struct _LrgReelVideoSource   LrgReelVideoSource;
 typedef struct _LrgReelVideoClip     LrgReelVideoClip;
 
+/* LrgReelAudioAnalysis is a final type - no Class forward declaration needed */
+typedef struct _LrgReelAudioAnalysis  LrgReelAudioAnalysis;
+
 /* Reel effects (derivable base + concretes) */
 typedef struct _LrgReelEffect             LrgReelEffect;
 typedef struct _LrgReelEffectClass        LrgReelEffectClass;
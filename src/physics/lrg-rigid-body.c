@@ -27,15 +27,8 @@ typedef struct
     gfloat            gravity_scale;
     gboolean          is_trigger;
 
-    /* Transform */
-    gfloat            pos_x;
-    gfloat            pos_y;
-    gfloat            rotation;
-
-    /* Motion */
-    gfloat            vel_x;
-    gfloat            vel_y;
-    gfloat            angular_velocity;
+    /* Transform and motion, exposed by get_motion() */
+    LrgRigidBodyMotion motion;
 
     /* Forces (accumulated each frame) */
     gfloat            force_x;
@@ -349,13 +342,13 @@ lrg_rigid_body_init (LrgRigidBody *self)
     priv->gravity_scale = 1.0f;
     priv->is_trigger = FALSE;
 
-    priv->pos_x = 0.0f;
-    priv->pos_y = 0.0f;
-    priv->rotation = 0.0f;
+    priv->motion.pos_x = 0.0f;
+    priv->motion.pos_y = 0.0f;
+    priv->motion.rotation = 0.0f;
 
-    priv->vel_x = 0.0f;
-    priv->vel_y = 0.0f;
-    priv->angular_velocity = 0.0f;
+    priv->motion.vel_x = 0.0f;
+    priv->motion.vel_y = 0.0f;
+    priv->motion.angular_velocity = 0.0f;
 
     priv->force_x = 0.0f;
     priv->force_y = 0.0f;
@@ -649,9 +642,9 @@ lrg_rigid_body_get_position (LrgRigidBody *self,
     priv = lrg_rigid_body_get_instance_private (self);
 
     if (out_x)
-        *out_x = priv->pos_x;
+        *out_x = priv->motion.pos_x;
     if (out_y)
-        *out_y = priv->pos_y;
+        *out_y = priv->motion.pos_y;
 }
 
 void
@@ -664,8 +657,8 @@ lrg_rigid_body_set_position (LrgRigidBody *self,
     g_return_if_fail (LRG_IS_RIGID_BODY (self));
 
     priv = lrg_rigid_body_get_instance_private (self);
-    priv->pos_x = x;
-    priv->pos_y = y;
+    priv->motion.pos_x = x;
+    priv->motion.pos_y = y;
 
     /* Teleporting wakes the body */
     priv->sleeping = FALSE;
@@ -680,7 +673,7 @@ lrg_rigid_body_get_rotation (LrgRigidBody *self)
     g_return_val_if_fail (LRG_IS_RIGID_BODY (self), 0.0f);
 
     priv = lrg_rigid_body_get_instance_private (self);
-    return priv->rotation;
+    return priv->motion.rotation;
 }
 
 void
@@ -692,7 +685,7 @@ lrg_rigid_body_set_rotation (LrgRigidBody *self,
     g_return_if_fail (LRG_IS_RIGID_BODY (self));
 
     priv = lrg_rigid_body_get_instance_private (self);
-    priv->rotation = rotation;
+    priv->motion.rotation = rotation;
 }
 
 void
@@ -707,9 +700,9 @@ lrg_rigid_body_get_velocity (LrgRigidBody *self,
     priv = lrg_rigid_body_get_instance_private (self);
 
     if (out_x)
-        *out_x = priv->vel_x;
+        *out_x = priv->motion.vel_x;
     if (out_y)
-        *out_y = priv->vel_y;
+        *out_y = priv->motion.vel_y;
 }
 
 void
@@ -722,8 +715,8 @@ lrg_rigid_body_set_velocity (LrgRigidBody *self,
     g_return_if_fail (LRG_IS_RIGID_BODY (self));
 
     priv = lrg_rigid_body_get_instance_private (self);
-    priv->vel_x = x;
-    priv->vel_y = y;
+    priv->motion.vel_x = x;
+    priv->motion.vel_y = y;
 
     /* Wakes the body */
     priv->sleeping = FALSE;
@@ -738,7 +731,7 @@ lrg_rigid_body_get_angular_velocity (LrgRigidBody *self)
     g_return_val_if_fail (LRG_IS_RIGID_BODY (self), 0.0f);
 
     priv = lrg_rigid_body_get_instance_private (self);
-    return priv->angular_velocity;
+    return priv->motion.angular_velocity;
 }
 
 void
@@ -750,7 +743,7 @@ lrg_rigid_body_set_angular_velocity (LrgRigidBody *self,
     g_return_if_fail (LRG_IS_RIGID_BODY (self));
 
     priv = lrg_rigid_body_get_instance_private (self);
-    priv->angular_velocity = velocity;
+    priv->motion.angular_velocity = velocity;
 }
 
 /* ==========================================================================
@@ -780,8 +773,8 @@ lrg_rigid_body_add_force (LrgRigidBody *self,
         break;
 
     case LRG_FORCE_MODE_IMPULSE:
-        priv->vel_x += force_x * priv->inv_mass;
-        priv->vel_y += force_y * priv->inv_mass;
+        priv->motion.vel_x += force_x * priv->inv_mass;
+        priv->motion.vel_y += force_y * priv->inv_mass;
         break;
 
     case LRG_FORCE_MODE_ACCELERATION:
@@ -790,8 +783,8 @@ lrg_rigid_body_add_force (LrgRigidBody *self,
         break;
 
     case LRG_FORCE_MODE_VELOCITY_CHANGE:
-        priv->vel_x += force_x;
-        priv->vel_y += force_y;
+        priv->motion.vel_x += force_x;
+        priv->motion.vel_y += force_y;
         break;
     }
 
@@ -820,8 +813,8 @@ lrg_rigid_body_add_force_at_point (LrgRigidBody *self,
         return;
 
     /* Lever arm from center of mass to point */
-    rx = point_x - priv->pos_x;
-    ry = point_y - priv->pos_y;
+    rx = point_x - priv->motion.pos_x;
+    ry = point_y - priv->motion.pos_y;
 
     /* Cross product gives torque */
     cross = rx * force_y - ry * force_x;
@@ -854,7 +847,7 @@ lrg_rigid_body_add_torque (LrgRigidBody *self,
 
     case LRG_FORCE_MODE_IMPULSE:
     case LRG_FORCE_MODE_VELOCITY_CHANGE:
-        priv->angular_velocity += torque;
+        priv->motion.angular_velocity += torque;
         break;
     }
 
@@ -976,7 +969,18 @@ lrg_rigid_body_sleep (LrgRigidBody *self)
 
     priv = lrg_rigid_body_get_instance_private (self);
     priv->sleeping = TRUE;
-    priv->vel_x = 0.0f;
-    priv->vel_y = 0.0f;
-    priv->angular_velocity = 0.0f;
+    priv->motion.vel_x = 0.0f;
+    priv->motion.vel_y = 0.0f;
+    priv->motion.angular_velocity = 0.0f;
+}
+
+LrgRigidBodyMotion *
+lrg_rigid_body_get_motion (LrgRigidBody *self)
+{
+    LrgRigidBodyPrivate *priv;
+
+    g_return_val_if_fail (LRG_IS_RIGID_BODY (self), NULL);
+
+    priv = lrg_rigid_body_get_instance_private (self);
+    return &priv->motion;
 }
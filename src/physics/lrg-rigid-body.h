@@ -21,6 +21,29 @@ G_BEGIN_DECLS
 
 G_DECLARE_DERIVABLE_TYPE (LrgRigidBody, lrg_rigid_body, LRG, RIGID_BODY, GObject)
 
+/**
+ * LrgRigidBodyMotion:
+ * @pos_x: X position
+ * @pos_y: Y position
+ * @rotation: rotation in radians
+ * @vel_x: X velocity
+ * @vel_y: Y velocity
+ * @angular_velocity: angular velocity in radians per second
+ *
+ * The integrated state of an #LrgRigidBody, laid out as plain floats
+ * so scripting backends can map it directly (see
+ * lrg_rigid_body_get_motion()).
+ */
+typedef struct
+{
+    gfloat pos_x;
+    gfloat pos_y;
+    gfloat rotation;
+    gfloat vel_x;
+    gfloat vel_y;
+    gfloat angular_velocity;
+} LrgRigidBodyMotion;
+
 /**
  * LrgRigidBodyClass:
  * @on_collision: Called when this body collides with another
@@ -482,6 +505,22 @@ void                lrg_rigid_body_wake_up               (LrgRigidBody *self);
 LRG_AVAILABLE_IN_ALL
 void                lrg_rigid_body_sleep                 (LrgRigidBody *self);
 
+/**
+ * lrg_rigid_body_get_motion:
+ * @self: an #LrgRigidBody
+ *
+ * Gets the storage backing the body's position and velocity.
+ *
+ * Writes through the returned pointer are seen by the next physics
+ * step but do not wake a sleeping body; call
+ * lrg_rigid_body_wake_up() if needed.
+ *
+ * Returns: (transfer none): the motion state, valid for the lifetime
+ *   of @self
+ */
+LRG_AVAILABLE_IN_ALL
+LrgRigidBodyMotion * lrg_rigid_body_get_motion           (LrgRigidBody *self);
+
 G_END_DECLS
 
 #endif /* LRG_RIGID_BODY_H */
@@ -10,6 +10,29 @@
 #include "../audio/lrg-wave-data.h"
 #include <math.h>
 
+/* Samples per block of the running sum-of-squares table. */
+#define REEL_AUDIO_BLOCK 256
+
+struct _LrgReelAudioAnalysis
+{
+    GObject  parent_instance;
+
+    gdouble  fps;
+    guint    sample_rate;
+    guint    window_size;
+    guint    n_bins;       /* FFT size / 2 */
+    gint     frame_count;
+
+    gfloat  *mono;         /* mono mixdown of the whole wave */
+    gsize    n_samples;
+    gdouble *block_sq;     /* block_sq[b] = sum of mono^2 over [0, b * REEL_AUDIO_BLOCK) */
+    gfloat  *spectrogram;  /* frame_count rows of n_bins magnitudes */
+    gfloat  *silence;      /* n_bins zeros, returned for frames outside the wave */
+    gfloat  *envelope;     /* per-frame RMS over 1 / fps seconds */
+};
+
+G_DEFINE_FINAL_TYPE (LrgReelAudioAnalysis, lrg_reel_audio_analysis, G_TYPE_OBJECT)
+
 /* ==========================================================================
  * Internal helpers
  * ========================================================================== */
@@ -60,144 +83,477 @@ bit_reverse_index (guint x,
 }
 
 /*
- * fft_inplace:
- * @re: real parts (length N, N must be a power of two)
- * @im: imaginary parts (length N)
- * @N: FFT size (power of two)
+ * ReelRfftPlan:
  *
- * In-place iterative radix-2 Cooley-Tukey DIT FFT.
+ * Twiddle and permutation tables for a real-input FFT of length @n.
  *
- * After return, re[k] and im[k] hold the real and imaginary parts of
- * the k-th DFT bin.  The twiddle factors are computed on the fly to
- * avoid allocating a separate table.
+ * The n real samples are packed as n/2 complex values (even samples in
+ * the real part, odd samples in the imaginary part), transformed with
+ * an n/2-point radix-2 FFT and split back into the n/2 non-redundant
+ * bins of the real spectrum.  That is half the work of a complex FFT
+ * over zero imaginary parts, and the tables below mean no cos()/sin()
+ * runs per transform.
  *
- * Mental correctness check: a pure cosine of frequency k0 cycles per
- * N samples, stored in @re with @im all zeros, produces a peak at bin
- * k0 (and its mirror at N-k0) with magnitude N/2.  After scaling by
- * 2/window_size (applied in the caller), the returned magnitude is 1.0,
- * matching the unit-amplitude cosine.
+ * Plans are immutable once built and shared by every caller; see
+ * reel_rfft_plan_get().
+ */
+typedef struct
+{
+    guint    n;        /* real length (power of two, >= 2) */
+    guint    half;     /* n / 2: length of the packed complex FFT */
+    gdouble *cos_tab;  /* cos (2 pi k / n), k in [0, n/2) */
+    gdouble *sin_tab;  /* sin (2 pi k / n), k in [0, n/2) */
+    guint   *bitrev;   /* bit-reversal permutation of [0, n/2) */
+} ReelRfftPlan;
+
+static GMutex      rfft_lock;
+static GHashTable *rfft_plans;  /* GUINT_TO_POINTER (n) -> ReelRfftPlan, never freed */
+
+/*
+ * reel_rfft_plan_get:
+ * @n: transform length (power of two, >= 2)
+ *
+ * Returns the shared plan for @n, building it on first use.  Only a
+ * handful of sizes are ever used, so plans live for the whole process.
+ */
+static const ReelRfftPlan *
+reel_rfft_plan_get (guint n)
+{
+    ReelRfftPlan *plan;
+
+    g_mutex_lock (&rfft_lock);
+
+    if (rfft_plans == NULL)
+        rfft_plans = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    plan = g_hash_table_lookup (rfft_plans, GUINT_TO_POINTER (n));
+    if (plan == NULL)
+    {
+        guint log2m;
+        guint k;
+
+        plan = g_new0 (ReelRfftPlan, 1);
+        plan->n       = n;
+        plan->half    = n / 2;
+        plan->cos_tab = g_new (gdouble, plan->half);
+        plan->sin_tab = g_new (gdouble, plan->half);
+        plan->bitrev  = g_new (guint, plan->half);
+
+        log2m = 0;
+        while ((1u << log2m) < plan->half)
+            log2m++;
+
+        for (k = 0; k < plan->half; k++)
+        {
+            gdouble ang = 2.0 * G_PI * (gdouble) k / (gdouble) n;
+
+            plan->cos_tab[k] = cos (ang);
+            plan->sin_tab[k] = sin (ang);
+            plan->bitrev[k]  = bit_reverse_index (k, log2m);
+        }
+
+        g_hash_table_insert (rfft_plans, GUINT_TO_POINTER (n), plan);
+    }
+
+    g_mutex_unlock (&rfft_lock);
+
+    return plan;
+}
+
+/*
+ * reel_rfft_magnitudes:
+ * @plan: plan for the transform length n
+ * @in: (array length=n): real input, already windowed and zero-padded
+ * @re: scratch buffer of n/2 doubles
+ * @im: scratch buffer of n/2 doubles
+ * @scale: factor applied to every magnitude
+ * @out: (array length=n_out): destination for the magnitudes
+ * @n_out: number of bins to write; bins past n/2 are zero-filled
+ *
+ * Computes |X[k]| * @scale of the real DFT of @in for k in [0, @n_out).
  */
 static void
-fft_inplace (gdouble *re,
-             gdouble *im,
-             guint    N)
+reel_rfft_magnitudes (const ReelRfftPlan *plan,
+                      const gdouble      *in,
+                      gdouble            *re,
+                      gdouble            *im,
+                      gdouble             scale,
+                      gfloat             *out,
+                      guint               n_out)
 {
-    guint log2n;
-    guint i;
+    guint m = plan->half;
     guint len;
+    guint j;
+    guint k;
 
-    /* --- bit-reversal permutation ---------------------------------------- */
-    log2n = 0;
+    /* Pack even/odd samples as complex values in bit-reversed order. */
+    for (j = 0; j < m; j++)
     {
-        guint tmp;
-        tmp = N;
-        while (tmp > 1) { tmp >>= 1; log2n++; }
+        re[plan->bitrev[j]] = in[2 * j];
+        im[plan->bitrev[j]] = in[2 * j + 1];
     }
 
-    for (i = 0; i < N; i++)
+    /* Radix-2 butterflies; a size-len stage uses every (n/len)-th twiddle. */
+    for (len = 2; len <= m; len <<= 1)
     {
-        guint j;
-        j = bit_reverse_index (i, log2n);
-        if (j > i)
+        guint half_len = len >> 1;
+        guint stride   = plan->n / len;
+        guint i2;
+
+        for (i2 = 0; i2 < m; i2 += len)
         {
-            gdouble tr, ti;
-            tr = re[i]; re[i] = re[j]; re[j] = tr;
-            ti = im[i]; im[i] = im[j]; im[j] = ti;
+            for (j = 0; j < half_len; j++)
+            {
+                guint   u  = i2 + j;
+                guint   v  = u + half_len;
+                gdouble wr = plan->cos_tab[j * stride];
+                gdouble wi = -plan->sin_tab[j * stride];
+                gdouble vr = wr * re[v] - wi * im[v];
+                gdouble vi = wr * im[v] + wi * re[v];
+
+                re[v] = re[u] - vr;
+                im[v] = im[u] - vi;
+                re[u] += vr;
+                im[u] += vi;
+            }
         }
     }
 
-    /* --- Cooley-Tukey butterfly passes ------------------------------------ */
-    for (len = 2; len <= N; len <<= 1)
+    /*
+     * Split: with Z = FFT(packed), the even and odd halves of the real
+     * spectrum are E[k] = (Z[k] + conj Z[m-k]) / 2 and
+     * O[k] = (Z[k] - conj Z[m-k]) / 2i, and X[k] = E[k] + W^k O[k].
+     */
+    for (k = 0; k < n_out; k++)
     {
-        guint half_len;
-        gdouble ang;
-        gdouble wr_step, wi_step;
-        guint i2;
-
-        half_len = len >> 1;
-        ang      = -2.0 * G_PI / (gdouble) len;
-        wr_step  = cos (ang);
-        wi_step  = sin (ang);
+        guint   mk;
+        gdouble er, ei, or_, oi, wr, wi, xr, xi;
 
-        for (i2 = 0; i2 < N; i2 += len)
+        if (k >= m)
         {
-            gdouble wr, wi;
-            guint j2;
+            out[k] = 0.0f;
+            continue;
+        }
 
-            wr = 1.0;
-            wi = 0.0;
+        mk  = (k == 0) ? 0 : m - k;
+        er  = 0.5 * (re[k] + re[mk]);
+        ei  = 0.5 * (im[k] - im[mk]);
+        or_ = 0.5 * (im[k] + im[mk]);
+        oi  = -0.5 * (re[k] - re[mk]);
+        wr  = plan->cos_tab[k];
+        wi  = -plan->sin_tab[k];
+        xr  = er + wr * or_ - wi * oi;
+        xi  = ei + wr * oi + wi * or_;
+
+        out[k] = (gfloat) (sqrt (xr * xr + xi * xi) * scale);
+    }
+}
 
-            for (j2 = 0; j2 < half_len; j2++)
-            {
-                guint u_idx, v_idx;
-                gdouble ur, ui, vr, vi, tmp_wr;
-
-                u_idx = i2 + j2;
-                v_idx = i2 + j2 + half_len;
-
-                ur = re[u_idx];
-                ui = im[u_idx];
-                vr = wr * re[v_idx] - wi * im[v_idx];
-                vi = wr * im[v_idx] + wi * re[v_idx];
-
-                re[u_idx] = ur + vr;
-                im[u_idx] = ui + vi;
-                re[v_idx] = ur - vr;
-                im[v_idx] = ui - vi;
-
-                /* Advance twiddle factor via multiplication */
-                tmp_wr = wr * wr_step - wi * wi_step;
-                wi     = wr * wi_step + wi * wr_step;
-                wr     = tmp_wr;
-            }
+/*
+ * reel_audio_mixdown:
+ * @wave: an #LrgWaveData
+ * @out_count: (out): number of mono samples
+ * @out_rate: (out): sample rate of @wave
+ *
+ * Decodes @wave once and averages its channels in place.
+ *
+ * Returns: (transfer full) (nullable): mono samples, or %NULL if @wave
+ *   is empty or malformed.
+ */
+static gfloat *
+reel_audio_mixdown (LrgWaveData *wave,
+                    gsize       *out_count,
+                    guint       *out_rate)
+{
+    gfloat *samples;
+    gsize   total;
+    gsize   frames;
+    gsize   f;
+    guint   channels;
+
+    *out_count = 0;
+    *out_rate  = lrg_wave_data_get_sample_rate (wave);
+    channels   = lrg_wave_data_get_channels (wave);
+
+    if (channels == 0 || *out_rate == 0)
+        return NULL;
+
+    samples = lrg_wave_data_get_samples (wave, &total);
+    frames  = total / channels;
+    if (samples == NULL || frames == 0)
+    {
+        g_free (samples);
+        return NULL;
+    }
+
+    /* Frame f reads from f * channels >= f, so mixing in place is safe. */
+    if (channels > 1)
+    {
+        for (f = 0; f < frames; f++)
+        {
+            gdouble mono = 0.0;
+            guint   c;
+
+            for (c = 0; c < channels; c++)
+                mono += (gdouble) samples[f * channels + c];
+            samples[f] = (gfloat) (mono / (gdouble) channels);
         }
     }
+
+    *out_count = frames;
+
+    return samples;
 }
 
 /*
- * build_mono_window:
- * @samples: interleaved float samples from lrg_wave_data_get_samples()
- * @total_samples: total number of interleaved samples
- * @channels: number of channels
- * @start_frame: first frame index to read (may be < 0, clamped to 0)
- * @window_frames: number of audio frames to place in the window
- * @out_buf: (array length=window_frames): caller-allocated output buffer
- *
- * Fills @out_buf with @window_frames mono (averaged) samples beginning
- * at @start_frame.  Frames outside [0, total_frames) are written as 0.
+ * reel_audio_spectrum_fill:
+ * @mono: mono samples
+ * @n_mono: number of mono samples
+ * @center: sample the window is centred on
+ * @window_size: analysis window length
+ * @hann: (array length=window_size): Hann coefficients
+ * @buf: scratch buffer of FFT-size doubles
+ * @re: scratch buffer of FFT-size / 2 doubles
+ * @im: scratch buffer of FFT-size / 2 doubles
+ * @plan: plan for the FFT size
+ * @out: (array length=n_out): destination magnitudes
+ * @n_out: number of bins to write
  */
 static void
-build_mono_window (const gfloat *samples,
-                   gsize         total_samples,
-                   guint         channels,
-                   gsize         start_frame,
-                   guint         window_frames,
-                   gdouble      *out_buf)
+reel_audio_spectrum_fill (const gfloat       *mono,
+                          gsize               n_mono,
+                          gsize               center,
+                          guint               window_size,
+                          const gdouble      *hann,
+                          gdouble            *buf,
+                          gdouble            *re,
+                          gdouble            *im,
+                          const ReelRfftPlan *plan,
+                          gfloat             *out,
+                          guint               n_out)
 {
+    gsize start;
     guint n;
-    gsize total_frames;
 
-    total_frames = (channels > 0) ? (total_samples / channels) : 0;
+    start = (center >= (gsize) (window_size / 2)) ? center - window_size / 2 : 0;
 
-    for (n = 0; n < window_frames; n++)
+    for (n = 0; n < window_size; n++)
     {
-        gsize frame_idx;
-        gdouble mono;
-        guint c;
+        gsize idx = start + n;
+
+        buf[n] = (idx < n_mono) ? (gdouble) mono[idx] * hann[n] : 0.0;
+    }
+    for (; n < plan->n; n++)
+        buf[n] = 0.0;
+
+    reel_rfft_magnitudes (plan, buf, re, im, 2.0 / (gdouble) window_size, out, n_out);
+}
+
+static gdouble *
+reel_audio_hann (guint window_size)
+{
+    gdouble *hann = g_new (gdouble, window_size);
+    guint    n;
+
+    if (window_size == 1)
+    {
+        hann[0] = 1.0;
+        return hann;
+    }
 
-        frame_idx = start_frame + (gsize) n;
+    for (n = 0; n < window_size; n++)
+        hann[n] = 0.5 * (1.0 - cos (2.0 * G_PI * (gdouble) n / (gdouble) (window_size - 1)));
+
+    return hann;
+}
+
+/*
+ * reel_audio_waveform_fill:
+ *
+ * Peak-amplitude buckets over @window_frames samples from @start,
+ * signed by the sign of each bucket's mean.  See lrg_reel_audio_waveform().
+ */
+static void
+reel_audio_waveform_fill (const gfloat *mono,
+                          gsize         n_mono,
+                          gsize         start,
+                          gsize         window_frames,
+                          gfloat       *out,
+                          guint         n_out)
+{
+    guint i;
+
+    for (i = 0; i < n_out; i++)
+    {
+        gsize   bucket_start;
+        gsize   bucket_end;
+        gsize   f;
+        gdouble peak_abs = 0.0;
+        gdouble sum      = 0.0;
 
-        if (frame_idx >= total_frames)
+        bucket_start = start + (gsize) ((gdouble) i       * (gdouble) window_frames / (gdouble) n_out);
+        bucket_end   = start + (gsize) ((gdouble) (i + 1) * (gdouble) window_frames / (gdouble) n_out);
+
+        if (bucket_start >= bucket_end)
+            bucket_end = bucket_start + 1;
+        if (bucket_end > n_mono)
+            bucket_end = n_mono;
+
+        if (bucket_start >= bucket_end)
         {
-            out_buf[n] = 0.0;
+            out[i] = 0.0f;
             continue;
         }
 
-        mono = 0.0;
-        for (c = 0; c < channels; c++)
-            mono += (gdouble) samples[frame_idx * channels + c];
+        for (f = bucket_start; f < bucket_end; f++)
+        {
+            gdouble v = (gdouble) mono[f];
+
+            if (fabs (v) > peak_abs)
+                peak_abs = fabs (v);
+            sum += v;
+        }
 
-        out_buf[n] = mono / (gdouble) channels;
+        if (peak_abs > 1.0)
+            peak_abs = 1.0;
+        out[i] = (gfloat) ((sum >= 0.0) ? peak_abs : -peak_abs);
+    }
+}
+
+static gdouble
+reel_audio_rms_scan (const gfloat *mono,
+                     gsize         start,
+                     gsize         end)
+{
+    gdouble sum_sq = 0.0;
+    gsize   f;
+
+    for (f = start; f < end; f++)
+        sum_sq += (gdouble) mono[f] * (gdouble) mono[f];
+
+    return sum_sq;
+}
+
+/*
+ * reel_audio_window:
+ *
+ * Maps (frame, seconds) to the [start, end) sample range used by the
+ * level and waveform analyses, clipped to the buffer.  Returns %FALSE
+ * when nothing of the window lies inside it.
+ */
+static gboolean
+reel_audio_window (gint     frame,
+                   gdouble  fps,
+                   gdouble  seconds,
+                   guint    sample_rate,
+                   gsize    n_mono,
+                   gsize   *out_start,
+                   gsize   *out_frames)
+{
+    gdouble start;
+    gsize   window_frames;
+
+    start         = round ((gdouble) frame / fps * (gdouble) sample_rate);
+    window_frames = (gsize) round (seconds * (gdouble) sample_rate);
+
+    if (window_frames == 0)
+        window_frames = 1;
+    if (start < 0.0 || start >= (gdouble) n_mono)
+        return FALSE;
+
+    *out_start  = (gsize) start;
+    *out_frames = window_frames;
+
+    return TRUE;
+}
+
+/* ==========================================================================
+ * LrgReelAudioAnalysis
+ * ========================================================================== */
+
+static void
+lrg_reel_audio_analysis_finalize (GObject *object)
+{
+    LrgReelAudioAnalysis *self = LRG_REEL_AUDIO_ANALYSIS (object);
+
+    g_clear_pointer (&self->mono, g_free);
+    g_clear_pointer (&self->block_sq, g_free);
+    g_clear_pointer (&self->spectrogram, g_free);
+    g_clear_pointer (&self->silence, g_free);
+    g_clear_pointer (&self->envelope, g_free);
+
+    G_OBJECT_CLASS (lrg_reel_audio_analysis_parent_class)->finalize (object);
+}
+
+static void
+lrg_reel_audio_analysis_class_init (LrgReelAudioAnalysisClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = lrg_reel_audio_analysis_finalize;
+}
+
+static void
+lrg_reel_audio_analysis_init (LrgReelAudioAnalysis *self)
+{
+}
+
+/* Sum of mono^2 over [start, end) in O(REEL_AUDIO_BLOCK). */
+static gdouble
+reel_audio_analysis_sum_sq (LrgReelAudioAnalysis *self,
+                            gsize                 start,
+                            gsize                 end)
+{
+    gsize first_block = (start + REEL_AUDIO_BLOCK - 1) / REEL_AUDIO_BLOCK;
+    gsize last_block  = end / REEL_AUDIO_BLOCK;
+
+    if (first_block >= last_block)
+        return reel_audio_rms_scan (self->mono, start, end);
+
+    return self->block_sq[last_block] - self->block_sq[first_block]
+         + reel_audio_rms_scan (self->mono, start, first_block * REEL_AUDIO_BLOCK)
+         + reel_audio_rms_scan (self->mono, last_block * REEL_AUDIO_BLOCK, end);
+}
+
+static void
+reel_audio_analysis_build (LrgReelAudioAnalysis *self)
+{
+    const ReelRfftPlan *plan;
+    g_autofree gdouble *hann = NULL;
+    g_autofree gdouble *buf = NULL;
+    g_autofree gdouble *re = NULL;
+    g_autofree gdouble *im = NULL;
+    gsize               n_blocks;
+    gsize               b;
+    gint                f;
+
+    /* Running sum of squares, one entry per block boundary. */
+    n_blocks = self->n_samples / REEL_AUDIO_BLOCK;
+    self->block_sq = g_new (gdouble, n_blocks + 1);
+    self->block_sq[0] = 0.0;
+    for (b = 0; b < n_blocks; b++)
+        self->block_sq[b + 1] = self->block_sq[b]
+            + reel_audio_rms_scan (self->mono, b * REEL_AUDIO_BLOCK, (b + 1) * REEL_AUDIO_BLOCK);
+
+    /* One STFT column and one RMS value per video frame. */
+    plan = reel_rfft_plan_get (self->n_bins * 2);
+    hann = reel_audio_hann (self->window_size);
+    buf  = g_new (gdouble, plan->n);
+    re   = g_new (gdouble, plan->half);
+    im   = g_new (gdouble, plan->half);
+
+    self->spectrogram = g_new (gfloat, (gsize) self->frame_count * self->n_bins);
+    self->envelope    = g_new0 (gfloat, self->frame_count);
+
+    for (f = 0; f < self->frame_count; f++)
+    {
+        gsize center = (gsize) round ((gdouble) f / self->fps * (gdouble) self->sample_rate);
+
+        reel_audio_spectrum_fill (self->mono, self->n_samples, center,
+                                  self->window_size, hann, buf, re, im, plan,
+                                  self->spectrogram + (gsize) f * self->n_bins,
+                                  self->n_bins);
+        self->envelope[f] = (gfloat) lrg_reel_audio_analysis_get_level (self, f, 1.0 / self->fps);
     }
 }
 
@@ -205,6 +561,231 @@ build_mono_window (const gfloat *samples,
  * Public API
  * ========================================================================== */
 
+/**
+ * lrg_reel_audio_analysis_new:
+ * @wave: an #LrgWaveData
+ * @fps: frames per second of the video (must be > 0)
+ * @window_size: number of audio samples per spectrum window (must be > 0)
+ *
+ * Decodes @wave once and precomputes its spectrogram and RMS envelope.
+ *
+ * Returns: (transfer full): a new #LrgReelAudioAnalysis
+ */
+LrgReelAudioAnalysis *
+lrg_reel_audio_analysis_new (LrgWaveData *wave,
+                             gdouble      fps,
+                             guint        window_size)
+{
+    LrgReelAudioAnalysis *self;
+
+    g_return_val_if_fail (wave != NULL, NULL);
+    g_return_val_if_fail (fps > 0.0, NULL);
+    g_return_val_if_fail (window_size > 0, NULL);
+
+    self = g_object_new (LRG_TYPE_REEL_AUDIO_ANALYSIS, NULL);
+    self->fps         = fps;
+    self->window_size = window_size;
+    self->n_bins      = MAX (next_pow2 (window_size), 2) / 2;
+    self->silence     = g_new0 (gfloat, self->n_bins);
+    self->mono        = reel_audio_mixdown (wave, &self->n_samples, &self->sample_rate);
+
+    if (self->mono != NULL)
+        self->frame_count = (gint) ceil ((gdouble) self->n_samples * fps
+                                         / (gdouble) self->sample_rate);
+
+    reel_audio_analysis_build (self);
+
+    return self;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_fps:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the frame rate the analysis was built for
+ */
+gdouble
+lrg_reel_audio_analysis_get_fps (LrgReelAudioAnalysis *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), 0.0);
+
+    return self->fps;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_sample_rate:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the sample rate of the analysed wave, or 0 if it was empty
+ */
+guint
+lrg_reel_audio_analysis_get_sample_rate (LrgReelAudioAnalysis *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), 0);
+
+    return self->sample_rate;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_window_size:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the spectrum window length in samples
+ */
+guint
+lrg_reel_audio_analysis_get_window_size (LrgReelAudioAnalysis *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), 0);
+
+    return self->window_size;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_bin_count:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the number of magnitude bins per spectrum
+ */
+guint
+lrg_reel_audio_analysis_get_bin_count (LrgReelAudioAnalysis *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), 0);
+
+    return self->n_bins;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_frame_count:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the number of video frames covered by the wave
+ */
+gint
+lrg_reel_audio_analysis_get_frame_count (LrgReelAudioAnalysis *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), 0);
+
+    return self->frame_count;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_spectrum:
+ * @self: an #LrgReelAudioAnalysis
+ * @frame: video frame index (0-based)
+ * @out_count: (out) (optional): set to the bin count
+ *
+ * Looks up the precomputed spectrum for @frame.
+ *
+ * Returns: (transfer none) (array length=out_count): magnitude bins
+ */
+const gfloat *
+lrg_reel_audio_analysis_get_spectrum (LrgReelAudioAnalysis *self,
+                                      gint                  frame,
+                                      gsize                *out_count)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), NULL);
+
+    if (out_count != NULL)
+        *out_count = self->n_bins;
+
+    if (frame < 0 || frame >= self->frame_count)
+        return self->silence;
+
+    return self->spectrogram + (gsize) frame * self->n_bins;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_envelope:
+ * @self: an #LrgReelAudioAnalysis
+ * @out_count: (out) (optional): set to the frame count
+ *
+ * Returns: (transfer none) (array length=out_count): per-frame RMS levels
+ */
+const gfloat *
+lrg_reel_audio_analysis_get_envelope (LrgReelAudioAnalysis *self,
+                                      gsize                *out_count)
+{
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), NULL);
+
+    if (out_count != NULL)
+        *out_count = (gsize) self->frame_count;
+
+    return self->envelope;
+}
+
+/**
+ * lrg_reel_audio_analysis_get_level:
+ * @self: an #LrgReelAudioAnalysis
+ * @frame: video frame index (0-based)
+ * @seconds: length of the audio window in seconds (must be > 0)
+ *
+ * Returns: RMS level in [0.0, 1.0]
+ */
+gdouble
+lrg_reel_audio_analysis_get_level (LrgReelAudioAnalysis *self,
+                                   gint                  frame,
+                                   gdouble               seconds)
+{
+    gsize   start;
+    gsize   window_frames;
+    gsize   end;
+    gdouble rms;
+
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), 0.0);
+
+    if (seconds <= 0.0 ||
+        !reel_audio_window (frame, self->fps, seconds, self->sample_rate,
+                            self->n_samples, &start, &window_frames))
+        return 0.0;
+
+    end = MIN (start + window_frames, self->n_samples);
+    rms = sqrt (reel_audio_analysis_sum_sq (self, start, end) / (gdouble) (end - start));
+
+    return MIN (rms, 1.0);
+}
+
+/**
+ * lrg_reel_audio_analysis_get_waveform:
+ * @self: an #LrgReelAudioAnalysis
+ * @frame: video frame index (0-based)
+ * @seconds: length of the audio window in seconds (must be > 0)
+ * @n_samples: number of output waveform samples (must be > 0)
+ * @out_count: (out) (optional): set to @n_samples, or 0 on failure
+ *
+ * Returns: (transfer full) (array length=out_count) (nullable): waveform
+ *   values in [-1, 1].  Free with g_free().
+ */
+gfloat *
+lrg_reel_audio_analysis_get_waveform (LrgReelAudioAnalysis *self,
+                                      gint                  frame,
+                                      gdouble               seconds,
+                                      guint                 n_samples,
+                                      gsize                *out_count)
+{
+    gfloat *result;
+    gsize   start;
+    gsize   window_frames;
+
+    if (out_count != NULL)
+        *out_count = 0;
+
+    g_return_val_if_fail (LRG_IS_REEL_AUDIO_ANALYSIS (self), NULL);
+
+    if (n_samples == 0 || seconds <= 0.0)
+        return NULL;
+
+    result = g_new0 (gfloat, n_samples);
+    if (reel_audio_window (frame, self->fps, seconds, self->sample_rate,
+                           self->n_samples, &start, &window_frames))
+        reel_audio_waveform_fill (self->mono, self->n_samples, start,
+                                  window_frames, result, n_samples);
+
+    if (out_count != NULL)
+        *out_count = n_samples;
+
+    return result;
+}
+
 /**
  * lrg_reel_audio_spectrum:
  * @wave: an #LrgWaveData
@@ -229,112 +810,39 @@ lrg_reel_audio_spectrum (LrgWaveData *wave,
                           guint        window_size,
                           gsize       *out_count)
 {
-    gfloat  *samples;
-    gsize    total_samples;
-    guint    channels;
-    guint    sample_rate;
-    guint    N;
-    gdouble *re;
-    gdouble *im;
-    gfloat  *result;
-    gsize    center_sample;
-    gsize    start_frame;
-    guint    half_window;
-    guint    n;
-    guint    k;
+    const ReelRfftPlan *plan;
+    g_autofree gfloat  *mono = NULL;
+    g_autofree gdouble *hann = NULL;
+    g_autofree gdouble *buf = NULL;
+    g_autofree gdouble *re = NULL;
+    g_autofree gdouble *im = NULL;
+    gfloat             *result;
+    gsize               n_mono;
+    guint               sample_rate;
+    gsize               center;
+
+    if (out_count != NULL)
+        *out_count = 0;
 
     /* --- Validate inputs -------------------------------------------------- */
     if (wave == NULL || n_bins == 0 || window_size == 0 || fps <= 0.0)
-    {
-        if (out_count != NULL)
-            *out_count = 0;
         return NULL;
-    }
 
-    /* --- Fetch raw samples (transfer full) -------------------------------- */
-    samples = lrg_wave_data_get_samples (wave, &total_samples);
-    if (samples == NULL || total_samples == 0)
-    {
-        g_free (samples);
-        if (out_count != NULL)
-            *out_count = 0;
+    mono = reel_audio_mixdown (wave, &n_mono, &sample_rate);
+    if (mono == NULL)
         return NULL;
-    }
-
-    channels    = lrg_wave_data_get_channels (wave);
-    sample_rate = lrg_wave_data_get_sample_rate (wave);
-
-    if (channels == 0 || sample_rate == 0)
-    {
-        g_free (samples);
-        if (out_count != NULL)
-            *out_count = 0;
-        return NULL;
-    }
-
-    /* --- Determine window start sample ------------------------------------ */
-    center_sample = (gsize) round ((gdouble) frame / fps * (gdouble) sample_rate);
-    half_window   = window_size / 2;
 
-    if (center_sample >= (gsize) half_window)
-        start_frame = center_sample - (gsize) half_window;
-    else
-        start_frame = 0;
+    /* --- Window, transform, pack ------------------------------------------ */
+    center = (gsize) round ((gdouble) frame / fps * (gdouble) sample_rate);
+    plan   = reel_rfft_plan_get (MAX (next_pow2 (window_size), 2));
+    hann   = reel_audio_hann (window_size);
+    buf    = g_new (gdouble, plan->n);
+    re     = g_new (gdouble, plan->half);
+    im     = g_new (gdouble, plan->half);
+    result = g_new (gfloat, n_bins);
 
-    /* --- Allocate FFT buffers --------------------------------------------- */
-    N  = next_pow2 (window_size);
-    re = g_new0 (gdouble, N);
-    im = g_new0 (gdouble, N);
-
-    /* --- Fill real part: Hann-windowed mono samples ----------------------- */
-    {
-        gdouble *mono_window;
-        mono_window = g_new0 (gdouble, window_size);
-
-        build_mono_window (samples, total_samples, channels,
-                           start_frame, window_size, mono_window);
-
-        for (n = 0; n < window_size; n++)
-        {
-            gdouble w;
-            w     = 0.5 * (1.0 - cos (2.0 * G_PI * (gdouble) n
-                                       / (gdouble) (window_size - 1)));
-            re[n] = mono_window[n] * w;
-        }
-        /* Indices [window_size, N) remain zero (zero-padding). */
-
-        g_free (mono_window);
-    }
-
-    g_free (samples);
-
-    /* --- FFT -------------------------------------------------------------- */
-    fft_inplace (re, im, N);
-
-    /* --- Compute magnitudes and pack result ------------------------------- */
-    result = g_new0 (gfloat, n_bins);
-
-    {
-        guint available_bins;
-        gdouble scale;
-
-        available_bins = N / 2;
-        scale          = 2.0 / (gdouble) window_size;
-
-        for (k = 0; k < n_bins; k++)
-        {
-            if (k < available_bins)
-            {
-                gdouble mag;
-                mag       = sqrt (re[k] * re[k] + im[k] * im[k]) * scale;
-                result[k] = (gfloat) mag;
-            }
-            /* else: already zero from g_new0 */
-        }
-    }
-
-    g_free (re);
-    g_free (im);
+    reel_audio_spectrum_fill (mono, n_mono, center, window_size, hann,
+                              buf, re, im, plan, result, n_bins);
 
     if (out_count != NULL)
         *out_count = (gsize) n_bins;
@@ -365,109 +873,30 @@ lrg_reel_audio_waveform (LrgWaveData *wave,
                           guint        n_samples,
                           gsize       *out_count)
 {
-    gfloat  *samples;
-    gsize    total_samples;
-    guint    channels;
-    guint    sample_rate;
-    gsize    start_frame;
-    gsize    window_frames;
-    gsize    total_frames;
-    gfloat  *result;
-    guint    i;
+    g_autofree gfloat *mono = NULL;
+    gfloat            *result;
+    gsize              n_mono;
+    guint              sample_rate;
+    gsize              start;
+    gsize              window_frames;
+
+    if (out_count != NULL)
+        *out_count = 0;
 
     /* --- Validate inputs -------------------------------------------------- */
     if (wave == NULL || n_samples == 0 || fps <= 0.0 || seconds <= 0.0)
-    {
-        if (out_count != NULL)
-            *out_count = 0;
         return NULL;
-    }
 
-    /* --- Fetch raw samples (transfer full) -------------------------------- */
-    samples = lrg_wave_data_get_samples (wave, &total_samples);
-    if (samples == NULL || total_samples == 0)
-    {
-        g_free (samples);
-        if (out_count != NULL)
-            *out_count = 0;
-        return NULL;
-    }
-
-    channels    = lrg_wave_data_get_channels (wave);
-    sample_rate = lrg_wave_data_get_sample_rate (wave);
-
-    if (channels == 0 || sample_rate == 0)
-    {
-        g_free (samples);
-        if (out_count != NULL)
-            *out_count = 0;
+    mono = reel_audio_mixdown (wave, &n_mono, &sample_rate);
+    if (mono == NULL)
         return NULL;
-    }
-
-    total_frames  = total_samples / channels;
-    start_frame   = (gsize) round ((gdouble) frame / fps * (gdouble) sample_rate);
-    window_frames = (gsize) round (seconds * (gdouble) sample_rate);
-
-    if (window_frames == 0)
-        window_frames = 1;
-
-    /* --- Allocate output -------------------------------------------------- */
-    result = g_new0 (gfloat, n_samples);
 
     /* --- Down-sample into buckets ----------------------------------------- */
-    for (i = 0; i < n_samples; i++)
-    {
-        gsize bucket_start;
-        gsize bucket_end;
-        gsize f;
-        gdouble peak_abs;
-        gdouble mean_sign_sum;
-        gsize   count_in_range;
-
-        bucket_start = start_frame
-                       + (gsize) ((gdouble) i       * (gdouble) window_frames / (gdouble) n_samples);
-        bucket_end   = start_frame
-                       + (gsize) ((gdouble) (i + 1) * (gdouble) window_frames / (gdouble) n_samples);
-
-        if (bucket_start >= bucket_end)
-            bucket_end = bucket_start + 1;
-
-        peak_abs      = 0.0;
-        mean_sign_sum = 0.0;
-        count_in_range = 0;
-
-        for (f = bucket_start; f < bucket_end; f++)
-        {
-            guint c;
-            gdouble mono;
-
-            if (f >= total_frames)
-                break;
-
-            mono = 0.0;
-            for (c = 0; c < channels; c++)
-                mono += (gdouble) samples[f * channels + c];
-            mono /= (gdouble) channels;
-
-            if (fabs (mono) > peak_abs)
-                peak_abs = fabs (mono);
-
-            mean_sign_sum += mono;
-            count_in_range++;
-        }
-
-        if (count_in_range > 0)
-        {
-            gdouble sign_val;
-            sign_val = (mean_sign_sum >= 0.0) ? 1.0 : -1.0;
-            if (peak_abs > 1.0)
-                peak_abs = 1.0;
-            result[i] = (gfloat) (peak_abs * sign_val);
-        }
-        /* else: out of range, result[i] stays 0.0 (from g_new0) */
-    }
-
-    g_free (samples);
+    result = g_new0 (gfloat, n_samples);
+    if (reel_audio_window (frame, fps, seconds, sample_rate, n_mono,
+                           &start, &window_frames))
+        reel_audio_waveform_fill (mono, n_mono, start, window_frames,
+                                  result, n_samples);
 
     if (out_count != NULL)
         *out_count = (gsize) n_samples;
@@ -493,76 +922,27 @@ lrg_reel_audio_level (LrgWaveData *wave,
                        gdouble      fps,
                        gdouble      seconds)
 {
-    gfloat  *samples;
-    gsize    total_samples;
-    guint    channels;
-    guint    sample_rate;
-    gsize    start_frame;
-    gsize    window_frames;
-    gsize    total_frames;
-    gdouble  sum_sq;
-    gsize    count;
-    gsize    f;
-    gdouble  rms;
+    g_autofree gfloat *mono = NULL;
+    gsize              n_mono;
+    guint              sample_rate;
+    gsize              start;
+    gsize              window_frames;
+    gsize              end;
+    gdouble            rms;
 
     /* --- Validate inputs -------------------------------------------------- */
     if (wave == NULL || fps <= 0.0 || seconds <= 0.0)
         return 0.0;
 
-    /* --- Fetch raw samples (transfer full) -------------------------------- */
-    samples = lrg_wave_data_get_samples (wave, &total_samples);
-    if (samples == NULL || total_samples == 0)
-    {
-        g_free (samples);
-        return 0.0;
-    }
-
-    channels    = lrg_wave_data_get_channels (wave);
-    sample_rate = lrg_wave_data_get_sample_rate (wave);
-
-    if (channels == 0 || sample_rate == 0)
-    {
-        g_free (samples);
+    mono = reel_audio_mixdown (wave, &n_mono, &sample_rate);
+    if (mono == NULL ||
+        !reel_audio_window (frame, fps, seconds, sample_rate, n_mono,
+                            &start, &window_frames))
         return 0.0;
-    }
-
-    total_frames  = total_samples / channels;
-    start_frame   = (gsize) round ((gdouble) frame / fps * (gdouble) sample_rate);
-    window_frames = (gsize) round (seconds * (gdouble) sample_rate);
-
-    if (window_frames == 0)
-        window_frames = 1;
 
     /* --- Accumulate RMS --------------------------------------------------- */
-    sum_sq = 0.0;
-    count  = 0;
-
-    for (f = start_frame; f < start_frame + window_frames; f++)
-    {
-        guint c;
-        gdouble mono;
-
-        if (f >= total_frames)
-            break;
-
-        mono = 0.0;
-        for (c = 0; c < channels; c++)
-            mono += (gdouble) samples[f * channels + c];
-        mono /= (gdouble) channels;
-
-        sum_sq += mono * mono;
-        count++;
-    }
-
-    g_free (samples);
-
-    if (count == 0)
-        return 0.0;
-
-    rms = sqrt (sum_sq / (gdouble) count);
-
-    if (rms > 1.0)
-        rms = 1.0;
+    end = MIN (start + window_frames, n_mono);
+    rms = sqrt (reel_audio_rms_scan (mono, start, end) / (gdouble) (end - start));
 
-    return rms;
+    return MIN (rms, 1.0);
 }
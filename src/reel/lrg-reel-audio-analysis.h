@@ -6,18 +6,21 @@
  *
  * Audio analysis helpers for the Reel video-composition module.
  *
- * These are free functions (no GObject type) that operate on an
- * #LrgWaveData object and produce per-frame analysis results suitable
- * for audiograms and music visualizers.
+ * Three analyses are provided, each in two forms:
  *
- * Three analyses are provided:
+ *  - spectrum: Hann-windowed FFT magnitude bins.
+ *  - waveform: Down-sampled peak-amplitude waveform.
+ *  - level:    Single RMS level value.
  *
- *  - lrg_reel_audio_spectrum(): Hann-windowed radix-2 FFT magnitude bins.
- *  - lrg_reel_audio_waveform(): Down-sampled peak-amplitude waveform.
- *  - lrg_reel_audio_level():    Single RMS level value.
+ * The free functions (lrg_reel_audio_spectrum() and friends) take an
+ * #LrgWaveData and decode it on every call, which suits one-off queries.
+ * #LrgReelAudioAnalysis decodes the wave once and precomputes a
+ * spectrogram and RMS envelope at the reel frame rate, so per-frame
+ * lookups from audio-reactive clips are O(1).  It is immutable after
+ * construction and may be shared between render threads.
  *
- * All functions down-mix multi-channel audio to mono by averaging
- * channels before analysis.
+ * All analyses down-mix multi-channel audio to mono by averaging
+ * channels first.
  */
 
 #pragma once
@@ -32,6 +35,131 @@
 
 G_BEGIN_DECLS
 
+#define LRG_TYPE_REEL_AUDIO_ANALYSIS (lrg_reel_audio_analysis_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgReelAudioAnalysis, lrg_reel_audio_analysis, LRG, REEL_AUDIO_ANALYSIS, GObject)
+
+/**
+ * lrg_reel_audio_analysis_new:
+ * @wave: an #LrgWaveData
+ * @fps: frames per second of the video (must be > 0)
+ * @window_size: number of audio samples in each spectrum window (must
+ *   be > 0); rounded up to a power of two for the FFT, as in
+ *   lrg_reel_audio_spectrum().
+ *
+ * Decodes @wave to mono once and precomputes, for every video frame, the
+ * spectrum that lrg_reel_audio_spectrum() would return and the RMS level
+ * over 1 / @fps seconds.  Construction costs one FFT per frame; the wave
+ * is not referenced afterwards.
+ *
+ * Returns: (transfer full): a new #LrgReelAudioAnalysis
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgReelAudioAnalysis *
+lrg_reel_audio_analysis_new (LrgWaveData *wave,
+                             gdouble      fps,
+                             guint        window_size);
+
+LRG_AVAILABLE_IN_ALL
+gdouble lrg_reel_audio_analysis_get_fps         (LrgReelAudioAnalysis *self);
+LRG_AVAILABLE_IN_ALL
+guint   lrg_reel_audio_analysis_get_sample_rate (LrgReelAudioAnalysis *self);
+LRG_AVAILABLE_IN_ALL
+guint   lrg_reel_audio_analysis_get_window_size (LrgReelAudioAnalysis *self);
+
+/**
+ * lrg_reel_audio_analysis_get_bin_count:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the number of bins in each spectrum, N/2 for FFT size N
+ */
+LRG_AVAILABLE_IN_ALL
+guint   lrg_reel_audio_analysis_get_bin_count   (LrgReelAudioAnalysis *self);
+
+/**
+ * lrg_reel_audio_analysis_get_frame_count:
+ * @self: an #LrgReelAudioAnalysis
+ *
+ * Returns: the number of video frames spanned by the wave
+ */
+LRG_AVAILABLE_IN_ALL
+gint    lrg_reel_audio_analysis_get_frame_count (LrgReelAudioAnalysis *self);
+
+/**
+ * lrg_reel_audio_analysis_get_spectrum:
+ * @self: an #LrgReelAudioAnalysis
+ * @frame: video frame index (0-based)
+ * @out_count: (out) (optional): set to the bin count
+ *
+ * Looks up the precomputed magnitude spectrum for @frame, scaled as in
+ * lrg_reel_audio_spectrum().  Frames outside the wave return silence.
+ *
+ * Returns: (transfer none) (array length=out_count): bins owned by @self
+ */
+LRG_AVAILABLE_IN_ALL
+const gfloat *
+lrg_reel_audio_analysis_get_spectrum (LrgReelAudioAnalysis *self,
+                                      gint                  frame,
+                                      gsize                *out_count);
+
+/**
+ * lrg_reel_audio_analysis_get_envelope:
+ * @self: an #LrgReelAudioAnalysis
+ * @out_count: (out) (optional): set to the frame count
+ *
+ * Gets the RMS level of every frame over 1 / fps seconds, i.e.
+ * lrg_reel_audio_analysis_get_level (self, frame, 1.0 / fps).
+ *
+ * Returns: (transfer none) (array length=out_count) (nullable): levels
+ *   owned by @self, or %NULL for an empty wave
+ */
+LRG_AVAILABLE_IN_ALL
+const gfloat *
+lrg_reel_audio_analysis_get_envelope (LrgReelAudioAnalysis *self,
+                                      gsize                *out_count);
+
+/**
+ * lrg_reel_audio_analysis_get_level:
+ * @self: an #LrgReelAudioAnalysis
+ * @frame: video frame index (0-based)
+ * @seconds: length of the audio window in seconds (must be > 0)
+ *
+ * Same result as lrg_reel_audio_level(), answered from a running
+ * sum-of-squares table instead of rescanning the window.
+ *
+ * Returns: RMS level in [0.0, 1.0]
+ */
+LRG_AVAILABLE_IN_ALL
+gdouble
+lrg_reel_audio_analysis_get_level (LrgReelAudioAnalysis *self,
+                                   gint                  frame,
+                                   gdouble               seconds);
+
+/**
+ * lrg_reel_audio_analysis_get_waveform:
+ * @self: an #LrgReelAudioAnalysis
+ * @frame: video frame index (0-based)
+ * @seconds: length of the audio window in seconds (must be > 0)
+ * @n_samples: number of output waveform samples (must be > 0)
+ * @out_count: (out) (optional): set to @n_samples, or 0 on failure
+ *
+ * Same result as lrg_reel_audio_waveform(), read from the cached mono
+ * buffer.  Cost is proportional to the window, not the wave.
+ *
+ * Returns: (transfer full) (array length=out_count) (nullable): values
+ *   in [-1, 1], or %NULL on invalid input.  Free with g_free().
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat *
+lrg_reel_audio_analysis_get_waveform (LrgReelAudioAnalysis *self,
+                                      gint                  frame,
+                                      gdouble               seconds,
+                                      guint                 n_samples,
+                                      gsize                *out_count);
+
 /**
  * lrg_reel_audio_spectrum:
  * @wave: an #LrgWaveData
@@ -47,8 +175,8 @@ G_BEGIN_DECLS
  * @frame.
  *
  * The audio window of @window_size samples is extracted from @wave
- * (mono-mixed, Hann-windowed) and transformed with a radix-2
- * Cooley-Tukey FFT.  The magnitude of each bin k is:
+ * (mono-mixed, Hann-windowed) and transformed with a real-input
+ * radix-2 FFT whose twiddle tables are cached per size.  The magnitude of each bin k is:
  *
  *   magnitude[k] = sqrt(re[k]^2 + im[k]^2) * (2 / window_size)
  *
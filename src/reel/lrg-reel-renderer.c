@@ -472,9 +472,9 @@ reel_parallel_worker (gpointer data)
  * Renders every frame across @n_threads worker threads (each with its own
  * canvas/context), then feeds the frames to @exporter strictly in order — so
  * the output is identical to a sequential render.  Each frame is independent
- * and deterministic, which is what makes this safe.  (Clips that share mutable
- * state across threads — e.g. a video source's frame cache — are the exception
- * and should be rendered sequentially.)
+ * and deterministic, which is what makes this safe.  Clips with shared state
+ * must guard it themselves; video clips do, since #LrgReelVideoSource serves
+ * concurrent readers.
  *
  * Returns: %TRUE on success
  *
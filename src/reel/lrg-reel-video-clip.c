@@ -89,7 +89,7 @@ lrg_reel_video_clip_render (LrgReelClip    *clip,
 {
     LrgReelVideoClip   *self = LRG_REEL_VIDEO_CLIP (clip);
     g_autoptr(GError)   error = NULL;
-    GrlImage           *frame;
+    g_autoptr(GrlImage) frame = NULL;
     GrlRectangle        dst;
     gint                clip_frame;
     gint                fw;
@@ -121,7 +121,8 @@ lrg_reel_video_clip_render (LrgReelClip    *clip,
     if (self->loop)
         src_index = ((src_index % src_count) + src_count) % src_count;
 
-    frame = lrg_reel_video_source_get_frame (self->source, src_index, &error);
+    /* A reference, not get_frame(): parallel renders share the source. */
+    frame = lrg_reel_video_source_dup_frame (self->source, src_index, &error);
     if (frame == NULL)
         return;
 
@@ -10,6 +10,17 @@
 #include "../audio/lrg-wave-data.h"
 #include <gio/gio.h>
 #include <glib/gstdio.h>
+#include <raylib.h>
+#include <string.h>
+
+#define REEL_VIDEO_DEFAULT_QUEUE_DEPTH 3
+
+/* One encoded (PNG) or raw frame waiting to be written to ffmpeg. */
+typedef struct
+{
+    guint8 *data;
+    gsize   size;
+} ReelVideoPacket;
 
 struct _LrgReelVideoExporter
 {
@@ -21,12 +32,30 @@ struct _LrgReelVideoExporter
     gint               bitrate_kbps;  /* > 0 selects target bitrate over CRF */
     gchar             *ffmpeg_path;   /* override, or NULL to auto-discover */
     LrgWaveData       *audio;         /* optional, ref */
+    LrgReelVideoPipeFormat pipe_format;
+    guint              queue_depth;   /* 0 writes on the caller's thread */
 
     /* Active encode state (begin .. finish). */
     GSubprocess  *proc;
     GOutputStream *stdin_stream;      /* (transfer none), owned by proc */
     gchar        *temp_dir;           /* created when audio is muxed */
     gchar        *temp_audio_path;
+    gint          width;
+    gint          height;
+
+    /*
+     * Writer thread.  add_frame() queues packets and blocks only while
+     * queue_depth packets are pending; the writer drains them into the
+     * pipe so ffmpeg I/O overlaps rendering.  Everything below is guarded
+     * by lock.
+     */
+    GThread      *writer;
+    GMutex        lock;
+    GCond         cond;
+    GQueue        pending;            /* ReelVideoPacket *, oldest first */
+    GQueue        spare;              /* recycled raw-frame packets */
+    gboolean      closing;
+    GError       *write_error;        /* first pipe failure, if any */
 };
 
 G_DEFINE_FINAL_TYPE (LrgReelVideoExporter, lrg_reel_video_exporter, LRG_TYPE_REEL_EXPORTER)
@@ -66,13 +95,25 @@ reel_video_build_argv (LrgReelVideoExporter *self,
     g_ptr_array_add (args, g_strdup ("error"));
     g_ptr_array_add (args, g_strdup ("-nostats"));
 
-    /* Video input: a stream of PNG frames at the composition frame rate. */
+    /* Video input at the composition frame rate: either raw RGBA frames of
+     * a fixed size, or a stream of self-describing PNG frames. */
     g_ptr_array_add (args, g_strdup ("-framerate"));
     g_ptr_array_add (args, g_strdup_printf ("%.6g", fps));
     g_ptr_array_add (args, g_strdup ("-f"));
-    g_ptr_array_add (args, g_strdup ("image2pipe"));
-    g_ptr_array_add (args, g_strdup ("-vcodec"));
-    g_ptr_array_add (args, g_strdup ("png"));
+    if (self->pipe_format == LRG_REEL_VIDEO_PIPE_FORMAT_RAW)
+    {
+        g_ptr_array_add (args, g_strdup ("rawvideo"));
+        g_ptr_array_add (args, g_strdup ("-pixel_format"));
+        g_ptr_array_add (args, g_strdup ("rgba"));
+        g_ptr_array_add (args, g_strdup ("-video_size"));
+        g_ptr_array_add (args, g_strdup_printf ("%dx%d", self->width, self->height));
+    }
+    else
+    {
+        g_ptr_array_add (args, g_strdup ("image2pipe"));
+        g_ptr_array_add (args, g_strdup ("-vcodec"));
+        g_ptr_array_add (args, g_strdup ("png"));
+    }
     g_ptr_array_add (args, g_strdup ("-i"));
     g_ptr_array_add (args, g_strdup ("pipe:0"));
 
@@ -178,6 +219,163 @@ reel_video_build_argv (LrgReelVideoExporter *self,
     return (gchar **) g_ptr_array_free (args, FALSE);
 }
 
+static gsize
+reel_video_frame_size (LrgReelVideoExporter *self)
+{
+    return (gsize) self->width * (gsize) self->height * 4;
+}
+
+static void
+reel_video_packet_free (ReelVideoPacket *packet)
+{
+    g_free (packet->data);
+    g_free (packet);
+}
+
+/* Return a drained packet for reuse.  Only raw frames are recycled, since
+ * they all share one size; the spare list never grows past the queue. */
+static void
+reel_video_recycle_locked (LrgReelVideoExporter *self,
+                           ReelVideoPacket      *packet)
+{
+    if (self->pipe_format == LRG_REEL_VIDEO_PIPE_FORMAT_RAW &&
+        packet->size == reel_video_frame_size (self) &&
+        g_queue_get_length (&self->spare) <= self->queue_depth)
+    {
+        g_queue_push_tail (&self->spare, packet);
+        return;
+    }
+
+    reel_video_packet_free (packet);
+}
+
+static gboolean
+reel_video_write_packet (LrgReelVideoExporter *self,
+                         ReelVideoPacket      *packet,
+                         GError              **error)
+{
+    gsize   written = 0;
+    GError *local = NULL;
+
+    if (!g_output_stream_write_all (self->stdin_stream, packet->data, packet->size,
+                                    &written, NULL, &local))
+    {
+        g_set_error (error, LRG_REEL_EXPORTER_ERROR,
+                     LRG_REEL_EXPORTER_ERROR_WRITE,
+                     "failed to write frame to ffmpeg: %s",
+                     local != NULL ? local->message : "broken pipe");
+        g_clear_error (&local);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static gpointer
+reel_video_writer_thread (gpointer data)
+{
+    LrgReelVideoExporter *self = data;
+
+    g_mutex_lock (&self->lock);
+    for (;;)
+    {
+        ReelVideoPacket *packet;
+        GError          *local = NULL;
+        gboolean         failed;
+
+        while (g_queue_is_empty (&self->pending) && !self->closing)
+            g_cond_wait (&self->cond, &self->lock);
+
+        packet = g_queue_pop_head (&self->pending);
+        if (packet == NULL)
+            break;
+
+        /* A slot just opened up for a blocked producer. */
+        g_cond_broadcast (&self->cond);
+        failed = self->write_error != NULL;
+        g_mutex_unlock (&self->lock);
+
+        /* After a failure, keep draining so the producer never deadlocks. */
+        if (!failed)
+            reel_video_write_packet (self, packet, &local);
+
+        g_mutex_lock (&self->lock);
+        if (local != NULL)
+        {
+            if (self->write_error == NULL)
+                self->write_error = local;
+            else
+                g_error_free (local);
+            g_cond_broadcast (&self->cond);
+        }
+        reel_video_recycle_locked (self, packet);
+    }
+    g_mutex_unlock (&self->lock);
+
+    return NULL;
+}
+
+/* Drain the queue and join the writer.  Safe to call when none is running. */
+static void
+reel_video_stop_writer (LrgReelVideoExporter *self)
+{
+    if (self->writer == NULL)
+        return;
+
+    g_mutex_lock (&self->lock);
+    self->closing = TRUE;
+    g_cond_broadcast (&self->cond);
+    g_mutex_unlock (&self->lock);
+
+    g_thread_join (self->writer);
+    self->writer = NULL;
+    self->closing = FALSE;
+}
+
+/* Drop all queued and recycled packets and any stored writer error. */
+static void
+reel_video_clear_packets (LrgReelVideoExporter *self)
+{
+    g_queue_clear_full (&self->pending, (GDestroyNotify) reel_video_packet_free);
+    g_queue_clear_full (&self->spare, (GDestroyNotify) reel_video_packet_free);
+    g_clear_error (&self->write_error);
+}
+
+/* Copy @frame's pixels as tightly packed RGBA8 into @dst, which holds
+ * exactly one frame of the size given to begin(). */
+static gboolean
+reel_video_copy_raw (LrgReelVideoExporter *self,
+                     GrlImage             *frame,
+                     guint8               *dst,
+                     GError              **error)
+{
+    g_autoptr(GrlImage) converted = NULL;
+    Image              *img;
+
+    if (grl_image_get_width (frame) != self->width ||
+        grl_image_get_height (frame) != self->height)
+    {
+        g_set_error (error, LRG_REEL_EXPORTER_ERROR,
+                     LRG_REEL_EXPORTER_ERROR_WRITE,
+                     "frame is %dx%d but the stream was opened at %dx%d",
+                     grl_image_get_width (frame), grl_image_get_height (frame),
+                     self->width, self->height);
+        return FALSE;
+    }
+
+    if (grl_image_get_format (frame) != GRL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        converted = grl_image_copy (frame);
+        grl_image_set_format (converted, GRL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        frame = converted;
+    }
+
+    img = (Image *) grl_image_get_handle (frame);
+    memcpy (dst, img->data, reel_video_frame_size (self));
+
+    return TRUE;
+}
+
 static gboolean
 lrg_reel_video_exporter_real_begin (LrgReelExporter *base,
                                     gint             width,
@@ -218,6 +416,8 @@ lrg_reel_video_exporter_real_begin (LrgReelExporter *base,
         }
     }
 
+    self->width = width;
+    self->height = height;
     argv = reel_video_build_argv (self, ffmpeg, fps);
 
     launcher = g_subprocess_launcher_new (G_SUBPROCESS_FLAGS_STDIN_PIPE);
@@ -238,9 +438,8 @@ lrg_reel_video_exporter_real_begin (LrgReelExporter *base,
 
     self->stdin_stream = g_subprocess_get_stdin_pipe (self->proc);
 
-    /* width/height are implied by the PNG frames themselves. */
-    (void) width;
-    (void) height;
+    if (self->queue_depth > 0)
+        self->writer = g_thread_new ("reel-video-writer", reel_video_writer_thread, self);
 
     return TRUE;
 }
@@ -251,11 +450,7 @@ lrg_reel_video_exporter_real_add_frame (LrgReelExporter *base,
                                         GError         **error)
 {
     LrgReelVideoExporter *self = LRG_REEL_VIDEO_EXPORTER (base);
-    guint8               *png = NULL;
-    gsize                 size = 0;
-    gsize                 written = 0;
-    GError               *local = NULL;
-    gboolean              ok;
+    ReelVideoPacket      *packet = NULL;
 
     if (self->stdin_stream == NULL)
     {
@@ -265,30 +460,70 @@ lrg_reel_video_exporter_real_add_frame (LrgReelExporter *base,
         return FALSE;
     }
 
-    png = grl_image_export_to_memory (frame, ".png", &size);
-    if (png == NULL || size == 0)
+    if (self->pipe_format == LRG_REEL_VIDEO_PIPE_FORMAT_RAW)
     {
-        g_free (png);
-        g_set_error_literal (error, LRG_REEL_EXPORTER_ERROR,
-                             LRG_REEL_EXPORTER_ERROR_WRITE,
-                             "failed to encode frame to PNG");
-        return FALSE;
+        /* The renderer reuses its frame image, so the pixels are copied
+         * into a (recycled) packet before the writer sees them. */
+        g_mutex_lock (&self->lock);
+        packet = g_queue_pop_head (&self->spare);
+        g_mutex_unlock (&self->lock);
+
+        if (packet == NULL)
+        {
+            packet = g_new0 (ReelVideoPacket, 1);
+            packet->size = reel_video_frame_size (self);
+            packet->data = g_malloc (packet->size);
+        }
+
+        if (!reel_video_copy_raw (self, frame, packet->data, error))
+        {
+            reel_video_packet_free (packet);
+            return FALSE;
+        }
+    }
+    else
+    {
+        packet = g_new0 (ReelVideoPacket, 1);
+        packet->data = grl_image_export_to_memory (frame, ".png", &packet->size);
+        if (packet->data == NULL || packet->size == 0)
+        {
+            reel_video_packet_free (packet);
+            g_set_error_literal (error, LRG_REEL_EXPORTER_ERROR,
+                                 LRG_REEL_EXPORTER_ERROR_WRITE,
+                                 "failed to encode frame to PNG");
+            return FALSE;
+        }
+    }
+
+    if (self->writer == NULL)
+    {
+        gboolean ok = reel_video_write_packet (self, packet, error);
+
+        g_mutex_lock (&self->lock);
+        reel_video_recycle_locked (self, packet);
+        g_mutex_unlock (&self->lock);
+
+        return ok;
     }
 
-    ok = g_output_stream_write_all (self->stdin_stream, png, size,
-                                    &written, NULL, &local);
-    g_free (png);
+    g_mutex_lock (&self->lock);
+    while (g_queue_get_length (&self->pending) >= self->queue_depth &&
+           self->write_error == NULL)
+        g_cond_wait (&self->cond, &self->lock);
 
-    if (!ok)
+    if (self->write_error != NULL)
     {
-        g_set_error (error, LRG_REEL_EXPORTER_ERROR,
-                     LRG_REEL_EXPORTER_ERROR_WRITE,
-                     "failed to write frame to ffmpeg: %s",
-                     local != NULL ? local->message : "broken pipe");
-        g_clear_error (&local);
+        g_mutex_unlock (&self->lock);
+        reel_video_packet_free (packet);
+        g_set_error_literal (error, self->write_error->domain,
+                             self->write_error->code, self->write_error->message);
         return FALSE;
     }
 
+    g_queue_push_tail (&self->pending, packet);
+    g_cond_broadcast (&self->cond);
+    g_mutex_unlock (&self->lock);
+
     return TRUE;
 }
 
@@ -324,6 +559,9 @@ lrg_reel_video_exporter_real_finish (LrgReelExporter *base,
         return FALSE;
     }
 
+    /* Let the writer drain every queued frame before the pipe closes. */
+    reel_video_stop_writer (self);
+
     /* Closing stdin signals EOF so ffmpeg flushes and exits. */
     if (self->stdin_stream != NULL)
     {
@@ -331,7 +569,13 @@ lrg_reel_video_exporter_real_finish (LrgReelExporter *base,
         self->stdin_stream = NULL;
     }
 
-    if (!g_subprocess_wait_check (self->proc, NULL, &local))
+    if (self->write_error != NULL)
+    {
+        g_subprocess_wait (self->proc, NULL, NULL);
+        g_propagate_error (error, g_steal_pointer (&self->write_error));
+        ok = FALSE;
+    }
+    else if (!g_subprocess_wait_check (self->proc, NULL, &local))
     {
         g_set_error (error, LRG_REEL_EXPORTER_ERROR,
                      LRG_REEL_EXPORTER_ERROR_SPAWN,
@@ -342,6 +586,7 @@ lrg_reel_video_exporter_real_finish (LrgReelExporter *base,
     }
 
     g_clear_object (&self->proc);
+    reel_video_clear_packets (self);
     reel_video_cleanup_temp (self);
 
     return ok;
@@ -352,6 +597,11 @@ lrg_reel_video_exporter_finalize (GObject *object)
 {
     LrgReelVideoExporter *self = LRG_REEL_VIDEO_EXPORTER (object);
 
+    reel_video_stop_writer (self);
+    reel_video_clear_packets (self);
+    g_mutex_clear (&self->lock);
+    g_cond_clear (&self->cond);
+
     if (self->stdin_stream != NULL)
     {
         g_output_stream_close (self->stdin_stream, NULL, NULL);
@@ -384,6 +634,13 @@ static void
 lrg_reel_video_exporter_init (LrgReelVideoExporter *self)
 {
     self->crf = 23;
+    self->pipe_format = LRG_REEL_VIDEO_PIPE_FORMAT_RAW;
+    self->queue_depth = REEL_VIDEO_DEFAULT_QUEUE_DEPTH;
+
+    g_mutex_init (&self->lock);
+    g_cond_init (&self->cond);
+    g_queue_init (&self->pending);
+    g_queue_init (&self->spare);
 }
 
 LrgReelVideoExporter *
@@ -439,6 +696,42 @@ lrg_reel_video_exporter_set_bitrate (LrgReelVideoExporter *self,
     self->bitrate_kbps = kbps;
 }
 
+void
+lrg_reel_video_exporter_set_pipe_format (LrgReelVideoExporter   *self,
+                                         LrgReelVideoPipeFormat  format)
+{
+    g_return_if_fail (LRG_IS_REEL_VIDEO_EXPORTER (self));
+    g_return_if_fail (self->proc == NULL);
+
+    self->pipe_format = format;
+}
+
+LrgReelVideoPipeFormat
+lrg_reel_video_exporter_get_pipe_format (LrgReelVideoExporter *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_VIDEO_EXPORTER (self), LRG_REEL_VIDEO_PIPE_FORMAT_RAW);
+
+    return self->pipe_format;
+}
+
+void
+lrg_reel_video_exporter_set_queue_depth (LrgReelVideoExporter *self,
+                                         guint                 depth)
+{
+    g_return_if_fail (LRG_IS_REEL_VIDEO_EXPORTER (self));
+    g_return_if_fail (self->proc == NULL);
+
+    self->queue_depth = depth;
+}
+
+guint
+lrg_reel_video_exporter_get_queue_depth (LrgReelVideoExporter *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_VIDEO_EXPORTER (self), 0);
+
+    return self->queue_depth;
+}
+
 void
 lrg_reel_video_exporter_set_ffmpeg_path (LrgReelVideoExporter *self,
                                          const gchar          *path)
@@ -6,9 +6,11 @@
  *
  * LrgReelVideoExporter - MP4/WebM output via an ffmpeg subprocess.
  *
- * Streams rendered frames (as a PNG image sequence) to ffmpeg's stdin and,
- * optionally, muxes a pre-mixed audio track in.  ffmpeg is discovered at
- * runtime; if it is not installed, begin() fails gracefully with
+ * Streams rendered frames (raw RGBA by default, or a PNG image sequence) to
+ * ffmpeg's stdin and, optionally, muxes a pre-mixed audio track in.  Pipe
+ * writes happen on a dedicated writer thread behind a small bounded queue,
+ * so they overlap with rendering.  ffmpeg is discovered at runtime; if it is
+ * not installed, begin() fails gracefully with
  * %LRG_REEL_EXPORTER_ERROR_FFMPEG_NOT_FOUND.
  */
 
@@ -83,6 +85,63 @@ void
 lrg_reel_video_exporter_set_bitrate (LrgReelVideoExporter *self,
                                      gint                  kbps);
 
+/**
+ * lrg_reel_video_exporter_set_pipe_format:
+ * @self: a #LrgReelVideoExporter
+ * @format: how frames are handed to ffmpeg.
+ *
+ * Selects raw RGBA frames (the default) or PNG-encoded frames.  Raw frames
+ * skip the per-frame PNG encode, which otherwise dominates export time at
+ * high resolutions.  Must be set before begin().
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_reel_video_exporter_set_pipe_format (LrgReelVideoExporter   *self,
+                                         LrgReelVideoPipeFormat  format);
+
+/**
+ * lrg_reel_video_exporter_get_pipe_format:
+ * @self: a #LrgReelVideoExporter
+ *
+ * Returns: the pipe format used for frames
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgReelVideoPipeFormat
+lrg_reel_video_exporter_get_pipe_format (LrgReelVideoExporter *self);
+
+/**
+ * lrg_reel_video_exporter_set_queue_depth:
+ * @self: a #LrgReelVideoExporter
+ * @depth: frames that may wait for the writer thread, or 0 to write on the
+ *   caller's thread.
+ *
+ * Bounds how far rendering may run ahead of the ffmpeg pipe.  Each queued
+ * raw frame holds width * height * 4 bytes.  The default is 3.  Must be set
+ * before begin().
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_reel_video_exporter_set_queue_depth (LrgReelVideoExporter *self,
+                                         guint                 depth);
+
+/**
+ * lrg_reel_video_exporter_get_queue_depth:
+ * @self: a #LrgReelVideoExporter
+ *
+ * Returns: the writer queue depth, 0 when writes are synchronous
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_reel_video_exporter_get_queue_depth (LrgReelVideoExporter *self);
+
 /**
  * lrg_reel_video_exporter_set_ffmpeg_path:
  * @self: a #LrgReelVideoExporter
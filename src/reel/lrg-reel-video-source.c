@@ -10,13 +10,19 @@
 #include "../audio/lrg-wave-data.h"
 #include <gio/gio.h>
 #include <glib/gstdio.h>
+#include <raylib.h>
 #include <string.h>
 
+#define REEL_VIDEO_DEFAULT_WINDOW     12
+#define REEL_VIDEO_DEFAULT_READ_AHEAD 4
+
+/* One decoded frame held in the window. */
 typedef struct
 {
-    gsize offset;  /* into png_data */
-    gsize length;
-} ReelFrameEntry;
+    GrlImage *image;
+    guint64   stamp;   /* last use, for LRU eviction */
+    gboolean  served;  /* handed to a reader at least once */
+} ReelVideoSlot;
 
 struct _LrgReelVideoSource
 {
@@ -29,27 +35,87 @@ struct _LrgReelVideoSource
     gdouble  duration;
     gboolean has_audio;
 
-    gboolean   decoded;
-    GBytes    *png_data;       /* concatenated PNG frames */
-    GArray    *frame_index;    /* of ReelFrameEntry */
-
-    GrlImage *current_frame;
-    gint      current_index;
+    /* Packet index from ffprobe, built on first frame access. */
+    gboolean  indexed;
+    gint      frame_count;
+    GArray   *keyframes;         /* of gint frame indices, ascending */
+
+    /*
+     * Frame window.  Readers and the decoder thread meet under lock; the
+     * decoder thread alone owns the ffmpeg process and reads its pipe with
+     * the lock released, so cache hits never wait on decoding.
+     */
+    GMutex      lock;
+    GCond       cond;
+    GHashTable *window;          /* frame index -> ReelVideoSlot */
+    GHashTable *waiters;         /* frame index -> number of blocked readers */
+    guint64     clock;
+    guint       window_size;
+    guint       read_ahead;
+    gint        last_request;
+    GThread    *decoder;
+    gboolean    shutdown;
+    GSubprocess  *proc;
+    GInputStream *stdout_stream; /* (transfer none), owned by proc */
+    gint          next_index;    /* frame the pipe produces next */
+    gboolean      eof;
+    GError       *decode_error;  /* sticky; set when ffmpeg cannot run */
+
+    GrlImage *current_frame;     /* keeps get_frame()'s result alive */
 };
 
 G_DEFINE_FINAL_TYPE (LrgReelVideoSource, lrg_reel_video_source, G_TYPE_OBJECT)
 
 #define LRG_REEL_VIDEO_SOURCE_ERROR (g_quark_from_static_string ("lrg-reel-video-source"))
 
+static void
+reel_video_slot_free (gpointer data)
+{
+    ReelVideoSlot *slot = data;
+
+    g_clear_object (&slot->image);
+    g_free (slot);
+}
+
+/* Kill a decode process that has already been detached from the source. */
+static void
+reel_video_kill (GSubprocess *proc)
+{
+    if (proc == NULL)
+        return;
+
+    g_subprocess_force_exit (proc);
+    g_subprocess_wait (proc, NULL, NULL);
+    g_object_unref (proc);
+}
+
 static void
 lrg_reel_video_source_finalize (GObject *object)
 {
     LrgReelVideoSource *self = LRG_REEL_VIDEO_SOURCE (object);
 
+    /* Stop the decoder; killing ffmpeg unblocks a pending pipe read. */
+    if (self->decoder != NULL)
+    {
+        g_mutex_lock (&self->lock);
+        self->shutdown = TRUE;
+        if (self->proc != NULL)
+            g_subprocess_force_exit (self->proc);
+        g_cond_broadcast (&self->cond);
+        g_mutex_unlock (&self->lock);
+
+        g_thread_join (self->decoder);
+        self->decoder = NULL;
+    }
+
     g_clear_object (&self->current_frame);
-    g_clear_pointer (&self->png_data, g_bytes_unref);
-    g_clear_pointer (&self->frame_index, g_array_unref);
+    g_clear_pointer (&self->window, g_hash_table_unref);
+    g_clear_pointer (&self->waiters, g_hash_table_unref);
+    g_clear_pointer (&self->keyframes, g_array_unref);
+    g_clear_error (&self->decode_error);
     g_clear_pointer (&self->path, g_free);
+    g_mutex_clear (&self->lock);
+    g_cond_clear (&self->cond);
 
     G_OBJECT_CLASS (lrg_reel_video_source_parent_class)->finalize (object);
 }
@@ -66,8 +132,14 @@ static void
 lrg_reel_video_source_init (LrgReelVideoSource *self)
 {
     self->fps = 30.0;
-    self->current_index = -1;
-    self->frame_index = g_array_new (FALSE, FALSE, sizeof (ReelFrameEntry));
+    self->keyframes = g_array_new (FALSE, FALSE, sizeof (gint));
+    self->window = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                          NULL, reel_video_slot_free);
+    self->waiters = g_hash_table_new (g_direct_hash, g_direct_equal);
+    self->window_size = REEL_VIDEO_DEFAULT_WINDOW;
+    self->read_ahead = REEL_VIDEO_DEFAULT_READ_AHEAD;
+    g_mutex_init (&self->lock);
+    g_cond_init (&self->cond);
 }
 
 gboolean
@@ -220,68 +292,190 @@ reel_video_probe (LrgReelVideoSource *self,
     return TRUE;
 }
 
-/* Walk the concatenated-PNG buffer, recording one entry per frame. */
+static gint
+reel_video_compare_int (gconstpointer a,
+                        gconstpointer b)
+{
+    gint x = *(const gint *) a;
+    gint y = *(const gint *) b;
+
+    return (x > y) - (x < y);
+}
+
 static void
-reel_video_build_index (LrgReelVideoSource *self)
+reel_video_waiter_add (LrgReelVideoSource *self,
+                       gint                index)
 {
-    const guint8 *data;
-    gsize         size = 0;
-    gsize         pos = 0;
-    static const guint8 sig[8] = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+    gpointer key = GINT_TO_POINTER (index);
+    guint    n = GPOINTER_TO_UINT (g_hash_table_lookup (self->waiters, key));
 
-    data = g_bytes_get_data (self->png_data, &size);
+    g_hash_table_insert (self->waiters, key, GUINT_TO_POINTER (n + 1));
+}
 
-    while (pos + 8 <= size)
+static void
+reel_video_waiter_remove (LrgReelVideoSource *self,
+                          gint                index)
+{
+    gpointer key = GINT_TO_POINTER (index);
+    guint    n = GPOINTER_TO_UINT (g_hash_table_lookup (self->waiters, key));
+
+    if (n <= 1)
+        g_hash_table_remove (self->waiters, key);
+    else
+        g_hash_table_insert (self->waiters, key, GUINT_TO_POINTER (n - 1));
+}
+
+/*
+ * Count frames and locate keyframes from the packet list.  This only demuxes,
+ * so it stays cheap for long clips.  Packets arrive in decode order; each
+ * video packet is one frame and keyframe times map to frame indices.
+ */
+static gboolean
+reel_video_build_index (LrgReelVideoSource *self,
+                        GError            **error)
+{
+    g_autofree gchar *ffprobe = g_find_program_in_path ("ffprobe");
+    g_autoptr(GBytes) out = NULL;
+    g_autofree gchar *text = NULL;
+    g_auto(GStrv) lines = NULL;
+    g_autoptr(GArray) key_times = NULL;
+    const gchar *argv[12];
+    gdouble first_pts = G_MAXDOUBLE;
+    gsize len = 0;
+    gint count = 0;
+    guint i;
+
+    if (ffprobe == NULL)
     {
-        gsize    start = pos;
-        gboolean iend = FALSE;
+        g_set_error_literal (error, LRG_REEL_VIDEO_SOURCE_ERROR, 1,
+                             "ffprobe was not found on the PATH");
+        return FALSE;
+    }
 
-        if (memcmp (data + pos, sig, 8) != 0)
-            break;
-        pos += 8;
+    argv[0] = ffprobe;
+    argv[1] = "-v";          argv[2] = "error";
+    argv[3] = "-select_streams"; argv[4] = "v:0";
+    argv[5] = "-show_entries"; argv[6] = "packet=pts_time,flags";
+    argv[7] = "-of";         argv[8] = "csv=p=0";
+    argv[9] = self->path;
+    argv[10] = NULL;
 
-        while (pos + 8 <= size && !iend)
-        {
-            guint32  clen = ((guint32) data[pos] << 24) |
-                            ((guint32) data[pos + 1] << 16) |
-                            ((guint32) data[pos + 2] << 8) |
-                            (guint32) data[pos + 3];
-            gboolean is_iend = (data[pos + 4] == 'I' && data[pos + 5] == 'E' &&
-                                data[pos + 6] == 'N' && data[pos + 7] == 'D');
-
-            pos += 8 + (gsize) clen + 4; /* len+type, data, crc */
-            if (is_iend)
-                iend = TRUE;
-        }
+    out = reel_video_run_capture ((const gchar * const *) argv, error);
+    if (out == NULL)
+        return FALSE;
 
-        if (iend && pos <= size)
-        {
-            ReelFrameEntry e;
+    {
+        const gchar *data = g_bytes_get_data (out, &len);
+        text = g_strndup (data, len);
+    }
 
-            e.offset = start;
-            e.length = pos - start;
-            g_array_append_val (self->frame_index, e);
-        }
-        else
-        {
+    key_times = g_array_new (FALSE, FALSE, sizeof (gdouble));
+    lines = g_strsplit (text, "\n", -1);
+    for (i = 0; lines[i] != NULL; i++)
+    {
+        gchar  *comma = strchr (lines[i], ',');
+        gchar  *end = NULL;
+        gdouble pts;
+
+        if (comma == NULL)
+            continue;
+
+        count++;
+        pts = g_ascii_strtod (lines[i], &end);
+        if (end == lines[i])
+            continue;
+
+        if (pts < first_pts)
+            first_pts = pts;
+        if (strchr (comma + 1, 'K') != NULL)
+            g_array_append_val (key_times, pts);
+    }
+
+    self->frame_count = count;
+    g_array_set_size (self->keyframes, 0);
+    for (i = 0; i < key_times->len; i++)
+    {
+        gdouble t = g_array_index (key_times, gdouble, i) - first_pts;
+        gint    index = (gint) (t * self->fps + 0.5);
+
+        g_array_append_val (self->keyframes, index);
+    }
+    g_array_sort (self->keyframes, (GCompareFunc) reel_video_compare_int);
+
+    return TRUE;
+}
+
+/* Last keyframe at or before @index, or -1 when unknown. */
+static gint
+reel_video_keyframe_before (LrgReelVideoSource *self,
+                            gint                index)
+{
+    gint found = -1;
+    guint i;
+
+    for (i = 0; i < self->keyframes->len; i++)
+    {
+        gint k = g_array_index (self->keyframes, gint, i);
+
+        if (k > index)
             break;
-        }
+        found = k;
     }
+
+    return found;
 }
 
+static guint
+reel_video_capacity (LrgReelVideoSource *self)
+{
+    /* Read-ahead must never evict the frame it was fetched for. */
+    return MAX (self->window_size, self->read_ahead + 2);
+}
+
+/* Decide whether reaching @want means restarting ffmpeg rather than reading
+ * on.  A restart only pays off when the target is behind the pipe, or far
+ * enough ahead that a later keyframe lets ffmpeg skip the frames between. */
 static gboolean
-reel_video_ensure_decoded (LrgReelVideoSource *self,
-                           GError            **error)
+reel_video_should_restart (LrgReelVideoSource *self,
+                           gint                want)
 {
-    g_autofree gchar *ffmpeg = NULL;
-    const gchar *argv[14];
+    gint key;
 
-    if (self->decoded)
-        return self->png_data != NULL;
+    if (self->proc == NULL || self->eof || want < self->next_index)
+        return TRUE;
 
-    self->decoded = TRUE;
+    if ((guint) (want - self->next_index) <= reel_video_capacity (self))
+        return FALSE;
+
+    key = reel_video_keyframe_before (self, want);
+    return key < 0 || key > self->next_index;
+}
+
+/* First frame a restart for @want should emit.  ffmpeg decodes from the
+ * keyframe at or before it either way; emitting from that keyframe (or half
+ * a window back) leaves nearby frames cached for backward scrubbing. */
+static gint
+reel_video_restart_index (LrgReelVideoSource *self,
+                          gint                want)
+{
+    gint back = want - (gint) (reel_video_capacity (self) / 2);
+    gint key = reel_video_keyframe_before (self, want);
+
+    return MAX (MAX (key, back), 0);
+}
+
+static gboolean
+reel_video_spawn (LrgReelVideoSource  *self,
+                  gint                 start,
+                  GSubprocess        **out_proc,
+                  GError             **error)
+{
+    g_autofree gchar *ffmpeg = g_find_program_in_path ("ffmpeg");
+    g_autofree gchar *seek = NULL;
+    g_autoptr(GSubprocessLauncher) launcher = NULL;
+    const gchar *argv[24];
+    gint n = 0;
 
-    ffmpeg = g_find_program_in_path ("ffmpeg");
     if (ffmpeg == NULL)
     {
         g_set_error_literal (error, LRG_REEL_VIDEO_SOURCE_ERROR, 1,
@@ -289,30 +483,318 @@ reel_video_ensure_decoded (LrgReelVideoSource *self,
         return FALSE;
     }
 
-    argv[0] = ffmpeg;
-    argv[1] = "-v";       argv[2] = "error";
-    argv[3] = "-i";       argv[4] = self->path;
-    argv[5] = "-f";       argv[6] = "image2pipe";
-    argv[7] = "-vcodec";  argv[8] = "png";
-    argv[9] = "-";
-    argv[10] = NULL;
+    argv[n++] = ffmpeg;
+    argv[n++] = "-v";       argv[n++] = "error";
+    if (start > 0)
+    {
+        gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
 
-    self->png_data = reel_video_run_capture ((const gchar * const *) argv, error);
-    if (self->png_data == NULL)
-        return FALSE;
+        /* Half a frame early, so rounding never skips the start frame. */
+        seek = g_strdup (g_ascii_dtostr (buf, sizeof buf, (start - 0.5) / self->fps));
+        argv[n++] = "-ss";  argv[n++] = seek;
+    }
+    argv[n++] = "-i";       argv[n++] = self->path;
+    argv[n++] = "-map";     argv[n++] = "0:v:0";
+    argv[n++] = "-fps_mode"; argv[n++] = "passthrough";
+    argv[n++] = "-f";       argv[n++] = "rawvideo";
+    argv[n++] = "-pix_fmt"; argv[n++] = "rgba";
+    argv[n++] = "-";
+    argv[n] = NULL;
 
-    reel_video_build_index (self);
+    launcher = g_subprocess_launcher_new (G_SUBPROCESS_FLAGS_STDOUT_PIPE |
+                                          G_SUBPROCESS_FLAGS_STDERR_SILENCE);
+    *out_proc = g_subprocess_launcher_spawnv (launcher, (const gchar * const *) argv, error);
 
-    if (self->frame_index->len == 0)
+    return *out_proc != NULL;
+}
+
+/*
+ * Evict least recently used frames nobody is waiting for, taking frames a
+ * reader already had before ones still unread.  Parallel renders request
+ * interleaved frames from several threads; keeping unread frames lets a
+ * lagging thread find its frame instead of forcing a backward restart.
+ */
+static void
+reel_video_trim_locked (LrgReelVideoSource *self)
+{
+    guint capacity = reel_video_capacity (self);
+
+    while (g_hash_table_size (self->window) > capacity)
     {
-        g_set_error_literal (error, LRG_REEL_VIDEO_SOURCE_ERROR, 3,
+        GHashTableIter iter;
+        gpointer       key;
+        gpointer       value;
+        gpointer       victim = NULL;
+        guint64        oldest = G_MAXUINT64;
+        gboolean       victim_served = FALSE;
+        gboolean       found = FALSE;
+
+        g_hash_table_iter_init (&iter, self->window);
+        while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+            ReelVideoSlot *slot = value;
+            gboolean       better;
+
+            if (g_hash_table_contains (self->waiters, key))
+                continue;
+
+            if (slot->served != victim_served)
+                better = slot->served;
+            else
+                better = slot->stamp < oldest;
+
+            if (!found || better)
+            {
+                oldest = slot->stamp;
+                victim_served = slot->served;
+                victim = key;
+                found = TRUE;
+            }
+        }
+
+        if (!found)
+            break;
+        g_hash_table_remove (self->window, victim);
+    }
+}
+
+/* Lowest frame a reader is blocked on that is not decoded yet, or -1. */
+static gint
+reel_video_wanted_locked (LrgReelVideoSource *self)
+{
+    GHashTableIter iter;
+    gpointer       key;
+    gint           want = -1;
+
+    g_hash_table_iter_init (&iter, self->waiters);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+        gint index = GPOINTER_TO_INT (key);
+
+        if (!g_hash_table_contains (self->window, key) && (want < 0 || index < want))
+            want = index;
+    }
+
+    return want;
+}
+
+/*
+ * Decoder thread.  Serves the lowest frame a reader waits on, restarting
+ * ffmpeg when that is cheaper than reading on, and otherwise reads ahead up
+ * to read_ahead frames past the latest request.  Each frame is read straight
+ * into a fresh image with the lock released.
+ */
+static gpointer
+reel_video_decoder_thread (gpointer data)
+{
+    LrgReelVideoSource *self = data;
+    gsize               frame_size = (gsize) self->width * (gsize) self->height * 4;
+    GrlColor            clear = { 0, 0, 0, 0 };
+
+    g_mutex_lock (&self->lock);
+    while (!self->shutdown)
+    {
+        gint          want = reel_video_wanted_locked (self);
+        GInputStream *stream;
+        GrlImage     *image;
+        Image        *raw;
+        gsize         got = 0;
+        gint          index;
+        gboolean      ok;
+
+        if (want < 0)
+        {
+            gboolean prefetch = self->proc != NULL && !self->eof &&
+                                self->next_index < self->frame_count &&
+                                self->next_index <= self->last_request + (gint) self->read_ahead &&
+                                !g_hash_table_contains (self->window,
+                                                        GINT_TO_POINTER (self->next_index));
+
+            if (!prefetch)
+            {
+                g_cond_wait (&self->cond, &self->lock);
+                continue;
+            }
+        }
+        else if (self->decode_error != NULL)
+        {
+            g_cond_wait (&self->cond, &self->lock);
+            continue;
+        }
+        else if (reel_video_should_restart (self, want))
+        {
+            GSubprocess *old = g_steal_pointer (&self->proc);
+            GSubprocess *proc = NULL;
+            GError      *local = NULL;
+            gint         start = reel_video_restart_index (self, want);
+
+            self->stdout_stream = NULL;
+            g_mutex_unlock (&self->lock);
+            reel_video_kill (old);
+            ok = reel_video_spawn (self, start, &proc, &local);
+            g_mutex_lock (&self->lock);
+
+            if (!ok)
+            {
+                self->decode_error = local;
+                self->eof = TRUE;
+                g_cond_broadcast (&self->cond);
+                continue;
+            }
+
+            self->proc = proc;
+            self->stdout_stream = g_subprocess_get_stdout_pipe (proc);
+            self->next_index = start;
+            self->eof = FALSE;
+
+            if (self->shutdown)
+                break;
+        }
+
+        stream = self->stdout_stream;
+        index = self->next_index;
+        g_mutex_unlock (&self->lock);
+
+        image = grl_image_new_color (self->width, self->height, &clear);
+        raw = (Image *) grl_image_get_handle (image);
+        ok = g_input_stream_read_all (stream, raw->data, frame_size, &got, NULL, NULL) &&
+             got == frame_size;
+
+        g_mutex_lock (&self->lock);
+        if (!ok)
+        {
+            /* End of stream.  The packet count can overstate what decodes,
+             * so a short stream shortens the clip rather than failing it. */
+            g_object_unref (image);
+            self->eof = TRUE;
+            if (index > 0 && index < self->frame_count)
+                self->frame_count = index;
+            else if (index == 0 && self->decode_error == NULL)
+                g_set_error (&self->decode_error, LRG_REEL_VIDEO_SOURCE_ERROR, 3,
                              "ffmpeg produced no frames");
+            g_cond_broadcast (&self->cond);
+            continue;
+        }
+
+        {
+            ReelVideoSlot *slot = g_new0 (ReelVideoSlot, 1);
+
+            slot->image = image;
+            slot->stamp = ++self->clock;
+            g_hash_table_replace (self->window, GINT_TO_POINTER (index), slot);
+        }
+        self->next_index = index + 1;
+        reel_video_trim_locked (self);
+        g_cond_broadcast (&self->cond);
+    }
+    {
+        GSubprocess *old = g_steal_pointer (&self->proc);
+
+        self->stdout_stream = NULL;
+        g_mutex_unlock (&self->lock);
+        reel_video_kill (old);
+    }
+
+    return NULL;
+}
+
+static gboolean
+reel_video_ensure_index_locked (LrgReelVideoSource *self,
+                                GError            **error)
+{
+    if (!self->indexed)
+    {
+        GError *local = NULL;
+
+        self->indexed = TRUE;
+        if (!reel_video_build_index (self, &local))
+            self->decode_error = local;
+        else if (self->frame_count == 0)
+            g_set_error_literal (&self->decode_error, LRG_REEL_VIDEO_SOURCE_ERROR, 3,
+                                 "video has no frames");
+    }
+
+    if (self->decode_error != NULL && self->frame_count == 0)
+    {
+        g_propagate_error (error, g_error_copy (self->decode_error));
         return FALSE;
     }
 
     return TRUE;
 }
 
+/* Fetch frame @index from the window, blocking until the decoder has it. */
+static GrlImage *
+reel_video_fetch (LrgReelVideoSource *self,
+                  gint                index,
+                  GError            **error)
+{
+    GrlImage *image = NULL;
+    gboolean  waiting = FALSE;
+    gint      asked = -1;
+
+    g_mutex_lock (&self->lock);
+
+    if (!reel_video_ensure_index_locked (self, error))
+    {
+        g_mutex_unlock (&self->lock);
+        return NULL;
+    }
+
+    if (self->decoder == NULL)
+        self->decoder = g_thread_new ("reel-video-decode", reel_video_decoder_thread, self);
+
+    for (;;)
+    {
+        ReelVideoSlot *slot;
+        gint           clamped = CLAMP (index, 0, self->frame_count - 1);
+
+        /* The clip can shrink while we wait; follow the clamped index. */
+        if (clamped != asked)
+        {
+            if (waiting)
+                reel_video_waiter_remove (self, asked);
+            asked = clamped;
+            waiting = FALSE;
+        }
+
+        slot = g_hash_table_lookup (self->window, GINT_TO_POINTER (asked));
+        if (slot != NULL)
+        {
+            slot->stamp = ++self->clock;
+            slot->served = TRUE;
+            image = g_object_ref (slot->image);
+            break;
+        }
+
+        if (self->decode_error != NULL)
+        {
+            g_propagate_error (error, g_error_copy (self->decode_error));
+            break;
+        }
+
+        if (!waiting)
+        {
+            reel_video_waiter_add (self, asked);
+            waiting = TRUE;
+            self->last_request = asked;
+            g_cond_broadcast (&self->cond);
+        }
+        g_cond_wait (&self->cond, &self->lock);
+    }
+
+    if (waiting)
+        reel_video_waiter_remove (self, asked);
+    else if (image != NULL)
+        self->last_request = asked;
+
+    /* A reader just moved on; let the decoder read ahead of it. */
+    g_cond_broadcast (&self->cond);
+    g_mutex_unlock (&self->lock);
+
+    return image;
+}
+
 LrgReelVideoSource *
 lrg_reel_video_source_new_from_file (const gchar  *path,
                                      GError      **error)
@@ -371,53 +853,89 @@ lrg_reel_video_source_get_has_audio (LrgReelVideoSource *self)
 gint
 lrg_reel_video_source_get_frame_count (LrgReelVideoSource *self)
 {
+    gint count;
+
     g_return_val_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self), 0);
 
-    if (!reel_video_ensure_decoded (self, NULL))
-        return 0;
+    g_mutex_lock (&self->lock);
+    count = reel_video_ensure_index_locked (self, NULL) ? self->frame_count : 0;
+    g_mutex_unlock (&self->lock);
 
-    return (gint) self->frame_index->len;
+    return count;
 }
 
 GrlImage *
-lrg_reel_video_source_get_frame (LrgReelVideoSource *self,
+lrg_reel_video_source_dup_frame (LrgReelVideoSource *self,
                                  gint                index,
                                  GError            **error)
 {
-    ReelFrameEntry e;
-    const guint8  *data;
-    GrlImage      *img;
-
     g_return_val_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self), NULL);
+    g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-    if (!reel_video_ensure_decoded (self, error))
-        return NULL;
+    return reel_video_fetch (self, index, error);
+}
 
-    if (index < 0)
-        index = 0;
-    if (index >= (gint) self->frame_index->len)
-        index = (gint) self->frame_index->len - 1;
+GrlImage *
+lrg_reel_video_source_get_frame (LrgReelVideoSource *self,
+                                 gint                index,
+                                 GError            **error)
+{
+    GrlImage *image;
 
-    if (self->current_frame != NULL && self->current_index == index)
-        return self->current_frame;
+    g_return_val_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self), NULL);
 
-    e = g_array_index (self->frame_index, ReelFrameEntry, index);
-    data = g_bytes_get_data (self->png_data, NULL);
-    img = grl_image_new_from_memory (".png", data + e.offset, e.length);
-    if (img == NULL)
-    {
-        g_set_error (error, LRG_REEL_VIDEO_SOURCE_ERROR, 4,
-                     "failed to decode frame %d", index);
+    image = reel_video_fetch (self, index, error);
+    if (image == NULL)
         return NULL;
-    }
 
     g_clear_object (&self->current_frame);
-    self->current_frame = img;
-    self->current_index = index;
+    self->current_frame = image;
 
     return self->current_frame;
 }
 
+void
+lrg_reel_video_source_set_window_size (LrgReelVideoSource *self,
+                                       guint               frames)
+{
+    g_return_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self));
+    g_return_if_fail (frames > 0);
+
+    g_mutex_lock (&self->lock);
+    self->window_size = frames;
+    reel_video_trim_locked (self);
+    g_mutex_unlock (&self->lock);
+}
+
+guint
+lrg_reel_video_source_get_window_size (LrgReelVideoSource *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self), 0);
+
+    return self->window_size;
+}
+
+void
+lrg_reel_video_source_set_read_ahead (LrgReelVideoSource *self,
+                                      guint               frames)
+{
+    g_return_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self));
+
+    g_mutex_lock (&self->lock);
+    self->read_ahead = frames;
+    reel_video_trim_locked (self);
+    g_cond_broadcast (&self->cond);
+    g_mutex_unlock (&self->lock);
+}
+
+guint
+lrg_reel_video_source_get_read_ahead (LrgReelVideoSource *self)
+{
+    g_return_val_if_fail (LRG_IS_REEL_VIDEO_SOURCE (self), 0);
+
+    return self->read_ahead;
+}
+
 LrgWaveData *
 lrg_reel_video_source_extract_audio (LrgReelVideoSource *self,
                                      GError            **error)
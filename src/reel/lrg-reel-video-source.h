@@ -6,10 +6,12 @@
  *
  * LrgReelVideoSource - decodes an existing video file into frames.
  *
- * Uses ffprobe for metadata and an ffmpeg subprocess (decoding to a PNG image
- * stream) for frames.  Decoded frames are demuxed and indexed; a frame is
- * rasterized to a #GrlImage on demand and the most recent one is cached, so
- * sequential access (the reel renderer's usual pattern) re-decodes nothing.
+ * Uses ffprobe for metadata and the packet/keyframe index, and an ffmpeg
+ * subprocess streaming raw RGBA for frames.  A decoder thread keeps a bounded
+ * LRU window of decoded frames, reads a few frames ahead of the latest
+ * request, and restarts ffmpeg at the nearest keyframe when a reader jumps
+ * away.  Memory stays constant regardless of clip length, and any number of
+ * threads may read frames concurrently.
  */
 
 #pragma once
@@ -62,8 +64,9 @@ gboolean lrg_reel_video_source_get_has_audio    (LrgReelVideoSource *self);
  * lrg_reel_video_source_get_frame_count:
  * @self: a #LrgReelVideoSource
  *
- * Returns the number of decoded frames.  This forces a full decode on the
- * first call.
+ * Returns the number of frames.  The first call lists the video's packets
+ * with ffprobe (no decoding).  If decoding later ends early the count shrinks
+ * to what actually decodes.
  *
  * Returns: the frame count, or 0 on decode failure
  *
@@ -80,7 +83,8 @@ lrg_reel_video_source_get_frame_count (LrgReelVideoSource *self);
  * @error: (nullable): return location for a #GError.
  *
  * Returns the decoded frame at @index.  The returned image is owned by the
- * source and remains valid only until the next call.
+ * source and remains valid only until the next call, so this is meant for a
+ * single reader; concurrent readers use lrg_reel_video_source_dup_frame().
  *
  * Returns: (transfer none) (nullable): the frame image, or %NULL on error
  *
@@ -92,6 +96,80 @@ lrg_reel_video_source_get_frame (LrgReelVideoSource *self,
                                  gint                index,
                                  GError            **error);
 
+/**
+ * lrg_reel_video_source_dup_frame:
+ * @self: a #LrgReelVideoSource
+ * @index: zero-based frame index (clamped to the valid range).
+ * @error: (nullable): return location for a #GError.
+ *
+ * Returns a new reference to the decoded frame at @index, blocking until it
+ * has been decoded.  Safe to call from several threads at once, e.g. from
+ * clips rendered by lrg_reel_renderer_render_parallel().
+ *
+ * Returns: (transfer full) (nullable): the frame image, or %NULL on error
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+GrlImage *
+lrg_reel_video_source_dup_frame (LrgReelVideoSource *self,
+                                 gint                index,
+                                 GError            **error);
+
+/**
+ * lrg_reel_video_source_set_window_size:
+ * @self: a #LrgReelVideoSource
+ * @frames: decoded frames to keep, at least 1.
+ *
+ * Bounds the decoded-frame window.  Each frame holds width * height * 4
+ * bytes.  The window always holds at least the read-ahead plus two frames,
+ * and frames a reader is blocked on are never evicted.  The default is 12.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_reel_video_source_set_window_size (LrgReelVideoSource *self,
+                                       guint               frames);
+
+/**
+ * lrg_reel_video_source_get_window_size:
+ * @self: a #LrgReelVideoSource
+ *
+ * Returns: the decoded-frame window size, in frames
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_reel_video_source_get_window_size (LrgReelVideoSource *self);
+
+/**
+ * lrg_reel_video_source_set_read_ahead:
+ * @self: a #LrgReelVideoSource
+ * @frames: frames to decode past the latest request, or 0 for none.
+ *
+ * Sets how far the decoder thread runs ahead of readers.  The default is 4.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_reel_video_source_set_read_ahead (LrgReelVideoSource *self,
+                                      guint               frames);
+
+/**
+ * lrg_reel_video_source_get_read_ahead:
+ * @self: a #LrgReelVideoSource
+ *
+ * Returns: the read-ahead distance, in frames
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_reel_video_source_get_read_ahead (LrgReelVideoSource *self);
+
 /**
  * lrg_reel_video_source_extract_audio:
  * @self: a #LrgReelVideoSource
@@ -17,11 +17,17 @@
 #include "../lrg-log.h"
 #include "../core/lrg-engine.h"
 #include "../core/lrg-registry.h"
+#include "../ecs/components/lrg-transform-component.h"
+#include "../physics/lrg-rigid-body.h"
 
 #include <lua.h>
 #include <lualib.h>
 #include <lauxlib.h>
 
+/* The view prelude declares these structs to the FFI as plain floats */
+G_STATIC_ASSERT (sizeof (LrgTransformData) == 5 * sizeof (gfloat));
+G_STATIC_ASSERT (sizeof (LrgRigidBodyMotion) == 6 * sizeof (gfloat));
+
 /* Registry keys for storing references */
 #define LRG_LUA_SCRIPTING_KEY  "LrgScripting"
 #define LRG_LUA_ENGINE_KEY     "LrgEngine"
@@ -539,6 +545,102 @@ lrg_lua_api_update_engine (lua_State *L,
     lua_setfield (L, LUA_REGISTRYINDEX, LRG_LUA_ENGINE_KEY);
 }
 
+/* ==========================================================================
+ * Views API
+ * ========================================================================== */
+
+/*
+ * Pointer accessors handed to the view prelude. They return the hot
+ * data of a component as light userdata, which ffi.cast() turns into
+ * typed cdata; after that, field access never re-enters C.
+ */
+static int
+views_transform_data (lua_State *L)
+{
+    GObject *object = lrg_lua_to_gobject (L, 1);
+
+    if (!LRG_IS_TRANSFORM_COMPONENT (object))
+        return luaL_argerror (L, 1, "LrgTransformComponent expected");
+
+    lua_pushlightuserdata (L, lrg_transform_component_get_data (LRG_TRANSFORM_COMPONENT (object)));
+    return 1;
+}
+
+static int
+views_rigid_body_motion (lua_State *L)
+{
+    GObject *object = lrg_lua_to_gobject (L, 1);
+
+    if (!LRG_IS_RIGID_BODY (object))
+        return luaL_argerror (L, 1, "LrgRigidBody expected");
+
+    lua_pushlightuserdata (L, lrg_rigid_body_get_motion (LRG_RIGID_BODY (object)));
+    return 1;
+}
+
+/*
+ * Each view anchors the object it was taken from, so the storage
+ * cannot be finalized while a script still holds the cdata.
+ */
+static const gchar views_prelude[] =
+    "local transform_data, rigid_body_motion = ...\n"
+    "local ok, ffi = pcall (require, 'ffi')\n"
+    "if not ok then return false end\n"
+    "ffi.cdef [[\n"
+    "typedef struct { float local_x, local_y, local_rotation, scale_x, scale_y; } LrgTransformData;\n"
+    "typedef struct { float pos_x, pos_y, rotation, vel_x, vel_y, angular_velocity; } LrgRigidBodyMotion;\n"
+    "]]\n"
+    "local transform_ptr = ffi.typeof ('LrgTransformData *')\n"
+    "local motion_ptr = ffi.typeof ('LrgRigidBodyMotion *')\n"
+    "local anchors = setmetatable ({}, { __mode = 'k' })\n"
+    "local Views = {}\n"
+    "function Views.transform (object)\n"
+    "    local view = ffi.cast (transform_ptr, transform_data (object))\n"
+    "    anchors[view] = object\n"
+    "    return view\n"
+    "end\n"
+    "function Views.rigid_body (object)\n"
+    "    local view = ffi.cast (motion_ptr, rigid_body_motion (object))\n"
+    "    anchors[view] = object\n"
+    "    return view\n"
+    "end\n"
+    "_G.Views = Views\n"
+    "return true\n";
+
+/**
+ * lrg_lua_api_register_views:
+ *
+ * Registers the Views global when the FFI library is available.
+ */
+void
+lrg_lua_api_register_views (lua_State *L)
+{
+    int result;
+
+    result = luaL_loadbuffer (L, views_prelude, sizeof (views_prelude) - 1, "=lrg-views");
+    if (result == 0)
+    {
+        lua_pushcfunction (L, views_transform_data);
+        lua_pushcfunction (L, views_rigid_body_motion);
+        result = lua_pcall (L, 2, 1, 0);
+    }
+
+    if (result != 0)
+    {
+        const gchar *msg = lua_tostring (L, -1);
+        lrg_warning (LRG_LOG_DOMAIN_SCRIPTING,
+                     "Failed to register Views: %s",
+                     msg ? msg : "(unknown error)");
+    }
+    else if (!lua_toboolean (L, -1))
+    {
+        lrg_debug (LRG_LOG_DOMAIN_SCRIPTING,
+                   "LuaJIT built without FFI, Views unavailable");
+    }
+
+    lua_pop (L, 1);
+}
+
 /* ==========================================================================
  * Main Registration
  * ========================================================================== */
@@ -564,4 +666,5 @@ lrg_lua_api_register_all (lua_State       *L,
     lrg_lua_api_register_log (L);
     lrg_lua_api_register_registry (L, scripting);
     lrg_lua_api_register_engine (L, scripting);
+    lrg_lua_api_register_views (L);
 }
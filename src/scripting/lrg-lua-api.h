@@ -7,7 +7,8 @@
  * Built-in Lua API for libregnum.
  *
  * This file provides the registration of built-in globals and
- * functions that are exposed to Lua scripts: Engine, Registry, Log.
+ * functions that are exposed to Lua scripts: Engine, Registry, Log,
+ * Views.
  */
 
 #pragma once
@@ -30,6 +31,7 @@ G_BEGIN_DECLS
  * - Engine: Access to the engine singleton
  * - Registry: Type registry for creating objects
  * - Log: Logging functions (debug, info, warning, error)
+ * - Views: FFI views over component data (LuaJIT FFI only)
  */
 void lrg_lua_api_register_all (lua_State       *L,
                                LrgScriptingLua *scripting);
@@ -99,6 +101,28 @@ void lrg_lua_api_register_registry (lua_State       *L,
  */
 void lrg_lua_api_register_log (lua_State *L);
 
+/**
+ * lrg_lua_api_register_views:
+ * @L: the Lua state
+ *
+ * Registers the Views global, which maps component hot data into
+ * LuaJIT FFI cdata. Scripts read and write the fields directly
+ * instead of going through GObject properties.
+ *
+ * The Views table provides:
+ * - Views.transform(component): #LrgTransformData of a transform
+ * - Views.rigid_body(body): #LrgRigidBodyMotion of a rigid body
+ *
+ * ```lua
+ * local t = Views.transform(transform)
+ * t.local_x = t.local_x + 10 * delta
+ * ```
+ *
+ * Writes bypass property notification. Nothing is registered when
+ * LuaJIT was built without the FFI.
+ */
+void lrg_lua_api_register_views (lua_State *L);
+
 /**
  * lrg_lua_api_update_engine:
  * @L: the Lua state
@@ -0,0 +1,599 @@
+/* lrg-script-job-system.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Parallel execution of entity scripts across several Lua states.
+ */
+
+#include "config.h"
+
+#define LRG_LOG_DOMAIN LRG_LOG_DOMAIN_SCRIPTING
+
+#include "lrg-script-job-system.h"
+#include "lrg-scripting-lua.h"
+#include "lrg-scripting-lua-private.h"
+#include "lrg-lua-bridge.h"
+#include "../lrg-log.h"
+
+#include <string.h>
+#include <lua.h>
+#include <lauxlib.h>
+
+/*
+ * ScriptJob:
+ *
+ * One entity scheduled on a worker. @func_name is interned.
+ */
+typedef struct
+{
+    GObject     *entity;
+    const gchar *func_name;
+} ScriptJob;
+
+/*
+ * ScriptCommand:
+ *
+ * A property write recorded by Commands.set(). The value is already
+ * converted to the property type so applying it cannot fail.
+ */
+typedef struct
+{
+    GObject    *object;
+    GParamSpec *pspec;
+    GValue      value;
+} ScriptCommand;
+
+typedef struct
+{
+    LrgScriptJobSystem *system;      /* Back pointer */
+    GThread            *thread;
+    LrgScriptingLua    *scripting;   /* Only touched by the thread during a run */
+    GArray             *jobs;        /* ScriptJob */
+    GArray             *commands;    /* ScriptCommand */
+    GError             *error;       /* First failure of the last run */
+    guint64             seen;        /* Last run serial this worker picked up */
+} ScriptWorker;
+
+struct _LrgScriptJobSystem
+{
+    GObject       parent_instance;
+
+    ScriptWorker *workers;
+    guint         n_workers;
+    guint         n_commands;
+
+    GMutex        lock;
+    GCond         cond;
+    guint64       run_serial;    /* Bumped to start a run */
+    guint         pending;       /* Workers still busy with the current run */
+    gdouble       delta;
+    gboolean      shutdown;
+};
+
+G_DEFINE_FINAL_TYPE (LrgScriptJobSystem, lrg_script_job_system, G_TYPE_OBJECT)
+
+/* ==========================================================================
+ * Commands
+ * ========================================================================== */
+
+static void
+script_job_clear (gpointer data)
+{
+    ScriptJob *job = data;
+
+    g_clear_object (&job->entity);
+}
+
+static void
+script_command_clear (gpointer data)
+{
+    ScriptCommand *command = data;
+
+    g_value_unset (&command->value);
+    g_clear_object (&command->object);
+}
+
+/*
+ * Commands.set(object, property, value)
+ *
+ * Records a property write on the worker's command buffer.
+ */
+static int
+commands_set (lua_State *L)
+{
+    ScriptWorker  *worker = lua_touserdata (L, lua_upvalueindex (1));
+    GObject       *object = lrg_lua_to_gobject (L, 1);
+    const gchar   *property = luaL_checkstring (L, 2);
+    GParamSpec    *pspec;
+    ScriptCommand  command;
+
+    if (object == NULL)
+        return luaL_argerror (L, 1, "GObject expected");
+
+    pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (object), property);
+    if (pspec == NULL || !(pspec->flags & G_PARAM_WRITABLE) ||
+        (pspec->flags & G_PARAM_CONSTRUCT_ONLY))
+    {
+        return luaL_error (L, "%s has no writable property '%s'",
+                           G_OBJECT_TYPE_NAME (object), property);
+    }
+
+    memset (&command, 0, sizeof (command));
+    if (!lrg_lua_to_gvalue_with_type (L, 3, pspec->value_type, &command.value))
+    {
+        if (G_IS_VALUE (&command.value))
+            g_value_unset (&command.value);
+        return luaL_argerror (L, 3, "value does not match the property type");
+    }
+
+    command.object = g_object_ref (object);
+    command.pspec = pspec;
+    g_array_append_val (worker->commands, command);
+
+    return 0;
+}
+
+static void
+register_commands (ScriptWorker *worker)
+{
+    lua_State *L = lrg_scripting_lua_get_state (worker->scripting);
+
+    lua_newtable (L);
+    lua_pushlightuserdata (L, worker);
+    lua_pushcclosure (L, commands_set, 1);
+    lua_setfield (L, -2, "set");
+    lua_setglobal (L, "Commands");
+}
+
+/* ==========================================================================
+ * Workers
+ * ========================================================================== */
+
+static void
+script_worker_fail (ScriptWorker *worker,
+                    gint          code,
+                    const gchar  *format,
+                    ...) G_GNUC_PRINTF (3, 4);
+
+static void
+script_worker_fail (ScriptWorker *worker,
+                    gint          code,
+                    const gchar  *format,
+                    ...)
+{
+    va_list args;
+
+    if (worker->error != NULL)
+        return;
+
+    va_start (args, format);
+    worker->error = g_error_new_valist (LRG_SCRIPTING_ERROR, code, format, args);
+    va_end (args);
+}
+
+static void
+script_worker_run (ScriptWorker *worker,
+                   gdouble       delta)
+{
+    lua_State *L = lrg_scripting_lua_get_state (worker->scripting);
+    guint      i;
+
+    for (i = 0; i < worker->jobs->len; i++)
+    {
+        ScriptJob *job = &g_array_index (worker->jobs, ScriptJob, i);
+
+        lua_getglobal (L, job->func_name);
+        if (!lua_isfunction (L, -1))
+        {
+            lua_pop (L, 1);
+            script_worker_fail (worker, LRG_SCRIPTING_ERROR_NOT_FOUND,
+                                "Function '%s' not found", job->func_name);
+            continue;
+        }
+
+        lrg_lua_push_gobject (L, job->entity);
+        lua_pushnumber (L, (lua_Number)delta);
+
+        if (lua_pcall (L, 2, 0, 0) != 0)
+        {
+            const gchar *msg = lua_tostring (L, -1);
+
+            script_worker_fail (worker, LRG_SCRIPTING_ERROR_RUNTIME,
+                                "Error calling '%s': %s",
+                                job->func_name, msg ? msg : "(unknown error)");
+            lua_pop (L, 1);
+        }
+    }
+}
+
+static gpointer
+script_worker_thread (gpointer data)
+{
+    ScriptWorker       *worker = data;
+    LrgScriptJobSystem *self = worker->system;
+
+    g_mutex_lock (&self->lock);
+    while (TRUE)
+    {
+        gdouble delta;
+
+        while (!self->shutdown && worker->seen == self->run_serial)
+            g_cond_wait (&self->cond, &self->lock);
+
+        if (self->shutdown)
+            break;
+
+        worker->seen = self->run_serial;
+        delta = self->delta;
+        g_mutex_unlock (&self->lock);
+
+        script_worker_run (worker, delta);
+
+        g_mutex_lock (&self->lock);
+        if (--self->pending == 0)
+            g_cond_broadcast (&self->cond);
+    }
+    g_mutex_unlock (&self->lock);
+
+    return NULL;
+}
+
+static ScriptWorker *
+least_loaded_worker (LrgScriptJobSystem *self)
+{
+    ScriptWorker *best = &self->workers[0];
+    guint         i;
+
+    for (i = 1; i < self->n_workers; i++)
+    {
+        if (self->workers[i].jobs->len < best->jobs->len)
+            best = &self->workers[i];
+    }
+
+    return best;
+}
+
+/* ==========================================================================
+ * GObject Implementation
+ * ========================================================================== */
+
+static void
+lrg_script_job_system_finalize (GObject *object)
+{
+    LrgScriptJobSystem *self = LRG_SCRIPT_JOB_SYSTEM (object);
+    guint               i;
+
+    g_mutex_lock (&self->lock);
+    self->shutdown = TRUE;
+    g_cond_broadcast (&self->cond);
+    g_mutex_unlock (&self->lock);
+
+    for (i = 0; i < self->n_workers; i++)
+    {
+        ScriptWorker *worker = &self->workers[i];
+
+        g_thread_join (worker->thread);
+        g_clear_pointer (&worker->jobs, g_array_unref);
+        g_clear_pointer (&worker->commands, g_array_unref);
+        g_clear_error (&worker->error);
+        g_clear_object (&worker->scripting);
+    }
+    g_free (self->workers);
+
+    g_mutex_clear (&self->lock);
+    g_cond_clear (&self->cond);
+
+    G_OBJECT_CLASS (lrg_script_job_system_parent_class)->finalize (object);
+}
+
+static void
+lrg_script_job_system_class_init (LrgScriptJobSystemClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = lrg_script_job_system_finalize;
+}
+
+static void
+lrg_script_job_system_init (LrgScriptJobSystem *self)
+{
+    g_mutex_init (&self->lock);
+    g_cond_init (&self->cond);
+}
+
+/* ==========================================================================
+ * Public API
+ * ========================================================================== */
+
+/**
+ * lrg_script_job_system_new:
+ * @n_workers: number of worker states, or 0 for one per processor
+ *
+ * Creates a job system with @n_workers threads, each owning a fresh
+ * #LrgScriptingLua state.
+ *
+ * Returns: (transfer full): a new #LrgScriptJobSystem
+ */
+LrgScriptJobSystem *
+lrg_script_job_system_new (guint n_workers)
+{
+    LrgScriptJobSystem *self;
+    guint               i;
+
+    if (n_workers == 0)
+        n_workers = MAX (1, g_get_num_processors ());
+
+    self = g_object_new (LRG_TYPE_SCRIPT_JOB_SYSTEM, NULL);
+    self->n_workers = n_workers;
+    self->workers = g_new0 (ScriptWorker, n_workers);
+
+    for (i = 0; i < n_workers; i++)
+    {
+        ScriptWorker *worker = &self->workers[i];
+
+        worker->system = self;
+        worker->scripting = lrg_scripting_lua_new ();
+        worker->jobs = g_array_new (FALSE, FALSE, sizeof (ScriptJob));
+        g_array_set_clear_func (worker->jobs, script_job_clear);
+        worker->commands = g_array_new (FALSE, FALSE, sizeof (ScriptCommand));
+        g_array_set_clear_func (worker->commands, script_command_clear);
+        register_commands (worker);
+
+        worker->thread = g_thread_new ("lrg-script-job", script_worker_thread, worker);
+    }
+
+    lrg_debug (LRG_LOG_DOMAIN_SCRIPTING, "Script job system started with %u workers", n_workers);
+
+    return self;
+}
+
+/**
+ * lrg_script_job_system_get_worker_count:
+ * @self: an #LrgScriptJobSystem
+ *
+ * Returns: the number of worker states
+ */
+guint
+lrg_script_job_system_get_worker_count (LrgScriptJobSystem *self)
+{
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), 0);
+
+    return self->n_workers;
+}
+
+/**
+ * lrg_script_job_system_load_file:
+ * @self: an #LrgScriptJobSystem
+ * @path: (type filename): path to a Lua script
+ * @error: (nullable): return location for a #GError
+ *
+ * Loads and executes @path in every worker state.
+ *
+ * Returns: %TRUE if every worker loaded the script
+ */
+gboolean
+lrg_script_job_system_load_file (LrgScriptJobSystem  *self,
+                                 const gchar         *path,
+                                 GError             **error)
+{
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), FALSE);
+    g_return_val_if_fail (path != NULL, FALSE);
+
+    for (i = 0; i < self->n_workers; i++)
+    {
+        if (!lrg_scripting_load_file (LRG_SCRIPTING (self->workers[i].scripting), path, error))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * lrg_script_job_system_load_string:
+ * @self: an #LrgScriptJobSystem
+ * @name: chunk name used in error messages
+ * @code: Lua source
+ * @error: (nullable): return location for a #GError
+ *
+ * Loads and executes @code in every worker state.
+ *
+ * Returns: %TRUE if every worker loaded the code
+ */
+gboolean
+lrg_script_job_system_load_string (LrgScriptJobSystem  *self,
+                                   const gchar         *name,
+                                   const gchar         *code,
+                                   GError             **error)
+{
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), FALSE);
+    g_return_val_if_fail (name != NULL, FALSE);
+    g_return_val_if_fail (code != NULL, FALSE);
+
+    for (i = 0; i < self->n_workers; i++)
+    {
+        if (!lrg_scripting_load_string (LRG_SCRIPTING (self->workers[i].scripting),
+                                        name, code, error))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * lrg_script_job_system_add_entity:
+ * @self: an #LrgScriptJobSystem
+ * @entity: the object passed to the script
+ * @func_name: global Lua function to call as `func (entity, delta)`
+ *
+ * Schedules @func_name to run for @entity on every call to
+ * lrg_script_job_system_run(). The entity is assigned to the least
+ * loaded worker and stays there.
+ */
+void
+lrg_script_job_system_add_entity (LrgScriptJobSystem *self,
+                                  GObject            *entity,
+                                  const gchar        *func_name)
+{
+    ScriptWorker *worker;
+    ScriptJob     job;
+
+    g_return_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self));
+    g_return_if_fail (G_IS_OBJECT (entity));
+    g_return_if_fail (func_name != NULL);
+
+    worker = least_loaded_worker (self);
+    job.entity = g_object_ref (entity);
+    job.func_name = g_intern_string (func_name);
+    g_array_append_val (worker->jobs, job);
+}
+
+/**
+ * lrg_script_job_system_remove_entity:
+ * @self: an #LrgScriptJobSystem
+ * @entity: an object previously added
+ *
+ * Removes every job scheduled for @entity.
+ *
+ * Returns: %TRUE if @entity had any jobs
+ */
+gboolean
+lrg_script_job_system_remove_entity (LrgScriptJobSystem *self,
+                                     GObject            *entity)
+{
+    gboolean removed = FALSE;
+    guint    i;
+
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), FALSE);
+
+    for (i = 0; i < self->n_workers; i++)
+    {
+        GArray *jobs = self->workers[i].jobs;
+        guint   j = 0;
+
+        while (j < jobs->len)
+        {
+            if (g_array_index (jobs, ScriptJob, j).entity == entity)
+            {
+                g_array_remove_index (jobs, j);
+                removed = TRUE;
+            }
+            else
+            {
+                j++;
+            }
+        }
+    }
+
+    return removed;
+}
+
+/**
+ * lrg_script_job_system_get_entity_count:
+ * @self: an #LrgScriptJobSystem
+ * @worker: a worker index, or -1 for all workers
+ *
+ * Returns: the number of jobs scheduled on @worker
+ */
+guint
+lrg_script_job_system_get_entity_count (LrgScriptJobSystem *self,
+                                        gint                worker)
+{
+    guint count = 0;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), 0);
+    g_return_val_if_fail (worker < (gint)self->n_workers, 0);
+
+    if (worker >= 0)
+        return self->workers[worker].jobs->len;
+
+    for (i = 0; i < self->n_workers; i++)
+        count += self->workers[i].jobs->len;
+
+    return count;
+}
+
+/**
+ * lrg_script_job_system_run:
+ * @self: an #LrgScriptJobSystem
+ * @delta: time since the last frame in seconds
+ * @error: (nullable): return location for a #GError
+ *
+ * Runs every scheduled job in parallel, waits for all workers and
+ * applies the recorded commands on the calling thread in worker order.
+ *
+ * Returns: %TRUE if every job succeeded
+ */
+gboolean
+lrg_script_job_system_run (LrgScriptJobSystem  *self,
+                           gdouble              delta,
+                           GError             **error)
+{
+    GError *first = NULL;
+    guint   i;
+
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), FALSE);
+
+    /* Parallel phase */
+    g_mutex_lock (&self->lock);
+    self->delta = delta;
+    self->pending = self->n_workers;
+    self->run_serial++;
+    g_cond_broadcast (&self->cond);
+    while (self->pending > 0)
+        g_cond_wait (&self->cond, &self->lock);
+    g_mutex_unlock (&self->lock);
+
+    /* Apply phase; worker order keeps the result deterministic */
+    self->n_commands = 0;
+    for (i = 0; i < self->n_workers; i++)
+    {
+        ScriptWorker *worker = &self->workers[i];
+        guint         j;
+
+        for (j = 0; j < worker->commands->len; j++)
+        {
+            ScriptCommand *command = &g_array_index (worker->commands, ScriptCommand, j);
+
+            g_object_set_property (command->object, command->pspec->name, &command->value);
+        }
+        self->n_commands += worker->commands->len;
+        g_array_set_size (worker->commands, 0);
+
+        if (worker->error != NULL)
+        {
+            if (first == NULL)
+                first = g_steal_pointer (&worker->error);
+            else
+                g_clear_error (&worker->error);
+        }
+    }
+
+    if (first != NULL)
+    {
+        g_propagate_error (error, first);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * lrg_script_job_system_get_command_count:
+ * @self: an #LrgScriptJobSystem
+ *
+ * Returns: the number of commands applied by the last run
+ */
+guint
+lrg_script_job_system_get_command_count (LrgScriptJobSystem *self)
+{
+    g_return_val_if_fail (LRG_IS_SCRIPT_JOB_SYSTEM (self), 0);
+
+    return self->n_commands;
+}
@@ -0,0 +1,177 @@
+/* lrg-script-job-system.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Parallel execution of entity scripts across several Lua states.
+ *
+ * LrgScriptJobSystem owns a pool of worker threads, each with its own
+ * #LrgScriptingLua state loaded from the same sources. Entities are
+ * partitioned across the workers and their update functions run in
+ * parallel. Scripts may read any object, but writes go through the
+ * `Commands` table, which records them in a per-worker buffer that is
+ * applied on the calling thread once every worker has finished.
+ */
+
+#pragma once
+
+#if !defined(LIBREGNUM_INSIDE) && !defined(LIBREGNUM_COMPILATION)
+#error "Only <libregnum.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include "../lrg-version.h"
+#include "../lrg-types.h"
+
+G_BEGIN_DECLS
+
+#define LRG_TYPE_SCRIPT_JOB_SYSTEM (lrg_script_job_system_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgScriptJobSystem, lrg_script_job_system, LRG, SCRIPT_JOB_SYSTEM, GObject)
+
+/* ==========================================================================
+ * Construction
+ * ========================================================================== */
+
+/**
+ * lrg_script_job_system_new:
+ * @n_workers: number of worker states, or 0 for one per processor
+ *
+ * Creates a job system with @n_workers threads, each owning a fresh
+ * #LrgScriptingLua state.
+ *
+ * Returns: (transfer full): a new #LrgScriptJobSystem
+ */
+LRG_AVAILABLE_IN_ALL
+LrgScriptJobSystem * lrg_script_job_system_new (guint n_workers);
+
+/**
+ * lrg_script_job_system_get_worker_count:
+ * @self: an #LrgScriptJobSystem
+ *
+ * Returns: the number of worker states
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_script_job_system_get_worker_count (LrgScriptJobSystem *self);
+
+/* ==========================================================================
+ * Sources
+ * ========================================================================== */
+
+/**
+ * lrg_script_job_system_load_file:
+ * @self: an #LrgScriptJobSystem
+ * @path: (type filename): path to a Lua script
+ * @error: (nullable): return location for a #GError
+ *
+ * Loads and executes @path in every worker state.
+ *
+ * Returns: %TRUE if every worker loaded the script
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_script_job_system_load_file (LrgScriptJobSystem  *self,
+                                          const gchar         *path,
+                                          GError             **error);
+
+/**
+ * lrg_script_job_system_load_string:
+ * @self: an #LrgScriptJobSystem
+ * @name: chunk name used in error messages
+ * @code: Lua source
+ * @error: (nullable): return location for a #GError
+ *
+ * Loads and executes @code in every worker state.
+ *
+ * Returns: %TRUE if every worker loaded the code
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_script_job_system_load_string (LrgScriptJobSystem  *self,
+                                            const gchar         *name,
+                                            const gchar         *code,
+                                            GError             **error);
+
+/* ==========================================================================
+ * Entities
+ * ========================================================================== */
+
+/**
+ * lrg_script_job_system_add_entity:
+ * @self: an #LrgScriptJobSystem
+ * @entity: the object passed to the script
+ * @func_name: global Lua function to call as `func (entity, delta)`
+ *
+ * Schedules @func_name to run for @entity on every call to
+ * lrg_script_job_system_run(). The entity is assigned to the least
+ * loaded worker and stays there, so per-entity script state kept in
+ * that worker's globals persists between runs.
+ *
+ * Entities on the same worker run in the order they were added.
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_script_job_system_add_entity (LrgScriptJobSystem *self,
+                                       GObject            *entity,
+                                       const gchar        *func_name);
+
+/**
+ * lrg_script_job_system_remove_entity:
+ * @self: an #LrgScriptJobSystem
+ * @entity: an object previously added
+ *
+ * Removes every job scheduled for @entity.
+ *
+ * Returns: %TRUE if @entity had any jobs
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_script_job_system_remove_entity (LrgScriptJobSystem *self,
+                                              GObject            *entity);
+
+/**
+ * lrg_script_job_system_get_entity_count:
+ * @self: an #LrgScriptJobSystem
+ * @worker: a worker index, or -1 for all workers
+ *
+ * Returns: the number of jobs scheduled on @worker
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_script_job_system_get_entity_count (LrgScriptJobSystem *self,
+                                              gint                worker);
+
+/* ==========================================================================
+ * Execution
+ * ========================================================================== */
+
+/**
+ * lrg_script_job_system_run:
+ * @self: an #LrgScriptJobSystem
+ * @delta: time since the last frame in seconds
+ * @error: (nullable): return location for a #GError
+ *
+ * Runs every scheduled job in parallel and blocks until all workers
+ * are done, then applies the recorded commands on the calling thread
+ * in worker order. During the parallel phase scripts must treat
+ * shared objects as read-only and write through
+ * `Commands.set (object, "property", value)`.
+ *
+ * A failing job does not stop the others; its commands recorded so
+ * far are still applied.
+ *
+ * Returns: %TRUE if every job succeeded, %FALSE with @error set to
+ *   the first failure otherwise
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_script_job_system_run (LrgScriptJobSystem  *self,
+                                    gdouble              delta,
+                                    GError             **error);
+
+/**
+ * lrg_script_job_system_get_command_count:
+ * @self: an #LrgScriptJobSystem
+ *
+ * Returns: the number of commands applied by the last run
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_script_job_system_get_command_count (LrgScriptJobSystem *self);
+
+G_END_DECLS
@@ -7,9 +7,30 @@
  * Crispy (compiled-C) scripting backend.
  */
 
+#include "config.h"
+
+#define LRG_LOG_DOMAIN LRG_LOG_DOMAIN_SCRIPTING
+
 #include "lrg-scripting-crispy.h"
+#include "lrg-script-module.h"
 #include "../lrg-enums.h"
+#include "../lrg-log.h"
 #include <crispy.h>
+#include <gio/gio.h>
+#include <gmodule.h>
+
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#else
+#include <link.h>
+#endif
+
+/* Typed entry points for the fast-call ABI. */
+typedef void (*CrispyVoidFunc)    (void);
+typedef void (*CrispyFloatFunc)   (float);
+typedef void (*CrispyDoubleFunc)  (double);
+typedef void (*CrispyIntFunc)     (int);
+typedef void (*CrispyPointerFunc) (void *);
 
 struct _LrgScriptingCrispy
 {
@@ -18,10 +39,131 @@ struct _LrgScriptingCrispy
 	CrispyGccCompiler *compiler;   /* lazily created GCC compiler */
 	CrispyFileCache   *cache;      /* lazily created compile cache */
 	CrispyScript      *script;     /* most recently loaded script */
+	GModule           *module;     /* handle on @script's shared object */
+	GHashTable        *symbols;    /* name -> function pointer (NULL = missing) */
+	guint              generation; /* bumped whenever @module changes */
+
+	gchar             *path;       /* source of the last load_file(), or NULL */
+	gboolean           hot_reload;
+	GFileMonitor      *monitor;
+	gint               reload_pending; /* atomic */
 };
 
 G_DEFINE_FINAL_TYPE (LrgScriptingCrispy, lrg_scripting_crispy, LRG_TYPE_SCRIPTING)
 
+/* Crispy hands out a script object but not the module it dlopen()ed.  We find
+ * the module by diffing the process's loaded objects around the load; when
+ * the compile cache hands back an object that is already mapped (the same
+ * script loaded by a second context) nothing new appears, so remember the
+ * object each source resolved to.  Keys are "file:<abs path>" or
+ * "inline:<sha1>". */
+static GMutex      module_paths_lock;
+static GHashTable *module_paths;
+
+/* ==========================================================================
+ * Module discovery
+ * ========================================================================== */
+
+#ifndef __APPLE__
+static int
+crispy_collect_object (struct dl_phdr_info *info,
+                       size_t               size,
+                       void                *data)
+{
+	GPtrArray *names = data;
+
+	(void) size;
+	if (info->dlpi_name != NULL && info->dlpi_name[0] != '\0')
+		g_ptr_array_add (names, g_strdup (info->dlpi_name));
+
+	return 0;
+}
+#endif
+
+/* Returns the paths of all loaded shared objects, in load order. */
+static GPtrArray *
+crispy_loaded_objects (void)
+{
+	GPtrArray *names = g_ptr_array_new_with_free_func (g_free);
+
+#ifdef __APPLE__
+	{
+		uint32_t n = _dyld_image_count ();
+		uint32_t i;
+
+		for (i = 0; i < n; i++)
+			g_ptr_array_add (names, g_strdup (_dyld_get_image_name (i)));
+	}
+#else
+	dl_iterate_phdr (crispy_collect_object, names);
+#endif
+
+	return names;
+}
+
+/* First object in @after that is not in @before: the script itself, since
+ * the dynamic loader maps an object before its dependencies. */
+static gchar *
+crispy_new_object (GPtrArray *before,
+                   GPtrArray *after)
+{
+	g_autoptr(GHashTable) seen = g_hash_table_new (g_str_hash, g_str_equal);
+	guint                 i;
+
+	for (i = 0; i < before->len; i++)
+		g_hash_table_add (seen, g_ptr_array_index (before, i));
+
+	for (i = 0; i < after->len; i++)
+	{
+		const gchar *name = g_ptr_array_index (after, i);
+
+		if (!g_hash_table_contains (seen, name))
+			return g_strdup (name);
+	}
+
+	return NULL;
+}
+
+/* Opens a second handle on the script's already-mapped object.  dlopen()
+ * returns the same instance, so symbols resolve to the code and statics the
+ * script's entry point just ran against. */
+static GModule *
+crispy_open_module (const gchar  *key,
+                    GPtrArray    *before,
+                    GError      **error)
+{
+	g_autoptr(GPtrArray) after = crispy_loaded_objects ();
+	g_autofree gchar    *so_path = crispy_new_object (before, after);
+	GModule             *module;
+
+	g_mutex_lock (&module_paths_lock);
+	if (module_paths == NULL)
+		module_paths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	if (so_path != NULL)
+		g_hash_table_replace (module_paths, g_strdup (key), g_strdup (so_path));
+	else
+		so_path = g_strdup (g_hash_table_lookup (module_paths, key));
+	g_mutex_unlock (&module_paths_lock);
+
+	if (so_path == NULL)
+	{
+		g_set_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_LOAD,
+		             "Could not locate the compiled module for '%s'", key);
+		return NULL;
+	}
+
+	module = g_module_open (so_path, G_MODULE_BIND_LAZY | G_MODULE_BIND_LOCAL);
+	if (module == NULL)
+		g_set_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_LOAD,
+		             "Failed to open '%s': %s", so_path, g_module_error ());
+
+	return module;
+}
+
+/* ==========================================================================
+ * Loading
+ * ========================================================================== */
+
 /* Lazily create the GCC compiler + file cache the script ctors require (they
  * assert both are non-NULL).  Returns FALSE on error. */
 static gboolean
@@ -36,26 +178,141 @@ crispy_ensure_toolchain (LrgScriptingCrispy *self, GError **error)
 	return self->cache != NULL;
 }
 
+/* Drops the current module.  The extra GModule handle goes first so that
+ * releasing the script really unloads the object. */
+static void
+crispy_clear_module (LrgScriptingCrispy *self)
+{
+	g_clear_pointer (&self->module, g_module_close);
+	g_clear_object (&self->script);
+	g_hash_table_remove_all (self->symbols);
+	self->generation++;
+}
+
+/*
+ * crispy_load:
+ * @path: source file, or %NULL to compile @code
+ * @code: inline source when @path is %NULL
+ *
+ * Compiles and runs a script, then resolves its module.  Only when every
+ * step succeeds does the new script replace the current one, so a failed
+ * load (or hot reload) leaves the previous module running.
+ */
 static gboolean
-crispy_load_file (LrgScripting  *scripting,
-                  const gchar   *path,
-                  GError       **error)
+crispy_load (LrgScriptingCrispy  *self,
+             const gchar         *path,
+             const gchar         *code,
+             GError             **error)
 {
-	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (scripting);
-	CrispyScript       *script;
+	g_autoptr(GPtrArray) before = NULL;
+	g_autofree gchar    *key = NULL;
+	CrispyScript        *script;
+	GModule             *module;
 
 	if (!crispy_ensure_toolchain (self, error))
 		return FALSE;
-	script = crispy_script_new_from_file (path, CRISPY_COMPILER (self->compiler),
-	                                      CRISPY_CACHE_PROVIDER (self->cache),
-	                                      CRISPY_FLAG_NONE, error);
+
+	before = crispy_loaded_objects ();
+
+	if (path != NULL)
+	{
+		script = crispy_script_new_from_file (path, CRISPY_COMPILER (self->compiler),
+		                                      CRISPY_CACHE_PROVIDER (self->cache),
+		                                      CRISPY_FLAG_NONE, error);
+		key = g_strconcat ("file:", path, NULL);
+	}
+	else
+	{
+		g_autofree gchar *sum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, code, -1);
+
+		script = crispy_script_new_from_inline (code, NULL,
+		                                        CRISPY_COMPILER (self->compiler),
+		                                        CRISPY_CACHE_PROVIDER (self->cache),
+		                                        CRISPY_FLAG_NONE, error);
+		key = g_strconcat ("inline:", sum, NULL);
+	}
 	if (script == NULL)
 		return FALSE;
 
-	g_clear_object (&self->script);
+	if (crispy_script_execute (script, 0, NULL, error) != 0)
+	{
+		if (error != NULL && *error == NULL)
+			g_set_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_RUNTIME,
+			             "Script entry point returned non-zero");
+		g_object_unref (script);
+		return FALSE;
+	}
+
+	module = crispy_open_module (key, before, error);
+	if (module == NULL)
+	{
+		g_object_unref (script);
+		return FALSE;
+	}
+
+	crispy_clear_module (self);
 	self->script = script;
+	self->module = module;
 
-	return crispy_script_execute (self->script, 0, NULL, error) == 0;
+	return TRUE;
+}
+
+static void
+crispy_on_file_changed (GFileMonitor      *monitor,
+                        GFile             *file,
+                        GFile             *other,
+                        GFileMonitorEvent  event,
+                        gpointer           user_data)
+{
+	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (user_data);
+
+	if (event != G_FILE_MONITOR_EVENT_CHANGED
+	    && event != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT
+	    && event != G_FILE_MONITOR_EVENT_CREATED)
+		return;
+
+	g_atomic_int_set (&self->reload_pending, TRUE);
+}
+
+static void
+crispy_update_monitor (LrgScriptingCrispy *self)
+{
+	g_autoptr(GFile) file = NULL;
+
+	if (self->monitor != NULL)
+	{
+		g_signal_handlers_disconnect_by_data (self->monitor, self);
+		g_file_monitor_cancel (self->monitor);
+		g_clear_object (&self->monitor);
+	}
+
+	if (!self->hot_reload || self->path == NULL)
+		return;
+
+	file = g_file_new_for_path (self->path);
+	self->monitor = g_file_monitor_file (file, G_FILE_MONITOR_NONE, NULL, NULL);
+	if (self->monitor != NULL)
+		g_signal_connect (self->monitor, "changed",
+		                  G_CALLBACK (crispy_on_file_changed), self);
+}
+
+static gboolean
+crispy_load_file (LrgScripting  *scripting,
+                  const gchar   *path,
+                  GError       **error)
+{
+	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (scripting);
+	g_autofree gchar   *abs_path = g_canonicalize_filename (path, NULL);
+
+	if (!crispy_load (self, abs_path, NULL, error))
+		return FALSE;
+
+	g_free (self->path);
+	self->path = g_steal_pointer (&abs_path);
+	g_atomic_int_set (&self->reload_pending, FALSE);
+	crispy_update_monitor (self);
+
+	return TRUE;
 }
 
 static gboolean
@@ -65,22 +322,43 @@ crispy_load_string (LrgScripting  *scripting,
                     GError       **error)
 {
 	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (scripting);
-	CrispyScript       *script;
 
 	(void) name;
-	if (!crispy_ensure_toolchain (self, error))
-		return FALSE;
-	script = crispy_script_new_from_inline (code, NULL,
-	                                        CRISPY_COMPILER (self->compiler),
-	                                        CRISPY_CACHE_PROVIDER (self->cache),
-	                                        CRISPY_FLAG_NONE, error);
-	if (script == NULL)
+	if (!crispy_load (self, NULL, code, error))
 		return FALSE;
 
-	g_clear_object (&self->script);
-	self->script = script;
+	g_clear_pointer (&self->path, g_free);
+	g_atomic_int_set (&self->reload_pending, FALSE);
+	crispy_update_monitor (self);
 
-	return crispy_script_execute (self->script, 0, NULL, error) == 0;
+	return TRUE;
+}
+
+/* ==========================================================================
+ * Calls
+ * ========================================================================== */
+
+/* Cached symbol lookup; misses are cached too, so polling an optional hook
+ * every frame costs one hash lookup. */
+static gpointer
+crispy_lookup (LrgScriptingCrispy  *self,
+               const gchar         *name,
+               GError             **error)
+{
+	gpointer symbol = NULL;
+
+	if (!g_hash_table_lookup_extended (self->symbols, name, NULL, &symbol))
+	{
+		if (self->module == NULL || !g_module_symbol (self->module, name, &symbol))
+			symbol = NULL;
+		g_hash_table_insert (self->symbols, g_strdup (name), symbol);
+	}
+
+	if (symbol == NULL)
+		g_set_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_NOT_FOUND,
+		             "Function '%s' not found", name);
+
+	return symbol;
 }
 
 static gboolean
@@ -91,9 +369,54 @@ crispy_call_function (LrgScripting  *scripting,
                       const GValue  *args,
                       GError       **error)
 {
-	/* Crispy scripts execute their entry point at load time and do not expose
-	 * per-function entry points, so lifecycle-hook calls are accepted as
-	 * no-ops (the script's effect already ran on load). */
+	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (scripting);
+	gpointer            fn;
+	GType               type;
+
+	(void) return_value;
+
+	/* The update hook marks a frame boundary: the one point where swapping
+	 * in a rebuilt module cannot tear a frame in half. */
+	if (g_atomic_int_get (&self->reload_pending) &&
+	    g_strcmp0 (func_name, LRG_SCRIPT_HOOK_UPDATE) == 0)
+	{
+		g_autoptr(GError) reload_error = NULL;
+
+		if (!lrg_scripting_crispy_apply_pending_reload (self, &reload_error))
+			lrg_warning (LRG_LOG_DOMAIN_SCRIPTING, "Crispy reload of %s failed: %s",
+			             self->path, reload_error->message);
+	}
+
+	fn = crispy_lookup (self, func_name, error);
+	if (fn == NULL)
+		return FALSE;
+
+	/* GValue arguments map onto the same typed signatures as the
+	 * lrg_scripting_crispy_call_*() fast calls. */
+	type = (n_args == 1) ? G_VALUE_TYPE (&args[0]) : G_TYPE_INVALID;
+
+	if (n_args == 0)
+		((CrispyVoidFunc) fn) ();
+	else if (type == G_TYPE_FLOAT)
+		((CrispyFloatFunc) fn) (g_value_get_float (&args[0]));
+	else if (type == G_TYPE_DOUBLE)
+		((CrispyDoubleFunc) fn) (g_value_get_double (&args[0]));
+	else if (type == G_TYPE_INT)
+		((CrispyIntFunc) fn) (g_value_get_int (&args[0]));
+	else if (type == G_TYPE_BOOLEAN)
+		((CrispyIntFunc) fn) (g_value_get_boolean (&args[0]));
+	else if (type == G_TYPE_POINTER)
+		((CrispyPointerFunc) fn) (g_value_get_pointer (&args[0]));
+	else if (type != G_TYPE_INVALID && G_TYPE_IS_OBJECT (type))
+		((CrispyPointerFunc) fn) (g_value_get_object (&args[0]));
+	else
+	{
+		g_set_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_TYPE,
+		             "Unsupported signature for '%s': crispy calls take at most one "
+		             "float, double, int, pointer or object argument", func_name);
+		return FALSE;
+	}
+
 	return TRUE;
 }
 
@@ -136,7 +459,10 @@ crispy_reset (LrgScripting *scripting)
 {
 	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (scripting);
 
-	g_clear_object (&self->script);
+	crispy_clear_module (self);
+	g_clear_pointer (&self->path, g_free);
+	g_atomic_int_set (&self->reload_pending, FALSE);
+	crispy_update_monitor (self);
 }
 
 static void
@@ -144,7 +470,10 @@ lrg_scripting_crispy_finalize (GObject *object)
 {
 	LrgScriptingCrispy *self = LRG_SCRIPTING_CRISPY (object);
 
-	g_clear_object (&self->script);
+	g_clear_pointer (&self->path, g_free);
+	crispy_update_monitor (self);
+	crispy_clear_module (self);
+	g_clear_pointer (&self->symbols, g_hash_table_unref);
 	g_clear_object (&self->compiler);
 	g_clear_object (&self->cache);
 
@@ -171,7 +500,8 @@ lrg_scripting_crispy_class_init (LrgScriptingCrispyClass *klass)
 static void
 lrg_scripting_crispy_init (LrgScriptingCrispy *self)
 {
-	self->script = NULL;
+	self->script  = NULL;
+	self->symbols = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 }
 
 LrgScriptingCrispy *
@@ -179,3 +509,146 @@ lrg_scripting_crispy_new (void)
 {
 	return g_object_new (LRG_TYPE_SCRIPTING_CRISPY, NULL);
 }
+
+/* ==========================================================================
+ * Native calls and hot reload
+ * ========================================================================== */
+
+gpointer
+lrg_scripting_crispy_lookup_symbol (LrgScriptingCrispy *self,
+                                    const gchar        *name)
+{
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), NULL);
+	g_return_val_if_fail (name != NULL, NULL);
+
+	return crispy_lookup (self, name, NULL);
+}
+
+guint
+lrg_scripting_crispy_get_generation (LrgScriptingCrispy *self)
+{
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), 0);
+
+	return self->generation;
+}
+
+gboolean
+lrg_scripting_crispy_call_void (LrgScriptingCrispy  *self,
+                                const gchar         *name,
+                                GError             **error)
+{
+	CrispyVoidFunc fn;
+
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	fn = (CrispyVoidFunc) crispy_lookup (self, name, error);
+	if (fn == NULL)
+		return FALSE;
+
+	fn ();
+	return TRUE;
+}
+
+gboolean
+lrg_scripting_crispy_call_float (LrgScriptingCrispy  *self,
+                                 const gchar         *name,
+                                 gfloat               value,
+                                 GError             **error)
+{
+	CrispyFloatFunc fn;
+
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	fn = (CrispyFloatFunc) crispy_lookup (self, name, error);
+	if (fn == NULL)
+		return FALSE;
+
+	fn (value);
+	return TRUE;
+}
+
+gboolean
+lrg_scripting_crispy_call_double (LrgScriptingCrispy  *self,
+                                  const gchar         *name,
+                                  gdouble              value,
+                                  GError             **error)
+{
+	CrispyDoubleFunc fn;
+
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	fn = (CrispyDoubleFunc) crispy_lookup (self, name, error);
+	if (fn == NULL)
+		return FALSE;
+
+	fn (value);
+	return TRUE;
+}
+
+gboolean
+lrg_scripting_crispy_call_pointer (LrgScriptingCrispy  *self,
+                                   const gchar         *name,
+                                   gpointer             data,
+                                   GError             **error)
+{
+	CrispyPointerFunc fn;
+
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	fn = (CrispyPointerFunc) crispy_lookup (self, name, error);
+	if (fn == NULL)
+		return FALSE;
+
+	fn (data);
+	return TRUE;
+}
+
+void
+lrg_scripting_crispy_set_hot_reload (LrgScriptingCrispy *self,
+                                     gboolean            enabled)
+{
+	g_return_if_fail (LRG_IS_SCRIPTING_CRISPY (self));
+
+	enabled = !!enabled;
+	if (self->hot_reload == enabled)
+		return;
+
+	self->hot_reload = enabled;
+	crispy_update_monitor (self);
+}
+
+gboolean
+lrg_scripting_crispy_get_hot_reload (LrgScriptingCrispy *self)
+{
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+
+	return self->hot_reload;
+}
+
+gboolean
+lrg_scripting_crispy_is_reload_pending (LrgScriptingCrispy *self)
+{
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+
+	return g_atomic_int_get (&self->reload_pending);
+}
+
+gboolean
+lrg_scripting_crispy_apply_pending_reload (LrgScriptingCrispy  *self,
+                                           GError             **error)
+{
+	g_return_val_if_fail (LRG_IS_SCRIPTING_CRISPY (self), FALSE);
+
+	if (!g_atomic_int_compare_and_exchange (&self->reload_pending, TRUE, FALSE))
+		return TRUE;
+	if (self->path == NULL)
+		return TRUE;
+
+	lrg_debug (LRG_LOG_DOMAIN_SCRIPTING, "Reloading crispy script: %s", self->path);
+
+	return crispy_load (self, self->path, NULL, error);
+}
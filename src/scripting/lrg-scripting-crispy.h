@@ -9,10 +9,21 @@
  * LrgScriptingCrispy is an #LrgScripting backend over the Crispy embedded
  * C-scripting library. Unlike the interpreter backends (Lua/Python/Gjs),
  * Crispy compiles a C source to a shared object and runs its entry point, so
- * this backend maps load_file()/load_string() to "compile and run". Per-function
- * calls and global get/set are not part of Crispy's model and are reported as
- * unsupported. This backend is only built when libregnum is configured with
- * Crispy support (HAS_CRISPY=1 / -DLRG_HAS_CRISPY).
+ * this backend maps load_file()/load_string() to "compile and run".
+ *
+ * After the entry point has run, the compiled module stays loaded and its
+ * exported functions can be called per frame (see #LRG_DEFINE_SCRIPT).
+ * Symbols are resolved once and cached as function pointers.  The
+ * lrg_scripting_crispy_call_*() functions call them through a typed
+ * signature with no #GValue marshalling; lrg_scripting_call_function()
+ * accepts the same signatures (no argument, or one float, double, int,
+ * boolean, pointer or object) and ignores return values.
+ *
+ * With hot reload enabled, a change to the loaded file is recompiled and
+ * swapped in between frames; a failed rebuild keeps the old module running.
+ * Global get/set and registering C functions are not part of Crispy's model
+ * and are reported as unsupported. This backend is only built when libregnum
+ * is configured with Crispy support (HAS_CRISPY=1 / -DLRG_HAS_CRISPY).
  */
 
 #pragma once
@@ -43,4 +54,154 @@ G_DECLARE_FINAL_TYPE (LrgScriptingCrispy, lrg_scripting_crispy, LRG, SCRIPTING_C
 LRG_AVAILABLE_IN_ALL
 LrgScriptingCrispy * lrg_scripting_crispy_new (void);
 
+/**
+ * lrg_scripting_crispy_lookup_symbol:
+ * @self: an #LrgScriptingCrispy
+ * @name: exported symbol name
+ *
+ * Resolves @name in the loaded module.  Lookups, including misses, are
+ * cached until the module changes.
+ *
+ * The pointer is only valid while the current module is loaded; callers
+ * keeping it across frames must re-resolve when
+ * lrg_scripting_crispy_get_generation() changes.
+ *
+ * Returns: (nullable): the symbol address, or %NULL if not exported
+ */
+LRG_AVAILABLE_IN_ALL
+gpointer lrg_scripting_crispy_lookup_symbol (LrgScriptingCrispy *self,
+                                             const gchar        *name);
+
+/**
+ * lrg_scripting_crispy_get_generation:
+ * @self: an #LrgScriptingCrispy
+ *
+ * Gets a counter that increases every time the loaded module is replaced
+ * (load, hot reload or reset).
+ *
+ * Returns: the module generation
+ */
+LRG_AVAILABLE_IN_ALL
+guint lrg_scripting_crispy_get_generation (LrgScriptingCrispy *self);
+
+/**
+ * lrg_scripting_crispy_call_void:
+ * @self: an #LrgScriptingCrispy
+ * @name: exported function, of type `void (void)`
+ * @error: (nullable): return location for error
+ *
+ * Calls @name directly through its cached pointer.
+ *
+ * Returns: %TRUE on success, %FALSE if @name is not exported
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_call_void (LrgScriptingCrispy  *self,
+                                         const gchar         *name,
+                                         GError             **error);
+
+/**
+ * lrg_scripting_crispy_call_float:
+ * @self: an #LrgScriptingCrispy
+ * @name: exported function, of type `void (float)`
+ * @value: the argument
+ * @error: (nullable): return location for error
+ *
+ * Calls @name directly through its cached pointer.
+ *
+ * Returns: %TRUE on success, %FALSE if @name is not exported
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_call_float (LrgScriptingCrispy  *self,
+                                          const gchar         *name,
+                                          gfloat               value,
+                                          GError             **error);
+
+/**
+ * lrg_scripting_crispy_call_double:
+ * @self: an #LrgScriptingCrispy
+ * @name: exported function, of type `void (double)`
+ * @value: the argument
+ * @error: (nullable): return location for error
+ *
+ * Calls @name directly through its cached pointer.  This is the signature
+ * of the #LRG_SCRIPT_HOOK_UPDATE hook.
+ *
+ * Returns: %TRUE on success, %FALSE if @name is not exported
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_call_double (LrgScriptingCrispy  *self,
+                                           const gchar         *name,
+                                           gdouble              value,
+                                           GError             **error);
+
+/**
+ * lrg_scripting_crispy_call_pointer:
+ * @self: an #LrgScriptingCrispy
+ * @name: exported function, of type `void (void *)`
+ * @data: (nullable): the argument
+ * @error: (nullable): return location for error
+ *
+ * Calls @name directly through its cached pointer.
+ *
+ * Returns: %TRUE on success, %FALSE if @name is not exported
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_call_pointer (LrgScriptingCrispy  *self,
+                                            const gchar         *name,
+                                            gpointer             data,
+                                            GError             **error);
+
+/**
+ * lrg_scripting_crispy_set_hot_reload:
+ * @self: an #LrgScriptingCrispy
+ * @enabled: whether to watch the loaded file
+ *
+ * Watches the file passed to lrg_scripting_load_file() for changes.  The
+ * watch is a #GFileMonitor, so the thread-default main context must be
+ * iterated for changes to be noticed.
+ *
+ * A change only marks a reload as pending.  The rebuilt module is swapped
+ * in by lrg_scripting_crispy_apply_pending_reload(), or automatically just
+ * before the next #LRG_SCRIPT_HOOK_UPDATE call made through
+ * lrg_scripting_call_function().  The new module's entry point runs as on a
+ * first load; statics of the old module are not carried over.
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_scripting_crispy_set_hot_reload (LrgScriptingCrispy *self,
+                                          gboolean            enabled);
+
+/**
+ * lrg_scripting_crispy_get_hot_reload:
+ * @self: an #LrgScriptingCrispy
+ *
+ * Returns: %TRUE if the loaded file is being watched
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_get_hot_reload (LrgScriptingCrispy *self);
+
+/**
+ * lrg_scripting_crispy_is_reload_pending:
+ * @self: an #LrgScriptingCrispy
+ *
+ * Returns: %TRUE if the watched file changed since the last (re)load
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_is_reload_pending (LrgScriptingCrispy *self);
+
+/**
+ * lrg_scripting_crispy_apply_pending_reload:
+ * @self: an #LrgScriptingCrispy
+ * @error: (nullable): return location for error
+ *
+ * If a reload is pending, recompiles the watched file and swaps the new
+ * module in.  Call between frames, when no script function is running.
+ * Cached symbols are dropped and the generation increases.
+ *
+ * Returns: %TRUE if nothing was pending or the swap succeeded; %FALSE if
+ *   the rebuild failed, in which case the previous module stays loaded
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_scripting_crispy_apply_pending_reload (LrgScriptingCrispy  *self,
+                                                    GError             **error);
+
 G_END_DECLS
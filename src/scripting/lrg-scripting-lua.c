@@ -23,6 +23,20 @@
 #include <lualib.h>
 #include <lauxlib.h>
 
+/*
+ * UpdateHook:
+ *
+ * A registered update hook. The function is looked up by name once and
+ * then kept as a registry reference, so each frame is a rawgeti instead
+ * of a global table lookup. @ref is LUA_NOREF until resolved and
+ * LUA_REFNIL when the global was not a function.
+ */
+typedef struct
+{
+    gchar *name;
+    gint   ref;
+} UpdateHook;
+
 struct _LrgScriptingLua
 {
     LrgScripting  parent_instance;
@@ -30,7 +44,7 @@ struct _LrgScriptingLua
     lua_State    *L;                /* Main Lua state */
     LrgRegistry  *registry;         /* Type registry (weak ref) */
     LrgEngine    *engine;           /* Engine (weak ref) */
-    GPtrArray    *update_hooks;     /* Array of function names (gchar *) */
+    GPtrArray    *update_hooks;     /* Array of UpdateHook * */
     GPtrArray    *search_paths;     /* Array of search paths (gchar *) */
     gchar        *default_path;     /* Default Lua package path */
 };
@@ -54,6 +68,55 @@ lua_panic (lua_State *L)
     return 0;
 }
 
+static void
+update_hook_free (gpointer data)
+{
+    UpdateHook *hook = data;
+
+    g_free (hook->name);
+    g_free (hook);
+}
+
+/*
+ * Drop the cached function of every update hook. Called whenever the
+ * globals may have been redefined, the next update resolves them again.
+ */
+static void
+invalidate_update_hooks (LrgScriptingLua *self)
+{
+    guint i;
+
+    for (i = 0; i < self->update_hooks->len; i++)
+    {
+        UpdateHook *hook = g_ptr_array_index (self->update_hooks, i);
+
+        if (self->L != NULL)
+            luaL_unref (self->L, LUA_REGISTRYINDEX, hook->ref);
+        hook->ref = LUA_NOREF;
+    }
+}
+
+/*
+ * Look up an update hook's function and cache it in the registry.
+ */
+static void
+resolve_update_hook (LrgScriptingLua *self,
+                     UpdateHook      *hook)
+{
+    lua_getglobal (self->L, hook->name);
+    if (!lua_isfunction (self->L, -1))
+    {
+        lrg_warning (LRG_LOG_DOMAIN_SCRIPTING,
+                     "Update hook '%s' is not a function",
+                     hook->name);
+        lua_pop (self->L, 1);
+        hook->ref = LUA_REFNIL;
+        return;
+    }
+
+    hook->ref = luaL_ref (self->L, LUA_REGISTRYINDEX);
+}
+
 /*
  * Update the Lua package path with custom search paths.
  */
@@ -124,8 +187,9 @@ lrg_scripting_lua_load_file (LrgScripting  *scripting,
         return FALSE;
     }
 
-    /* Execute the loaded chunk */
+    /* Execute the loaded chunk; it may redefine hook functions */
     result = lua_pcall (self->L, 0, 0, 0);
+    invalidate_update_hooks (self);
     if (result != 0)
     {
         const gchar *msg = lua_tostring (self->L, -1);
@@ -170,8 +234,9 @@ lrg_scripting_lua_load_string (LrgScripting  *scripting,
         return FALSE;
     }
 
-    /* Execute the loaded chunk */
+    /* Execute the loaded chunk; it may redefine hook functions */
     result = lua_pcall (self->L, 0, 0, 0);
+    invalidate_update_hooks (self);
     if (result != 0)
     {
         const gchar *msg = lua_tostring (self->L, -1);
@@ -361,6 +426,7 @@ lrg_scripting_lua_register_function (LrgScripting           *scripting,
 
     /* Set as global */
     lua_setglobal (self->L, name);
+    invalidate_update_hooks (self);
 
     lrg_debug (LRG_LOG_DOMAIN_SCRIPTING, "Registered C function: %s", name);
 
@@ -424,6 +490,7 @@ lrg_scripting_lua_set_global (LrgScripting  *scripting,
 
     lrg_lua_push_gvalue (self->L, value);
     lua_setglobal (self->L, name);
+    invalidate_update_hooks (self);
 
     return TRUE;
 }
@@ -440,7 +507,7 @@ lrg_scripting_lua_reset (LrgScripting *scripting)
         self->L = NULL;
     }
 
-    /* Clear update hooks */
+    /* Clear update hooks (their refs died with the old state) */
     g_ptr_array_set_size (self->update_hooks, 0);
 
     /* Create new state */
@@ -519,7 +586,7 @@ lrg_scripting_lua_init (LrgScriptingLua *self)
     self->L = NULL;
     self->registry = NULL;
     self->engine = NULL;
-    self->update_hooks = g_ptr_array_new_with_free_func (g_free);
+    self->update_hooks = g_ptr_array_new_with_free_func (update_hook_free);
     self->search_paths = g_ptr_array_new_with_free_func (g_free);
     self->default_path = NULL;
 
@@ -621,15 +688,26 @@ lrg_scripting_lua_clear_search_paths (LrgScriptingLua *self)
  * @func_name: name of the Lua function to call on update
  *
  * Registers a Lua function to be called each frame.
+ *
+ * The function is resolved on the next update and then called through
+ * a cached reference. Loading code, setting a global or registering a
+ * C function re-resolves every hook; call
+ * lrg_scripting_lua_invalidate_update_hooks() after redefining a hook
+ * any other way.
  */
 void
 lrg_scripting_lua_register_update_hook (LrgScriptingLua *self,
                                         const gchar     *func_name)
 {
+    UpdateHook *hook;
+
     g_return_if_fail (LRG_IS_SCRIPTING_LUA (self));
     g_return_if_fail (func_name != NULL);
 
-    g_ptr_array_add (self->update_hooks, g_strdup (func_name));
+    hook = g_new0 (UpdateHook, 1);
+    hook->name = g_strdup (func_name);
+    hook->ref = LUA_NOREF;
+    g_ptr_array_add (self->update_hooks, hook);
 
     lrg_debug (LRG_LOG_DOMAIN_SCRIPTING, "Registered update hook: %s", func_name);
 }
@@ -654,9 +732,11 @@ lrg_scripting_lua_unregister_update_hook (LrgScriptingLua *self,
 
     for (i = 0; i < self->update_hooks->len; i++)
     {
-        const gchar *name = g_ptr_array_index (self->update_hooks, i);
-        if (g_strcmp0 (name, func_name) == 0)
+        UpdateHook *hook = g_ptr_array_index (self->update_hooks, i);
+        if (g_strcmp0 (hook->name, func_name) == 0)
         {
+            if (self->L != NULL)
+                luaL_unref (self->L, LUA_REGISTRYINDEX, hook->ref);
             g_ptr_array_remove_index (self->update_hooks, i);
             return TRUE;
         }
@@ -676,9 +756,25 @@ lrg_scripting_lua_clear_update_hooks (LrgScriptingLua *self)
 {
     g_return_if_fail (LRG_IS_SCRIPTING_LUA (self));
 
+    invalidate_update_hooks (self);
     g_ptr_array_set_size (self->update_hooks, 0);
 }
 
+/**
+ * lrg_scripting_lua_invalidate_update_hooks:
+ * @self: an #LrgScriptingLua
+ *
+ * Drops the cached functions of all update hooks so the next update
+ * looks them up by name again.
+ */
+void
+lrg_scripting_lua_invalidate_update_hooks (LrgScriptingLua *self)
+{
+    g_return_if_fail (LRG_IS_SCRIPTING_LUA (self));
+
+    invalidate_update_hooks (self);
+}
+
 /**
  * lrg_scripting_lua_update:
  * @self: an #LrgScriptingLua
@@ -697,19 +793,17 @@ lrg_scripting_lua_update (LrgScriptingLua *self,
 
     for (i = 0; i < self->update_hooks->len; i++)
     {
-        const gchar *func_name = g_ptr_array_index (self->update_hooks, i);
-        int          result;
+        UpdateHook *hook = g_ptr_array_index (self->update_hooks, i);
+        int         result;
 
-        /* Get the function */
-        lua_getglobal (self->L, func_name);
-        if (!lua_isfunction (self->L, -1))
-        {
-            lrg_warning (LRG_LOG_DOMAIN_SCRIPTING,
-                         "Update hook '%s' is not a function",
-                         func_name);
-            lua_pop (self->L, 1);
+        if (hook->ref == LUA_NOREF)
+            resolve_update_hook (self, hook);
+
+        /* Not a function; warned once when resolved */
+        if (hook->ref == LUA_REFNIL)
             continue;
-        }
+
+        lua_rawgeti (self->L, LUA_REGISTRYINDEX, hook->ref);
 
         /* Push delta argument */
         lua_pushnumber (self->L, (lua_Number)delta);
@@ -721,7 +815,7 @@ lrg_scripting_lua_update (LrgScriptingLua *self,
             const gchar *msg = lua_tostring (self->L, -1);
             lrg_warning (LRG_LOG_DOMAIN_SCRIPTING,
                          "Update hook '%s' error: %s",
-                         func_name, msg ? msg : "(unknown)");
+                         hook->name, msg ? msg : "(unknown)");
             lua_pop (self->L, 1);
         }
     }
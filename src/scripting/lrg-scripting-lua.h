@@ -123,6 +123,12 @@ void lrg_scripting_lua_clear_search_paths (LrgScriptingLua *self);
  * ```
  *
  * Multiple hooks can be registered and will be called in order.
+ *
+ * The function is resolved on the next update and then called through
+ * a cached reference. Loading code, setting a global or registering a
+ * C function re-resolves every hook; call
+ * lrg_scripting_lua_invalidate_update_hooks() after redefining a hook
+ * any other way.
  */
 LRG_AVAILABLE_IN_ALL
 void lrg_scripting_lua_register_update_hook (LrgScriptingLua *self,
@@ -150,6 +156,16 @@ gboolean lrg_scripting_lua_unregister_update_hook (LrgScriptingLua *self,
 LRG_AVAILABLE_IN_ALL
 void lrg_scripting_lua_clear_update_hooks (LrgScriptingLua *self);
 
+/**
+ * lrg_scripting_lua_invalidate_update_hooks:
+ * @self: an #LrgScriptingLua
+ *
+ * Drops the cached functions of all update hooks so the next update
+ * looks them up by name again.
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_scripting_lua_invalidate_update_hooks (LrgScriptingLua *self);
+
 /**
  * lrg_scripting_lua_update:
  * @self: an #LrgScriptingLua
@@ -17,11 +17,25 @@ typedef struct
     gint h;
 } ClipRect;
 
+typedef struct
+{
+    GrlRectangle src;
+    GrlRectangle dst;
+    GrlColor     tint;
+} GlyphQuad;
+
 struct _Lrg2DSurface
 {
     LrgFrameSurface parent_instance;
     GrlWindow      *window;
     GArray         *clip_stack;  /* ClipRect */
+
+    /* Glyphs queued from one atlas page, drawn together on flush. */
+    GArray         *glyph_run;   /* GlyphQuad */
+    LrgGlyphAtlas  *run_atlas;
+    guint           run_page;
+
+    GPtrArray      *atlases;     /* LrgGlyphAtlas*, drawn from this frame */
 };
 
 static void lrg_2d_surface_text_renderer_init (LrgTextRendererInterface *iface);
@@ -46,11 +60,55 @@ clip_intersect (const ClipRect *a,
     out->h = MAX (0, y1 - y0);
 }
 
+/*
+ * flush_glyph_run:
+ *
+ * Draws the queued glyph run. The page texture is fetched (and its dirty
+ * region uploaded) once for the whole run rather than once per glyph.
+ */
+static void
+flush_glyph_run (Lrg2DSurface *self)
+{
+    GrlTexture *tex;
+    GrlVector2 origin;
+    guint i;
+
+    if (self->glyph_run->len == 0)
+        return;
+
+    tex = lrg_glyph_atlas_get_page_texture (self->run_atlas, self->run_page);
+    if (tex != NULL)
+    {
+        origin.x = 0.0f;
+        origin.y = 0.0f;
+
+        grl_draw_begin_blend_mode (GRL_BLEND_ALPHA);
+        for (i = 0; i < self->glyph_run->len; i++)
+        {
+            GlyphQuad *q = &g_array_index (self->glyph_run, GlyphQuad, i);
+            grl_draw_texture_pro (tex, &q->src, &q->dst, &origin, 0.0f, &q->tint);
+        }
+        grl_draw_end_blend_mode ();
+    }
+
+    g_array_set_size (self->glyph_run, 0);
+    g_clear_object (&self->run_atlas);
+}
+
 static void
 lrg_2d_surface_begin_frame (LrgFrameSurface *surface)
 {
     Lrg2DSurface *self = LRG_2D_SURFACE (surface);
     gint ww, wh;
+    guint i;
+
+    flush_glyph_run (self);
+
+    /* Start a new frame on every atlas drawn from last frame, so their LRU
+       eviction sees which pages are still in use. */
+    for (i = 0; i < self->atlases->len; i++)
+        lrg_glyph_atlas_begin_frame (g_ptr_array_index (self->atlases, i));
+    g_ptr_array_set_size (self->atlases, 0);
 
     if (self->window == NULL)
         return;
@@ -87,6 +145,8 @@ lrg_2d_surface_end_frame (LrgFrameSurface *surface)
     if (self->window == NULL)
         return;
 
+    flush_glyph_run (self);
+
     /* Present via swap_buffers (flush + SwapScreenBuffer), NOT end_drawing:
        end_drawing == EndDrawing() also calls PollInputEvents(), which would
        consume the input queues a second time per cycle and drop keystrokes.
@@ -104,6 +164,7 @@ lrg_2d_surface_clear (LrgFrameSurface *surface,
     if (self->window == NULL || color == NULL)
         return;
 
+    flush_glyph_run (self);
     grl_window_clear_background (self->window, color);
 }
 
@@ -115,7 +176,7 @@ lrg_2d_surface_fill_rect (LrgFrameSurface *surface,
                           gint             height,
                           const GrlColor  *color)
 {
-    (void) surface;
+    flush_glyph_run (LRG_2D_SURFACE (surface));
 
     if (color == NULL)
         return;
@@ -134,7 +195,7 @@ lrg_2d_surface_draw_rect_outline (LrgFrameSurface *surface,
 {
     g_autoptr(GrlRectangle) rect = NULL;
 
-    (void) surface;
+    flush_glyph_run (LRG_2D_SURFACE (surface));
 
     if (color == NULL)
         return;
@@ -155,7 +216,7 @@ lrg_2d_surface_draw_line (LrgFrameSurface *surface,
     g_autoptr(GrlVector2) a = NULL;
     g_autoptr(GrlVector2) b = NULL;
 
-    (void) surface;
+    flush_glyph_run (LRG_2D_SURFACE (surface));
 
     if (color == NULL)
         return;
@@ -175,6 +236,8 @@ lrg_2d_surface_push_clip (LrgFrameSurface *surface,
     Lrg2DSurface *self = LRG_2D_SURFACE (surface);
     ClipRect nr;
 
+    flush_glyph_run (self);
+
     nr.x = x;
     nr.y = y;
     nr.w = width;
@@ -203,6 +266,7 @@ lrg_2d_surface_pop_clip (LrgFrameSurface *surface)
     if (self->clip_stack->len == 0)
         return;
 
+    flush_glyph_run (self);
     grl_draw_end_scissor_mode ();
     g_array_remove_index (self->clip_stack, self->clip_stack->len - 1);
 
@@ -222,15 +286,15 @@ lrg_2d_surface_draw_glyph (LrgFrameSurface   *surface,
                            gfloat             y,
                            const GrlColor    *fg)
 {
+    Lrg2DSurface *self = LRG_2D_SURFACE (surface);
     LrgGlyphMetrics *m;
-    GrlTexture *tex;
+    GlyphQuad q;
+    guint page;
     gint px = 0;
     gint py = 0;
     gint gw = 0;
     gint gh = 0;
 
-    (void) surface;
-
     if (atlas == NULL || key == NULL)
         return;
 
@@ -242,35 +306,42 @@ lrg_2d_surface_draw_glyph (LrgFrameSurface   *surface,
     if (gw <= 0 || gh <= 0)
         return;  /* zero-size glyph (e.g. space) */
 
-    tex = lrg_glyph_atlas_get_page_texture (atlas, lrg_glyph_metrics_get_page (m));
-    if (tex == NULL)
-        return;
-
+    /* Queue the glyph; the run is drawn when the page changes or another
+       primitive needs the glyphs below it. Pages used this frame are never
+       evicted, so the queued rects stay valid until then. */
+    page = lrg_glyph_metrics_get_page (m);
+    if (atlas != self->run_atlas || page != self->run_page)
     {
-        gint bx = lrg_glyph_metrics_get_bearing_x (m);
-        gint by = lrg_glyph_metrics_get_bearing_y (m);
-        g_autoptr(GrlRectangle) src = grl_rectangle_new (px, py, gw, gh);
-        g_autoptr(GrlRectangle) dst =
-            grl_rectangle_new (x + (gfloat) bx, y - (gfloat) by,
-                               (gfloat) gw, (gfloat) gh);
-        g_autoptr(GrlVector2) origin = grl_vector2_new (0.0f, 0.0f);
-        g_autoptr(GrlColor) white = NULL;
-        const GrlColor *tint;
-
-        if (lrg_glyph_metrics_get_is_color (m) || fg == NULL)
-        {
-            white = grl_color_new_white ();
-            tint = white;
-        }
-        else
-        {
-            tint = fg;
-        }
+        flush_glyph_run (self);
+        self->run_atlas = g_object_ref (atlas);
+        self->run_page = page;
 
-        grl_draw_begin_blend_mode (GRL_BLEND_ALPHA);
-        grl_draw_texture_pro (tex, src, dst, origin, 0.0f, tint);
-        grl_draw_end_blend_mode ();
+        if (!g_ptr_array_find (self->atlases, atlas, NULL))
+            g_ptr_array_add (self->atlases, g_object_ref (atlas));
+    }
+
+    q.src.x = (gfloat) px;
+    q.src.y = (gfloat) py;
+    q.src.width = (gfloat) gw;
+    q.src.height = (gfloat) gh;
+    q.dst.x = x + (gfloat) lrg_glyph_metrics_get_bearing_x (m);
+    q.dst.y = y - (gfloat) lrg_glyph_metrics_get_bearing_y (m);
+    q.dst.width = (gfloat) gw;
+    q.dst.height = (gfloat) gh;
+
+    if (lrg_glyph_metrics_get_is_color (m) || fg == NULL)
+    {
+        q.tint.r = 255;
+        q.tint.g = 255;
+        q.tint.b = 255;
+        q.tint.a = 255;
+    }
+    else
+    {
+        q.tint = *fg;
     }
+
+    g_array_append_val (self->glyph_run, q);
 }
 
 static void
@@ -288,7 +359,7 @@ lrg_2d_surface_draw_texture_region (LrgFrameSurface    *surface,
     g_autoptr(GrlColor) white = NULL;
     const GrlColor *t = tint;
 
-    (void) surface;
+    flush_glyph_run (LRG_2D_SURFACE (surface));
 
     if (texture == NULL || src == NULL)
         return;
@@ -370,6 +441,13 @@ lrg_2d_surface_get_window (Lrg2DSurface *self)
     return self->window;
 }
 
+void
+lrg_2d_surface_flush (Lrg2DSurface *self)
+{
+    g_return_if_fail (LRG_IS_2D_SURFACE (self));
+    flush_glyph_run (self);
+}
+
 static void
 lrg_2d_surface_finalize (GObject *object)
 {
@@ -377,6 +455,9 @@ lrg_2d_surface_finalize (GObject *object)
 
     g_clear_object (&self->window);
     g_clear_pointer (&self->clip_stack, g_array_unref);
+    g_clear_pointer (&self->glyph_run, g_array_unref);
+    g_clear_object (&self->run_atlas);
+    g_clear_pointer (&self->atlases, g_ptr_array_unref);
 
     G_OBJECT_CLASS (lrg_2d_surface_parent_class)->finalize (object);
 }
@@ -408,4 +489,8 @@ lrg_2d_surface_init (Lrg2DSurface *self)
 {
     self->window = NULL;
     self->clip_stack = g_array_new (FALSE, FALSE, sizeof (ClipRect));
+    self->glyph_run = g_array_new (FALSE, FALSE, sizeof (GlyphQuad));
+    self->run_atlas = NULL;
+    self->run_page = 0;
+    self->atlases = g_ptr_array_new_with_free_func (g_object_unref);
 }
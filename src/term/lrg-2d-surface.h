@@ -57,4 +57,17 @@ Lrg2DSurface * lrg_2d_surface_new (gint         width,
 LRG_AVAILABLE_IN_ALL
 GrlWindow * lrg_2d_surface_get_window (Lrg2DSurface *self);
 
+/**
+ * lrg_2d_surface_flush:
+ * @self: a #Lrg2DSurface
+ *
+ * Draws any queued glyphs. Glyphs from one atlas page are batched and drawn
+ * when the page changes or another primitive is drawn; call this before
+ * reading back the framebuffer directly.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_2d_surface_flush (Lrg2DSurface *self);
+
 G_END_DECLS
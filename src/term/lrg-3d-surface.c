@@ -325,8 +325,10 @@ lrg_3d_surface_end_content (LrgFrameSurface *surface)
 	w = lrg_frame_surface_get_width (surface);
 	h = lrg_frame_surface_get_height (surface);
 
-	/* raylib batches draws; a scissor begin/end forces the flush so the
-	   readback sees the flat frame we just rasterised. */
+	/* Draw the content surface's queued glyphs, then force raylib's own
+	   batch out (a scissor begin/end flushes it) so the readback sees the
+	   flat frame we just rasterised. */
+	lrg_2d_surface_flush (self->content);
 	grl_draw_begin_scissor_mode (0, 0, w, h);
 	grl_draw_end_scissor_mode ();
 
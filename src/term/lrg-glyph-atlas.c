@@ -8,24 +8,60 @@
 #include "config.h"
 #include "lrg-glyph-atlas.h"
 
+#include <string.h>
+
 /* Padding between packed glyphs, in pixels, to stop bilinear bleed. */
 #define LRG_ATLAS_PAD 1
 
+/* Bytes per RGBA8 pixel. */
+#define LRG_ATLAS_BPP 4
+
+/*
+ * One segment of a page's skyline: the top edge of the packed area spans
+ * [x, x + width) at height y. Segments are sorted by x and cover the page.
+ */
 typedef struct
 {
-    GrlTexture *texture;   /* NULL until first upload to this page */
-    gint        shelf_x;
-    gint        shelf_y;
-    gint        shelf_h;
+    gint x;
+    gint y;
+    gint width;
+} SkylineNode;
+
+typedef struct
+{
+    GrlTexture *texture;   /* NULL until the first flush of this page */
+    guint8     *pixels;    /* CPU copy of the page, NULL until first upload */
+    GArray     *skyline;   /* SkylineNode, left to right */
+    GPtrArray  *glyphs;    /* GlyphEntry* with ink on this page */
+    guint64     last_used; /* frame stamp of the newest glyph use */
+
+    /* Pixels written since the last upload, x1 <= x0 when clean. */
+    gint        dirty_x0;
+    gint        dirty_y0;
+    gint        dirty_x1;
+    gint        dirty_y1;
 } AtlasPage;
 
+typedef struct
+{
+    LrgGlyphKey     *key;       /* borrowed from the glyph table */
+    LrgGlyphMetrics *metrics;
+    guint64          last_used; /* frame stamp */
+    gboolean         on_page;   /* FALSE for zero-size glyphs */
+} GlyphEntry;
+
 struct _LrgGlyphAtlas
 {
     GObject     parent_instance;
     gint        page_w;
     gint        page_h;
+    guint       max_pages; /* 0 = unlimited */
+    guint64     frame;
     GPtrArray  *pages;     /* AtlasPage* */
-    GHashTable *glyphs;    /* LrgGlyphKey* -> LrgGlyphMetrics* */
+    GHashTable *glyphs;    /* LrgGlyphKey* -> GlyphEntry* */
+
+    guint8     *upload_buf; /* scratch rows for partial-width uploads */
+    gsize       upload_buf_size;
 };
 
 G_DEFINE_TYPE (LrgGlyphAtlas, lrg_glyph_atlas, G_TYPE_OBJECT)
@@ -35,18 +71,29 @@ enum
     PROP_0,
     PROP_PAGE_WIDTH,
     PROP_PAGE_HEIGHT,
+    PROP_MAX_PAGES,
     N_PROPS
 };
 
 enum
 {
     SIGNAL_PAGE_ADDED,
+    SIGNAL_PAGE_EVICTED,
     N_SIGNALS
 };
 
 static GParamSpec *properties[N_PROPS];
 static guint signals[N_SIGNALS];
 
+static void
+glyph_entry_free (gpointer data)
+{
+    GlyphEntry *entry = data;
+
+    lrg_glyph_metrics_free (entry->metrics);
+    g_free (entry);
+}
+
 static void
 atlas_page_free (gpointer data)
 {
@@ -56,9 +103,44 @@ atlas_page_free (gpointer data)
         return;
 
     g_clear_object (&page->texture);
+    g_clear_pointer (&page->pixels, g_free);
+    g_clear_pointer (&page->skyline, g_array_unref);
+    g_clear_pointer (&page->glyphs, g_ptr_array_unref);
     g_free (page);
 }
 
+static void
+page_reset_skyline (AtlasPage *page,
+                    gint       pw)
+{
+    SkylineNode node = { LRG_ATLAS_PAD, LRG_ATLAS_PAD, pw - LRG_ATLAS_PAD };
+
+    g_array_set_size (page->skyline, 0);
+    g_array_append_val (page->skyline, node);
+}
+
+static void
+page_mark_dirty (AtlasPage *page,
+                 gint       x,
+                 gint       y,
+                 gint       w,
+                 gint       h)
+{
+    if (page->dirty_x1 <= page->dirty_x0)
+    {
+        page->dirty_x0 = x;
+        page->dirty_y0 = y;
+        page->dirty_x1 = x + w;
+        page->dirty_y1 = y + h;
+        return;
+    }
+
+    page->dirty_x0 = MIN (page->dirty_x0, x);
+    page->dirty_y0 = MIN (page->dirty_y0, y);
+    page->dirty_x1 = MAX (page->dirty_x1, x + w);
+    page->dirty_y1 = MAX (page->dirty_y1, y + h);
+}
+
 static guint
 atlas_add_page (LrgGlyphAtlas *self)
 {
@@ -66,9 +148,11 @@ atlas_add_page (LrgGlyphAtlas *self)
     guint idx;
 
     page->texture = NULL;
-    page->shelf_x = LRG_ATLAS_PAD;
-    page->shelf_y = LRG_ATLAS_PAD;
-    page->shelf_h = 0;
+    page->pixels = NULL;
+    page->skyline = g_array_new (FALSE, FALSE, sizeof (SkylineNode));
+    page->glyphs = g_ptr_array_new ();
+    page->last_used = self->frame;
+    page_reset_skyline (page, self->page_w);
 
     g_ptr_array_add (self->pages, page);
     idx = self->pages->len - 1;
@@ -78,6 +162,107 @@ atlas_add_page (LrgGlyphAtlas *self)
     return idx;
 }
 
+/*
+ * skyline_fit:
+ *
+ * Returns the y at which a @w x @h box whose left edge sits at node @i
+ * rests on the skyline, or -1 if it runs off the page.
+ */
+static gint
+skyline_fit (AtlasPage *page,
+             guint      i,
+             gint       pw,
+             gint       ph,
+             gint       w,
+             gint       h)
+{
+    gint x = g_array_index (page->skyline, SkylineNode, i).x;
+    gint remaining = w;
+    gint y = 0;
+
+    if (x + w > pw)
+        return -1;
+
+    while (remaining > 0)
+    {
+        const SkylineNode *node;
+
+        if (i >= page->skyline->len)
+            return -1;
+
+        node = &g_array_index (page->skyline, SkylineNode, i);
+        y = MAX (y, node->y);
+        if (y + h > ph)
+            return -1;
+
+        remaining -= node->width;
+        i++;
+    }
+
+    return y;
+}
+
+/*
+ * skyline_insert:
+ *
+ * Raises the skyline over [x, x + w) to y + h: inserts a node at @i,
+ * trims the nodes it now covers and merges equal-height neighbours.
+ */
+static void
+skyline_insert (AtlasPage *page,
+                guint      i,
+                gint       x,
+                gint       y,
+                gint       w,
+                gint       h)
+{
+    SkylineNode node = { x, y + h, w };
+    guint j;
+
+    g_array_insert_val (page->skyline, i, node);
+
+    j = i + 1;
+    while (j < page->skyline->len)
+    {
+        SkylineNode *prev = &g_array_index (page->skyline, SkylineNode, j - 1);
+        SkylineNode *cur = &g_array_index (page->skyline, SkylineNode, j);
+        gint overlap = prev->x + prev->width - cur->x;
+
+        if (overlap <= 0)
+            break;
+
+        cur->x += overlap;
+        cur->width -= overlap;
+        if (cur->width > 0)
+            break;
+
+        g_array_remove_index (page->skyline, j);
+    }
+
+    j = 0;
+    while (j + 1 < page->skyline->len)
+    {
+        SkylineNode *cur = &g_array_index (page->skyline, SkylineNode, j);
+        SkylineNode *next = &g_array_index (page->skyline, SkylineNode, j + 1);
+
+        if (cur->y == next->y)
+        {
+            cur->width += next->width;
+            g_array_remove_index (page->skyline, j + 1);
+        }
+        else
+        {
+            j++;
+        }
+    }
+}
+
+/*
+ * page_try_place:
+ *
+ * Bottom-left skyline placement: of every position along the skyline,
+ * picks the one whose top edge ends lowest, leftmost on ties.
+ */
 static gboolean
 page_try_place (AtlasPage *page,
                 gint       pw,
@@ -87,34 +272,245 @@ page_try_place (AtlasPage *page,
                 gint      *ox,
                 gint      *oy)
 {
+    gint best_top = G_MAXINT;
+    gint best_x = 0;
+    gint best_y = 0;
+    guint best_i = 0;
+    gint pw_box;
+    gint ph_box;
+    guint i;
+
     /* Zero-size glyphs (e.g. space) take no atlas room. */
     if (w <= 0 || h <= 0)
     {
-        *ox = page->shelf_x;
-        *oy = page->shelf_y;
+        *ox = LRG_ATLAS_PAD;
+        *oy = LRG_ATLAS_PAD;
         return TRUE;
     }
 
-    /* Wrap to a new shelf if the glyph won't fit on the current one. */
-    if (page->shelf_x + w + LRG_ATLAS_PAD > pw)
+    /* Every box carries its right and bottom padding. */
+    pw_box = w + LRG_ATLAS_PAD;
+    ph_box = h + LRG_ATLAS_PAD;
+
+    for (i = 0; i < page->skyline->len; i++)
     {
-        page->shelf_y += page->shelf_h + LRG_ATLAS_PAD;
-        page->shelf_x = LRG_ATLAS_PAD;
-        page->shelf_h = 0;
+        gint y = skyline_fit (page, i, pw, ph, pw_box, ph_box);
+
+        if (y >= 0 && y + ph_box < best_top)
+        {
+            best_top = y + ph_box;
+            best_x = g_array_index (page->skyline, SkylineNode, i).x;
+            best_y = y;
+            best_i = i;
+        }
     }
 
-    if (page->shelf_y + h + LRG_ATLAS_PAD > ph)
+    if (best_top == G_MAXINT)
         return FALSE;
 
-    *ox = page->shelf_x;
-    *oy = page->shelf_y;
-    page->shelf_x += w + LRG_ATLAS_PAD;
-    if (h > page->shelf_h)
-        page->shelf_h = h;
+    skyline_insert (page, best_i, best_x, best_y, pw_box, ph_box);
+
+    *ox = best_x;
+    *oy = best_y;
 
     return TRUE;
 }
 
+static void
+atlas_set_uv (LrgGlyphAtlas   *self,
+              LrgGlyphMetrics *metrics,
+              gint             x,
+              gint             y,
+              gint             w,
+              gint             h)
+{
+    lrg_glyph_metrics_set_uv (metrics,
+                              (gfloat) x / (gfloat) self->page_w,
+                              (gfloat) y / (gfloat) self->page_h,
+                              (gfloat) (x + w) / (gfloat) self->page_w,
+                              (gfloat) (y + h) / (gfloat) self->page_h);
+}
+
+static void
+page_write_pixels (LrgGlyphAtlas *self,
+                   AtlasPage     *page,
+                   const guint8  *pixels,
+                   gint           x,
+                   gint           y,
+                   gint           w,
+                   gint           h)
+{
+    gsize stride = (gsize) self->page_w * LRG_ATLAS_BPP;
+    gsize row = (gsize) w * LRG_ATLAS_BPP;
+    gint r;
+
+    if (page->pixels == NULL)
+        page->pixels = g_malloc0 (stride * (gsize) self->page_h);
+
+    for (r = 0; r < h; r++)
+        memcpy (page->pixels + (gsize) (y + r) * stride + (gsize) x * LRG_ATLAS_BPP,
+                pixels + (gsize) r * row, row);
+
+    page_mark_dirty (page, x, y, w, h);
+}
+
+/*
+ * atlas_repack_page:
+ *
+ * Evicts the glyphs on page @idx that were not used in the page's most
+ * recent frame, then repacks the rest tallest first. Glyphs that no
+ * longer fit are evicted too. Returns the number of glyphs removed.
+ */
+static guint
+atlas_repack_page (LrgGlyphAtlas *self,
+                   guint          idx,
+                   gboolean       keep_recent)
+{
+    AtlasPage *page = g_ptr_array_index (self->pages, idx);
+    g_autoptr(GPtrArray) survivors = g_ptr_array_new ();
+    g_autofree guint8 *saved = NULL;
+    g_autofree gsize *offsets = NULL;
+    gsize saved_size = 0;
+    guint removed = 0;
+    guint i;
+
+    for (i = 0; i < page->glyphs->len; i++)
+    {
+        GlyphEntry *entry = g_ptr_array_index (page->glyphs, i);
+
+        if (keep_recent && entry->last_used >= page->last_used)
+        {
+            g_ptr_array_add (survivors, entry);
+        }
+        else
+        {
+            g_hash_table_remove (self->glyphs, entry->key);
+            removed++;
+        }
+    }
+    g_ptr_array_set_size (page->glyphs, 0);
+
+    /* Tallest first packs densest on a skyline. */
+    for (i = 1; i < survivors->len; i++)
+    {
+        GlyphEntry *entry = g_ptr_array_index (survivors, i);
+        gint h;
+        guint j = i;
+
+        lrg_glyph_metrics_get_rect (entry->metrics, NULL, NULL, NULL, &h);
+        while (j > 0)
+        {
+            GlyphEntry *prev = g_ptr_array_index (survivors, j - 1);
+            gint prev_h;
+
+            lrg_glyph_metrics_get_rect (prev->metrics, NULL, NULL, NULL, &prev_h);
+            if (prev_h >= h)
+                break;
+            survivors->pdata[j] = prev;
+            j--;
+        }
+        survivors->pdata[j] = entry;
+    }
+
+    /* Stash surviving ink before the page is cleared. */
+    if (page->pixels != NULL && survivors->len > 0)
+    {
+        gsize stride = (gsize) self->page_w * LRG_ATLAS_BPP;
+
+        offsets = g_new (gsize, survivors->len);
+        for (i = 0; i < survivors->len; i++)
+        {
+            GlyphEntry *entry = g_ptr_array_index (survivors, i);
+            gint w;
+            gint h;
+
+            lrg_glyph_metrics_get_rect (entry->metrics, NULL, NULL, &w, &h);
+            offsets[i] = saved_size;
+            saved_size += (gsize) w * (gsize) h * LRG_ATLAS_BPP;
+        }
+
+        saved = g_malloc (MAX (saved_size, 1));
+        for (i = 0; i < survivors->len; i++)
+        {
+            GlyphEntry *entry = g_ptr_array_index (survivors, i);
+            gint x;
+            gint y;
+            gint w;
+            gint h;
+            gint r;
+
+            lrg_glyph_metrics_get_rect (entry->metrics, &x, &y, &w, &h);
+            for (r = 0; r < h; r++)
+                memcpy (saved + offsets[i] + (gsize) r * (gsize) w * LRG_ATLAS_BPP,
+                        page->pixels + (gsize) (y + r) * stride + (gsize) x * LRG_ATLAS_BPP,
+                        (gsize) w * LRG_ATLAS_BPP);
+        }
+    }
+
+    if (page->pixels != NULL)
+    {
+        memset (page->pixels, 0,
+                (gsize) self->page_w * (gsize) self->page_h * LRG_ATLAS_BPP);
+        page_mark_dirty (page, 0, 0, self->page_w, self->page_h);
+    }
+
+    page_reset_skyline (page, self->page_w);
+
+    for (i = 0; i < survivors->len; i++)
+    {
+        GlyphEntry *entry = g_ptr_array_index (survivors, i);
+        gint w;
+        gint h;
+        gint x = 0;
+        gint y = 0;
+
+        lrg_glyph_metrics_get_rect (entry->metrics, NULL, NULL, &w, &h);
+        if (!page_try_place (page, self->page_w, self->page_h, w, h, &x, &y))
+        {
+            g_hash_table_remove (self->glyphs, entry->key);
+            removed++;
+            continue;
+        }
+
+        lrg_glyph_metrics_set_position (entry->metrics, idx, x, y);
+        atlas_set_uv (self, entry->metrics, x, y, w, h);
+        if (saved != NULL)
+            page_write_pixels (self, page, saved + offsets[i], x, y, w, h);
+        g_ptr_array_add (page->glyphs, entry);
+    }
+
+    g_signal_emit (self, signals[SIGNAL_PAGE_EVICTED], 0, idx);
+
+    return removed;
+}
+
+/*
+ * atlas_find_lru_page:
+ *
+ * Returns the index of the least recently used page, or -1 if every
+ * page was used this frame (its glyphs may already be queued for drawing).
+ */
+static gint
+atlas_find_lru_page (LrgGlyphAtlas *self)
+{
+    gint best = -1;
+    guint64 best_used = self->frame;
+    guint i;
+
+    for (i = 0; i < self->pages->len; i++)
+    {
+        AtlasPage *page = g_ptr_array_index (self->pages, i);
+
+        if (page->last_used < best_used)
+        {
+            best_used = page->last_used;
+            best = (gint) i;
+        }
+    }
+
+    return best;
+}
+
 static GrlTexture *
 ensure_page_texture (LrgGlyphAtlas *self,
                      AtlasPage     *page)
@@ -134,6 +530,78 @@ ensure_page_texture (LrgGlyphAtlas *self,
     return page->texture;
 }
 
+/*
+ * atlas_flush_page:
+ *
+ * Uploads everything written to the page since the last flush as one
+ * sub-image update covering the dirty rectangle.
+ */
+static void
+atlas_flush_page (LrgGlyphAtlas *self,
+                  AtlasPage     *page)
+{
+    g_autoptr(GrlRectangle) rect = NULL;
+    GrlTexture *tex;
+    gsize stride;
+    gsize row;
+    gint w;
+    gint h;
+    gint r;
+
+    if (page->dirty_x1 <= page->dirty_x0 || page->pixels == NULL)
+        return;
+
+    tex = ensure_page_texture (self, page);
+    if (tex == NULL)
+        return;
+
+    w = page->dirty_x1 - page->dirty_x0;
+    h = page->dirty_y1 - page->dirty_y0;
+    stride = (gsize) self->page_w * LRG_ATLAS_BPP;
+    row = (gsize) w * LRG_ATLAS_BPP;
+    rect = grl_rectangle_new (page->dirty_x0, page->dirty_y0, w, h);
+
+    if (w == self->page_w)
+    {
+        /* Full rows are already contiguous in the page copy. */
+        grl_texture_update_rec (tex, rect,
+                                page->pixels + (gsize) page->dirty_y0 * stride);
+    }
+    else
+    {
+        if (self->upload_buf_size < row * (gsize) h)
+        {
+            self->upload_buf_size = row * (gsize) h;
+            self->upload_buf = g_realloc (self->upload_buf, self->upload_buf_size);
+        }
+
+        for (r = 0; r < h; r++)
+            memcpy (self->upload_buf + (gsize) r * row,
+                    page->pixels + (gsize) (page->dirty_y0 + r) * stride
+                    + (gsize) page->dirty_x0 * LRG_ATLAS_BPP,
+                    row);
+
+        grl_texture_update_rec (tex, rect, self->upload_buf);
+    }
+
+    page->dirty_x0 = page->dirty_x1 = 0;
+    page->dirty_y0 = page->dirty_y1 = 0;
+}
+
+static void
+atlas_touch (LrgGlyphAtlas *self,
+             GlyphEntry    *entry)
+{
+    entry->last_used = self->frame;
+
+    if (entry->on_page)
+    {
+        AtlasPage *page = g_ptr_array_index (self->pages,
+                                             lrg_glyph_metrics_get_page (entry->metrics));
+        page->last_used = self->frame;
+    }
+}
+
 LrgGlyphAtlas *
 lrg_glyph_atlas_new (gint page_width,
                      gint page_height)
@@ -156,9 +624,11 @@ lrg_glyph_atlas_reserve (LrgGlyphAtlas *self,
                          gint          *out_y)
 {
     AtlasPage *page;
-    guint idx;
+    gboolean placed = FALSE;
+    guint idx = 0;
     gint x = 0;
     gint y = 0;
+    guint i;
 
     g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), FALSE);
 
@@ -171,10 +641,52 @@ lrg_glyph_atlas_reserve (LrgGlyphAtlas *self,
     if (self->pages->len == 0)
         atlas_add_page (self);
 
-    idx = self->pages->len - 1;
-    page = g_ptr_array_index (self->pages, idx);
+    if (width <= 0 || height <= 0)
+    {
+        idx = self->pages->len - 1;
+        page = g_ptr_array_index (self->pages, idx);
+        placed = page_try_place (page, self->page_w, self->page_h,
+                                 width, height, &x, &y);
+    }
 
-    if (!page_try_place (page, self->page_w, self->page_h, width, height, &x, &y))
+    for (i = 0; i < self->pages->len && !placed; i++)
+    {
+        page = g_ptr_array_index (self->pages, i);
+        if (page_try_place (page, self->page_w, self->page_h,
+                            width, height, &x, &y))
+        {
+            idx = i;
+            placed = TRUE;
+        }
+    }
+
+    /* Over budget: recycle the least recently used page. */
+    if (!placed && self->max_pages > 0 && self->pages->len >= self->max_pages)
+    {
+        gint lru = atlas_find_lru_page (self);
+
+        if (lru >= 0)
+        {
+            idx = (guint) lru;
+            page = g_ptr_array_index (self->pages, idx);
+
+            atlas_repack_page (self, idx, TRUE);
+            placed = page_try_place (page, self->page_w, self->page_h,
+                                     width, height, &x, &y);
+            if (!placed)
+            {
+                atlas_repack_page (self, idx, FALSE);
+                placed = page_try_place (page, self->page_w, self->page_h,
+                                         width, height, &x, &y);
+            }
+        }
+    }
+
+    /*
+     * Under budget, or every page is in use this frame: grow. The budget
+     * is soft within a frame so glyphs already queued for drawing never move.
+     */
+    if (!placed)
     {
         idx = atlas_add_page (self);
         page = g_ptr_array_index (self->pages, idx);
@@ -204,7 +716,7 @@ lrg_glyph_atlas_upload (LrgGlyphAtlas     *self,
                         gint               advance,
                         gboolean           is_color)
 {
-    LrgGlyphMetrics *metrics;
+    GlyphEntry *entry;
     guint page_idx = 0;
     gint x = 0;
     gint y = 0;
@@ -212,45 +724,57 @@ lrg_glyph_atlas_upload (LrgGlyphAtlas     *self,
     g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), NULL);
     g_return_val_if_fail (key != NULL, NULL);
 
-    metrics = g_hash_table_lookup (self->glyphs, key);
-    if (metrics != NULL)
-        return metrics;
+    entry = g_hash_table_lookup (self->glyphs, key);
+    if (entry != NULL)
+    {
+        atlas_touch (self, entry);
+        return entry->metrics;
+    }
 
     if (!lrg_glyph_atlas_reserve (self, width, height, &page_idx, &x, &y))
         return NULL;
 
-    if (pixels != NULL && width > 0 && height > 0)
+    entry = g_new0 (GlyphEntry, 1);
+    entry->metrics = lrg_glyph_metrics_new (page_idx, x, y, width, height,
+                                            bearing_x, bearing_y, advance,
+                                            is_color);
+    entry->key = lrg_glyph_key_copy (key);
+    entry->on_page = (width > 0 && height > 0);
+    g_hash_table_insert (self->glyphs, entry->key, entry);
+
+    if (entry->on_page)
     {
         AtlasPage *page = g_ptr_array_index (self->pages, page_idx);
-        GrlTexture *tex = ensure_page_texture (self, page);
-        g_autoptr(GrlRectangle) rect = grl_rectangle_new (x, y, width, height);
 
-        if (tex != NULL)
-            grl_texture_update_rec (tex, rect, pixels);
-    }
+        atlas_set_uv (self, entry->metrics, x, y, width, height);
+        g_ptr_array_add (page->glyphs, entry);
 
-    metrics = lrg_glyph_metrics_new (page_idx, x, y, width, height,
-                                     bearing_x, bearing_y, advance, is_color);
-    if (width > 0 && height > 0)
-        lrg_glyph_metrics_set_uv (metrics,
-                                  (gfloat) x / (gfloat) self->page_w,
-                                  (gfloat) y / (gfloat) self->page_h,
-                                  (gfloat) (x + width) / (gfloat) self->page_w,
-                                  (gfloat) (y + height) / (gfloat) self->page_h);
+        /* Staged in the page copy; uploaded on the next flush. */
+        if (pixels != NULL)
+            page_write_pixels (self, page, pixels, x, y, width, height);
+    }
 
-    g_hash_table_insert (self->glyphs, lrg_glyph_key_copy (key), metrics);
+    atlas_touch (self, entry);
 
-    return metrics;
+    return entry->metrics;
 }
 
 LrgGlyphMetrics *
 lrg_glyph_atlas_lookup (LrgGlyphAtlas     *self,
                         const LrgGlyphKey *key)
 {
+    GlyphEntry *entry;
+
     g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), NULL);
     g_return_val_if_fail (key != NULL, NULL);
 
-    return g_hash_table_lookup (self->glyphs, key);
+    entry = g_hash_table_lookup (self->glyphs, key);
+    if (entry == NULL)
+        return NULL;
+
+    atlas_touch (self, entry);
+
+    return entry->metrics;
 }
 
 GrlTexture *
@@ -265,9 +789,83 @@ lrg_glyph_atlas_get_page_texture (LrgGlyphAtlas *self,
         return NULL;
 
     p = g_ptr_array_index (self->pages, page);
+    atlas_flush_page (self, p);
+
     return p->texture;
 }
 
+void
+lrg_glyph_atlas_flush (LrgGlyphAtlas *self)
+{
+    guint i;
+
+    g_return_if_fail (LRG_IS_GLYPH_ATLAS (self));
+
+    for (i = 0; i < self->pages->len; i++)
+        atlas_flush_page (self, g_ptr_array_index (self->pages, i));
+}
+
+void
+lrg_glyph_atlas_begin_frame (LrgGlyphAtlas *self)
+{
+    g_return_if_fail (LRG_IS_GLYPH_ATLAS (self));
+
+    self->frame++;
+}
+
+guint64
+lrg_glyph_atlas_get_frame (LrgGlyphAtlas *self)
+{
+    g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), 0);
+    return self->frame;
+}
+
+gboolean
+lrg_glyph_atlas_get_dirty_rect (LrgGlyphAtlas *self,
+                                guint          page,
+                                gint          *out_x,
+                                gint          *out_y,
+                                gint          *out_w,
+                                gint          *out_h)
+{
+    AtlasPage *p;
+
+    g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), FALSE);
+
+    if (page >= self->pages->len)
+        return FALSE;
+
+    p = g_ptr_array_index (self->pages, page);
+    if (p->dirty_x1 <= p->dirty_x0)
+        return FALSE;
+
+    if (out_x != NULL)
+        *out_x = p->dirty_x0;
+    if (out_y != NULL)
+        *out_y = p->dirty_y0;
+    if (out_w != NULL)
+        *out_w = p->dirty_x1 - p->dirty_x0;
+    if (out_h != NULL)
+        *out_h = p->dirty_y1 - p->dirty_y0;
+
+    return TRUE;
+}
+
+const guint8 *
+lrg_glyph_atlas_get_page_pixels (LrgGlyphAtlas *self,
+                                 guint          page)
+{
+    AtlasPage *p;
+
+    g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), NULL);
+
+    if (page >= self->pages->len)
+        return NULL;
+
+    p = g_ptr_array_index (self->pages, page);
+    return p->pixels;
+}
+
 guint
 lrg_glyph_atlas_get_page_count (LrgGlyphAtlas *self)
 {
@@ -296,6 +894,26 @@ lrg_glyph_atlas_get_page_height (LrgGlyphAtlas *self)
     return self->page_h;
 }
 
+guint
+lrg_glyph_atlas_get_max_pages (LrgGlyphAtlas *self)
+{
+    g_return_val_if_fail (LRG_IS_GLYPH_ATLAS (self), 0);
+    return self->max_pages;
+}
+
+void
+lrg_glyph_atlas_set_max_pages (LrgGlyphAtlas *self,
+                               guint          max_pages)
+{
+    g_return_if_fail (LRG_IS_GLYPH_ATLAS (self));
+
+    if (self->max_pages == max_pages)
+        return;
+
+    self->max_pages = max_pages;
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MAX_PAGES]);
+}
+
 guint
 lrg_glyph_atlas_evict_font (LrgGlyphAtlas *self,
                             guint64        font_id)
@@ -311,9 +929,17 @@ lrg_glyph_atlas_evict_font (LrgGlyphAtlas *self,
     while (g_hash_table_iter_next (&iter, &k, &v))
     {
         const LrgGlyphKey *key = k;
+        GlyphEntry *entry = v;
 
         if (lrg_glyph_key_get_font_id (key) == font_id)
         {
+            if (entry->on_page)
+            {
+                AtlasPage *page = g_ptr_array_index (self->pages,
+                                                     lrg_glyph_metrics_get_page (entry->metrics));
+                g_ptr_array_remove_fast (page->glyphs, entry);
+            }
+
             g_hash_table_iter_remove (&iter);
             removed++;
         }
@@ -338,6 +964,9 @@ lrg_glyph_atlas_get_property (GObject    *object,
     case PROP_PAGE_HEIGHT:
         g_value_set_int (value, self->page_h);
         break;
+    case PROP_MAX_PAGES:
+        g_value_set_uint (value, self->max_pages);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -359,6 +988,9 @@ lrg_glyph_atlas_set_property (GObject      *object,
     case PROP_PAGE_HEIGHT:
         self->page_h = g_value_get_int (value);
         break;
+    case PROP_MAX_PAGES:
+        lrg_glyph_atlas_set_max_pages (self, g_value_get_uint (value));
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
     }
@@ -371,6 +1003,7 @@ lrg_glyph_atlas_finalize (GObject *object)
 
     g_clear_pointer (&self->glyphs, g_hash_table_unref);
     g_clear_pointer (&self->pages, g_ptr_array_unref);
+    g_clear_pointer (&self->upload_buf, g_free);
 
     G_OBJECT_CLASS (lrg_glyph_atlas_parent_class)->finalize (object);
 }
@@ -408,6 +1041,20 @@ lrg_glyph_atlas_class_init (LrgGlyphAtlasClass *klass)
                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY
                           | G_PARAM_STATIC_STRINGS);
 
+    /**
+     * LrgGlyphAtlas:max-pages:
+     *
+     * Page budget. When a glyph does not fit and the atlas already has this
+     * many pages, the least recently used page is evicted and repacked
+     * instead of growing a new one. 0 means unlimited.
+     */
+    properties[PROP_MAX_PAGES] =
+        g_param_spec_uint ("max-pages", "Max pages",
+                           "Page budget before LRU eviction (0 = unlimited)",
+                           0, G_MAXUINT, 0,
+                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY
+                           | G_PARAM_STATIC_STRINGS);
+
     g_object_class_install_properties (object_class, N_PROPS, properties);
 
     /**
@@ -423,6 +1070,21 @@ lrg_glyph_atlas_class_init (LrgGlyphAtlasClass *klass)
                       G_SIGNAL_RUN_FIRST,
                       0, NULL, NULL, NULL,
                       G_TYPE_NONE, 1, G_TYPE_UINT);
+
+    /**
+     * LrgGlyphAtlas::page-evicted:
+     * @self: the atlas
+     * @page: the index of the recycled page
+     *
+     * Emitted after the least recently used page was evicted and its
+     * remaining glyphs repacked. Metrics of moved glyphs are updated in place.
+     */
+    signals[SIGNAL_PAGE_EVICTED] =
+        g_signal_new ("page-evicted",
+                      G_TYPE_FROM_CLASS (klass),
+                      G_SIGNAL_RUN_FIRST,
+                      0, NULL, NULL, NULL,
+                      G_TYPE_NONE, 1, G_TYPE_UINT);
 }
 
 static void
@@ -430,9 +1092,11 @@ lrg_glyph_atlas_init (LrgGlyphAtlas *self)
 {
     self->page_w = 1024;
     self->page_h = 1024;
+    self->max_pages = 0;
+    self->frame = 0;
     self->pages = g_ptr_array_new_with_free_func (atlas_page_free);
     self->glyphs = g_hash_table_new_full (lrg_glyph_key_hash,
                                           lrg_glyph_key_equal,
                                           (GDestroyNotify) lrg_glyph_key_free,
-                                          (GDestroyNotify) lrg_glyph_metrics_free);
+                                          glyph_entry_free);
 }
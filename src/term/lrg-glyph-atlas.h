@@ -4,7 +4,8 @@
  *
  * SPDX-License-Identifier: AGPL-3.0-or-later
  *
- * GPU glyph cache: shelf-packed RGBA atlas pages keyed by #LrgGlyphKey.
+ * GPU glyph cache: skyline-packed RGBA atlas pages keyed by #LrgGlyphKey,
+ * with per-glyph frame stamps and LRU page eviction under a page budget.
  */
 
 #pragma once
@@ -52,10 +53,13 @@ LrgGlyphAtlas * lrg_glyph_atlas_new (gint page_width,
  * @out_x: (out): return location for the x of the placement within the page
  * @out_y: (out): return location for the y of the placement within the page
  *
- * Runs the shelf packer to choose a slot for a @width x @height glyph, growing
- * a new page if needed (emitting #LrgGlyphAtlas::page-added). This performs NO
- * GPU work, so it is safe to call headless and is the unit-testable core of the
- * packer.
+ * Runs the skyline packer to choose a slot for a @width x @height glyph. Every
+ * page is tried in order, placing the glyph where its top edge ends lowest.
+ * If no page has room and #LrgGlyphAtlas:max-pages is reached, the least
+ * recently used page is evicted and repacked (emitting
+ * #LrgGlyphAtlas::page-evicted); otherwise a new page is grown (emitting
+ * #LrgGlyphAtlas::page-added). This performs NO GPU work, so it is safe to
+ * call headless and is the unit-testable core of the packer.
  *
  * Returns: %TRUE on success, %FALSE if the glyph is larger than a whole page
  *
@@ -83,10 +87,18 @@ gboolean lrg_glyph_atlas_reserve (LrgGlyphAtlas *self,
  * @is_color: %TRUE for a colour glyph (drawn untinted), %FALSE for an
  *   alpha-coverage mask (drawn tinted by the face foreground)
  *
- * Packs the glyph into an atlas page, uploads its pixels to the page texture
- * (creating the texture on first use -- this step needs a GL context), records
- * its #LrgGlyphMetrics, and caches it under @key. If @key is already present the
- * existing metrics are returned unchanged.
+ * Packs the glyph into an atlas page, copies its pixels into the page's CPU
+ * staging copy, records its #LrgGlyphMetrics, and caches it under @key. If @key
+ * is already present the existing metrics are returned unchanged. Both paths
+ * stamp the glyph as used in the current frame.
+ *
+ * No GPU work happens here: every glyph staged on a page is sent as a single
+ * sub-image update covering the page's dirty rectangle by
+ * lrg_glyph_atlas_flush() or lrg_glyph_atlas_get_page_texture().
+ *
+ * The returned metrics stay valid until the glyph is evicted, but a later
+ * eviction of its page may move the glyph; re-read the rect and UVs each frame
+ * rather than caching them.
  *
  * Returns: (transfer none): the cached #LrgGlyphMetrics owned by the atlas, or
  *   %NULL on failure
@@ -123,6 +135,9 @@ LrgGlyphMetrics * lrg_glyph_atlas_lookup (LrgGlyphAtlas     *self,
  * @self: a #LrgGlyphAtlas
  * @page: a page index
  *
+ * Flushes pending uploads for @page (see lrg_glyph_atlas_flush()), creating its
+ * texture on first use -- this step needs a GL context.
+ *
  * Returns: (transfer none) (nullable): the page's #GrlTexture, or %NULL if the
  *   page index is out of range or nothing has been uploaded to it yet
  *
@@ -132,6 +147,85 @@ LRG_AVAILABLE_IN_ALL
 GrlTexture * lrg_glyph_atlas_get_page_texture (LrgGlyphAtlas *self,
                                                guint          page);
 
+/**
+ * lrg_glyph_atlas_begin_frame:
+ * @self: a #LrgGlyphAtlas
+ *
+ * Advances the atlas frame counter. Glyphs looked up or uploaded since the
+ * previous call count as used in that frame; a page touched in the current
+ * frame is never evicted, so metrics returned this frame stay put until the
+ * next call. Call once at the start of each frame; #Lrg2DSurface does this
+ * for every atlas it drew glyphs from in the previous frame.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_glyph_atlas_begin_frame (LrgGlyphAtlas *self);
+
+/**
+ * lrg_glyph_atlas_get_frame:
+ * @self: a #LrgGlyphAtlas
+ *
+ * Returns: the current frame stamp
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint64 lrg_glyph_atlas_get_frame (LrgGlyphAtlas *self);
+
+/**
+ * lrg_glyph_atlas_flush:
+ * @self: a #LrgGlyphAtlas
+ *
+ * Uploads every page's pending pixels, one sub-image update per dirty page,
+ * creating page textures on first use (needs a GL context). Normally not
+ * needed: lrg_glyph_atlas_get_page_texture() flushes its page on demand.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_glyph_atlas_flush (LrgGlyphAtlas *self);
+
+/**
+ * lrg_glyph_atlas_get_dirty_rect:
+ * @self: a #LrgGlyphAtlas
+ * @page: a page index
+ * @out_x: (out) (optional): return location for the dirty rect x
+ * @out_y: (out) (optional): return location for the dirty rect y
+ * @out_w: (out) (optional): return location for the dirty rect width
+ * @out_h: (out) (optional): return location for the dirty rect height
+ *
+ * Gets the bounding rectangle of pixels staged on @page since its last flush,
+ * i.e. the region the next upload will cover.
+ *
+ * Returns: %TRUE if @page has pending pixels
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean lrg_glyph_atlas_get_dirty_rect (LrgGlyphAtlas *self,
+                                         guint          page,
+                                         gint          *out_x,
+                                         gint          *out_y,
+                                         gint          *out_w,
+                                         gint          *out_h);
+
+/**
+ * lrg_glyph_atlas_get_page_pixels:
+ * @self: a #LrgGlyphAtlas
+ * @page: a page index
+ *
+ * Gets the CPU staging copy of @page, page-width * page-height RGBA8 pixels.
+ *
+ * Returns: (transfer none) (nullable): the page pixels, or %NULL if the page
+ *   index is out of range or no pixels have been uploaded to it yet
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+const guint8 * lrg_glyph_atlas_get_page_pixels (LrgGlyphAtlas *self,
+                                                guint          page);
+
 LRG_AVAILABLE_IN_ALL
 guint lrg_glyph_atlas_get_page_count (LrgGlyphAtlas *self);
 
@@ -144,14 +238,33 @@ gint lrg_glyph_atlas_get_page_width (LrgGlyphAtlas *self);
 LRG_AVAILABLE_IN_ALL
 gint lrg_glyph_atlas_get_page_height (LrgGlyphAtlas *self);
 
+LRG_AVAILABLE_IN_ALL
+guint lrg_glyph_atlas_get_max_pages (LrgGlyphAtlas *self);
+
+/**
+ * lrg_glyph_atlas_set_max_pages:
+ * @self: a #LrgGlyphAtlas
+ * @max_pages: the page budget, or 0 for unlimited
+ *
+ * Sets the page budget. Once reached, a glyph that fits nowhere evicts the
+ * least recently used page: its glyphs used in that page's most recent frame
+ * are repacked, the rest are dropped. The budget is soft within a frame --
+ * if every page was used in the current frame a new page is grown instead.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_glyph_atlas_set_max_pages (LrgGlyphAtlas *self,
+                                    guint          max_pages);
+
 /**
  * lrg_glyph_atlas_evict_font:
  * @self: a #LrgGlyphAtlas
  * @font_id: the font identity whose glyphs should be dropped
  *
- * Removes all cached glyphs belonging to @font_id. Atlas page space is not
- * reclaimed (the freed shelf area is not reused), but the entries are gone so a
- * re-render re-uploads them; call when a font is closed.
+ * Removes all cached glyphs belonging to @font_id; call when a font is closed.
+ * Their atlas space is reclaimed the next time the page is evicted and
+ * repacked, and a re-render re-uploads them.
  *
  * Returns: the number of glyphs removed
  *
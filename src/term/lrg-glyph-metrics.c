@@ -89,6 +89,19 @@ lrg_glyph_metrics_set_uv (LrgGlyphMetrics *self,
     self->v1 = v1;
 }
 
+void
+lrg_glyph_metrics_set_position (LrgGlyphMetrics *self,
+                                guint            page,
+                                gint             px,
+                                gint             py)
+{
+    g_return_if_fail (self != NULL);
+
+    self->page = page;
+    self->px = px;
+    self->py = py;
+}
+
 guint
 lrg_glyph_metrics_get_page (const LrgGlyphMetrics *self)
 {
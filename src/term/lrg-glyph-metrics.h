@@ -92,6 +92,24 @@ void lrg_glyph_metrics_set_uv (LrgGlyphMetrics *self,
                                gfloat           u1,
                                gfloat           v1);
 
+/**
+ * lrg_glyph_metrics_set_position:
+ * @self: a #LrgGlyphMetrics
+ * @page: atlas page index
+ * @px: x of the glyph ink box within the page (pixels)
+ * @py: y of the glyph ink box within the page (pixels)
+ *
+ * Moves the glyph within the atlas. Called by #LrgGlyphAtlas when it repacks
+ * a page; the caller updates the UVs with lrg_glyph_metrics_set_uv().
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void lrg_glyph_metrics_set_position (LrgGlyphMetrics *self,
+                                     guint            page,
+                                     gint             px,
+                                     gint             py);
+
 LRG_AVAILABLE_IN_ALL
 guint lrg_glyph_metrics_get_page (const LrgGlyphMetrics *self);
 
@@ -34,8 +34,36 @@
  * - `[wave]text[/wave]` - Wave effect
  * - `[rainbow]text[/rainbow]` - Rainbow effect
  * - `[typewriter speed=50]text[/typewriter]` - Typewriter reveal
+ *
+ * ## Layout Cache
+ *
+ * Spans are laid out into positioned glyphs the first time the text is
+ * drawn, and again only after the markup, font size, line spacing, wrap
+ * width or default font changes. Glyphs of one span on one line form a
+ * run. Runs without an effect are drawn with a single text call; runs
+ * with an effect apply its per-glyph offset and color to the cached
+ * positions.
  */
 
+/* One laid out character, positioned relative to the draw origin */
+typedef struct
+{
+    gfloat x;
+    gfloat y;
+    guint  char_index;   /* index into the plain text, as effects expect */
+    gchar  utf8[8];
+} LayoutGlyph;
+
+/* Glyphs of one span on one line */
+typedef struct
+{
+    guint  span_index;
+    guint  first_glyph;
+    guint  n_glyphs;
+    gsize  text_offset;  /* NUL-terminated run text in run_text */
+    gfloat font_size;
+} LayoutRun;
+
 typedef struct
 {
     GPtrArray        *spans;     /* LrgTextSpan* */
@@ -49,6 +77,13 @@ typedef struct
     guint8            default_g;
     guint8            default_b;
     guint8            default_a;
+
+    /* Layout cache, rebuilt when layout_valid is FALSE */
+    gboolean          layout_valid;
+    gconstpointer     layout_font;  /* font the layout was measured with */
+    GArray           *glyphs;       /* LayoutGlyph */
+    GArray           *runs;         /* LayoutRun */
+    GString          *run_text;
 } LrgRichTextPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgRichText, lrg_rich_text, G_TYPE_OBJECT)
@@ -208,6 +243,7 @@ lrg_rich_text_real_parse (LrgRichText *text,
     priv = lrg_rich_text_get_instance_private (text);
 
     /* Clear existing spans */
+    priv->layout_valid = FALSE;
     g_ptr_array_set_size (priv->spans, 0);
     g_ptr_array_set_size (priv->effects, 0);
     g_string_truncate (priv->plain_text, 0);
@@ -416,45 +452,73 @@ lrg_rich_text_real_update (LrgRichText *text,
 }
 
 static void
-lrg_rich_text_real_draw (LrgRichText *text,
-                         gfloat       x,
-                         gfloat       y)
+end_run (LrgRichTextPrivate *priv,
+         LayoutRun          *run)
+{
+    if (run->n_glyphs > 0)
+    {
+        g_string_append_c (priv->run_text, '\0');
+        g_array_append_val (priv->runs, *run);
+    }
+
+    run->first_glyph = priv->glyphs->len;
+    run->n_glyphs = 0;
+    run->text_offset = priv->run_text->len;
+}
+
+/*
+ * ensure_layout:
+ *
+ * Lays the spans out into glyphs and runs, breaking lines exactly as
+ * characters were placed before the cache existed: a character that
+ * crosses the wrap width stays on its line and the next one wraps.
+ */
+static void
+ensure_layout (LrgRichText *text)
 {
     LrgRichTextPrivate *priv;
     LrgFontManager *font_mgr;
+    gconstpointer font;
     gfloat cursor_x, cursor_y;
-    guint i;
     guint global_char_index;
+    guint i;
 
     priv = lrg_rich_text_get_instance_private (text);
     font_mgr = lrg_font_manager_get_default ();
+    font = lrg_font_manager_get_font (font_mgr, NULL);
+
+    if (priv->layout_valid && priv->layout_font == font)
+        return;
 
-    cursor_x = x;
-    cursor_y = y;
+    g_array_set_size (priv->glyphs, 0);
+    g_array_set_size (priv->runs, 0);
+    g_string_truncate (priv->run_text, 0);
+
+    cursor_x = 0.0f;
+    cursor_y = 0.0f;
     global_char_index = 0;
 
     for (i = 0; i < priv->spans->len; i++)
     {
         const LrgTextSpan *span;
-        LrgTextEffect *effect;
-        const gchar *span_text;
         gfloat span_font_size;
-        guint8 r, g, b, a;
+        LayoutRun run;
         const gchar *ch;
 
         span = g_ptr_array_index (priv->spans, i);
-        effect = g_ptr_array_index (priv->effects, i);
-        span_text = lrg_text_span_get_text (span);
         span_font_size = lrg_text_span_get_font_size (span) * priv->font_size;
-        lrg_text_span_get_color (span, &r, &g, &b, &a);
 
-        for (ch = span_text; *ch != '\0'; ch = g_utf8_next_char (ch))
+        run.span_index = i;
+        run.font_size = span_font_size;
+        run.first_glyph = priv->glyphs->len;
+        run.n_glyphs = 0;
+        run.text_offset = priv->run_text->len;
+
+        for (ch = lrg_text_span_get_text (span); *ch != '\0'; ch = g_utf8_next_char (ch))
         {
+            LayoutGlyph glyph;
             gunichar uc;
-            gchar char_buf[7];
             gint char_len;
-            gfloat offset_x, offset_y;
-            guint8 chr, chg, chb, cha;
             gfloat char_width;
 
             uc = g_utf8_get_char (ch);
@@ -462,14 +526,109 @@ lrg_rich_text_real_draw (LrgRichText *text,
             /* Handle newlines */
             if (uc == '\n')
             {
-                cursor_x = x;
+                end_run (priv, &run);
+                cursor_x = 0.0f;
                 cursor_y += span_font_size * priv->line_spacing;
                 global_char_index++;
                 continue;
             }
 
-            char_len = g_unichar_to_utf8 (uc, char_buf);
-            char_buf[char_len] = '\0';
+            char_len = g_unichar_to_utf8 (uc, glyph.utf8);
+            glyph.utf8[char_len] = '\0';
+            glyph.x = cursor_x;
+            glyph.y = cursor_y;
+            glyph.char_index = global_char_index;
+
+            g_array_append_val (priv->glyphs, glyph);
+            g_string_append_len (priv->run_text, glyph.utf8, char_len);
+            run.n_glyphs++;
+
+            /* Advance cursor */
+            lrg_font_manager_measure_text (font_mgr, NULL, glyph.utf8, span_font_size,
+                                           &char_width, NULL);
+            cursor_x += char_width;
+
+            /* Handle word wrap */
+            if (priv->max_width > 0.0f && cursor_x > priv->max_width)
+            {
+                end_run (priv, &run);
+                cursor_x = 0.0f;
+                cursor_y += span_font_size * priv->line_spacing;
+            }
+
+            global_char_index++;
+        }
+
+        end_run (priv, &run);
+    }
+
+    priv->layout_valid = TRUE;
+    priv->layout_font = font;
+}
+
+static void
+lrg_rich_text_real_draw (LrgRichText *text,
+                         gfloat       x,
+                         gfloat       y)
+{
+    LrgRichTextPrivate *priv;
+    LrgFontManager *font_mgr;
+    GrlFont *font;
+    guint i;
+
+    priv = lrg_rich_text_get_instance_private (text);
+    font_mgr = lrg_font_manager_get_default ();
+    font = lrg_font_manager_get_font (font_mgr, NULL);
+
+    ensure_layout (text);
+
+    for (i = 0; i < priv->runs->len; i++)
+    {
+        const LayoutRun *run;
+        const LrgTextSpan *span;
+        LrgTextEffect *effect;
+        guint8 r, g, b, a;
+        guint j;
+
+        run = &g_array_index (priv->runs, LayoutRun, i);
+        span = g_ptr_array_index (priv->spans, run->span_index);
+        effect = g_ptr_array_index (priv->effects, run->span_index);
+        lrg_text_span_get_color (span, &r, &g, &b, &a);
+
+        /*
+         * Without an effect every glyph keeps its cached position and the
+         * span color, so the run goes out as one text draw.  Zero spacing
+         * matches the per-character advances the layout was measured with.
+         */
+        if (effect == NULL && font != NULL)
+        {
+            const LayoutGlyph *first;
+            GrlVector2 pos;
+            GrlColor color;
+
+            if (a == 0)
+                continue;
+
+            first = &g_array_index (priv->glyphs, LayoutGlyph, run->first_glyph);
+            pos.x = x + first->x;
+            pos.y = y + first->y;
+            color.r = r;
+            color.g = g;
+            color.b = b;
+            color.a = a;
+
+            grl_draw_text_ex (font, priv->run_text->str + run->text_offset,
+                              &pos, run->font_size, 0.0f, &color);
+            continue;
+        }
+
+        for (j = 0; j < run->n_glyphs; j++)
+        {
+            const LayoutGlyph *glyph;
+            gfloat offset_x, offset_y;
+            guint8 chr, chg, chb, cha;
+
+            glyph = &g_array_index (priv->glyphs, LayoutGlyph, run->first_glyph + j);
 
             /* Apply effects */
             offset_x = 0.0f;
@@ -481,7 +640,7 @@ lrg_rich_text_real_draw (LrgRichText *text,
 
             if (effect != NULL)
             {
-                lrg_text_effect_apply (effect, global_char_index,
+                lrg_text_effect_apply (effect, glyph->char_index,
                                        &offset_x, &offset_y,
                                        &chr, &chg, &chb, &cha);
             }
@@ -489,26 +648,12 @@ lrg_rich_text_real_draw (LrgRichText *text,
             /* Draw character */
             if (cha > 0)
             {
-                lrg_font_manager_draw_text (font_mgr, NULL, char_buf,
-                                            cursor_x + offset_x,
-                                            cursor_y + offset_y,
-                                            span_font_size,
+                lrg_font_manager_draw_text (font_mgr, NULL, glyph->utf8,
+                                            x + glyph->x + offset_x,
+                                            y + glyph->y + offset_y,
+                                            run->font_size,
                                             chr, chg, chb, cha);
             }
-
-            /* Advance cursor */
-            lrg_font_manager_measure_text (font_mgr, NULL, char_buf, span_font_size,
-                                           &char_width, NULL);
-            cursor_x += char_width;
-
-            /* Handle word wrap */
-            if (priv->max_width > 0.0f && cursor_x - x > priv->max_width)
-            {
-                cursor_x = x;
-                cursor_y += span_font_size * priv->line_spacing;
-            }
-
-            global_char_index++;
         }
     }
 }
@@ -524,6 +669,9 @@ lrg_rich_text_finalize (GObject *object)
     g_ptr_array_unref (priv->spans);
     g_ptr_array_unref (priv->effects);
     g_string_free (priv->plain_text, TRUE);
+    g_array_unref (priv->glyphs);
+    g_array_unref (priv->runs);
+    g_string_free (priv->run_text, TRUE);
 
     G_OBJECT_CLASS (lrg_rich_text_parent_class)->finalize (object);
 }
@@ -573,12 +721,15 @@ lrg_rich_text_set_property (GObject      *object,
     {
     case PROP_FONT_SIZE:
         priv->font_size = g_value_get_float (value);
+        priv->layout_valid = FALSE;
         break;
     case PROP_LINE_SPACING:
         priv->line_spacing = g_value_get_float (value);
+        priv->layout_valid = FALSE;
         break;
     case PROP_MAX_WIDTH:
         priv->max_width = g_value_get_float (value);
+        priv->layout_valid = FALSE;
         break;
     case PROP_ALIGNMENT:
         priv->alignment = g_value_get_enum (value);
@@ -641,6 +792,11 @@ lrg_rich_text_init (LrgRichText *self)
     priv->default_g = 255;
     priv->default_b = 255;
     priv->default_a = 255;
+    priv->layout_valid = FALSE;
+    priv->layout_font = NULL;
+    priv->glyphs = g_array_new (FALSE, FALSE, sizeof (LayoutGlyph));
+    priv->runs = g_array_new (FALSE, FALSE, sizeof (LayoutRun));
+    priv->run_text = g_string_new (NULL);
 }
 
 /*
@@ -736,6 +892,7 @@ lrg_rich_text_set_font_size (LrgRichText *text,
 
     priv = lrg_rich_text_get_instance_private (text);
     priv->font_size = size > 0.0f ? size : 16.0f;
+    priv->layout_valid = FALSE;
 }
 
 gfloat
@@ -759,6 +916,7 @@ lrg_rich_text_set_line_spacing (LrgRichText *text,
 
     priv = lrg_rich_text_get_instance_private (text);
     priv->line_spacing = spacing;
+    priv->layout_valid = FALSE;
 }
 
 gfloat
@@ -782,6 +940,7 @@ lrg_rich_text_set_max_width (LrgRichText *text,
 
     priv = lrg_rich_text_get_instance_private (text);
     priv->max_width = width >= 0.0f ? width : 0.0f;
+    priv->layout_valid = FALSE;
 }
 
 LrgTextAlignment
@@ -935,3 +1094,64 @@ lrg_rich_text_effects_complete (LrgRichText *text)
 
     return TRUE;
 }
+
+void
+lrg_rich_text_invalidate_layout (LrgRichText *text)
+{
+    LrgRichTextPrivate *priv;
+
+    g_return_if_fail (LRG_IS_RICH_TEXT (text));
+
+    priv = lrg_rich_text_get_instance_private (text);
+    priv->layout_valid = FALSE;
+}
+
+guint
+lrg_rich_text_get_glyph_count (LrgRichText *text)
+{
+    LrgRichTextPrivate *priv;
+
+    g_return_val_if_fail (LRG_IS_RICH_TEXT (text), 0);
+
+    priv = lrg_rich_text_get_instance_private (text);
+    ensure_layout (text);
+
+    return priv->glyphs->len;
+}
+
+gboolean
+lrg_rich_text_get_glyph_position (LrgRichText *text,
+                                  guint        index,
+                                  gfloat      *x,
+                                  gfloat      *y)
+{
+    LrgRichTextPrivate *priv;
+    const LayoutGlyph *glyph;
+
+    g_return_val_if_fail (LRG_IS_RICH_TEXT (text), FALSE);
+
+    priv = lrg_rich_text_get_instance_private (text);
+    ensure_layout (text);
+
+    if (index >= priv->glyphs->len)
+        return FALSE;
+
+    glyph = &g_array_index (priv->glyphs, LayoutGlyph, index);
+    if (x != NULL) *x = glyph->x;
+    if (y != NULL) *y = glyph->y;
+
+    return TRUE;
+}
+
+guint
+lrg_rich_text_get_run_count (LrgRichText *text)
+{
+    LrgRichTextPrivate *priv;
+
+    g_return_val_if_fail (LRG_IS_RICH_TEXT (text), 0);
+
+    priv = lrg_rich_text_get_instance_private (text);
+    ensure_layout (text);
+
+    return priv->runs->len;
+}
@@ -311,4 +311,55 @@ void                lrg_rich_text_reset_effects         (LrgRichText *text);
 LRG_AVAILABLE_IN_ALL
 gboolean            lrg_rich_text_effects_complete      (LrgRichText *text);
 
+/**
+ * lrg_rich_text_invalidate_layout:
+ * @text: A #LrgRichText
+ *
+ * Discards the cached layout so the next draw lays the text out again.
+ * Changing the markup, font size, line spacing, max width or default
+ * font already does this; call it after changing a font's glyphs.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_rich_text_invalidate_layout     (LrgRichText *text);
+
+/**
+ * lrg_rich_text_get_glyph_count:
+ * @text: A #LrgRichText
+ *
+ * Gets the number of laid out glyphs.  Newlines take no glyph.
+ *
+ * Returns: The glyph count
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_rich_text_get_glyph_count       (LrgRichText *text);
+
+/**
+ * lrg_rich_text_get_glyph_position:
+ * @text: A #LrgRichText
+ * @index: Glyph index
+ * @x: (out) (optional): X offset from the draw position
+ * @y: (out) (optional): Y offset from the draw position
+ *
+ * Gets where a glyph is drawn, before any effect offset.
+ *
+ * Returns: %TRUE if @index is a valid glyph
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_rich_text_get_glyph_position    (LrgRichText *text,
+                                                         guint        index,
+                                                         gfloat      *x,
+                                                         gfloat      *y);
+
+/**
+ * lrg_rich_text_get_run_count:
+ * @text: A #LrgRichText
+ *
+ * Gets the number of glyph runs: stretches of one span on one line.
+ * Runs without an effect are drawn with a single text call.
+ *
+ * Returns: The run count
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_rich_text_get_run_count         (LrgRichText *text);
+
 G_END_DECLS
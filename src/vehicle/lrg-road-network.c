@@ -8,9 +8,35 @@
 #include "config.h"
 
 #include <math.h>
+#include <string.h>
 
 #include "lrg-road-network.h"
 
+#define DEFAULT_ROUTE_CACHE_SIZE (1024)
+
+/* Speed assumed for segments without a positive speed limit */
+#define FALLBACK_SPEED (1.0)
+
+/* Connections whose endpoints are further apart than this make the
+ * straight-line A* heuristic inadmissible, so it is switched off. */
+#define HEURISTIC_GAP_TOLERANCE (0.01f)
+
+/* Nodes settled per witness search while contracting */
+#define WITNESS_SETTLE_LIMIT (64)
+
+/*
+ * Routing works on directed states rather than roads: state 2r drives
+ * road r from its start to its end, state 2r+1 drives it from the end
+ * back to the start (never valid on one-way roads). Taking the edge
+ * u -> v costs the full traversal time of u.
+ */
+#define STATE_FORWARD  (0)
+#define STATE_BACKWARD (1)
+#define MAKE_STATE(road, dir) ((guint32)(road) * 2 + (dir))
+#define STATE_ROAD(state)     ((state) / 2)
+#define STATE_DIR(state)      ((state) % 2)
+#define NO_INDEX              (G_MAXUINT32)
+
 /* Connection key structure */
 typedef struct
 {
@@ -25,6 +51,54 @@ typedef struct
     gboolean at_end;
 } ConnectionTarget;
 
+/* Binary heap entry */
+typedef struct
+{
+    gdouble key;
+    guint32 node;
+} HeapEntry;
+
+/*
+ * Distances and parents for one search. Slots are only meaningful
+ * where seen[] equals the current stamp, so starting a new search
+ * costs nothing however large the graph is.
+ */
+typedef struct
+{
+    gdouble *dist;
+    guint32 *parent;
+    guint32 *seen;
+    guint32 *settled;
+    guint32  stamp;
+    guint    n_nodes;
+    GArray  *heap;
+} SearchSpace;
+
+/* Contraction hierarchy edge; shortcuts keep the two edges they skip */
+typedef struct
+{
+    guint32 from;
+    guint32 to;
+    gdouble weight;
+    guint32 child_a;
+    guint32 child_b;
+} ChEdge;
+
+/*
+ * Answer for one pair of roads, independent of where on them a query
+ * starts or ends. cost[d][e] is the time from leaving the source road
+ * driven in direction d to entering the target road driven in
+ * direction e; path[d][e] lists the road indices after the source,
+ * ending with the target.
+ */
+typedef struct
+{
+    guint64  key;
+    gdouble  cost[2][2];
+    GArray  *path[2][2];
+    GList    link;
+} RouteCacheEntry;
+
 struct _LrgRoadNetwork
 {
     GObject parent_instance;
@@ -38,6 +112,34 @@ struct _LrgRoadNetwork
     /* Cached road list */
     GList *road_list;
     gboolean list_dirty;
+
+    /* Integer road indices, stable until the network is cleared */
+    GPtrArray  *road_slots;     /* index -> LrgRoad, NULL once removed */
+    GHashTable *road_indices;   /* road ID -> index + 1 */
+
+    /* Routing graph over states in CSR form */
+    gboolean  graph_dirty;
+    guint     n_states;
+    guint32  *edge_offsets;
+    guint32  *edge_targets;
+    gdouble  *state_time;
+    gfloat   *state_entry;      /* xyz where each state enters its road */
+    gdouble   max_speed;        /* 0 disables the A* heuristic */
+    SearchSpace search[2];
+
+    /* Optional contraction hierarchy */
+    gboolean  contraction_enabled;
+    gboolean  hierarchy_dirty;
+    GArray   *ch_edges;
+    guint32  *ch_up_offsets;
+    guint32  *ch_up_edges;
+    guint32  *ch_down_offsets;
+    guint32  *ch_down_edges;
+
+    /* LRU cache of road pair answers, most recent at the head */
+    GHashTable *route_cache;
+    GQueue      route_lru;
+    guint       route_cache_size;
 };
 
 G_DEFINE_TYPE (LrgRoadNetwork, lrg_road_network, G_TYPE_OBJECT)
@@ -65,6 +167,1086 @@ connection_list_free (GList *list)
     g_list_free_full (list, (GDestroyNotify)connection_target_free);
 }
 
+/* ==========================================================================
+ * Search helpers
+ * ========================================================================== */
+
+static void
+heap_push (GArray  *heap,
+           gdouble  key,
+           guint32  node)
+{
+    HeapEntry *entries;
+    HeapEntry entry;
+    guint i;
+
+    entry.key = key;
+    entry.node = node;
+    g_array_append_val (heap, entry);
+
+    entries = (HeapEntry *)heap->data;
+    i = heap->len - 1;
+    while (i > 0)
+    {
+        guint parent = (i - 1) / 2;
+
+        if (entries[parent].key <= key)
+            break;
+
+        entries[i] = entries[parent];
+        i = parent;
+    }
+    entries[i] = entry;
+}
+
+static gboolean
+heap_pop (GArray    *heap,
+          HeapEntry *out)
+{
+    HeapEntry *entries;
+    HeapEntry last;
+    guint n;
+    guint i;
+
+    if (heap->len == 0)
+        return FALSE;
+
+    entries = (HeapEntry *)heap->data;
+    *out = entries[0];
+    last = entries[heap->len - 1];
+    g_array_set_size (heap, heap->len - 1);
+
+    n = heap->len;
+    if (n == 0)
+        return TRUE;
+
+    i = 0;
+    while (TRUE)
+    {
+        guint child = 2 * i + 1;
+
+        if (child >= n)
+            break;
+        if (child + 1 < n && entries[child + 1].key < entries[child].key)
+            child++;
+        if (entries[child].key >= last.key)
+            break;
+
+        entries[i] = entries[child];
+        i = child;
+    }
+    entries[i] = last;
+
+    return TRUE;
+}
+
+static void
+search_space_clear (SearchSpace *space)
+{
+    g_clear_pointer (&space->dist, g_free);
+    g_clear_pointer (&space->parent, g_free);
+    g_clear_pointer (&space->seen, g_free);
+    g_clear_pointer (&space->settled, g_free);
+    g_clear_pointer (&space->heap, g_array_unref);
+    space->n_nodes = 0;
+    space->stamp = 0;
+}
+
+static void
+search_space_resize (SearchSpace *space,
+                     guint        n_nodes)
+{
+    search_space_clear (space);
+
+    space->dist = g_new (gdouble, MAX (n_nodes, 1));
+    space->parent = g_new (guint32, MAX (n_nodes, 1));
+    space->seen = g_new0 (guint32, MAX (n_nodes, 1));
+    space->settled = g_new0 (guint32, MAX (n_nodes, 1));
+    space->heap = g_array_new (FALSE, FALSE, sizeof (HeapEntry));
+    space->n_nodes = n_nodes;
+}
+
+static void
+search_space_begin (SearchSpace *space)
+{
+    space->stamp++;
+    if (space->stamp == 0)
+    {
+        memset (space->seen, 0, sizeof (guint32) * MAX (space->n_nodes, 1));
+        memset (space->settled, 0, sizeof (guint32) * MAX (space->n_nodes, 1));
+        space->stamp = 1;
+    }
+    g_array_set_size (space->heap, 0);
+}
+
+static inline gboolean
+search_space_has (const SearchSpace *space,
+                  guint32            node)
+{
+    return space->seen[node] == space->stamp;
+}
+
+/* Records @dist for @node if it improves on what is known and the
+ * node is not settled yet. The caller pushes it onto the heap. */
+static inline gboolean
+search_space_update (SearchSpace *space,
+                     guint32      node,
+                     gdouble      dist,
+                     guint32      parent)
+{
+    if (space->settled[node] == space->stamp)
+        return FALSE;
+    if (space->seen[node] == space->stamp && space->dist[node] <= dist)
+        return FALSE;
+
+    space->seen[node] = space->stamp;
+    space->dist[node] = dist;
+    space->parent[node] = parent;
+
+    return TRUE;
+}
+
+/* ==========================================================================
+ * Routing graph
+ * ========================================================================== */
+
+static gdouble
+segment_time (const LrgRoadWaypoint *wp0,
+              const LrgRoadWaypoint *wp1)
+{
+    gdouble dx, dy, dz;
+    gdouble speed;
+
+    dx = wp1->x - wp0->x;
+    dy = wp1->y - wp0->y;
+    dz = wp1->z - wp0->z;
+
+    speed = 0.5 * ((gdouble)wp0->speed_limit + (gdouble)wp1->speed_limit);
+    if (speed <= 0.0)
+        speed = FALLBACK_SPEED;
+
+    return sqrt (dx * dx + dy * dy + dz * dz) / speed;
+}
+
+/*
+ * Travel time from the start of @road to @t, using the same segment
+ * parametrisation as lrg_road_interpolate().
+ */
+static gdouble
+road_time_to (const LrgRoad *road,
+              gfloat         t)
+{
+    guint count;
+    guint segment_index;
+    gdouble segment_t;
+    gdouble total;
+    guint i;
+
+    count = lrg_road_get_waypoint_count (road);
+    if (count < 2)
+        return 0.0;
+
+    t = CLAMP (t, 0.0f, 1.0f);
+    segment_t = (gdouble)t * (count - 1);
+    segment_index = (guint)segment_t;
+    if (segment_index >= count - 1)
+        segment_index = count - 2;
+
+    total = 0.0;
+    for (i = 0; i < segment_index; i++)
+        total += segment_time (lrg_road_get_waypoint (road, i),
+                               lrg_road_get_waypoint (road, i + 1));
+
+    total += segment_time (lrg_road_get_waypoint (road, segment_index),
+                           lrg_road_get_waypoint (road, segment_index + 1))
+             * (segment_t - segment_index);
+
+    return total;
+}
+
+static LrgRoad *
+road_at (LrgRoadNetwork *self,
+         guint           index)
+{
+    if (index >= self->road_slots->len)
+        return NULL;
+
+    return g_ptr_array_index (self->road_slots, index);
+}
+
+static gboolean
+state_is_valid (LrgRoadNetwork *self,
+                guint32         state)
+{
+    LrgRoad *road;
+
+    road = road_at (self, STATE_ROAD (state));
+    if (road == NULL)
+        return FALSE;
+
+    return STATE_DIR (state) == STATE_FORWARD || !lrg_road_is_one_way (road);
+}
+
+/* Point where a state enters (@exit = FALSE) or leaves its road */
+static void
+state_endpoint (const LrgRoad *road,
+                guint          dir,
+                gboolean       exit,
+                gfloat        *out)
+{
+    const LrgRoadWaypoint *wp;
+    guint count;
+
+    count = lrg_road_get_waypoint_count (road);
+    if (count == 0)
+    {
+        out[0] = out[1] = out[2] = 0.0f;
+        return;
+    }
+
+    wp = lrg_road_get_waypoint (road, ((dir == STATE_FORWARD) == exit) ? count - 1 : 0);
+    out[0] = wp->x;
+    out[1] = wp->y;
+    out[2] = wp->z;
+}
+
+static void
+routing_graph_build (LrgRoadNetwork *self)
+{
+    GArray *targets;
+    gboolean admissible;
+    gdouble max_speed;
+    guint n_states;
+    guint32 s;
+
+    n_states = self->road_slots->len * 2;
+
+    g_free (self->edge_offsets);
+    g_free (self->edge_targets);
+    g_free (self->state_time);
+    g_free (self->state_entry);
+
+    self->n_states = n_states;
+    self->edge_offsets = g_new (guint32, n_states + 1);
+    self->state_time = g_new0 (gdouble, MAX (n_states, 1));
+    self->state_entry = g_new0 (gfloat, MAX (n_states, 1) * 3);
+
+    targets = g_array_new (FALSE, FALSE, sizeof (guint32));
+    admissible = TRUE;
+    max_speed = 0.0;
+
+    for (s = 0; s < n_states; s++)
+    {
+        LrgRoad *road;
+        GList *l;
+        gchar *key;
+        guint count;
+        guint i;
+
+        self->edge_offsets[s] = targets->len;
+        if (!state_is_valid (self, s))
+            continue;
+
+        road = road_at (self, STATE_ROAD (s));
+        count = lrg_road_get_waypoint_count (road);
+        if (count == 0)
+            admissible = FALSE;
+
+        for (i = 0; i + 1 < count; i++)
+        {
+            const LrgRoadWaypoint *wp0 = lrg_road_get_waypoint (road, i);
+            const LrgRoadWaypoint *wp1 = lrg_road_get_waypoint (road, i + 1);
+
+            self->state_time[s] += segment_time (wp0, wp1);
+            max_speed = MAX (max_speed, 0.5 * ((gdouble)wp0->speed_limit +
+                                               (gdouble)wp1->speed_limit));
+        }
+        state_endpoint (road, STATE_DIR (s), FALSE, &self->state_entry[s * 3]);
+
+        /* Forward states leave at the end, backward ones at the start */
+        key = make_connection_key (lrg_road_get_id (road), STATE_DIR (s) == STATE_FORWARD);
+        for (l = g_hash_table_lookup (self->connections, key); l != NULL; l = l->next)
+        {
+            ConnectionTarget *target = l->data;
+            guint index;
+            guint32 v;
+
+            index = GPOINTER_TO_UINT (g_hash_table_lookup (self->road_indices, target->road_id));
+            if (index == 0)
+                continue;
+
+            v = MAKE_STATE (index - 1, target->at_end ? STATE_BACKWARD : STATE_FORWARD);
+            if (state_is_valid (self, v))
+                g_array_append_val (targets, v);
+        }
+        g_free (key);
+    }
+    self->edge_offsets[n_states] = targets->len;
+    self->edge_targets = (guint32 *)g_array_free (targets, FALSE);
+
+    /* The heuristic assumes consecutive roads actually touch */
+    for (s = 0; s < n_states && admissible; s++)
+    {
+        gfloat exit_point[3];
+        guint32 i;
+
+        if (self->edge_offsets[s] == self->edge_offsets[s + 1])
+            continue;
+
+        state_endpoint (road_at (self, STATE_ROAD (s)), STATE_DIR (s), TRUE, exit_point);
+        for (i = self->edge_offsets[s]; i < self->edge_offsets[s + 1]; i++)
+        {
+            const gfloat *entry = &self->state_entry[self->edge_targets[i] * 3];
+            gfloat dx = entry[0] - exit_point[0];
+            gfloat dy = entry[1] - exit_point[1];
+            gfloat dz = entry[2] - exit_point[2];
+
+            if (dx * dx + dy * dy + dz * dz >
+                HEURISTIC_GAP_TOLERANCE * HEURISTIC_GAP_TOLERANCE)
+            {
+                admissible = FALSE;
+                break;
+            }
+        }
+    }
+    self->max_speed = admissible ? max_speed : 0.0;
+
+    search_space_resize (&self->search[0], n_states);
+    search_space_resize (&self->search[1], n_states);
+
+    self->graph_dirty = FALSE;
+    self->hierarchy_dirty = TRUE;
+}
+
+static gdouble
+heuristic (LrgRoadNetwork *self,
+           guint32         state,
+           const gfloat   *goals,
+           guint           n_goals)
+{
+    const gfloat *p;
+    gdouble best;
+    guint i;
+
+    if (self->max_speed <= 0.0)
+        return 0.0;
+
+    p = &self->state_entry[state * 3];
+    best = G_MAXDOUBLE;
+    for (i = 0; i < n_goals; i++)
+    {
+        gdouble dx = goals[i * 3] - p[0];
+        gdouble dy = goals[i * 3 + 1] - p[1];
+        gdouble dz = goals[i * 3 + 2] - p[2];
+
+        best = MIN (best, dx * dx + dy * dy + dz * dz);
+    }
+
+    return sqrt (best) / self->max_speed;
+}
+
+static GArray *
+path_from_parents (const SearchSpace *space,
+                   guint32            goal)
+{
+    GArray *path;
+    guint32 node;
+    guint i;
+
+    path = g_array_new (FALSE, FALSE, sizeof (guint));
+    for (node = goal; node != NO_INDEX; node = space->parent[node])
+    {
+        guint road = STATE_ROAD (node);
+
+        g_array_append_val (path, road);
+    }
+
+    for (i = 0; i < path->len / 2; i++)
+    {
+        guint tmp = g_array_index (path, guint, i);
+
+        g_array_index (path, guint, i) = g_array_index (path, guint, path->len - 1 - i);
+        g_array_index (path, guint, path->len - 1 - i) = tmp;
+    }
+
+    return path;
+}
+
+/*
+ * A* from the exit of @source to the entry of @target_road in either
+ * direction, filling row STATE_DIR (@source) of @entry.
+ */
+static void
+search_plain (LrgRoadNetwork  *self,
+              guint32          source,
+              guint            target_road,
+              RouteCacheEntry *entry)
+{
+    SearchSpace *space;
+    HeapEntry top;
+    gfloat goals[6];
+    guint n_goals;
+    guint remaining;
+    guint32 i;
+    guint e;
+
+    space = &self->search[0];
+
+    n_goals = 0;
+    for (e = 0; e < 2; e++)
+    {
+        guint32 goal = MAKE_STATE (target_road, e);
+
+        if (state_is_valid (self, goal))
+        {
+            memcpy (&goals[n_goals * 3], &self->state_entry[goal * 3], sizeof (gfloat) * 3);
+            n_goals++;
+        }
+    }
+    remaining = n_goals;
+
+    search_space_begin (space);
+    for (i = self->edge_offsets[source]; i < self->edge_offsets[source + 1]; i++)
+    {
+        guint32 v = self->edge_targets[i];
+
+        if (search_space_update (space, v, 0.0, NO_INDEX))
+            heap_push (space->heap, heuristic (self, v, goals, n_goals), v);
+    }
+
+    while (remaining > 0 && heap_pop (space->heap, &top))
+    {
+        guint32 u = top.node;
+        gdouble next;
+
+        if (space->settled[u] == space->stamp)
+            continue;
+        space->settled[u] = space->stamp;
+
+        if (STATE_ROAD (u) == target_road)
+            remaining--;
+
+        next = space->dist[u] + self->state_time[u];
+        for (i = self->edge_offsets[u]; i < self->edge_offsets[u + 1]; i++)
+        {
+            guint32 v = self->edge_targets[i];
+
+            if (search_space_update (space, v, next, u))
+                heap_push (space->heap, next + heuristic (self, v, goals, n_goals), v);
+        }
+    }
+
+    for (e = 0; e < 2; e++)
+    {
+        guint32 goal = MAKE_STATE (target_road, e);
+
+        if (!state_is_valid (self, goal) || !search_space_has (space, goal))
+            continue;
+
+        entry->cost[STATE_DIR (source)][e] = space->dist[goal];
+        entry->path[STATE_DIR (source)][e] = path_from_parents (space, goal);
+    }
+}
+
+/* ==========================================================================
+ * Contraction hierarchy
+ * ========================================================================== */
+
+typedef struct
+{
+    GArray      *edges;
+    GArray     **out;
+    GArray     **in;
+    gboolean    *contracted;
+    guint       *deleted_neighbors;
+    SearchSpace  witness;
+} HierarchyBuilder;
+
+static void
+builder_add_edge (HierarchyBuilder *builder,
+                  guint32           from,
+                  guint32           to,
+                  gdouble           weight,
+                  guint32           child_a,
+                  guint32           child_b)
+{
+    ChEdge edge;
+    guint32 index;
+
+    edge.from = from;
+    edge.to = to;
+    edge.weight = weight;
+    edge.child_a = child_a;
+    edge.child_b = child_b;
+
+    index = builder->edges->len;
+    g_array_append_val (builder->edges, edge);
+    g_array_append_val (builder->out[from], index);
+    g_array_append_val (builder->in[to], index);
+}
+
+/* Bounded Dijkstra from @source that avoids @skip */
+static void
+witness_search (HierarchyBuilder *builder,
+                guint32           source,
+                guint32           skip,
+                gdouble           max_cost)
+{
+    SearchSpace *space;
+    HeapEntry top;
+    guint settled;
+
+    space = &builder->witness;
+    search_space_begin (space);
+    search_space_update (space, source, 0.0, NO_INDEX);
+    heap_push (space->heap, 0.0, source);
+
+    settled = 0;
+    while (settled < WITNESS_SETTLE_LIMIT && heap_pop (space->heap, &top))
+    {
+        guint32 u = top.node;
+        guint i;
+
+        if (space->settled[u] == space->stamp)
+            continue;
+        if (top.key > max_cost)
+            break;
+
+        space->settled[u] = space->stamp;
+        settled++;
+
+        for (i = 0; i < builder->out[u]->len; i++)
+        {
+            const ChEdge *edge;
+            gdouble next;
+
+            edge = &g_array_index (builder->edges, ChEdge,
+                                   g_array_index (builder->out[u], guint32, i));
+            if (edge->to == skip || builder->contracted[edge->to])
+                continue;
+
+            next = space->dist[u] + edge->weight;
+            if (search_space_update (space, edge->to, next, NO_INDEX))
+                heap_push (space->heap, next, edge->to);
+        }
+    }
+}
+
+/*
+ * Counts the shortcuts needed to remove @v from the remaining graph,
+ * adding them unless @simulate is set.
+ */
+static guint
+contract_node (HierarchyBuilder *builder,
+               guint32           v,
+               gboolean          simulate)
+{
+    guint shortcuts;
+    guint i;
+    guint j;
+
+    shortcuts = 0;
+    for (i = 0; i < builder->in[v]->len; i++)
+    {
+        guint32 in_index;
+        ChEdge in_edge;
+        gdouble max_cost;
+        gboolean has_out;
+
+        in_index = g_array_index (builder->in[v], guint32, i);
+        in_edge = g_array_index (builder->edges, ChEdge, in_index);
+        if (in_edge.from == v || builder->contracted[in_edge.from])
+            continue;
+
+        max_cost = 0.0;
+        has_out = FALSE;
+        for (j = 0; j < builder->out[v]->len; j++)
+        {
+            const ChEdge *out_edge;
+
+            out_edge = &g_array_index (builder->edges, ChEdge,
+                                       g_array_index (builder->out[v], guint32, j));
+            if (out_edge->to == v || out_edge->to == in_edge.from ||
+                builder->contracted[out_edge->to])
+                continue;
+
+            max_cost = MAX (max_cost, in_edge.weight + out_edge->weight);
+            has_out = TRUE;
+        }
+        if (!has_out)
+            continue;
+
+        witness_search (builder, in_edge.from, v, max_cost);
+
+        for (j = 0; j < builder->out[v]->len; j++)
+        {
+            guint32 out_index;
+            ChEdge out_edge;
+            gdouble weight;
+
+            out_index = g_array_index (builder->out[v], guint32, j);
+            out_edge = g_array_index (builder->edges, ChEdge, out_index);
+            if (out_edge.to == v || out_edge.to == in_edge.from ||
+                builder->contracted[out_edge.to])
+                continue;
+
+            weight = in_edge.weight + out_edge.weight;
+            if (search_space_has (&builder->witness, out_edge.to) &&
+                builder->witness.dist[out_edge.to] <= weight)
+                continue;
+
+            shortcuts++;
+            if (!simulate)
+                builder_add_edge (builder, in_edge.from, out_edge.to, weight,
+                                  in_index, out_index);
+        }
+    }
+
+    return shortcuts;
+}
+
+static guint
+count_active_neighbors (HierarchyBuilder *builder,
+                        guint32           v,
+                        gboolean          mark_deleted)
+{
+    guint count;
+    guint i;
+
+    count = 0;
+    for (i = 0; i < builder->in[v]->len; i++)
+    {
+        guint32 u = g_array_index (builder->edges, ChEdge,
+                                   g_array_index (builder->in[v], guint32, i)).from;
+
+        if (u != v && !builder->contracted[u])
+        {
+            count++;
+            if (mark_deleted)
+                builder->deleted_neighbors[u]++;
+        }
+    }
+    for (i = 0; i < builder->out[v]->len; i++)
+    {
+        guint32 x = g_array_index (builder->edges, ChEdge,
+                                   g_array_index (builder->out[v], guint32, i)).to;
+
+        if (x != v && !builder->contracted[x])
+        {
+            count++;
+            if (mark_deleted)
+                builder->deleted_neighbors[x]++;
+        }
+    }
+
+    return count;
+}
+
+static gdouble
+node_priority (HierarchyBuilder *builder,
+               guint32           v)
+{
+    return (gdouble)contract_node (builder, v, TRUE)
+           - (gdouble)count_active_neighbors (builder, v, FALSE)
+           + (gdouble)builder->deleted_neighbors[v];
+}
+
+static void
+build_edge_lists (LrgRoadNetwork  *self,
+                  const guint32   *rank)
+{
+    guint32 *up_fill;
+    guint32 *down_fill;
+    guint n;
+    guint i;
+
+    n = self->n_states;
+    g_free (self->ch_up_offsets);
+    g_free (self->ch_up_edges);
+    g_free (self->ch_down_offsets);
+    g_free (self->ch_down_edges);
+    self->ch_up_offsets = g_new0 (guint32, n + 1);
+    self->ch_down_offsets = g_new0 (guint32, n + 1);
+
+    /* Forward searches climb out-edges, backward ones climb in-edges */
+    for (i = 0; i < self->ch_edges->len; i++)
+    {
+        const ChEdge *edge = &g_array_index (self->ch_edges, ChEdge, i);
+
+        if (rank[edge->to] > rank[edge->from])
+            self->ch_up_offsets[edge->from + 1]++;
+        else if (rank[edge->from] > rank[edge->to])
+            self->ch_down_offsets[edge->to + 1]++;
+    }
+    for (i = 0; i < n; i++)
+    {
+        self->ch_up_offsets[i + 1] += self->ch_up_offsets[i];
+        self->ch_down_offsets[i + 1] += self->ch_down_offsets[i];
+    }
+
+    self->ch_up_edges = g_new (guint32, MAX (self->ch_up_offsets[n], 1));
+    self->ch_down_edges = g_new (guint32, MAX (self->ch_down_offsets[n], 1));
+    up_fill = g_memdup2 (self->ch_up_offsets, sizeof (guint32) * (n + 1));
+    down_fill = g_memdup2 (self->ch_down_offsets, sizeof (guint32) * (n + 1));
+
+    for (i = 0; i < self->ch_edges->len; i++)
+    {
+        const ChEdge *edge = &g_array_index (self->ch_edges, ChEdge, i);
+
+        if (rank[edge->to] > rank[edge->from])
+            self->ch_up_edges[up_fill[edge->from]++] = i;
+        else if (rank[edge->from] > rank[edge->to])
+            self->ch_down_edges[down_fill[edge->to]++] = i;
+    }
+
+    g_free (up_fill);
+    g_free (down_fill);
+}
+
+static void
+hierarchy_build (LrgRoadNetwork *self)
+{
+    HierarchyBuilder builder;
+    GArray *queue;
+    guint32 *rank;
+    guint32 next_rank;
+    HeapEntry top;
+    guint n;
+    guint32 u;
+    guint32 i;
+
+    n = self->n_states;
+
+    if (self->ch_edges == NULL)
+        self->ch_edges = g_array_new (FALSE, FALSE, sizeof (ChEdge));
+    g_array_set_size (self->ch_edges, 0);
+
+    memset (&builder, 0, sizeof (builder));
+    builder.edges = self->ch_edges;
+    builder.out = g_new (GArray *, MAX (n, 1));
+    builder.in = g_new (GArray *, MAX (n, 1));
+    builder.contracted = g_new0 (gboolean, MAX (n, 1));
+    builder.deleted_neighbors = g_new0 (guint, MAX (n, 1));
+    search_space_resize (&builder.witness, n);
+
+    for (u = 0; u < n; u++)
+    {
+        builder.out[u] = g_array_new (FALSE, FALSE, sizeof (guint32));
+        builder.in[u] = g_array_new (FALSE, FALSE, sizeof (guint32));
+    }
+    for (u = 0; u < n; u++)
+    {
+        for (i = self->edge_offsets[u]; i < self->edge_offsets[u + 1]; i++)
+            builder_add_edge (&builder, u, self->edge_targets[i],
+                              self->state_time[u], NO_INDEX, NO_INDEX);
+    }
+
+    /* Contract in order of edge difference, re-evaluating lazily */
+    queue = g_array_new (FALSE, FALSE, sizeof (HeapEntry));
+    for (u = 0; u < n; u++)
+        heap_push (queue, node_priority (&builder, u), u);
+
+    rank = g_new (guint32, MAX (n, 1));
+    next_rank = 0;
+    while (heap_pop (queue, &top))
+    {
+        gdouble priority;
+
+        u = top.node;
+        if (builder.contracted[u])
+            continue;
+
+        priority = node_priority (&builder, u);
+        if (queue->len > 0 && priority > g_array_index (queue, HeapEntry, 0).key)
+        {
+            heap_push (queue, priority, u);
+            continue;
+        }
+
+        contract_node (&builder, u, FALSE);
+        count_active_neighbors (&builder, u, TRUE);
+        builder.contracted[u] = TRUE;
+        rank[u] = next_rank++;
+    }
+
+    build_edge_lists (self, rank);
+
+    for (u = 0; u < n; u++)
+    {
+        g_array_unref (builder.out[u]);
+        g_array_unref (builder.in[u]);
+    }
+    g_free (builder.out);
+    g_free (builder.in);
+    g_free (builder.contracted);
+    g_free (builder.deleted_neighbors);
+    search_space_clear (&builder.witness);
+    g_array_unref (queue);
+    g_free (rank);
+
+    self->hierarchy_dirty = FALSE;
+}
+
+static void
+unpack_edge (LrgRoadNetwork *self,
+             guint32         index,
+             GArray         *path)
+{
+    const ChEdge *edge;
+
+    edge = &g_array_index (self->ch_edges, ChEdge, index);
+    if (edge->child_a == NO_INDEX)
+    {
+        guint road = STATE_ROAD (edge->to);
+
+        g_array_append_val (path, road);
+        return;
+    }
+
+    unpack_edge (self, edge->child_a, path);
+    unpack_edge (self, edge->child_b, path);
+}
+
+/*
+ * Bidirectional upward search from @source to @target. Returns the
+ * cost including the traversal of @source, or G_MAXDOUBLE.
+ */
+static gdouble
+hierarchy_query (LrgRoadNetwork  *self,
+                 guint32          source,
+                 guint32          target,
+                 GArray         **out_path)
+{
+    SearchSpace *spaces[2];
+    GArray *climb;
+    gboolean progressed;
+    gdouble best;
+    guint32 meet;
+    guint32 node;
+    guint side;
+    gint i;
+
+    spaces[0] = &self->search[0];
+    spaces[1] = &self->search[1];
+
+    search_space_begin (spaces[0]);
+    search_space_begin (spaces[1]);
+    search_space_update (spaces[0], source, 0.0, NO_INDEX);
+    heap_push (spaces[0]->heap, 0.0, source);
+    search_space_update (spaces[1], target, 0.0, NO_INDEX);
+    heap_push (spaces[1]->heap, 0.0, target);
+
+    best = G_MAXDOUBLE;
+    meet = NO_INDEX;
+
+    do
+    {
+        progressed = FALSE;
+
+        for (side = 0; side < 2; side++)
+        {
+            SearchSpace *space = spaces[side];
+            SearchSpace *other = spaces[1 - side];
+            const guint32 *offsets;
+            const guint32 *edges;
+            HeapEntry top;
+            guint32 u;
+            guint32 k;
+
+            if (space->heap->len == 0 ||
+                g_array_index (space->heap, HeapEntry, 0).key >= best)
+                continue;
+
+            heap_pop (space->heap, &top);
+            progressed = TRUE;
+
+            u = top.node;
+            if (space->settled[u] == space->stamp)
+                continue;
+            space->settled[u] = space->stamp;
+
+            if (search_space_has (other, u) && space->dist[u] + other->dist[u] < best)
+            {
+                best = space->dist[u] + other->dist[u];
+                meet = u;
+            }
+
+            offsets = side == 0 ? self->ch_up_offsets : self->ch_down_offsets;
+            edges = side == 0 ? self->ch_up_edges : self->ch_down_edges;
+            for (k = offsets[u]; k < offsets[u + 1]; k++)
+            {
+                const ChEdge *edge = &g_array_index (self->ch_edges, ChEdge, edges[k]);
+                guint32 v = side == 0 ? edge->to : edge->from;
+                gdouble next = space->dist[u] + edge->weight;
+
+                if (search_space_update (space, v, next, edges[k]))
+                    heap_push (space->heap, next, v);
+            }
+        }
+    }
+    while (progressed);
+
+    if (meet == NO_INDEX)
+        return G_MAXDOUBLE;
+
+    if (out_path != NULL)
+    {
+        *out_path = g_array_new (FALSE, FALSE, sizeof (guint));
+
+        climb = g_array_new (FALSE, FALSE, sizeof (guint32));
+        for (node = meet; spaces[0]->parent[node] != NO_INDEX;)
+        {
+            guint32 index = spaces[0]->parent[node];
+
+            g_array_append_val (climb, index);
+            node = g_array_index (self->ch_edges, ChEdge, index).from;
+        }
+        for (i = (gint)climb->len - 1; i >= 0; i--)
+            unpack_edge (self, g_array_index (climb, guint32, i), *out_path);
+        g_array_unref (climb);
+
+        for (node = meet; spaces[1]->parent[node] != NO_INDEX;)
+        {
+            guint32 index = spaces[1]->parent[node];
+
+            unpack_edge (self, index, *out_path);
+            node = g_array_index (self->ch_edges, ChEdge, index).to;
+        }
+    }
+
+    return best;
+}
+
+/* ==========================================================================
+ * Route cache
+ * ========================================================================== */
+
+static void
+route_cache_entry_free (RouteCacheEntry *entry)
+{
+    guint d;
+    guint e;
+
+    for (d = 0; d < 2; d++)
+    {
+        for (e = 0; e < 2; e++)
+        {
+            if (entry->path[d][e] != NULL)
+                g_array_unref (entry->path[d][e]);
+        }
+    }
+
+    g_slice_free (RouteCacheEntry, entry);
+}
+
+static void
+route_cache_clear (LrgRoadNetwork *self)
+{
+    g_hash_table_remove_all (self->route_cache);
+    g_queue_init (&self->route_lru);
+}
+
+static void
+route_cache_trim (LrgRoadNetwork *self,
+                  guint           size)
+{
+    while (self->route_lru.length > size)
+    {
+        GList *link = g_queue_pop_tail_link (&self->route_lru);
+        RouteCacheEntry *entry = link->data;
+
+        g_hash_table_remove (self->route_cache, &entry->key);
+    }
+}
+
+static void
+routes_invalidate (LrgRoadNetwork *self)
+{
+    self->graph_dirty = TRUE;
+    self->hierarchy_dirty = TRUE;
+    route_cache_clear (self);
+}
+
+static RouteCacheEntry *
+route_cache_compute (LrgRoadNetwork *self,
+                     guint           from_index,
+                     guint           to_index)
+{
+    RouteCacheEntry *entry;
+    guint d;
+    guint e;
+
+    entry = g_slice_new0 (RouteCacheEntry);
+    entry->key = ((guint64)from_index << 32) | to_index;
+    entry->link.data = entry;
+
+    for (d = 0; d < 2; d++)
+    {
+        guint32 source = MAKE_STATE (from_index, d);
+
+        for (e = 0; e < 2; e++)
+            entry->cost[d][e] = G_MAXDOUBLE;
+
+        if (!state_is_valid (self, source))
+            continue;
+
+        /* Same-road loops are cheap to search and awkward to express
+         * as a single hierarchy query. */
+        if (!self->contraction_enabled || from_index == to_index)
+        {
+            search_plain (self, source, to_index, entry);
+            continue;
+        }
+
+        for (e = 0; e < 2; e++)
+        {
+            guint32 target = MAKE_STATE (to_index, e);
+            gdouble cost;
+
+            if (!state_is_valid (self, target))
+                continue;
+
+            cost = hierarchy_query (self, source, target, &entry->path[d][e]);
+            if (cost < G_MAXDOUBLE)
+                entry->cost[d][e] = cost - self->state_time[source];
+        }
+    }
+
+    return entry;
+}
+
+/* Returns the pair entry, or a temporary one when caching is disabled */
+static RouteCacheEntry *
+route_cache_get (LrgRoadNetwork *self,
+                 guint           from_index,
+                 guint           to_index,
+                 gboolean       *out_cached)
+{
+    RouteCacheEntry *entry;
+    guint64 key;
+
+    key = ((guint64)from_index << 32) | to_index;
+    entry = g_hash_table_lookup (self->route_cache, &key);
+    if (entry != NULL)
+    {
+        g_queue_unlink (&self->route_lru, &entry->link);
+        g_queue_push_head_link (&self->route_lru, &entry->link);
+        *out_cached = TRUE;
+        return entry;
+    }
+
+    entry = route_cache_compute (self, from_index, to_index);
+    *out_cached = self->route_cache_size > 0;
+    if (*out_cached)
+    {
+        g_hash_table_insert (self->route_cache, &entry->key, entry);
+        g_queue_push_head_link (&self->route_lru, &entry->link);
+        route_cache_trim (self, self->route_cache_size);
+    }
+
+    return entry;
+}
+
 static void
 lrg_road_network_finalize (GObject *object)
 {
@@ -75,6 +1257,24 @@ lrg_road_network_finalize (GObject *object)
     g_hash_table_unref (self->roads);
     g_hash_table_unref (self->connections);
     g_list_free (self->road_list);
+    g_ptr_array_unref (self->road_slots);
+    g_hash_table_unref (self->road_indices);
+
+    g_free (self->edge_offsets);
+    g_free (self->edge_targets);
+    g_free (self->state_time);
+    g_free (self->state_entry);
+    search_space_clear (&self->search[0]);
+    search_space_clear (&self->search[1]);
+
+    if (self->ch_edges != NULL)
+        g_array_unref (self->ch_edges);
+    g_free (self->ch_up_offsets);
+    g_free (self->ch_up_edges);
+    g_free (self->ch_down_offsets);
+    g_free (self->ch_down_edges);
+
+    g_hash_table_unref (self->route_cache);
 
     G_OBJECT_CLASS (lrg_road_network_parent_class)->finalize (object);
 }
@@ -98,6 +1298,16 @@ lrg_road_network_init (LrgRoadNetwork *self)
                                                g_free, (GDestroyNotify)connection_list_free);
     self->road_list = NULL;
     self->list_dirty = TRUE;
+
+    self->road_slots = g_ptr_array_new ();
+    self->road_indices = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    self->graph_dirty = TRUE;
+    self->hierarchy_dirty = TRUE;
+
+    self->route_cache = g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL,
+                                               (GDestroyNotify)route_cache_entry_free);
+    g_queue_init (&self->route_lru);
+    self->route_cache_size = DEFAULT_ROUTE_CACHE_SIZE;
 }
 
 LrgRoadNetwork *
@@ -124,7 +1334,11 @@ lrg_road_network_add_road (LrgRoadNetwork *self,
         return FALSE;
 
     g_hash_table_insert (self->roads, g_strdup (road_id), road);
+    g_hash_table_insert (self->road_indices, g_strdup (road_id),
+                         GUINT_TO_POINTER (self->road_slots->len + 1));
+    g_ptr_array_add (self->road_slots, road);
     self->list_dirty = TRUE;
+    routes_invalidate (self);
 
     return TRUE;
 }
@@ -145,6 +1359,7 @@ lrg_road_network_remove_road (LrgRoadNetwork *self,
 {
     gchar *key_start;
     gchar *key_end;
+    guint index;
 
     g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), FALSE);
     g_return_val_if_fail (road_id != NULL, FALSE);
@@ -152,6 +1367,11 @@ lrg_road_network_remove_road (LrgRoadNetwork *self,
     if (!g_hash_table_contains (self->roads, road_id))
         return FALSE;
 
+    /* The index stays reserved so other indices remain valid */
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (self->road_indices, road_id));
+    g_ptr_array_index (self->road_slots, index - 1) = NULL;
+    g_hash_table_remove (self->road_indices, road_id);
+
     /* Remove connections */
     key_start = make_connection_key (road_id, FALSE);
     key_end = make_connection_key (road_id, TRUE);
@@ -165,6 +1385,7 @@ lrg_road_network_remove_road (LrgRoadNetwork *self,
     /* Remove road */
     g_hash_table_remove (self->roads, road_id);
     self->list_dirty = TRUE;
+    routes_invalidate (self);
 
     return TRUE;
 }
@@ -237,6 +1458,7 @@ lrg_road_network_connect (LrgRoadNetwork *self,
     /* Update hash table (steal old list if exists) */
     g_hash_table_steal (self->connections, key);
     g_hash_table_insert (self->connections, key, connections);
+    routes_invalidate (self);
 
     return TRUE;
 }
@@ -282,7 +1504,9 @@ lrg_road_network_disconnect (LrgRoadNetwork *self,
         }
     }
 
-    if (!found)
+    if (found)
+        routes_invalidate (self);
+    else
         g_free (key);
 
     return found;
@@ -316,9 +1540,6 @@ lrg_road_network_get_connections (LrgRoadNetwork *self,
     return result;
 }
 
-/*
- * Simple BFS pathfinding
- */
 gboolean
 lrg_road_network_find_route (LrgRoadNetwork *self,
                              const gchar    *from_road_id,
@@ -327,105 +1548,208 @@ lrg_road_network_find_route (LrgRoadNetwork *self,
                              gfloat          to_t,
                              GList         **out_road_sequence)
 {
-    GQueue *queue;
-    GHashTable *visited;
-    GHashTable *came_from;
-    gboolean found;
+    GArray *route;
     GList *path;
-    GList *l;
+    gint from_index;
+    gint to_index;
+    gint i;
 
     g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), FALSE);
     g_return_val_if_fail (from_road_id != NULL, FALSE);
     g_return_val_if_fail (to_road_id != NULL, FALSE);
 
-    (void)from_t;
-    (void)to_t;
+    if (out_road_sequence != NULL)
+        *out_road_sequence = NULL;
 
-    /* Same road? */
-    if (g_strcmp0 (from_road_id, to_road_id) == 0)
-    {
-        if (out_road_sequence != NULL)
-            *out_road_sequence = g_list_append (NULL, (gpointer)from_road_id);
+    from_index = lrg_road_network_get_road_index (self, from_road_id);
+    to_index = lrg_road_network_get_road_index (self, to_road_id);
+    if (from_index < 0 || to_index < 0)
+        return FALSE;
+
+    route = NULL;
+    if (!lrg_road_network_find_route_indices (self, from_index, from_t, to_index, to_t,
+                                              out_road_sequence != NULL ? &route : NULL,
+                                              NULL))
+        return FALSE;
+
+    if (route == NULL)
         return TRUE;
+
+    path = NULL;
+    for (i = (gint)route->len - 1; i >= 0; i--)
+    {
+        LrgRoad *road = road_at (self, g_array_index (route, guint, i));
+
+        path = g_list_prepend (path, (gpointer)lrg_road_get_id (road));
     }
+    g_array_unref (route);
 
-    /* BFS */
-    queue = g_queue_new ();
-    visited = g_hash_table_new (g_str_hash, g_str_equal);
-    came_from = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, NULL);
+    *out_road_sequence = path;
 
-    g_queue_push_tail (queue, (gpointer)from_road_id);
-    g_hash_table_add (visited, (gpointer)from_road_id);
+    return TRUE;
+}
 
-    found = FALSE;
+gboolean
+lrg_road_network_find_route_indices (LrgRoadNetwork  *self,
+                                     guint            from_index,
+                                     gfloat           from_t,
+                                     guint            to_index,
+                                     gfloat           to_t,
+                                     GArray         **out_route,
+                                     gfloat          *out_cost)
+{
+    RouteCacheEntry *entry;
+    LrgRoad *from_road;
+    LrgRoad *to_road;
+    GArray *best_path;
+    gboolean cached;
+    gdouble from_time;
+    gdouble to_time;
+    gdouble best;
+    guint d;
+    guint e;
 
-    while (!g_queue_is_empty (queue))
-    {
-        const gchar *current;
-        GList *neighbors_start;
-        GList *neighbors_end;
+    g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), FALSE);
 
-        current = g_queue_pop_head (queue);
+    if (out_route != NULL)
+        *out_route = NULL;
 
-        if (g_strcmp0 (current, to_road_id) == 0)
-        {
-            found = TRUE;
-            break;
-        }
+    from_road = road_at (self, from_index);
+    to_road = road_at (self, to_index);
+    if (from_road == NULL || to_road == NULL)
+        return FALSE;
 
-        /* Get connections from both ends */
-        neighbors_start = lrg_road_network_get_connections (self, current, FALSE);
-        neighbors_end = lrg_road_network_get_connections (self, current, TRUE);
+    if (self->graph_dirty)
+        routing_graph_build (self);
+    if (self->contraction_enabled && self->hierarchy_dirty)
+        hierarchy_build (self);
 
-        for (l = neighbors_start; l != NULL; l = l->next)
-        {
-            const gchar *neighbor = l->data;
-            if (!g_hash_table_contains (visited, neighbor))
-            {
-                g_hash_table_add (visited, (gpointer)neighbor);
-                g_hash_table_insert (came_from, (gpointer)neighbor, (gpointer)current);
-                g_queue_push_tail (queue, (gpointer)neighbor);
-            }
-        }
+    from_time = road_time_to (from_road, from_t);
+    to_time = road_time_to (to_road, to_t);
+    best = G_MAXDOUBLE;
+    best_path = NULL;
 
-        for (l = neighbors_end; l != NULL; l = l->next)
+    /* Staying on the current road, if it is heading the right way */
+    if (from_index == to_index)
+    {
+        if (to_t >= from_t)
+            best = to_time - from_time;
+        if (to_t <= from_t && !lrg_road_is_one_way (from_road))
+            best = MIN (best, from_time - to_time);
+    }
+
+    entry = route_cache_get (self, from_index, to_index, &cached);
+    for (d = 0; d < 2; d++)
+    {
+        for (e = 0; e < 2; e++)
         {
-            const gchar *neighbor = l->data;
-            if (!g_hash_table_contains (visited, neighbor))
+            gdouble leave;
+            gdouble arrive;
+            gdouble total;
+
+            if (entry->cost[d][e] == G_MAXDOUBLE)
+                continue;
+
+            leave = d == STATE_FORWARD
+                ? self->state_time[MAKE_STATE (from_index, d)] - from_time
+                : from_time;
+            arrive = e == STATE_FORWARD
+                ? to_time
+                : self->state_time[MAKE_STATE (to_index, e)] - to_time;
+
+            total = leave + entry->cost[d][e] + arrive;
+            if (total < best)
             {
-                g_hash_table_add (visited, (gpointer)neighbor);
-                g_hash_table_insert (came_from, (gpointer)neighbor, (gpointer)current);
-                g_queue_push_tail (queue, (gpointer)neighbor);
+                best = total;
+                best_path = entry->path[d][e];
             }
         }
-
-        g_list_free (neighbors_start);
-        g_list_free (neighbors_end);
     }
 
-    /* Reconstruct path */
-    path = NULL;
-    if (found)
+    if (best < G_MAXDOUBLE)
     {
-        const gchar *current = to_road_id;
-
-        while (current != NULL)
+        if (out_route != NULL)
         {
-            path = g_list_prepend (path, (gpointer)current);
-            current = g_hash_table_lookup (came_from, current);
+            *out_route = g_array_new (FALSE, FALSE, sizeof (guint));
+            g_array_append_val (*out_route, from_index);
+            if (best_path != NULL)
+                g_array_append_vals (*out_route, best_path->data, best_path->len);
         }
+        if (out_cost != NULL)
+            *out_cost = (gfloat)best;
     }
 
-    g_queue_free (queue);
-    g_hash_table_unref (visited);
-    g_hash_table_unref (came_from);
+    if (!cached)
+        route_cache_entry_free (entry);
 
-    if (out_road_sequence != NULL)
-        *out_road_sequence = path;
-    else
-        g_list_free (path);
+    return best < G_MAXDOUBLE;
+}
 
-    return found;
+gint
+lrg_road_network_get_road_index (LrgRoadNetwork *self,
+                                 const gchar    *road_id)
+{
+    g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), -1);
+    g_return_val_if_fail (road_id != NULL, -1);
+
+    return (gint)GPOINTER_TO_UINT (g_hash_table_lookup (self->road_indices, road_id)) - 1;
+}
+
+LrgRoad *
+lrg_road_network_get_road_by_index (LrgRoadNetwork *self,
+                                    guint           index)
+{
+    g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), NULL);
+
+    return road_at (self, index);
+}
+
+void
+lrg_road_network_set_route_cache_size (LrgRoadNetwork *self,
+                                       guint           size)
+{
+    g_return_if_fail (LRG_IS_ROAD_NETWORK (self));
+
+    self->route_cache_size = size;
+    route_cache_trim (self, size);
+}
+
+guint
+lrg_road_network_get_route_cache_size (LrgRoadNetwork *self)
+{
+    g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), 0);
+
+    return self->route_cache_size;
+}
+
+void
+lrg_road_network_set_contraction_enabled (LrgRoadNetwork *self,
+                                          gboolean        enabled)
+{
+    g_return_if_fail (LRG_IS_ROAD_NETWORK (self));
+
+    enabled = !!enabled;
+    if (self->contraction_enabled == enabled)
+        return;
+
+    self->contraction_enabled = enabled;
+    route_cache_clear (self);
+}
+
+gboolean
+lrg_road_network_get_contraction_enabled (LrgRoadNetwork *self)
+{
+    g_return_val_if_fail (LRG_IS_ROAD_NETWORK (self), FALSE);
+
+    return self->contraction_enabled;
+}
+
+void
+lrg_road_network_invalidate_routes (LrgRoadNetwork *self)
+{
+    g_return_if_fail (LRG_IS_ROAD_NETWORK (self));
+
+    routes_invalidate (self);
 }
 
 gfloat
@@ -572,4 +1896,8 @@ lrg_road_network_clear (LrgRoadNetwork *self)
     g_list_free (self->road_list);
     self->road_list = NULL;
     self->list_dirty = TRUE;
+
+    g_ptr_array_set_size (self->road_slots, 0);
+    g_hash_table_remove_all (self->road_indices);
+    routes_invalidate (self);
 }
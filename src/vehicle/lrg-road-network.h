@@ -8,6 +8,12 @@
  *
  * Manages a collection of roads with connections between them.
  * Provides pathfinding for traffic AI navigation.
+ *
+ * Routes minimise travel time (segment length over speed limit) with
+ * A* over a compact adjacency array built from the connections. For
+ * static networks an optional contraction hierarchy speeds queries up
+ * further. Answers are cached per road pair and the cache is dropped
+ * whenever roads or connections change.
  */
 
 #pragma once
@@ -192,9 +198,17 @@ lrg_road_network_get_connections (LrgRoadNetwork *self,
  * @from_t: Starting position (0-1)
  * @to_road_id: Destination road
  * @to_t: Destination position (0-1)
- * @out_road_sequence: (out) (element-type utf8) (transfer container): Sequence of road IDs
+ * @out_road_sequence: (out) (optional) (element-type utf8) (transfer container): Sequence of road IDs
+ *
+ * Finds the fastest route between two points. Connections are directed:
+ * a road is left at the end it was connected from and entered at the
+ * end it was connected to, and one-way roads are only driven from
+ * start to end. The sequence starts with @from_road_id and ends with
+ * @to_road_id; the same road may appear twice when the route loops
+ * back onto it.
  *
- * Finds a route between two points.
+ * Route queries share scratch buffers and the route cache, so this is
+ * not thread-safe.
  *
  * Returns: %TRUE if route found
  *
@@ -209,6 +223,142 @@ lrg_road_network_find_route (LrgRoadNetwork *self,
                              gfloat          to_t,
                              GList         **out_road_sequence);
 
+/**
+ * lrg_road_network_find_route_indices:
+ * @self: an #LrgRoadNetwork
+ * @from_index: Starting road index
+ * @from_t: Starting position (0-1)
+ * @to_index: Destination road index
+ * @to_t: Destination position (0-1)
+ * @out_route: (out) (optional) (element-type guint) (transfer full): Sequence of road indices
+ * @out_cost: (out) (optional): Travel time of the route in seconds
+ *
+ * Like lrg_road_network_find_route() but works on the integer indices
+ * from lrg_road_network_get_road_index(), avoiding string lookups for
+ * callers that route many agents.
+ *
+ * Returns: %TRUE if route found
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_road_network_find_route_indices (LrgRoadNetwork  *self,
+                                     guint            from_index,
+                                     gfloat           from_t,
+                                     guint            to_index,
+                                     gfloat           to_t,
+                                     GArray         **out_route,
+                                     gfloat          *out_cost);
+
+/**
+ * lrg_road_network_get_road_index:
+ * @self: an #LrgRoadNetwork
+ * @road_id: Road ID
+ *
+ * Gets the integer index of a road. Indices are assigned in the order
+ * roads are added and stay valid until the road is removed or the
+ * network is cleared; removed indices are not reused.
+ *
+ * Returns: The index, or -1 if there is no such road
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gint
+lrg_road_network_get_road_index (LrgRoadNetwork *self,
+                                 const gchar    *road_id);
+
+/**
+ * lrg_road_network_get_road_by_index:
+ * @self: an #LrgRoadNetwork
+ * @index: Road index
+ *
+ * Gets a road by its integer index.
+ *
+ * Returns: (transfer none) (nullable): The road, or %NULL
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgRoad *
+lrg_road_network_get_road_by_index (LrgRoadNetwork *self,
+                                    guint           index);
+
+/**
+ * lrg_road_network_set_route_cache_size:
+ * @self: an #LrgRoadNetwork
+ * @size: Maximum number of cached road pairs, 0 to disable
+ *
+ * Sets how many road pair answers are kept. The least recently used
+ * ones are dropped first. Defaults to 1024.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_road_network_set_route_cache_size (LrgRoadNetwork *self,
+                                       guint           size);
+
+/**
+ * lrg_road_network_get_route_cache_size:
+ * @self: an #LrgRoadNetwork
+ *
+ * Gets the route cache capacity.
+ *
+ * Returns: Maximum number of cached road pairs
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_road_network_get_route_cache_size (LrgRoadNetwork *self);
+
+/**
+ * lrg_road_network_set_contraction_enabled:
+ * @self: an #LrgRoadNetwork
+ * @enabled: Whether to use a contraction hierarchy
+ *
+ * Enables contraction hierarchy routing. The hierarchy is built on the
+ * first query after any change to the network, which costs far more
+ * than a single search, so only enable it for networks that are
+ * static while agents drive on them.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_road_network_set_contraction_enabled (LrgRoadNetwork *self,
+                                          gboolean        enabled);
+
+/**
+ * lrg_road_network_get_contraction_enabled:
+ * @self: an #LrgRoadNetwork
+ *
+ * Gets whether contraction hierarchy routing is enabled.
+ *
+ * Returns: %TRUE if enabled
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_road_network_get_contraction_enabled (LrgRoadNetwork *self);
+
+/**
+ * lrg_road_network_invalidate_routes:
+ * @self: an #LrgRoadNetwork
+ *
+ * Drops cached routes and the routing graph. Adding, removing and
+ * connecting roads does this automatically; call it after editing the
+ * waypoints or speed limits of a road already in the network.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_road_network_invalidate_routes (LrgRoadNetwork *self);
+
 /**
  * lrg_road_network_get_route_length:
  * @self: an #LrgRoadNetwork
@@ -0,0 +1,62 @@
+/* lrg-traffic-agent-private.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Hooks LrgTrafficManager uses to drive agents in batches.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+#include "lrg-traffic-agent.h"
+
+G_BEGIN_DECLS
+
+/*
+ * lrg_traffic_agent_set_managed:
+ * @self: an #LrgTrafficAgent
+ * @managed: whether a manager drives this agent
+ *
+ * Managed agents take their road position and obstacle distance from
+ * lrg_traffic_agent_set_frame() instead of searching the network, and
+ * hold their signals back until lrg_traffic_agent_flush_events().
+ * Leaving managed mode flushes anything pending.
+ */
+void     lrg_traffic_agent_set_managed        (LrgTrafficAgent *self,
+                                               gboolean         managed);
+
+/*
+ * lrg_traffic_agent_set_frame:
+ * @self: an #LrgTrafficAgent
+ * @road_id: (nullable): road the vehicle is on, owned by the network
+ * @t: position along @road_id
+ * @obstacle_distance: nearest vehicle ahead, or %G_MAXFLOAT
+ *
+ * Sets the inputs for the next managed update.
+ */
+void     lrg_traffic_agent_set_frame          (LrgTrafficAgent *self,
+                                               const gchar     *road_id,
+                                               gfloat           t,
+                                               gfloat           obstacle_distance);
+
+/*
+ * lrg_traffic_agent_has_pending_events:
+ * @self: an #LrgTrafficAgent
+ *
+ * Returns: %TRUE if a managed update held back a signal
+ */
+gboolean lrg_traffic_agent_has_pending_events (LrgTrafficAgent *self);
+
+/*
+ * lrg_traffic_agent_flush_events:
+ * @self: an #LrgTrafficAgent
+ *
+ * Emits the signals held back by managed updates. Must be called on
+ * the thread that owns the agent.
+ */
+void     lrg_traffic_agent_flush_events       (LrgTrafficAgent *self);
+
+G_END_DECLS
@@ -10,6 +10,7 @@
 #include <math.h>
 
 #include "lrg-traffic-agent.h"
+#include "lrg-traffic-agent-private.h"
 
 /* Default values */
 #define DEFAULT_MAX_SPEED           30.0f
@@ -64,6 +65,15 @@ typedef struct _LrgTrafficAgentPrivate
     /* Internal state */
     gfloat target_speed;
     gfloat steering_input;
+
+    /* Set while an LrgTrafficManager drives this agent */
+    gboolean managed;
+    const gchar *frame_road_id;
+    gfloat frame_t;
+    gfloat frame_obstacle;
+    gboolean pending_destination;
+    gboolean pending_obstacle;
+    gfloat pending_obstacle_distance;
 } LrgTrafficAgentPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE (LrgTrafficAgent, lrg_traffic_agent, G_TYPE_OBJECT)
@@ -304,6 +314,14 @@ lrg_traffic_agent_init (LrgTrafficAgent *self)
 
     priv->target_speed = 0.0f;
     priv->steering_input = 0.0f;
+
+    priv->managed = FALSE;
+    priv->frame_road_id = NULL;
+    priv->frame_t = 0.0f;
+    priv->frame_obstacle = G_MAXFLOAT;
+    priv->pending_destination = FALSE;
+    priv->pending_obstacle = FALSE;
+    priv->pending_obstacle_distance = 0.0f;
 }
 
 /*
@@ -351,24 +369,85 @@ check_obstacles (LrgTrafficAgent *self,
         gfloat dx, dy, dz;
         gfloat dist;
         gfloat dot;
+        gfloat reach;
 
         dx = obs->x - veh_x;
         dy = obs->y - veh_y;
         dz = obs->z - veh_z;
 
-        dist = sqrtf (dx * dx + dy * dy + dz * dz) - obs->radius;
-
         /* Check if ahead of vehicle */
         dot = dx * forward_x + dz * forward_z;
-        if (dot > 0.0f && dist < nearest_dist && dist < priv->detection_range)
-        {
+        if (dot <= 0.0f)
+            continue;
+
+        /* Reject out-of-range obstacles before taking the root */
+        reach = priv->detection_range + obs->radius;
+        if (dx * dx + dy * dy + dz * dz >= reach * reach)
+            continue;
+
+        dist = sqrtf (dx * dx + dy * dy + dz * dz) - obs->radius;
+        if (dist < nearest_dist)
             nearest_dist = dist;
-        }
     }
 
     return nearest_dist;
 }
 
+/*
+ * set_current_road:
+ *
+ * Updates the cached road position, only reallocating the ID when the
+ * agent actually changes road.
+ */
+static void
+set_current_road (LrgTrafficAgentPrivate *priv,
+                  const gchar            *road_id,
+                  gfloat                  t)
+{
+    if (g_strcmp0 (priv->current_road_id, road_id) != 0)
+    {
+        g_free (priv->current_road_id);
+        priv->current_road_id = g_strdup (road_id);
+    }
+    priv->current_t = t;
+}
+
+/*
+ * Managed agents may be updated on a worker thread, so their signals
+ * are held back until the manager flushes them on its own thread.
+ */
+static void
+notify_destination_reached (LrgTrafficAgent *self)
+{
+    LrgTrafficAgentPrivate *priv;
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    if (priv->managed)
+        priv->pending_destination = TRUE;
+    else
+        g_signal_emit (self, signals[SIGNAL_DESTINATION_REACHED], 0);
+}
+
+static void
+notify_obstacle_detected (LrgTrafficAgent *self,
+                          gfloat           distance)
+{
+    LrgTrafficAgentPrivate *priv;
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    if (priv->managed)
+    {
+        priv->pending_obstacle = TRUE;
+        priv->pending_obstacle_distance = distance;
+    }
+    else
+    {
+        g_signal_emit (self, signals[SIGNAL_OBSTACLE_DETECTED], 0, distance);
+    }
+}
+
 /*
  * lrg_traffic_agent_real_update_ai:
  *
@@ -402,6 +481,12 @@ lrg_traffic_agent_real_update_ai (LrgTrafficAgent *self,
     lrg_vehicle_get_forward_vector (priv->vehicle, &forward_x, &forward_y, &forward_z);
 
     /* Update current road position */
+    if (priv->managed)
+    {
+        if (priv->frame_road_id != NULL)
+            set_current_road (priv, priv->frame_road_id, priv->frame_t);
+    }
+    else
     {
         const gchar *nearest_road;
         gfloat t, dist;
@@ -409,9 +494,7 @@ lrg_traffic_agent_real_update_ai (LrgTrafficAgent *self,
         if (lrg_road_network_get_nearest_road (priv->network, veh_x, veh_y, veh_z,
                                                &nearest_road, &t, &dist))
         {
-            g_free (priv->current_road_id);
-            priv->current_road_id = g_strdup (nearest_road);
-            priv->current_t = t;
+            set_current_road (priv, nearest_road, t);
         }
     }
 
@@ -431,7 +514,7 @@ lrg_traffic_agent_real_update_ai (LrgTrafficAgent *self,
                 {
                     priv->state = LRG_TRAFFIC_STATE_ARRIVED;
                     priv->has_destination = FALSE;
-                    g_signal_emit (self, signals[SIGNAL_DESTINATION_REACHED], 0);
+                    notify_destination_reached (self);
                     return;
                 }
             }
@@ -479,11 +562,13 @@ lrg_traffic_agent_real_update_ai (LrgTrafficAgent *self,
 
     /* Check for obstacles */
     obstacle_dist = check_obstacles (self, veh_x, veh_y, veh_z, forward_x, forward_z);
+    if (priv->managed)
+        obstacle_dist = fminf (obstacle_dist, priv->frame_obstacle);
 
     if (obstacle_dist < priv->detection_range)
     {
         priv->state = LRG_TRAFFIC_STATE_AVOIDING;
-        g_signal_emit (self, signals[SIGNAL_OBSTACLE_DETECTED], 0, obstacle_dist);
+        notify_obstacle_detected (self, obstacle_dist);
 
         /* Slow down based on distance */
         if (obstacle_dist < 5.0f)
@@ -815,6 +900,18 @@ lrg_traffic_agent_set_obstacle_detection_range (LrgTrafficAgent *self,
     priv->detection_range = range;
 }
 
+gfloat
+lrg_traffic_agent_get_obstacle_detection_range (LrgTrafficAgent *self)
+{
+    LrgTrafficAgentPrivate *priv;
+
+    g_return_val_if_fail (LRG_IS_TRAFFIC_AGENT (self), DEFAULT_DETECTION_RANGE);
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    return priv->detection_range;
+}
+
 void
 lrg_traffic_agent_add_obstacle (LrgTrafficAgent *self,
                                 gfloat           x,
@@ -908,3 +1005,75 @@ lrg_traffic_agent_is_active (LrgTrafficAgent *self)
 
     return priv->is_active;
 }
+
+/*
+ * Manager hooks (see lrg-traffic-agent-private.h)
+ */
+
+void
+lrg_traffic_agent_set_managed (LrgTrafficAgent *self,
+                               gboolean         managed)
+{
+    LrgTrafficAgentPrivate *priv;
+
+    g_return_if_fail (LRG_IS_TRAFFIC_AGENT (self));
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    /* Deliver anything still held back before switching modes */
+    if (!managed)
+        lrg_traffic_agent_flush_events (self);
+
+    priv->managed = managed;
+    priv->frame_road_id = NULL;
+    priv->frame_obstacle = G_MAXFLOAT;
+}
+
+void
+lrg_traffic_agent_set_frame (LrgTrafficAgent *self,
+                             const gchar     *road_id,
+                             gfloat           t,
+                             gfloat           obstacle_distance)
+{
+    LrgTrafficAgentPrivate *priv;
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    priv->frame_road_id = road_id;
+    priv->frame_t = t;
+    priv->frame_obstacle = obstacle_distance;
+}
+
+gboolean
+lrg_traffic_agent_has_pending_events (LrgTrafficAgent *self)
+{
+    LrgTrafficAgentPrivate *priv;
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    return priv->pending_destination || priv->pending_obstacle;
+}
+
+void
+lrg_traffic_agent_flush_events (LrgTrafficAgent *self)
+{
+    LrgTrafficAgentPrivate *priv;
+    gboolean destination;
+    gboolean obstacle;
+
+    g_return_if_fail (LRG_IS_TRAFFIC_AGENT (self));
+
+    priv = lrg_traffic_agent_get_instance_private (self);
+
+    destination = priv->pending_destination;
+    obstacle = priv->pending_obstacle;
+    priv->pending_destination = FALSE;
+    priv->pending_obstacle = FALSE;
+
+    /* Same order as an unmanaged update could produce them */
+    if (obstacle)
+        g_signal_emit (self, signals[SIGNAL_OBSTACLE_DETECTED], 0,
+                       priv->pending_obstacle_distance);
+    if (destination)
+        g_signal_emit (self, signals[SIGNAL_DESTINATION_REACHED], 0);
+}
@@ -352,6 +352,20 @@ void
 lrg_traffic_agent_set_obstacle_detection_range (LrgTrafficAgent *self,
                                                 gfloat           range);
 
+/**
+ * lrg_traffic_agent_get_obstacle_detection_range:
+ * @self: an #LrgTrafficAgent
+ *
+ * Gets obstacle detection range.
+ *
+ * Returns: Detection range
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat
+lrg_traffic_agent_get_obstacle_detection_range (LrgTrafficAgent *self);
+
 /**
  * lrg_traffic_agent_add_obstacle:
  * @self: an #LrgTrafficAgent
@@ -393,6 +407,10 @@ lrg_traffic_agent_clear_obstacles (LrgTrafficAgent *self);
  *
  * Updates the traffic agent AI.
  *
+ * Agents owned by an #LrgTrafficManager are updated by the manager,
+ * possibly on a worker thread; overrides of the update_ai vfunc must
+ * then only touch the agent and its vehicle.
+ *
  * Since: 1.0
  */
 LRG_AVAILABLE_IN_ALL
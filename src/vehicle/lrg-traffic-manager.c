@@ -0,0 +1,795 @@
+/* lrg-traffic-manager.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include "config.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "lrg-traffic-manager.h"
+#include "lrg-traffic-agent-private.h"
+
+#define DEFAULT_LANE_WIDTH      (3.5f)
+
+/* Batches smaller than this are not worth handing to threads */
+#define PARALLEL_MIN_AGENTS     (256)
+#define CHUNKS_PER_THREAD       (4)
+
+#define NO_LANE                 (G_MAXUINT)
+#define NO_LEADER               (G_MAXUINT)
+
+/*
+ * Per-agent simulation data, rebuilt from the vehicle every frame
+ * except for the road index, which seeds the next frame's search.
+ */
+typedef struct
+{
+    LrgTrafficAgent *agent;
+    gboolean         has_vehicle;
+    gfloat           x;
+    gfloat           y;
+    gfloat           z;
+    gfloat           forward_x;
+    gfloat           forward_z;
+    gfloat           range;
+    gint             road;
+    gfloat           t;
+    guint            lane;       /* road * 2, +1 when driving against it */
+    guint            leader;
+    gfloat           leader_gap;
+} TrafficSlot;
+
+typedef struct
+{
+    guint  lane;
+    gfloat t;
+    guint  slot;
+} LaneEntry;
+
+typedef enum
+{
+    PHASE_LOCATE,
+    PHASE_DRIVE
+} TrafficPhase;
+
+typedef struct
+{
+    LrgTrafficManager *manager;
+    TrafficPhase       phase;
+    guint              begin;
+    guint              end;
+    gfloat             delta;
+} TrafficChunk;
+
+struct _LrgTrafficManager
+{
+    GObject parent_instance;
+
+    LrgRoadNetwork *network;
+
+    /* Agents and their slots share indices */
+    GPtrArray  *agents;
+    GArray     *slots;
+    GHashTable *agent_indices;   /* agent -> index + 1 */
+
+    /* Vehicles sorted by lane, then position along the road */
+    GArray *lanes;
+
+    /* Spatial hash in CSR form: bucket b holds
+     * cell_slots[cell_start[b] .. cell_start[b + 1]] */
+    guint  *cell_start;
+    guint  *cell_slots;
+    guint   n_buckets;
+    gfloat  cell_size;
+
+    gfloat lane_width;
+
+    /* Parallel updates */
+    guint        max_threads;
+    GThreadPool *pool;
+    GMutex       lock;
+    GCond        cond;
+    guint        pending;
+};
+
+G_DEFINE_TYPE (LrgTrafficManager, lrg_traffic_manager, G_TYPE_OBJECT)
+
+/* ==========================================================================
+ * Spatial hash
+ * ========================================================================== */
+
+static inline guint
+cell_bucket (LrgTrafficManager *self,
+             gint               cx,
+             gint               cz)
+{
+    return (((guint)cx * 73856093u) ^ ((guint)cz * 19349663u)) & (self->n_buckets - 1);
+}
+
+static void
+build_spatial_hash (LrgTrafficManager *self)
+{
+    guint n;
+    guint i;
+    gfloat cell_size;
+
+    n = self->slots->len;
+
+    /* Cells as large as the longest detection range keep every query
+     * within the 3x3 block around the vehicle */
+    cell_size = 1.0f;
+    for (i = 0; i < n; i++)
+        cell_size = fmaxf (cell_size, g_array_index (self->slots, TrafficSlot, i).range);
+    self->cell_size = cell_size;
+
+    self->n_buckets = 16;
+    while (self->n_buckets < n * 2)
+        self->n_buckets *= 2;
+
+    g_free (self->cell_start);
+    g_free (self->cell_slots);
+    self->cell_start = g_new0 (guint, self->n_buckets + 1);
+    self->cell_slots = g_new (guint, MAX (n, 1));
+
+    for (i = 0; i < n; i++)
+    {
+        TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, i);
+
+        if (slot->has_vehicle)
+            self->cell_start[cell_bucket (self, (gint)floorf (slot->x / cell_size),
+                                          (gint)floorf (slot->z / cell_size)) + 1]++;
+    }
+    for (i = 0; i < self->n_buckets; i++)
+        self->cell_start[i + 1] += self->cell_start[i];
+
+    /* Filling advances each bucket's start to its end; shift back after */
+    for (i = 0; i < n; i++)
+    {
+        TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, i);
+        guint bucket;
+
+        if (!slot->has_vehicle)
+            continue;
+
+        bucket = cell_bucket (self, (gint)floorf (slot->x / cell_size),
+                              (gint)floorf (slot->z / cell_size));
+        self->cell_slots[self->cell_start[bucket]++] = i;
+    }
+    for (i = self->n_buckets; i > 0; i--)
+        self->cell_start[i] = self->cell_start[i - 1];
+    self->cell_start[0] = 0;
+}
+
+/*
+ * Nearest vehicle ahead of @index within its detection range and the
+ * lane corridor, or G_MAXFLOAT.
+ */
+static gfloat
+nearest_vehicle_ahead (LrgTrafficManager *self,
+                       guint              index)
+{
+    const TrafficSlot *slot;
+    gfloat best_sq;
+    gfloat half_lane;
+    gboolean found;
+    gint cx;
+    gint cz;
+    gint dx;
+    gint dz;
+
+    slot = &g_array_index (self->slots, TrafficSlot, index);
+    best_sq = slot->range * slot->range;
+    half_lane = self->lane_width * 0.5f;
+    found = FALSE;
+
+    cx = (gint)floorf (slot->x / self->cell_size);
+    cz = (gint)floorf (slot->z / self->cell_size);
+
+    for (dz = -1; dz <= 1; dz++)
+    {
+        for (dx = -1; dx <= 1; dx++)
+        {
+            guint bucket = cell_bucket (self, cx + dx, cz + dz);
+            guint k;
+
+            for (k = self->cell_start[bucket]; k < self->cell_start[bucket + 1]; k++)
+            {
+                const TrafficSlot *other;
+                gfloat rx, ry, rz;
+                gfloat dist_sq;
+
+                if (self->cell_slots[k] == index)
+                    continue;
+
+                other = &g_array_index (self->slots, TrafficSlot, self->cell_slots[k]);
+                rx = other->x - slot->x;
+                ry = other->y - slot->y;
+                rz = other->z - slot->z;
+
+                if (rx * slot->forward_x + rz * slot->forward_z <= 0.0f)
+                    continue;
+                if (fabsf (rx * slot->forward_z - rz * slot->forward_x) > half_lane)
+                    continue;
+
+                dist_sq = rx * rx + ry * ry + rz * rz;
+                if (dist_sq < best_sq)
+                {
+                    best_sq = dist_sq;
+                    found = TRUE;
+                }
+            }
+        }
+    }
+
+    return found ? sqrtf (best_sq) : G_MAXFLOAT;
+}
+
+/* ==========================================================================
+ * Lanes
+ * ========================================================================== */
+
+static gint
+lane_entry_compare (gconstpointer a,
+                    gconstpointer b)
+{
+    const LaneEntry *ea = a;
+    const LaneEntry *eb = b;
+
+    if (ea->lane != eb->lane)
+        return ea->lane < eb->lane ? -1 : 1;
+    if (ea->t != eb->t)
+        return ea->t < eb->t ? -1 : 1;
+    if (ea->slot != eb->slot)
+        return ea->slot < eb->slot ? -1 : 1;
+
+    return 0;
+}
+
+/*
+ * Sorts vehicles by lane and position, then links each to the next
+ * vehicle in its direction of travel.
+ */
+static void
+build_lanes (LrgTrafficManager *self)
+{
+    guint i;
+    guint start;
+
+    g_array_set_size (self->lanes, 0);
+    for (i = 0; i < self->slots->len; i++)
+    {
+        TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, i);
+        LaneEntry entry;
+
+        slot->leader = NO_LEADER;
+        slot->leader_gap = G_MAXFLOAT;
+
+        if (slot->lane == NO_LANE)
+            continue;
+
+        entry.lane = slot->lane;
+        entry.t = slot->t;
+        entry.slot = i;
+        g_array_append_val (self->lanes, entry);
+    }
+
+    qsort (self->lanes->data, self->lanes->len, sizeof (LaneEntry), lane_entry_compare);
+
+    for (start = 0; start < self->lanes->len;)
+    {
+        const LaneEntry *run;
+        LrgRoad *road;
+        gfloat length;
+        guint end;
+        guint k;
+
+        run = &g_array_index (self->lanes, LaneEntry, start);
+        for (end = start + 1; end < self->lanes->len; end++)
+        {
+            if (g_array_index (self->lanes, LaneEntry, end).lane != run->lane)
+                break;
+        }
+
+        road = lrg_road_network_get_road_by_index (self->network, run->lane / 2);
+        length = road != NULL ? lrg_road_get_length (road) : 0.0f;
+
+        for (k = 0; k + 1 < end - start; k++)
+        {
+            const LaneEntry *behind = &run[k];
+            const LaneEntry *ahead = &run[k + 1];
+            gfloat gap = (ahead->t - behind->t) * length;
+
+            /* Against the road direction the vehicle at lower t leads */
+            if (run->lane % 2 == 0)
+            {
+                TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, behind->slot);
+
+                slot->leader = ahead->slot;
+                slot->leader_gap = gap;
+            }
+            else
+            {
+                TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, ahead->slot);
+
+                slot->leader = behind->slot;
+                slot->leader_gap = gap;
+            }
+        }
+
+        start = end;
+    }
+}
+
+/* ==========================================================================
+ * Per-agent work
+ * ========================================================================== */
+
+/*
+ * Places a vehicle on the network, trying the road it was on last
+ * frame before searching every road.
+ */
+static void
+locate_slot (LrgTrafficManager *self,
+             TrafficSlot       *slot)
+{
+    LrgRoad *road;
+    gfloat t;
+    gfloat dist;
+    gfloat dir_x, dir_y, dir_z;
+
+    slot->lane = NO_LANE;
+    if (!slot->has_vehicle)
+        return;
+
+    road = slot->road >= 0
+        ? lrg_road_network_get_road_by_index (self->network, slot->road)
+        : NULL;
+
+    if (road == NULL ||
+        !lrg_road_find_nearest_point (road, slot->x, slot->y, slot->z, &t, &dist) ||
+        t <= 0.0f || t >= 1.0f ||
+        dist > lrg_road_get_width_at (road, t))
+    {
+        const gchar *road_id;
+
+        slot->road = -1;
+        if (!lrg_road_network_get_nearest_road (self->network, slot->x, slot->y, slot->z,
+                                                &road_id, &t, &dist))
+            return;
+
+        slot->road = lrg_road_network_get_road_index (self->network, road_id);
+        road = lrg_road_network_get_road_by_index (self->network, slot->road);
+    }
+
+    slot->t = t;
+    slot->lane = (guint)slot->road * 2;
+
+    if (lrg_road_get_direction_at (road, t, &dir_x, &dir_y, &dir_z) &&
+        dir_x * slot->forward_x + dir_z * slot->forward_z < 0.0f)
+        slot->lane++;
+}
+
+static void
+drive_slot (LrgTrafficManager *self,
+            guint              index,
+            gfloat             delta)
+{
+    TrafficSlot *slot;
+    const gchar *road_id;
+    gfloat obstacle;
+
+    slot = &g_array_index (self->slots, TrafficSlot, index);
+    if (!slot->has_vehicle)
+        return;
+
+    obstacle = fminf (nearest_vehicle_ahead (self, index), slot->leader_gap);
+
+    road_id = NULL;
+    if (slot->lane != NO_LANE)
+        road_id = lrg_road_get_id (lrg_road_network_get_road_by_index (self->network,
+                                                                       slot->road));
+
+    lrg_traffic_agent_set_frame (slot->agent, road_id, slot->t, obstacle);
+    lrg_traffic_agent_update (slot->agent, delta);
+}
+
+static void
+run_range (LrgTrafficManager *self,
+           TrafficPhase       phase,
+           guint              begin,
+           guint              end,
+           gfloat             delta)
+{
+    guint i;
+
+    for (i = begin; i < end; i++)
+    {
+        if (phase == PHASE_LOCATE)
+            locate_slot (self, &g_array_index (self->slots, TrafficSlot, i));
+        else
+            drive_slot (self, i, delta);
+    }
+}
+
+static void
+run_chunk (gpointer data,
+           gpointer user_data)
+{
+    TrafficChunk *chunk = data;
+    LrgTrafficManager *self = chunk->manager;
+
+    (void)user_data;
+
+    run_range (self, chunk->phase, chunk->begin, chunk->end, chunk->delta);
+
+    g_mutex_lock (&self->lock);
+    if (--self->pending == 0)
+        g_cond_signal (&self->cond);
+    g_mutex_unlock (&self->lock);
+}
+
+static guint
+resolve_threads (LrgTrafficManager *self)
+{
+    return self->max_threads > 0 ? self->max_threads
+                                 : (guint)MAX (1, g_get_num_processors ());
+}
+
+/*
+ * Runs @phase over every slot, split into chunks across the pool when
+ * the batch is large enough. Returns once all chunks are done.
+ */
+static void
+run_phase (LrgTrafficManager *self,
+           TrafficPhase       phase,
+           gfloat             delta)
+{
+    TrafficChunk *chunks;
+    guint threads;
+    guint n_chunks;
+    guint chunk_size;
+    guint n;
+    guint i;
+
+    n = self->slots->len;
+    threads = resolve_threads (self);
+
+    if (threads <= 1 || n < PARALLEL_MIN_AGENTS)
+    {
+        run_range (self, phase, 0, n, delta);
+        return;
+    }
+
+    if (self->pool == NULL)
+        self->pool = g_thread_pool_new (run_chunk, NULL, threads, FALSE, NULL);
+    else if ((guint)g_thread_pool_get_max_threads (self->pool) != threads)
+        g_thread_pool_set_max_threads (self->pool, threads, NULL);
+
+    chunk_size = (n + threads * CHUNKS_PER_THREAD - 1) / (threads * CHUNKS_PER_THREAD);
+    n_chunks = (n + chunk_size - 1) / chunk_size;
+    chunks = g_new (TrafficChunk, n_chunks);
+
+    g_mutex_lock (&self->lock);
+    self->pending = n_chunks;
+    g_mutex_unlock (&self->lock);
+
+    for (i = 0; i < n_chunks; i++)
+    {
+        chunks[i].manager = self;
+        chunks[i].phase = phase;
+        chunks[i].begin = i * chunk_size;
+        chunks[i].end = MIN (n, (i + 1) * chunk_size);
+        chunks[i].delta = delta;
+        g_thread_pool_push (self->pool, &chunks[i], NULL);
+    }
+
+    g_mutex_lock (&self->lock);
+    while (self->pending > 0)
+        g_cond_wait (&self->cond, &self->lock);
+    g_mutex_unlock (&self->lock);
+
+    g_free (chunks);
+}
+
+/* ==========================================================================
+ * GObject
+ * ========================================================================== */
+
+static void
+lrg_traffic_manager_dispose (GObject *object)
+{
+    LrgTrafficManager *self;
+    guint i;
+
+    self = LRG_TRAFFIC_MANAGER (object);
+
+    if (self->pool != NULL)
+    {
+        g_thread_pool_free (self->pool, FALSE, TRUE);
+        self->pool = NULL;
+    }
+
+    for (i = 0; i < self->agents->len; i++)
+        lrg_traffic_agent_set_managed (g_ptr_array_index (self->agents, i), FALSE);
+    g_ptr_array_set_size (self->agents, 0);
+    g_array_set_size (self->slots, 0);
+    g_hash_table_remove_all (self->agent_indices);
+
+    g_clear_object (&self->network);
+
+    G_OBJECT_CLASS (lrg_traffic_manager_parent_class)->dispose (object);
+}
+
+static void
+lrg_traffic_manager_finalize (GObject *object)
+{
+    LrgTrafficManager *self;
+
+    self = LRG_TRAFFIC_MANAGER (object);
+
+    g_ptr_array_unref (self->agents);
+    g_array_unref (self->slots);
+    g_hash_table_unref (self->agent_indices);
+    g_array_unref (self->lanes);
+    g_free (self->cell_start);
+    g_free (self->cell_slots);
+    g_mutex_clear (&self->lock);
+    g_cond_clear (&self->cond);
+
+    G_OBJECT_CLASS (lrg_traffic_manager_parent_class)->finalize (object);
+}
+
+static void
+lrg_traffic_manager_class_init (LrgTrafficManagerClass *klass)
+{
+    GObjectClass *object_class;
+
+    object_class = G_OBJECT_CLASS (klass);
+
+    object_class->dispose = lrg_traffic_manager_dispose;
+    object_class->finalize = lrg_traffic_manager_finalize;
+}
+
+static void
+lrg_traffic_manager_init (LrgTrafficManager *self)
+{
+    self->network = NULL;
+    self->agents = g_ptr_array_new_with_free_func (g_object_unref);
+    self->slots = g_array_new (FALSE, TRUE, sizeof (TrafficSlot));
+    self->agent_indices = g_hash_table_new (g_direct_hash, g_direct_equal);
+    self->lanes = g_array_new (FALSE, FALSE, sizeof (LaneEntry));
+    self->cell_start = NULL;
+    self->cell_slots = NULL;
+    self->n_buckets = 0;
+    self->cell_size = 1.0f;
+    self->lane_width = DEFAULT_LANE_WIDTH;
+    self->max_threads = 0;
+    self->pool = NULL;
+    g_mutex_init (&self->lock);
+    g_cond_init (&self->cond);
+    self->pending = 0;
+}
+
+/* ==========================================================================
+ * Public API
+ * ========================================================================== */
+
+LrgTrafficManager *
+lrg_traffic_manager_new (LrgRoadNetwork *network)
+{
+    LrgTrafficManager *self;
+
+    g_return_val_if_fail (LRG_IS_ROAD_NETWORK (network), NULL);
+
+    self = g_object_new (LRG_TYPE_TRAFFIC_MANAGER, NULL);
+    self->network = g_object_ref (network);
+
+    return self;
+}
+
+LrgRoadNetwork *
+lrg_traffic_manager_get_road_network (LrgTrafficManager *self)
+{
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), NULL);
+
+    return self->network;
+}
+
+gboolean
+lrg_traffic_manager_add_agent (LrgTrafficManager *self,
+                               LrgTrafficAgent   *agent)
+{
+    TrafficSlot slot = { 0 };
+
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), FALSE);
+    g_return_val_if_fail (LRG_IS_TRAFFIC_AGENT (agent), FALSE);
+
+    if (g_hash_table_contains (self->agent_indices, agent))
+        return FALSE;
+
+    if (lrg_traffic_agent_get_road_network (agent) == NULL)
+        lrg_traffic_agent_set_road_network (agent, self->network);
+
+    slot.agent = agent;
+    slot.road = -1;
+    slot.lane = NO_LANE;
+    slot.leader = NO_LEADER;
+    slot.leader_gap = G_MAXFLOAT;
+
+    g_hash_table_insert (self->agent_indices, agent,
+                         GUINT_TO_POINTER (self->agents->len + 1));
+    g_ptr_array_add (self->agents, g_object_ref (agent));
+    g_array_append_val (self->slots, slot);
+    lrg_traffic_agent_set_managed (agent, TRUE);
+
+    return TRUE;
+}
+
+gboolean
+lrg_traffic_manager_remove_agent (LrgTrafficManager *self,
+                                  LrgTrafficAgent   *agent)
+{
+    guint index;
+    guint last;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), FALSE);
+    g_return_val_if_fail (LRG_IS_TRAFFIC_AGENT (agent), FALSE);
+
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (self->agent_indices, agent));
+    if (index == 0)
+        return FALSE;
+    index--;
+
+    g_hash_table_remove (self->agent_indices, agent);
+    lrg_traffic_agent_set_managed (agent, FALSE);
+
+    /* Swap the last agent into the hole */
+    last = self->agents->len - 1;
+    if (index != last)
+        g_hash_table_insert (self->agent_indices, g_ptr_array_index (self->agents, last),
+                             GUINT_TO_POINTER (index + 1));
+    g_ptr_array_remove_index_fast (self->agents, index);
+    g_array_remove_index_fast (self->slots, index);
+
+    /* Leader links refer to slot indices, which just moved */
+    for (i = 0; i < self->slots->len; i++)
+    {
+        TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, i);
+
+        slot->leader = NO_LEADER;
+        slot->leader_gap = G_MAXFLOAT;
+    }
+
+    return TRUE;
+}
+
+guint
+lrg_traffic_manager_get_agent_count (LrgTrafficManager *self)
+{
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), 0);
+
+    return self->agents->len;
+}
+
+GPtrArray *
+lrg_traffic_manager_get_agents (LrgTrafficManager *self)
+{
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), NULL);
+
+    return self->agents;
+}
+
+void
+lrg_traffic_manager_set_lane_width (LrgTrafficManager *self,
+                                    gfloat             width)
+{
+    g_return_if_fail (LRG_IS_TRAFFIC_MANAGER (self));
+    g_return_if_fail (width >= 0.0f);
+
+    self->lane_width = width;
+}
+
+gfloat
+lrg_traffic_manager_get_lane_width (LrgTrafficManager *self)
+{
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), DEFAULT_LANE_WIDTH);
+
+    return self->lane_width;
+}
+
+void
+lrg_traffic_manager_set_max_threads (LrgTrafficManager *self,
+                                     guint              max_threads)
+{
+    g_return_if_fail (LRG_IS_TRAFFIC_MANAGER (self));
+
+    self->max_threads = max_threads;
+}
+
+guint
+lrg_traffic_manager_get_max_threads (LrgTrafficManager *self)
+{
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), 0);
+
+    return self->max_threads;
+}
+
+void
+lrg_traffic_manager_update (LrgTrafficManager *self,
+                            gfloat             delta)
+{
+    GPtrArray *notify;
+    GList *l;
+    guint i;
+
+    g_return_if_fail (LRG_IS_TRAFFIC_MANAGER (self));
+    g_return_if_fail (delta > 0.0f);
+
+    /* Gather vehicle state on this thread */
+    for (i = 0; i < self->slots->len; i++)
+    {
+        TrafficSlot *slot = &g_array_index (self->slots, TrafficSlot, i);
+        LrgVehicle *vehicle = lrg_traffic_agent_get_vehicle (slot->agent);
+
+        slot->has_vehicle = vehicle != NULL;
+        slot->range = lrg_traffic_agent_get_obstacle_detection_range (slot->agent);
+        if (vehicle == NULL)
+            continue;
+
+        lrg_vehicle_get_position (vehicle, &slot->x, &slot->y, &slot->z);
+        lrg_vehicle_get_forward_vector (vehicle, &slot->forward_x, NULL, &slot->forward_z);
+    }
+
+    /* Road lengths are cached lazily; fill the caches before threads
+     * start reading them */
+    for (l = lrg_road_network_get_roads (self->network); l != NULL; l = l->next)
+        lrg_road_get_length (l->data);
+
+    run_phase (self, PHASE_LOCATE, delta);
+    build_lanes (self);
+    build_spatial_hash (self);
+    run_phase (self, PHASE_DRIVE, delta);
+
+    /* Deliver held back signals here; handlers may add or remove agents */
+    notify = g_ptr_array_new_with_free_func (g_object_unref);
+    for (i = 0; i < self->agents->len; i++)
+    {
+        LrgTrafficAgent *agent = g_ptr_array_index (self->agents, i);
+
+        if (lrg_traffic_agent_has_pending_events (agent))
+            g_ptr_array_add (notify, g_object_ref (agent));
+    }
+    for (i = 0; i < notify->len; i++)
+        lrg_traffic_agent_flush_events (g_ptr_array_index (notify, i));
+    g_ptr_array_unref (notify);
+}
+
+LrgTrafficAgent *
+lrg_traffic_manager_get_leader (LrgTrafficManager *self,
+                                LrgTrafficAgent   *agent,
+                                gfloat            *out_gap)
+{
+    const TrafficSlot *slot;
+    guint index;
+
+    g_return_val_if_fail (LRG_IS_TRAFFIC_MANAGER (self), NULL);
+    g_return_val_if_fail (LRG_IS_TRAFFIC_AGENT (agent), NULL);
+
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (self->agent_indices, agent));
+    if (index == 0)
+        return NULL;
+
+    slot = &g_array_index (self->slots, TrafficSlot, index - 1);
+    if (slot->leader == NO_LEADER)
+        return NULL;
+
+    if (out_gap != NULL)
+        *out_gap = slot->leader_gap;
+
+    return g_ptr_array_index (self->agents, slot->leader);
+}
@@ -0,0 +1,227 @@
+/* lrg-traffic-manager.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * LrgTrafficManager - Batched traffic simulation.
+ *
+ * Owns a set of traffic agents and updates them together. Every frame
+ * the manager places each vehicle on the road network, sorts vehicles
+ * into lanes to find who follows whom, and buckets them in a spatial
+ * hash so agents see each other as obstacles without game code feeding
+ * every vehicle to every agent. Agent updates run in parallel chunks.
+ */
+
+#pragma once
+
+#if !defined(LIBREGNUM_INSIDE) && !defined(LIBREGNUM_COMPILATION)
+#error "Only <libregnum.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include "../lrg-version.h"
+#include "lrg-road-network.h"
+#include "lrg-traffic-agent.h"
+
+G_BEGIN_DECLS
+
+#define LRG_TYPE_TRAFFIC_MANAGER (lrg_traffic_manager_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgTrafficManager, lrg_traffic_manager,
+                      LRG, TRAFFIC_MANAGER, GObject)
+
+/**
+ * lrg_traffic_manager_new:
+ * @network: Road network the agents drive on
+ *
+ * Creates a new traffic manager.
+ *
+ * Returns: (transfer full): A new #LrgTrafficManager
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgTrafficManager *
+lrg_traffic_manager_new (LrgRoadNetwork *network);
+
+/**
+ * lrg_traffic_manager_get_road_network:
+ * @self: an #LrgTrafficManager
+ *
+ * Gets the road network.
+ *
+ * Returns: (transfer none): The road network
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgRoadNetwork *
+lrg_traffic_manager_get_road_network (LrgTrafficManager *self);
+
+/* Agents */
+
+/**
+ * lrg_traffic_manager_add_agent:
+ * @self: an #LrgTrafficManager
+ * @agent: Agent to manage
+ *
+ * Adds an agent. Agents without a road network are given the
+ * manager's. While managed, the agent is only updated through
+ * lrg_traffic_manager_update() and sees every other managed vehicle
+ * as an obstacle; its own obstacles still apply.
+ *
+ * Returns: %TRUE if added, %FALSE if already managed
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_traffic_manager_add_agent (LrgTrafficManager *self,
+                               LrgTrafficAgent   *agent);
+
+/**
+ * lrg_traffic_manager_remove_agent:
+ * @self: an #LrgTrafficManager
+ * @agent: Agent to remove
+ *
+ * Removes an agent, returning it to standalone updates.
+ *
+ * Returns: %TRUE if removed
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean
+lrg_traffic_manager_remove_agent (LrgTrafficManager *self,
+                                  LrgTrafficAgent   *agent);
+
+/**
+ * lrg_traffic_manager_get_agent_count:
+ * @self: an #LrgTrafficManager
+ *
+ * Gets the number of managed agents.
+ *
+ * Returns: Agent count
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_traffic_manager_get_agent_count (LrgTrafficManager *self);
+
+/**
+ * lrg_traffic_manager_get_agents:
+ * @self: an #LrgTrafficManager
+ *
+ * Gets the managed agents. The order changes when agents are removed.
+ *
+ * Returns: (transfer none) (element-type LrgTrafficAgent): The agents
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+GPtrArray *
+lrg_traffic_manager_get_agents (LrgTrafficManager *self);
+
+/* Configuration */
+
+/**
+ * lrg_traffic_manager_set_lane_width:
+ * @self: an #LrgTrafficManager
+ * @width: Lane width in world units
+ *
+ * Sets the width of the corridor ahead of each vehicle in which other
+ * vehicles count as obstacles. Vehicles further to the side, such as
+ * oncoming traffic, are ignored. Defaults to 3.5.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_traffic_manager_set_lane_width (LrgTrafficManager *self,
+                                    gfloat             width);
+
+/**
+ * lrg_traffic_manager_get_lane_width:
+ * @self: an #LrgTrafficManager
+ *
+ * Gets the lane width.
+ *
+ * Returns: Lane width
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat
+lrg_traffic_manager_get_lane_width (LrgTrafficManager *self);
+
+/**
+ * lrg_traffic_manager_set_max_threads:
+ * @self: an #LrgTrafficManager
+ * @max_threads: Worker threads, 0 for one per processor, 1 to stay on
+ *   the calling thread
+ *
+ * Sets how many threads update agents. Small batches always run on the
+ * calling thread. Defaults to 0.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_traffic_manager_set_max_threads (LrgTrafficManager *self,
+                                     guint              max_threads);
+
+/**
+ * lrg_traffic_manager_get_max_threads:
+ * @self: an #LrgTrafficManager
+ *
+ * Gets the thread limit.
+ *
+ * Returns: Thread limit, 0 meaning one per processor
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+guint
+lrg_traffic_manager_get_max_threads (LrgTrafficManager *self);
+
+/* Simulation */
+
+/**
+ * lrg_traffic_manager_update:
+ * @self: an #LrgTrafficManager
+ * @delta: Time step in seconds
+ *
+ * Updates every managed agent. Vehicle physics is not stepped; update
+ * the vehicles afterwards as usual. Agent signals are emitted on the
+ * calling thread once all agents are updated.
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+void
+lrg_traffic_manager_update (LrgTrafficManager *self,
+                            gfloat             delta);
+
+/**
+ * lrg_traffic_manager_get_leader:
+ * @self: an #LrgTrafficManager
+ * @agent: A managed agent
+ * @out_gap: (out) (optional): Distance to the leader along the road
+ *
+ * Gets the vehicle directly ahead of @agent in the same lane as of the
+ * last update. Each direction of a road is one lane.
+ *
+ * Returns: (transfer none) (nullable): The leading agent, or %NULL
+ *
+ * Since: 1.0
+ */
+LRG_AVAILABLE_IN_ALL
+LrgTrafficAgent *
+lrg_traffic_manager_get_leader (LrgTrafficManager *self,
+                                LrgTrafficAgent   *agent,
+                                gfloat            *out_gap);
+
+G_END_DECLS
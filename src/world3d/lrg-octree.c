@@ -14,26 +14,38 @@
 
 #define DEFAULT_MAX_DEPTH 8
 #define DEFAULT_MAX_OBJECTS 8
+#define DEFAULT_LOOSENESS 1.0f
+#define MAX_LOOSENESS 2.0f
+
+/* Octree node */
+typedef struct _OctreeNode OctreeNode;
 
 /* Object entry stored in the octree */
 typedef struct
 {
-    gpointer        object;
-    LrgBoundingBox3D bounds;
+    gpointer          object;
+    LrgBoundingBox3D  bounds;
+    OctreeNode       *node;         /* Node currently holding this entry */
 } OctreeEntry;
 
-/* Octree node */
-typedef struct _OctreeNode OctreeNode;
-
 struct _OctreeNode
 {
     LrgBoundingBox3D  bounds;
+    LrgBoundingBox3D  loose_bounds; /* bounds scaled by the tree's looseness */
     GPtrArray        *entries;      /* OctreeEntry* */
     OctreeNode       *children[8];  /* 8 children for octree */
     guint             depth;
     gboolean          is_leaf;
 };
 
+/* Item in the best-first search queue: either a node or an entry */
+typedef struct
+{
+    gfloat       key;
+    OctreeNode  *node;
+    OctreeEntry *entry;
+} OctreeQueueItem;
+
 struct _LrgOctree
 {
     GObject          parent_instance;
@@ -44,15 +56,17 @@ struct _LrgOctree
     guint            max_objects;
     guint            object_count;
     guint            node_count;
+    gfloat           looseness;
 
-    /* Object lookup for fast removal */
-    GHashTable      *object_nodes;  /* gpointer -> OctreeNode* */
+    /* Object lookup for fast removal and in-place updates */
+    GHashTable      *object_entries;  /* gpointer -> OctreeEntry* */
 };
 
 G_DEFINE_FINAL_TYPE (LrgOctree, lrg_octree, G_TYPE_OBJECT)
 
 /* Forward declarations */
-static OctreeNode * octree_node_new             (const LrgBoundingBox3D *bounds,
+static OctreeNode * octree_node_new             (LrgOctree              *tree,
+                                                 const LrgBoundingBox3D *bounds,
                                                  guint                   depth);
 static void         octree_node_free            (OctreeNode             *node);
 static void         octree_node_subdivide       (LrgOctree              *tree,
@@ -91,8 +105,31 @@ octree_entry_free (gpointer data)
     g_free (data);
 }
 
+static void
+compute_loose_bounds (const LrgBoundingBox3D *bounds,
+                      gfloat                  looseness,
+                      LrgBoundingBox3D       *loose)
+{
+    gfloat pad_x;
+    gfloat pad_y;
+    gfloat pad_z;
+
+    /* Each half-extent is scaled by looseness around the same center */
+    pad_x = (bounds->max.x - bounds->min.x) * 0.5f * (looseness - 1.0f);
+    pad_y = (bounds->max.y - bounds->min.y) * 0.5f * (looseness - 1.0f);
+    pad_z = (bounds->max.z - bounds->min.z) * 0.5f * (looseness - 1.0f);
+
+    loose->min.x = bounds->min.x - pad_x;
+    loose->min.y = bounds->min.y - pad_y;
+    loose->min.z = bounds->min.z - pad_z;
+    loose->max.x = bounds->max.x + pad_x;
+    loose->max.y = bounds->max.y + pad_y;
+    loose->max.z = bounds->max.z + pad_z;
+}
+
 static OctreeNode *
-octree_node_new (const LrgBoundingBox3D *bounds,
+octree_node_new (LrgOctree              *tree,
+                 const LrgBoundingBox3D *bounds,
                  guint                   depth)
 {
     OctreeNode *node;
@@ -100,6 +137,7 @@ octree_node_new (const LrgBoundingBox3D *bounds,
 
     node = g_new0 (OctreeNode, 1);
     node->bounds = *bounds;
+    compute_loose_bounds (bounds, tree->looseness, &node->loose_bounds);
     node->entries = g_ptr_array_new_with_free_func (octree_entry_free);
     node->depth = depth;
     node->is_leaf = TRUE;
@@ -158,6 +196,42 @@ octree_node_get_child_bounds (const LrgBoundingBox3D *parent,
     child->max.z = (index & 4) ? parent->max.z : mid_z;
 }
 
+/*
+ * Finds the child that should hold @bounds, or -1 if it must stay at
+ * @node. The child is picked by the octant of the object's center and
+ * accepted only if the object fits in that child's loose bounds. With a
+ * looseness of 1.0 this is the classic "fits entirely in one child" rule.
+ */
+static gint
+octree_node_find_child (const OctreeNode       *node,
+                        const LrgBoundingBox3D *bounds)
+{
+    gfloat mid_x;
+    gfloat mid_y;
+    gfloat mid_z;
+    gint index;
+
+    if (node->is_leaf)
+        return -1;
+
+    mid_x = (node->bounds.min.x + node->bounds.max.x) * 0.5f;
+    mid_y = (node->bounds.min.y + node->bounds.max.y) * 0.5f;
+    mid_z = (node->bounds.min.z + node->bounds.max.z) * 0.5f;
+
+    index = 0;
+    if ((bounds->min.x + bounds->max.x) * 0.5f >= mid_x)
+        index |= 1;
+    if ((bounds->min.y + bounds->max.y) * 0.5f >= mid_y)
+        index |= 2;
+    if ((bounds->min.z + bounds->max.z) * 0.5f >= mid_z)
+        index |= 4;
+
+    if (lrg_bounding_box3d_contains (&node->children[index]->loose_bounds, bounds))
+        return index;
+
+    return -1;
+}
+
 static void
 octree_node_subdivide (LrgOctree  *tree,
                        OctreeNode *node)
@@ -174,22 +248,19 @@ octree_node_subdivide (LrgOctree  *tree,
     for (i = 0; i < 8; i++)
     {
         octree_node_get_child_bounds (&node->bounds, i, &child_bounds);
-        node->children[i] = octree_node_new (&child_bounds, node->depth + 1);
+        node->children[i] = octree_node_new (tree, &child_bounds, node->depth + 1);
         tree->node_count++;
     }
 
     node->is_leaf = FALSE;
 
-    /* Re-insert entries into children */
+    /* Move existing entries down; they keep their identity */
     old_entries = node->entries;
     node->entries = g_ptr_array_new_with_free_func (octree_entry_free);
+    g_ptr_array_set_free_func (old_entries, NULL);
 
     for (j = 0; j < old_entries->len; j++)
-    {
-        OctreeEntry *entry = g_ptr_array_index (old_entries, j);
-        OctreeEntry *new_entry = octree_entry_new (entry->object, &entry->bounds);
-        octree_node_insert (tree, node, new_entry);
-    }
+        octree_node_insert (tree, node, g_ptr_array_index (old_entries, j));
 
     g_ptr_array_unref (old_entries);
 }
@@ -199,22 +270,12 @@ octree_node_insert (LrgOctree   *tree,
                     OctreeNode  *node,
                     OctreeEntry *entry)
 {
-    gint i;
     gint fitting_child;
 
     /* Check if entry fits in any child */
     if (!node->is_leaf)
     {
-        fitting_child = -1;
-
-        for (i = 0; i < 8; i++)
-        {
-            if (lrg_bounding_box3d_contains (&node->children[i]->bounds, &entry->bounds))
-            {
-                fitting_child = i;
-                break;
-            }
-        }
+        fitting_child = octree_node_find_child (node, &entry->bounds);
 
         if (fitting_child >= 0)
         {
@@ -223,13 +284,13 @@ octree_node_insert (LrgOctree   *tree,
 
         /* Entry spans multiple children, store at this level */
         g_ptr_array_add (node->entries, entry);
-        g_hash_table_insert (tree->object_nodes, entry->object, node);
+        entry->node = node;
         return TRUE;
     }
 
     /* Leaf node */
     g_ptr_array_add (node->entries, entry);
-    g_hash_table_insert (tree->object_nodes, entry->object, node);
+    entry->node = node;
 
     /* Subdivide if needed */
     if (node->entries->len > tree->max_objects && node->depth < tree->max_depth)
@@ -240,6 +301,26 @@ octree_node_insert (LrgOctree   *tree,
     return TRUE;
 }
 
+static void
+octree_node_collect_all (OctreeNode *node,
+                         GPtrArray  *results)
+{
+    guint i;
+    gint j;
+
+    for (i = 0; i < node->entries->len; i++)
+    {
+        OctreeEntry *entry = g_ptr_array_index (node->entries, i);
+        g_ptr_array_add (results, entry->object);
+    }
+
+    if (!node->is_leaf)
+    {
+        for (j = 0; j < 8; j++)
+            octree_node_collect_all (node->children[j], results);
+    }
+}
+
 static void
 octree_node_query_box (OctreeNode             *node,
                        const LrgBoundingBox3D *query,
@@ -263,7 +344,7 @@ octree_node_query_box (OctreeNode             *node,
     {
         for (j = 0; j < 8; j++)
         {
-            if (lrg_bounding_box3d_intersects (&node->children[j]->bounds, query))
+            if (lrg_bounding_box3d_intersects (&node->children[j]->loose_bounds, query))
             {
                 octree_node_query_box (node->children[j], query, results);
             }
@@ -271,38 +352,58 @@ octree_node_query_box (OctreeNode             *node,
     }
 }
 
-static gboolean
-box_intersects_sphere (const LrgBoundingBox3D *box,
-                       const GrlVector3       *center,
-                       gfloat                  radius)
+static gfloat
+box_distance_sq (const LrgBoundingBox3D *box,
+                 const GrlVector3       *point)
 {
     gfloat dx;
     gfloat dy;
     gfloat dz;
-    gfloat dist_sq;
 
-    /* Find closest point on box to sphere center */
+    /* Squared distance from point to the closest point on the box */
     dx = 0.0f;
     dy = 0.0f;
     dz = 0.0f;
 
-    if (center->x < box->min.x)
-        dx = box->min.x - center->x;
-    else if (center->x > box->max.x)
-        dx = center->x - box->max.x;
+    if (point->x < box->min.x)
+        dx = box->min.x - point->x;
+    else if (point->x > box->max.x)
+        dx = point->x - box->max.x;
+
+    if (point->y < box->min.y)
+        dy = box->min.y - point->y;
+    else if (point->y > box->max.y)
+        dy = point->y - box->max.y;
+
+    if (point->z < box->min.z)
+        dz = box->min.z - point->z;
+    else if (point->z > box->max.z)
+        dz = point->z - box->max.z;
+
+    return dx * dx + dy * dy + dz * dz;
+}
+
+static gboolean
+box_intersects_sphere (const LrgBoundingBox3D *box,
+                       const GrlVector3       *center,
+                       gfloat                  radius)
+{
+    return box_distance_sq (box, center) <= radius * radius;
+}
 
-    if (center->y < box->min.y)
-        dy = box->min.y - center->y;
-    else if (center->y > box->max.y)
-        dy = center->y - box->max.y;
+static gfloat
+entry_center_distance_sq (const OctreeEntry *entry,
+                          const GrlVector3  *point)
+{
+    gfloat dx;
+    gfloat dy;
+    gfloat dz;
 
-    if (center->z < box->min.z)
-        dz = box->min.z - center->z;
-    else if (center->z > box->max.z)
-        dz = center->z - box->max.z;
+    dx = point->x - (entry->bounds.min.x + entry->bounds.max.x) * 0.5f;
+    dy = point->y - (entry->bounds.min.y + entry->bounds.max.y) * 0.5f;
+    dz = point->z - (entry->bounds.min.z + entry->bounds.max.z) * 0.5f;
 
-    dist_sq = dx * dx + dy * dy + dz * dz;
-    return dist_sq <= radius * radius;
+    return dx * dx + dy * dy + dz * dz;
 }
 
 static void
@@ -329,7 +430,7 @@ octree_node_query_sphere (OctreeNode       *node,
     {
         for (j = 0; j < 8; j++)
         {
-            if (box_intersects_sphere (&node->children[j]->bounds, center, radius))
+            if (box_intersects_sphere (&node->children[j]->loose_bounds, center, radius))
             {
                 octree_node_query_sphere (node->children[j], center, radius, results);
             }
@@ -337,6 +438,308 @@ octree_node_query_sphere (OctreeNode       *node,
     }
 }
 
+/*
+ * Frustum classification of a box against planes (a, b, c, d) whose
+ * inside half-space satisfies a*x + b*y + c*z + d >= 0.
+ */
+typedef enum
+{
+    FRUSTUM_OUTSIDE,
+    FRUSTUM_INTERSECTS,
+    FRUSTUM_INSIDE
+} FrustumResult;
+
+static FrustumResult
+box_classify_planes (const LrgBoundingBox3D *box,
+                     const gfloat           *planes,
+                     guint                   n_planes)
+{
+    FrustumResult result;
+    guint i;
+
+    result = FRUSTUM_INSIDE;
+
+    for (i = 0; i < n_planes; i++)
+    {
+        const gfloat *p = &planes[i * 4];
+        gfloat px;
+        gfloat py;
+        gfloat pz;
+        gfloat nx;
+        gfloat ny;
+        gfloat nz;
+
+        /* Corner furthest along the plane normal (p) and its opposite (n) */
+        px = p[0] >= 0.0f ? box->max.x : box->min.x;
+        py = p[1] >= 0.0f ? box->max.y : box->min.y;
+        pz = p[2] >= 0.0f ? box->max.z : box->min.z;
+        nx = p[0] >= 0.0f ? box->min.x : box->max.x;
+        ny = p[1] >= 0.0f ? box->min.y : box->max.y;
+        nz = p[2] >= 0.0f ? box->min.z : box->max.z;
+
+        if (p[0] * px + p[1] * py + p[2] * pz + p[3] < 0.0f)
+            return FRUSTUM_OUTSIDE;
+
+        if (p[0] * nx + p[1] * ny + p[2] * nz + p[3] < 0.0f)
+            result = FRUSTUM_INTERSECTS;
+    }
+
+    return result;
+}
+
+static void
+octree_node_query_frustum (OctreeNode   *node,
+                           const gfloat *planes,
+                           guint         n_planes,
+                           GPtrArray    *results)
+{
+    guint i;
+    gint j;
+
+    for (i = 0; i < node->entries->len; i++)
+    {
+        OctreeEntry *entry = g_ptr_array_index (node->entries, i);
+        if (box_classify_planes (&entry->bounds, planes, n_planes) != FRUSTUM_OUTSIDE)
+            g_ptr_array_add (results, entry->object);
+    }
+
+    if (node->is_leaf)
+        return;
+
+    for (j = 0; j < 8; j++)
+    {
+        OctreeNode *child = node->children[j];
+
+        switch (box_classify_planes (&child->loose_bounds, planes, n_planes))
+        {
+        case FRUSTUM_INSIDE:
+            /* Whole subtree is visible, no further plane tests needed */
+            octree_node_collect_all (child, results);
+            break;
+        case FRUSTUM_INTERSECTS:
+            octree_node_query_frustum (child, planes, n_planes, results);
+            break;
+        case FRUSTUM_OUTSIDE:
+        default:
+            break;
+        }
+    }
+}
+
+/*
+ * Clips the ray interval [*tmin, *tmax] against one axis slab.
+ * Axes the ray runs parallel to are handled explicitly so a ray lying
+ * exactly on a slab plane does not produce 0 * inf = NaN.
+ */
+static gboolean
+ray_clip_slab (gfloat  origin,
+               gfloat  inv_dir,
+               gfloat  slab_min,
+               gfloat  slab_max,
+               gfloat *tmin,
+               gfloat *tmax)
+{
+    gfloat t1;
+    gfloat t2;
+
+    if (isinf (inv_dir))
+        return origin >= slab_min && origin <= slab_max;
+
+    t1 = (slab_min - origin) * inv_dir;
+    t2 = (slab_max - origin) * inv_dir;
+    *tmin = MAX (*tmin, MIN (t1, t2));
+    *tmax = MIN (*tmax, MAX (t1, t2));
+
+    return *tmax >= *tmin;
+}
+
+/*
+ * Slab test. On a hit, stores the entry distance along the ray (clamped
+ * to 0 when the origin is inside the box) in @out_t.
+ */
+static gboolean
+ray_intersects_box (const LrgBoundingBox3D *box,
+                    const GrlVector3       *origin,
+                    const GrlVector3       *inv_dir,
+                    gfloat                  max_distance,
+                    gfloat                 *out_t)
+{
+    gfloat tmin;
+    gfloat tmax;
+
+    tmin = 0.0f;
+    tmax = max_distance;
+
+    if (!ray_clip_slab (origin->x, inv_dir->x, box->min.x, box->max.x, &tmin, &tmax) ||
+        !ray_clip_slab (origin->y, inv_dir->y, box->min.y, box->max.y, &tmin, &tmax) ||
+        !ray_clip_slab (origin->z, inv_dir->z, box->min.z, box->max.z, &tmin, &tmax))
+        return FALSE;
+
+    *out_t = tmin;
+    return TRUE;
+}
+
+/*
+ * Normalizes @direction and stores its component-wise reciprocal in
+ * @inv_dir. Zero components become infinity, which ray_clip_slab()
+ * treats as "parallel to that axis". Returns %FALSE for a zero-length
+ * direction.
+ */
+static gboolean
+ray_prepare (const GrlVector3 *direction,
+             GrlVector3       *inv_dir)
+{
+    gfloat len;
+
+    len = sqrtf (direction->x * direction->x +
+                 direction->y * direction->y +
+                 direction->z * direction->z);
+    if (len <= 0.0f)
+        return FALSE;
+
+    inv_dir->x = direction->x != 0.0f ? len / direction->x : INFINITY;
+    inv_dir->y = direction->y != 0.0f ? len / direction->y : INFINITY;
+    inv_dir->z = direction->z != 0.0f ? len / direction->z : INFINITY;
+
+    return TRUE;
+}
+
+static void
+octree_node_query_ray (OctreeNode       *node,
+                       const GrlVector3 *origin,
+                       const GrlVector3 *inv_dir,
+                       gfloat            max_distance,
+                       GPtrArray        *results)
+{
+    gfloat t;
+    guint i;
+    gint j;
+
+    for (i = 0; i < node->entries->len; i++)
+    {
+        OctreeEntry *entry = g_ptr_array_index (node->entries, i);
+        if (ray_intersects_box (&entry->bounds, origin, inv_dir, max_distance, &t))
+            g_ptr_array_add (results, entry->object);
+    }
+
+    if (node->is_leaf)
+        return;
+
+    for (j = 0; j < 8; j++)
+    {
+        if (ray_intersects_box (&node->children[j]->loose_bounds,
+                                origin, inv_dir, max_distance, &t))
+        {
+            octree_node_query_ray (node->children[j], origin, inv_dir,
+                                   max_distance, results);
+        }
+    }
+}
+
+/*
+ * Binary min-heap over OctreeQueueItem, used for best-first traversal
+ * by the k-nearest and raycast queries.
+ */
+static void
+queue_push (GArray      *heap,
+            gfloat       key,
+            OctreeNode  *node,
+            OctreeEntry *entry)
+{
+    OctreeQueueItem item;
+    OctreeQueueItem *items;
+    guint i;
+
+    item.key = key;
+    item.node = node;
+    item.entry = entry;
+
+    g_array_append_val (heap, item);
+    items = (OctreeQueueItem *)heap->data;
+
+    /* Sift up */
+    i = heap->len - 1;
+    while (i > 0)
+    {
+        guint parent = (i - 1) / 2;
+
+        if (items[parent].key <= item.key)
+            break;
+
+        items[i] = items[parent];
+        i = parent;
+    }
+    items[i] = item;
+}
+
+static OctreeQueueItem
+queue_pop (GArray *heap)
+{
+    OctreeQueueItem top;
+    OctreeQueueItem last;
+    OctreeQueueItem *items;
+    guint len;
+    guint i;
+
+    items = (OctreeQueueItem *)heap->data;
+    top = items[0];
+    last = items[heap->len - 1];
+    g_array_set_size (heap, heap->len - 1);
+
+    len = heap->len;
+    if (len == 0)
+        return top;
+
+    /* Sift down */
+    i = 0;
+    for (;;)
+    {
+        guint child = i * 2 + 1;
+
+        if (child >= len)
+            break;
+        if (child + 1 < len && items[child + 1].key < items[child].key)
+            child++;
+        if (last.key <= items[child].key)
+            break;
+
+        items[i] = items[child];
+        i = child;
+    }
+    items[i] = last;
+
+    return top;
+}
+
+static void
+queue_push_node_contents (GArray           *heap,
+                          OctreeNode       *node,
+                          const GrlVector3 *point)
+{
+    guint i;
+    gint j;
+
+    /*
+     * Entry keys use the distance to the entry center, which is never
+     * smaller than the distance to the (loose) node box holding it, so
+     * popping in key order yields entries in nearest-first order.
+     */
+    for (i = 0; i < node->entries->len; i++)
+    {
+        OctreeEntry *entry = g_ptr_array_index (node->entries, i);
+        queue_push (heap, entry_center_distance_sq (entry, point), NULL, entry);
+    }
+
+    if (node->is_leaf)
+        return;
+
+    for (j = 0; j < 8; j++)
+    {
+        OctreeNode *child = node->children[j];
+        queue_push (heap, box_distance_sq (&child->loose_bounds, point), child, NULL);
+    }
+}
+
 static guint
 octree_node_count_nodes (OctreeNode *node)
 {
@@ -363,7 +766,7 @@ lrg_octree_finalize (GObject *object)
     LrgOctree *self = LRG_OCTREE (object);
 
     octree_node_free (self->root);
-    g_hash_table_unref (self->object_nodes);
+    g_hash_table_unref (self->object_entries);
 
     G_OBJECT_CLASS (lrg_octree_parent_class)->finalize (object);
 }
@@ -384,7 +787,8 @@ lrg_octree_init (LrgOctree *self)
     self->max_objects = DEFAULT_MAX_OBJECTS;
     self->object_count = 0;
     self->node_count = 0;
-    self->object_nodes = g_hash_table_new (g_direct_hash, g_direct_equal);
+    self->looseness = DEFAULT_LOOSENESS;
+    self->object_entries = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 /**
@@ -421,7 +825,7 @@ lrg_octree_new_with_depth (const LrgBoundingBox3D *bounds,
     self = g_object_new (LRG_TYPE_OCTREE, NULL);
     self->bounds = *bounds;
     self->max_depth = max_depth;
-    self->root = octree_node_new (bounds, 0);
+    self->root = octree_node_new (self, bounds, 0);
     self->node_count = 1;
 
     return self;
@@ -449,13 +853,14 @@ lrg_octree_insert (LrgOctree              *self,
     g_return_val_if_fail (bounds != NULL, FALSE);
 
     /* Check if object is already in the tree */
-    if (g_hash_table_contains (self->object_nodes, object))
+    if (g_hash_table_contains (self->object_entries, object))
         return FALSE;
 
     entry = octree_entry_new (object, bounds);
 
     if (octree_node_insert (self, self->root, entry))
     {
+        g_hash_table_insert (self->object_entries, object, entry);
         self->object_count++;
         return TRUE;
     }
@@ -477,30 +882,20 @@ gboolean
 lrg_octree_remove (LrgOctree *self,
                    gpointer   object)
 {
-    OctreeNode *node;
-    guint i;
+    OctreeEntry *entry;
 
     g_return_val_if_fail (LRG_IS_OCTREE (self), FALSE);
     g_return_val_if_fail (object != NULL, FALSE);
 
-    node = g_hash_table_lookup (self->object_nodes, object);
-    if (node == NULL)
+    entry = g_hash_table_lookup (self->object_entries, object);
+    if (entry == NULL)
         return FALSE;
 
-    /* Find and remove the entry */
-    for (i = 0; i < node->entries->len; i++)
-    {
-        OctreeEntry *entry = g_ptr_array_index (node->entries, i);
-        if (entry->object == object)
-        {
-            g_ptr_array_remove_index (node->entries, i);
-            g_hash_table_remove (self->object_nodes, object);
-            self->object_count--;
-            return TRUE;
-        }
-    }
+    g_hash_table_remove (self->object_entries, object);
+    self->object_count--;
 
-    return FALSE;
+    /* Frees the entry through the array's free func */
+    return g_ptr_array_remove_fast (entry->node->entries, entry);
 }
 
 /**
@@ -510,7 +905,11 @@ lrg_octree_remove (LrgOctree *self,
  * @new_bounds: (transfer none): New bounding box for the object
  *
  * Updates an object's position in the octree.
- * This removes and re-inserts the object.
+ *
+ * If the new bounds still fit the (loose) bounds of the node holding
+ * the object and would not be pushed into one of its children, the
+ * entry is updated in place without touching the tree structure.
+ * Otherwise the object is removed and re-inserted.
  *
  * Returns: %TRUE if updated successfully
  */
@@ -519,10 +918,28 @@ lrg_octree_update (LrgOctree              *self,
                    gpointer                object,
                    const LrgBoundingBox3D *new_bounds)
 {
+    OctreeEntry *entry;
+    OctreeNode *node;
+
     g_return_val_if_fail (LRG_IS_OCTREE (self), FALSE);
     g_return_val_if_fail (object != NULL, FALSE);
     g_return_val_if_fail (new_bounds != NULL, FALSE);
 
+    entry = g_hash_table_lookup (self->object_entries, object);
+    if (entry == NULL)
+        return FALSE;
+
+    node = entry->node;
+
+    /* The root holds anything that fits nowhere else, even out of bounds */
+    if ((node == self->root ||
+         lrg_bounding_box3d_contains (&node->loose_bounds, new_bounds)) &&
+        octree_node_find_child (node, new_bounds) < 0)
+    {
+        entry->bounds = *new_bounds;
+        return TRUE;
+    }
+
     if (!lrg_octree_remove (self, object))
         return FALSE;
 
@@ -541,9 +958,9 @@ lrg_octree_clear (LrgOctree *self)
     g_return_if_fail (LRG_IS_OCTREE (self));
 
     octree_node_free (self->root);
-    g_hash_table_remove_all (self->object_nodes);
+    g_hash_table_remove_all (self->object_entries);
 
-    self->root = octree_node_new (&self->bounds, 0);
+    self->root = octree_node_new (self, &self->bounds, 0);
     self->node_count = 1;
     self->object_count = 0;
 }
@@ -567,11 +984,40 @@ lrg_octree_query_box (LrgOctree              *self,
     g_return_val_if_fail (query != NULL, NULL);
 
     results = g_ptr_array_new ();
-    octree_node_query_box (self->root, query, results);
+    lrg_octree_query_box_into (self, query, results);
 
     return results;
 }
 
+/**
+ * lrg_octree_query_box_into:
+ * @self: An #LrgOctree
+ * @query: (transfer none): Query bounding box
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects that intersect with the query box to @results.
+ * The array is not cleared first, so callers can reuse one buffer across
+ * frames by calling g_ptr_array_set_size (results, 0) between queries.
+ *
+ * Returns: Number of objects appended
+ */
+guint
+lrg_octree_query_box_into (LrgOctree              *self,
+                           const LrgBoundingBox3D *query,
+                           GPtrArray              *results)
+{
+    guint start;
+
+    g_return_val_if_fail (LRG_IS_OCTREE (self), 0);
+    g_return_val_if_fail (query != NULL, 0);
+    g_return_val_if_fail (results != NULL, 0);
+
+    start = results->len;
+    octree_node_query_box (self->root, query, results);
+
+    return results->len - start;
+}
+
 /**
  * lrg_octree_query_sphere:
  * @self: An #LrgOctree
@@ -594,11 +1040,41 @@ lrg_octree_query_sphere (LrgOctree        *self,
     g_return_val_if_fail (radius > 0.0f, NULL);
 
     results = g_ptr_array_new ();
-    octree_node_query_sphere (self->root, center, radius, results);
+    lrg_octree_query_sphere_into (self, center, radius, results);
 
     return results;
 }
 
+/**
+ * lrg_octree_query_sphere_into:
+ * @self: An #LrgOctree
+ * @center: (transfer none): Sphere center
+ * @radius: Sphere radius
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects that intersect with a sphere to @results.
+ *
+ * Returns: Number of objects appended
+ */
+guint
+lrg_octree_query_sphere_into (LrgOctree        *self,
+                              const GrlVector3 *center,
+                              gfloat            radius,
+                              GPtrArray        *results)
+{
+    guint start;
+
+    g_return_val_if_fail (LRG_IS_OCTREE (self), 0);
+    g_return_val_if_fail (center != NULL, 0);
+    g_return_val_if_fail (radius > 0.0f, 0);
+    g_return_val_if_fail (results != NULL, 0);
+
+    start = results->len;
+    octree_node_query_sphere (self->root, center, radius, results);
+
+    return results->len - start;
+}
+
 /**
  * lrg_octree_query_point:
  * @self: An #LrgOctree
@@ -612,16 +1088,207 @@ GPtrArray *
 lrg_octree_query_point (LrgOctree        *self,
                         const GrlVector3 *point)
 {
-    g_autoptr(LrgBoundingBox3D) tiny_box = NULL;
+    GPtrArray *results;
 
     g_return_val_if_fail (LRG_IS_OCTREE (self), NULL);
     g_return_val_if_fail (point != NULL, NULL);
 
-    /* Use a tiny box for point query */
-    tiny_box = lrg_bounding_box3d_new (point->x, point->y, point->z,
-                                       point->x, point->y, point->z);
+    results = g_ptr_array_new ();
+    lrg_octree_query_point_into (self, point, results);
+
+    return results;
+}
+
+/**
+ * lrg_octree_query_point_into:
+ * @self: An #LrgOctree
+ * @point: (transfer none): Point to query
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects that contain the given point to @results.
+ *
+ * Returns: Number of objects appended
+ */
+guint
+lrg_octree_query_point_into (LrgOctree        *self,
+                             const GrlVector3 *point,
+                             GPtrArray        *results)
+{
+    LrgBoundingBox3D tiny_box;
+
+    g_return_val_if_fail (LRG_IS_OCTREE (self), 0);
+    g_return_val_if_fail (point != NULL, 0);
+
+    /* Use a degenerate box for point query */
+    tiny_box.min = *point;
+    tiny_box.max = *point;
+
+    return lrg_octree_query_box_into (self, &tiny_box, results);
+}
+
+/**
+ * lrg_octree_query_frustum_into:
+ * @self: An #LrgOctree
+ * @planes: (array length=n_floats): Plane equations, four floats (a, b, c, d)
+ *   per plane
+ * @n_floats: Number of floats in @planes (four per plane, usually 24)
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects whose bounds are at least partially inside the
+ * convex volume bounded by @planes. A point is inside a plane when
+ * a*x + b*y + c*z + d >= 0, so plane normals point into the volume;
+ * a view frustum is six such planes.
+ *
+ * Subtrees that are entirely inside the volume are collected without
+ * further plane tests.
+ *
+ * Returns: Number of objects appended
+ */
+guint
+lrg_octree_query_frustum_into (LrgOctree    *self,
+                               const gfloat *planes,
+                               guint         n_floats,
+                               GPtrArray    *results)
+{
+    guint start;
+    guint n_planes;
+
+    g_return_val_if_fail (LRG_IS_OCTREE (self), 0);
+    g_return_val_if_fail (planes != NULL, 0);
+    g_return_val_if_fail (n_floats % 4 == 0, 0);
+    g_return_val_if_fail (results != NULL, 0);
 
-    return lrg_octree_query_box (self, tiny_box);
+    start = results->len;
+    n_planes = n_floats / 4;
+
+    switch (box_classify_planes (&self->root->loose_bounds, planes, n_planes))
+    {
+    case FRUSTUM_INSIDE:
+        octree_node_collect_all (self->root, results);
+        break;
+    case FRUSTUM_INTERSECTS:
+    case FRUSTUM_OUTSIDE:
+    default:
+        /* The root can hold out-of-bounds objects, so always test it */
+        octree_node_query_frustum (self->root, planes, n_planes, results);
+        break;
+    }
+
+    return results->len - start;
+}
+
+/**
+ * lrg_octree_query_ray_into:
+ * @self: An #LrgOctree
+ * @origin: (transfer none): Ray origin
+ * @direction: (transfer none): Ray direction (need not be normalized)
+ * @max_distance: Maximum distance along the ray
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends every object whose bounds are hit by the ray within
+ * @max_distance. Objects are appended in traversal order, not sorted by
+ * distance; use lrg_octree_raycast() for the closest hit.
+ *
+ * Returns: Number of objects appended
+ */
+guint
+lrg_octree_query_ray_into (LrgOctree        *self,
+                           const GrlVector3 *origin,
+                           const GrlVector3 *direction,
+                           gfloat            max_distance,
+                           GPtrArray        *results)
+{
+    GrlVector3 inv_dir;
+    guint start;
+
+    g_return_val_if_fail (LRG_IS_OCTREE (self), 0);
+    g_return_val_if_fail (origin != NULL, 0);
+    g_return_val_if_fail (direction != NULL, 0);
+    g_return_val_if_fail (results != NULL, 0);
+
+    if (!ray_prepare (direction, &inv_dir))
+        return 0;
+
+    start = results->len;
+    octree_node_query_ray (self->root, origin, &inv_dir, max_distance, results);
+
+    return results->len - start;
+}
+
+/**
+ * lrg_octree_raycast:
+ * @self: An #LrgOctree
+ * @origin: (transfer none): Ray origin
+ * @direction: (transfer none): Ray direction (need not be normalized)
+ * @max_distance: Maximum distance along the ray
+ * @out_distance: (out) (optional): Distance to the hit bounds
+ *
+ * Finds the first object whose bounds are hit by the ray.
+ *
+ * Nodes are visited nearest-first and the search stops as soon as the
+ * closest remaining candidate is an object, so distant parts of the
+ * tree are never touched.
+ *
+ * Returns: (transfer none) (nullable): The closest hit object, or %NULL
+ */
+gpointer
+lrg_octree_raycast (LrgOctree        *self,
+                    const GrlVector3 *origin,
+                    const GrlVector3 *direction,
+                    gfloat            max_distance,
+                    gfloat           *out_distance)
+{
+    g_autoptr(GArray) heap = NULL;
+    GrlVector3 inv_dir;
+    gfloat t;
+
+    g_return_val_if_fail (LRG_IS_OCTREE (self), NULL);
+    g_return_val_if_fail (origin != NULL, NULL);
+    g_return_val_if_fail (direction != NULL, NULL);
+
+    if (self->object_count == 0 || !ray_prepare (direction, &inv_dir))
+        return NULL;
+
+    heap = g_array_sized_new (FALSE, FALSE, sizeof (OctreeQueueItem), 32);
+
+    /* Root is always expanded: it may hold objects outside its bounds */
+    queue_push (heap, 0.0f, self->root, NULL);
+
+    while (heap->len > 0)
+    {
+        OctreeQueueItem item = queue_pop (heap);
+        OctreeNode *node;
+        guint i;
+        gint j;
+
+        if (item.entry != NULL)
+        {
+            if (out_distance != NULL)
+                *out_distance = item.key;
+            return item.entry->object;
+        }
+
+        node = item.node;
+
+        for (i = 0; i < node->entries->len; i++)
+        {
+            OctreeEntry *entry = g_ptr_array_index (node->entries, i);
+            if (ray_intersects_box (&entry->bounds, origin, &inv_dir, max_distance, &t))
+                queue_push (heap, t, NULL, entry);
+        }
+
+        if (node->is_leaf)
+            continue;
+
+        for (j = 0; j < 8; j++)
+        {
+            OctreeNode *child = node->children[j];
+            if (ray_intersects_box (&child->loose_bounds, origin, &inv_dir, max_distance, &t))
+                queue_push (heap, t, child, NULL);
+        }
+    }
+
+    return NULL;
 }
 
 /**
@@ -629,7 +1296,8 @@ lrg_octree_query_point (LrgOctree        *self,
  * @self: An #LrgOctree
  * @point: (transfer none): Point to search from
  *
- * Finds the nearest object to a point.
+ * Finds the nearest object to a point, measured to the center of the
+ * object's bounds.
  *
  * Returns: (transfer none) (nullable): The nearest object, or %NULL if empty
  */
@@ -637,10 +1305,7 @@ gpointer
 lrg_octree_query_nearest (LrgOctree        *self,
                           const GrlVector3 *point)
 {
-    g_autoptr(GPtrArray) candidates = NULL;
-    gpointer nearest;
-    gfloat nearest_dist_sq;
-    guint i;
+    g_autoptr(GPtrArray) results = NULL;
 
     g_return_val_if_fail (LRG_IS_OCTREE (self), NULL);
     g_return_val_if_fail (point != NULL, NULL);
@@ -648,69 +1313,110 @@ lrg_octree_query_nearest (LrgOctree        *self,
     if (self->object_count == 0)
         return NULL;
 
-    /* Start with a reasonable search radius and expand if needed */
-    candidates = lrg_octree_query_sphere (self, point, 100.0f);
+    results = g_ptr_array_sized_new (1);
+    if (lrg_octree_query_k_nearest_into (self, point, 1, results) == 0)
+        return NULL;
 
-    if (candidates->len == 0)
-    {
-        /* Try the whole world */
-        g_ptr_array_unref (candidates);
-        candidates = lrg_octree_query_box (self, &self->bounds);
-    }
+    return g_ptr_array_index (results, 0);
+}
 
-    if (candidates->len == 0)
-        return NULL;
+/**
+ * lrg_octree_query_k_nearest_into:
+ * @self: An #LrgOctree
+ * @point: (transfer none): Point to search from
+ * @k: Maximum number of objects to find
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends up to @k objects nearest to @point to @results, closest first.
+ * Distance is measured to the center of each object's bounds.
+ *
+ * This is a best-first search: nodes and objects share one priority
+ * queue ordered by distance, so only the nodes that can contain one of
+ * the @k nearest objects are expanded.
+ *
+ * Returns: Number of objects appended
+ */
+guint
+lrg_octree_query_k_nearest_into (LrgOctree        *self,
+                                 const GrlVector3 *point,
+                                 guint             k,
+                                 GPtrArray        *results)
+{
+    g_autoptr(GArray) heap = NULL;
+    guint found;
 
-    nearest = NULL;
-    nearest_dist_sq = G_MAXFLOAT;
+    g_return_val_if_fail (LRG_IS_OCTREE (self), 0);
+    g_return_val_if_fail (point != NULL, 0);
+    g_return_val_if_fail (results != NULL, 0);
 
-    for (i = 0; i < candidates->len; i++)
-    {
-        gpointer obj;
-        OctreeNode *node;
-        guint j;
+    if (k == 0 || self->object_count == 0)
+        return 0;
 
-        obj = g_ptr_array_index (candidates, i);
-        node = g_hash_table_lookup (self->object_nodes, obj);
+    heap = g_array_sized_new (FALSE, FALSE, sizeof (OctreeQueueItem), 32);
 
-        if (node == NULL)
-            continue;
+    /* Root is always expanded: it may hold objects outside its bounds */
+    queue_push (heap, 0.0f, self->root, NULL);
+
+    found = 0;
+    while (heap->len > 0 && found < k)
+    {
+        OctreeQueueItem item = queue_pop (heap);
 
-        /* Find the entry for this object */
-        for (j = 0; j < node->entries->len; j++)
+        if (item.entry != NULL)
         {
-            OctreeEntry *entry = g_ptr_array_index (node->entries, j);
-            if (entry->object == obj)
-            {
-                gfloat cx;
-                gfloat cy;
-                gfloat cz;
-                gfloat dx;
-                gfloat dy;
-                gfloat dz;
-                gfloat dist_sq;
-
-                /* Distance from point to center of object bounds */
-                cx = (entry->bounds.min.x + entry->bounds.max.x) * 0.5f;
-                cy = (entry->bounds.min.y + entry->bounds.max.y) * 0.5f;
-                cz = (entry->bounds.min.z + entry->bounds.max.z) * 0.5f;
-
-                dx = point->x - cx;
-                dy = point->y - cy;
-                dz = point->z - cz;
-                dist_sq = dx * dx + dy * dy + dz * dz;
-
-                if (dist_sq < nearest_dist_sq)
-                {
-                    nearest_dist_sq = dist_sq;
-                    nearest = obj;
-                }
-                break;
-            }
+            g_ptr_array_add (results, item.entry->object);
+            found++;
+            continue;
         }
+
+        queue_push_node_contents (heap, item.node, point);
     }
 
-    return nearest;
+    return found;
+}
+
+/**
+ * lrg_octree_get_looseness:
+ * @self: An #LrgOctree
+ *
+ * Gets the looseness factor of the octree nodes.
+ *
+ * Returns: The looseness factor (1.0 for a classic octree)
+ */
+gfloat
+lrg_octree_get_looseness (LrgOctree *self)
+{
+    g_return_val_if_fail (LRG_IS_OCTREE (self), DEFAULT_LOOSENESS);
+
+    return self->looseness;
+}
+
+/**
+ * lrg_octree_set_looseness:
+ * @self: An #LrgOctree
+ * @looseness: Looseness factor, between 1.0 and 2.0
+ *
+ * Sets the looseness factor. Each node accepts objects whose bounds fit
+ * in the node's box scaled by @looseness around its center, so objects
+ * are placed by their center and moving objects rarely cross into a
+ * different node. A factor of 2.0 is the usual loose octree; 1.0 gives
+ * a classic octree. Queries become slightly less tight as looseness
+ * grows.
+ *
+ * The tree is rebuilt if the value changes.
+ */
+void
+lrg_octree_set_looseness (LrgOctree *self,
+                          gfloat     looseness)
+{
+    g_return_if_fail (LRG_IS_OCTREE (self));
+    g_return_if_fail (looseness >= 1.0f && looseness <= MAX_LOOSENESS);
+
+    if (self->looseness == looseness)
+        return;
+
+    self->looseness = looseness;
+    lrg_octree_rebuild (self);
 }
 
 /**
@@ -839,47 +1545,36 @@ lrg_octree_rebuild (LrgOctree *self)
 {
     GPtrArray *all_entries;
     GHashTableIter iter;
-    gpointer key;
     gpointer value;
     guint i;
 
     g_return_if_fail (LRG_IS_OCTREE (self));
 
-    /* Collect all entries */
+    /* Collect copies of all entries; the originals die with the old nodes */
     all_entries = g_ptr_array_new ();
 
-    g_hash_table_iter_init (&iter, self->object_nodes);
-    while (g_hash_table_iter_next (&iter, &key, &value))
+    g_hash_table_iter_init (&iter, self->object_entries);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
     {
-        OctreeNode *node = value;
-        guint j;
-
-        for (j = 0; j < node->entries->len; j++)
-        {
-            OctreeEntry *entry = g_ptr_array_index (node->entries, j);
-            if (entry->object == key)
-            {
-                OctreeEntry *copy = octree_entry_new (entry->object, &entry->bounds);
-                g_ptr_array_add (all_entries, copy);
-                break;
-            }
-        }
+        OctreeEntry *entry = value;
+        g_ptr_array_add (all_entries, octree_entry_new (entry->object, &entry->bounds));
     }
 
     /* Clear and rebuild */
     octree_node_free (self->root);
-    g_hash_table_remove_all (self->object_nodes);
+    g_hash_table_remove_all (self->object_entries);
 
-    self->root = octree_node_new (&self->bounds, 0);
+    self->root = octree_node_new (self, &self->bounds, 0);
     self->node_count = 1;
-    self->object_count = 0;
 
-    /* Re-insert all entries */
+    /* Re-insert all entries; nodes take ownership */
     for (i = 0; i < all_entries->len; i++)
     {
         OctreeEntry *entry = g_ptr_array_index (all_entries, i);
-        lrg_octree_insert (self, entry->object, &entry->bounds);
+
+        octree_node_insert (self, self->root, entry);
+        g_hash_table_insert (self->object_entries, entry->object, entry);
     }
 
-    g_ptr_array_free (all_entries, TRUE);
+    g_ptr_array_unref (all_entries);
 }
@@ -84,7 +84,11 @@ gboolean            lrg_octree_remove               (LrgOctree              *sel
  * @new_bounds: (transfer none): New bounding box for the object
  *
  * Updates an object's position in the octree.
- * This removes and re-inserts the object.
+ *
+ * If the new bounds still fit the (loose) bounds of the node holding
+ * the object and would not be pushed into one of its children, the
+ * entry is updated in place without touching the tree structure.
+ * Otherwise the object is removed and re-inserted.
  *
  * Returns: %TRUE if updated successfully
  */
@@ -115,6 +119,23 @@ LRG_AVAILABLE_IN_ALL
 GPtrArray *         lrg_octree_query_box            (LrgOctree              *self,
                                                      const LrgBoundingBox3D *query);
 
+/**
+ * lrg_octree_query_box_into:
+ * @self: An #LrgOctree
+ * @query: (transfer none): Query bounding box
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects that intersect with the query box to @results.
+ * The array is not cleared first, so callers can reuse one buffer across
+ * frames by calling g_ptr_array_set_size (results, 0) between queries.
+ *
+ * Returns: Number of objects appended
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_octree_query_box_into       (LrgOctree              *self,
+                                                     const LrgBoundingBox3D *query,
+                                                     GPtrArray              *results);
+
 /**
  * lrg_octree_query_sphere:
  * @self: An #LrgOctree
@@ -130,6 +151,23 @@ GPtrArray *         lrg_octree_query_sphere         (LrgOctree              *sel
                                                      const GrlVector3       *center,
                                                      gfloat                  radius);
 
+/**
+ * lrg_octree_query_sphere_into:
+ * @self: An #LrgOctree
+ * @center: (transfer none): Sphere center
+ * @radius: Sphere radius
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects that intersect with a sphere to @results.
+ *
+ * Returns: Number of objects appended
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_octree_query_sphere_into    (LrgOctree              *self,
+                                                     const GrlVector3       *center,
+                                                     gfloat                  radius,
+                                                     GPtrArray              *results);
+
 /**
  * lrg_octree_query_point:
  * @self: An #LrgOctree
@@ -143,12 +181,96 @@ LRG_AVAILABLE_IN_ALL
 GPtrArray *         lrg_octree_query_point          (LrgOctree              *self,
                                                      const GrlVector3       *point);
 
+/**
+ * lrg_octree_query_point_into:
+ * @self: An #LrgOctree
+ * @point: (transfer none): Point to query
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects that contain the given point to @results.
+ *
+ * Returns: Number of objects appended
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_octree_query_point_into     (LrgOctree              *self,
+                                                     const GrlVector3       *point,
+                                                     GPtrArray              *results);
+
+/**
+ * lrg_octree_query_frustum_into:
+ * @self: An #LrgOctree
+ * @planes: (array length=n_floats): Plane equations, four floats (a, b, c, d)
+ *   per plane
+ * @n_floats: Number of floats in @planes (four per plane, usually 24)
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends all objects whose bounds are at least partially inside the
+ * convex volume bounded by @planes. A point is inside a plane when
+ * a*x + b*y + c*z + d >= 0, so plane normals point into the volume;
+ * a view frustum is six such planes.
+ *
+ * Subtrees that are entirely inside the volume are collected without
+ * further plane tests.
+ *
+ * Returns: Number of objects appended
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_octree_query_frustum_into   (LrgOctree              *self,
+                                                     const gfloat           *planes,
+                                                     guint                   n_floats,
+                                                     GPtrArray              *results);
+
+/**
+ * lrg_octree_query_ray_into:
+ * @self: An #LrgOctree
+ * @origin: (transfer none): Ray origin
+ * @direction: (transfer none): Ray direction (need not be normalized)
+ * @max_distance: Maximum distance along the ray
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends every object whose bounds are hit by the ray within
+ * @max_distance. Objects are appended in traversal order, not sorted by
+ * distance; use lrg_octree_raycast() for the closest hit.
+ *
+ * Returns: Number of objects appended
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_octree_query_ray_into       (LrgOctree              *self,
+                                                     const GrlVector3       *origin,
+                                                     const GrlVector3       *direction,
+                                                     gfloat                  max_distance,
+                                                     GPtrArray              *results);
+
+/**
+ * lrg_octree_raycast:
+ * @self: An #LrgOctree
+ * @origin: (transfer none): Ray origin
+ * @direction: (transfer none): Ray direction (need not be normalized)
+ * @max_distance: Maximum distance along the ray
+ * @out_distance: (out) (optional): Distance to the hit bounds
+ *
+ * Finds the first object whose bounds are hit by the ray.
+ *
+ * Nodes are visited nearest-first and the search stops as soon as the
+ * closest remaining candidate is an object, so distant parts of the
+ * tree are never touched.
+ *
+ * Returns: (transfer none) (nullable): The closest hit object, or %NULL
+ */
+LRG_AVAILABLE_IN_ALL
+gpointer            lrg_octree_raycast              (LrgOctree              *self,
+                                                     const GrlVector3       *origin,
+                                                     const GrlVector3       *direction,
+                                                     gfloat                  max_distance,
+                                                     gfloat                 *out_distance);
+
 /**
  * lrg_octree_query_nearest:
  * @self: An #LrgOctree
  * @point: (transfer none): Point to search from
  *
- * Finds the nearest object to a point.
+ * Finds the nearest object to a point, measured to the center of the
+ * object's bounds.
  *
  * Returns: (transfer none) (nullable): The nearest object, or %NULL if empty
  */
@@ -156,6 +278,28 @@ LRG_AVAILABLE_IN_ALL
 gpointer            lrg_octree_query_nearest        (LrgOctree              *self,
                                                      const GrlVector3       *point);
 
+/**
+ * lrg_octree_query_k_nearest_into:
+ * @self: An #LrgOctree
+ * @point: (transfer none): Point to search from
+ * @k: Maximum number of objects to find
+ * @results: (element-type gpointer): Caller-owned array to append objects to
+ *
+ * Appends up to @k objects nearest to @point to @results, closest first.
+ * Distance is measured to the center of each object's bounds.
+ *
+ * This is a best-first search: nodes and objects share one priority
+ * queue ordered by distance, so only the nodes that can contain one of
+ * the @k nearest objects are expanded.
+ *
+ * Returns: Number of objects appended
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_octree_query_k_nearest_into (LrgOctree              *self,
+                                                     const GrlVector3       *point,
+                                                     guint                   k,
+                                                     GPtrArray              *results);
+
 /**
  * lrg_octree_get_bounds:
  * @self: An #LrgOctree
@@ -234,6 +378,35 @@ LRG_AVAILABLE_IN_ALL
 void                lrg_octree_set_max_objects_per_node (LrgOctree          *self,
                                                          guint               max_objects);
 
+/**
+ * lrg_octree_get_looseness:
+ * @self: An #LrgOctree
+ *
+ * Gets the looseness factor of the octree nodes.
+ *
+ * Returns: The looseness factor (1.0 for a classic octree)
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat              lrg_octree_get_looseness        (LrgOctree              *self);
+
+/**
+ * lrg_octree_set_looseness:
+ * @self: An #LrgOctree
+ * @looseness: Looseness factor, between 1.0 and 2.0
+ *
+ * Sets the looseness factor. Each node accepts objects whose bounds fit
+ * in the node's box scaled by @looseness around its center, so objects
+ * are placed by their center and moving objects rarely cross into a
+ * different node. A factor of 2.0 is the usual loose octree; 1.0 gives
+ * a classic octree. Queries become slightly less tight as looseness
+ * grows.
+ *
+ * The tree is rebuilt if the value changes.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_octree_set_looseness        (LrgOctree              *self,
+                                                     gfloat                  looseness);
+
 /**
  * lrg_octree_rebuild:
  * @self: An #LrgOctree
@@ -791,3 +791,53 @@ lrg_portal_system_get_sector_portals (LrgPortalSystem *self,
 
     return result;
 }
+
+/**
+ * lrg_portal_system_get_adjacent_sectors:
+ * @self: An #LrgPortalSystem
+ * @sector_id: Sector ID
+ *
+ * Gets the sectors connected to a sector through a portal, regardless
+ * of portal visibility.
+ *
+ * Returns: (transfer container) (element-type utf8): Array of adjacent sector IDs
+ */
+GPtrArray *
+lrg_portal_system_get_adjacent_sectors (LrgPortalSystem *self,
+                                        const gchar     *sector_id)
+{
+    const LrgSector *sector;
+    g_autoptr(GPtrArray) portal_ids = NULL;
+    GPtrArray *result;
+    guint i;
+
+    g_return_val_if_fail (LRG_IS_PORTAL_SYSTEM (self), NULL);
+    g_return_val_if_fail (sector_id != NULL, NULL);
+
+    result = g_ptr_array_new ();
+
+    sector = lrg_portal_system_get_sector (self, sector_id);
+    if (sector == NULL)
+        return result;
+
+    portal_ids = lrg_sector_get_portal_ids (sector);
+
+    for (i = 0; i < portal_ids->len; i++)
+    {
+        const LrgPortal *portal;
+        const gchar *other_sector;
+
+        portal = lrg_portal_system_get_portal (self, g_ptr_array_index (portal_ids, i));
+        if (portal == NULL)
+            continue;
+
+        other_sector = lrg_portal_get_other_sector (portal, sector_id);
+        if (other_sector == NULL || !g_hash_table_contains (self->sectors, other_sector))
+            continue;
+
+        if (!g_ptr_array_find_with_equal_func (result, other_sector, g_str_equal, NULL))
+            g_ptr_array_add (result, (gpointer)other_sector);
+    }
+
+    return result;
+}
@@ -279,4 +279,18 @@ LRG_AVAILABLE_IN_ALL
 GPtrArray *         lrg_portal_system_get_sector_portals (LrgPortalSystem   *self,
                                                            const gchar       *sector_id);
 
+/**
+ * lrg_portal_system_get_adjacent_sectors:
+ * @self: An #LrgPortalSystem
+ * @sector_id: Sector ID
+ *
+ * Gets the sectors connected to a sector through a portal, regardless
+ * of portal visibility.
+ *
+ * Returns: (transfer container) (element-type utf8): Array of adjacent sector IDs
+ */
+LRG_AVAILABLE_IN_ALL
+GPtrArray *         lrg_portal_system_get_adjacent_sectors (LrgPortalSystem *self,
+                                                             const gchar     *sector_id);
+
 G_END_DECLS
@@ -0,0 +1,1215 @@
+/* lrg-sector-streamer.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Sector-based asynchronous level streaming implementation.
+ */
+
+#include "config.h"
+#include "lrg-sector-streamer.h"
+#include <math.h>
+
+#define DEFAULT_MAX_RESIDENT         8
+#define DEFAULT_PREFETCH_DEPTH       1
+#define DEFAULT_MAX_CONCURRENT_LOADS 2
+
+/*
+ * LoadClosure:
+ *
+ * Reference counted load function and user data. Loads in flight and
+ * resident sectors each hold a reference, so replacing the load function
+ * never frees user data or a content destroy function still in use.
+ */
+typedef struct
+{
+    LrgSectorLoadFunc func;
+    gpointer          user_data;
+    GDestroyNotify    user_data_destroy;
+    GDestroyNotify    content_destroy;
+} LoadClosure;
+
+typedef struct
+{
+    gchar        *id;
+    gpointer      content;
+    LoadClosure  *closure;      /* nullable */
+    GCancellable *cancellable;  /* non-NULL while loading */
+    gboolean      loaded;
+} StreamEntry;
+
+typedef struct
+{
+    gchar  *id;
+    guint   hops;               /* Portals away from a visible sector */
+    gfloat  distance;           /* Camera distance to sector bounds */
+} WantedSector;
+
+typedef struct
+{
+    gchar       *id;
+    LrgSector   *sector;        /* Private copy for the worker thread */
+    LoadClosure *closure;
+} LoadRequest;
+
+struct _LrgSectorStreamer
+{
+    GObject          parent_instance;
+
+    LrgPortalSystem *portal_system;
+    LoadClosure     *closure;
+
+    GHashTable      *entries;   /* gchar* -> StreamEntry*, loading or loaded */
+    GHashTable      *failed;    /* gchar* set, failed since the last update */
+    GArray          *wanted;    /* WantedSector, highest priority first */
+    guint            n_target;  /* Leading wanted sectors within budget */
+    guint            n_loading;
+
+    guint            max_resident;
+    guint            prefetch_depth;
+    gfloat           prefetch_distance;
+    guint            max_concurrent_loads;
+};
+
+G_DEFINE_FINAL_TYPE (LrgSectorStreamer, lrg_sector_streamer, G_TYPE_OBJECT)
+
+enum {
+    PROP_0,
+    PROP_PORTAL_SYSTEM,
+    PROP_MAX_RESIDENT,
+    PROP_PREFETCH_DEPTH,
+    PROP_PREFETCH_DISTANCE,
+    PROP_MAX_CONCURRENT_LOADS,
+    PROP_LOADED_COUNT,
+    PROP_LOADING_COUNT,
+    N_PROPS
+};
+
+static GParamSpec *properties[N_PROPS];
+
+enum {
+    SIGNAL_SECTOR_LOADED,
+    SIGNAL_SECTOR_UNLOADED,
+    SIGNAL_SECTOR_LOAD_FAILED,
+    N_SIGNALS
+};
+
+static guint signals[N_SIGNALS];
+
+static void streamer_pump (LrgSectorStreamer *self);
+
+static void
+load_closure_clear (gpointer data)
+{
+    LoadClosure *closure = data;
+
+    if (closure->user_data_destroy != NULL)
+        closure->user_data_destroy (closure->user_data);
+}
+
+static void
+load_closure_release (LoadClosure *closure)
+{
+    g_atomic_rc_box_release_full (closure, load_closure_clear);
+}
+
+static void
+stream_entry_free (gpointer data)
+{
+    StreamEntry *entry = data;
+
+    if (entry->cancellable != NULL)
+    {
+        g_cancellable_cancel (entry->cancellable);
+        g_object_unref (entry->cancellable);
+    }
+
+    if (entry->content != NULL && entry->closure != NULL &&
+        entry->closure->content_destroy != NULL)
+        entry->closure->content_destroy (entry->content);
+
+    g_clear_pointer (&entry->closure, load_closure_release);
+    g_free (entry->id);
+    g_free (entry);
+}
+
+static void
+wanted_sector_clear (gpointer data)
+{
+    WantedSector *wanted = data;
+
+    g_free (wanted->id);
+}
+
+static void
+load_request_free (gpointer data)
+{
+    LoadRequest *request = data;
+
+    g_free (request->id);
+    lrg_sector_free (request->sector);
+    load_closure_release (request->closure);
+    g_free (request);
+}
+
+/*
+ * bounds_distance:
+ *
+ * Distance from a point to the closest point of a box, 0 inside.
+ */
+static gfloat
+bounds_distance (const LrgBoundingBox3D *bounds,
+                 const GrlVector3       *point)
+{
+    gfloat dx;
+    gfloat dy;
+    gfloat dz;
+
+    dx = MAX (MAX (bounds->min.x - point->x, 0.0f), point->x - bounds->max.x);
+    dy = MAX (MAX (bounds->min.y - point->y, 0.0f), point->y - bounds->max.y);
+    dz = MAX (MAX (bounds->min.z - point->z, 0.0f), point->z - bounds->max.z);
+
+    return sqrtf (dx * dx + dy * dy + dz * dz);
+}
+
+static gfloat
+sector_distance (LrgSectorStreamer *self,
+                 const gchar       *sector_id,
+                 const GrlVector3  *point)
+{
+    const LrgSector *sector;
+    g_autoptr(LrgBoundingBox3D) bounds = NULL;
+
+    sector = lrg_portal_system_get_sector (self->portal_system, sector_id);
+    if (sector == NULL)
+        return G_MAXFLOAT;
+
+    bounds = lrg_sector_get_bounds (sector);
+    return bounds_distance (bounds, point);
+}
+
+static gint
+wanted_sector_compare (gconstpointer a,
+                       gconstpointer b)
+{
+    const WantedSector *wa = a;
+    const WantedSector *wb = b;
+
+    /* Visible sectors first, then prefetch candidates nearest first */
+    if ((wa->hops == 0) != (wb->hops == 0))
+        return wa->hops == 0 ? -1 : 1;
+    if (wa->distance != wb->distance)
+        return wa->distance < wb->distance ? -1 : 1;
+    if (wa->hops != wb->hops)
+        return wa->hops < wb->hops ? -1 : 1;
+
+    return 0;
+}
+
+/*
+ * collect_wanted:
+ *
+ * Breadth-first walk over portal adjacency starting at the visible
+ * sectors, filling self->wanted in priority order. Returns the number
+ * of visible sectors.
+ */
+static guint
+collect_wanted (LrgSectorStreamer *self,
+                const GrlVector3  *camera_pos)
+{
+    g_autoptr(GPtrArray) visible = NULL;
+    g_autoptr(GHashTable) seen = NULL;
+    guint n_visible;
+    guint head;
+    guint i;
+
+    g_array_set_size (self->wanted, 0);
+    seen = g_hash_table_new (g_str_hash, g_str_equal);
+
+    visible = lrg_portal_system_get_visible_sectors (self->portal_system);
+    if (visible->len == 0)
+    {
+        /* Portal system not updated yet, or camera outside every sector */
+        const LrgSector *current;
+
+        current = lrg_portal_system_find_sector_at (self->portal_system, camera_pos);
+        if (current != NULL)
+            g_ptr_array_add (visible, (gpointer)current);
+    }
+
+    for (i = 0; i < visible->len; i++)
+    {
+        const gchar *id = lrg_sector_get_id (g_ptr_array_index (visible, i));
+        WantedSector wanted;
+
+        if (!g_hash_table_add (seen, (gpointer)id))
+            continue;
+
+        wanted.id = g_strdup (id);
+        wanted.hops = 0;
+        wanted.distance = sector_distance (self, id, camera_pos);
+        g_array_append_val (self->wanted, wanted);
+    }
+
+    n_visible = self->wanted->len;
+
+    for (head = 0; head < self->wanted->len; head++)
+    {
+        g_autoptr(GPtrArray) adjacent = NULL;
+        guint hops;
+
+        hops = g_array_index (self->wanted, WantedSector, head).hops;
+        if (hops >= self->prefetch_depth)
+            continue;
+
+        adjacent = lrg_portal_system_get_adjacent_sectors (self->portal_system,
+                                                           g_array_index (self->wanted, WantedSector, head).id);
+
+        for (i = 0; i < adjacent->len; i++)
+        {
+            const gchar *id = g_ptr_array_index (adjacent, i);
+            WantedSector wanted;
+
+            if (!g_hash_table_add (seen, (gpointer)id))
+                continue;
+
+            wanted.distance = sector_distance (self, id, camera_pos);
+            if (self->prefetch_distance > 0.0f && wanted.distance > self->prefetch_distance)
+                continue;
+
+            wanted.id = g_strdup (id);
+            wanted.hops = hops + 1;
+            g_array_append_val (self->wanted, wanted);
+        }
+    }
+
+    g_array_sort (self->wanted, wanted_sector_compare);
+
+    return n_visible;
+}
+
+static void
+unload_entry (LrgSectorStreamer *self,
+              StreamEntry       *entry)
+{
+    if (entry->loaded)
+    {
+        g_signal_emit (self, signals[SIGNAL_SECTOR_UNLOADED], 0,
+                       entry->id, entry->content);
+    }
+    else
+    {
+        self->n_loading--;
+    }
+
+    /* Frees content and cancels a load in flight */
+    g_hash_table_remove (self->entries, entry->id);
+}
+
+static void
+finish_load (LrgSectorStreamer *self,
+             StreamEntry       *entry,
+             gpointer           content)
+{
+    entry->loaded = TRUE;
+    entry->content = content;
+    g_clear_object (&entry->cancellable);
+
+    g_signal_emit (self, signals[SIGNAL_SECTOR_LOADED], 0, entry->id, entry->content);
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADED_COUNT]);
+}
+
+static void
+load_task_thread (GTask        *task,
+                  gpointer      source_object,
+                  gpointer      task_data,
+                  GCancellable *cancellable)
+{
+    LoadRequest *request = task_data;
+    GError *error = NULL;
+    gpointer content;
+
+    if (g_task_return_error_if_cancelled (task))
+        return;
+
+    content = request->closure->func (request->sector,
+                                      request->closure->user_data,
+                                      cancellable, &error);
+
+    if (error != NULL)
+    {
+        if (content != NULL && request->closure->content_destroy != NULL)
+            request->closure->content_destroy (content);
+        g_task_return_error (task, error);
+        return;
+    }
+
+    g_task_return_pointer (task, content, request->closure->content_destroy);
+}
+
+static void
+on_load_finished (GObject      *source_object,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+    LrgSectorStreamer *self = LRG_SECTOR_STREAMER (source_object);
+    GTask *task = G_TASK (result);
+    LoadRequest *request = g_task_get_task_data (task);
+    g_autoptr(GError) error = NULL;
+    StreamEntry *entry;
+    gpointer content;
+
+    content = g_task_propagate_pointer (task, &error);
+    entry = g_hash_table_lookup (self->entries, request->id);
+
+    /* Superseded: the sector was unloaded or re-requested meanwhile */
+    if (entry == NULL || entry->loaded ||
+        entry->cancellable != g_task_get_cancellable (task))
+    {
+        if (content != NULL && request->closure->content_destroy != NULL)
+            request->closure->content_destroy (content);
+        return;
+    }
+
+    self->n_loading--;
+
+    if (error != NULL)
+    {
+        g_autofree gchar *id = g_strdup (request->id);
+
+        g_hash_table_remove (self->entries, id);
+        g_hash_table_add (self->failed, g_strdup (id));
+        g_signal_emit (self, signals[SIGNAL_SECTOR_LOAD_FAILED], 0, id, error);
+    }
+    else
+    {
+        finish_load (self, entry, content);
+    }
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING_COUNT]);
+    streamer_pump (self);
+}
+
+static void
+start_load (LrgSectorStreamer *self,
+            const gchar       *sector_id)
+{
+    const LrgSector *sector;
+    StreamEntry *entry;
+    LoadRequest *request;
+    g_autoptr(GTask) task = NULL;
+
+    sector = lrg_portal_system_get_sector (self->portal_system, sector_id);
+    if (sector == NULL)
+        return;
+
+    entry = g_new0 (StreamEntry, 1);
+    entry->id = g_strdup (sector_id);
+    if (self->closure != NULL)
+        entry->closure = g_atomic_rc_box_acquire (self->closure);
+    g_hash_table_insert (self->entries, entry->id, entry);
+
+    if (self->closure == NULL || self->closure->func == NULL)
+    {
+        finish_load (self, entry, NULL);
+        return;
+    }
+
+    entry->cancellable = g_cancellable_new ();
+    self->n_loading++;
+
+    request = g_new0 (LoadRequest, 1);
+    request->id = g_strdup (sector_id);
+    request->sector = lrg_sector_copy (sector);
+    request->closure = g_atomic_rc_box_acquire (self->closure);
+
+    task = g_task_new (self, entry->cancellable, on_load_finished, NULL);
+    g_task_set_source_tag (task, start_load);
+    g_task_set_task_data (task, request, load_request_free);
+    g_task_run_in_thread (task, load_task_thread);
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING_COUNT]);
+}
+
+/*
+ * streamer_pump:
+ *
+ * Starts loads for wanted sectors within the budget, highest
+ * priority first, up to the concurrency limit. Sectors that failed
+ * since the last update are left for the next one.
+ */
+static void
+streamer_pump (LrgSectorStreamer *self)
+{
+    guint i;
+
+    for (i = 0; i < self->n_target && i < self->wanted->len; i++)
+    {
+        const gchar *id;
+
+        if (self->n_loading >= self->max_concurrent_loads)
+            break;
+
+        id = g_array_index (self->wanted, WantedSector, i).id;
+        if (!g_hash_table_contains (self->entries, id) &&
+            !g_hash_table_contains (self->failed, id))
+            start_load (self, id);
+    }
+}
+
+typedef struct
+{
+    StreamEntry *entry;
+    gfloat       distance;
+} EvictCandidate;
+
+static gint
+evict_candidate_compare (gconstpointer a,
+                         gconstpointer b)
+{
+    const EvictCandidate *ca = a;
+    const EvictCandidate *cb = b;
+
+    /* Farthest first */
+    if (ca->distance != cb->distance)
+        return ca->distance > cb->distance ? -1 : 1;
+
+    return 0;
+}
+
+static void
+lrg_sector_streamer_dispose (GObject *object)
+{
+    LrgSectorStreamer *self = LRG_SECTOR_STREAMER (object);
+
+    if (self->entries != NULL)
+        g_hash_table_remove_all (self->entries);
+    self->n_loading = 0;
+
+    G_OBJECT_CLASS (lrg_sector_streamer_parent_class)->dispose (object);
+}
+
+static void
+lrg_sector_streamer_finalize (GObject *object)
+{
+    LrgSectorStreamer *self = LRG_SECTOR_STREAMER (object);
+
+    g_clear_pointer (&self->entries, g_hash_table_unref);
+    g_clear_pointer (&self->failed, g_hash_table_unref);
+    g_clear_pointer (&self->wanted, g_array_unref);
+    g_clear_pointer (&self->closure, load_closure_release);
+    g_clear_object (&self->portal_system);
+
+    G_OBJECT_CLASS (lrg_sector_streamer_parent_class)->finalize (object);
+}
+
+static void
+lrg_sector_streamer_get_property (GObject    *object,
+                                  guint       prop_id,
+                                  GValue     *value,
+                                  GParamSpec *pspec)
+{
+    LrgSectorStreamer *self = LRG_SECTOR_STREAMER (object);
+
+    switch (prop_id)
+    {
+    case PROP_PORTAL_SYSTEM:
+        g_value_set_object (value, self->portal_system);
+        break;
+    case PROP_MAX_RESIDENT:
+        g_value_set_uint (value, self->max_resident);
+        break;
+    case PROP_PREFETCH_DEPTH:
+        g_value_set_uint (value, self->prefetch_depth);
+        break;
+    case PROP_PREFETCH_DISTANCE:
+        g_value_set_float (value, self->prefetch_distance);
+        break;
+    case PROP_MAX_CONCURRENT_LOADS:
+        g_value_set_uint (value, self->max_concurrent_loads);
+        break;
+    case PROP_LOADED_COUNT:
+        g_value_set_uint (value, lrg_sector_streamer_get_loaded_count (self));
+        break;
+    case PROP_LOADING_COUNT:
+        g_value_set_uint (value, self->n_loading);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+lrg_sector_streamer_set_property (GObject      *object,
+                                  guint         prop_id,
+                                  const GValue *value,
+                                  GParamSpec   *pspec)
+{
+    LrgSectorStreamer *self = LRG_SECTOR_STREAMER (object);
+
+    switch (prop_id)
+    {
+    case PROP_PORTAL_SYSTEM:
+        self->portal_system = g_value_dup_object (value);
+        break;
+    case PROP_MAX_RESIDENT:
+        lrg_sector_streamer_set_max_resident (self, g_value_get_uint (value));
+        break;
+    case PROP_PREFETCH_DEPTH:
+        lrg_sector_streamer_set_prefetch_depth (self, g_value_get_uint (value));
+        break;
+    case PROP_PREFETCH_DISTANCE:
+        lrg_sector_streamer_set_prefetch_distance (self, g_value_get_float (value));
+        break;
+    case PROP_MAX_CONCURRENT_LOADS:
+        lrg_sector_streamer_set_max_concurrent_loads (self, g_value_get_uint (value));
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+lrg_sector_streamer_class_init (LrgSectorStreamerClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->dispose = lrg_sector_streamer_dispose;
+    object_class->finalize = lrg_sector_streamer_finalize;
+    object_class->get_property = lrg_sector_streamer_get_property;
+    object_class->set_property = lrg_sector_streamer_set_property;
+
+    /**
+     * LrgSectorStreamer:portal-system:
+     *
+     * The portal system providing sectors, visibility and adjacency.
+     */
+    properties[PROP_PORTAL_SYSTEM] =
+        g_param_spec_object ("portal-system",
+                             "Portal System",
+                             "Portal system providing sectors",
+                             LRG_TYPE_PORTAL_SYSTEM,
+                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                             G_PARAM_STATIC_STRINGS);
+
+    /**
+     * LrgSectorStreamer:max-resident:
+     *
+     * Residency budget: maximum number of resident or loading sectors.
+     */
+    properties[PROP_MAX_RESIDENT] =
+        g_param_spec_uint ("max-resident",
+                           "Max Resident",
+                           "Maximum number of resident sectors",
+                           1, G_MAXUINT, DEFAULT_MAX_RESIDENT,
+                           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                           G_PARAM_EXPLICIT_NOTIFY);
+
+    /**
+     * LrgSectorStreamer:prefetch-depth:
+     *
+     * How many portals away from a visible sector are loaded in advance.
+     */
+    properties[PROP_PREFETCH_DEPTH] =
+        g_param_spec_uint ("prefetch-depth",
+                           "Prefetch Depth",
+                           "Portal hops prefetched around visible sectors",
+                           0, 16, DEFAULT_PREFETCH_DEPTH,
+                           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                           G_PARAM_EXPLICIT_NOTIFY);
+
+    /**
+     * LrgSectorStreamer:prefetch-distance:
+     *
+     * Maximum camera distance for prefetched sectors, 0 for unlimited.
+     */
+    properties[PROP_PREFETCH_DISTANCE] =
+        g_param_spec_float ("prefetch-distance",
+                            "Prefetch Distance",
+                            "Maximum camera distance for prefetching",
+                            0.0f, G_MAXFLOAT, 0.0f,
+                            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                            G_PARAM_EXPLICIT_NOTIFY);
+
+    /**
+     * LrgSectorStreamer:max-concurrent-loads:
+     *
+     * Maximum number of sector loads in flight.
+     */
+    properties[PROP_MAX_CONCURRENT_LOADS] =
+        g_param_spec_uint ("max-concurrent-loads",
+                           "Max Concurrent Loads",
+                           "Maximum number of loads in flight",
+                           1, 64, DEFAULT_MAX_CONCURRENT_LOADS,
+                           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                           G_PARAM_EXPLICIT_NOTIFY);
+
+    /**
+     * LrgSectorStreamer:loaded-count:
+     *
+     * The number of resident sectors.
+     */
+    properties[PROP_LOADED_COUNT] =
+        g_param_spec_uint ("loaded-count",
+                           "Loaded Count",
+                           "Number of resident sectors",
+                           0, G_MAXUINT, 0,
+                           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+    /**
+     * LrgSectorStreamer:loading-count:
+     *
+     * The number of sector loads in flight.
+     */
+    properties[PROP_LOADING_COUNT] =
+        g_param_spec_uint ("loading-count",
+                           "Loading Count",
+                           "Number of loads in flight",
+                           0, G_MAXUINT, 0,
+                           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+    g_object_class_install_properties (object_class, N_PROPS, properties);
+
+    /**
+     * LrgSectorStreamer::sector-loaded:
+     * @self: An #LrgSectorStreamer
+     * @sector_id: The sector that became resident
+     * @content: (nullable): Contents returned by the load function
+     *
+     * Emitted on the main context when a sector's contents are loaded.
+     */
+    signals[SIGNAL_SECTOR_LOADED] =
+        g_signal_new ("sector-loaded",
+                      G_TYPE_FROM_CLASS (klass),
+                      G_SIGNAL_RUN_LAST,
+                      0, NULL, NULL, NULL,
+                      G_TYPE_NONE, 2, G_TYPE_STRING, G_TYPE_POINTER);
+
+    /**
+     * LrgSectorStreamer::sector-unloaded:
+     * @self: An #LrgSectorStreamer
+     * @sector_id: The sector being unloaded
+     * @content: (nullable): Contents about to be freed
+     *
+     * Emitted before a resident sector's contents are freed.
+     */
+    signals[SIGNAL_SECTOR_UNLOADED] =
+        g_signal_new ("sector-unloaded",
+                      G_TYPE_FROM_CLASS (klass),
+                      G_SIGNAL_RUN_LAST,
+                      0, NULL, NULL, NULL,
+                      G_TYPE_NONE, 2, G_TYPE_STRING, G_TYPE_POINTER);
+
+    /**
+     * LrgSectorStreamer::sector-load-failed:
+     * @self: An #LrgSectorStreamer
+     * @sector_id: The sector that failed to load
+     * @error: The error reported by the load function
+     *
+     * Emitted when the load function fails. The sector is retried on
+     * the next lrg_sector_streamer_update() while it is still wanted.
+     */
+    signals[SIGNAL_SECTOR_LOAD_FAILED] =
+        g_signal_new ("sector-load-failed",
+                      G_TYPE_FROM_CLASS (klass),
+                      G_SIGNAL_RUN_LAST,
+                      0, NULL, NULL, NULL,
+                      G_TYPE_NONE, 2, G_TYPE_STRING, G_TYPE_ERROR);
+}
+
+static void
+lrg_sector_streamer_init (LrgSectorStreamer *self)
+{
+    self->entries = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                           NULL, stream_entry_free);
+    self->failed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    self->wanted = g_array_new (FALSE, FALSE, sizeof (WantedSector));
+    g_array_set_clear_func (self->wanted, wanted_sector_clear);
+    self->closure = NULL;
+    self->n_target = 0;
+    self->n_loading = 0;
+    self->max_resident = DEFAULT_MAX_RESIDENT;
+    self->prefetch_depth = DEFAULT_PREFETCH_DEPTH;
+    self->prefetch_distance = 0.0f;
+    self->max_concurrent_loads = DEFAULT_MAX_CONCURRENT_LOADS;
+}
+
+/**
+ * lrg_sector_streamer_new:
+ * @portal_system: (transfer none): Portal system providing sectors and adjacency
+ *
+ * Creates a new sector streamer.
+ *
+ * Returns: (transfer full): A new #LrgSectorStreamer
+ */
+LrgSectorStreamer *
+lrg_sector_streamer_new (LrgPortalSystem *portal_system)
+{
+    g_return_val_if_fail (LRG_IS_PORTAL_SYSTEM (portal_system), NULL);
+
+    return g_object_new (LRG_TYPE_SECTOR_STREAMER,
+                         "portal-system", portal_system,
+                         NULL);
+}
+
+/**
+ * lrg_sector_streamer_get_portal_system:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the portal system used for visibility and adjacency.
+ *
+ * Returns: (transfer none): The portal system
+ */
+LrgPortalSystem *
+lrg_sector_streamer_get_portal_system (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), NULL);
+
+    return self->portal_system;
+}
+
+/**
+ * lrg_sector_streamer_set_load_func:
+ * @self: An #LrgSectorStreamer
+ * @func: (nullable) (scope notified): Function loading sector contents
+ * @user_data: (closure): User data for @func, must be thread-safe
+ * @user_data_destroy: (nullable): Destroy notify for @user_data
+ * @content_destroy: (nullable): Frees contents returned by @func
+ *
+ * Sets the function used to load sector contents in the background.
+ * Sectors already resident keep their contents and are freed with the
+ * destroy function they were loaded with.
+ */
+void
+lrg_sector_streamer_set_load_func (LrgSectorStreamer *self,
+                                   LrgSectorLoadFunc  func,
+                                   gpointer           user_data,
+                                   GDestroyNotify     user_data_destroy,
+                                   GDestroyNotify     content_destroy)
+{
+    LoadClosure *closure;
+
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+
+    closure = g_atomic_rc_box_new0 (LoadClosure);
+    closure->func = func;
+    closure->user_data = user_data;
+    closure->user_data_destroy = user_data_destroy;
+    closure->content_destroy = content_destroy;
+
+    g_clear_pointer (&self->closure, load_closure_release);
+    self->closure = closure;
+}
+
+/* --- Streaming --- */
+
+/**
+ * lrg_sector_streamer_update:
+ * @self: An #LrgSectorStreamer
+ * @camera_pos: (transfer none): Camera position
+ *
+ * Recomputes the wanted sector set and schedules loads and unloads.
+ * Call once per frame after lrg_portal_system_update().
+ */
+void
+lrg_sector_streamer_update (LrgSectorStreamer *self,
+                            const GrlVector3  *camera_pos)
+{
+    g_autoptr(GHashTable) targets = NULL;
+    g_autoptr(GPtrArray) stale = NULL;
+    g_autoptr(GArray) candidates = NULL;
+    GHashTableIter iter;
+    gpointer value;
+    guint n_visible;
+    guint budget;
+    guint missing;
+    guint i;
+
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+    g_return_if_fail (camera_pos != NULL);
+
+    /* Failed sectors get one more attempt per update */
+    g_hash_table_remove_all (self->failed);
+
+    n_visible = collect_wanted (self, camera_pos);
+
+    /* Visible sectors are never dropped, even over budget */
+    budget = MAX (self->max_resident, n_visible);
+    self->n_target = MIN (budget, self->wanted->len);
+
+    targets = g_hash_table_new (g_str_hash, g_str_equal);
+    missing = 0;
+    for (i = 0; i < self->n_target; i++)
+    {
+        const gchar *id = g_array_index (self->wanted, WantedSector, i).id;
+
+        g_hash_table_add (targets, (gpointer)id);
+        if (!g_hash_table_contains (self->entries, id))
+            missing++;
+    }
+
+    /*
+     * Loads that are no longer wanted are cancelled; resident sectors
+     * outside the target set stay cached until the budget needs room.
+     */
+    stale = g_ptr_array_new ();
+    candidates = g_array_new (FALSE, FALSE, sizeof (EvictCandidate));
+
+    g_hash_table_iter_init (&iter, self->entries);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        StreamEntry *entry = value;
+        EvictCandidate candidate;
+
+        if (g_hash_table_contains (targets, entry->id))
+            continue;
+
+        if (!entry->loaded)
+        {
+            g_ptr_array_add (stale, entry);
+            continue;
+        }
+
+        candidate.entry = entry;
+        candidate.distance = sector_distance (self, entry->id, camera_pos);
+        g_array_append_val (candidates, candidate);
+    }
+
+    for (i = 0; i < stale->len; i++)
+        unload_entry (self, g_ptr_array_index (stale, i));
+
+    if (stale->len > 0)
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING_COUNT]);
+
+    g_array_sort (candidates, evict_candidate_compare);
+
+    for (i = 0; i < candidates->len; i++)
+    {
+        if (g_hash_table_size (self->entries) + missing <= budget)
+            break;
+
+        unload_entry (self, g_array_index (candidates, EvictCandidate, i).entry);
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADED_COUNT]);
+    }
+
+    streamer_pump (self);
+}
+
+/**
+ * lrg_sector_streamer_unload_all:
+ * @self: An #LrgSectorStreamer
+ *
+ * Cancels pending loads and unloads every resident sector.
+ */
+void
+lrg_sector_streamer_unload_all (LrgSectorStreamer *self)
+{
+    g_autoptr(GPtrArray) entries = NULL;
+    GHashTableIter iter;
+    gpointer value;
+    guint i;
+
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+
+    entries = g_ptr_array_new ();
+    g_hash_table_iter_init (&iter, self->entries);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+        g_ptr_array_add (entries, value);
+
+    for (i = 0; i < entries->len; i++)
+        unload_entry (self, g_ptr_array_index (entries, i));
+
+    g_array_set_size (self->wanted, 0);
+    self->n_target = 0;
+
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADED_COUNT]);
+    g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING_COUNT]);
+}
+
+/* --- State Queries --- */
+
+/**
+ * lrg_sector_streamer_is_sector_loaded:
+ * @self: An #LrgSectorStreamer
+ * @sector_id: Sector ID
+ *
+ * Checks if a sector is resident.
+ *
+ * Returns: %TRUE if the sector's contents are loaded
+ */
+gboolean
+lrg_sector_streamer_is_sector_loaded (LrgSectorStreamer *self,
+                                      const gchar       *sector_id)
+{
+    StreamEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), FALSE);
+    g_return_val_if_fail (sector_id != NULL, FALSE);
+
+    entry = g_hash_table_lookup (self->entries, sector_id);
+
+    return entry != NULL && entry->loaded;
+}
+
+/**
+ * lrg_sector_streamer_is_sector_loading:
+ * @self: An #LrgSectorStreamer
+ * @sector_id: Sector ID
+ *
+ * Checks if a sector is being loaded in the background.
+ *
+ * Returns: %TRUE if a load is in flight
+ */
+gboolean
+lrg_sector_streamer_is_sector_loading (LrgSectorStreamer *self,
+                                       const gchar       *sector_id)
+{
+    StreamEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), FALSE);
+    g_return_val_if_fail (sector_id != NULL, FALSE);
+
+    entry = g_hash_table_lookup (self->entries, sector_id);
+
+    return entry != NULL && !entry->loaded;
+}
+
+/**
+ * lrg_sector_streamer_get_sector_content:
+ * @self: An #LrgSectorStreamer
+ * @sector_id: Sector ID
+ *
+ * Gets the contents returned by the load function for a resident sector.
+ *
+ * Returns: (transfer none) (nullable): The contents, or %NULL
+ */
+gpointer
+lrg_sector_streamer_get_sector_content (LrgSectorStreamer *self,
+                                        const gchar       *sector_id)
+{
+    StreamEntry *entry;
+
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), NULL);
+    g_return_val_if_fail (sector_id != NULL, NULL);
+
+    entry = g_hash_table_lookup (self->entries, sector_id);
+    if (entry == NULL || !entry->loaded)
+        return NULL;
+
+    return entry->content;
+}
+
+/**
+ * lrg_sector_streamer_get_loaded_sectors:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the IDs of all resident sectors.
+ *
+ * Returns: (transfer container) (element-type utf8): Array of sector IDs
+ */
+GPtrArray *
+lrg_sector_streamer_get_loaded_sectors (LrgSectorStreamer *self)
+{
+    GPtrArray *result;
+    GHashTableIter iter;
+    gpointer value;
+
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), NULL);
+
+    result = g_ptr_array_new ();
+
+    g_hash_table_iter_init (&iter, self->entries);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        StreamEntry *entry = value;
+        if (entry->loaded)
+            g_ptr_array_add (result, entry->id);
+    }
+
+    return result;
+}
+
+/**
+ * lrg_sector_streamer_get_loaded_count:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the number of resident sectors.
+ *
+ * Returns: Resident sector count
+ */
+guint
+lrg_sector_streamer_get_loaded_count (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), 0);
+
+    return g_hash_table_size (self->entries) - self->n_loading;
+}
+
+/**
+ * lrg_sector_streamer_get_loading_count:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the number of loads in flight.
+ *
+ * Returns: Pending load count
+ */
+guint
+lrg_sector_streamer_get_loading_count (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), 0);
+
+    return self->n_loading;
+}
+
+/* --- Configuration --- */
+
+/**
+ * lrg_sector_streamer_get_max_resident:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the residency budget.
+ *
+ * Returns: Maximum number of resident or loading sectors
+ */
+guint
+lrg_sector_streamer_get_max_resident (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), 0);
+
+    return self->max_resident;
+}
+
+/**
+ * lrg_sector_streamer_set_max_resident:
+ * @self: An #LrgSectorStreamer
+ * @max_resident: Maximum number of resident or loading sectors
+ *
+ * Sets the residency budget. Takes effect on the next update.
+ */
+void
+lrg_sector_streamer_set_max_resident (LrgSectorStreamer *self,
+                                      guint              max_resident)
+{
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+    g_return_if_fail (max_resident >= 1);
+
+    if (self->max_resident != max_resident)
+    {
+        self->max_resident = max_resident;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MAX_RESIDENT]);
+    }
+}
+
+/**
+ * lrg_sector_streamer_get_prefetch_depth:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets how many portals away from visible sectors are prefetched.
+ *
+ * Returns: Prefetch depth
+ */
+guint
+lrg_sector_streamer_get_prefetch_depth (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), 0);
+
+    return self->prefetch_depth;
+}
+
+/**
+ * lrg_sector_streamer_set_prefetch_depth:
+ * @self: An #LrgSectorStreamer
+ * @depth: Prefetch depth, 0 to load visible sectors only
+ *
+ * Sets how many portals away from visible sectors are prefetched.
+ */
+void
+lrg_sector_streamer_set_prefetch_depth (LrgSectorStreamer *self,
+                                        guint              depth)
+{
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+    g_return_if_fail (depth <= 16);
+
+    if (self->prefetch_depth != depth)
+    {
+        self->prefetch_depth = depth;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PREFETCH_DEPTH]);
+    }
+}
+
+/**
+ * lrg_sector_streamer_get_prefetch_distance:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the maximum camera distance for prefetched sectors.
+ *
+ * Returns: Prefetch distance, or 0 for unlimited
+ */
+gfloat
+lrg_sector_streamer_get_prefetch_distance (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), 0.0f);
+
+    return self->prefetch_distance;
+}
+
+/**
+ * lrg_sector_streamer_set_prefetch_distance:
+ * @self: An #LrgSectorStreamer
+ * @distance: Maximum distance from the camera to a prefetched sector's
+ *   bounds, or 0 for unlimited
+ *
+ * Limits prefetching to sectors near the camera.
+ */
+void
+lrg_sector_streamer_set_prefetch_distance (LrgSectorStreamer *self,
+                                           gfloat             distance)
+{
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+    g_return_if_fail (distance >= 0.0f);
+
+    if (self->prefetch_distance != distance)
+    {
+        self->prefetch_distance = distance;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PREFETCH_DISTANCE]);
+    }
+}
+
+/**
+ * lrg_sector_streamer_get_max_concurrent_loads:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the maximum number of loads in flight.
+ *
+ * Returns: Maximum concurrent loads
+ */
+guint
+lrg_sector_streamer_get_max_concurrent_loads (LrgSectorStreamer *self)
+{
+    g_return_val_if_fail (LRG_IS_SECTOR_STREAMER (self), 0);
+
+    return self->max_concurrent_loads;
+}
+
+/**
+ * lrg_sector_streamer_set_max_concurrent_loads:
+ * @self: An #LrgSectorStreamer
+ * @max_loads: Maximum number of loads in flight
+ *
+ * Sets the maximum number of loads in flight.
+ */
+void
+lrg_sector_streamer_set_max_concurrent_loads (LrgSectorStreamer *self,
+                                              guint              max_loads)
+{
+    g_return_if_fail (LRG_IS_SECTOR_STREAMER (self));
+    g_return_if_fail (max_loads >= 1 && max_loads <= 64);
+
+    if (self->max_concurrent_loads != max_loads)
+    {
+        self->max_concurrent_loads = max_loads;
+        g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MAX_CONCURRENT_LOADS]);
+        streamer_pump (self);
+    }
+}
@@ -0,0 +1,285 @@
+/* lrg-sector-streamer.h
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Sector-based asynchronous level streaming.
+ */
+
+#pragma once
+
+#if !defined(LIBREGNUM_INSIDE) && !defined(LIBREGNUM_COMPILATION)
+#error "Only <libregnum.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <gio/gio.h>
+#include <graylib.h>
+#include "../lrg-version.h"
+#include "lrg-sector.h"
+#include "lrg-portal-system.h"
+
+G_BEGIN_DECLS
+
+#define LRG_TYPE_SECTOR_STREAMER (lrg_sector_streamer_get_type ())
+
+LRG_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (LrgSectorStreamer, lrg_sector_streamer, LRG, SECTOR_STREAMER, GObject)
+
+/**
+ * LrgSectorLoadFunc:
+ * @sector: (transfer none): A private copy of the sector being loaded
+ * @user_data: User data passed to lrg_sector_streamer_set_load_func()
+ * @cancellable: (nullable): Cancelled when the sector is no longer wanted
+ * @error: Return location for a #GError
+ *
+ * Loads the contents of a sector. Called on a worker thread, so it
+ * must not touch GPU resources or non thread-safe state; do that from
+ * the #LrgSectorStreamer::sector-loaded handler instead.
+ *
+ * Returns: (transfer full) (nullable): The sector contents, or %NULL
+ *   with @error set on failure
+ */
+typedef gpointer (*LrgSectorLoadFunc) (const LrgSector *sector,
+                                       gpointer         user_data,
+                                       GCancellable    *cancellable,
+                                       GError         **error);
+
+/**
+ * lrg_sector_streamer_new:
+ * @portal_system: (transfer none): Portal system providing sectors and adjacency
+ *
+ * Creates a new sector streamer.
+ *
+ * Returns: (transfer full): A new #LrgSectorStreamer
+ */
+LRG_AVAILABLE_IN_ALL
+LrgSectorStreamer * lrg_sector_streamer_new         (LrgPortalSystem        *portal_system);
+
+/**
+ * lrg_sector_streamer_get_portal_system:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the portal system used for visibility and adjacency.
+ *
+ * Returns: (transfer none): The portal system
+ */
+LRG_AVAILABLE_IN_ALL
+LrgPortalSystem *   lrg_sector_streamer_get_portal_system (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_set_load_func:
+ * @self: An #LrgSectorStreamer
+ * @func: (nullable) (scope notified): Function loading sector contents
+ * @user_data: (closure): User data for @func, must be thread-safe
+ * @user_data_destroy: (nullable): Destroy notify for @user_data
+ * @content_destroy: (nullable): Frees contents returned by @func
+ *
+ * Sets the function used to load sector contents in the background.
+ * Without a load function, sectors become resident immediately with
+ * %NULL contents, which is enough to drive gameplay from the signals.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_set_load_func (LrgSectorStreamer *self,
+                                                       LrgSectorLoadFunc  func,
+                                                       gpointer           user_data,
+                                                       GDestroyNotify     user_data_destroy,
+                                                       GDestroyNotify     content_destroy);
+
+/* --- Streaming --- */
+
+/**
+ * lrg_sector_streamer_update:
+ * @self: An #LrgSectorStreamer
+ * @camera_pos: (transfer none): Camera position
+ *
+ * Recomputes the wanted sector set and schedules loads and unloads.
+ * Call once per frame after lrg_portal_system_update().
+ *
+ * Visible sectors are always wanted. Sectors up to
+ * #LrgSectorStreamer:prefetch-depth portals away from a visible sector
+ * are prefetched, nearest first, while the residency budget allows.
+ * When over budget, unwanted sectors farthest from the camera are
+ * unloaded first.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_update      (LrgSectorStreamer      *self,
+                                                     const GrlVector3       *camera_pos);
+
+/**
+ * lrg_sector_streamer_unload_all:
+ * @self: An #LrgSectorStreamer
+ *
+ * Cancels pending loads and unloads every resident sector.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_unload_all  (LrgSectorStreamer      *self);
+
+/* --- State Queries --- */
+
+/**
+ * lrg_sector_streamer_is_sector_loaded:
+ * @self: An #LrgSectorStreamer
+ * @sector_id: Sector ID
+ *
+ * Checks if a sector is resident.
+ *
+ * Returns: %TRUE if the sector's contents are loaded
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_sector_streamer_is_sector_loaded (LrgSectorStreamer *self,
+                                                          const gchar       *sector_id);
+
+/**
+ * lrg_sector_streamer_is_sector_loading:
+ * @self: An #LrgSectorStreamer
+ * @sector_id: Sector ID
+ *
+ * Checks if a sector is being loaded in the background.
+ *
+ * Returns: %TRUE if a load is in flight
+ */
+LRG_AVAILABLE_IN_ALL
+gboolean            lrg_sector_streamer_is_sector_loading (LrgSectorStreamer *self,
+                                                           const gchar       *sector_id);
+
+/**
+ * lrg_sector_streamer_get_sector_content:
+ * @self: An #LrgSectorStreamer
+ * @sector_id: Sector ID
+ *
+ * Gets the contents returned by the load function for a resident sector.
+ *
+ * Returns: (transfer none) (nullable): The contents, or %NULL
+ */
+LRG_AVAILABLE_IN_ALL
+gpointer            lrg_sector_streamer_get_sector_content (LrgSectorStreamer *self,
+                                                            const gchar       *sector_id);
+
+/**
+ * lrg_sector_streamer_get_loaded_sectors:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the IDs of all resident sectors.
+ *
+ * Returns: (transfer container) (element-type utf8): Array of sector IDs
+ */
+LRG_AVAILABLE_IN_ALL
+GPtrArray *         lrg_sector_streamer_get_loaded_sectors (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_get_loaded_count:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the number of resident sectors.
+ *
+ * Returns: Resident sector count
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_sector_streamer_get_loaded_count (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_get_loading_count:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the number of loads in flight.
+ *
+ * Returns: Pending load count
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_sector_streamer_get_loading_count (LrgSectorStreamer *self);
+
+/* --- Configuration --- */
+
+/**
+ * lrg_sector_streamer_get_max_resident:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the residency budget.
+ *
+ * Returns: Maximum number of resident or loading sectors
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_sector_streamer_get_max_resident (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_set_max_resident:
+ * @self: An #LrgSectorStreamer
+ * @max_resident: Maximum number of resident or loading sectors
+ *
+ * Sets the residency budget. Visible sectors are kept even when they
+ * alone exceed the budget.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_set_max_resident (LrgSectorStreamer *self,
+                                                          guint              max_resident);
+
+/**
+ * lrg_sector_streamer_get_prefetch_depth:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets how many portals away from visible sectors are prefetched.
+ *
+ * Returns: Prefetch depth
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_sector_streamer_get_prefetch_depth (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_set_prefetch_depth:
+ * @self: An #LrgSectorStreamer
+ * @depth: Prefetch depth, 0 to load visible sectors only
+ *
+ * Sets how many portals away from visible sectors are prefetched.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_set_prefetch_depth (LrgSectorStreamer *self,
+                                                            guint              depth);
+
+/**
+ * lrg_sector_streamer_get_prefetch_distance:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the maximum camera distance for prefetched sectors.
+ *
+ * Returns: Prefetch distance, or 0 for unlimited
+ */
+LRG_AVAILABLE_IN_ALL
+gfloat              lrg_sector_streamer_get_prefetch_distance (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_set_prefetch_distance:
+ * @self: An #LrgSectorStreamer
+ * @distance: Maximum distance from the camera to a prefetched sector's
+ *   bounds, or 0 for unlimited
+ *
+ * Limits prefetching to sectors near the camera.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_set_prefetch_distance (LrgSectorStreamer *self,
+                                                               gfloat             distance);
+
+/**
+ * lrg_sector_streamer_get_max_concurrent_loads:
+ * @self: An #LrgSectorStreamer
+ *
+ * Gets the maximum number of loads in flight.
+ *
+ * Returns: Maximum concurrent loads
+ */
+LRG_AVAILABLE_IN_ALL
+guint               lrg_sector_streamer_get_max_concurrent_loads (LrgSectorStreamer *self);
+
+/**
+ * lrg_sector_streamer_set_max_concurrent_loads:
+ * @self: An #LrgSectorStreamer
+ * @max_loads: Maximum number of loads in flight
+ *
+ * Sets the maximum number of loads in flight.
+ */
+LRG_AVAILABLE_IN_ALL
+void                lrg_sector_streamer_set_max_concurrent_loads (LrgSectorStreamer *self,
+                                                                  guint              max_loads);
+
+G_END_DECLS
@@ -174,6 +174,177 @@ condition_check_counter (LrgBlackboard *blackboard,
     return (counter >= threshold);
 }
 
+/*
+ * Scripted nodes: the result depends only on the node id and the
+ * "tick" value, and every call is folded into "trace", so two trees
+ * behave the same exactly when their traces match.
+ */
+static guint tick_slot;
+static guint trace_slot;
+
+static void
+script_slots_init (void)
+{
+    tick_slot = lrg_blackboard_intern_key ("tick");
+    trace_slot = lrg_blackboard_intern_key ("trace");
+}
+
+static guint
+script_roll (LrgBlackboard *blackboard,
+             guint          id)
+{
+    guint tick;
+    guint trace;
+
+    tick = (guint)lrg_blackboard_get_int_slot (blackboard, tick_slot, 0);
+    trace = (guint)lrg_blackboard_get_int_slot (blackboard, trace_slot, 0);
+    lrg_blackboard_set_int_slot (blackboard, trace_slot, (gint)(trace * 31u + id));
+
+    return ((id * 2654435761u) ^ (tick * 40503u)) >> 7;
+}
+
+static LrgBTStatus
+action_scripted (LrgBlackboard *blackboard,
+                 gfloat         delta_time,
+                 gpointer       user_data)
+{
+    static const LrgBTStatus results[] = {
+        LRG_BT_STATUS_SUCCESS, LRG_BT_STATUS_FAILURE, LRG_BT_STATUS_RUNNING
+    };
+
+    (void)delta_time;
+
+    return results[script_roll (blackboard, GPOINTER_TO_UINT (user_data)) % 3];
+}
+
+static gboolean
+condition_scripted (LrgBlackboard *blackboard,
+                    gpointer       user_data)
+{
+    return script_roll (blackboard, GPOINTER_TO_UINT (user_data)) % 2 == 0;
+}
+
+/*
+ * Builds a random tree of every built-in node type.
+ */
+static LrgBTNode *
+create_random_tree (GRand *rand,
+                    guint  depth,
+                    guint *next_id)
+{
+    LrgBTNode *node = NULL;
+    LrgBTNode *child;
+    guint n_children;
+    guint i;
+
+    switch (depth == 0 ? g_rand_int_range (rand, 7, 10) : g_rand_int_range (rand, 0, 10))
+    {
+    case 0:
+    case 1:
+    case 2:
+        if (g_rand_int_range (rand, 0, 3) == 0)
+            node = LRG_BT_NODE (lrg_bt_parallel_new (g_rand_boolean (rand)
+                                                     ? LRG_BT_PARALLEL_REQUIRE_ONE
+                                                     : LRG_BT_PARALLEL_REQUIRE_ALL));
+        else if (g_rand_boolean (rand))
+            node = LRG_BT_NODE (lrg_bt_sequence_new ());
+        else
+            node = LRG_BT_NODE (lrg_bt_selector_new ());
+
+        n_children = g_rand_int_range (rand, 1, 5);
+        for (i = 0; i < n_children; i++)
+        {
+            child = create_random_tree (rand, depth - 1, next_id);
+            lrg_bt_composite_add_child (LRG_BT_COMPOSITE (node), child);
+            g_object_unref (child);
+        }
+        return node;
+
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+        child = create_random_tree (rand, depth - 1, next_id);
+        switch (g_rand_int_range (rand, 0, 4))
+        {
+        case 0:
+            node = LRG_BT_NODE (lrg_bt_inverter_new (child));
+            break;
+        case 1:
+            node = LRG_BT_NODE (lrg_bt_repeater_new (child, g_rand_int_range (rand, 0, 4)));
+            break;
+        case 2:
+            node = LRG_BT_NODE (lrg_bt_succeeder_new (child));
+            break;
+        default:
+            node = LRG_BT_NODE (lrg_bt_failer_new (child));
+            break;
+        }
+        g_object_unref (child);
+        return node;
+
+    case 7:
+        return LRG_BT_NODE (lrg_bt_action_new (action_scripted, GUINT_TO_POINTER ((*next_id)++), NULL));
+
+    case 8:
+        return LRG_BT_NODE (lrg_bt_condition_new (condition_scripted, GUINT_TO_POINTER ((*next_id)++), NULL));
+
+    default:
+        return LRG_BT_NODE (lrg_bt_wait_new ((gfloat)g_rand_double_range (rand, 0.05, 0.35)));
+    }
+}
+
+/*
+ * Agent tree for the batch tests:
+ * Selector
+ *   ├── Sequence
+ *   │     ├── Condition (scripted)
+ *   │     └── Action (scripted)
+ *   └── Sequence
+ *         ├── Wait (0.3 s)
+ *         └── Action (scripted)
+ */
+static LrgBTNode *
+create_agent_tree (void)
+{
+    LrgBTSelector *root;
+    LrgBTSequence *engage;
+    LrgBTSequence *wander;
+    g_autoptr(LrgBTCondition) has_target = NULL;
+    g_autoptr(LrgBTAction) attack = NULL;
+    g_autoptr(LrgBTWait) pause = NULL;
+    g_autoptr(LrgBTAction) walk = NULL;
+
+    root = lrg_bt_selector_new ();
+    engage = lrg_bt_sequence_new ();
+    wander = lrg_bt_sequence_new ();
+    has_target = lrg_bt_condition_new (condition_scripted, GUINT_TO_POINTER (1), NULL);
+    attack = lrg_bt_action_new (action_scripted, GUINT_TO_POINTER (2), NULL);
+    pause = lrg_bt_wait_new (0.3f);
+    walk = lrg_bt_action_new (action_scripted, GUINT_TO_POINTER (3), NULL);
+
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (engage), LRG_BT_NODE (has_target));
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (engage), LRG_BT_NODE (attack));
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (wander), LRG_BT_NODE (pause));
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (wander), LRG_BT_NODE (walk));
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (root), LRG_BT_NODE (engage));
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (root), LRG_BT_NODE (wander));
+    g_object_unref (engage);
+    g_object_unref (wander);
+
+    return LRG_BT_NODE (root);
+}
+
+static void
+count_signal (gpointer  instance,
+              gpointer  arg,
+              gpointer  user_data)
+{
+    (void)instance;
+    (void)arg;
+    (*(guint *)user_data)++;
+}
+
 /* ==========================================================================
  * Blackboard Tests
  * ========================================================================== */
@@ -364,6 +535,127 @@ test_blackboard_get_keys (BlackboardFixture *fixture,
     g_list_free (keys);
 }
 
+static void
+test_blackboard_slots (BlackboardFixture *fixture,
+                       gconstpointer      user_data)
+{
+    g_autoptr(GObject) object = NULL;
+    guint health;
+    guint name;
+
+    (void)user_data;
+
+    health = lrg_blackboard_intern_key ("slot-health");
+    name = lrg_blackboard_intern_key ("slot-name");
+    g_assert_cmpuint (health, !=, 0);
+    g_assert_cmpuint (health, !=, name);
+    g_assert_cmpuint (lrg_blackboard_intern_key ("slot-health"), ==, health);
+    g_assert_cmpstr (lrg_blackboard_get_key_name (health), ==, "slot-health");
+    g_assert_null (lrg_blackboard_get_key_name (0));
+
+    /* Slots and key names reach the same entries */
+    g_assert_false (lrg_blackboard_has_slot (fixture->blackboard, health));
+    lrg_blackboard_set_float_slot (fixture->blackboard, health, 75.0f);
+    g_assert_cmpfloat (lrg_blackboard_get_float (fixture->blackboard, "slot-health", 0.0f), ==, 75.0f);
+    lrg_blackboard_set_int (fixture->blackboard, "slot-health", 3);
+    g_assert_cmpint (lrg_blackboard_get_int_slot (fixture->blackboard, health, -1), ==, 3);
+    g_assert_cmpfloat (lrg_blackboard_get_float_slot (fixture->blackboard, health, -1.0f), ==, -1.0f);
+
+    lrg_blackboard_set_bool_slot (fixture->blackboard, health, TRUE);
+    g_assert_true (lrg_blackboard_get_bool (fixture->blackboard, "slot-health", FALSE));
+
+    /* Replacing a value with itself keeps it alive */
+    lrg_blackboard_set_string_slot (fixture->blackboard, name, "scout");
+    lrg_blackboard_set_string_slot (fixture->blackboard, name,
+                                    lrg_blackboard_get_string_slot (fixture->blackboard, name));
+    g_assert_cmpstr (lrg_blackboard_get_string (fixture->blackboard, "slot-name"), ==, "scout");
+
+    object = g_object_new (G_TYPE_OBJECT, NULL);
+    lrg_blackboard_set_object_slot (fixture->blackboard, name, object);
+    lrg_blackboard_set_object_slot (fixture->blackboard, name,
+                                    lrg_blackboard_get_object_slot (fixture->blackboard, name));
+    g_assert_true (lrg_blackboard_get_object (fixture->blackboard, "slot-name") == object);
+    g_assert_null (lrg_blackboard_get_string_slot (fixture->blackboard, name));
+
+    g_assert_true (lrg_blackboard_remove (fixture->blackboard, "slot-name"));
+    g_assert_false (lrg_blackboard_has_slot (fixture->blackboard, name));
+    g_assert_true (lrg_blackboard_has_slot (fixture->blackboard, health));
+
+    /* Unknown names are not registered by lookups */
+    g_assert_false (lrg_blackboard_has_key (fixture->blackboard, "slot-never-set"));
+    g_assert_cmpint (lrg_blackboard_get_int (fixture->blackboard, "slot-never-set", 7), ==, 7);
+}
+
+#define MANY_KEYS_THREADS 4
+#define MANY_KEYS_PER_THREAD 2000
+
+static gpointer
+intern_many_keys (gpointer data)
+{
+    guint thread = GPOINTER_TO_UINT (data);
+    guint i;
+
+    for (i = 0; i < MANY_KEYS_PER_THREAD; i++)
+    {
+        g_autofree gchar *key = g_strdup_printf ("many-%u-%u", thread, i);
+        g_autofree gchar *shared = g_strdup_printf ("many-shared-%u", i);
+        guint slot = lrg_blackboard_intern_key (key);
+
+        /* Threads racing on one name agree on its slot */
+        if (lrg_blackboard_intern_key (shared) != lrg_blackboard_intern_key (shared))
+            return GUINT_TO_POINTER (FALSE);
+
+        if (slot == 0 || g_strcmp0 (lrg_blackboard_get_key_name (slot), key) != 0)
+            return GUINT_TO_POINTER (FALSE);
+    }
+
+    return GUINT_TO_POINTER (TRUE);
+}
+
+static void
+test_blackboard_many_keys (BlackboardFixture *fixture,
+                           gconstpointer      user_data)
+{
+    GThread *threads[MANY_KEYS_THREADS];
+    g_autoptr(GList) keys = NULL;
+    guint slots[] = { 0, 0, 0 };
+    guint i;
+
+    (void)user_data;
+
+    for (i = 0; i < MANY_KEYS_THREADS; i++)
+        threads[i] = g_thread_new ("intern", intern_many_keys, GUINT_TO_POINTER (i));
+    for (i = 0; i < MANY_KEYS_THREADS; i++)
+        g_assert_true (GPOINTER_TO_UINT (g_thread_join (threads[i])));
+
+    for (i = 0; i < MANY_KEYS_PER_THREAD; i++)
+    {
+        g_autofree gchar *shared = g_strdup_printf ("many-shared-%u", i);
+        guint slot = lrg_blackboard_intern_key (shared);
+
+        g_assert_cmpstr (lrg_blackboard_get_key_name (slot), ==, shared);
+    }
+
+    /* A blackboard holds only the keys set on it, whatever their slots */
+    slots[0] = lrg_blackboard_intern_key ("many-3-1999");
+    slots[1] = lrg_blackboard_intern_key ("many-0-0");
+    slots[2] = lrg_blackboard_intern_key ("many-2-1000");
+
+    for (i = 0; i < G_N_ELEMENTS (slots); i++)
+        lrg_blackboard_set_int_slot (fixture->blackboard, slots[i], (gint)i);
+
+    for (i = 0; i < G_N_ELEMENTS (slots); i++)
+        g_assert_cmpint (lrg_blackboard_get_int_slot (fixture->blackboard, slots[i], -1), ==, (gint)i);
+
+    keys = lrg_blackboard_get_keys (fixture->blackboard);
+    g_assert_cmpuint (g_list_length (keys), ==, 3);
+
+    g_assert_true (lrg_blackboard_remove (fixture->blackboard, "many-0-0"));
+    g_assert_cmpint (lrg_blackboard_get_int (fixture->blackboard, "many-3-1999", -1), ==, 0);
+    g_assert_cmpint (lrg_blackboard_get_int (fixture->blackboard, "many-2-1000", -1), ==, 2);
+    g_assert_false (lrg_blackboard_has_key (fixture->blackboard, "many-0-0"));
+}
+
 /* ==========================================================================
  * BT Action Node Tests
  * ========================================================================== */
@@ -1031,6 +1323,288 @@ test_behavior_tree_complex (BehaviorTreeFixture *fixture,
     g_assert_cmpint (lrg_blackboard_get_int (bb, "counter", -1), ==, 5);
 }
 
+static void
+test_behavior_tree_compiled_matches (void)
+{
+    guint seed;
+
+    script_slots_init ();
+
+    for (seed = 1; seed <= 40; seed++)
+    {
+        g_autoptr(GRand) rand = g_rand_new_with_seed (seed);
+        g_autoptr(LrgBTNode) root = NULL;
+        g_autoptr(LrgBTProgram) program = NULL;
+        g_autoptr(LrgBehaviorTree) objects = NULL;
+        g_autoptr(LrgBehaviorTree) compiled = NULL;
+        LrgBlackboard *bb_objects;
+        LrgBlackboard *bb_compiled;
+        guint next_id = 1;
+        gint tick;
+
+        root = create_random_tree (rand, 4, &next_id);
+        program = lrg_bt_program_new (root);
+        objects = lrg_behavior_tree_new_with_root (root);
+        compiled = lrg_behavior_tree_new_from_program (program);
+        bb_objects = lrg_behavior_tree_get_blackboard (objects);
+        bb_compiled = lrg_behavior_tree_get_blackboard (compiled);
+
+        g_assert_true (lrg_bt_program_is_shareable (program));
+        g_assert_true (lrg_behavior_tree_get_root (compiled) == root);
+
+        for (tick = 0; tick < 200; tick++)
+        {
+            LrgBTStatus expected;
+            LrgBTStatus status;
+
+            lrg_blackboard_set_int_slot (bb_objects, tick_slot, tick);
+            lrg_blackboard_set_int_slot (bb_compiled, tick_slot, tick);
+
+            if (tick == 80)
+            {
+                lrg_behavior_tree_reset (objects);
+                lrg_behavior_tree_reset (compiled);
+            }
+            else if (tick == 140)
+            {
+                lrg_behavior_tree_abort (objects);
+                lrg_behavior_tree_abort (compiled);
+            }
+
+            expected = lrg_behavior_tree_tick (objects, 0.1f);
+            status = lrg_behavior_tree_tick (compiled, 0.1f);
+
+            g_assert_cmpint (status, ==, expected);
+            g_assert_cmpint (lrg_blackboard_get_int_slot (bb_compiled, trace_slot, 0), ==,
+                             lrg_blackboard_get_int_slot (bb_objects, trace_slot, 0));
+        }
+    }
+}
+
+static void
+test_behavior_tree_compile (BehaviorTreeFixture *fixture,
+                            gconstpointer        user_data)
+{
+    g_autoptr(LrgBTSequence) root = NULL;
+    g_autoptr(LrgBTWait) wait = NULL;
+    g_autoptr(LrgBTAction) action = NULL;
+    g_autoptr(LrgBTAction) other = NULL;
+    LrgBTProgram *program;
+
+    (void)user_data;
+
+    g_action_call_count = 0;
+    root = lrg_bt_sequence_new ();
+    wait = lrg_bt_wait_new (0.25f);
+    action = lrg_bt_action_new_simple (action_success);
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (root), LRG_BT_NODE (wait));
+    lrg_bt_composite_add_child (LRG_BT_COMPOSITE (root), LRG_BT_NODE (action));
+
+    lrg_behavior_tree_set_root (fixture->tree, LRG_BT_NODE (root));
+    lrg_behavior_tree_compile (fixture->tree);
+
+    program = lrg_behavior_tree_get_program (fixture->tree);
+    g_assert_nonnull (program);
+    g_assert_cmpuint (lrg_bt_program_get_node_count (program), ==, 3);
+
+    g_assert_cmpint (lrg_behavior_tree_tick (fixture->tree, 0.1f), ==, LRG_BT_STATUS_RUNNING);
+    g_assert_cmpint (lrg_behavior_tree_tick (fixture->tree, 0.1f), ==, LRG_BT_STATUS_RUNNING);
+    g_assert_cmpint (lrg_behavior_tree_tick (fixture->tree, 0.1f), ==, LRG_BT_STATUS_SUCCESS);
+    g_assert_cmpint (g_action_call_count, ==, 1);
+
+    /* The node objects were not ticked */
+    g_assert_cmpint (lrg_bt_node_get_status (LRG_BT_NODE (wait)), ==, LRG_BT_STATUS_INVALID);
+
+    /* Setting another root drops the program */
+    other = lrg_bt_action_new_simple (action_failure);
+    lrg_behavior_tree_set_root (fixture->tree, LRG_BT_NODE (other));
+    g_assert_null (lrg_behavior_tree_get_program (fixture->tree));
+    g_assert_cmpint (lrg_behavior_tree_tick (fixture->tree, 0.1f), ==, LRG_BT_STATUS_FAILURE);
+}
+
+static void
+test_behavior_tree_shared_program (void)
+{
+    g_autoptr(LrgBTWait) wait = NULL;
+    g_autoptr(LrgBTProgram) program = NULL;
+    g_autoptr(LrgBehaviorTree) first = NULL;
+    g_autoptr(LrgBehaviorTree) second = NULL;
+
+    wait = lrg_bt_wait_new (0.5f);
+    program = lrg_bt_program_new (LRG_BT_NODE (wait));
+    first = lrg_behavior_tree_new_from_program (program);
+    second = lrg_behavior_tree_new_from_program (program);
+
+    g_assert_true (lrg_behavior_tree_get_blackboard (first) !=
+                   lrg_behavior_tree_get_blackboard (second));
+
+    /* Each tree keeps its own elapsed time */
+    g_assert_cmpint (lrg_behavior_tree_tick (first, 0.3f), ==, LRG_BT_STATUS_RUNNING);
+    g_assert_cmpint (lrg_behavior_tree_tick (first, 0.3f), ==, LRG_BT_STATUS_SUCCESS);
+    g_assert_cmpint (lrg_behavior_tree_tick (second, 0.3f), ==, LRG_BT_STATUS_RUNNING);
+    g_assert_cmpint (lrg_behavior_tree_tick (second, 0.1f), ==, LRG_BT_STATUS_RUNNING);
+    g_assert_cmpint (lrg_behavior_tree_tick (second, 0.1f), ==, LRG_BT_STATUS_SUCCESS);
+}
+
+static void
+test_behavior_tree_status_notify (BehaviorTreeFixture *fixture,
+                                  gconstpointer        user_data)
+{
+    g_autoptr(LrgBTAction) action = NULL;
+    guint notifies = 0;
+    guint completed = 0;
+    guint i;
+
+    (void)user_data;
+
+    action = lrg_bt_action_new_simple (action_running);
+    lrg_behavior_tree_set_root (fixture->tree, LRG_BT_NODE (action));
+    g_signal_connect (fixture->tree, "notify::status", G_CALLBACK (count_signal), &notifies);
+    g_signal_connect (fixture->tree, "completed", G_CALLBACK (count_signal), &completed);
+
+    for (i = 0; i < 5; i++)
+        lrg_behavior_tree_tick (fixture->tree, 0.016f);
+    g_assert_cmpuint (notifies, ==, 1);
+
+    lrg_behavior_tree_reset (fixture->tree);
+    lrg_behavior_tree_reset (fixture->tree);
+    g_assert_cmpuint (notifies, ==, 2);
+    g_assert_cmpuint (completed, ==, 0);
+}
+
+static void
+test_behavior_tree_tick_batch (void)
+{
+    g_autoptr(LrgBTNode) root = NULL;
+    g_autoptr(LrgBTProgram) program = NULL;
+    g_autoptr(GPtrArray) batched = NULL;
+    g_autoptr(GPtrArray) single = NULL;
+    guint completed = 0;
+    guint expected_completed = 0;
+    guint n_trees = 300;
+    gint tick;
+    guint i;
+
+    script_slots_init ();
+
+    root = create_agent_tree ();
+    program = lrg_bt_program_new (root);
+    batched = g_ptr_array_new_with_free_func (g_object_unref);
+    single = g_ptr_array_new_with_free_func (g_object_unref);
+
+    for (i = 0; i < n_trees; i++)
+    {
+        LrgBehaviorTree *tree = lrg_behavior_tree_new_from_program (program);
+        LrgBehaviorTree *reference = lrg_behavior_tree_new_from_program (program);
+
+        /* Give every agent a different script */
+        lrg_blackboard_set_int_slot (lrg_behavior_tree_get_blackboard (tree), trace_slot, (gint)i);
+        lrg_blackboard_set_int_slot (lrg_behavior_tree_get_blackboard (reference), trace_slot, (gint)i);
+        g_signal_connect (tree, "completed", G_CALLBACK (count_signal), &completed);
+        g_signal_connect (reference, "completed", G_CALLBACK (count_signal), &expected_completed);
+
+        g_ptr_array_add (batched, tree);
+        g_ptr_array_add (single, reference);
+    }
+
+    for (tick = 0; tick < 30; tick++)
+    {
+        for (i = 0; i < n_trees; i++)
+        {
+            lrg_blackboard_set_int_slot (lrg_behavior_tree_get_blackboard (g_ptr_array_index (batched, i)),
+                                         tick_slot, tick);
+            lrg_blackboard_set_int_slot (lrg_behavior_tree_get_blackboard (g_ptr_array_index (single, i)),
+                                         tick_slot, tick);
+            lrg_behavior_tree_tick (g_ptr_array_index (single, i), 0.1f);
+        }
+
+        lrg_behavior_tree_tick_batch ((LrgBehaviorTree * const *)batched->pdata, n_trees, 0.1f, 4);
+
+        for (i = 0; i < n_trees; i++)
+        {
+            LrgBehaviorTree *tree = g_ptr_array_index (batched, i);
+            LrgBehaviorTree *reference = g_ptr_array_index (single, i);
+
+            g_assert_cmpint (lrg_behavior_tree_get_status (tree), ==,
+                             lrg_behavior_tree_get_status (reference));
+            g_assert_cmpint (lrg_blackboard_get_int_slot (lrg_behavior_tree_get_blackboard (tree), trace_slot, 0), ==,
+                             lrg_blackboard_get_int_slot (lrg_behavior_tree_get_blackboard (reference), trace_slot, 0));
+        }
+    }
+
+    g_assert_cmpuint (completed, ==, expected_completed);
+    g_assert_cmpuint (completed, >, 0);
+}
+
+static void
+test_behavior_tree_perf (void)
+{
+    g_autoptr(GPtrArray) objects = NULL;
+    g_autoptr(GPtrArray) compiled = NULL;
+    g_autoptr(LrgBTNode) root = NULL;
+    g_autoptr(LrgBTProgram) program = NULL;
+    g_autoptr(GTimer) timer = NULL;
+    const guint n_agents = 2000;
+    const gint n_ticks = 50;
+    gdouble object_ms;
+    gdouble compiled_ms;
+    gint tick;
+    guint i;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    script_slots_init ();
+
+    /* Object trees keep their state in the nodes, so each needs its own */
+    objects = g_ptr_array_new_with_free_func (g_object_unref);
+    compiled = g_ptr_array_new_with_free_func (g_object_unref);
+    root = create_agent_tree ();
+    program = lrg_bt_program_new (root);
+
+    for (i = 0; i < n_agents; i++)
+    {
+        g_autoptr(LrgBTNode) agent_root = create_agent_tree ();
+
+        g_ptr_array_add (objects, lrg_behavior_tree_new_with_root (agent_root));
+        g_ptr_array_add (compiled, lrg_behavior_tree_new_from_program (program));
+    }
+
+    timer = g_timer_new ();
+    for (tick = 0; tick < n_ticks; tick++)
+    {
+        for (i = 0; i < n_agents; i++)
+        {
+            LrgBehaviorTree *tree = g_ptr_array_index (objects, i);
+
+            lrg_blackboard_set_int (lrg_behavior_tree_get_blackboard (tree), "tick", tick);
+            lrg_behavior_tree_tick (tree, 0.1f);
+        }
+    }
+    object_ms = g_timer_elapsed (timer, NULL) * 1000.0 / n_ticks;
+
+    g_timer_start (timer);
+    for (tick = 0; tick < n_ticks; tick++)
+    {
+        for (i = 0; i < n_agents; i++)
+        {
+            LrgBehaviorTree *tree = g_ptr_array_index (compiled, i);
+
+            lrg_blackboard_set_int_slot (lrg_behavior_tree_get_blackboard (tree), tick_slot, tick);
+        }
+
+        lrg_behavior_tree_tick_batch ((LrgBehaviorTree * const *)compiled->pdata, n_agents, 0.1f, 0);
+    }
+    compiled_ms = g_timer_elapsed (timer, NULL) * 1000.0 / n_ticks;
+
+    g_test_minimized_result (compiled_ms,
+                             "%u agents: %.3f ms per tick with node objects, %.3f ms compiled and batched",
+                             n_agents, object_ms, compiled_ms);
+}
+
 /* ==========================================================================
  * BT Node Properties Tests
  * ========================================================================== */
@@ -1161,6 +1735,12 @@ main (int   argc,
     g_test_add ("/ai/blackboard/get-keys", BlackboardFixture, NULL,
                 blackboard_fixture_set_up, test_blackboard_get_keys,
                 blackboard_fixture_tear_down);
+    g_test_add ("/ai/blackboard/slots", BlackboardFixture, NULL,
+                blackboard_fixture_set_up, test_blackboard_slots,
+                blackboard_fixture_tear_down);
+    g_test_add ("/ai/blackboard/many-keys", BlackboardFixture, NULL,
+                blackboard_fixture_set_up, test_blackboard_many_keys,
+                blackboard_fixture_tear_down);
 
     /* BT Action tests */
     g_test_add ("/ai/bt/action/success", BTNodeFixture, NULL,
@@ -1261,6 +1841,16 @@ main (int   argc,
     g_test_add ("/ai/behavior-tree/complex", BehaviorTreeFixture, NULL,
                 behavior_tree_fixture_set_up, test_behavior_tree_complex,
                 behavior_tree_fixture_tear_down);
+    g_test_add ("/ai/behavior-tree/compile", BehaviorTreeFixture, NULL,
+                behavior_tree_fixture_set_up, test_behavior_tree_compile,
+                behavior_tree_fixture_tear_down);
+    g_test_add ("/ai/behavior-tree/status-notify", BehaviorTreeFixture, NULL,
+                behavior_tree_fixture_set_up, test_behavior_tree_status_notify,
+                behavior_tree_fixture_tear_down);
+    g_test_add_func ("/ai/behavior-tree/compiled-matches", test_behavior_tree_compiled_matches);
+    g_test_add_func ("/ai/behavior-tree/shared-program", test_behavior_tree_shared_program);
+    g_test_add_func ("/ai/behavior-tree/tick-batch", test_behavior_tree_tick_batch);
+    g_test_add_func ("/ai/behavior-tree/perf", test_behavior_tree_perf);
 
     /* BT Node property tests */
     g_test_add ("/ai/bt/node/name", BTNodeFixture, NULL,
@@ -12,6 +12,7 @@
 #include <glib.h>
 #include <glib-object.h>
 #include <math.h>
+#include <string.h>
 #include "../src/libregnum.h"
 
 /*
@@ -428,6 +429,397 @@ test_clip_add_track (void)
     g_assert_cmpstr (lrg_animation_clip_get_track_bone_name (clip, 0), ==, "bone1");
 }
 
+static void
+test_clip_keyframes_sorted (void)
+{
+    g_autoptr(LrgAnimationClip) clip = lrg_animation_clip_new ("test");
+    const gfloat times[] = { 0.5f, 0.0f, 1.0f, 0.25f, 0.5f };
+    LrgAnimationKeyframe *keyframe;
+    guint i;
+
+    lrg_animation_clip_add_track (clip, "bone1");
+
+    for (i = 0; i < G_N_ELEMENTS (times); i++)
+    {
+        keyframe = lrg_animation_keyframe_new (times[i]);
+        keyframe->pose.position_x = (gfloat)i;
+        lrg_animation_clip_add_keyframe (clip, 0, keyframe);
+        lrg_animation_keyframe_free (keyframe);
+    }
+
+    g_assert_cmpuint (lrg_animation_clip_get_keyframe_count (clip, 0), ==, 5);
+
+    for (i = 1; i < 5; i++)
+    {
+        g_assert_cmpfloat (lrg_animation_clip_get_keyframe (clip, 0, i - 1)->time, <=,
+                           lrg_animation_clip_get_keyframe (clip, 0, i)->time);
+    }
+
+    /* Equal times keep insertion order */
+    g_assert_cmpfloat (lrg_animation_clip_get_keyframe (clip, 0, 2)->pose.position_x, ==, 0.0f);
+    g_assert_cmpfloat (lrg_animation_clip_get_keyframe (clip, 0, 3)->pose.position_x, ==, 4.0f);
+}
+
+/*
+ * A clip of smooth motion keyed at @rate Hz: every track sways,
+ * turns about Z and pulses in scale at its own frequency. @offset
+ * shifts the X position and Y scale so clips can be told apart.
+ */
+static LrgAnimationClip *
+create_smooth_clip_with_offset (guint  n_tracks,
+                                gfloat duration,
+                                gfloat rate,
+                                gfloat offset)
+{
+    LrgAnimationClip *clip;
+    guint n_keys;
+    guint track;
+    guint k;
+
+    clip = lrg_animation_clip_new ("smooth");
+    lrg_animation_clip_set_duration (clip, duration);
+    n_keys = (guint)(duration * rate) + 1;
+
+    for (track = 0; track < n_tracks; track++)
+    {
+        g_autofree gchar *bone_name = g_strdup_printf ("bone%u", track);
+        gfloat freq = 0.5f + 0.25f * (gfloat)(track % 8);
+
+        lrg_animation_clip_add_track (clip, bone_name);
+
+        for (k = 0; k < n_keys; k++)
+        {
+            gfloat t = MIN ((gfloat)k / rate, duration);
+            gfloat angle = 0.8f * sinf (2.0f * G_PI * freq * t);
+            LrgAnimationKeyframe *keyframe = lrg_animation_keyframe_new (t);
+
+            keyframe->pose.position_x = 0.5f * sinf (2.0f * G_PI * freq * t) + offset;
+            keyframe->pose.position_y = 0.25f * cosf (2.0f * G_PI * freq * t);
+            keyframe->pose.position_z = (gfloat)track;
+            keyframe->pose.rotation_x = 0.0f;
+            keyframe->pose.rotation_y = 0.0f;
+            keyframe->pose.rotation_z = sinf (angle * 0.5f);
+            keyframe->pose.rotation_w = cosf (angle * 0.5f);
+            keyframe->pose.scale_x = 1.0f + 0.1f * sinf (2.0f * G_PI * freq * t);
+            keyframe->pose.scale_y = 1.0f + offset * 0.1f;
+            keyframe->pose.scale_z = 1.0f;
+
+            lrg_animation_clip_add_keyframe (clip, track, keyframe);
+            lrg_animation_keyframe_free (keyframe);
+        }
+    }
+
+    lrg_animation_clip_calculate_smooth_tangents (clip);
+
+    return clip;
+}
+
+static LrgAnimationClip *
+create_smooth_clip (guint  n_tracks,
+                    gfloat duration,
+                    gfloat rate)
+{
+    return create_smooth_clip_with_offset (n_tracks, duration, rate, 0.0f);
+}
+
+static gfloat
+pose_max_error (const LrgBonePose *a,
+                const LrgBonePose *b)
+{
+    gfloat sign;
+    gfloat error;
+
+    /* q and -q are the same rotation */
+    sign = (a->rotation_x * b->rotation_x + a->rotation_y * b->rotation_y +
+            a->rotation_z * b->rotation_z + a->rotation_w * b->rotation_w) < 0.0f ? -1.0f : 1.0f;
+
+    error = fabsf (a->position_x - b->position_x);
+    error = MAX (error, fabsf (a->position_y - b->position_y));
+    error = MAX (error, fabsf (a->position_z - b->position_z));
+    error = MAX (error, fabsf (a->rotation_x - b->rotation_x * sign));
+    error = MAX (error, fabsf (a->rotation_y - b->rotation_y * sign));
+    error = MAX (error, fabsf (a->rotation_z - b->rotation_z * sign));
+    error = MAX (error, fabsf (a->rotation_w - b->rotation_w * sign));
+    error = MAX (error, fabsf (a->scale_x - b->scale_x));
+    error = MAX (error, fabsf (a->scale_y - b->scale_y));
+    error = MAX (error, fabsf (a->scale_z - b->scale_z));
+
+    return error;
+}
+
+static void
+test_clip_cursor (void)
+{
+    const LrgAnimationLoopMode modes[] = {
+        LRG_ANIMATION_LOOP_NONE,
+        LRG_ANIMATION_LOOP_REPEAT,
+        LRG_ANIMATION_LOOP_PINGPONG
+    };
+    g_autoptr(LrgAnimationClip) clip = create_smooth_clip (3, 2.0f, 30.0f);
+    g_autoptr(GRand) rand = g_rand_new_with_seed (45);
+    guint m;
+
+    for (m = 0; m < G_N_ELEMENTS (modes); m++)
+    {
+        g_autoptr(LrgAnimationClipCursor) cursor = NULL;
+        gfloat time;
+        guint step;
+        guint track;
+
+        lrg_animation_clip_set_loop_mode (clip, modes[m]);
+        cursor = lrg_animation_clip_cursor_new (clip);
+        g_assert_true (lrg_animation_clip_cursor_get_clip (cursor) == clip);
+
+        /* Forward past the end, back to the start, then random seeks */
+        for (step = 0; step < 600; step++)
+        {
+            if (step < 300)
+                time = (gfloat)step / 60.0f;
+            else if (step < 400)
+                time = (gfloat)(600 - step) / 60.0f;
+            else
+                time = (gfloat)g_rand_double_range (rand, -1.0, 6.0);
+
+            for (track = 0; track < 3; track++)
+            {
+                LrgBonePose expected;
+                LrgBonePose actual;
+
+                lrg_animation_clip_sample_track (clip, track, time, &expected);
+                lrg_animation_clip_cursor_sample_track (cursor, track, time, &actual);
+                g_assert_cmpfloat (pose_max_error (&expected, &actual), ==, 0.0f);
+            }
+        }
+    }
+}
+
+static void
+test_compressed_clip_error (void)
+{
+    g_autoptr(LrgAnimationClip) source = create_smooth_clip (4, 3.0f, 30.0f);
+    g_autoptr(LrgCompressedClip) compressed = NULL;
+    g_autoptr(LrgAnimationClipCursor) cursor = NULL;
+    LrgAnimationClip *clip;
+    gfloat tolerance = 0.005f;
+    gfloat grid_error = 0.0f;
+    gfloat max_error = 0.0f;
+    guint source_keys = 0;
+    guint track;
+    guint i;
+
+    lrg_animation_clip_set_loop_mode (source, LRG_ANIMATION_LOOP_REPEAT);
+    compressed = lrg_compressed_clip_new (source, tolerance);
+    clip = LRG_ANIMATION_CLIP (compressed);
+
+    g_assert_cmpstr (lrg_animation_clip_get_name (clip), ==, "smooth");
+    g_assert_cmpfloat (lrg_animation_clip_get_duration (clip), ==, 3.0f);
+    g_assert_cmpint (lrg_animation_clip_get_loop_mode (clip), ==, LRG_ANIMATION_LOOP_REPEAT);
+    g_assert_cmpuint (lrg_animation_clip_get_track_count (clip), ==, 4);
+    g_assert_cmpstr (lrg_animation_clip_get_track_bone_name (clip, 3), ==, "bone3");
+    g_assert_cmpfloat (lrg_compressed_clip_get_tolerance (compressed), ==, tolerance);
+
+    for (track = 0; track < 4; track++)
+        source_keys += lrg_animation_clip_get_keyframe_count (source, track);
+
+    g_assert_cmpuint (lrg_compressed_clip_get_key_count (compressed), <, source_keys * 3);
+    g_assert_cmpuint (lrg_compressed_clip_get_data_size (compressed), <,
+                      source_keys * sizeof (LrgAnimationKeyframe) / 4);
+
+    cursor = lrg_animation_clip_cursor_new (clip);
+
+    /* Two loops at 240 Hz; every fourth sample lands on the resampling grid */
+    for (i = 0; i <= 1440; i++)
+    {
+        gfloat time = (gfloat)i / 240.0f;
+
+        for (track = 0; track < 4; track++)
+        {
+            LrgBonePose expected;
+            LrgBonePose actual;
+            LrgBonePose plain;
+            gfloat error;
+
+            lrg_animation_clip_sample_track (source, track, time, &expected);
+            lrg_animation_clip_cursor_sample_track (cursor, track, time, &actual);
+            lrg_animation_clip_sample_track (clip, track, time, &plain);
+
+            g_assert_cmpfloat (pose_max_error (&plain, &actual), ==, 0.0f);
+
+            error = pose_max_error (&expected, &actual);
+            max_error = MAX (max_error, error);
+            if (i % 4 == 0)
+                grid_error = MAX (grid_error, error);
+        }
+    }
+
+    /* Exact on the grid up to rounding; between grid points the source curves away */
+    g_assert_cmpfloat (grid_error, <=, tolerance + 0.0002f);
+    g_assert_cmpfloat (max_error, <=, tolerance * 2.0f);
+}
+
+static void
+test_compressed_clip_constant (void)
+{
+    g_autoptr(LrgAnimationClip) source = lrg_animation_clip_new ("idle");
+    g_autoptr(LrgCompressedClip) compressed = NULL;
+    LrgBonePose pose;
+    guint k;
+
+    lrg_animation_clip_set_duration (source, 1.0f);
+    lrg_animation_clip_add_track (source, "still");
+    lrg_animation_clip_add_track (source, "empty");
+
+    for (k = 0; k <= 30; k++)
+    {
+        LrgAnimationKeyframe *keyframe = lrg_animation_keyframe_new ((gfloat)k / 30.0f);
+
+        lrg_bone_pose_set_position (&keyframe->pose, 1.0f, 2.0f, 3.0f);
+        lrg_bone_pose_set_rotation_euler (&keyframe->pose, 0.0f, 0.5f, 0.0f);
+        lrg_animation_clip_add_keyframe (source, 0, keyframe);
+        lrg_animation_keyframe_free (keyframe);
+    }
+
+    compressed = lrg_compressed_clip_new (source, 0.001f);
+
+    /* One key per channel of the still track, none for the empty one */
+    g_assert_cmpuint (lrg_compressed_clip_get_key_count (compressed), ==, 3);
+
+    lrg_animation_clip_sample_track (LRG_ANIMATION_CLIP (compressed), 0, 0.37f, &pose);
+    g_assert_cmpfloat_with_epsilon (pose.position_y, 2.0f, 0.0001f);
+    g_assert_cmpfloat_with_epsilon (pose.scale_x, 1.0f, 0.0001f);
+
+    lrg_animation_clip_sample_track (LRG_ANIMATION_CLIP (compressed), 1, 0.37f, &pose);
+    g_assert_cmpfloat (pose.position_x, ==, 0.0f);
+    g_assert_cmpfloat (pose.rotation_w, ==, 1.0f);
+}
+
+static void
+assert_identity_pose (const LrgBonePose *pose)
+{
+    g_assert_cmpfloat (pose->position_x, ==, 0.0f);
+    g_assert_cmpfloat (pose->position_y, ==, 0.0f);
+    g_assert_cmpfloat (pose->position_z, ==, 0.0f);
+    g_assert_cmpfloat (pose->rotation_x, ==, 0.0f);
+    g_assert_cmpfloat (pose->rotation_w, ==, 1.0f);
+    g_assert_cmpfloat (pose->scale_x, ==, 1.0f);
+}
+
+static void
+test_clip_sample_out_of_range (void)
+{
+    g_autoptr(LrgAnimationClip) clip = lrg_animation_clip_new ("walk");
+    g_autoptr(LrgCompressedClip) compressed = NULL;
+    g_autoptr(LrgAnimationClipCursor) cursor = NULL;
+    g_autoptr(LrgAnimationClipCursor) compressed_cursor = NULL;
+    LrgAnimationKeyframe *keyframe;
+    LrgBonePose pose;
+
+    lrg_animation_clip_set_duration (clip, 1.0f);
+    lrg_animation_clip_add_track (clip, "hip");
+    keyframe = lrg_animation_keyframe_new (0.0f);
+    lrg_bone_pose_set_position (&keyframe->pose, 1.0f, 2.0f, 3.0f);
+    lrg_animation_clip_add_keyframe (clip, 0, keyframe);
+    lrg_animation_keyframe_free (keyframe);
+
+    compressed = lrg_compressed_clip_new (clip, 0.001f);
+    cursor = lrg_animation_clip_cursor_new (clip);
+    compressed_cursor = lrg_animation_clip_cursor_new (LRG_ANIMATION_CLIP (compressed));
+
+    /* A track past the end samples as the identity pose */
+    memset (&pose, 0xff, sizeof (pose));
+    lrg_animation_clip_sample_track (clip, 3, 0.5f, &pose);
+    assert_identity_pose (&pose);
+
+    memset (&pose, 0xff, sizeof (pose));
+    lrg_animation_clip_cursor_sample_track (cursor, 3, 0.5f, &pose);
+    assert_identity_pose (&pose);
+
+    memset (&pose, 0xff, sizeof (pose));
+    lrg_animation_clip_sample_track (LRG_ANIMATION_CLIP (compressed), 3, 0.5f, &pose);
+    assert_identity_pose (&pose);
+
+    memset (&pose, 0xff, sizeof (pose));
+    lrg_animation_clip_cursor_sample_track (compressed_cursor, 3, 0.5f, &pose);
+    assert_identity_pose (&pose);
+}
+
+/*
+ * Best of five passes over @frames frames at 10 frames a second of
+ * clip time, in milliseconds per frame. Samples through @cursor if
+ * given.
+ */
+static gdouble
+time_clip_sampling (LrgAnimationClip       *clip,
+                    LrgAnimationClipCursor *cursor,
+                    guint                   frames)
+{
+    g_autoptr(GTimer) timer = g_timer_new ();
+    LrgBonePose pose;
+    gdouble best = G_MAXDOUBLE;
+    guint n_tracks;
+    guint pass;
+    guint f;
+    guint track;
+
+    n_tracks = lrg_animation_clip_get_track_count (clip);
+
+    for (pass = 0; pass < 5; pass++)
+    {
+        if (cursor != NULL)
+            lrg_animation_clip_cursor_reset (cursor);
+
+        g_timer_start (timer);
+        for (f = 0; f < frames; f++)
+        {
+            for (track = 0; track < n_tracks; track++)
+            {
+                if (cursor != NULL)
+                    lrg_animation_clip_cursor_sample_track (cursor, track, (gfloat)f / 10.0f, &pose);
+                else
+                    lrg_animation_clip_sample_track (clip, track, (gfloat)f / 10.0f, &pose);
+            }
+        }
+        best = MIN (best, g_timer_elapsed (timer, NULL) * 1000.0 / frames);
+    }
+
+    return best;
+}
+
+static void
+test_clip_cursor_perf (void)
+{
+    g_autoptr(LrgAnimationClip) clip = NULL;
+    g_autoptr(LrgCompressedClip) compressed = NULL;
+    g_autoptr(LrgAnimationClipCursor) cursor = NULL;
+    g_autoptr(LrgAnimationClipCursor) compressed_cursor = NULL;
+    gdouble plain_ms;
+    gdouble cursor_ms;
+    gdouble compressed_ms;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    /* 64 bones keyed at 30 Hz for a minute */
+    clip = create_smooth_clip (64, 60.0f, 30.0f);
+    compressed = lrg_compressed_clip_new (clip, 0.01f);
+    cursor = lrg_animation_clip_cursor_new (clip);
+    compressed_cursor = lrg_animation_clip_cursor_new (LRG_ANIMATION_CLIP (compressed));
+
+    plain_ms = time_clip_sampling (clip, NULL, 600);
+    cursor_ms = time_clip_sampling (clip, cursor, 600);
+    compressed_ms = time_clip_sampling (LRG_ANIMATION_CLIP (compressed), compressed_cursor, 600);
+
+    g_test_minimized_result (cursor_ms,
+                             "64 tracks x 1801 keys: %.4f ms/frame searched, %.4f with cursor, "
+                             "%.4f compressed (%" G_GSIZE_FORMAT " bytes, was %" G_GSIZE_FORMAT ")",
+                             plain_ms, cursor_ms, compressed_ms,
+                             lrg_compressed_clip_get_data_size (compressed),
+                             (gsize)64 * 1801 * sizeof (LrgAnimationKeyframe));
+}
+
 /*
  * ============================================================================
  * LrgAnimator Tests
@@ -595,6 +987,448 @@ test_state_machine_force_state (StateMachineFixture *fixture,
     g_assert_cmpstr (current, ==, "walk");
 }
 
+/*
+ * ============================================================================
+ * LrgPoseBuffer Tests
+ * ============================================================================
+ */
+
+static void
+random_pose (GRand       *rand,
+             LrgBonePose *pose)
+{
+    lrg_bone_pose_set_position (pose,
+                                (gfloat)g_rand_double_range (rand, -1.0, 1.0),
+                                (gfloat)g_rand_double_range (rand, -1.0, 1.0),
+                                (gfloat)g_rand_double_range (rand, -1.0, 1.0));
+    lrg_bone_pose_set_rotation_euler (pose,
+                                      (gfloat)g_rand_double_range (rand, -1.0, 1.0),
+                                      (gfloat)g_rand_double_range (rand, -1.0, 1.0),
+                                      (gfloat)g_rand_double_range (rand, -1.0, 1.0));
+    lrg_bone_pose_set_scale (pose,
+                             (gfloat)g_rand_double_range (rand, 0.5, 1.5),
+                             (gfloat)g_rand_double_range (rand, 0.5, 1.5),
+                             (gfloat)g_rand_double_range (rand, 0.5, 1.5));
+}
+
+static void
+test_pose_buffer_lerp (void)
+{
+    g_autoptr(GRand) rand = g_rand_new_with_seed (46);
+    g_autoptr(LrgPoseBuffer) a = lrg_pose_buffer_new (7);
+    g_autoptr(LrgPoseBuffer) b = lrg_pose_buffer_new (7);
+    g_autoptr(LrgPoseBuffer) out = lrg_pose_buffer_new (7);
+    guint i;
+
+    for (i = 0; i < 7; i++)
+    {
+        LrgBonePose pose;
+
+        random_pose (rand, &pose);
+        lrg_pose_buffer_set_pose (a, i, &pose);
+        random_pose (rand, &pose);
+
+        /* Odd bones point the other way, as -q */
+        if (i % 2 == 1)
+        {
+            pose.rotation_x = -pose.rotation_x;
+            pose.rotation_y = -pose.rotation_y;
+            pose.rotation_z = -pose.rotation_z;
+            pose.rotation_w = -pose.rotation_w;
+        }
+        lrg_pose_buffer_set_pose (b, i, &pose);
+    }
+
+    lrg_pose_buffer_lerp (a, b, 0.3f, out);
+
+    for (i = 0; i < 7; i++)
+    {
+        LrgBonePose pa;
+        LrgBonePose pb;
+        LrgBonePose expected;
+        LrgBonePose actual;
+        gfloat sign;
+
+        lrg_pose_buffer_get_pose (a, i, &pa);
+        lrg_pose_buffer_get_pose (b, i, &pb);
+        lrg_pose_buffer_get_pose (out, i, &actual);
+
+        sign = (pa.rotation_x * pb.rotation_x + pa.rotation_y * pb.rotation_y +
+                pa.rotation_z * pb.rotation_z + pa.rotation_w * pb.rotation_w) < 0.0f ? -1.0f : 1.0f;
+
+        expected.position_x = pa.position_x + (pb.position_x - pa.position_x) * 0.3f;
+        expected.position_y = pa.position_y + (pb.position_y - pa.position_y) * 0.3f;
+        expected.position_z = pa.position_z + (pb.position_z - pa.position_z) * 0.3f;
+        expected.rotation_x = pa.rotation_x + (pb.rotation_x * sign - pa.rotation_x) * 0.3f;
+        expected.rotation_y = pa.rotation_y + (pb.rotation_y * sign - pa.rotation_y) * 0.3f;
+        expected.rotation_z = pa.rotation_z + (pb.rotation_z * sign - pa.rotation_z) * 0.3f;
+        expected.rotation_w = pa.rotation_w + (pb.rotation_w * sign - pa.rotation_w) * 0.3f;
+        expected.scale_x = pa.scale_x + (pb.scale_x - pa.scale_x) * 0.3f;
+        expected.scale_y = pa.scale_y + (pb.scale_y - pa.scale_y) * 0.3f;
+        expected.scale_z = pa.scale_z + (pb.scale_z - pa.scale_z) * 0.3f;
+        lrg_bone_pose_normalize_rotation (&expected);
+
+        g_assert_cmpfloat (pose_max_error (&expected, &actual), <, 0.00001f);
+    }
+
+    /* Resizing keeps existing bones and adds identity ones */
+    lrg_pose_buffer_set_bone_count (out, 9);
+    g_assert_cmpuint (lrg_pose_buffer_get_bone_count (out), ==, 9);
+    {
+        LrgBonePose pose;
+        LrgBonePose identity;
+
+        lrg_bone_pose_set_identity (&identity);
+        lrg_pose_buffer_get_pose (out, 8, &pose);
+        g_assert_cmpfloat (pose_max_error (&identity, &pose), ==, 0.0f);
+    }
+}
+
+static void
+test_pose_buffer_accumulate (void)
+{
+    g_autoptr(LrgPoseBuffer) a = lrg_pose_buffer_new (5);
+    g_autoptr(LrgPoseBuffer) b = NULL;
+    g_autoptr(LrgPoseBuffer) sum = lrg_pose_buffer_new (5);
+    LrgBonePose pose;
+    guint i;
+
+    lrg_bone_pose_set_identity (&pose);
+    lrg_bone_pose_set_position (&pose, 1.0f, 2.0f, 3.0f);
+    lrg_bone_pose_set_rotation_euler (&pose, 0.0f, 0.6f, 0.0f);
+    for (i = 0; i < 5; i++)
+        lrg_pose_buffer_set_pose (a, i, &pose);
+
+    /* Same rotation stored as -q, different position */
+    b = lrg_pose_buffer_copy (a);
+    pose.position_x = 3.0f;
+    pose.rotation_x = -pose.rotation_x;
+    pose.rotation_y = -pose.rotation_y;
+    pose.rotation_z = -pose.rotation_z;
+    pose.rotation_w = -pose.rotation_w;
+    for (i = 0; i < 5; i++)
+        lrg_pose_buffer_set_pose (b, i, &pose);
+
+    lrg_pose_buffer_clear (sum);
+    lrg_pose_buffer_accumulate (sum, a, 0.5f);
+    lrg_pose_buffer_accumulate (sum, b, 0.5f);
+    lrg_pose_buffer_normalize_rotations (sum);
+
+    for (i = 0; i < 5; i++)
+    {
+        LrgBonePose expected;
+        LrgBonePose actual;
+
+        lrg_pose_buffer_get_pose (a, i, &expected);
+        expected.position_x = 2.0f;
+        lrg_pose_buffer_get_pose (sum, i, &actual);
+
+        g_assert_cmpfloat (pose_max_error (&expected, &actual), <, 0.00001f);
+    }
+
+    /* A degenerate rotation falls back to identity, its neighbours do not */
+    pose.rotation_x = 0.0f;
+    pose.rotation_y = 0.0f;
+    pose.rotation_z = 0.0f;
+    pose.rotation_w = 0.0f;
+    lrg_pose_buffer_set_pose (sum, 4, &pose);
+    lrg_pose_buffer_normalize_rotations (sum);
+
+    lrg_pose_buffer_get_pose (sum, 4, &pose);
+    g_assert_cmpfloat (pose.rotation_x, ==, 0.0f);
+    g_assert_cmpfloat (pose.rotation_y, ==, 0.0f);
+    g_assert_cmpfloat (pose.rotation_z, ==, 0.0f);
+    g_assert_cmpfloat (pose.rotation_w, ==, 1.0f);
+
+    for (i = 0; i < 4; i++)
+    {
+        LrgBonePose expected;
+        LrgBonePose actual;
+
+        lrg_pose_buffer_get_pose (a, i, &expected);
+        expected.position_x = 2.0f;
+        lrg_pose_buffer_get_pose (sum, i, &actual);
+
+        g_assert_cmpfloat (pose_max_error (&expected, &actual), <, 0.00001f);
+    }
+}
+
+/*
+ * ============================================================================
+ * LrgBlendTree Tests
+ * ============================================================================
+ */
+
+/* A skeleton whose bones are named like create_smooth_clip() tracks */
+static LrgSkeleton *
+create_chain_skeleton (guint n_bones)
+{
+    LrgSkeleton *skeleton;
+    guint i;
+
+    skeleton = lrg_skeleton_new ();
+
+    for (i = 0; i < n_bones; i++)
+    {
+        g_autofree gchar *name = g_strdup_printf ("bone%u", i);
+        g_autoptr(LrgBone) bone = lrg_bone_new (name, (gint)i);
+        LrgBonePose bind;
+
+        lrg_bone_pose_set_identity (&bind);
+        bind.position_y = 0.5f;
+        lrg_bone_set_bind_pose (bone, &bind);
+        if (i > 0)
+            lrg_bone_set_parent_index (bone, (gint)i - 1);
+
+        lrg_skeleton_add_bone (skeleton, bone);
+    }
+
+    return skeleton;
+}
+
+/* Looping two-second clip whose positions and scales are offset by @offset */
+static LrgAnimationClip *
+create_offset_clip (guint  n_tracks,
+                    gfloat offset)
+{
+    LrgAnimationClip *clip;
+
+    clip = create_smooth_clip_with_offset (n_tracks, 2.0f, 30.0f, offset);
+    lrg_animation_clip_set_loop_mode (clip, LRG_ANIMATION_LOOP_REPEAT);
+
+    return clip;
+}
+
+static void
+test_blend_tree_sample_pose (void)
+{
+    g_autoptr(LrgSkeleton) skeleton = create_chain_skeleton (4);
+    g_autoptr(LrgAnimationClip) idle = create_offset_clip (3, 0.0f);
+    g_autoptr(LrgAnimationClip) walk = create_offset_clip (3, 1.0f);
+    g_autoptr(LrgAnimationClip) run = create_offset_clip (3, 2.0f);
+    g_autoptr(LrgBlendTree) tree = lrg_blend_tree_new (LRG_BLEND_TYPE_1D);
+    g_autoptr(LrgPoseBuffer) poses = lrg_pose_buffer_new (0);
+    guint frame;
+    guint bone;
+
+    /* Only bones 0-2 are animated; bone 3 stays at its bind pose */
+    lrg_blend_tree_add_child (tree, idle, 0.0f);
+    lrg_blend_tree_add_child (tree, walk, 1.0f);
+    lrg_blend_tree_add_child (tree, run, 2.0f);
+
+    for (frame = 0; frame < 90; frame++)
+    {
+        lrg_blend_tree_set_parameter (tree, (gfloat)frame / 45.0f);
+        lrg_blend_tree_update (tree, 1.0f / 60.0f);
+        lrg_blend_tree_sample_pose (tree, skeleton, poses);
+
+        g_assert_cmpuint (lrg_pose_buffer_get_bone_count (poses), ==, 4);
+
+        for (bone = 0; bone < 3; bone++)
+        {
+            g_autofree gchar *name = g_strdup_printf ("bone%u", bone);
+            LrgBonePose expected;
+            LrgBonePose actual;
+
+            lrg_blend_tree_sample (tree, &expected, name);
+            lrg_pose_buffer_get_pose (poses, bone, &actual);
+            g_assert_cmpfloat (pose_max_error (&expected, &actual), <, 0.0001f);
+        }
+
+        {
+            LrgBonePose actual;
+
+            lrg_pose_buffer_get_pose (poses, 3, &actual);
+            g_assert_cmpfloat (pose_max_error (lrg_bone_get_bind_pose (lrg_skeleton_get_bone (skeleton, 3)),
+                                               &actual), ==, 0.0f);
+        }
+    }
+}
+
+static void
+test_blend_tree_invalidate (void)
+{
+    g_autoptr(LrgSkeleton) skeleton = create_chain_skeleton (2);
+    g_autoptr(LrgAnimationClip) low = create_offset_clip (2, 0.0f);
+    g_autoptr(LrgAnimationClip) high = create_offset_clip (2, 1.0f);
+    g_autoptr(LrgBlendTree) tree = lrg_blend_tree_new (LRG_BLEND_TYPE_1D);
+    g_autoptr(LrgPoseBuffer) before = lrg_pose_buffer_new (0);
+    g_autoptr(LrgPoseBuffer) after = lrg_pose_buffer_new (0);
+    LrgBlendTreeChild *child;
+    LrgBonePose a;
+    LrgBonePose b;
+
+    lrg_blend_tree_add_child (tree, low, 0.0f);
+    lrg_blend_tree_add_child (tree, high, 1.0f);
+    lrg_blend_tree_set_parameter (tree, 0.5f);
+    lrg_blend_tree_update (tree, 0.0f);
+    lrg_blend_tree_sample_pose (tree, skeleton, before);
+
+    /* Moving a threshold in place only counts once the tree is told */
+    child = g_list_nth_data (lrg_blend_tree_get_children (tree), 1);
+    child->threshold = 0.5f;
+    lrg_blend_tree_invalidate (tree);
+    lrg_blend_tree_update (tree, 0.0f);
+    lrg_blend_tree_sample_pose (tree, skeleton, after);
+
+    lrg_pose_buffer_get_pose (before, 0, &a);
+    lrg_pose_buffer_get_pose (after, 0, &b);
+    g_assert_cmpfloat_with_epsilon (b.position_x - a.position_x, 0.5f, 0.001f);
+
+    /* Swapping a child's clip rebinds it */
+    g_set_object (&child->clip, low);
+    lrg_blend_tree_sample_pose (tree, skeleton, after);
+    lrg_pose_buffer_get_pose (after, 0, &b);
+    g_assert_cmpfloat_with_epsilon (b.position_x, a.position_x - 0.5f, 0.001f);
+}
+
+/* 2D freeform tree over four offset clips, as a locomotion blend */
+static LrgBlendTree *
+create_locomotion_tree (LrgAnimationClip **clips)
+{
+    LrgBlendTree *tree;
+
+    tree = lrg_blend_tree_new (LRG_BLEND_TYPE_2D_FREEFORM);
+    lrg_blend_tree_add_child_2d (tree, clips[0], 0.0f, 1.0f);
+    lrg_blend_tree_add_child_2d (tree, clips[1], 0.0f, -1.0f);
+    lrg_blend_tree_add_child_2d (tree, clips[2], -1.0f, 0.0f);
+    lrg_blend_tree_add_child_2d (tree, clips[3], 1.0f, 0.0f);
+
+    return tree;
+}
+
+static void
+test_blend_tree_sample_batch (void)
+{
+    g_autoptr(LrgSkeleton) skeleton = create_chain_skeleton (6);
+    LrgAnimationClip *clips[4];
+    LrgBlendTree *trees[40];
+    LrgPoseBuffer *batched[40];
+    guint i;
+
+    for (i = 0; i < 4; i++)
+        clips[i] = create_offset_clip (6, (gfloat)i);
+
+    for (i = 0; i < 40; i++)
+    {
+        trees[i] = create_locomotion_tree (clips);
+        lrg_blend_tree_set_parameter_2d (trees[i], sinf ((gfloat)i), cosf ((gfloat)i * 0.7f));
+        lrg_blend_tree_update (trees[i], (gfloat)i / 40.0f);
+        batched[i] = lrg_pose_buffer_new (0);
+    }
+
+    lrg_blend_tree_sample_batch (trees, 40, skeleton, batched, 4);
+
+    for (i = 0; i < 40; i++)
+    {
+        g_autoptr(LrgPoseBuffer) single = lrg_pose_buffer_new (0);
+        guint bone;
+
+        lrg_blend_tree_sample_pose (trees[i], skeleton, single);
+
+        for (bone = 0; bone < 6; bone++)
+        {
+            LrgBonePose expected;
+            LrgBonePose actual;
+
+            lrg_pose_buffer_get_pose (single, bone, &expected);
+            lrg_pose_buffer_get_pose (batched[i], bone, &actual);
+            g_assert_cmpfloat (pose_max_error (&expected, &actual), ==, 0.0f);
+        }
+
+        g_object_unref (trees[i]);
+        lrg_pose_buffer_free (batched[i]);
+    }
+
+    for (i = 0; i < 4; i++)
+        g_object_unref (clips[i]);
+}
+
+static void
+test_blend_tree_perf (void)
+{
+    g_autoptr(LrgSkeleton) skeleton = NULL;
+    g_autoptr(GTimer) timer = NULL;
+    LrgAnimationClip *clips[4];
+    LrgBlendTree **trees;
+    LrgPoseBuffer **poses;
+    gchar *bone_names[40];
+    gdouble per_bone_ms;
+    gdouble batched_ms;
+    guint frames = 10;
+    guint n = 500;
+    guint f;
+    guint i;
+    guint bone;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    /* 500 characters with 40 bones, each blending four 40-track clips */
+    skeleton = create_chain_skeleton (40);
+    for (i = 0; i < 4; i++)
+        clips[i] = create_offset_clip (40, (gfloat)i);
+    for (bone = 0; bone < 40; bone++)
+        bone_names[bone] = g_strdup_printf ("bone%u", bone);
+
+    trees = g_new (LrgBlendTree *, n);
+    poses = g_new (LrgPoseBuffer *, n);
+    for (i = 0; i < n; i++)
+    {
+        trees[i] = create_locomotion_tree (clips);
+        lrg_blend_tree_set_parameter_2d (trees[i], sinf ((gfloat)i), cosf ((gfloat)i));
+        poses[i] = lrg_pose_buffer_new (40);
+    }
+
+    timer = g_timer_new ();
+
+    g_timer_start (timer);
+    for (f = 0; f < frames; f++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            lrg_blend_tree_update (trees[i], 1.0f / 60.0f);
+            for (bone = 0; bone < 40; bone++)
+            {
+                LrgBonePose pose;
+
+                lrg_blend_tree_sample (trees[i], &pose, bone_names[bone]);
+                lrg_pose_buffer_set_pose (poses[i], bone, &pose);
+            }
+        }
+    }
+    per_bone_ms = g_timer_elapsed (timer, NULL) * 1000.0 / frames;
+
+    g_timer_start (timer);
+    for (f = 0; f < frames; f++)
+    {
+        for (i = 0; i < n; i++)
+            lrg_blend_tree_update (trees[i], 1.0f / 60.0f);
+        lrg_blend_tree_sample_batch (trees, n, skeleton, poses, 1);
+    }
+    batched_ms = g_timer_elapsed (timer, NULL) * 1000.0 / frames;
+
+    g_test_minimized_result (batched_ms,
+                             "%u characters, 40 bones, 4-way blend: %.3f ms/frame per bone, "
+                             "%.3f ms/frame batched (one thread)",
+                             n, per_bone_ms, batched_ms);
+
+    for (i = 0; i < n; i++)
+    {
+        g_object_unref (trees[i]);
+        lrg_pose_buffer_free (poses[i]);
+    }
+    g_free (trees);
+    g_free (poses);
+    for (i = 0; i < 4; i++)
+        g_object_unref (clips[i]);
+    for (bone = 0; bone < 40; bone++)
+        g_free (bone_names[bone]);
+}
+
 /*
  * ============================================================================
  * LrgIKSolver Tests
@@ -696,6 +1530,14 @@ main (int   argc,
     g_test_add_func ("/animation/clip/duration", test_clip_duration);
     g_test_add_func ("/animation/clip/loop-mode", test_clip_loop_mode);
     g_test_add_func ("/animation/clip/add-track", test_clip_add_track);
+    g_test_add_func ("/animation/clip/keyframes-sorted", test_clip_keyframes_sorted);
+    g_test_add_func ("/animation/clip/cursor", test_clip_cursor);
+    g_test_add_func ("/animation/clip/cursor-perf", test_clip_cursor_perf);
+    g_test_add_func ("/animation/clip/sample-out-of-range", test_clip_sample_out_of_range);
+
+    /* LrgCompressedClip tests */
+    g_test_add_func ("/animation/compressed-clip/error", test_compressed_clip_error);
+    g_test_add_func ("/animation/compressed-clip/constant", test_compressed_clip_constant);
 
     /* LrgAnimator tests */
     g_test_add_func ("/animation/animator/new", test_animator_new);
@@ -723,6 +1565,16 @@ main (int   argc,
     g_test_add ("/animation/state-machine/force-state", StateMachineFixture, NULL,
                 state_machine_fixture_set_up, test_state_machine_force_state, state_machine_fixture_tear_down);
 
+    /* LrgPoseBuffer tests */
+    g_test_add_func ("/animation/pose-buffer/lerp", test_pose_buffer_lerp);
+    g_test_add_func ("/animation/pose-buffer/accumulate", test_pose_buffer_accumulate);
+
+    /* LrgBlendTree tests */
+    g_test_add_func ("/animation/blend-tree/sample-pose", test_blend_tree_sample_pose);
+    g_test_add_func ("/animation/blend-tree/invalidate", test_blend_tree_invalidate);
+    g_test_add_func ("/animation/blend-tree/sample-batch", test_blend_tree_sample_batch);
+    g_test_add_func ("/animation/blend-tree/perf", test_blend_tree_perf);
+
     /* LrgIKSolver tests */
     g_test_add_func ("/animation/ik-solver/fabrik/new", test_ik_solver_fabrik_new);
     g_test_add_func ("/animation/ik-solver/ccd/new", test_ik_solver_ccd_new);
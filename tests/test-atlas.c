@@ -15,6 +15,7 @@
 
 #include <glib.h>
 #include <glib/gstdio.h>
+#include <gio/gio.h>
 #include <math.h>
 #include <unistd.h>
 
@@ -833,6 +834,308 @@ test_atlas_packer_no_power_of_two (PackerFixture *fixture,
     g_assert_cmpint (lrg_atlas_packer_get_packed_height (fixture->packer), ==, 50);
 }
 
+/*
+ * add_random_images:
+ *
+ * Adds @n images named "img<i>" with sizes typical of sprites and UI
+ * pieces. Seeded, so every run packs the same set.
+ */
+static void
+add_random_images (LrgAtlasPacker *packer,
+                   guint           n)
+{
+    g_autoptr(GRand) rand = g_rand_new_with_seed (42);
+    guint i;
+
+    for (i = 0; i < n; i++)
+    {
+        g_autofree gchar *name = g_strdup_printf ("img%u", i);
+        gint w = g_rand_int_range (rand, 8, 96);
+        gint h = g_rand_int_range (rand, 8, 96);
+
+        lrg_atlas_packer_add_image (packer, name, w, h, NULL);
+    }
+}
+
+/*
+ * assert_packed_without_overlaps:
+ *
+ * Checks that every image added by add_random_images() lies within its
+ * page and that no two images on a page overlap, padding included.
+ */
+static void
+assert_packed_without_overlaps (LrgAtlasPacker *packer,
+                                guint           n)
+{
+    g_autoptr(GRand) rand = g_rand_new_with_seed (42);
+    g_autofree gint *rects = g_new (gint, n * 5);
+    gint padding = lrg_atlas_packer_get_padding (packer);
+    guint i, j;
+
+    for (i = 0; i < n; i++)
+    {
+        g_autofree gchar *name = g_strdup_printf ("img%u", i);
+        gint *r = &rects[i * 5];
+        gint w = g_rand_int_range (rand, 8, 96);
+        gint h = g_rand_int_range (rand, 8, 96);
+        gint page_w, page_h;
+        gboolean rotated;
+
+        g_assert_true (lrg_atlas_packer_get_image_position (packer, name,
+                                                            &r[0], &r[1],
+                                                            &rotated));
+        r[2] = (rotated ? h : w) + padding;
+        r[3] = (rotated ? w : h) + padding;
+        r[4] = lrg_atlas_packer_get_image_page (packer, name);
+
+        g_assert_cmpint (r[4], >=, 0);
+        g_assert_true (lrg_atlas_packer_get_page_size (packer, r[4], &page_w, &page_h));
+        g_assert_cmpint (r[0], >=, 0);
+        g_assert_cmpint (r[1], >=, 0);
+        g_assert_cmpint (r[0] + r[2], <=, page_w);
+        g_assert_cmpint (r[1] + r[3], <=, page_h);
+        g_assert_cmpint (page_w, <=, lrg_atlas_packer_get_max_width (packer));
+        g_assert_cmpint (page_h, <=, lrg_atlas_packer_get_max_height (packer));
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        for (j = i + 1; j < n; j++)
+        {
+            const gint *a = &rects[i * 5];
+            const gint *b = &rects[j * 5];
+
+            if (a[4] != b[4])
+                continue;
+
+            g_assert_false (a[0] < b[0] + b[2] && b[0] < a[0] + a[2] &&
+                            a[1] < b[1] + b[3] && b[1] < a[1] + a[3]);
+        }
+    }
+}
+
+static gfloat
+pack_random_images (LrgAtlasPackMethod method,
+                    gboolean           allow_rotation)
+{
+    g_autoptr(GError) error = NULL;
+    LrgAtlasPacker *packer;
+    gfloat efficiency;
+
+    packer = lrg_atlas_packer_new ();
+    lrg_atlas_packer_set_max_size (packer, 1024, 1024);
+    lrg_atlas_packer_set_power_of_two (packer, FALSE);
+    lrg_atlas_packer_set_method (packer, method);
+    lrg_atlas_packer_set_allow_rotation (packer, allow_rotation);
+    add_random_images (packer, 150);
+
+    g_assert_true (lrg_atlas_packer_pack (packer, &error));
+    g_assert_no_error (error);
+    g_assert_cmpuint (lrg_atlas_packer_get_page_count (packer), ==, 1);
+    assert_packed_without_overlaps (packer, 150);
+
+    efficiency = lrg_atlas_packer_get_efficiency (packer);
+    g_test_message ("method %d, rotation %d: %dx%d, efficiency %.1f%%",
+                    method, allow_rotation,
+                    lrg_atlas_packer_get_packed_width (packer),
+                    lrg_atlas_packer_get_packed_height (packer),
+                    efficiency * 100.0f);
+
+    g_object_unref (packer);
+    return efficiency;
+}
+
+static void
+test_atlas_packer_maxrects (void)
+{
+    gfloat shelf;
+    gfloat maxrects;
+    gfloat rotated;
+
+    shelf = pack_random_images (LRG_ATLAS_PACK_METHOD_SHELF, FALSE);
+    maxrects = pack_random_images (LRG_ATLAS_PACK_METHOD_MAXRECTS, FALSE);
+    rotated = pack_random_images (LRG_ATLAS_PACK_METHOD_MAXRECTS, TRUE);
+
+    g_assert_cmpfloat (maxrects, >, shelf);
+    g_assert_cmpfloat (rotated, >=, maxrects);
+}
+
+static void
+test_atlas_packer_guillotine (void)
+{
+    gfloat shelf;
+    gfloat guillotine;
+    gfloat rotated;
+
+    shelf = pack_random_images (LRG_ATLAS_PACK_METHOD_SHELF, FALSE);
+    guillotine = pack_random_images (LRG_ATLAS_PACK_METHOD_GUILLOTINE, FALSE);
+    rotated = pack_random_images (LRG_ATLAS_PACK_METHOD_GUILLOTINE, TRUE);
+
+    g_assert_cmpfloat (guillotine, >, shelf);
+    g_assert_cmpfloat (rotated, >=, guillotine);
+}
+
+static void
+test_atlas_packer_rotation (PackerFixture *fixture,
+                            gconstpointer  user_data)
+{
+    g_autoptr(GError) error = NULL;
+    LrgTextureAtlas *atlas;
+    LrgAtlasRegion *region;
+    gint x, y;
+    gboolean rotated;
+
+    /* Only fits lying on its side */
+    lrg_atlas_packer_set_max_size (fixture->packer, 64, 256);
+    lrg_atlas_packer_set_method (fixture->packer, LRG_ATLAS_PACK_METHOD_MAXRECTS);
+    lrg_atlas_packer_add_image (fixture->packer, "long", 200, 40, NULL);
+
+    g_assert_false (lrg_atlas_packer_pack (fixture->packer, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE);
+    g_clear_error (&error);
+
+    lrg_atlas_packer_set_allow_rotation (fixture->packer, TRUE);
+    g_assert_true (lrg_atlas_packer_pack (fixture->packer, &error));
+    g_assert_no_error (error);
+
+    g_assert_true (lrg_atlas_packer_get_image_position (fixture->packer, "long",
+                                                        &x, &y, &rotated));
+    g_assert_true (rotated);
+    g_assert_cmpint (lrg_atlas_packer_get_packed_width (fixture->packer), ==, 64);
+    g_assert_cmpint (lrg_atlas_packer_get_packed_height (fixture->packer), ==, 256);
+
+    /* The region covers the texels the image occupies on its side */
+    atlas = lrg_atlas_packer_create_page_atlas (fixture->packer, "page", 0);
+    region = lrg_texture_atlas_get_region (atlas, "long");
+    g_assert_nonnull (region);
+    g_assert_true (lrg_atlas_region_is_rotated (region));
+    g_assert_cmpint (lrg_atlas_region_get_x (region), ==, x);
+    g_assert_cmpint (lrg_atlas_region_get_y (region), ==, y);
+    g_assert_cmpint (lrg_atlas_region_get_width (region), ==, 40);
+    g_assert_cmpint (lrg_atlas_region_get_height (region), ==, 200);
+    g_assert_cmpfloat (lrg_atlas_region_get_u1 (region), >=, 0.0f);
+    g_assert_cmpfloat (lrg_atlas_region_get_v1 (region), >=, 0.0f);
+    g_assert_cmpfloat (lrg_atlas_region_get_u2 (region), <=, 1.0f);
+    g_assert_cmpfloat (lrg_atlas_region_get_v2 (region), <=, 1.0f);
+    g_object_unref (atlas);
+}
+
+static void
+test_atlas_packer_multi_page (PackerFixture *fixture,
+                              gconstpointer  user_data)
+{
+    g_autoptr(GError) error = NULL;
+    LrgTextureAtlas *atlas;
+    guint methods[] = { LRG_ATLAS_PACK_METHOD_SHELF,
+                        LRG_ATLAS_PACK_METHOD_MAXRECTS,
+                        LRG_ATLAS_PACK_METHOD_GUILLOTINE };
+    guint regions;
+    guint m, p;
+    gint i;
+
+    /* Four 64x64 images fill a 128x128 page */
+    lrg_atlas_packer_set_max_size (fixture->packer, 128, 128);
+    lrg_atlas_packer_set_padding (fixture->packer, 0);
+    lrg_atlas_packer_set_max_pages (fixture->packer, 0);
+    for (i = 0; i < 10; i++)
+    {
+        g_autofree gchar *name = g_strdup_printf ("tile%d", i);
+        lrg_atlas_packer_add_image (fixture->packer, name, 64, 64, NULL);
+    }
+
+    for (m = 0; m < G_N_ELEMENTS (methods); m++)
+    {
+        lrg_atlas_packer_set_method (fixture->packer, methods[m]);
+
+        g_assert_true (lrg_atlas_packer_pack (fixture->packer, &error));
+        g_assert_no_error (error);
+        g_assert_cmpuint (lrg_atlas_packer_get_page_count (fixture->packer), ==, 3);
+        g_assert_cmpint (lrg_atlas_packer_get_image_page (fixture->packer, "tile0"), ==, 0);
+        g_assert_cmpint (lrg_atlas_packer_get_image_page (fixture->packer, "tile9"), ==, 2);
+
+        regions = 0;
+        for (p = 0; p < 3; p++)
+        {
+            atlas = lrg_atlas_packer_create_page_atlas (fixture->packer, "page", p);
+            regions += lrg_texture_atlas_get_region_count (atlas);
+            g_object_unref (atlas);
+        }
+        g_assert_cmpuint (regions, ==, 10);
+
+        /* Two full pages and one half-full 128x64 page */
+        g_assert_cmpfloat_with_epsilon (lrg_atlas_packer_get_efficiency (fixture->packer),
+                                        1.0f, 0.001f);
+    }
+
+    lrg_atlas_packer_set_max_pages (fixture->packer, 2);
+    g_assert_false (lrg_atlas_packer_pack (fixture->packer, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE);
+    g_assert_cmpuint (lrg_atlas_packer_get_page_count (fixture->packer), ==, 0);
+}
+
+static void
+test_atlas_packer_single_page_overflow (PackerFixture *fixture,
+                                        gconstpointer  user_data)
+{
+    g_autoptr(GError) error = NULL;
+    gint i;
+
+    /* pack () + create_atlas () callers only see page 0: fail, don't spill */
+    g_assert_cmpuint (lrg_atlas_packer_get_max_pages (fixture->packer), ==, 1);
+
+    lrg_atlas_packer_set_max_size (fixture->packer, 128, 128);
+    lrg_atlas_packer_set_padding (fixture->packer, 0);
+    for (i = 0; i < 5; i++)
+    {
+        g_autofree gchar *name = g_strdup_printf ("tile%d", i);
+        lrg_atlas_packer_add_image (fixture->packer, name, 64, 64, NULL);
+    }
+
+    g_assert_false (lrg_atlas_packer_pack (fixture->packer, &error));
+    g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE);
+    g_assert_cmpuint (lrg_atlas_packer_get_page_count (fixture->packer), ==, 0);
+}
+
+static void
+test_atlas_packer_threads (void)
+{
+    g_autoptr(GError) error = NULL;
+    LrgAtlasPacker *serial;
+    LrgAtlasPacker *parallel;
+    guint i;
+
+    serial = lrg_atlas_packer_new ();
+    parallel = lrg_atlas_packer_new ();
+    lrg_atlas_packer_set_method (serial, LRG_ATLAS_PACK_METHOD_MAXRECTS);
+    lrg_atlas_packer_set_method (parallel, LRG_ATLAS_PACK_METHOD_MAXRECTS);
+    lrg_atlas_packer_set_allow_rotation (serial, TRUE);
+    lrg_atlas_packer_set_allow_rotation (parallel, TRUE);
+    lrg_atlas_packer_set_max_threads (serial, 1);
+    lrg_atlas_packer_set_max_threads (parallel, 4);
+    add_random_images (serial, 100);
+    add_random_images (parallel, 100);
+
+    g_assert_true (lrg_atlas_packer_pack (serial, &error));
+    g_assert_true (lrg_atlas_packer_pack (parallel, &error));
+    g_assert_no_error (error);
+
+    for (i = 0; i < 100; i++)
+    {
+        g_autofree gchar *name = g_strdup_printf ("img%u", i);
+        gint sx, sy, px, py;
+        gboolean sr, pr;
+
+        lrg_atlas_packer_get_image_position (serial, name, &sx, &sy, &sr);
+        lrg_atlas_packer_get_image_position (parallel, name, &px, &py, &pr);
+        g_assert_cmpint (sx, ==, px);
+        g_assert_cmpint (sy, ==, py);
+        g_assert_cmpint (sr, ==, pr);
+    }
+
+    g_object_unref (serial);
+    g_object_unref (parallel);
+}
+
 /* ========================================================================== */
 /*                         YAML Serialization Tests                           */
 /* ========================================================================== */
@@ -1105,6 +1408,15 @@ main (int argc, char *argv[])
                 packer_fixture_set_up, test_atlas_packer_user_data, packer_fixture_tear_down);
     g_test_add ("/atlas/packer/no_power_of_two", PackerFixture, NULL,
                 packer_fixture_set_up, test_atlas_packer_no_power_of_two, packer_fixture_tear_down);
+    g_test_add_func ("/atlas/packer/maxrects", test_atlas_packer_maxrects);
+    g_test_add_func ("/atlas/packer/guillotine", test_atlas_packer_guillotine);
+    g_test_add ("/atlas/packer/rotation", PackerFixture, NULL,
+                packer_fixture_set_up, test_atlas_packer_rotation, packer_fixture_tear_down);
+    g_test_add ("/atlas/packer/multi_page", PackerFixture, NULL,
+                packer_fixture_set_up, test_atlas_packer_multi_page, packer_fixture_tear_down);
+    g_test_add ("/atlas/packer/single_page_overflow", PackerFixture, NULL,
+                packer_fixture_set_up, test_atlas_packer_single_page_overflow, packer_fixture_tear_down);
+    g_test_add_func ("/atlas/packer/threads", test_atlas_packer_threads);
 
     return g_test_run ();
 }
@@ -625,6 +625,99 @@ test_build_grid_out_of_bounds (BuildGridFixture *fixture,
                                               14, 15, LRG_ROTATION_0));
 }
 
+static void
+assert_mask_matches_can_place (BuildGridFixture *fixture,
+                               LrgBuildingDef   *def,
+                               LrgRotation       rotation)
+{
+    g_autoptr(GBytes) mask = NULL;
+    const guint8     *bytes;
+    gsize             size;
+    gint              x;
+    gint              y;
+
+    /* Cover a border outside the grid as well */
+    mask = lrg_build_grid_get_placement_mask (fixture->grid, def, rotation,
+                                              -2, -2, 20, 20);
+    bytes = g_bytes_get_data (mask, &size);
+    g_assert_cmpuint (size, ==, 20 * 20);
+
+    for (y = 0; y < 20; y++)
+    {
+        for (x = 0; x < 20; x++)
+        {
+            g_assert_cmpint (bytes[y * 20 + x], ==,
+                             lrg_build_grid_can_place (fixture->grid, def,
+                                                       x - 2, y - 2, rotation));
+        }
+    }
+}
+
+static void
+test_build_grid_placement_mask (BuildGridFixture *fixture,
+                                gconstpointer     user_data)
+{
+    g_autoptr(LrgBuildingInstance) building = NULL;
+    g_autoptr(GBytes) mask = NULL;
+    const guint8     *bytes;
+
+    (void)user_data;
+
+    assert_mask_matches_can_place (fixture, fixture->large_def, LRG_ROTATION_0);
+
+    /* Each kind of edit must be reflected in the next query */
+    building = lrg_building_instance_new (fixture->small_def, 6, 6);
+    g_assert_true (lrg_build_grid_place_building (fixture->grid, building));
+    lrg_build_grid_set_blocked (fixture->grid, 1, 12, TRUE);
+    lrg_build_grid_set_terrain_rect (fixture->grid, 10, 2, 2, 3, LRG_TERRAIN_WATER);
+
+    assert_mask_matches_can_place (fixture, fixture->large_def, LRG_ROTATION_0);
+    assert_mask_matches_can_place (fixture, fixture->large_def, LRG_ROTATION_90);
+    assert_mask_matches_can_place (fixture, fixture->small_def, LRG_ROTATION_0);
+
+    mask = lrg_build_grid_get_placement_mask (fixture->grid, fixture->small_def,
+                                              LRG_ROTATION_0, 6, 6, 2, 1);
+    bytes = g_bytes_get_data (mask, NULL);
+    g_assert_cmpint (bytes[0], ==, 0);
+    g_assert_cmpint (bytes[1], ==, 1);
+
+    g_assert_true (lrg_build_grid_remove_building (fixture->grid, building));
+    lrg_build_grid_set_blocked (fixture->grid, 1, 12, FALSE);
+    lrg_build_grid_fill_terrain (fixture->grid, LRG_TERRAIN_SAND);
+
+    /* Nothing is grass any more */
+    g_assert_false (lrg_build_grid_can_place (fixture->grid, fixture->small_def,
+                                              6, 6, LRG_ROTATION_0));
+    g_assert_true (lrg_build_grid_is_area_free (fixture->grid, 0, 0, 16, 16));
+    assert_mask_matches_can_place (fixture, fixture->large_def, LRG_ROTATION_0);
+}
+
+static void
+test_build_grid_buildings_in_area (BuildGridFixture *fixture,
+                                   gconstpointer     user_data)
+{
+    g_autoptr(LrgBuildingInstance) b1 = NULL;
+    g_autoptr(LrgBuildingInstance) b2 = NULL;
+    g_autoptr(GPtrArray) buildings = NULL;
+
+    (void)user_data;
+
+    b1 = lrg_building_instance_new (fixture->large_def, 2, 2);
+    b2 = lrg_building_instance_new (fixture->small_def, 8, 8);
+    g_assert_true (lrg_build_grid_place_building (fixture->grid, b1));
+    g_assert_true (lrg_build_grid_place_building (fixture->grid, b2));
+
+    /* Every cell of the 3x2 building is covered, it is reported once */
+    buildings = lrg_build_grid_get_buildings_in_area (fixture->grid, -4, -4, 30, 30);
+    g_assert_cmpuint (buildings->len, ==, 2);
+    g_clear_pointer (&buildings, g_ptr_array_unref);
+
+    /* An area starting inside the building still finds it once */
+    buildings = lrg_build_grid_get_buildings_in_area (fixture->grid, 3, 3, 2, 2);
+    g_assert_cmpuint (buildings->len, ==, 1);
+    g_assert_true (g_ptr_array_index (buildings, 0) == b1);
+}
+
 /* ============================================================================
  * LrgPlacementSystem Tests
  * ============================================================================ */
@@ -972,6 +1065,16 @@ main (int   argc,
                 test_build_grid_out_of_bounds,
                 build_grid_fixture_tear_down);
 
+    g_test_add ("/building/grid/placement-mask", BuildGridFixture, NULL,
+                build_grid_fixture_set_up,
+                test_build_grid_placement_mask,
+                build_grid_fixture_tear_down);
+
+    g_test_add ("/building/grid/buildings-in-area", BuildGridFixture, NULL,
+                build_grid_fixture_set_up,
+                test_build_grid_buildings_in_area,
+                build_grid_fixture_tear_down);
+
     /* LrgPlacementSystem tests */
     g_test_add ("/building/placement/start", PlacementFixture, NULL,
                 placement_fixture_set_up,
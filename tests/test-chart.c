@@ -407,6 +407,248 @@ test_data_series_marker (void)
                      ==, LRG_CHART_MARKER_DIAMOND);
 }
 
+static void
+test_data_series_columnar (void)
+{
+    g_autoptr(LrgChartDataSeries) series = NULL;
+    const LrgChartDataPoint *point;
+    gdouble min, max;
+    guint i;
+
+    series = lrg_chart_data_series_new_columnar ("Columnar", 0);
+    g_assert_true (lrg_chart_data_series_is_columnar (series));
+    g_assert_cmpuint (lrg_chart_data_series_get_capacity (series), ==, 0);
+
+    /* Unbounded columnar series grow past their initial allocation. */
+    for (i = 0; i < 1000; i++)
+        lrg_chart_data_series_add_point (series, (gdouble) i, (gdouble) (i % 7));
+    g_assert_cmpuint (lrg_chart_data_series_get_point_count (series), ==, 1000);
+
+    point = lrg_chart_data_series_get_point (series, 500);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_point_get_x (point), 500.0, 0.0001);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_y (series, 500),
+                                    (gdouble) (500 % 7), 0.0001);
+
+    lrg_chart_data_series_get_y_range (series, &min, &max);
+    g_assert_cmpfloat_with_epsilon (min, 0.0, 0.0001);
+    g_assert_cmpfloat_with_epsilon (max, 6.0, 0.0001);
+    g_assert_true (lrg_chart_data_series_get_x_sorted (series));
+    g_assert_cmpuint (lrg_chart_data_series_find_x (series, 250.5), ==, 251);
+
+    /* Edits behave like the point-array storage. */
+    lrg_chart_data_series_insert_point (series, 0, -1.0, 100.0);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_x (series, 0), -1.0, 0.0001);
+    lrg_chart_data_series_get_y_range (series, NULL, &max);
+    g_assert_cmpfloat_with_epsilon (max, 100.0, 0.0001);
+
+    g_assert_true (lrg_chart_data_series_remove_point (series, 0));
+    lrg_chart_data_series_get_y_range (series, NULL, &max);
+    g_assert_cmpfloat_with_epsilon (max, 6.0, 0.0001);
+
+    lrg_chart_data_series_clear (series);
+    g_assert_cmpuint (lrg_chart_data_series_get_point_count (series), ==, 0);
+}
+
+static void
+test_data_series_ring_buffer (void)
+{
+    g_autoptr(LrgChartDataSeries) series = NULL;
+    gdouble xs[10];
+    gdouble ys[10];
+    gdouble min, max;
+    guint64 generation;
+    guint i;
+
+    series = lrg_chart_data_series_new_columnar ("Stream", 4);
+    g_assert_cmpuint (lrg_chart_data_series_get_capacity (series), ==, 4);
+
+    for (i = 0; i < 10; i++)
+    {
+        xs[i] = (gdouble) i;
+        ys[i] = (gdouble) (i * 10);
+    }
+
+    /* Only the newest four survive, oldest first. */
+    lrg_chart_data_series_append_values (series, xs, ys, 6);
+    g_assert_cmpuint (lrg_chart_data_series_get_point_count (series), ==, 4);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_x (series, 0), 2.0, 0.0001);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_x (series, 3), 5.0, 0.0001);
+
+    /* Wrapping around the ring keeps logical order and ranges. */
+    generation = lrg_chart_data_series_get_generation (series);
+    lrg_chart_data_series_add_point (series, xs[6], ys[6]);
+    lrg_chart_data_series_add_point (series, xs[7], ys[7]);
+    g_assert_cmpuint (lrg_chart_data_series_get_generation (series), >, generation);
+    g_assert_cmpuint (lrg_chart_data_series_get_point_count (series), ==, 4);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_x (series, 0), 4.0, 0.0001);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_x (series, 3), 7.0, 0.0001);
+
+    lrg_chart_data_series_get_x_range (series, &min, &max);
+    g_assert_cmpfloat_with_epsilon (min, 4.0, 0.0001);
+    g_assert_cmpfloat_with_epsilon (max, 7.0, 0.0001);
+    lrg_chart_data_series_get_y_range (series, &min, &max);
+    g_assert_cmpfloat_with_epsilon (min, 40.0, 0.0001);
+    g_assert_cmpfloat_with_epsilon (max, 70.0, 0.0001);
+
+    /* Removing from the middle of a wrapped ring. */
+    g_assert_true (lrg_chart_data_series_remove_point (series, 1));
+    g_assert_cmpuint (lrg_chart_data_series_get_point_count (series), ==, 3);
+    g_assert_cmpfloat_with_epsilon (lrg_chart_data_series_get_x (series, 1), 6.0, 0.0001);
+}
+
+static void
+test_data_series_decimate_lttb (void)
+{
+    g_autoptr(LrgChartDataSeries) series = NULL;
+    const guint *indices;
+    const guint *again;
+    guint n = 0;
+    guint i;
+
+    series = lrg_chart_data_series_new_columnar ("Dense", 0);
+    for (i = 0; i < 10000; i++)
+        lrg_chart_data_series_add_point (series, (gdouble) i, sin (i * 0.01));
+
+    /* Sparse enough windows are not decimated. */
+    indices = lrg_chart_data_series_get_decimated (series, LRG_CHART_DECIMATION_LTTB,
+                                                   0, 50, 100, &n);
+    g_assert_null (indices);
+    g_assert_cmpuint (n, ==, 50);
+
+    indices = lrg_chart_data_series_get_decimated (series, LRG_CHART_DECIMATION_LTTB,
+                                                   0, 10000, 100, &n);
+    g_assert_nonnull (indices);
+    g_assert_cmpuint (n, ==, 100);
+    g_assert_cmpuint (indices[0], ==, 0);
+    g_assert_cmpuint (indices[n - 1], ==, 9999);
+    for (i = 1; i < n; i++)
+        g_assert_cmpuint (indices[i], >, indices[i - 1]);
+
+    /* Cached until the data changes. */
+    again = lrg_chart_data_series_get_decimated (series, LRG_CHART_DECIMATION_LTTB,
+                                                 0, 10000, 100, &n);
+    g_assert_true (again == indices);
+
+    lrg_chart_data_series_add_point (series, 10000.0, 0.0);
+    again = lrg_chart_data_series_get_decimated (series, LRG_CHART_DECIMATION_LTTB,
+                                                 0, 10001, 100, &n);
+    g_assert_nonnull (again);
+    g_assert_cmpuint (again[n - 1], ==, 10000);
+}
+
+static void
+test_data_series_decimate_min_max (void)
+{
+    g_autoptr(LrgChartDataSeries) series = NULL;
+    const guint *indices;
+    gboolean found_spike = FALSE;
+    gboolean found_dip = FALSE;
+    guint n = 0;
+    guint i;
+
+    series = lrg_chart_data_series_new ("Spiky");
+    for (i = 0; i < 5000; i++)
+    {
+        gdouble y = 0.0;
+
+        if (i == 1234) y = 100.0;
+        if (i == 4321) y = -50.0;
+        lrg_chart_data_series_add_point (series, (gdouble) i, y);
+    }
+
+    indices = lrg_chart_data_series_get_decimated (series, LRG_CHART_DECIMATION_MIN_MAX,
+                                                   0, 5000, 200, &n);
+    g_assert_nonnull (indices);
+    g_assert_cmpuint (n, <=, 202);
+
+    /* Every extreme survives min/max decimation. */
+    for (i = 0; i < n; i++)
+    {
+        if (indices[i] == 1234) found_spike = TRUE;
+        if (indices[i] == 4321) found_dip = TRUE;
+    }
+    g_assert_true (found_spike);
+    g_assert_true (found_dip);
+}
+
+static void
+test_data_series_find_nearest (void)
+{
+    g_autoptr(LrgChartDataSeries) series = NULL;
+    g_autoptr(GRand) rand = NULL;
+    guint i, j;
+
+    series = lrg_chart_data_series_new ("Cloud");
+    rand = g_rand_new_with_seed (1234);
+
+    for (i = 0; i < 3000; i++)
+    {
+        lrg_chart_data_series_add_point (series,
+                                         g_rand_double_range (rand, -100.0, 100.0),
+                                         g_rand_double_range (rand, 0.0, 10.0));
+    }
+
+    /* The index must agree with a brute-force scan. */
+    for (i = 0; i < 200; i++)
+    {
+        gdouble qx = g_rand_double_range (rand, -110.0, 110.0);
+        gdouble qy = g_rand_double_range (rand, -1.0, 11.0);
+        gdouble best_sq = G_MAXDOUBLE;
+        guint best = 0;
+        guint index = 0;
+        gdouble dist = 0.0;
+
+        for (j = 0; j < 3000; j++)
+        {
+            gdouble dx = (lrg_chart_data_series_get_x (series, j) - qx) * 2.0;
+            gdouble dy = (lrg_chart_data_series_get_y (series, j) - qy) * 40.0;
+
+            if (dx * dx + dy * dy < best_sq)
+            {
+                best_sq = dx * dx + dy * dy;
+                best = j;
+            }
+        }
+
+        g_assert_true (lrg_chart_data_series_find_nearest (series, qx, qy, 2.0, 40.0,
+                                                           G_MAXDOUBLE, &index, &dist));
+        g_assert_cmpuint (index, ==, best);
+        g_assert_cmpfloat_with_epsilon (dist, sqrt (best_sq), 1e-9);
+    }
+
+    /* Nothing within the radius is a miss. */
+    g_assert_false (lrg_chart_data_series_find_nearest (series, 1000.0, 1000.0, 1.0, 1.0,
+                                                        5.0, NULL, NULL));
+}
+
+static void
+test_data_series_find_nearest_rebuild (void)
+{
+    g_autoptr(LrgChartDataSeries) series = NULL;
+    guint index = 0;
+
+    series = lrg_chart_data_series_new ("Test");
+    g_assert_false (lrg_chart_data_series_find_nearest (series, 0.0, 0.0, 1.0, 1.0,
+                                                        G_MAXDOUBLE, &index, NULL));
+
+    lrg_chart_data_series_add_point (series, 0.0, 0.0);
+    lrg_chart_data_series_add_point (series, 10.0, 10.0);
+    g_assert_true (lrg_chart_data_series_find_nearest (series, 6.0, 6.0, 1.0, 1.0,
+                                                       G_MAXDOUBLE, &index, NULL));
+    g_assert_cmpuint (index, ==, 1);
+
+    /* New data invalidates the index. */
+    lrg_chart_data_series_add_point (series, 5.0, 5.0);
+    g_assert_true (lrg_chart_data_series_find_nearest (series, 6.0, 6.0, 1.0, 1.0,
+                                                       G_MAXDOUBLE, &index, NULL));
+    g_assert_cmpuint (index, ==, 2);
+
+    lrg_chart_data_series_remove_point (series, 2);
+    g_assert_true (lrg_chart_data_series_find_nearest (series, 6.0, 6.0, 1.0, 1.0,
+                                                       G_MAXDOUBLE, &index, NULL));
+    g_assert_cmpuint (index, ==, 1);
+}
+
 /* ==========================================================================
  * LrgChartColorScale Tests
  * ========================================================================== */
@@ -754,6 +996,83 @@ test_line_chart2d_properties (void)
     /* Test fill opacity */
     lrg_line_chart2d_set_fill_opacity (chart, 0.5f);
     g_assert_cmpfloat_with_epsilon (lrg_line_chart2d_get_fill_opacity (chart), 0.5f, 0.0001f);
+
+    /* Test decimation */
+    g_assert_cmpint (lrg_line_chart2d_get_decimation (chart), ==, LRG_CHART_DECIMATION_LTTB);
+    lrg_line_chart2d_set_decimation (chart, LRG_CHART_DECIMATION_MIN_MAX);
+    g_assert_cmpint (lrg_line_chart2d_get_decimation (chart), ==, LRG_CHART_DECIMATION_MIN_MAX);
+}
+
+static void
+test_scatter_chart2d_hit_test (void)
+{
+    g_autoptr(LrgScatterChart2D) chart = NULL;
+    g_autoptr(GRand) rand = NULL;
+    LrgChartDataSeries *series;
+    gfloat radius;
+    guint s, i, j;
+
+    chart = lrg_scatter_chart2d_new_with_size (400.0f, 300.0f);
+    rand = g_rand_new_with_seed (42);
+    radius = lrg_scatter_chart2d_get_hit_radius (chart);
+
+    for (s = 0; s < 2; s++)
+    {
+        series = lrg_chart_data_series_new ("Cloud");
+        for (i = 0; i < 500; i++)
+        {
+            lrg_chart_data_series_add_point (series,
+                                             g_rand_double_range (rand, 0.0, 1000.0),
+                                             g_rand_double_range (rand, -5.0, 5.0));
+        }
+        lrg_chart_add_series (LRG_CHART (chart), series);
+        g_object_unref (series);
+    }
+
+    lrg_chart_update_data (LRG_CHART (chart));
+
+    /* Indexed hit testing must match a scan in screen space. */
+    for (i = 0; i < 300; i++)
+    {
+        g_autoptr(LrgChartHitInfo) hit = lrg_chart_hit_info_new ();
+        gfloat qx = (gfloat) g_rand_double_range (rand, 0.0, 400.0);
+        gfloat qy = (gfloat) g_rand_double_range (rand, 0.0, 300.0);
+        gfloat best_sq = radius * radius;
+        gint best_series = -1;
+        gint best_point = -1;
+
+        for (s = 0; s < 2; s++)
+        {
+            series = lrg_chart_get_series (LRG_CHART (chart), s);
+            for (j = 0; j < 500; j++)
+            {
+                gfloat sx, sy;
+                gfloat d_sq;
+
+                lrg_chart2d_data_to_screen (LRG_CHART2D (chart),
+                                            lrg_chart_data_series_get_x (series, j),
+                                            lrg_chart_data_series_get_y (series, j),
+                                            &sx, &sy);
+                d_sq = (sx - qx) * (sx - qx) + (sy - qy) * (sy - qy);
+                if (d_sq < best_sq)
+                {
+                    best_sq = d_sq;
+                    best_series = s;
+                    best_point = j;
+                }
+            }
+        }
+
+        if (best_series < 0)
+        {
+            g_assert_false (lrg_chart_hit_test (LRG_CHART (chart), qx, qy, hit));
+            continue;
+        }
+
+        g_assert_true (lrg_chart_hit_test (LRG_CHART (chart), qx, qy, hit));
+        g_assert_cmpint (lrg_chart_hit_info_get_series_index (hit), ==, best_series);
+        g_assert_cmpint (lrg_chart_hit_info_get_point_index (hit), ==, best_point);
+    }
 }
 
 static void
@@ -955,6 +1274,12 @@ main (int   argc,
     g_test_add_func ("/chart/data-series/color", test_data_series_color);
     g_test_add_func ("/chart/data-series/line-width", test_data_series_line_width);
     g_test_add_func ("/chart/data-series/marker", test_data_series_marker);
+    g_test_add_func ("/chart/data-series/columnar", test_data_series_columnar);
+    g_test_add_func ("/chart/data-series/ring-buffer", test_data_series_ring_buffer);
+    g_test_add_func ("/chart/data-series/decimate-lttb", test_data_series_decimate_lttb);
+    g_test_add_func ("/chart/data-series/decimate-min-max", test_data_series_decimate_min_max);
+    g_test_add_func ("/chart/data-series/find-nearest", test_data_series_find_nearest);
+    g_test_add_func ("/chart/data-series/find-nearest-rebuild", test_data_series_find_nearest_rebuild);
 
     /* Color Scale tests */
     g_test_add_func ("/chart/color-scale/new", test_color_scale_new);
@@ -990,6 +1315,7 @@ main (int   argc,
     /* Chart property tests */
     g_test_add_func ("/chart/2d/bar/properties", test_bar_chart2d_properties);
     g_test_add_func ("/chart/2d/line/properties", test_line_chart2d_properties);
+    g_test_add_func ("/chart/2d/scatter/hit-test", test_scatter_chart2d_hit_test);
     g_test_add_func ("/chart/2d/pie/properties", test_pie_chart2d_properties);
     g_test_add_func ("/chart/2d/gauge/properties", test_gauge_chart2d_properties);
     /* TODO: Uncomment when implemented
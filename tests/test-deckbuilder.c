@@ -4282,6 +4282,373 @@ test_combat_manager_defeat_check (void)
     g_assert_true (lrg_combat_manager_check_defeat (manager));
 }
 
+/* --------------------------------------------------------------------------
+ * LrgCombatSimulator Tests
+ * -------------------------------------------------------------------------- */
+
+static LrgCardDef *
+sim_card_def_new (const gchar       *id,
+                  gint               cost,
+                  LrgCardTargetType  target,
+                  const gchar       *effect_type,
+                  gint               amount)
+{
+    LrgCardDef *def;
+    LrgCardEffect *effect;
+
+    def = lrg_card_def_new (id);
+    lrg_card_def_set_base_cost (def, cost);
+    lrg_card_def_set_target_type (def, target);
+
+    effect = lrg_card_effect_new (effect_type);
+    lrg_card_effect_set_param_int (effect, "amount", amount);
+    lrg_card_def_add_effect (def, effect);
+
+    return def;
+}
+
+static void
+sim_add_cards (LrgCardPile *pile,
+               LrgCardDef  *def,
+               guint        count)
+{
+    guint i;
+
+    for (i = 0; i < count; i++)
+        lrg_card_pile_add_top (pile, lrg_card_instance_new (def));
+}
+
+/* The starter deck of the combat example against a single enemy */
+static LrgCombatContext *
+sim_context_new (LrgEnemyDef *enemy_def,
+                 gint         enemy_health)
+{
+    g_autoptr(LrgPlayerCombatant) player = NULL;
+    g_autoptr(LrgCardDef) strike = NULL;
+    g_autoptr(LrgCardDef) defend = NULL;
+    g_autoptr(LrgCardDef) bash = NULL;
+    g_autoptr(LrgEnemyInstance) enemy = NULL;
+    LrgCombatContext *ctx;
+    LrgCardEffect *effect;
+    LrgCardPile *draw;
+
+    strike = sim_card_def_new ("strike", 1, LRG_CARD_TARGET_SINGLE_ENEMY, "damage", 6);
+    defend = sim_card_def_new ("defend", 1, LRG_CARD_TARGET_SELF, "block", 5);
+    bash = sim_card_def_new ("bash", 2, LRG_CARD_TARGET_SINGLE_ENEMY, "damage", 8);
+    effect = lrg_card_effect_new ("apply_status");
+    lrg_card_effect_set_param_string (effect, "status", "vulnerable");
+    lrg_card_effect_set_param_int (effect, "stacks", 2);
+    lrg_card_def_add_effect (bash, effect);
+
+    player = lrg_player_combatant_new ("player", "Hero", 80);
+    ctx = lrg_combat_context_new (player, NULL);
+
+    draw = lrg_combat_context_get_draw_pile (ctx);
+    sim_add_cards (draw, strike, 5);
+    sim_add_cards (draw, defend, 4);
+    sim_add_cards (draw, bash, 1);
+
+    enemy = lrg_enemy_instance_new_with_health (enemy_def, enemy_health);
+    lrg_combat_context_add_enemy (ctx, enemy);
+
+    return ctx;
+}
+
+static LrgEnemyDef *
+sim_slime_new (void)
+{
+    LrgEnemyDef *def;
+
+    def = lrg_enemy_def_new ("slime", "Slime");
+    lrg_enemy_def_set_base_health (def, 20);
+    lrg_enemy_def_add_intent_pattern (def, lrg_enemy_intent_new_attack (8, 1), 75);
+    lrg_enemy_def_add_intent_pattern (def, lrg_enemy_intent_new_defend (5), 25);
+
+    return def;
+}
+
+static void
+test_combat_simulator_new (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(GError) error = NULL;
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 20);
+
+    sim = lrg_combat_simulator_new (ctx, &error);
+    g_assert_no_error (error);
+    g_assert_true (LRG_IS_COMBAT_SIMULATOR (sim));
+    g_assert_cmpint (lrg_combat_simulator_get_policy (sim), ==, LRG_COMBAT_SIM_POLICY_GREEDY);
+    g_assert_cmpuint (lrg_combat_simulator_get_max_turns (sim), ==, 50);
+
+    /* The context itself is left alone */
+    g_assert_cmpuint (lrg_card_pile_get_count (lrg_combat_context_get_draw_pile (ctx)), ==, 10);
+}
+
+static void
+test_combat_simulator_deterministic (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCombatSimReport) serial = NULL;
+    g_autoptr(LrgCombatSimReport) parallel = NULL;
+    g_autoptr(LrgCombatSimReport) reseeded = NULL;
+    const guint *a;
+    const guint *b;
+    guint n_a;
+    guint n_b;
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 40);
+    sim = lrg_combat_simulator_new (ctx, NULL);
+    lrg_combat_simulator_set_policy (sim, LRG_COMBAT_SIM_POLICY_RANDOM);
+
+    serial = lrg_combat_simulator_run (sim, 1000, 42, 1);
+    parallel = lrg_combat_simulator_run (sim, 1000, 42, 4);
+
+    /* Same seed, same combats, however many threads ran them */
+    g_assert_cmpuint (lrg_combat_sim_report_get_wins (serial), ==,
+                      lrg_combat_sim_report_get_wins (parallel));
+    g_assert_cmpuint (lrg_combat_sim_report_get_losses (serial), ==,
+                      lrg_combat_sim_report_get_losses (parallel));
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_damage_dealt (serial), ==,
+                       lrg_combat_sim_report_get_mean_damage_dealt (parallel));
+
+    a = lrg_combat_sim_report_get_damage_taken (serial, &n_a);
+    b = lrg_combat_sim_report_get_damage_taken (parallel, &n_b);
+    g_assert_cmpmem (a, n_a * sizeof (guint), b, n_b * sizeof (guint));
+
+    a = lrg_combat_sim_report_get_turns_to_win (serial, &n_a);
+    b = lrg_combat_sim_report_get_turns_to_win (parallel, &n_b);
+    g_assert_cmpmem (a, n_a * sizeof (guint), b, n_b * sizeof (guint));
+
+    /* A different seed plays different combats */
+    reseeded = lrg_combat_simulator_run (sim, 1000, 43, 1);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_damage_taken (serial), !=,
+                       lrg_combat_sim_report_get_mean_damage_taken (reseeded));
+}
+
+static void
+test_combat_simulator_report (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCombatSimReport) report = NULL;
+    g_autoptr(LrgCombatSimReport) copy = NULL;
+    const guint *damage;
+    const guint *turns;
+    guint n_damage;
+    guint n_turns;
+    guint damage_total = 0;
+    guint turns_total = 0;
+    guint i;
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 60);
+    sim = lrg_combat_simulator_new (ctx, NULL);
+
+    report = lrg_combat_simulator_run (sim, 500, 7, 0);
+
+    g_assert_cmpuint (lrg_combat_sim_report_get_combats (report), ==, 500);
+    g_assert_cmpuint (lrg_combat_sim_report_get_wins (report) +
+                      lrg_combat_sim_report_get_losses (report) +
+                      lrg_combat_sim_report_get_timeouts (report), ==, 500);
+
+    damage = lrg_combat_sim_report_get_damage_taken (report, &n_damage);
+    for (i = 0; i < n_damage; i++)
+        damage_total += damage[i];
+    g_assert_cmpuint (damage_total, ==, 500);
+
+    turns = lrg_combat_sim_report_get_turns_to_win (report, &n_turns);
+    for (i = 0; i < n_turns; i++)
+        turns_total += turns[i];
+    g_assert_cmpuint (turns_total, ==, lrg_combat_sim_report_get_wins (report));
+
+    /* Percentiles are ordered and the maximum is the largest bucket */
+    g_assert_cmpint (lrg_combat_sim_report_get_damage_taken_percentile (report, 0.0), <=,
+                     lrg_combat_sim_report_get_damage_taken_percentile (report, 50.0));
+    g_assert_cmpint (lrg_combat_sim_report_get_damage_taken_percentile (report, 50.0), <=,
+                     lrg_combat_sim_report_get_damage_taken_percentile (report, 90.0));
+    g_assert_cmpint (lrg_combat_sim_report_get_damage_taken_percentile (report, 100.0), ==,
+                     (gint)n_damage - 1);
+    g_assert_cmpuint (damage[n_damage - 1], >, 0);
+
+    copy = lrg_combat_sim_report_copy (report);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_win_rate (copy), ==,
+                       lrg_combat_sim_report_get_win_rate (report));
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_damage_taken (copy), ==,
+                       lrg_combat_sim_report_get_mean_damage_taken (report));
+}
+
+static void
+test_combat_simulator_lethal_deck (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCombatSimReport) report = NULL;
+    g_autoptr(LrgCardDef) smite = NULL;
+    g_autoptr(GPtrArray) deck = NULL;
+    g_autoptr(GError) error = NULL;
+    guint i;
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 20);
+    sim = lrg_combat_simulator_new (ctx, NULL);
+
+    /* Every card kills the slime on the first turn */
+    smite = sim_card_def_new ("smite", 1, LRG_CARD_TARGET_SINGLE_ENEMY, "damage", 30);
+    deck = g_ptr_array_new_with_free_func (g_object_unref);
+    for (i = 0; i < 10; i++)
+        g_ptr_array_add (deck, lrg_card_instance_new (smite));
+
+    g_assert_true (lrg_combat_simulator_set_deck (sim, deck, &error));
+    g_assert_no_error (error);
+
+    report = lrg_combat_simulator_run (sim, 100, 1, 1);
+    g_assert_cmpuint (lrg_combat_sim_report_get_wins (report), ==, 100);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_win_rate (report), ==, 1.0);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_turns_to_win (report), ==, 1.0);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_damage_taken (report), ==, 0.0);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_damage_dealt (report), ==, 20.0);
+}
+
+static void
+test_combat_simulator_compare_decks (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCombatSimReport) starter = NULL;
+    g_autoptr(LrgCombatSimReport) turtle = NULL;
+    g_autoptr(LrgCardDef) defend = NULL;
+    g_autoptr(GPtrArray) deck = NULL;
+    guint i;
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 20);
+    sim = lrg_combat_simulator_new (ctx, NULL);
+    lrg_combat_simulator_set_max_turns (sim, 20);
+
+    starter = lrg_combat_simulator_run (sim, 300, 5, 0);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_win_rate (starter), >, 0.9);
+
+    /* A deck that only blocks never wins and never loses */
+    defend = sim_card_def_new ("defend", 1, LRG_CARD_TARGET_SELF, "block", 5);
+    deck = g_ptr_array_new_with_free_func (g_object_unref);
+    for (i = 0; i < 10; i++)
+        g_ptr_array_add (deck, lrg_card_instance_new (defend));
+    g_assert_true (lrg_combat_simulator_set_deck (sim, deck, NULL));
+
+    turtle = lrg_combat_simulator_run (sim, 300, 5, 0);
+    g_assert_cmpuint (lrg_combat_sim_report_get_wins (turtle), ==, 0);
+    g_assert_cmpuint (lrg_combat_sim_report_get_timeouts (turtle), ==, 300);
+    g_assert_cmpfloat (lrg_combat_sim_report_get_mean_damage_taken (turtle), ==, 0.0);
+}
+
+static gint
+sim_pass_policy (const LrgCombatSimState *state,
+                 guint                   *target,
+                 gpointer                 user_data)
+{
+    guint *calls = user_data;
+
+    g_assert_cmpuint (lrg_combat_sim_state_get_hand_size (state), ==, 5);
+    g_assert_cmpint (lrg_combat_sim_state_get_energy (state), ==, 3);
+    g_assert_cmpuint (lrg_combat_sim_state_get_enemy_count (state), ==, 1);
+    g_assert_nonnull (lrg_combat_sim_state_get_enemy_intent (state, 0));
+    g_assert_nonnull (lrg_combat_sim_state_get_hand_card (state, 0));
+    g_assert_true (lrg_combat_sim_state_can_play (state, 0));
+
+    (*calls)++;
+
+    return -1;
+}
+
+static void
+test_combat_simulator_scripted (void)
+{
+    g_autoptr(LrgEnemyDef) goblin = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCombatSimReport) report = NULL;
+    const guint *damage;
+    guint n_damage;
+    guint calls = 0;
+
+    goblin = lrg_enemy_def_new ("goblin", "Goblin");
+    lrg_enemy_def_add_intent_pattern (goblin, lrg_enemy_intent_new_attack (12, 1), 100);
+    ctx = sim_context_new (goblin, 25);
+    sim = lrg_combat_simulator_new (ctx, NULL);
+
+    /* Never playing a card: 12 damage a turn kills the player on turn 7 */
+    lrg_combat_simulator_set_policy_func (sim, sim_pass_policy, &calls, NULL);
+    g_assert_cmpint (lrg_combat_simulator_get_policy (sim), ==, LRG_COMBAT_SIM_POLICY_SCRIPTED);
+
+    report = lrg_combat_simulator_run (sim, 10, 3, 1);
+    g_assert_cmpuint (lrg_combat_sim_report_get_losses (report), ==, 10);
+    g_assert_cmpuint (calls, ==, 70);
+
+    damage = lrg_combat_sim_report_get_damage_taken (report, &n_damage);
+    g_assert_cmpuint (n_damage, ==, 81);
+    g_assert_cmpuint (damage[80], ==, 10);
+}
+
+static void
+test_combat_simulator_unknown_effect (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCardDef) transform = NULL;
+    g_autoptr(GError) error = NULL;
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 20);
+
+    transform = sim_card_def_new ("transform", 1, LRG_CARD_TARGET_NONE, "transform", 1);
+    lrg_card_pile_add_top (lrg_combat_context_get_draw_pile (ctx),
+                           lrg_card_instance_new (transform));
+
+    sim = lrg_combat_simulator_new (ctx, &error);
+    g_assert_null (sim);
+    g_assert_error (error, LRG_DECKBUILDER_ERROR, LRG_DECKBUILDER_ERROR_EXECUTOR_NOT_FOUND);
+}
+
+static void
+test_combat_simulator_perf (void)
+{
+    g_autoptr(LrgEnemyDef) slime = NULL;
+    g_autoptr(LrgCombatContext) ctx = NULL;
+    g_autoptr(LrgCombatSimulator) sim = NULL;
+    g_autoptr(LrgCombatSimReport) report = NULL;
+    g_autoptr(GTimer) timer = NULL;
+    gdouble elapsed;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    slime = sim_slime_new ();
+    ctx = sim_context_new (slime, 20);
+    sim = lrg_combat_simulator_new (ctx, NULL);
+
+    timer = g_timer_new ();
+    report = lrg_combat_simulator_run (sim, 100000, 1, 0);
+    elapsed = g_timer_elapsed (timer, NULL);
+
+    g_test_minimized_result (elapsed, "100000 greedy combats: %.3f s (%.0f combats/s, win rate %.3f)",
+                             elapsed, 100000 / elapsed,
+                             lrg_combat_sim_report_get_win_rate (report));
+}
+
 /* ==========================================================================
  * Phase 6.5: Run/Map System Tests
  * ========================================================================== */
@@ -5103,6 +5470,337 @@ test_scoring_hand_chip_values (void)
     g_assert_cmpint (lrg_scoring_hand_get_chip_value (LRG_CARD_RANK_TWO), ==, 2);
 }
 
+/*
+ * Reference hand classification: counts every rank and suit, then tests
+ * each hand type from the strongest down. The table-driven evaluator
+ * must agree with it on every hand.
+ */
+static LrgHandType
+reference_hand_type (const LrgCardRank *ranks,
+                     const LrgCardSuit *suits,
+                     const gboolean    *wild,
+                     guint              n_cards)
+{
+    gint rank_counts[14] = { 0 };
+    gint suit_counts[5] = { 0 };
+    gint pairs = 0;
+    gint threes = 0;
+    gint fours = 0;
+    gint fives = 0;
+    gboolean flush = FALSE;
+    gboolean straight = FALSE;
+    gboolean ace_high = FALSE;
+    gint run = 0;
+    guint i;
+    gint s;
+
+    if (n_cards == 0)
+        return LRG_HAND_TYPE_NONE;
+
+    for (i = 0; i < n_cards; i++)
+    {
+        if (ranks[i] > 0 && ranks[i] <= 13)
+            rank_counts[ranks[i]]++;
+        if (suits[i] > 0 && suits[i] <= 4)
+            suit_counts[suits[i]]++;
+        if (wild[i])
+        {
+            for (s = 1; s <= 4; s++)
+            {
+                if (s != (gint)suits[i])
+                    suit_counts[s]++;
+            }
+        }
+    }
+
+    for (s = 1; s <= 13; s++)
+    {
+        pairs += rank_counts[s] == 2;
+        threes += rank_counts[s] == 3;
+        fours += rank_counts[s] == 4;
+        fives += rank_counts[s] == 5;
+
+        run = rank_counts[s] > 0 ? run + 1 : 0;
+        straight |= run >= 5;
+    }
+
+    for (s = 1; s <= 4; s++)
+        flush |= suit_counts[s] >= 5;
+
+    ace_high = rank_counts[1] > 0 && rank_counts[10] > 0 && rank_counts[11] > 0 &&
+               rank_counts[12] > 0 && rank_counts[13] > 0;
+    straight |= ace_high;
+
+    if (fives > 0 && flush)
+        return LRG_HAND_TYPE_FLUSH_FIVE;
+    if (threes > 0 && pairs > 0 && flush)
+        return LRG_HAND_TYPE_FLUSH_HOUSE;
+    if (fives > 0)
+        return LRG_HAND_TYPE_FIVE_OF_A_KIND;
+    if (flush && ace_high)
+        return LRG_HAND_TYPE_ROYAL_FLUSH;
+    if (flush && straight)
+        return LRG_HAND_TYPE_STRAIGHT_FLUSH;
+    if (fours > 0)
+        return LRG_HAND_TYPE_FOUR_OF_A_KIND;
+    if (threes > 0 && pairs > 0)
+        return LRG_HAND_TYPE_FULL_HOUSE;
+    if (flush)
+        return LRG_HAND_TYPE_FLUSH;
+    if (straight)
+        return LRG_HAND_TYPE_STRAIGHT;
+    if (threes > 0)
+        return LRG_HAND_TYPE_THREE_OF_A_KIND;
+    if (pairs >= 2)
+        return LRG_HAND_TYPE_TWO_PAIR;
+    if (pairs == 1)
+        return LRG_HAND_TYPE_PAIR;
+
+    return LRG_HAND_TYPE_HIGH_CARD;
+}
+
+/* The 52 cards of a deck, then the same 52 tagged wild */
+static GPtrArray *
+create_poker_deck (void)
+{
+    GPtrArray *deck;
+    gint wild;
+    gint suit;
+    gint rank;
+
+    deck = g_ptr_array_new_with_free_func (g_object_unref);
+
+    for (wild = 0; wild < 2; wild++)
+    {
+        for (suit = LRG_CARD_SUIT_SPADES; suit <= LRG_CARD_SUIT_CLUBS; suit++)
+        {
+            for (rank = LRG_CARD_RANK_ACE; rank <= LRG_CARD_RANK_KING; rank++)
+            {
+                LrgCardInstance *card = create_poker_card (rank, suit);
+
+                if (wild)
+                    lrg_card_def_add_tag (lrg_card_instance_get_def (card), "wild");
+                g_ptr_array_add (deck, card);
+            }
+        }
+    }
+
+    return deck;
+}
+
+static void
+test_scoring_hand_all_five_card_hands (void)
+{
+    g_autoptr(LrgScoringHand) hand = NULL;
+    g_autoptr(GPtrArray) deck = NULL;
+    g_autoptr(GPtrArray) cards = NULL;
+    LrgCardRank ranks[5];
+    LrgCardSuit suits[5];
+    gboolean wild[5];
+    guint8 packed[5];
+    guint counts[LRG_HAND_TYPE_FLUSH_FIVE + 1] = { 0 };
+    guint n_hands = 0;
+    guint idx[5];
+    guint i;
+
+    hand = lrg_scoring_hand_new ();
+    deck = create_poker_deck ();
+    cards = g_ptr_array_new ();
+    g_ptr_array_set_size (cards, 5);
+
+    /*
+     * Every 5-card hand, once as dealt and once with some cards wild.
+     * The wild cards cycle through all 32 subsets of the hand.
+     */
+    for (idx[0] = 0; idx[0] < 52; idx[0]++)
+    for (idx[1] = idx[0] + 1; idx[1] < 52; idx[1]++)
+    for (idx[2] = idx[1] + 1; idx[2] < 52; idx[2]++)
+    for (idx[3] = idx[2] + 1; idx[3] < 52; idx[3]++)
+    for (idx[4] = idx[3] + 1; idx[4] < 52; idx[4]++)
+    {
+        guint wild_mask = n_hands % 32;
+        LrgHandType type;
+        gint pass;
+
+        for (pass = 0; pass < 2; pass++)
+        {
+            for (i = 0; i < 5; i++)
+            {
+                guint card = idx[i];
+
+                wild[i] = pass == 1 && (wild_mask & (1u << i)) != 0;
+                if (wild[i])
+                    card += 52;
+
+                g_ptr_array_index (cards, i) = g_ptr_array_index (deck, card);
+                ranks[i] = (LrgCardRank)(idx[i] % 13 + 1);
+                suits[i] = (LrgCardSuit)(idx[i] / 13 + 1);
+                packed[i] = lrg_scoring_hand_pack (ranks[i], suits[i], wild[i]);
+            }
+
+            lrg_scoring_hand_set_cards (hand, cards);
+            type = lrg_scoring_hand_evaluate (hand);
+            g_assert_cmpint (lrg_scoring_hand_evaluate_packed (packed, 5), ==, type);
+
+            if (type != reference_hand_type (ranks, suits, wild, 5))
+            {
+                g_test_message ("hand %u %u %u %u %u (wild mask %u): got %d, expected %d",
+                                idx[0], idx[1], idx[2], idx[3], idx[4], pass ? wild_mask : 0,
+                                type, reference_hand_type (ranks, suits, wild, 5));
+                g_assert_not_reached ();
+            }
+
+            if (pass == 0)
+                counts[type]++;
+        }
+
+        n_hands++;
+    }
+
+    g_assert_cmpuint (n_hands, ==, 2598960);
+    g_assert_cmpuint (lrg_scoring_hand_get_scoring_cards (hand)->len, ==, 5);
+
+    /* The well-known frequencies of a 52-card deck */
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_ROYAL_FLUSH], ==, 4);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_STRAIGHT_FLUSH], ==, 36);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_FOUR_OF_A_KIND], ==, 624);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_FULL_HOUSE], ==, 3744);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_FLUSH], ==, 5108);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_STRAIGHT], ==, 10200);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_THREE_OF_A_KIND], ==, 54912);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_TWO_PAIR], ==, 123552);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_PAIR], ==, 1098240);
+    g_assert_cmpuint (counts[LRG_HAND_TYPE_HIGH_CARD], ==, 1302540);
+}
+
+static void
+test_scoring_hand_any_size (void)
+{
+    g_autoptr(LrgScoringHand) hand = NULL;
+    g_autoptr(GPtrArray) deck = NULL;
+    g_autoptr(GPtrArray) cards = NULL;
+    g_autoptr(GRand) rand = NULL;
+    LrgCardRank ranks[10];
+    LrgCardSuit suits[10];
+    gboolean wild[10];
+    guint8 packed[10];
+    guint iter;
+    guint i;
+
+    hand = lrg_scoring_hand_new ();
+    deck = create_poker_deck ();
+    cards = g_ptr_array_new ();
+    rand = g_rand_new_with_seed (49);
+
+    g_assert_cmpint (lrg_scoring_hand_evaluate (hand), ==, LRG_HAND_TYPE_NONE);
+
+    /*
+     * Hands of up to ten cards drawn with repeats, so five and six of
+     * a kind come up, from few ranks so flushes and straights do too.
+     */
+    for (iter = 0; iter < 200000; iter++)
+    {
+        guint n_cards = (guint)g_rand_int_range (rand, 0, 11);
+        guint n_ranks = (guint)g_rand_int_range (rand, 1, 14);
+        guint first_rank = (guint)g_rand_int_range (rand, 0, 14 - n_ranks);
+
+        g_ptr_array_set_size (cards, n_cards);
+
+        for (i = 0; i < n_cards; i++)
+        {
+            guint rank = first_rank + (guint)g_rand_int_range (rand, 0, n_ranks);
+            guint suit = (guint)g_rand_int_range (rand, 0, 4);
+            guint card = suit * 13 + rank;
+
+            wild[i] = g_rand_int_range (rand, 0, 4) == 0;
+            if (wild[i])
+                card += 52;
+
+            g_ptr_array_index (cards, i) = g_ptr_array_index (deck, card);
+            ranks[i] = (LrgCardRank)(rank + 1);
+            suits[i] = (LrgCardSuit)(suit + 1);
+            packed[i] = lrg_scoring_hand_pack_card (g_ptr_array_index (cards, i));
+        }
+
+        lrg_scoring_hand_set_cards (hand, cards);
+        g_assert_cmpint (lrg_scoring_hand_evaluate (hand), ==,
+                         reference_hand_type (ranks, suits, wild, n_cards));
+        g_assert_cmpint (lrg_scoring_hand_evaluate_packed (packed, n_cards), ==,
+                         reference_hand_type (ranks, suits, wild, n_cards));
+        g_assert_cmpuint (lrg_scoring_hand_get_scoring_cards (hand)->len, ==, n_cards);
+    }
+}
+
+static void
+test_scoring_hand_perf (void)
+{
+    g_autoptr(LrgScoringHand) hand = NULL;
+    g_autoptr(GPtrArray) deck = NULL;
+    g_autoptr(GPtrArray) cards = NULL;
+    g_autoptr(GRand) rand = NULL;
+    g_autoptr(GTimer) timer = NULL;
+    guint hands[1024][5];
+    guint8 packed_deck[104];
+    guint8 packed[5];
+    guint checksum = 0;
+    gdouble elapsed;
+    gdouble packed_elapsed;
+    guint iter;
+    guint i;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    hand = lrg_scoring_hand_new ();
+    deck = create_poker_deck ();
+    cards = g_ptr_array_new ();
+    g_ptr_array_set_size (cards, 5);
+    rand = g_rand_new_with_seed (1);
+
+    for (iter = 0; iter < G_N_ELEMENTS (hands); iter++)
+    {
+        for (i = 0; i < 5; i++)
+            hands[iter][i] = (guint)g_rand_int_range (rand, 0, 52);
+    }
+
+    timer = g_timer_new ();
+    for (iter = 0; iter < 1000000; iter++)
+    {
+        const guint *h = hands[iter % G_N_ELEMENTS (hands)];
+
+        for (i = 0; i < 5; i++)
+            g_ptr_array_index (cards, i) = g_ptr_array_index (deck, h[i]);
+
+        lrg_scoring_hand_set_cards (hand, cards);
+        checksum += lrg_scoring_hand_evaluate (hand);
+    }
+    elapsed = g_timer_elapsed (timer, NULL);
+
+    for (i = 0; i < deck->len; i++)
+        packed_deck[i] = lrg_scoring_hand_pack_card (g_ptr_array_index (deck, i));
+
+    g_timer_start (timer);
+    for (iter = 0; iter < 1000000; iter++)
+    {
+        const guint *h = hands[iter % G_N_ELEMENTS (hands)];
+
+        for (i = 0; i < 5; i++)
+            packed[i] = packed_deck[h[i]];
+
+        checksum += lrg_scoring_hand_evaluate_packed (packed, 5);
+    }
+    packed_elapsed = g_timer_elapsed (timer, NULL);
+
+    g_assert_cmpuint (checksum, >, 0);
+    g_test_minimized_result (elapsed, "1000000 hand evaluations: %.3f s (%.0f hands/s)",
+                             elapsed, 1000000 / elapsed);
+    g_test_minimized_result (packed_elapsed, "1000000 packed hand evaluations: %.3f s (%.0f hands/s)",
+                             packed_elapsed, 1000000 / packed_elapsed);
+}
+
 /* --- LrgScoringContext tests --- */
 
 static void
@@ -6556,6 +7254,16 @@ main (int   argc,
     g_test_add_func ("/deckbuilder/combat-manager/victory-check", test_combat_manager_victory_check);
     g_test_add_func ("/deckbuilder/combat-manager/defeat-check", test_combat_manager_defeat_check);
 
+    /* LrgCombatSimulator tests */
+    g_test_add_func ("/deckbuilder/combat-simulator/new", test_combat_simulator_new);
+    g_test_add_func ("/deckbuilder/combat-simulator/deterministic", test_combat_simulator_deterministic);
+    g_test_add_func ("/deckbuilder/combat-simulator/report", test_combat_simulator_report);
+    g_test_add_func ("/deckbuilder/combat-simulator/lethal-deck", test_combat_simulator_lethal_deck);
+    g_test_add_func ("/deckbuilder/combat-simulator/compare-decks", test_combat_simulator_compare_decks);
+    g_test_add_func ("/deckbuilder/combat-simulator/scripted", test_combat_simulator_scripted);
+    g_test_add_func ("/deckbuilder/combat-simulator/unknown-effect", test_combat_simulator_unknown_effect);
+    g_test_add_func ("/deckbuilder/combat-simulator/perf", test_combat_simulator_perf);
+
     /* Phase 6.5: Run/Map System Tests */
     g_test_add_func ("/deckbuilder/map-node/new", test_map_node_new);
     g_test_add_func ("/deckbuilder/map-node/types", test_map_node_types);
@@ -6596,6 +7304,9 @@ main (int   argc,
     g_test_add_func ("/deckbuilder/scoring-hand/four-of-a-kind", test_scoring_hand_four_of_a_kind);
     g_test_add_func ("/deckbuilder/scoring-hand/straight-flush", test_scoring_hand_straight_flush);
     g_test_add_func ("/deckbuilder/scoring-hand/chip-values", test_scoring_hand_chip_values);
+    g_test_add_func ("/deckbuilder/scoring-hand/all-five-card-hands", test_scoring_hand_all_five_card_hands);
+    g_test_add_func ("/deckbuilder/scoring-hand/any-size", test_scoring_hand_any_size);
+    g_test_add_func ("/deckbuilder/scoring-hand/perf", test_scoring_hand_perf);
     g_test_add_func ("/deckbuilder/scoring-context/new", test_scoring_context_new);
     g_test_add_func ("/deckbuilder/scoring-context/chips", test_scoring_context_chips);
     g_test_add_func ("/deckbuilder/scoring-context/mult", test_scoring_context_mult);
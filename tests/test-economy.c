@@ -9,6 +9,7 @@
 
 #include <glib.h>
 #include <libregnum.h>
+#include <math.h>
 
 /* ==========================================================================
  * Test Fixtures
@@ -1116,6 +1117,283 @@ test_offline_calculator_producers (void)
     g_assert_cmpuint (lrg_offline_calculator_get_producer_count (calc), ==, 0);
 }
 
+/* ==========================================================================
+ * LrgOfflineCalculator Production Graph Tests
+ *
+ * Each graph is built twice: once ticked producer by producer the way a
+ * running game would, restarting idle producers every tick, and once
+ * solved by the calculator. The two must end up with the same stocks,
+ * give or take the batches still in progress when ticking stops.
+ * ========================================================================== */
+
+#define GRAPH_TICK (0.25)
+
+typedef void (*GraphBuildFunc) (LrgResourcePool *pool,
+                                GPtrArray       *producers);
+
+static LrgResource *
+graph_resource (const gchar *id,
+                gdouble      max_value)
+{
+    LrgResource *resource = lrg_resource_new (id);
+
+    lrg_resource_set_max_value (resource, max_value);
+    return resource;
+}
+
+static LrgProductionRecipe *
+graph_recipe (GPtrArray       *producers,
+              LrgResourcePool *pool,
+              const gchar     *id,
+              gdouble          production_time)
+{
+    g_autoptr(LrgProducer) producer = NULL;
+    g_autoptr(LrgProductionRecipe) recipe = NULL;
+
+    recipe = lrg_production_recipe_new (id);
+    lrg_production_recipe_set_production_time (recipe, production_time);
+
+    producer = lrg_producer_new_with_recipe (recipe, pool);
+    lrg_producer_set_auto_restart (producer, TRUE);
+    g_ptr_array_add (producers, g_steal_pointer (&producer));
+
+    return recipe;
+}
+
+/* Miner: 1 ore / 2s; smelter: 2 ore -> 1 bar / 3s, starved by the miner */
+static void
+build_chain (LrgResourcePool *pool,
+             GPtrArray       *producers)
+{
+    g_autoptr(LrgResource) ore = graph_resource ("ore", G_MAXDOUBLE);
+    g_autoptr(LrgResource) bar = graph_resource ("bar", G_MAXDOUBLE);
+    LrgProductionRecipe *recipe;
+
+    recipe = graph_recipe (producers, pool, "mine", 2.0);
+    lrg_production_recipe_add_output (recipe, ore, 1.0, 1.0);
+
+    recipe = graph_recipe (producers, pool, "smelt", 3.0);
+    lrg_production_recipe_add_input (recipe, ore, 2.0);
+    lrg_production_recipe_add_output (recipe, bar, 1.0, 1.0);
+}
+
+/* Ore and coal into one smelter; ore runs short, coal piles up */
+static void
+build_fan_in (LrgResourcePool *pool,
+              GPtrArray       *producers)
+{
+    g_autoptr(LrgResource) ore = graph_resource ("ore", G_MAXDOUBLE);
+    g_autoptr(LrgResource) coal = graph_resource ("coal", G_MAXDOUBLE);
+    g_autoptr(LrgResource) steel = graph_resource ("steel", G_MAXDOUBLE);
+    LrgProductionRecipe *recipe;
+
+    recipe = graph_recipe (producers, pool, "mine", 1.0);
+    lrg_production_recipe_add_output (recipe, ore, 1.0, 1.0);
+
+    recipe = graph_recipe (producers, pool, "dig", 1.0);
+    lrg_production_recipe_add_output (recipe, coal, 1.0, 1.0);
+
+    recipe = graph_recipe (producers, pool, "smelt", 1.0);
+    lrg_production_recipe_add_input (recipe, ore, 2.0);
+    lrg_production_recipe_add_input (recipe, coal, 1.0);
+    lrg_production_recipe_add_output (recipe, steel, 1.0, 1.0);
+}
+
+/* The miner outpaces the smelter; ore and then bars hit their caps */
+static void
+build_capped (LrgResourcePool *pool,
+              GPtrArray       *producers)
+{
+    g_autoptr(LrgResource) ore = graph_resource ("ore", 50.0);
+    g_autoptr(LrgResource) bar = graph_resource ("bar", 1000.0);
+    LrgProductionRecipe *recipe;
+
+    recipe = graph_recipe (producers, pool, "mine", 1.0);
+    lrg_production_recipe_add_output (recipe, ore, 2.0, 1.0);
+
+    recipe = graph_recipe (producers, pool, "smelt", 1.0);
+    lrg_production_recipe_add_input (recipe, ore, 1.0);
+    lrg_production_recipe_add_output (recipe, bar, 1.0, 1.0);
+}
+
+/* No miner: the smelter works through the ore in stock, then stops */
+static void
+build_starved (LrgResourcePool *pool,
+               GPtrArray       *producers)
+{
+    g_autoptr(LrgResource) ore = graph_resource ("ore", G_MAXDOUBLE);
+    g_autoptr(LrgResource) bar = graph_resource ("bar", G_MAXDOUBLE);
+    g_autoptr(LrgResource) tool = graph_resource ("tool", G_MAXDOUBLE);
+    LrgProductionRecipe *recipe;
+
+    lrg_resource_pool_set (pool, ore, 300.0);
+
+    recipe = graph_recipe (producers, pool, "smelt", 2.0);
+    lrg_production_recipe_add_input (recipe, ore, 2.0);
+    lrg_production_recipe_add_output (recipe, bar, 1.0, 1.0);
+
+    recipe = graph_recipe (producers, pool, "forge", 4.0);
+    lrg_production_recipe_add_input (recipe, bar, 1.0);
+    lrg_production_recipe_add_output (recipe, tool, 1.0, 1.0);
+}
+
+/* Water boils into steam and comes back from the turbine */
+static void
+build_loop (LrgResourcePool *pool,
+            GPtrArray       *producers)
+{
+    g_autoptr(LrgResource) water = graph_resource ("water", G_MAXDOUBLE);
+    g_autoptr(LrgResource) steam = graph_resource ("steam", G_MAXDOUBLE);
+    g_autoptr(LrgResource) power = graph_resource ("power", G_MAXDOUBLE);
+    LrgProductionRecipe *recipe;
+
+    lrg_resource_pool_set (pool, water, 5.0);
+
+    recipe = graph_recipe (producers, pool, "boil", 1.0);
+    lrg_production_recipe_add_input (recipe, water, 1.0);
+    lrg_production_recipe_add_output (recipe, steam, 1.0, 1.0);
+
+    recipe = graph_recipe (producers, pool, "turn", 2.0);
+    lrg_production_recipe_add_input (recipe, steam, 1.0);
+    lrg_production_recipe_add_output (recipe, water, 1.0, 1.0);
+    lrg_production_recipe_add_output (recipe, power, 1.0, 1.0);
+}
+
+static void
+tick_producers (GPtrArray *producers,
+                gdouble    duration)
+{
+    guint ticks = (guint)(duration / GRAPH_TICK);
+    guint t;
+    guint i;
+
+    for (t = 0; t < ticks; t++)
+    {
+        for (i = 0; i < producers->len; i++)
+        {
+            LrgProducer *producer = g_ptr_array_index (producers, i);
+
+            if (!lrg_producer_get_is_producing (producer))
+                lrg_producer_start (producer);
+            lrg_component_update (LRG_COMPONENT (producer), GRAPH_TICK);
+        }
+    }
+}
+
+static void
+assert_graph_matches_ticking (GraphBuildFunc      build,
+                              gdouble             duration,
+                              gdouble             tolerance,
+                              const gchar * const *ids)
+{
+    g_autoptr(LrgOfflineCalculator) calc = NULL;
+    g_autoptr(LrgResourcePool) ticked = NULL;
+    g_autoptr(LrgResourcePool) solved = NULL;
+    g_autoptr(GPtrArray) ticked_producers = NULL;
+    g_autoptr(GPtrArray) solved_producers = NULL;
+    guint i;
+
+    ticked = lrg_resource_pool_new ();
+    ticked_producers = g_ptr_array_new_with_free_func (g_object_unref);
+    build (ticked, ticked_producers);
+    tick_producers (ticked_producers, duration);
+
+    solved = lrg_resource_pool_new ();
+    solved_producers = g_ptr_array_new_with_free_func (g_object_unref);
+    build (solved, solved_producers);
+
+    calc = lrg_offline_calculator_new ();
+    for (i = 0; i < solved_producers->len; i++)
+        lrg_offline_calculator_add_producer (calc, g_ptr_array_index (solved_producers, i));
+    lrg_offline_calculator_advance (calc, duration);
+
+    for (i = 0; ids[i] != NULL; i++)
+    {
+        gdouble expected = lrg_resource_pool_get_by_id (ticked, ids[i]);
+        gdouble actual = lrg_resource_pool_get_by_id (solved, ids[i]);
+
+        if (fabs (expected - actual) > tolerance)
+        {
+            g_error ("%s: ticked %.3f, solved %.3f (tolerance %.3f)",
+                     ids[i], expected, actual, tolerance);
+        }
+    }
+}
+
+static void
+test_offline_calculator_graph_chain (void)
+{
+    const gchar *ids[] = { "ore", "bar", NULL };
+
+    assert_graph_matches_ticking (build_chain, 3600.0, 3.0, ids);
+}
+
+static void
+test_offline_calculator_graph_fan_in (void)
+{
+    const gchar *ids[] = { "ore", "coal", "steel", NULL };
+
+    assert_graph_matches_ticking (build_fan_in, 3600.0, 3.0, ids);
+}
+
+static void
+test_offline_calculator_graph_capped (void)
+{
+    const gchar *ids[] = { "ore", "bar", NULL };
+
+    assert_graph_matches_ticking (build_capped, 600.0, 3.0, ids);
+    assert_graph_matches_ticking (build_capped, 3600.0, 3.0, ids);
+}
+
+static void
+test_offline_calculator_graph_starved (void)
+{
+    const gchar *ids[] = { "ore", "bar", "tool", NULL };
+
+    assert_graph_matches_ticking (build_starved, 200.0, 3.0, ids);
+    assert_graph_matches_ticking (build_starved, 3600.0, 3.0, ids);
+}
+
+static void
+test_offline_calculator_graph_loop (void)
+{
+    const gchar *ids[] = { "water", "steam", "power", NULL };
+
+    assert_graph_matches_ticking (build_loop, 3600.0, 3.0, ids);
+}
+
+static void
+test_offline_calculator_graph_long (void)
+{
+    g_autoptr(LrgOfflineCalculator) calc = NULL;
+    g_autoptr(LrgResourcePool) pool = NULL;
+    g_autoptr(LrgResourcePool) gains = NULL;
+    g_autoptr(GPtrArray) producers = NULL;
+    gdouble duration = 72.0 * 3600.0;
+    guint i;
+
+    pool = lrg_resource_pool_new ();
+    producers = g_ptr_array_new_with_free_func (g_object_unref);
+    build_starved (pool, producers);
+
+    calc = lrg_offline_calculator_new ();
+    for (i = 0; i < producers->len; i++)
+        lrg_offline_calculator_add_producer (calc, g_ptr_array_index (producers, i));
+
+    /* 300 ore make 150 bars, which make 150 tools */
+    gains = lrg_resource_pool_new ();
+    lrg_offline_calculator_calculate_duration (calc, duration, gains);
+    g_assert_cmpfloat_with_epsilon (lrg_resource_pool_get_by_id (gains, "tool"), 150.0, 1e-9);
+    g_assert_cmpfloat_with_epsilon (lrg_resource_pool_get_by_id (gains, "bar"), 0.0, 1e-9);
+    g_assert_cmpfloat_with_epsilon (lrg_resource_pool_get_by_id (gains, "ore"), 0.0, 1e-9);
+    g_assert_cmpfloat (lrg_resource_pool_get_by_id (pool, "ore"), ==, 300.0);
+
+    lrg_offline_calculator_advance (calc, duration);
+    g_assert_cmpfloat_with_epsilon (lrg_resource_pool_get_by_id (pool, "ore"), 0.0, 1e-9);
+    g_assert_cmpfloat_with_epsilon (lrg_resource_pool_get_by_id (pool, "bar"), 0.0, 1e-9);
+    g_assert_cmpfloat_with_epsilon (lrg_resource_pool_get_by_id (pool, "tool"), 150.0, 1e-9);
+}
+
 /* ==========================================================================
  * Main
  * ========================================================================== */
@@ -1206,6 +1484,12 @@ main (int   argc,
     g_test_add ("/economy/offline-calculator/efficiency", EconomyFixture, NULL,
                 economy_fixture_set_up, test_offline_calculator_efficiency, economy_fixture_tear_down);
     g_test_add_func ("/economy/offline-calculator/producers", test_offline_calculator_producers);
+    g_test_add_func ("/economy/offline-calculator/graph/chain", test_offline_calculator_graph_chain);
+    g_test_add_func ("/economy/offline-calculator/graph/fan-in", test_offline_calculator_graph_fan_in);
+    g_test_add_func ("/economy/offline-calculator/graph/capped", test_offline_calculator_graph_capped);
+    g_test_add_func ("/economy/offline-calculator/graph/starved", test_offline_calculator_graph_starved);
+    g_test_add_func ("/economy/offline-calculator/graph/loop", test_offline_calculator_graph_loop);
+    g_test_add_func ("/economy/offline-calculator/graph/long", test_offline_calculator_graph_long);
 
     return g_test_run ();
 }
@@ -1411,6 +1411,259 @@ test_renderer_type (void)
     g_assert_true (G_TYPE_IS_OBJECT (type));
 }
 
+/* ==========================================================================
+ * Test Cases - Render Queue
+ * ========================================================================== */
+
+static void
+submit_test_sprite (LrgRenderer *renderer,
+                    guint64      key,
+                    gfloat       x)
+{
+    GrlRectangle source = { 0.0f, 0.0f, 16.0f, 16.0f };
+    GrlRectangle dest = { x, 0.0f, 16.0f, 16.0f };
+
+    lrg_renderer_submit_sprite (renderer, key, NULL, NULL, &source, &dest,
+                                NULL, 0.0f, NULL);
+}
+
+static void
+test_render_queue_sort_key (void)
+{
+    /* Sort layer outranks every other field */
+    g_assert_cmpuint (lrg_renderer_pack_sort_key (0, 15, 4095, 65535, 1000.0f), <,
+                      lrg_renderer_pack_sort_key (1, 0, 0, 0, -1000.0f));
+
+    /* State outranks depth */
+    g_assert_cmpuint (lrg_renderer_pack_sort_key (0, 0, 0, 1, 1000.0f), <,
+                      lrg_renderer_pack_sort_key (0, 0, 0, 2, -1000.0f));
+    g_assert_cmpuint (lrg_renderer_pack_sort_key (0, 0, 1, 0, 0.0f), <,
+                      lrg_renderer_pack_sort_key (0, 1, 0, 0, 0.0f));
+
+    /* Depth orders like a float, negatives included */
+    g_assert_cmpuint (lrg_renderer_pack_sort_key (0, 0, 0, 0, -2.0f), <,
+                      lrg_renderer_pack_sort_key (0, 0, 0, 0, -1.0f));
+    g_assert_cmpuint (lrg_renderer_pack_sort_key (0, 0, 0, 0, -1.0f), <,
+                      lrg_renderer_pack_sort_key (0, 0, 0, 0, 0.0f));
+    g_assert_cmpuint (lrg_renderer_pack_sort_key (0, 0, 0, 0, 0.5f), <,
+                      lrg_renderer_pack_sort_key (0, 0, 0, 0, 2.0f));
+}
+
+static void
+test_render_queue_batching (void)
+{
+    g_autoptr(LrgRecordingRenderer) recorder = lrg_recording_renderer_new ();
+    LrgRenderer          *renderer = LRG_RENDERER (recorder);
+    const LrgRenderBatch *batch;
+    guint                 i;
+    guint                 j;
+
+    lrg_renderer_begin_frame (renderer);
+    lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_WORLD);
+
+    /* Alternate two textures, depth decreasing with submission order */
+    for (i = 0; i < 100; i++)
+    {
+        guint64 key = lrg_renderer_pack_sort_key (0, 0, 0, 1 + i % 2, 100.0f - i);
+
+        submit_test_sprite (renderer, key, (gfloat)i);
+    }
+
+    /* Nothing is drawn before the layer ends */
+    g_assert_cmpuint (lrg_recording_renderer_get_n_batches (recorder), ==, 0);
+
+    lrg_renderer_end_layer (renderer);
+    lrg_renderer_end_frame (renderer);
+
+    g_assert_cmpuint (lrg_recording_renderer_get_n_batches (recorder), ==, 2);
+    g_assert_cmpuint (lrg_renderer_get_batch_count (renderer), ==, 2);
+    g_assert_cmpuint (lrg_renderer_get_sprite_count (renderer), ==, 100);
+
+    for (j = 0; j < 2; j++)
+    {
+        batch = lrg_recording_renderer_get_batch (recorder, j);
+        g_assert_cmpint (batch->layer, ==, LRG_RENDER_LAYER_WORLD);
+        g_assert_null (batch->drawable);
+        g_assert_cmpuint (batch->n_sprites, ==, 50);
+
+        /* Texture 1 has the even sprites; lowest depth, i.e. latest, first */
+        for (i = 0; i < 50; i++)
+        {
+            gfloat expected = (gfloat)(98 - 2 * i + j);
+
+            g_assert_cmpfloat (batch->sprites[i].dest.x, ==, expected);
+            g_assert_cmpuint (batch->sprites[i].tint.a, ==, 255);
+        }
+    }
+
+    /* A new frame starts a new recording */
+    lrg_renderer_begin_frame (renderer);
+    g_assert_cmpuint (lrg_recording_renderer_get_n_batches (recorder), ==, 0);
+    g_assert_cmpuint (lrg_renderer_get_batch_count (renderer), ==, 0);
+    lrg_renderer_end_frame (renderer);
+}
+
+static void
+test_render_queue_ordering (void)
+{
+    g_autoptr(LrgRecordingRenderer) recorder = lrg_recording_renderer_new ();
+    g_autoptr(TestDrawable) drawable = test_drawable_new ();
+    LrgRenderer          *renderer = LRG_RENDERER (recorder);
+    const LrgRenderBatch *batch;
+    guint                 i;
+
+    lrg_renderer_begin_frame (renderer);
+    lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_UI);
+
+    /* Submitted back to front; sort layers put them in order */
+    submit_test_sprite (renderer, lrg_renderer_pack_sort_key (2, 0, 0, 1, 0.0f), 20.0f);
+    lrg_renderer_submit_drawable (renderer, lrg_renderer_pack_sort_key (1, 0, 0, 0, 0.0f),
+                                  LRG_DRAWABLE (drawable), 0.5f);
+    submit_test_sprite (renderer, lrg_renderer_pack_sort_key (0, 0, 0, 1, 0.0f), 0.0f);
+
+    /* Equal keys keep submission order */
+    for (i = 0; i < 3; i++)
+        submit_test_sprite (renderer, lrg_renderer_pack_sort_key (0, 0, 0, 1, 0.0f),
+                            1.0f + i);
+
+    /* An open layer is flushed when the next one begins */
+    lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_DEBUG);
+    g_assert_cmpuint (lrg_recording_renderer_get_n_batches (recorder), ==, 3);
+    lrg_renderer_end_frame (renderer);
+
+    batch = lrg_recording_renderer_get_batch (recorder, 0);
+    g_assert_cmpint (batch->layer, ==, LRG_RENDER_LAYER_UI);
+    g_assert_cmpuint (batch->n_sprites, ==, 4);
+    for (i = 0; i < 4; i++)
+        g_assert_cmpfloat (batch->sprites[i].dest.x, ==, (gfloat)i);
+
+    batch = lrg_recording_renderer_get_batch (recorder, 1);
+    g_assert_true (batch->drawable == LRG_DRAWABLE (drawable));
+    g_assert_cmpuint (batch->n_sprites, ==, 0);
+    g_assert_cmpfloat (batch->delta, ==, 0.5f);
+
+    batch = lrg_recording_renderer_get_batch (recorder, 2);
+    g_assert_cmpuint (batch->n_sprites, ==, 1);
+    g_assert_cmpfloat (batch->sprites[0].dest.x, ==, 20.0f);
+
+    /* The recorder records drawables without drawing them */
+    g_assert_cmpint (drawable->draw_count, ==, 0);
+}
+
+static void
+test_render_queue_large_batch (void)
+{
+    g_autoptr(LrgRecordingRenderer) recorder = lrg_recording_renderer_new ();
+    LrgRenderer *renderer = LRG_RENDERER (recorder);
+    guint        i;
+
+    g_assert_cmpuint (lrg_renderer_make_sort_key (renderer, 3, GRL_BLEND_ALPHA, NULL, NULL, 1.0f), ==,
+                      lrg_renderer_pack_sort_key (3, GRL_BLEND_ALPHA, 0, 0, 1.0f));
+
+    lrg_renderer_begin_frame (renderer);
+    lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_EFFECTS);
+    for (i = 0; i < 10000; i++)
+        submit_test_sprite (renderer, lrg_renderer_pack_sort_key (0, 0, 0, 1, (gfloat)(i % 7)),
+                            (gfloat)i);
+    lrg_renderer_end_layer (renderer);
+    lrg_renderer_end_frame (renderer);
+
+    /* Batches are capped at the size of one rlgl vertex buffer */
+    g_assert_cmpuint (lrg_recording_renderer_get_n_batches (recorder), ==, 2);
+    g_assert_cmpuint (lrg_recording_renderer_get_batch (recorder, 0)->n_sprites, ==, 8192);
+    g_assert_cmpuint (lrg_recording_renderer_get_batch (recorder, 1)->n_sprites, ==, 1808);
+    g_assert_cmpuint (lrg_renderer_get_sprite_count (renderer), ==, 10000);
+}
+
+static void
+test_render_queue_ids_reset (void)
+{
+    g_autoptr(LrgRecordingRenderer) recorder = lrg_recording_renderer_new ();
+    LrgRenderer *renderer = LRG_RENDERER (recorder);
+    gint         textures[2];
+    guint64      key;
+
+    lrg_renderer_begin_frame (renderer);
+    lrg_renderer_make_sort_key (renderer, 0, GRL_BLEND_ALPHA, NULL,
+                                (GrlTexture *)&textures[0], 0.0f);
+    key = lrg_renderer_make_sort_key (renderer, 0, GRL_BLEND_ALPHA, NULL,
+                                      (GrlTexture *)&textures[1], 0.0f);
+    g_assert_cmpuint (key, ==, lrg_renderer_pack_sort_key (0, GRL_BLEND_ALPHA, 0, 2, 0.0f));
+    lrg_renderer_end_frame (renderer);
+
+    /* Ids start over every frame instead of saturating */
+    lrg_renderer_begin_frame (renderer);
+    key = lrg_renderer_make_sort_key (renderer, 0, GRL_BLEND_ALPHA, NULL,
+                                      (GrlTexture *)&textures[1], 0.0f);
+    g_assert_cmpuint (key, ==, lrg_renderer_pack_sort_key (0, GRL_BLEND_ALPHA, 0, 1, 0.0f));
+    lrg_renderer_end_frame (renderer);
+}
+
+static void
+test_render_queue_perf (void)
+{
+    static const guint sizes[] = { 1000, 10000, 50000 };
+    g_autoptr(LrgRecordingRenderer) recorder = NULL;
+    LrgRenderer *renderer;
+    GRand       *rand;
+    guint        s;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    recorder = lrg_recording_renderer_new ();
+    renderer = LRG_RENDERER (recorder);
+    rand = g_rand_new_with_seed (41);
+
+    for (s = 0; s < G_N_ELEMENTS (sizes); s++)
+    {
+        guint    n = sizes[s];
+        guint64 *keys = g_new (guint64, n);
+        guint    immediate_calls = 0;
+        guint    frames = 20;
+        GTimer  *timer;
+        guint    f;
+        guint    i;
+
+        /* 32 textures in random order, as a scene graph walk produces */
+        for (i = 0; i < n; i++)
+        {
+            guint texture = (guint)g_rand_int_range (rand, 1, 33);
+
+            keys[i] = lrg_renderer_pack_sort_key (0, 0, 0, texture,
+                                                  (gfloat)g_rand_double_range (rand, 0.0, 100.0));
+            if (i == 0 || (keys[i] ^ keys[i - 1]) >> 24 != 0)
+                immediate_calls++;
+        }
+
+        timer = g_timer_new ();
+        for (f = 0; f < frames; f++)
+        {
+            lrg_renderer_begin_frame (renderer);
+            lrg_renderer_begin_layer (renderer, LRG_RENDER_LAYER_WORLD);
+            for (i = 0; i < n; i++)
+                submit_test_sprite (renderer, keys[i], (gfloat)i);
+            lrg_renderer_end_layer (renderer);
+            lrg_renderer_end_frame (renderer);
+        }
+        g_timer_stop (timer);
+
+        g_test_minimized_result (g_timer_elapsed (timer, NULL) * 1000.0 / frames,
+                                 "%u sprites: %u draw calls immediate, %u batched, %.3f ms/frame",
+                                 n, immediate_calls, lrg_renderer_get_batch_count (renderer),
+                                 g_timer_elapsed (timer, NULL) * 1000.0 / frames);
+        g_assert_cmpuint (lrg_renderer_get_batch_count (renderer), <=, 32 + n / 8192 + 1);
+
+        g_timer_destroy (timer);
+        g_free (keys);
+    }
+
+    g_rand_free (rand);
+}
+
 /* ==========================================================================
  * Test Cases - Enums
  * ========================================================================== */
@@ -1595,6 +1848,14 @@ main (int    argc,
     /* LrgRenderer tests */
     g_test_add_func ("/graphics/renderer/type", test_renderer_type);
 
+    /* Render queue tests */
+    g_test_add_func ("/graphics/render-queue/sort-key", test_render_queue_sort_key);
+    g_test_add_func ("/graphics/render-queue/batching", test_render_queue_batching);
+    g_test_add_func ("/graphics/render-queue/ordering", test_render_queue_ordering);
+    g_test_add_func ("/graphics/render-queue/large-batch", test_render_queue_large_batch);
+    g_test_add_func ("/graphics/render-queue/ids-reset", test_render_queue_ids_reset);
+    g_test_add_func ("/graphics/render-queue/perf", test_render_queue_perf);
+
     /* Enum tests */
     g_test_add_func ("/graphics/enums/render-layer", test_render_layer_enum);
     g_test_add_func ("/graphics/enums/projection-type", test_projection_type_enum);
@@ -875,6 +875,227 @@ test_inventory_signals (InventoryFixture *fixture,
     g_assert_true (signal_data.slot_changed_fired);
 }
 
+/* Counts by scanning every slot, to check the cached index against */
+static guint
+scan_count (LrgInventory *inventory,
+            const gchar  *item_id,
+            gint         *first_slot)
+{
+    guint count = 0;
+    guint i;
+
+    *first_slot = -1;
+    for (i = 0; i < lrg_inventory_get_capacity (inventory); i++)
+    {
+        LrgItemStack *stack = lrg_inventory_get_slot (inventory, i);
+
+        if (stack != NULL &&
+            g_strcmp0 (lrg_item_def_get_id (lrg_item_stack_get_def (stack)), item_id) == 0)
+        {
+            if (*first_slot < 0)
+                *first_slot = (gint)i;
+            count += lrg_item_stack_get_quantity (stack);
+        }
+    }
+
+    return count;
+}
+
+static void
+assert_index_consistent (InventoryFixture *fixture)
+{
+    const gchar *ids[] = { "sword_iron", "potion_health", "gold_coin" };
+    guint used = 0;
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (ids); i++)
+    {
+        gint first;
+        guint count = scan_count (fixture->inventory, ids[i], &first);
+
+        g_assert_cmpuint (lrg_inventory_count_item (fixture->inventory, ids[i]), ==, count);
+        g_assert_cmpint (lrg_inventory_find_item_slot (fixture->inventory, ids[i]), ==, first);
+    }
+
+    for (i = 0; i < lrg_inventory_get_capacity (fixture->inventory); i++)
+    {
+        if (!lrg_inventory_is_slot_empty (fixture->inventory, i))
+            used++;
+    }
+    g_assert_cmpuint (lrg_inventory_get_used_slots (fixture->inventory), ==, used);
+}
+
+static void
+test_inventory_index (InventoryFixture *fixture,
+                      gconstpointer     user_data)
+{
+    g_autoptr(LrgItemStack) stack = NULL;
+
+    (void)user_data;
+
+    /* Spans several bitmap words */
+    lrg_inventory_set_capacity (fixture->inventory, 200);
+
+    lrg_inventory_add_item (fixture->inventory, fixture->potion, 35);
+    lrg_inventory_add_item (fixture->inventory, fixture->sword, 3);
+    lrg_inventory_add_item (fixture->inventory, fixture->gold, 2500);
+    lrg_inventory_add_to_slot (fixture->inventory, 150, fixture->potion, 7);
+    assert_index_consistent (fixture);
+    g_assert_cmpuint (lrg_inventory_count_item (fixture->inventory, "potion_health"), ==, 42);
+
+    lrg_inventory_remove_item (fixture->inventory, "potion_health", 12);
+    lrg_inventory_remove_from_slot (fixture->inventory, 150, 7);
+    assert_index_consistent (fixture);
+
+    lrg_inventory_swap_slots (fixture->inventory, 2, 120);
+    lrg_inventory_move_to_slot (fixture->inventory, 1, 130, 4);
+    lrg_inventory_move_to_slot (fixture->inventory, 5, 140, -1);
+    assert_index_consistent (fixture);
+
+    stack = lrg_item_stack_new (fixture->gold, 10);
+    lrg_inventory_set_slot (fixture->inventory, 199, stack);
+    lrg_item_stack_unref (lrg_inventory_clear_slot (fixture->inventory, 120));
+    assert_index_consistent (fixture);
+
+    /* Shrinking drops the stacks past the end */
+    lrg_inventory_set_capacity (fixture->inventory, 100);
+    assert_index_consistent (fixture);
+
+    lrg_inventory_sort (fixture->inventory);
+    assert_index_consistent (fixture);
+    g_assert_cmpint (lrg_inventory_find_empty_slot (fixture->inventory), ==,
+                     (gint)lrg_inventory_get_used_slots (fixture->inventory));
+
+    lrg_inventory_clear (fixture->inventory);
+    assert_index_consistent (fixture);
+    g_assert_null (lrg_inventory_find_item (fixture->inventory, "gold_coin"));
+}
+
+typedef struct
+{
+    guint added;
+    guint removed;
+    guint changed;
+} SignalCounts;
+
+static void
+count_item_added (LrgInventory *inventory,
+                  guint         slot,
+                  LrgItemStack *stack,
+                  gpointer      user_data)
+{
+    ((SignalCounts *)user_data)->added++;
+}
+
+static void
+count_item_removed (LrgInventory *inventory,
+                    guint         slot,
+                    LrgItemStack *stack,
+                    gpointer      user_data)
+{
+    ((SignalCounts *)user_data)->removed++;
+}
+
+static void
+count_slot_changed (LrgInventory *inventory,
+                    guint         slot,
+                    gpointer      user_data)
+{
+    ((SignalCounts *)user_data)->changed++;
+}
+
+static void
+connect_counts (LrgInventory *inventory,
+                SignalCounts *counts)
+{
+    g_signal_connect (inventory, "item-added", G_CALLBACK (count_item_added), counts);
+    g_signal_connect (inventory, "item-removed", G_CALLBACK (count_item_removed), counts);
+    g_signal_connect (inventory, "slot-changed", G_CALLBACK (count_slot_changed), counts);
+}
+
+static void
+test_inventory_batch (InventoryFixture *fixture,
+                      gconstpointer     user_data)
+{
+    SignalCounts counts = { 0, 0, 0 };
+    guint i;
+
+    (void)user_data;
+
+    connect_counts (fixture->inventory, &counts);
+
+    lrg_inventory_begin_batch (fixture->inventory);
+    for (i = 0; i < 25; i++)
+        lrg_inventory_add_item (fixture->inventory, fixture->potion, 1);
+    lrg_inventory_add_item (fixture->inventory, fixture->sword, 1);
+    lrg_inventory_remove_item (fixture->inventory, "sword_iron", 1);
+    g_assert_cmpuint (counts.added + counts.removed + counts.changed, ==, 0);
+    lrg_inventory_end_batch (fixture->inventory);
+
+    /* Three potion stacks; the sword came and went unseen */
+    g_assert_cmpuint (counts.added, ==, 3);
+    g_assert_cmpuint (counts.removed, ==, 0);
+    g_assert_cmpuint (counts.changed, ==, 4);
+    g_assert_cmpuint (lrg_inventory_count_item (fixture->inventory, "potion_health"), ==, 25);
+}
+
+static void
+test_inventory_transfer (InventoryFixture *fixture,
+                         gconstpointer     user_data)
+{
+    g_autoptr(LrgInventory) dest = NULL;
+    SignalCounts source_counts = { 0, 0, 0 };
+    SignalCounts dest_counts = { 0, 0, 0 };
+    LrgItemTransfer transfers[] = {
+        { "potion_health", 10 },
+        { "gold_coin", 1200 },
+        { "potion_health", 5 },
+    };
+    LrgItemTransfer too_many[] = {
+        { "gold_coin", 100 },
+        { "sword_iron", 1 },
+    };
+
+    (void)user_data;
+
+    dest = lrg_inventory_new (4);
+    lrg_inventory_add_item (fixture->inventory, fixture->potion, 25);
+    lrg_inventory_add_item (fixture->inventory, fixture->gold, 1500);
+    lrg_inventory_add_item (fixture->inventory, fixture->sword, 1);
+    lrg_inventory_add_item (dest, fixture->potion, 5);
+
+    connect_counts (fixture->inventory, &source_counts);
+    connect_counts (dest, &dest_counts);
+
+    /* Not enough potions: nothing moves */
+    transfers[0].quantity = 25;
+    g_assert_false (lrg_inventory_transfer_items (fixture->inventory, dest,
+                                                  transfers, G_N_ELEMENTS (transfers)));
+    g_assert_cmpuint (lrg_inventory_count_item (fixture->inventory, "potion_health"), ==, 25);
+    g_assert_cmpuint (source_counts.changed + dest_counts.changed, ==, 0);
+
+    /* 15 potions fill the partial stack and one more; gold needs two slots */
+    transfers[0].quantity = 10;
+    g_assert_true (lrg_inventory_transfer_items (fixture->inventory, dest,
+                                                 transfers, G_N_ELEMENTS (transfers)));
+    g_assert_cmpuint (lrg_inventory_count_item (fixture->inventory, "potion_health"), ==, 10);
+    g_assert_cmpuint (lrg_inventory_count_item (fixture->inventory, "gold_coin"), ==, 300);
+    g_assert_cmpuint (lrg_inventory_count_item (dest, "potion_health"), ==, 20);
+    g_assert_cmpuint (lrg_inventory_count_item (dest, "gold_coin"), ==, 1200);
+    g_assert_true (lrg_inventory_is_full (dest));
+
+    /* One notification per touched slot */
+    g_assert_cmpuint (dest_counts.added, ==, 3);
+    g_assert_cmpuint (dest_counts.changed, ==, 4);
+    g_assert_cmpuint (source_counts.removed, ==, 2);
+    g_assert_cmpuint (source_counts.changed, ==, 4);
+
+    /* The destination has no free slot left for the sword */
+    g_assert_false (lrg_inventory_transfer_items (fixture->inventory, dest,
+                                                  too_many, G_N_ELEMENTS (too_many)));
+    g_assert_cmpuint (lrg_inventory_count_item (dest, "gold_coin"), ==, 1200);
+}
+
 /* ==========================================================================
  * LrgEquipment Tests
  * ========================================================================== */
@@ -1345,6 +1566,12 @@ main (int   argc,
                 inventory_fixture_set_up, test_inventory_sort, inventory_fixture_tear_down);
     g_test_add ("/inventory/inventory/signals", InventoryFixture, NULL,
                 inventory_fixture_set_up, test_inventory_signals, inventory_fixture_tear_down);
+    g_test_add ("/inventory/inventory/index", InventoryFixture, NULL,
+                inventory_fixture_set_up, test_inventory_index, inventory_fixture_tear_down);
+    g_test_add ("/inventory/inventory/batch", InventoryFixture, NULL,
+                inventory_fixture_set_up, test_inventory_batch, inventory_fixture_tear_down);
+    g_test_add ("/inventory/inventory/transfer", InventoryFixture, NULL,
+                inventory_fixture_set_up, test_inventory_transfer, inventory_fixture_tear_down);
 
     /* LrgEquipment tests */
     g_test_add_func ("/inventory/equipment/new", test_equipment_new);
@@ -918,6 +918,135 @@ test_exporter_video_missing_ffmpeg (void)
     g_object_unref (vid);
 }
 
+static void
+test_exporter_video_pipe_options (void)
+{
+    LrgReelVideoExporter *vid;
+
+    vid = lrg_reel_video_exporter_new ("out.mp4", LRG_REEL_VIDEO_CODEC_H264);
+    g_assert_cmpint (lrg_reel_video_exporter_get_pipe_format (vid), ==,
+                     LRG_REEL_VIDEO_PIPE_FORMAT_RAW);
+    g_assert_cmpuint (lrg_reel_video_exporter_get_queue_depth (vid), ==, 3);
+
+    lrg_reel_video_exporter_set_pipe_format (vid, LRG_REEL_VIDEO_PIPE_FORMAT_PNG);
+    lrg_reel_video_exporter_set_queue_depth (vid, 0);
+    g_assert_cmpint (lrg_reel_video_exporter_get_pipe_format (vid), ==,
+                     LRG_REEL_VIDEO_PIPE_FORMAT_PNG);
+    g_assert_cmpuint (lrg_reel_video_exporter_get_queue_depth (vid), ==, 0);
+
+    g_object_unref (vid);
+}
+
+static void
+test_exporter_video_png_pipe (void)
+{
+    g_autofree gchar *dir = NULL;
+    g_autofree gchar *path = NULL;
+    g_autoptr(GError) error = NULL;
+    g_autoptr(LrgReel) reel = NULL;
+    g_autoptr(LrgReelRenderer) renderer = NULL;
+    LrgReelVideoExporter *vid;
+    Rgba green = { 0, 255, 0, 255 };
+    GStatBuf st;
+
+    if (!lrg_reel_video_exporter_is_ffmpeg_available ())
+    {
+        g_test_skip ("ffmpeg not available");
+        return;
+    }
+
+    dir = g_dir_make_tmp ("reel-vid-XXXXXX", &error);
+    g_assert_no_error (error);
+    path = g_build_filename (dir, "out.mp4", NULL);
+
+    /* The PNG pipe written synchronously, i.e. the pre-writer-thread path. */
+    reel = make_fill_reel (&green, 6);
+    renderer = lrg_reel_renderer_new (reel);
+    vid = lrg_reel_video_exporter_new (path, LRG_REEL_VIDEO_CODEC_H264);
+    lrg_reel_video_exporter_set_pipe_format (vid, LRG_REEL_VIDEO_PIPE_FORMAT_PNG);
+    lrg_reel_video_exporter_set_queue_depth (vid, 0);
+
+    g_assert_true (lrg_reel_renderer_render_to_exporter (
+        renderer, LRG_REEL_EXPORTER (vid), &error));
+    g_assert_no_error (error);
+
+    g_assert_cmpint (g_stat (path, &st), ==, 0);
+    g_assert_cmpint (st.st_size, >, 0);
+
+    g_object_unref (vid);
+    g_unlink (path);
+    g_rmdir (dir);
+}
+
+/* Push @frames copies of a 1080p frame through one exporter configuration
+ * and return the throughput in frames per second. */
+static gdouble
+export_1080p_fps (const gchar            *path,
+                  LrgReelVideoPipeFormat  format,
+                  guint                   queue_depth,
+                  gint                    frames)
+{
+    g_autoptr(GError) error = NULL;
+    g_autoptr(GTimer) timer = NULL;
+    GrlColor grey = { 128, 128, 128, 255 };
+    g_autoptr(GrlImage) frame = grl_image_new_color (1920, 1080, &grey);
+    LrgReelVideoExporter *vid;
+    gint i;
+
+    vid = lrg_reel_video_exporter_new (path, LRG_REEL_VIDEO_CODEC_H264);
+    lrg_reel_video_exporter_set_pipe_format (vid, format);
+    lrg_reel_video_exporter_set_queue_depth (vid, queue_depth);
+
+    timer = g_timer_new ();
+    g_assert_true (lrg_reel_exporter_begin (LRG_REEL_EXPORTER (vid), 1920, 1080, 30.0, &error));
+    for (i = 0; i < frames; i++)
+        g_assert_true (lrg_reel_exporter_add_frame (LRG_REEL_EXPORTER (vid), frame, &error));
+    g_assert_true (lrg_reel_exporter_finish (LRG_REEL_EXPORTER (vid), &error));
+    g_assert_no_error (error);
+    g_timer_stop (timer);
+
+    g_object_unref (vid);
+    g_unlink (path);
+
+    return frames / g_timer_elapsed (timer, NULL);
+}
+
+static void
+test_exporter_video_throughput (void)
+{
+    g_autofree gchar *dir = NULL;
+    g_autofree gchar *path = NULL;
+    g_autoptr(GError) error = NULL;
+    gdouble png_fps;
+    gdouble raw_sync_fps;
+    gdouble raw_fps;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+    if (!lrg_reel_video_exporter_is_ffmpeg_available ())
+    {
+        g_test_skip ("ffmpeg not available");
+        return;
+    }
+
+    dir = g_dir_make_tmp ("reel-bench-XXXXXX", &error);
+    g_assert_no_error (error);
+    path = g_build_filename (dir, "bench.mp4", NULL);
+
+    png_fps = export_1080p_fps (path, LRG_REEL_VIDEO_PIPE_FORMAT_PNG, 0, 60);
+    raw_sync_fps = export_1080p_fps (path, LRG_REEL_VIDEO_PIPE_FORMAT_RAW, 0, 60);
+    raw_fps = export_1080p_fps (path, LRG_REEL_VIDEO_PIPE_FORMAT_RAW, 3, 60);
+
+    g_test_message ("1080p export: png %.1f fps, raw %.1f fps, raw+writer %.1f fps",
+                    png_fps, raw_sync_fps, raw_fps);
+    g_test_maximized_result (raw_fps, "raw+writer 1080p export: %.1f fps", raw_fps);
+
+    g_rmdir (dir);
+}
+
 /* ==========================================================================
  * transitions (CPU)
  * ========================================================================== */
@@ -1586,6 +1715,166 @@ test_video_clip (void)
     g_rmdir (dir);
 }
 
+/* Each frame is a flat grey of level 4 * frame, so frames identify themselves. */
+static void
+ramp_render (LrgReelClip    *clip,
+             LrgReelContext *ctx,
+             LrgImageCanvas *canvas,
+             gpointer        user_data)
+{
+    GrlColor color;
+
+    color.r = color.g = color.b = (guint8) (lrg_reel_context_get_frame (ctx) * 4);
+    color.a = 255;
+    lrg_image_canvas_clear (canvas, &color);
+}
+
+static gboolean
+make_ramp_mp4 (const gchar *path,
+               gint         frames)
+{
+    g_autoptr(LrgReel) reel = NULL;
+    g_autoptr(LrgReelRenderer) renderer = NULL;
+    LrgReelVideoExporter *vid;
+    LrgReelClip *clip;
+    gboolean ok;
+
+    reel = lrg_reel_new ("ramp", 16, 16, 30.0, frames);
+    clip = lrg_reel_clip_new_with_func (ramp_render, NULL, NULL);
+    lrg_reel_add_clip (reel, clip);
+    g_object_unref (clip);
+
+    renderer = lrg_reel_renderer_new (reel);
+    vid = lrg_reel_video_exporter_new (path, LRG_REEL_VIDEO_CODEC_H264);
+    lrg_reel_video_exporter_set_crf (vid, 0);
+    ok = lrg_reel_renderer_render_to_exporter (renderer, LRG_REEL_EXPORTER (vid), NULL);
+    g_object_unref (vid);
+
+    return ok;
+}
+
+static void
+assert_ramp_frame (GrlImage *frame,
+                   gint      index)
+{
+    g_autoptr(GrlColor) c = NULL;
+
+    g_assert_nonnull (frame);
+    c = grl_image_get_pixel (frame, 8, 8);
+    g_assert_cmpint (ABS ((gint) c->g - index * 4), <=, 6);
+}
+
+static void
+test_video_source_window (void)
+{
+    g_autofree gchar *dir = NULL;
+    g_autofree gchar *mp4 = NULL;
+    g_autoptr(GError) error = NULL;
+    LrgReelVideoSource *src;
+    static const gint order[] = { 0, 1, 2, 40, 41, 3, 59, 20, 19, 18, 58, 0 };
+    guint i;
+
+    if (!lrg_reel_video_source_is_ffmpeg_available ())
+    {
+        g_test_skip ("ffmpeg/ffprobe not available");
+        return;
+    }
+
+    dir = g_dir_make_tmp ("reel-vwin-XXXXXX", &error);
+    g_assert_no_error (error);
+    mp4 = g_build_filename (dir, "ramp.mp4", NULL);
+    g_assert_true (make_ramp_mp4 (mp4, 60));
+
+    src = lrg_reel_video_source_new_from_file (mp4, &error);
+    g_assert_no_error (error);
+    g_assert_cmpint (lrg_reel_video_source_get_frame_count (src), ==, 60);
+
+    /* A tiny window forces evictions and seeks in both directions. */
+    lrg_reel_video_source_set_window_size (src, 3);
+    lrg_reel_video_source_set_read_ahead (src, 1);
+    g_assert_cmpuint (lrg_reel_video_source_get_window_size (src), ==, 3);
+    g_assert_cmpuint (lrg_reel_video_source_get_read_ahead (src), ==, 1);
+
+    for (i = 0; i < G_N_ELEMENTS (order); i++)
+    {
+        GrlImage *frame = lrg_reel_video_source_get_frame (src, order[i], &error);
+
+        g_assert_no_error (error);
+        assert_ramp_frame (frame, order[i]);
+    }
+
+    /* Out-of-range indices clamp. */
+    assert_ramp_frame (lrg_reel_video_source_get_frame (src, 1000, NULL), 59);
+
+    g_object_unref (src);
+    g_unlink (mp4);
+    g_rmdir (dir);
+}
+
+typedef struct
+{
+    LrgReelVideoSource *source;
+    gint                first;
+    gint                step;
+} VideoReader;
+
+static gpointer
+video_reader_thread (gpointer data)
+{
+    VideoReader *r = data;
+    gint         f;
+
+    for (f = r->first; f < 60; f += r->step)
+    {
+        g_autoptr(GrlImage) frame = lrg_reel_video_source_dup_frame (r->source, f, NULL);
+
+        assert_ramp_frame (frame, f);
+    }
+
+    return NULL;
+}
+
+static void
+test_video_source_concurrent (void)
+{
+    g_autofree gchar *dir = NULL;
+    g_autofree gchar *mp4 = NULL;
+    g_autoptr(GError) error = NULL;
+    LrgReelVideoSource *src;
+    VideoReader readers[4];
+    GThread *threads[4];
+    gint t;
+
+    if (!lrg_reel_video_source_is_ffmpeg_available ())
+    {
+        g_test_skip ("ffmpeg/ffprobe not available");
+        return;
+    }
+
+    dir = g_dir_make_tmp ("reel-vcon-XXXXXX", &error);
+    g_assert_no_error (error);
+    mp4 = g_build_filename (dir, "ramp.mp4", NULL);
+    g_assert_true (make_ramp_mp4 (mp4, 60));
+
+    src = lrg_reel_video_source_new_from_file (mp4, &error);
+    g_assert_no_error (error);
+
+    /* Interleaved readers, as render_parallel() workers request frames. */
+    for (t = 0; t < 4; t++)
+    {
+        readers[t].source = src;
+        readers[t].first = t;
+        readers[t].step = 4;
+        threads[t] = g_thread_new ("video-reader", video_reader_thread, &readers[t]);
+    }
+    for (t = 0; t < 4; t++)
+        g_thread_join (threads[t]);
+
+    g_object_unref (src);
+    g_unlink (mp4);
+    g_rmdir (dir);
+}
+
 static void
 test_audio_from_file (void)
 {
@@ -1676,6 +1965,55 @@ test_audio_level (void)
     g_assert_cmpfloat (level, <, 0.01);
 }
 
+static void
+test_audio_analysis (void)
+{
+    g_autoptr(LrgWaveData) wave = make_sine_wave (8000, 1000.0);
+    g_autoptr(LrgReelAudioAnalysis) analysis = NULL;
+    const gfloat *row;
+    const gfloat *envelope;
+    gfloat       *bins;
+    gfloat       *wf_a;
+    gfloat       *wf_b;
+    gsize         count;
+    gsize         i;
+    gint          f;
+
+    analysis = lrg_reel_audio_analysis_new (wave, 30.0, 1024);
+    g_assert_cmpuint (lrg_reel_audio_analysis_get_bin_count (analysis), ==, 512);
+    g_assert_cmpint (lrg_reel_audio_analysis_get_frame_count (analysis), ==, 30);
+
+    /* Precomputed lookups agree with the one-shot functions. */
+    for (f = 0; f < 30; f += 5)
+    {
+        row = lrg_reel_audio_analysis_get_spectrum (analysis, f, &count);
+        bins = lrg_reel_audio_spectrum (wave, f, 30.0, 512, 1024, NULL);
+        g_assert_cmpuint (count, ==, 512);
+        for (i = 0; i < count; i++)
+            g_assert_cmpfloat (fabs (row[i] - bins[i]), <, 1e-5);
+        g_free (bins);
+
+        g_assert_cmpfloat (fabs (lrg_reel_audio_analysis_get_level (analysis, f, 0.05)
+                                 - lrg_reel_audio_level (wave, f, 30.0, 0.05)), <, 1e-6);
+
+        wf_a = lrg_reel_audio_analysis_get_waveform (analysis, f, 0.1, 64, NULL);
+        wf_b = lrg_reel_audio_waveform (wave, f, 30.0, 0.1, 64, NULL);
+        g_assert_cmpmem (wf_a, 64 * sizeof (gfloat), wf_b, 64 * sizeof (gfloat));
+        g_free (wf_a);
+        g_free (wf_b);
+    }
+
+    /* A unit sine has RMS 1/sqrt(2) in every frame. */
+    envelope = lrg_reel_audio_analysis_get_envelope (analysis, &count);
+    g_assert_cmpuint (count, ==, 30);
+    for (i = 0; i < count; i++)
+        g_assert_cmpfloat (fabs (envelope[i] - G_SQRT2 / 2.0), <, 0.01);
+
+    /* Frames past the end read as silence. */
+    row = lrg_reel_audio_analysis_get_spectrum (analysis, 1000, NULL);
+    g_assert_cmpfloat (row[128], ==, 0.0f);
+}
+
 /* ==========================================================================
  * Wave D: effects, transitions, path motion
  * ========================================================================== */
@@ -2447,6 +2785,9 @@ main (int   argc,
     g_test_add_func ("/reel/exporter/gif", test_exporter_gif);
     g_test_add_func ("/reel/exporter/video", test_exporter_video_ffmpeg);
     g_test_add_func ("/reel/exporter/video-missing-ffmpeg", test_exporter_video_missing_ffmpeg);
+    g_test_add_func ("/reel/exporter/video-pipe-options", test_exporter_video_pipe_options);
+    g_test_add_func ("/reel/exporter/video-png-pipe", test_exporter_video_png_pipe);
+    g_test_add_func ("/reel/exporter/video-throughput", test_exporter_video_throughput);
 
     g_test_add_func ("/reel/transition/fade", test_transition_fade);
     g_test_add_func ("/reel/transition/wipe", test_transition_wipe);
@@ -2476,9 +2817,12 @@ main (int   argc,
 
     g_test_add_func ("/reel/video/roundtrip", test_video_roundtrip);
     g_test_add_func ("/reel/video/clip", test_video_clip);
+    g_test_add_func ("/reel/video/source-window", test_video_source_window);
+    g_test_add_func ("/reel/video/source-concurrent", test_video_source_concurrent);
     g_test_add_func ("/reel/audio/from-file", test_audio_from_file);
     g_test_add_func ("/reel/audio/fft-spectrum", test_fft_spectrum);
     g_test_add_func ("/reel/audio/level", test_audio_level);
+    g_test_add_func ("/reel/audio/analysis", test_audio_analysis);
 
     g_test_add_func ("/reel/effect/chroma-key", test_effect_chroma_key);
     g_test_add_func ("/reel/effect/color-grade", test_effect_color_grade);
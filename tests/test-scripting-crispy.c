@@ -0,0 +1,236 @@
+/* test-scripting-crispy.c
+ *
+ * Copyright 2025 Zach Podbielniak
+ *
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Unit tests for LrgScriptingCrispy.
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <libregnum.h>
+
+/* ==========================================================================
+ * Test Fixture
+ * ========================================================================== */
+
+/* A script exporting the update hook plus a few fast-call signatures.
+ * Both %d are the scale, which changes between reloads. */
+static const gchar script_template[] =
+    "static double total;\n"
+    "static int    loads;\n"
+    "int main (void) { loads++; return 0; }\n"
+    "void lrg_script_update (double delta) { total += delta * %d; }\n"
+    "void bump (float amount) { total += amount; }\n"
+    "void report (void *out) { ((double *) out)[0] = total; ((double *) out)[1] = %d; }\n";
+
+typedef struct
+{
+    LrgScriptingCrispy *scripting;
+    gchar              *dir;
+    gchar              *path;
+} CrispyFixture;
+
+static void
+write_script (CrispyFixture *fixture,
+              gint           scale)
+{
+    g_autofree gchar *source = g_strdup_printf (script_template, scale, scale);
+
+    g_assert_true (g_file_set_contents (fixture->path, source, -1, NULL));
+}
+
+static void
+crispy_fixture_set_up (CrispyFixture *fixture,
+                       gconstpointer  user_data)
+{
+    (void)user_data;
+
+    fixture->scripting = lrg_scripting_crispy_new ();
+    fixture->dir = g_dir_make_tmp ("lrg-crispy-XXXXXX", NULL);
+    fixture->path = g_build_filename (fixture->dir, "script.c", NULL);
+    write_script (fixture, 1);
+}
+
+static void
+crispy_fixture_tear_down (CrispyFixture *fixture,
+                          gconstpointer  user_data)
+{
+    (void)user_data;
+
+    g_clear_object (&fixture->scripting);
+    g_unlink (fixture->path);
+    g_rmdir (fixture->dir);
+    g_free (fixture->path);
+    g_free (fixture->dir);
+}
+
+static void
+report (LrgScriptingCrispy *scripting,
+        gdouble            *total,
+        gdouble            *scale)
+{
+    gdouble out[2] = { -1.0, -1.0 };
+
+    g_assert_true (lrg_scripting_crispy_call_pointer (scripting, "report", out, NULL));
+    *total = out[0];
+    *scale = out[1];
+}
+
+/* ==========================================================================
+ * Tests
+ * ========================================================================== */
+
+static void
+test_scripting_crispy_fast_calls (CrispyFixture *fixture,
+                                  gconstpointer  user_data)
+{
+    g_autoptr(GError) error = NULL;
+    GValue            arg = G_VALUE_INIT;
+    gdouble           total;
+    gdouble           scale;
+
+    (void)user_data;
+
+    g_assert_true (lrg_scripting_load_file (LRG_SCRIPTING (fixture->scripting),
+                                            fixture->path, &error));
+    g_assert_no_error (error);
+
+    /* The generic entry point marshals a double to void (double). */
+    g_value_init (&arg, G_TYPE_DOUBLE);
+    g_value_set_double (&arg, 0.5);
+    g_assert_true (lrg_scripting_call_function (LRG_SCRIPTING (fixture->scripting),
+                                                LRG_SCRIPT_HOOK_UPDATE,
+                                                NULL, 1, &arg, &error));
+    g_assert_no_error (error);
+    g_value_unset (&arg);
+
+    g_assert_true (lrg_scripting_crispy_call_double (fixture->scripting,
+                                                     LRG_SCRIPT_HOOK_UPDATE,
+                                                     0.25, NULL));
+    g_assert_true (lrg_scripting_crispy_call_float (fixture->scripting, "bump", 2.0f, NULL));
+
+    report (fixture->scripting, &total, &scale);
+    g_assert_cmpfloat_with_epsilon (total, 2.75, 1e-9);
+    g_assert_nonnull (lrg_scripting_crispy_lookup_symbol (fixture->scripting, "bump"));
+
+    g_assert_false (lrg_scripting_crispy_call_void (fixture->scripting, "missing", &error));
+    g_assert_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_NOT_FOUND);
+    g_assert_null (lrg_scripting_crispy_lookup_symbol (fixture->scripting, "missing"));
+}
+
+static void
+test_scripting_crispy_hot_reload (CrispyFixture *fixture,
+                                  gconstpointer  user_data)
+{
+    g_autoptr(GError) error = NULL;
+    GValue            arg = G_VALUE_INIT;
+    gint64            deadline;
+    guint             generation;
+    gdouble           total;
+    gdouble           scale;
+
+    (void)user_data;
+
+    lrg_scripting_crispy_set_hot_reload (fixture->scripting, TRUE);
+    g_assert_true (lrg_scripting_crispy_get_hot_reload (fixture->scripting));
+    g_assert_true (lrg_scripting_load_file (LRG_SCRIPTING (fixture->scripting),
+                                            fixture->path, &error));
+    g_assert_no_error (error);
+    generation = lrg_scripting_crispy_get_generation (fixture->scripting);
+
+    write_script (fixture, 3);
+    deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+    while (!lrg_scripting_crispy_is_reload_pending (fixture->scripting) &&
+           g_get_monotonic_time () < deadline)
+        g_main_context_iteration (NULL, FALSE);
+
+    if (!lrg_scripting_crispy_is_reload_pending (fixture->scripting))
+    {
+        g_test_skip ("file monitor did not report the change");
+        return;
+    }
+
+    /* Nothing swaps until the frame boundary. */
+    report (fixture->scripting, &total, &scale);
+    g_assert_cmpfloat (scale, ==, 1.0);
+
+    g_value_init (&arg, G_TYPE_DOUBLE);
+    g_value_set_double (&arg, 1.0);
+    g_assert_true (lrg_scripting_call_function (LRG_SCRIPTING (fixture->scripting),
+                                                LRG_SCRIPT_HOOK_UPDATE,
+                                                NULL, 1, &arg, NULL));
+    g_value_unset (&arg);
+
+    g_assert_cmpuint (lrg_scripting_crispy_get_generation (fixture->scripting), !=, generation);
+    report (fixture->scripting, &total, &scale);
+    g_assert_cmpfloat (scale, ==, 3.0);
+    g_assert_cmpfloat_with_epsilon (total, 3.0, 1e-9);
+
+    /* A broken edit keeps the running module. */
+    g_assert_true (g_file_set_contents (fixture->path, "not C at all", -1, NULL));
+    deadline = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+    while (!lrg_scripting_crispy_is_reload_pending (fixture->scripting) &&
+           g_get_monotonic_time () < deadline)
+        g_main_context_iteration (NULL, FALSE);
+
+    if (!lrg_scripting_crispy_is_reload_pending (fixture->scripting))
+    {
+        g_test_skip ("file monitor did not report the broken edit");
+        return;
+    }
+
+    g_assert_false (lrg_scripting_crispy_apply_pending_reload (fixture->scripting, &error));
+    g_assert_nonnull (error);
+    report (fixture->scripting, &total, &scale);
+    g_assert_cmpfloat (scale, ==, 3.0);
+}
+
+static void
+test_scripting_crispy_reset (CrispyFixture *fixture,
+                             gconstpointer  user_data)
+{
+    guint generation;
+
+    (void)user_data;
+
+    g_assert_true (lrg_scripting_load_file (LRG_SCRIPTING (fixture->scripting),
+                                            fixture->path, NULL));
+    generation = lrg_scripting_crispy_get_generation (fixture->scripting);
+
+    lrg_scripting_reset (LRG_SCRIPTING (fixture->scripting));
+    g_assert_cmpuint (lrg_scripting_crispy_get_generation (fixture->scripting), !=, generation);
+    g_assert_false (lrg_scripting_crispy_call_void (fixture->scripting, "report", NULL));
+}
+
+/* ==========================================================================
+ * Main
+ * ========================================================================== */
+
+int
+main (int   argc,
+      char *argv[])
+{
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add ("/scripting-crispy/fast-calls",
+                CrispyFixture, NULL,
+                crispy_fixture_set_up,
+                test_scripting_crispy_fast_calls,
+                crispy_fixture_tear_down);
+
+    g_test_add ("/scripting-crispy/hot-reload",
+                CrispyFixture, NULL,
+                crispy_fixture_set_up,
+                test_scripting_crispy_hot_reload,
+                crispy_fixture_tear_down);
+
+    g_test_add ("/scripting-crispy/reset",
+                CrispyFixture, NULL,
+                crispy_fixture_set_up,
+                test_scripting_crispy_reset,
+                crispy_fixture_tear_down);
+
+    return g_test_run ();
+}
@@ -784,6 +784,126 @@ test_scripting_update_hooks (ScriptingFixture *fixture,
     g_value_unset (&get_value);
 }
 
+static void
+test_scripting_update_hooks_reload (ScriptingFixture *fixture,
+                                    gconstpointer     user_data)
+{
+    g_autoptr(GError) error = NULL;
+    GValue            get_value = G_VALUE_INIT;
+
+    g_assert_true (lrg_scripting_load_string (LRG_SCRIPTING (fixture->scripting),
+                                              "v1",
+                                              "ticks = 0\n"
+                                              "function game_update(delta)\n"
+                                              "    ticks = ticks + 1\n"
+                                              "end",
+                                              &error));
+    g_assert_no_error (error);
+
+    lrg_scripting_lua_register_update_hook (fixture->scripting, "game_update");
+    lrg_scripting_lua_update (fixture->scripting, 0.016f);
+
+    /* Reloading replaces the cached function */
+    g_assert_true (lrg_scripting_load_string (LRG_SCRIPTING (fixture->scripting),
+                                              "v2",
+                                              "function game_update(delta)\n"
+                                              "    ticks = ticks + 10\n"
+                                              "end",
+                                              &error));
+    g_assert_no_error (error);
+    lrg_scripting_lua_update (fixture->scripting, 0.016f);
+
+    /* So does a redefinition the backend cannot see, once invalidated */
+    g_assert_true (lrg_scripting_load_string (LRG_SCRIPTING (fixture->scripting),
+                                              "v3",
+                                              "function swap_hook()\n"
+                                              "    game_update = function(delta) ticks = ticks + 100 end\n"
+                                              "end",
+                                              &error));
+    g_assert_no_error (error);
+    g_assert_true (lrg_scripting_call_function (LRG_SCRIPTING (fixture->scripting),
+                                                "swap_hook", NULL, 0, NULL, &error));
+    g_assert_no_error (error);
+    lrg_scripting_lua_update (fixture->scripting, 0.016f);
+    lrg_scripting_lua_invalidate_update_hooks (fixture->scripting);
+    lrg_scripting_lua_update (fixture->scripting, 0.016f);
+
+    g_assert_true (lrg_scripting_get_global (LRG_SCRIPTING (fixture->scripting),
+                                             "ticks", &get_value, &error));
+    g_assert_no_error (error);
+    g_assert_cmpfloat_with_epsilon (get_numeric_value (&get_value), 121.0, 0.001);
+    g_value_unset (&get_value);
+
+    g_assert_true (lrg_scripting_lua_unregister_update_hook (fixture->scripting, "game_update"));
+    lrg_scripting_lua_update (fixture->scripting, 0.016f);
+}
+
+/* ==========================================================================
+ * Test Cases - FFI Views
+ * ========================================================================== */
+
+static void
+test_scripting_views (ScriptingFixture *fixture,
+                      gconstpointer     user_data)
+{
+    g_autoptr(GError)                error = NULL;
+    g_autoptr(LrgTransformComponent) transform = NULL;
+    g_autoptr(LrgRigidBody)          body = NULL;
+    GValue                           value = G_VALUE_INIT;
+    gfloat                           vel_x;
+    gfloat                           vel_y;
+
+    g_assert_true (lrg_scripting_load_string (LRG_SCRIPTING (fixture->scripting),
+                                              "probe",
+                                              "has_views = Views ~= nil",
+                                              &error));
+    g_assert_true (lrg_scripting_get_global (LRG_SCRIPTING (fixture->scripting),
+                                             "has_views", &value, &error));
+    g_assert_no_error (error);
+    if (!g_value_get_boolean (&value))
+    {
+        g_value_unset (&value);
+        g_test_skip ("LuaJIT built without FFI");
+        return;
+    }
+    g_value_unset (&value);
+
+    transform = lrg_transform_component_new_at (1.0f, 2.0f);
+    body = lrg_rigid_body_new (LRG_RIGID_BODY_DYNAMIC);
+    lrg_rigid_body_set_velocity (body, 3.0f, 4.0f);
+
+    g_value_init (&value, G_TYPE_OBJECT);
+    g_value_set_object (&value, transform);
+    lrg_scripting_set_global (LRG_SCRIPTING (fixture->scripting), "transform", &value, NULL);
+    g_value_unset (&value);
+
+    g_value_init (&value, G_TYPE_OBJECT);
+    g_value_set_object (&value, body);
+    lrg_scripting_set_global (LRG_SCRIPTING (fixture->scripting), "body", &value, NULL);
+    g_value_unset (&value);
+
+    g_assert_true (lrg_scripting_load_string (LRG_SCRIPTING (fixture->scripting),
+                                              "views",
+                                              "local t = Views.transform(transform)\n"
+                                              "local b = Views.rigid_body(body)\n"
+                                              "t.local_x = t.local_x + t.local_y\n"
+                                              "b.vel_x, b.vel_y = b.vel_y, b.vel_x\n",
+                                              &error));
+    g_assert_no_error (error);
+
+    g_assert_cmpfloat (lrg_transform_component_get_local_x (transform), ==, 3.0f);
+    lrg_rigid_body_get_velocity (body, &vel_x, &vel_y);
+    g_assert_cmpfloat (vel_x, ==, 4.0f);
+    g_assert_cmpfloat (vel_y, ==, 3.0f);
+
+    /* Wrong type is a Lua error, not a bad cast */
+    g_assert_false (lrg_scripting_load_string (LRG_SCRIPTING (fixture->scripting),
+                                               "bad-view",
+                                               "Views.rigid_body(transform)",
+                                               &error));
+    g_assert_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_RUNTIME);
+}
+
 /* ==========================================================================
  * Test Cases - Reset
  * ========================================================================== */
@@ -834,6 +954,102 @@ test_scripting_reset (ScriptingFixture *fixture,
     /* If result is FALSE, that's also acceptable - value doesn't exist */
 }
 
+/* ==========================================================================
+ * Test Cases - Job System
+ * ========================================================================== */
+
+static const gchar agent_script[] =
+    "function agent_update(agent, delta)\n"
+    "    Commands.set(agent, 'value', agent.value + 1)\n"
+    "end\n"
+    "function broken_update(agent, delta)\n"
+    "    Commands.set(agent, 'value', 7)\n"
+    "    error('boom')\n"
+    "end\n";
+
+static void
+test_scripting_job_system (void)
+{
+    g_autoptr(LrgScriptJobSystem) jobs = NULL;
+    g_autoptr(GPtrArray)          agents = NULL;
+    g_autoptr(GError)             error = NULL;
+    guint                         min_count = G_MAXUINT;
+    guint                         max_count = 0;
+    guint                         i;
+
+    jobs = lrg_script_job_system_new (4);
+    g_assert_cmpuint (lrg_script_job_system_get_worker_count (jobs), ==, 4);
+    g_assert_true (lrg_script_job_system_load_string (jobs, "agents", agent_script, &error));
+    g_assert_no_error (error);
+
+    agents = g_ptr_array_new_with_free_func (g_object_unref);
+    for (i = 0; i < 103; i++)
+    {
+        GObject *agent = g_object_new (TEST_TYPE_OBJECT, "value", (gint)i, NULL);
+
+        g_ptr_array_add (agents, agent);
+        lrg_script_job_system_add_entity (jobs, agent, "agent_update");
+    }
+
+    /* Agents are spread evenly */
+    g_assert_cmpuint (lrg_script_job_system_get_entity_count (jobs, -1), ==, 103);
+    for (i = 0; i < 4; i++)
+    {
+        guint count = lrg_script_job_system_get_entity_count (jobs, (gint)i);
+
+        min_count = MIN (min_count, count);
+        max_count = MAX (max_count, count);
+    }
+    g_assert_cmpuint (max_count - min_count, <=, 1);
+
+    for (i = 0; i < 3; i++)
+    {
+        g_assert_true (lrg_script_job_system_run (jobs, 0.016, &error));
+        g_assert_no_error (error);
+        g_assert_cmpuint (lrg_script_job_system_get_command_count (jobs), ==, 103);
+    }
+
+    for (i = 0; i < agents->len; i++)
+        g_assert_cmpint (TEST_OBJECT (g_ptr_array_index (agents, i))->value, ==, (gint)i + 3);
+
+    /* A removed agent is left alone */
+    g_assert_true (lrg_script_job_system_remove_entity (jobs, g_ptr_array_index (agents, 0)));
+    g_assert_false (lrg_script_job_system_remove_entity (jobs, g_ptr_array_index (agents, 0)));
+    g_assert_true (lrg_script_job_system_run (jobs, 0.016, &error));
+    g_assert_cmpint (TEST_OBJECT (g_ptr_array_index (agents, 0))->value, ==, 3);
+    g_assert_cmpint (TEST_OBJECT (g_ptr_array_index (agents, 1))->value, ==, 5);
+}
+
+static void
+test_scripting_job_system_errors (void)
+{
+    g_autoptr(LrgScriptJobSystem) jobs = NULL;
+    g_autoptr(GObject)            good = NULL;
+    g_autoptr(GObject)            bad = NULL;
+    g_autoptr(GError)             error = NULL;
+
+    jobs = lrg_script_job_system_new (2);
+    g_assert_true (lrg_script_job_system_load_string (jobs, "agents", agent_script, NULL));
+
+    good = g_object_new (TEST_TYPE_OBJECT, "value", 1, NULL);
+    bad = g_object_new (TEST_TYPE_OBJECT, "value", 1, NULL);
+    lrg_script_job_system_add_entity (jobs, good, "agent_update");
+    lrg_script_job_system_add_entity (jobs, bad, "broken_update");
+
+    /* The failure is reported, everything else still lands */
+    g_assert_false (lrg_script_job_system_run (jobs, 0.016, &error));
+    g_assert_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_RUNTIME);
+    g_assert_cmpint (TEST_OBJECT (good)->value, ==, 2);
+    g_assert_cmpint (TEST_OBJECT (bad)->value, ==, 7);
+    g_clear_error (&error);
+
+    g_assert_true (lrg_script_job_system_remove_entity (jobs, bad));
+    lrg_script_job_system_add_entity (jobs, bad, "no_such_function");
+    g_assert_false (lrg_script_job_system_run (jobs, 0.016, &error));
+    g_assert_error (error, LRG_SCRIPTING_ERROR, LRG_SCRIPTING_ERROR_NOT_FOUND);
+    g_assert_cmpint (TEST_OBJECT (good)->value, ==, 3);
+}
+
 /* ==========================================================================
  * Test Cases - Engine Integration
  * ========================================================================== */
@@ -1267,6 +1483,19 @@ main (int   argc,
                 test_scripting_update_hooks,
                 scripting_fixture_tear_down);
 
+    g_test_add ("/scripting/update-hooks/reload",
+                ScriptingFixture, NULL,
+                scripting_fixture_set_up,
+                test_scripting_update_hooks_reload,
+                scripting_fixture_tear_down);
+
+    /* FFI views */
+    g_test_add ("/scripting/views",
+                ScriptingFixture, NULL,
+                scripting_fixture_set_up,
+                test_scripting_views,
+                scripting_fixture_tear_down);
+
     /* Reset */
     g_test_add ("/scripting/reset",
                 ScriptingFixture, NULL,
@@ -1277,6 +1506,10 @@ main (int   argc,
     /* Engine integration */
     g_test_add_func ("/scripting/engine-integration", test_scripting_engine_integration);
 
+    /* Job system */
+    g_test_add_func ("/scripting/job-system", test_scripting_job_system);
+    g_test_add_func ("/scripting/job-system/errors", test_scripting_job_system_errors);
+
     /* LrgScriptable interface tests */
     g_test_add ("/scripting/scriptable/interface",
                 ScriptableFixture, NULL,
@@ -5,13 +5,14 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  *
  * Tests for the terminal/display backend module (output_lrg): render-mode enum,
- * glyph key/metrics boxed types, the GL-free shelf packer, and (with a display)
- * the Lrg2DSurface upload/draw path.
+ * glyph key/metrics boxed types, the GL-free skyline packer and LRU eviction,
+ * and (with a display) the Lrg2DSurface upload/draw path.
  */
 
 #include <libregnum.h>
 #include <graylib.h>
 #include <glib.h>
+#include <string.h>
 
 #define SKIP_IF_NO_DISPLAY() \
     do { \
@@ -173,6 +174,163 @@ test_atlas_packing (void)
     g_assert_false (lrg_glyph_atlas_reserve (atlas, 100, 100, &pg, &x, &y));
 }
 
+static void
+test_atlas_skyline (void)
+{
+    g_autoptr(LrgGlyphAtlas) atlas = lrg_glyph_atlas_new (64, 64);
+    guint pg = 99;
+    gint x = -1, y = -1;
+
+    /* A tall glyph, then a short one beside it. */
+    g_assert_true (lrg_glyph_atlas_reserve (atlas, 30, 40, &pg, &x, &y));
+    g_assert_cmpint (x, ==, 1);
+    g_assert_cmpint (y, ==, 1);
+    g_assert_true (lrg_glyph_atlas_reserve (atlas, 30, 10, &pg, &x, &y));
+    g_assert_cmpint (x, ==, 32);
+    g_assert_cmpint (y, ==, 1);
+
+    /* The next short glyph stacks on the short one rather than starting a
+     * shelf below the tall one. */
+    g_assert_true (lrg_glyph_atlas_reserve (atlas, 30, 10, &pg, &x, &y));
+    g_assert_cmpuint (pg, ==, 0);
+    g_assert_cmpint (x, ==, 32);
+    g_assert_cmpint (y, ==, 12);
+    g_assert_cmpuint (lrg_glyph_atlas_get_page_count (atlas), ==, 1);
+}
+
+static LrgGlyphMetrics *
+upload_solid (LrgGlyphAtlas *atlas,
+              guint32        code,
+              gint           size)
+{
+    g_autoptr(LrgGlyphKey) key = lrg_glyph_key_new (1, code, 0);
+    g_autofree guint8 *pixels = g_malloc ((gsize) size * size * 4);
+
+    memset (pixels, (int) code, (gsize) size * size * 4);
+    return lrg_glyph_atlas_upload (atlas, key, pixels, size, size,
+                                   0, size, size, FALSE);
+}
+
+static LrgGlyphMetrics *
+lookup_code (LrgGlyphAtlas *atlas,
+             guint32        code)
+{
+    g_autoptr(LrgGlyphKey) key = lrg_glyph_key_new (1, code, 0);
+
+    return lrg_glyph_atlas_lookup (atlas, key);
+}
+
+static void
+on_page_evicted (LrgGlyphAtlas *atlas,
+                 guint          page,
+                 gpointer       user_data)
+{
+    guint *count = user_data;
+
+    (void) atlas;
+    g_assert_cmpuint (page, ==, 0);
+    (*count)++;
+}
+
+static void
+test_atlas_lru_eviction (void)
+{
+    g_autoptr(LrgGlyphAtlas) atlas = lrg_glyph_atlas_new (32, 32);
+    LrgGlyphMetrics *c;
+    LrgGlyphMetrics *m;
+    const guint8 *px;
+    guint evicted = 0;
+    gint x, y;
+    guint32 code;
+
+    /* 14x14 glyphs pack four to a 32x32 page. */
+    lrg_glyph_atlas_set_max_pages (atlas, 2);
+    g_assert_cmpuint (lrg_glyph_atlas_get_max_pages (atlas), ==, 2);
+    g_signal_connect (atlas, "page-evicted", G_CALLBACK (on_page_evicted),
+                      &evicted);
+
+    /* Frame 1: A-D fill page 0. */
+    lrg_glyph_atlas_begin_frame (atlas);
+    for (code = 'A'; code <= 'D'; code++)
+        g_assert_nonnull (upload_solid (atlas, code, 14));
+    g_assert_cmpuint (lrg_glyph_atlas_get_page_count (atlas), ==, 1);
+
+    /* Frame 2: E-H fill page 1, and C is still in use. */
+    lrg_glyph_atlas_begin_frame (atlas);
+    for (code = 'E'; code <= 'H'; code++)
+        g_assert_nonnull (upload_solid (atlas, code, 14));
+    c = lookup_code (atlas, 'C');
+    g_assert_nonnull (c);
+    g_assert_cmpuint (lrg_glyph_atlas_get_page_count (atlas), ==, 2);
+
+    /* Frame 3: page 1 is in use, so I recycles page 0. Only C survived
+     * the page's last frame; it is repacked to the top-left corner. */
+    lrg_glyph_atlas_begin_frame (atlas);
+    g_assert_nonnull (lookup_code (atlas, 'E'));
+    m = upload_solid (atlas, 'I', 14);
+    g_assert_nonnull (m);
+
+    g_assert_cmpuint (evicted, ==, 1);
+    g_assert_cmpuint (lrg_glyph_atlas_get_page_count (atlas), ==, 2);
+    g_assert_cmpuint (lrg_glyph_atlas_get_glyph_count (atlas), ==, 6);
+    g_assert_null (lookup_code (atlas, 'A'));
+    g_assert_null (lookup_code (atlas, 'D'));
+    g_assert_true (lookup_code (atlas, 'C') == c);
+
+    lrg_glyph_metrics_get_rect (c, &x, &y, NULL, NULL);
+    g_assert_cmpuint (lrg_glyph_metrics_get_page (c), ==, 0);
+    g_assert_cmpint (x, ==, 1);
+    g_assert_cmpint (y, ==, 1);
+
+    lrg_glyph_metrics_get_rect (m, &x, &y, NULL, NULL);
+    g_assert_cmpuint (lrg_glyph_metrics_get_page (m), ==, 0);
+    g_assert_cmpint (x, ==, 16);
+    g_assert_cmpint (y, ==, 1);
+
+    /* C's pixels moved with it; the evicted glyphs' pixels are gone. */
+    px = lrg_glyph_atlas_get_page_pixels (atlas, 0);
+    g_assert_nonnull (px);
+    g_assert_cmpuint (px[(1 * 32 + 1) * 4], ==, 'C');
+    g_assert_cmpuint (px[(14 * 32 + 14) * 4], ==, 'C');
+    g_assert_cmpuint (px[(1 * 32 + 16) * 4], ==, 'I');
+    g_assert_cmpuint (px[(20 * 32 + 20) * 4], ==, 0);
+}
+
+static void
+test_atlas_soft_budget (void)
+{
+    g_autoptr(LrgGlyphAtlas) atlas = lrg_glyph_atlas_new (32, 32);
+    guint32 code;
+
+    g_object_set (atlas, "max-pages", 1, NULL);
+    lrg_glyph_atlas_begin_frame (atlas);
+
+    /* Everything is in use this frame, so the atlas grows past its
+     * budget instead of moving glyphs that may already be queued. */
+    for (code = 'A'; code <= 'E'; code++)
+        g_assert_nonnull (upload_solid (atlas, code, 14));
+    g_assert_cmpuint (lrg_glyph_atlas_get_page_count (atlas), ==, 2);
+    g_assert_cmpuint (lrg_glyph_atlas_get_glyph_count (atlas), ==, 5);
+}
+
+static void
+test_atlas_dirty_rect (void)
+{
+    g_autoptr(LrgGlyphAtlas) atlas = lrg_glyph_atlas_new (32, 32);
+    gint x, y, w, h;
+
+    g_assert_false (lrg_glyph_atlas_get_dirty_rect (atlas, 0, &x, &y, &w, &h));
+
+    /* Both glyphs go out in one upload covering their union. */
+    upload_solid (atlas, 'A', 14);
+    upload_solid (atlas, 'B', 14);
+    g_assert_true (lrg_glyph_atlas_get_dirty_rect (atlas, 0, &x, &y, &w, &h));
+    g_assert_cmpint (x, ==, 1);
+    g_assert_cmpint (y, ==, 1);
+    g_assert_cmpint (w, ==, 29);
+    g_assert_cmpint (h, ==, 14);
+}
+
 /* ----------------------------------------------- surface + upload (GL) ----- */
 
 static void
@@ -268,6 +426,9 @@ test_surface_upload_draw (void)
         lrg_frame_surface_end_frame (fs);
     }
 
+    /* Each frame after the first advanced the atlas it drew from. */
+    g_assert_cmpuint (lrg_glyph_atlas_get_frame (atlas), ==, 4);
+
     g_free (pixels);
     g_clear_object (&atlas);
 }
@@ -693,6 +854,10 @@ main (int   argc,
     g_test_add_func ("/term/glyph-key", test_glyph_key);
     g_test_add_func ("/term/glyph-metrics", test_glyph_metrics);
     g_test_add_func ("/term/atlas-packing", test_atlas_packing);
+    g_test_add_func ("/term/atlas-skyline", test_atlas_skyline);
+    g_test_add_func ("/term/atlas-lru-eviction", test_atlas_lru_eviction);
+    g_test_add_func ("/term/atlas-soft-budget", test_atlas_soft_budget);
+    g_test_add_func ("/term/atlas-dirty-rect", test_atlas_dirty_rect);
     g_test_add_func ("/term/surface-upload-draw", test_surface_upload_draw);
     g_test_add_func ("/term/surface-draw-offset", test_frame_surface_draw_offset);
     g_test_add_func ("/term/mode-enums", test_mode_enums);
@@ -448,6 +448,163 @@ test_rich_text_new_from_markup (void)
     g_assert_cmpstr (lrg_rich_text_get_plain_text (text), ==, "Bold and italic");
 }
 
+/*
+ * Layout cache.  No font is loaded in tests, so the font manager measures
+ * every character as 0.6 × font size: 6 units at size 10.
+ */
+
+static void
+test_rich_text_layout_positions (RichTextFixture *fixture,
+                                 gconstpointer    user_data)
+{
+    gfloat x, y;
+
+    (void) user_data;
+
+    lrg_rich_text_set_font_size (fixture->text, 10.0f);
+    lrg_rich_text_set_line_spacing (fixture->text, 1.2f);
+    lrg_rich_text_set_markup (fixture->text, "[b]He[/b]llo\nWorld");
+
+    /* The newline takes no glyph */
+    g_assert_cmpuint (lrg_rich_text_get_glyph_count (fixture->text), ==, 10);
+
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 1, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 6.0f, 0.001f);
+    g_assert_cmpfloat_with_epsilon (y, 0.0f, 0.001f);
+
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 4, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 24.0f, 0.001f);
+
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 6, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 6.0f, 0.001f);
+    g_assert_cmpfloat_with_epsilon (y, 12.0f, 0.001f);
+
+    g_assert_false (lrg_rich_text_get_glyph_position (fixture->text, 10, NULL, NULL));
+
+    /* "He", "llo" and "World": one run per span per line */
+    g_assert_cmpuint (lrg_rich_text_get_run_count (fixture->text), ==, 3);
+}
+
+static void
+test_rich_text_layout_wrap (RichTextFixture *fixture,
+                            gconstpointer    user_data)
+{
+    gfloat x, y;
+
+    (void) user_data;
+
+    lrg_rich_text_set_font_size (fixture->text, 10.0f);
+    lrg_rich_text_set_markup (fixture->text, "Hello");
+    lrg_rich_text_set_max_width (fixture->text, 20.0f);
+
+    /* The glyph that crosses the width stays; the next one wraps */
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 3, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 18.0f, 0.001f);
+    g_assert_cmpfloat_with_epsilon (y, 0.0f, 0.001f);
+
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 4, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 0.0f, 0.001f);
+    g_assert_cmpfloat_with_epsilon (y, 12.0f, 0.001f);
+    g_assert_cmpuint (lrg_rich_text_get_run_count (fixture->text), ==, 2);
+}
+
+static void
+test_rich_text_layout_invalidation (RichTextFixture *fixture,
+                                    gconstpointer    user_data)
+{
+    gfloat x, y;
+
+    (void) user_data;
+
+    lrg_rich_text_set_font_size (fixture->text, 10.0f);
+    lrg_rich_text_set_markup (fixture->text, "Hello");
+    lrg_rich_text_set_max_width (fixture->text, 20.0f);
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 4, &x, &y));
+    g_assert_cmpfloat_with_epsilon (y, 12.0f, 0.001f);
+
+    /* Each layout input re-lays the text out */
+    lrg_rich_text_set_max_width (fixture->text, 0.0f);
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 4, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 24.0f, 0.001f);
+    g_assert_cmpfloat_with_epsilon (y, 0.0f, 0.001f);
+
+    g_object_set (fixture->text, "font-size", 20.0f, NULL);
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 4, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 48.0f, 0.001f);
+
+    lrg_rich_text_set_max_width (fixture->text, 30.0f);
+    lrg_rich_text_set_line_spacing (fixture->text, 2.0f);
+    g_assert_true (lrg_rich_text_get_glyph_position (fixture->text, 3, &x, &y));
+    g_assert_cmpfloat_with_epsilon (x, 0.0f, 0.001f);
+    g_assert_cmpfloat_with_epsilon (y, 40.0f, 0.001f);
+
+    lrg_rich_text_set_markup (fixture->text, "Hi");
+    g_assert_cmpuint (lrg_rich_text_get_glyph_count (fixture->text), ==, 2);
+
+    lrg_rich_text_set_markup (fixture->text, "");
+    g_assert_cmpuint (lrg_rich_text_get_glyph_count (fixture->text), ==, 0);
+    g_assert_cmpuint (lrg_rich_text_get_run_count (fixture->text), ==, 0);
+}
+
+/*
+ * Per-frame cost of a 5,000 character dialog with animated spans.  Without
+ * the cache every draw laid the text out again; with it a frame only
+ * updates effects.  Drawing needs a window, so this times the layout and
+ * effect work that draw does on the CPU.
+ */
+static void
+test_rich_text_layout_perf (void)
+{
+    g_autoptr(LrgRichText) text = NULL;
+    g_autoptr(GString)     markup = NULL;
+    GTimer *timer;
+    guint   frames = 200;
+    guint   f;
+    gdouble uncached_ms;
+    gdouble cached_ms;
+
+    if (!g_test_perf ())
+    {
+        g_test_skip ("performance test; run with -m perf");
+        return;
+    }
+
+    /* 80 lines of 64 characters */
+    markup = g_string_new (NULL);
+    for (f = 0; f < 80; f++)
+        g_string_append (markup, "[wave]The quick brown fox[/wave] jumps over "
+                                 "[color=red]the lazy dog[/color] near the "
+                                 "[b]river[/b] bank.\n");
+
+    text = lrg_rich_text_new_from_markup (markup->str);
+    lrg_rich_text_set_max_width (text, 400.0f);
+    g_assert_cmpuint (lrg_rich_text_get_glyph_count (text), >=, 5000);
+
+    timer = g_timer_new ();
+    for (f = 0; f < frames; f++)
+    {
+        lrg_rich_text_invalidate_layout (text);
+        lrg_rich_text_update (text, 0.016f);
+        g_assert_cmpuint (lrg_rich_text_get_glyph_count (text), >=, 5000);
+    }
+    uncached_ms = g_timer_elapsed (timer, NULL) * 1000.0 / frames;
+
+    g_timer_start (timer);
+    for (f = 0; f < frames; f++)
+    {
+        lrg_rich_text_update (text, 0.016f);
+        g_assert_cmpuint (lrg_rich_text_get_glyph_count (text), >=, 5000);
+    }
+    cached_ms = g_timer_elapsed (timer, NULL) * 1000.0 / frames;
+    g_timer_destroy (timer);
+
+    g_test_minimized_result (cached_ms,
+                             "%u glyphs in %u runs: %.3f ms/frame uncached, %.4f ms/frame cached",
+                             lrg_rich_text_get_glyph_count (text),
+                             lrg_rich_text_get_run_count (text),
+                             uncached_ms, cached_ms);
+}
+
 /*
  * ============================================================================
  * Main
@@ -499,6 +656,13 @@ main (int   argc,
                 rich_text_fixture_set_up, test_rich_text_line_spacing, rich_text_fixture_tear_down);
     g_test_add ("/text/rich-text/max-width", RichTextFixture, NULL,
                 rich_text_fixture_set_up, test_rich_text_max_width, rich_text_fixture_tear_down);
+    g_test_add ("/text/rich-text/layout/positions", RichTextFixture, NULL,
+                rich_text_fixture_set_up, test_rich_text_layout_positions, rich_text_fixture_tear_down);
+    g_test_add ("/text/rich-text/layout/wrap", RichTextFixture, NULL,
+                rich_text_fixture_set_up, test_rich_text_layout_wrap, rich_text_fixture_tear_down);
+    g_test_add ("/text/rich-text/layout/invalidation", RichTextFixture, NULL,
+                rich_text_fixture_set_up, test_rich_text_layout_invalidation, rich_text_fixture_tear_down);
+    g_test_add_func ("/text/rich-text/layout/perf", test_rich_text_layout_perf);
     g_test_add ("/text/rich-text/alignment", RichTextFixture, NULL,
                 rich_text_fixture_set_up, test_rich_text_alignment, rich_text_fixture_tear_down);
     g_test_add ("/text/rich-text/default-color", RichTextFixture, NULL,
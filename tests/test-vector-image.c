@@ -112,6 +112,42 @@ get_pixel_rgba (GrlImage *image,
     *out_a = c->a;
 }
 
+/*
+ * max_channel_diff:
+ *
+ * Largest difference between matching colour channels of two images of
+ * the same size.  0 means the images are pixel-identical.
+ */
+static guint
+max_channel_diff (GrlImage *a,
+                  GrlImage *b)
+{
+    guint max_diff = 0;
+    gint  x;
+    gint  y;
+
+    g_assert_cmpint (grl_image_get_width  (a), ==, grl_image_get_width  (b));
+    g_assert_cmpint (grl_image_get_height (a), ==, grl_image_get_height (b));
+
+    for (y = 0; y < grl_image_get_height (a); y++)
+    {
+        for (x = 0; x < grl_image_get_width (a); x++)
+        {
+            guint8 pa[4];
+            guint8 pb[4];
+            gint   c;
+
+            get_pixel_rgba (a, x, y, &pa[0], &pa[1], &pa[2], &pa[3]);
+            get_pixel_rgba (b, x, y, &pb[0], &pb[1], &pb[2], &pb[3]);
+
+            for (c = 0; c < 4; c++)
+                max_diff = MAX (max_diff, (guint) ABS ((gint) pa[c] - (gint) pb[c]));
+        }
+    }
+
+    return max_diff;
+}
+
 /* ==========================================================================
  * Sample SVG data
  *
@@ -410,6 +446,279 @@ test_vector_image_render_preserve_aspect_letterbox (void)
     g_assert_cmpuint (a, <, 32);
 }
 
+/* ==========================================================================
+ * Test: raster cache
+ * ========================================================================== */
+
+static void
+test_vector_image_cache_hit_identical (void)
+{
+    g_autoptr(LrgVectorImage) vi        = NULL;
+    g_autoptr(GError)         error     = NULL;
+    g_autoptr(GrlImage)       reference = NULL;
+    g_autoptr(GrlImage)       first     = NULL;
+    g_autoptr(GrlImage)       second    = NULL;
+    guint                     hits;
+    guint                     misses;
+    gsize                     bytes;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+
+    /* Uncached rasterization as the reference */
+    lrg_vector_image_set_cache_budget (vi, 0);
+    reference = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    g_assert_nonnull (reference);
+
+    lrg_vector_image_set_cache_budget (vi, 1024 * 1024);
+    first = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    second = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    g_assert_nonnull (first);
+    g_assert_nonnull (second);
+
+    lrg_vector_image_get_cache_stats (vi, &hits, &misses, &bytes);
+    g_assert_cmpuint (hits, ==, 1);
+    g_assert_cmpuint (misses, ==, 2);
+    g_assert_cmpuint (bytes, ==, 64 * 64 * 4);
+
+    /* Hits are copies, identical to a fresh rasterization */
+    g_assert_true (first != second);
+    g_assert_cmpuint (max_channel_diff (reference, first), ==, 0);
+    g_assert_cmpuint (max_channel_diff (reference, second), ==, 0);
+}
+
+static void
+test_vector_image_cache_copy_isolated (void)
+{
+    g_autoptr(LrgVectorImage) vi     = NULL;
+    g_autoptr(GError)         error  = NULL;
+    g_autoptr(GrlImage)       first  = NULL;
+    g_autoptr(GrlImage)       second = NULL;
+    g_autoptr(GrlColor)       white  = NULL;
+    guint8                    r;
+    guint8                    g;
+    guint8                    b;
+    guint8                    a;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+
+    /* Drawing on a returned image must not reach the cached raster */
+    white = grl_color_new (255, 255, 255, 255);
+    first = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    grl_image_draw_pixel (first, 0, 0, white);
+
+    second = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    get_pixel_rgba (second, 0, 0, &r, &g, &b, &a);
+    g_assert_cmpuint (a, <, 32);
+}
+
+static void
+test_vector_image_cache_key (void)
+{
+    g_autoptr(LrgVectorImage) vi    = NULL;
+    g_autoptr(GError)         error = NULL;
+    g_autoptr(GrlColor)       white = NULL;
+    g_autoptr(GrlColor)       clear = NULL;
+    guint                     hits;
+    guint                     misses;
+    gint                      pass;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+
+    white = grl_color_new (255, 255, 255, 255);
+    clear = grl_color_new (0, 0, 0, 0);
+
+    /* Size, background and aspect mode each select a different raster */
+    for (pass = 0; pass < 2; pass++)
+    {
+        g_autoptr(GrlImage) a = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+        g_autoptr(GrlImage) b = lrg_vector_image_render (vi, 32, 64, NULL, FALSE);
+        g_autoptr(GrlImage) c = lrg_vector_image_render (vi, 64, 64, white, FALSE);
+        g_autoptr(GrlImage) d = lrg_vector_image_render (vi, 64, 64, NULL, TRUE);
+
+        g_assert_nonnull (a);
+        g_assert_nonnull (b);
+        g_assert_nonnull (c);
+        g_assert_nonnull (d);
+    }
+
+    lrg_vector_image_get_cache_stats (vi, &hits, &misses, NULL);
+    g_assert_cmpuint (misses, ==, 4);
+    g_assert_cmpuint (hits, ==, 4);
+
+    /* A transparent background renders the same as none */
+    {
+        g_autoptr(GrlImage) e = lrg_vector_image_render (vi, 64, 64, clear, FALSE);
+
+        g_assert_nonnull (e);
+    }
+    lrg_vector_image_get_cache_stats (vi, &hits, &misses, NULL);
+    g_assert_cmpuint (hits, ==, 5);
+}
+
+static void
+test_vector_image_cache_lru_budget (void)
+{
+    g_autoptr(LrgVectorImage) vi    = NULL;
+    g_autoptr(GError)         error = NULL;
+    g_autoptr(GrlColor)       white = NULL;
+    g_autoptr(GrlImage)       img   = NULL;
+    guint                     hits;
+    guint                     misses;
+    gsize                     bytes;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+
+    white = grl_color_new (255, 255, 255, 255);
+
+    /* Room for exactly two 64×64 rasters */
+    lrg_vector_image_set_cache_budget (vi, 2 * 64 * 64 * 4);
+    g_assert_cmpuint (lrg_vector_image_get_cache_budget (vi), ==, 2 * 64 * 64 * 4);
+
+    img = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);    /* A: miss */
+    g_clear_object (&img);
+    img = lrg_vector_image_render (vi, 64, 64, white, FALSE);   /* B: miss */
+    g_clear_object (&img);
+    img = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);    /* A: hit */
+    g_clear_object (&img);
+    img = lrg_vector_image_render (vi, 64, 64, NULL, TRUE);     /* C: miss, evicts B */
+    g_clear_object (&img);
+
+    lrg_vector_image_get_cache_stats (vi, &hits, &misses, &bytes);
+    g_assert_cmpuint (hits, ==, 1);
+    g_assert_cmpuint (misses, ==, 3);
+    g_assert_cmpuint (bytes, ==, 2 * 64 * 64 * 4);
+
+    img = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);    /* A: hit */
+    g_clear_object (&img);
+    img = lrg_vector_image_render (vi, 64, 64, white, FALSE);   /* B: miss */
+    g_clear_object (&img);
+
+    lrg_vector_image_get_cache_stats (vi, &hits, &misses, NULL);
+    g_assert_cmpuint (hits, ==, 2);
+    g_assert_cmpuint (misses, ==, 4);
+
+    /* Rasters larger than the whole budget are not cached */
+    img = lrg_vector_image_render (vi, 128, 128, NULL, FALSE);
+    g_assert_nonnull (img);
+    g_clear_object (&img);
+    lrg_vector_image_get_cache_stats (vi, NULL, NULL, &bytes);
+    g_assert_cmpuint (bytes, ==, 2 * 64 * 64 * 4);
+
+    /* Shrinking the budget evicts; zero disables caching */
+    lrg_vector_image_set_cache_budget (vi, 64 * 64 * 4);
+    lrg_vector_image_get_cache_stats (vi, NULL, NULL, &bytes);
+    g_assert_cmpuint (bytes, ==, 64 * 64 * 4);
+
+    lrg_vector_image_set_cache_budget (vi, 0);
+    lrg_vector_image_get_cache_stats (vi, NULL, NULL, &bytes);
+    g_assert_cmpuint (bytes, ==, 0);
+
+    img = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    g_assert_nonnull (img);
+    lrg_vector_image_get_cache_stats (vi, &hits, &misses, NULL);
+    g_assert_cmpuint (hits, ==, 2);
+    g_assert_cmpuint (misses, ==, 6);
+}
+
+static void
+test_vector_image_cache_clear (void)
+{
+    g_autoptr(LrgVectorImage) vi    = NULL;
+    g_autoptr(GError)         error = NULL;
+    g_autoptr(GrlImage)       img   = NULL;
+    guint                     misses;
+    gsize                     bytes;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+
+    img = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    g_clear_object (&img);
+    lrg_vector_image_clear_cache (vi);
+
+    lrg_vector_image_get_cache_stats (vi, NULL, NULL, &bytes);
+    g_assert_cmpuint (bytes, ==, 0);
+
+    img = lrg_vector_image_render (vi, 64, 64, NULL, FALSE);
+    lrg_vector_image_get_cache_stats (vi, NULL, &misses, NULL);
+    g_assert_cmpuint (misses, ==, 2);
+}
+
+/* ==========================================================================
+ * Test: tiled rasterization matches a single-piece render
+ * ========================================================================== */
+
+static void
+test_vector_image_tiles_identical (void)
+{
+    g_autoptr(LrgVectorImage) vi        = NULL;
+    g_autoptr(GError)         error     = NULL;
+    g_autoptr(GrlImage)       reference = NULL;
+    g_autoptr(GrlImage)       serial    = NULL;
+    g_autoptr(GrlImage)       parallel  = NULL;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+    lrg_vector_image_set_cache_budget (vi, 0);
+
+    /*
+     * At 100×100 the rect edges land on whole pixels, so tile offsets are
+     * exact and tiling must not change a single pixel.  32 does not divide
+     * 100, so the last row and column of tiles are partial.
+     */
+    reference = lrg_vector_image_render (vi, 100, 100, NULL, FALSE);
+
+    lrg_vector_image_set_tile_size (vi, 32);
+    g_assert_cmpint (lrg_vector_image_get_tile_size (vi), ==, 32);
+
+    lrg_vector_image_set_max_threads (vi, 1);
+    serial = lrg_vector_image_render (vi, 100, 100, NULL, FALSE);
+
+    lrg_vector_image_set_max_threads (vi, 4);
+    g_assert_cmpuint (lrg_vector_image_get_max_threads (vi), ==, 4);
+    parallel = lrg_vector_image_render (vi, 100, 100, NULL, FALSE);
+
+    g_assert_cmpuint (max_channel_diff (reference, serial), ==, 0);
+    g_assert_cmpuint (max_channel_diff (reference, parallel), ==, 0);
+}
+
+static void
+test_vector_image_tiles_thread_independent (void)
+{
+    g_autoptr(LrgVectorImage) vi        = NULL;
+    g_autoptr(GError)         error     = NULL;
+    g_autoptr(GrlColor)       white     = NULL;
+    g_autoptr(GrlImage)       reference = NULL;
+    g_autoptr(GrlImage)       serial    = NULL;
+    g_autoptr(GrlImage)       parallel  = NULL;
+
+    vi = lrg_vector_image_new_from_data (SVG_RECT, strlen (SVG_RECT), &error);
+    g_assert_no_error (error);
+    lrg_vector_image_set_cache_budget (vi, 0);
+
+    white = grl_color_new (255, 255, 255, 255);
+
+    /* Letterboxed at an odd size the edges fall mid-pixel */
+    reference = lrg_vector_image_render (vi, 77, 53, white, TRUE);
+
+    lrg_vector_image_set_tile_size (vi, 16);
+    lrg_vector_image_set_max_threads (vi, 1);
+    serial = lrg_vector_image_render (vi, 77, 53, white, TRUE);
+
+    lrg_vector_image_set_max_threads (vi, 4);
+    parallel = lrg_vector_image_render (vi, 77, 53, white, TRUE);
+
+    /* Threads never change the output */
+    g_assert_cmpuint (max_channel_diff (serial, parallel), ==, 0);
+
+    /* Tile offsets may move edge coverage by a rounding step at most */
+    g_assert_cmpuint (max_channel_diff (reference, serial), <=, 2);
+}
+
 /* ==========================================================================
  * main
  * ========================================================================== */
@@ -445,6 +754,24 @@ main (int   argc,
     g_test_add_func ("/vector-image/render/preserve-aspect-letterbox",
                      test_vector_image_render_preserve_aspect_letterbox);
 
+    /* Raster cache */
+    g_test_add_func ("/vector-image/cache/hit-identical",
+                     test_vector_image_cache_hit_identical);
+    g_test_add_func ("/vector-image/cache/copy-isolated",
+                     test_vector_image_cache_copy_isolated);
+    g_test_add_func ("/vector-image/cache/key",
+                     test_vector_image_cache_key);
+    g_test_add_func ("/vector-image/cache/lru-budget",
+                     test_vector_image_cache_lru_budget);
+    g_test_add_func ("/vector-image/cache/clear",
+                     test_vector_image_cache_clear);
+
+    /* Tiled rasterization */
+    g_test_add_func ("/vector-image/tiles/identical",
+                     test_vector_image_tiles_identical);
+    g_test_add_func ("/vector-image/tiles/thread-independent",
+                     test_vector_image_tiles_thread_independent);
+
     result = g_test_run ();
     cleanup_graphics_context ();
     return result;
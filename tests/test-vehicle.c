@@ -18,6 +18,7 @@
 #include "vehicle/lrg-road.h"
 #include "vehicle/lrg-road-network.h"
 #include "vehicle/lrg-traffic-agent.h"
+#include "vehicle/lrg-traffic-manager.h"
 
 /* ============================================================================
  * LrgWheel Tests
@@ -584,6 +585,336 @@ test_network_nearest (NetworkFixture *fixture,
     g_assert_cmpfloat (fabs (t - 0.5f), <, 0.01f);
 }
 
+static void
+add_straight_road (LrgRoadNetwork *network,
+                   const gchar    *id,
+                   gfloat          x0,
+                   gfloat          z0,
+                   gfloat          x1,
+                   gfloat          z1,
+                   gfloat          speed,
+                   gboolean        one_way)
+{
+    LrgRoad *road;
+
+    road = lrg_road_new (id);
+    lrg_road_add_waypoint (road, x0, 0.0f, z0, 5.0f, speed);
+    lrg_road_add_waypoint (road, x1, 0.0f, z1, 5.0f, speed);
+    lrg_road_set_one_way (road, one_way);
+    g_assert_true (lrg_road_network_add_road (network, road));
+}
+
+static void
+assert_route (GList       *route,
+              const gchar *first,
+              ...)
+{
+    const gchar *expected;
+    va_list args;
+    GList *l;
+
+    va_start (args, first);
+    l = route;
+    for (expected = first; expected != NULL; expected = va_arg (args, const gchar *))
+    {
+        g_assert_nonnull (l);
+        g_assert_cmpstr (l->data, ==, expected);
+        l = l->next;
+    }
+    va_end (args);
+
+    g_assert_null (l);
+}
+
+static void
+test_network_route_weighted (void)
+{
+    LrgRoadNetwork *network;
+    LrgRoad *road;
+    GArray *indices;
+    GList *route;
+    gfloat cost;
+
+    network = lrg_road_network_new ();
+
+    /* A short slow road and a longer fast detour between the same points */
+    add_straight_road (network, "start", 0.0f, 0.0f, 100.0f, 0.0f, 10.0f, TRUE);
+    add_straight_road (network, "slow", 100.0f, 0.0f, 200.0f, 0.0f, 5.0f, TRUE);
+    add_straight_road (network, "fast_a", 100.0f, 0.0f, 150.0f, 50.0f, 50.0f, TRUE);
+    add_straight_road (network, "fast_b", 150.0f, 50.0f, 200.0f, 0.0f, 50.0f, TRUE);
+    add_straight_road (network, "goal", 200.0f, 0.0f, 300.0f, 0.0f, 10.0f, TRUE);
+
+    lrg_road_network_connect (network, "start", TRUE, "slow", FALSE);
+    lrg_road_network_connect (network, "start", TRUE, "fast_a", FALSE);
+    lrg_road_network_connect (network, "slow", TRUE, "goal", FALSE);
+    lrg_road_network_connect (network, "fast_a", TRUE, "fast_b", FALSE);
+    lrg_road_network_connect (network, "fast_b", TRUE, "goal", FALSE);
+
+    g_assert_true (lrg_road_network_find_route (network, "start", 0.5f, "goal", 0.5f, &route));
+    assert_route (route, "start", "fast_a", "fast_b", "goal", NULL);
+    g_list_free (route);
+
+    g_assert_true (lrg_road_network_find_route_indices (network,
+                                                        lrg_road_network_get_road_index (network, "start"), 0.5f,
+                                                        lrg_road_network_get_road_index (network, "goal"), 0.5f,
+                                                        &indices, &cost));
+    g_assert_cmpuint (indices->len, ==, 4);
+    g_assert_cmpint (g_array_index (indices, guint, 1), ==,
+                     lrg_road_network_get_road_index (network, "fast_a"));
+    g_assert_cmpfloat_with_epsilon (cost, 10.0f + 2.0f * sqrtf (5000.0f) / 50.0f, 1e-3);
+    g_array_unref (indices);
+
+    /* Slowing the detour down in place needs an explicit invalidation */
+    road = lrg_road_network_get_road (network, "fast_a");
+    lrg_road_clear_waypoints (road);
+    lrg_road_add_waypoint (road, 100.0f, 0.0f, 0.0f, 5.0f, 1.0f);
+    lrg_road_add_waypoint (road, 150.0f, 0.0f, 50.0f, 5.0f, 1.0f);
+    lrg_road_network_invalidate_routes (network);
+
+    g_assert_true (lrg_road_network_find_route (network, "start", 0.5f, "goal", 0.5f, &route));
+    assert_route (route, "start", "slow", "goal", NULL);
+    g_list_free (route);
+
+    g_object_unref (network);
+}
+
+static void
+test_network_route_direction (void)
+{
+    LrgRoadNetwork *network;
+    GList *route;
+    gint a;
+    gfloat cost;
+
+    network = lrg_road_network_new ();
+
+    /* Two one-way roads forming a loop */
+    add_straight_road (network, "a", 0.0f, 0.0f, 100.0f, 0.0f, 10.0f, TRUE);
+    add_straight_road (network, "b", 100.0f, 0.0f, 0.0f, 0.0f, 10.0f, TRUE);
+    lrg_road_network_connect (network, "a", TRUE, "b", FALSE);
+    lrg_road_network_connect (network, "b", TRUE, "a", FALSE);
+    a = lrg_road_network_get_road_index (network, "a");
+
+    g_assert_true (lrg_road_network_find_route_indices (network, a, 0.2f, a, 0.8f, NULL, &cost));
+    g_assert_cmpfloat_with_epsilon (cost, 6.0f, 1e-3);
+
+    /* Going back along a one-way road means driving around the loop */
+    g_assert_true (lrg_road_network_find_route (network, "a", 0.8f, "a", 0.2f, &route));
+    assert_route (route, "a", "b", "a", NULL);
+    g_list_free (route);
+    g_assert_true (lrg_road_network_find_route_indices (network, a, 0.8f, a, 0.2f, NULL, &cost));
+    g_assert_cmpfloat_with_epsilon (cost, 14.0f, 1e-3);
+
+    /* Connections are directed: b cannot be reached from a's start */
+    lrg_road_network_disconnect (network, "a", TRUE, "b", FALSE);
+    g_assert_false (lrg_road_network_find_route (network, "a", 0.0f, "b", 0.5f, &route));
+    g_assert_null (route);
+
+    /* A two-way road can simply be driven backwards */
+    lrg_road_set_one_way (lrg_road_network_get_road (network, "a"), FALSE);
+    lrg_road_network_invalidate_routes (network);
+    g_assert_true (lrg_road_network_find_route (network, "a", 0.8f, "a", 0.2f, &route));
+    assert_route (route, "a", NULL);
+    g_list_free (route);
+
+    g_object_unref (network);
+}
+
+static void
+test_network_route_cache (NetworkFixture *fixture,
+                          gconstpointer   user_data)
+{
+    GList *route;
+    gint index;
+
+    (void)user_data;
+
+    g_assert_cmpint (lrg_road_network_get_road_index (fixture->network, "road1"), ==, 0);
+    g_assert_cmpint (lrg_road_network_get_road_index (fixture->network, "road2"), ==, 1);
+    g_assert_cmpint (lrg_road_network_get_road_index (fixture->network, "missing"), ==, -1);
+    g_assert_true (lrg_road_network_get_road_by_index (fixture->network, 1) ==
+                   lrg_road_network_get_road (fixture->network, "road2"));
+    g_assert_cmpuint (lrg_road_network_get_route_cache_size (fixture->network), ==, 1024);
+
+    g_assert_true (lrg_road_network_find_route (fixture->network, "road1", 0.0f,
+                                                "road2", 1.0f, NULL));
+
+    /* Cached answers must not survive topology changes */
+    g_assert_true (lrg_road_network_disconnect (fixture->network, "road1", TRUE, "road2", FALSE));
+    g_assert_false (lrg_road_network_find_route (fixture->network, "road1", 0.0f,
+                                                 "road2", 1.0f, NULL));
+
+    g_assert_true (lrg_road_network_connect (fixture->network, "road1", TRUE, "road2", FALSE));
+    g_assert_true (lrg_road_network_find_route (fixture->network, "road1", 0.0f,
+                                                "road2", 1.0f, &route));
+    assert_route (route, "road1", "road2", NULL);
+    g_list_free (route);
+
+    /* Removed indices stay reserved */
+    g_assert_true (lrg_road_network_remove_road (fixture->network, "road1"));
+    g_assert_null (lrg_road_network_get_road_by_index (fixture->network, 0));
+    g_assert_false (lrg_road_network_find_route_indices (fixture->network, 0, 0.0f,
+                                                         1, 1.0f, NULL, NULL));
+    add_straight_road (fixture->network, "road3", 0.0f, 0.0f, 100.0f, 0.0f, 30.0f, FALSE);
+    index = lrg_road_network_get_road_index (fixture->network, "road3");
+    g_assert_cmpint (index, ==, 2);
+
+    lrg_road_network_set_route_cache_size (fixture->network, 0);
+    g_assert_true (lrg_road_network_connect (fixture->network, "road3", TRUE, "road2", FALSE));
+    g_assert_true (lrg_road_network_find_route_indices (fixture->network, index, 0.0f,
+                                                        1, 1.0f, NULL, NULL));
+}
+
+static void
+test_network_route_contraction (void)
+{
+    LrgRoadNetwork *network;
+    GRand *rand;
+    gfloat *positions;
+    gfloat *costs;
+    gboolean *found;
+    guint *queries;
+    const guint size = 8;
+    const guint n_queries = 300;
+    guint n_roads;
+    guint i;
+    guint j;
+
+    network = lrg_road_network_new ();
+    rand = g_rand_new_with_seed (42);
+
+    /* A grid of roads with random speeds and some one-way streets */
+    n_roads = 0;
+    for (i = 0; i < size; i++)
+    {
+        for (j = 0; j < size; j++)
+        {
+            guint horizontal;
+
+            for (horizontal = 0; horizontal < 2; horizontal++)
+            {
+                g_autofree gchar *id = NULL;
+                gfloat x0 = i * 50.0f;
+                gfloat z0 = j * 50.0f;
+                gfloat x1 = x0 + (horizontal ? 50.0f : 0.0f);
+                gfloat z1 = z0 + (horizontal ? 0.0f : 50.0f);
+                gboolean one_way = g_rand_int_range (rand, 0, 4) == 0;
+
+                if ((horizontal && i + 1 == size) || (!horizontal && j + 1 == size))
+                    continue;
+
+                id = g_strdup_printf ("r%u", n_roads++);
+                if (one_way && g_rand_boolean (rand))
+                    add_straight_road (network, id, x1, z1, x0, z0,
+                                       g_rand_double_range (rand, 5.0, 40.0), TRUE);
+                else
+                    add_straight_road (network, id, x0, z0, x1, z1,
+                                       g_rand_double_range (rand, 5.0, 40.0), one_way);
+            }
+        }
+    }
+
+    /* Connect every road end to every other road meeting at that node */
+    for (i = 0; i < n_roads; i++)
+    {
+        LrgRoad *from = lrg_road_network_get_road_by_index (network, i);
+        guint from_end;
+
+        for (from_end = 0; from_end < 2; from_end++)
+        {
+            const LrgRoadWaypoint *p = lrg_road_get_waypoint (from, from_end ? 1 : 0);
+
+            for (j = 0; j < n_roads; j++)
+            {
+                LrgRoad *to = lrg_road_network_get_road_by_index (network, j);
+                guint to_end;
+
+                if (i == j)
+                    continue;
+
+                for (to_end = 0; to_end < 2; to_end++)
+                {
+                    const LrgRoadWaypoint *q = lrg_road_get_waypoint (to, to_end ? 1 : 0);
+
+                    if (p->x == q->x && p->z == q->z)
+                        lrg_road_network_connect (network,
+                                                  lrg_road_get_id (from), from_end,
+                                                  lrg_road_get_id (to), to_end);
+                }
+            }
+        }
+    }
+
+    queries = g_new (guint, n_queries * 2);
+    positions = g_new (gfloat, n_queries * 2);
+    costs = g_new (gfloat, n_queries);
+    found = g_new (gboolean, n_queries);
+    for (i = 0; i < n_queries * 2; i++)
+    {
+        queries[i] = g_rand_int_range (rand, 0, n_roads);
+        positions[i] = g_rand_double (rand);
+    }
+
+    /* Plain A* first, then the hierarchy must agree on every query */
+    for (i = 0; i < n_queries; i++)
+    {
+        costs[i] = 0.0f;
+        found[i] = lrg_road_network_find_route_indices (network,
+                                                        queries[i * 2], positions[i * 2],
+                                                        queries[i * 2 + 1], positions[i * 2 + 1],
+                                                        NULL, &costs[i]);
+    }
+
+    lrg_road_network_set_contraction_enabled (network, TRUE);
+    g_assert_true (lrg_road_network_get_contraction_enabled (network));
+
+    for (i = 0; i < n_queries; i++)
+    {
+        GArray *route = NULL;
+        gfloat cost = 0.0f;
+
+        g_assert_cmpint (lrg_road_network_find_route_indices (network,
+                                                              queries[i * 2], positions[i * 2],
+                                                              queries[i * 2 + 1], positions[i * 2 + 1],
+                                                              &route, &cost), ==, found[i]);
+        if (!found[i])
+            continue;
+
+        g_assert_cmpfloat_with_epsilon (cost, costs[i], 1e-3 * MAX (1.0f, costs[i]));
+        g_assert_cmpuint (g_array_index (route, guint, 0), ==, queries[i * 2]);
+        g_assert_cmpuint (g_array_index (route, guint, route->len - 1), ==, queries[i * 2 + 1]);
+
+        /* Consecutive roads must be connected */
+        for (j = 0; j + 1 < route->len; j++)
+        {
+            const gchar *from_id;
+            const gchar *to_id;
+            GList *start;
+            GList *end;
+
+            from_id = lrg_road_get_id (lrg_road_network_get_road_by_index (
+                network, g_array_index (route, guint, j)));
+            to_id = lrg_road_get_id (lrg_road_network_get_road_by_index (
+                network, g_array_index (route, guint, j + 1)));
+            start = lrg_road_network_get_connections (network, from_id, FALSE);
+            end = lrg_road_network_get_connections (network, from_id, TRUE);
+            g_assert_true (g_list_find_custom (start, to_id, (GCompareFunc)g_strcmp0) != NULL ||
+                           g_list_find_custom (end, to_id, (GCompareFunc)g_strcmp0) != NULL);
+            g_list_free (start);
+            g_list_free (end);
+        }
+
+        g_array_unref (route);
+    }
+
+    g_free (queries);
+    g_free (positions);
+    g_free (costs);
+    g_free (found);
+    g_rand_free (rand);
+    g_object_unref (network);
+}
+
 /* ============================================================================
  * LrgTrafficAgent Tests
  * ============================================================================ */
@@ -656,6 +987,232 @@ test_traffic_agent_obstacles (void)
     g_object_unref (agent);
 }
 
+/* ============================================================================
+ * LrgTrafficManager Tests
+ * ============================================================================ */
+
+static LrgRoadNetwork *
+create_straight_network (guint n_roads)
+{
+    LrgRoadNetwork *network;
+    guint i;
+
+    network = lrg_road_network_new ();
+
+    for (i = 0; i < n_roads; i++)
+    {
+        g_autofree gchar *id = g_strdup_printf ("road%u", i);
+        LrgRoad *road = lrg_road_new (id);
+
+        lrg_road_add_waypoint (road, 0.0f, 0.0f, i * 40.0f, 8.0f, 30.0f);
+        lrg_road_add_waypoint (road, 400.0f, 0.0f, i * 40.0f, 8.0f, 30.0f);
+        lrg_road_network_add_road (network, road);
+    }
+
+    return network;
+}
+
+/* Adds a started agent driving along x; the manager keeps the only ref */
+static LrgTrafficAgent *
+add_managed_agent (LrgTrafficManager *manager,
+                   gfloat             x,
+                   gfloat             z,
+                   gboolean           reverse)
+{
+    LrgTrafficAgent *agent;
+    LrgVehicle *vehicle;
+
+    vehicle = lrg_vehicle_new ();
+    lrg_vehicle_set_position (vehicle, x, 0.0f, z);
+    lrg_vehicle_set_rotation (vehicle, 0.0f, reverse ? -G_PI / 2.0f : G_PI / 2.0f, 0.0f);
+
+    agent = lrg_traffic_agent_new ();
+    lrg_traffic_agent_set_vehicle (agent, vehicle);
+    g_assert_true (lrg_traffic_manager_add_agent (manager, agent));
+    lrg_traffic_agent_start (agent);
+
+    g_object_unref (vehicle);
+    g_object_unref (agent);
+
+    return agent;
+}
+
+static void
+on_manager_obstacle (LrgTrafficAgent *agent,
+                     gfloat           distance,
+                     gpointer         user_data)
+{
+    guint *count = user_data;
+
+    (void)agent;
+    (void)distance;
+
+    /* Managed agents must never signal from a worker */
+    g_assert_true (g_thread_self () == g_object_get_data (G_OBJECT (agent), "test-thread"));
+    (*count)++;
+}
+
+static void
+test_traffic_manager_leaders (void)
+{
+    LrgRoadNetwork *network;
+    LrgTrafficManager *manager;
+    LrgTrafficAgent *a10, *a30, *a60, *a64, *oncoming;
+    gfloat gap;
+    guint obstacle_count;
+
+    network = create_straight_network (1);
+    manager = lrg_traffic_manager_new (network);
+
+    a10 = add_managed_agent (manager, 10.0f, 0.0f, FALSE);
+    a30 = add_managed_agent (manager, 30.0f, 0.0f, FALSE);
+    a60 = add_managed_agent (manager, 60.0f, 0.0f, FALSE);
+    a64 = add_managed_agent (manager, 64.0f, 0.0f, FALSE);
+    oncoming = add_managed_agent (manager, 70.0f, 3.5f, TRUE);
+
+    g_assert_cmpuint (lrg_traffic_manager_get_agent_count (manager), ==, 5);
+    g_assert_false (lrg_traffic_manager_add_agent (manager, a10));
+    g_assert_true (lrg_traffic_agent_get_road_network (a10) == network);
+
+    obstacle_count = 0;
+    g_object_set_data (G_OBJECT (a60), "test-thread", g_thread_self ());
+    g_signal_connect (a60, "obstacle-detected",
+                      G_CALLBACK (on_manager_obstacle), &obstacle_count);
+
+    lrg_traffic_manager_update (manager, 0.016f);
+
+    g_assert_true (lrg_traffic_manager_get_leader (manager, a10, &gap) == a30);
+    g_assert_cmpfloat_with_epsilon (gap, 20.0f, 0.01f);
+    g_assert_true (lrg_traffic_manager_get_leader (manager, a60, &gap) == a64);
+    g_assert_cmpfloat_with_epsilon (gap, 4.0f, 0.01f);
+    g_assert_null (lrg_traffic_manager_get_leader (manager, a64, NULL));
+
+    /* The oncoming car is in the other lane and nobody leads it */
+    g_assert_null (lrg_traffic_manager_get_leader (manager, oncoming, NULL));
+
+    g_assert_cmpint (lrg_traffic_agent_get_state (a60), ==, LRG_TRAFFIC_STATE_STOPPED);
+    g_assert_cmpint (lrg_traffic_agent_get_state (a30), ==, LRG_TRAFFIC_STATE_DRIVING);
+    g_assert_cmpint (lrg_traffic_agent_get_state (a64), ==, LRG_TRAFFIC_STATE_DRIVING);
+    g_assert_cmpint (lrg_traffic_agent_get_state (oncoming), ==, LRG_TRAFFIC_STATE_DRIVING);
+    g_assert_cmpuint (obstacle_count, ==, 1);
+
+    g_object_unref (manager);
+    g_object_unref (network);
+}
+
+static LrgTrafficManager *
+create_busy_manager (LrgRoadNetwork *network,
+                     guint           max_threads)
+{
+    LrgTrafficManager *manager;
+    GRand *rand;
+    guint i;
+
+    manager = lrg_traffic_manager_new (network);
+    lrg_traffic_manager_set_max_threads (manager, max_threads);
+
+    rand = g_rand_new_with_seed (40);
+    for (i = 0; i < 600; i++)
+    {
+        guint road = g_rand_int_range (rand, 0, 20);
+        gfloat x = (gfloat)g_rand_double_range (rand, 1.0, 399.0);
+
+        add_managed_agent (manager, x, road * 40.0f, g_rand_boolean (rand));
+    }
+    g_rand_free (rand);
+
+    return manager;
+}
+
+static void
+test_traffic_manager_parallel (void)
+{
+    LrgRoadNetwork *network;
+    LrgTrafficManager *serial;
+    LrgTrafficManager *parallel;
+    GPtrArray *serial_agents;
+    GPtrArray *parallel_agents;
+    guint stopped;
+    guint i;
+
+    network = create_straight_network (20);
+    serial = create_busy_manager (network, 1);
+    parallel = create_busy_manager (network, 4);
+
+    lrg_traffic_manager_update (serial, 0.016f);
+    lrg_traffic_manager_update (parallel, 0.016f);
+
+    serial_agents = lrg_traffic_manager_get_agents (serial);
+    parallel_agents = lrg_traffic_manager_get_agents (parallel);
+    g_assert_cmpuint (serial_agents->len, ==, parallel_agents->len);
+
+    stopped = 0;
+    for (i = 0; i < serial_agents->len; i++)
+    {
+        LrgTrafficAgent *sa = g_ptr_array_index (serial_agents, i);
+        LrgTrafficAgent *pa = g_ptr_array_index (parallel_agents, i);
+        LrgTrafficAgent *sl;
+        LrgTrafficAgent *pl;
+        gfloat sgap = 0.0f;
+        gfloat pgap = 0.0f;
+
+        g_assert_cmpint (lrg_traffic_agent_get_state (sa), ==,
+                         lrg_traffic_agent_get_state (pa));
+
+        sl = lrg_traffic_manager_get_leader (serial, sa, &sgap);
+        pl = lrg_traffic_manager_get_leader (parallel, pa, &pgap);
+        g_assert_true ((sl == NULL) == (pl == NULL));
+        if (sl != NULL)
+            g_assert_cmpfloat (sgap, ==, pgap);
+
+        if (lrg_traffic_agent_get_state (sa) == LRG_TRAFFIC_STATE_STOPPED)
+            stopped++;
+    }
+
+    /* 30 cars per road direction is dense enough for some to queue */
+    g_assert_cmpuint (stopped, >, 0);
+
+    g_object_unref (serial);
+    g_object_unref (parallel);
+    g_object_unref (network);
+}
+
+static void
+test_traffic_manager_remove (void)
+{
+    LrgRoadNetwork *network;
+    LrgTrafficManager *manager;
+    LrgTrafficAgent *a10, *a30, *a60;
+    gfloat gap;
+
+    network = create_straight_network (1);
+    manager = lrg_traffic_manager_new (network);
+
+    a10 = add_managed_agent (manager, 10.0f, 0.0f, FALSE);
+    a30 = add_managed_agent (manager, 30.0f, 0.0f, FALSE);
+    a60 = add_managed_agent (manager, 60.0f, 0.0f, FALSE);
+    lrg_traffic_manager_update (manager, 0.016f);
+    g_assert_true (lrg_traffic_manager_get_leader (manager, a10, NULL) == a30);
+
+    g_object_ref (a30);
+    g_assert_true (lrg_traffic_manager_remove_agent (manager, a30));
+    g_assert_false (lrg_traffic_manager_remove_agent (manager, a30));
+    g_assert_cmpuint (lrg_traffic_manager_get_agent_count (manager), ==, 2);
+    g_assert_null (lrg_traffic_manager_get_leader (manager, a30, NULL));
+
+    lrg_traffic_manager_update (manager, 0.016f);
+    g_assert_true (lrg_traffic_manager_get_leader (manager, a10, &gap) == a60);
+    g_assert_cmpfloat_with_epsilon (gap, 50.0f, 0.01f);
+
+    /* A removed agent updates on its own again */
+    lrg_traffic_agent_update (a30, 0.016f);
+    g_assert_cmpint (lrg_traffic_agent_get_state (a30), ==, LRG_TRAFFIC_STATE_DRIVING);
+
+    g_object_unref (a30);
+    g_object_unref (manager);
+    g_object_unref (network);
+}
+
 /* ============================================================================
  * LrgVehicleCamera Tests
  * ============================================================================ */
@@ -910,6 +1467,11 @@ main (int   argc,
                 network_fixture_set_up, test_network_route, network_fixture_tear_down);
     g_test_add ("/vehicle/network/nearest", NetworkFixture, NULL,
                 network_fixture_set_up, test_network_nearest, network_fixture_tear_down);
+    g_test_add_func ("/vehicle/network/route-weighted", test_network_route_weighted);
+    g_test_add_func ("/vehicle/network/route-direction", test_network_route_direction);
+    g_test_add ("/vehicle/network/route-cache", NetworkFixture, NULL,
+                network_fixture_set_up, test_network_route_cache, network_fixture_tear_down);
+    g_test_add_func ("/vehicle/network/route-contraction", test_network_route_contraction);
 
     /* LrgTrafficAgent tests */
     g_test_add_func ("/vehicle/traffic-agent/new", test_traffic_agent_new);
@@ -917,6 +1479,11 @@ main (int   argc,
     g_test_add_func ("/vehicle/traffic-agent/start-stop", test_traffic_agent_start_stop);
     g_test_add_func ("/vehicle/traffic-agent/obstacles", test_traffic_agent_obstacles);
 
+    /* LrgTrafficManager tests */
+    g_test_add_func ("/vehicle/traffic-manager/leaders", test_traffic_manager_leaders);
+    g_test_add_func ("/vehicle/traffic-manager/parallel", test_traffic_manager_parallel);
+    g_test_add_func ("/vehicle/traffic-manager/remove", test_traffic_manager_remove);
+
     /* LrgVehicleCamera tests */
     g_test_add_func ("/vehicle/camera/new", test_vehicle_camera_new);
     g_test_add_func ("/vehicle/camera/modes", test_vehicle_camera_modes);
@@ -266,6 +266,159 @@ test_octree_remove (void)
     g_assert_cmpuint (lrg_octree_get_object_count (octree), ==, 0);
 }
 
+static LrgOctree *
+create_octree_grid (gint *objects)
+{
+    LrgOctree *octree;
+    LrgBoundingBox3D bounds = { { -100.0f, -100.0f, -100.0f }, { 100.0f, 100.0f, 100.0f } };
+    gint i;
+
+    /* 64 unit boxes along the x axis, spaced 3 units apart */
+    octree = lrg_octree_new (&bounds);
+    lrg_octree_set_max_objects_per_node (octree, 2);
+
+    for (i = 0; i < 64; i++)
+    {
+        LrgBoundingBox3D box;
+        gfloat x = -96.0f + i * 3.0f;
+
+        box.min.x = x - 0.5f;
+        box.min.y = -0.5f;
+        box.min.z = -0.5f;
+        box.max.x = x + 0.5f;
+        box.max.y = 0.5f;
+        box.max.z = 0.5f;
+
+        objects[i] = i;
+        lrg_octree_insert (octree, &objects[i], &box);
+    }
+
+    return octree;
+}
+
+static void
+test_octree_k_nearest (void)
+{
+    g_autoptr(LrgOctree) octree = NULL;
+    g_autoptr(GPtrArray) results = NULL;
+    gint objects[64];
+    GrlVector3 point = { 0.5f, 0.0f, 0.0f };
+    guint n;
+
+    octree = create_octree_grid (objects);
+    results = g_ptr_array_new ();
+
+    /* Centers at 0 (i=32), 3 (i=33), -3 (i=31), 6 (i=34) */
+    n = lrg_octree_query_k_nearest_into (octree, &point, 3, results);
+    g_assert_cmpuint (n, ==, 3);
+    g_assert_true (g_ptr_array_index (results, 0) == &objects[32]);
+    g_assert_true (g_ptr_array_index (results, 1) == &objects[33]);
+    g_assert_true (g_ptr_array_index (results, 2) == &objects[31]);
+
+    /* Far outside any populated node still finds the closest object */
+    point.x = 99.0f;
+    point.y = 90.0f;
+    g_assert_true (lrg_octree_query_nearest (octree, &point) == &objects[63]);
+
+    /* Buffer is appended to, not replaced */
+    n = lrg_octree_query_k_nearest_into (octree, &point, 100, results);
+    g_assert_cmpuint (n, ==, 64);
+    g_assert_cmpuint (results->len, ==, 67);
+}
+
+static void
+test_octree_frustum (void)
+{
+    g_autoptr(LrgOctree) octree = NULL;
+    g_autoptr(GPtrArray) results = NULL;
+    gint objects[64];
+    /* Slab 0 <= x <= 10, |y| <= 1, |z| <= 1 */
+    const gfloat planes[24] = {
+         1.0f,  0.0f,  0.0f,  0.0f,
+        -1.0f,  0.0f,  0.0f, 10.0f,
+         0.0f,  1.0f,  0.0f,  1.0f,
+         0.0f, -1.0f,  0.0f,  1.0f,
+         0.0f,  0.0f,  1.0f,  1.0f,
+         0.0f,  0.0f, -1.0f,  1.0f
+    };
+    guint n;
+
+    octree = create_octree_grid (objects);
+    results = g_ptr_array_new ();
+
+    /* Centers 0, 3, 6, 9 are inside; -3 and 12 are not */
+    n = lrg_octree_query_frustum_into (octree, planes, G_N_ELEMENTS (planes), results);
+    g_assert_cmpuint (n, ==, 4);
+    g_assert_true (g_ptr_array_find (results, &objects[32], NULL));
+    g_assert_true (g_ptr_array_find (results, &objects[35], NULL));
+    g_assert_false (g_ptr_array_find (results, &objects[31], NULL));
+    g_assert_false (g_ptr_array_find (results, &objects[36], NULL));
+}
+
+static void
+test_octree_raycast (void)
+{
+    g_autoptr(LrgOctree) octree = NULL;
+    g_autoptr(GPtrArray) results = NULL;
+    gint objects[64];
+    GrlVector3 origin = { 1.5f, 0.0f, 0.0f };
+    GrlVector3 direction = { 2.0f, 0.0f, 0.0f };
+    GrlVector3 up = { 0.0f, 1.0f, 0.0f };
+    gfloat distance;
+    gpointer hit;
+
+    octree = create_octree_grid (objects);
+    results = g_ptr_array_new ();
+
+    /* First box along +x from 1.5 is the one centered at 3 */
+    hit = lrg_octree_raycast (octree, &origin, &direction, 1000.0f, &distance);
+    g_assert_true (hit == &objects[33]);
+    g_assert_cmpfloat_with_epsilon (distance, 1.0f, 0.0001f);
+
+    /* Short ray misses everything */
+    g_assert_null (lrg_octree_raycast (octree, &origin, &direction, 0.5f, NULL));
+
+    /* Ray straight up misses the row */
+    g_assert_null (lrg_octree_raycast (octree, &origin, &up, 1000.0f, NULL));
+
+    /* Ray query within 9.5 units: centers 3, 6, 9 */
+    g_assert_cmpuint (lrg_octree_query_ray_into (octree, &origin, &direction,
+                                                 9.5f, results), ==, 3);
+}
+
+static void
+test_octree_loose_update (void)
+{
+    g_autoptr(LrgOctree) octree = NULL;
+    g_autoptr(GPtrArray) results = NULL;
+    gint objects[64];
+    LrgBoundingBox3D moved = { { 1.0f, -0.5f, -0.5f }, { 2.0f, 0.5f, 0.5f } };
+    LrgBoundingBox3D query = { { 1.2f, -0.1f, -0.1f }, { 1.8f, 0.1f, 0.1f } };
+    LrgBoundingBox3D distant = { { 80.0f, 80.0f, 80.0f }, { 81.0f, 81.0f, 81.0f } };
+    guint node_count;
+
+    octree = create_octree_grid (objects);
+    results = g_ptr_array_new ();
+
+    lrg_octree_set_looseness (octree, 2.0f);
+    g_assert_cmpfloat (lrg_octree_get_looseness (octree), ==, 2.0f);
+    g_assert_cmpuint (lrg_octree_get_object_count (octree), ==, 64);
+
+    /* Small move stays within its loose node: structure untouched */
+    node_count = lrg_octree_get_node_count (octree);
+    g_assert_true (lrg_octree_update (octree, &objects[32], &moved));
+    g_assert_cmpuint (lrg_octree_get_node_count (octree), ==, node_count);
+    g_assert_cmpuint (lrg_octree_query_box_into (octree, &query, results), ==, 1);
+    g_assert_true (g_ptr_array_index (results, 0) == &objects[32]);
+
+    /* Large move relocates the object */
+    g_assert_true (lrg_octree_update (octree, &objects[32], &distant));
+    g_ptr_array_set_size (results, 0);
+    g_assert_cmpuint (lrg_octree_query_box_into (octree, &query, results), ==, 0);
+    g_assert_cmpuint (lrg_octree_query_box_into (octree, &distant, results), ==, 1);
+    g_assert_cmpuint (lrg_octree_get_object_count (octree), ==, 64);
+}
+
 /* =============================================================================
  * Portal Tests
  * =============================================================================
@@ -549,6 +702,238 @@ test_portal_system_clear (void)
     g_assert_cmpuint (lrg_portal_system_get_portal_count (system), ==, 0);
 }
 
+/* =============================================================================
+ * SectorStreamer Tests
+ * =============================================================================
+ */
+
+/*
+ * create_sector_chain:
+ *
+ * Four 100-unit sectors along X ("s0" .. "s3"), each connected to the
+ * next through a portal.
+ */
+static LrgPortalSystem *
+create_sector_chain (void)
+{
+    LrgPortalSystem *system;
+    guint i;
+
+    system = lrg_portal_system_new ();
+
+    for (i = 0; i < 4; i++)
+    {
+        g_autoptr(LrgSector) sector = NULL;
+        g_autofree gchar *id = g_strdup_printf ("s%u", i);
+        gfloat x = i * 100.0f;
+
+        sector = lrg_sector_new_box (id, x, 0.0f, 0.0f, x + 100.0f, 50.0f, 100.0f);
+
+        if (i > 0)
+        {
+            g_autofree gchar *portal_id = g_strdup_printf ("p%u", i - 1);
+            lrg_sector_add_portal (sector, portal_id);
+        }
+        if (i < 3)
+        {
+            g_autofree gchar *portal_id = g_strdup_printf ("p%u", i);
+            g_autofree gchar *next_id = g_strdup_printf ("s%u", i + 1);
+            g_autoptr(LrgBoundingBox3D) bounds = NULL;
+            g_autoptr(LrgPortal) portal = NULL;
+
+            lrg_sector_add_portal (sector, portal_id);
+            bounds = lrg_bounding_box3d_new (x + 100.0f, 0.0f, 40.0f,
+                                             x + 100.0f, 50.0f, 60.0f);
+            portal = lrg_portal_new (portal_id, bounds, id, next_id);
+            lrg_portal_system_add_portal (system, portal);
+        }
+
+        lrg_portal_system_add_sector (system, sector);
+    }
+
+    return system;
+}
+
+static void
+on_sector_streamed (LrgSectorStreamer *streamer,
+                    const gchar       *sector_id,
+                    gpointer           content,
+                    gpointer           user_data)
+{
+    guint *count = user_data;
+
+    (*count)++;
+}
+
+static gpointer
+load_sector_name (const LrgSector *sector,
+                  gpointer         user_data,
+                  GCancellable    *cancellable,
+                  GError         **error)
+{
+    return g_strdup (lrg_sector_get_id (sector));
+}
+
+static void
+test_portal_system_adjacent_sectors (void)
+{
+    g_autoptr(LrgPortalSystem) system = NULL;
+    g_autoptr(GPtrArray) adjacent = NULL;
+
+    system = create_sector_chain ();
+
+    adjacent = lrg_portal_system_get_adjacent_sectors (system, "s1");
+    g_assert_cmpuint (adjacent->len, ==, 2);
+    g_assert_true (g_ptr_array_find_with_equal_func (adjacent, "s0", g_str_equal, NULL));
+    g_assert_true (g_ptr_array_find_with_equal_func (adjacent, "s2", g_str_equal, NULL));
+}
+
+static void
+test_sector_streamer_prefetch (void)
+{
+    g_autoptr(LrgPortalSystem) system = NULL;
+    g_autoptr(LrgSectorStreamer) streamer = NULL;
+    GrlVector3 camera = { 50.0f, 25.0f, 50.0f };
+    guint loaded = 0;
+
+    system = create_sector_chain ();
+    streamer = lrg_sector_streamer_new (system);
+    g_signal_connect (streamer, "sector-loaded", G_CALLBACK (on_sector_streamed), &loaded);
+
+    /* No load function: sectors become resident synchronously */
+    lrg_sector_streamer_update (streamer, &camera);
+
+    g_assert_true (lrg_sector_streamer_is_sector_loaded (streamer, "s0"));
+    g_assert_true (lrg_sector_streamer_is_sector_loaded (streamer, "s1"));
+    g_assert_false (lrg_sector_streamer_is_sector_loaded (streamer, "s2"));
+    g_assert_cmpuint (loaded, ==, 2);
+
+    lrg_sector_streamer_set_prefetch_depth (streamer, 2);
+    lrg_sector_streamer_update (streamer, &camera);
+
+    g_assert_true (lrg_sector_streamer_is_sector_loaded (streamer, "s2"));
+    g_assert_false (lrg_sector_streamer_is_sector_loaded (streamer, "s3"));
+    g_assert_cmpuint (lrg_sector_streamer_get_loaded_count (streamer), ==, 3);
+}
+
+static void
+test_sector_streamer_budget (void)
+{
+    g_autoptr(LrgPortalSystem) system = NULL;
+    g_autoptr(LrgSectorStreamer) streamer = NULL;
+    GrlVector3 start = { 50.0f, 25.0f, 50.0f };
+    GrlVector3 middle = { 150.0f, 25.0f, 50.0f };
+    GrlVector3 end = { 350.0f, 25.0f, 50.0f };
+    guint unloaded = 0;
+
+    system = create_sector_chain ();
+    streamer = lrg_sector_streamer_new (system);
+    lrg_sector_streamer_set_max_resident (streamer, 3);
+    g_signal_connect (streamer, "sector-unloaded", G_CALLBACK (on_sector_streamed), &unloaded);
+
+    lrg_sector_streamer_update (streamer, &start);
+    g_assert_cmpuint (lrg_sector_streamer_get_loaded_count (streamer), ==, 2);
+
+    /* s0, s1 and s2 fit the budget, nothing is evicted */
+    lrg_sector_streamer_update (streamer, &middle);
+    g_assert_cmpuint (lrg_sector_streamer_get_loaded_count (streamer), ==, 3);
+    g_assert_cmpuint (unloaded, ==, 0);
+
+    /* s3 and s2 are wanted; the farthest cached sector makes room */
+    lrg_sector_streamer_update (streamer, &end);
+    g_assert_cmpuint (lrg_sector_streamer_get_loaded_count (streamer), ==, 3);
+    g_assert_cmpuint (unloaded, ==, 1);
+    g_assert_false (lrg_sector_streamer_is_sector_loaded (streamer, "s0"));
+    g_assert_true (lrg_sector_streamer_is_sector_loaded (streamer, "s1"));
+    g_assert_true (lrg_sector_streamer_is_sector_loaded (streamer, "s3"));
+
+    lrg_sector_streamer_unload_all (streamer);
+    g_assert_cmpuint (lrg_sector_streamer_get_loaded_count (streamer), ==, 0);
+    g_assert_cmpuint (unloaded, ==, 4);
+}
+
+static void
+test_sector_streamer_async (void)
+{
+    g_autoptr(LrgPortalSystem) system = NULL;
+    g_autoptr(LrgSectorStreamer) streamer = NULL;
+    GrlVector3 camera = { 50.0f, 25.0f, 50.0f };
+    guint loaded = 0;
+    gint64 deadline;
+
+    system = create_sector_chain ();
+    streamer = lrg_sector_streamer_new (system);
+    lrg_sector_streamer_set_load_func (streamer, load_sector_name, NULL, NULL, g_free);
+    lrg_sector_streamer_set_max_concurrent_loads (streamer, 1);
+    g_signal_connect (streamer, "sector-loaded", G_CALLBACK (on_sector_streamed), &loaded);
+
+    lrg_sector_streamer_update (streamer, &camera);
+
+    /* The visible sector is loaded first, one load at a time */
+    g_assert_true (lrg_sector_streamer_is_sector_loading (streamer, "s0"));
+    g_assert_cmpuint (lrg_sector_streamer_get_loading_count (streamer), ==, 1);
+    g_assert_null (lrg_sector_streamer_get_sector_content (streamer, "s0"));
+
+    deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+    while (loaded < 2 && g_get_monotonic_time () < deadline)
+        g_main_context_iteration (NULL, TRUE);
+
+    g_assert_cmpuint (loaded, ==, 2);
+    g_assert_cmpuint (lrg_sector_streamer_get_loading_count (streamer), ==, 0);
+    g_assert_cmpstr (lrg_sector_streamer_get_sector_content (streamer, "s0"), ==, "s0");
+    g_assert_cmpstr (lrg_sector_streamer_get_sector_content (streamer, "s1"), ==, "s1");
+}
+
+static gpointer
+load_sector_fail (const LrgSector *sector,
+                  gpointer         user_data,
+                  GCancellable    *cancellable,
+                  GError         **error)
+{
+    g_atomic_int_inc ((gint *)user_data);
+    g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED, "unavailable");
+    return NULL;
+}
+
+static void
+test_sector_streamer_load_failed (void)
+{
+    g_autoptr(LrgPortalSystem) system = NULL;
+    g_autoptr(LrgSectorStreamer) streamer = NULL;
+    GrlVector3 camera = { 50.0f, 25.0f, 50.0f };
+    gint attempts = 0;
+    guint failed = 0;
+    guint update;
+
+    system = create_sector_chain ();
+    streamer = lrg_sector_streamer_new (system);
+    lrg_sector_streamer_set_prefetch_depth (streamer, 0);
+    lrg_sector_streamer_set_load_func (streamer, load_sector_fail, &attempts, NULL, NULL);
+    g_signal_connect (streamer, "sector-load-failed", G_CALLBACK (on_sector_streamed), &failed);
+
+    /* A failing sector is tried once per update, not again straight away */
+    for (update = 1; update <= 3; update++)
+    {
+        gint64 deadline;
+
+        lrg_sector_streamer_update (streamer, &camera);
+
+        deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+        while (failed < update && g_get_monotonic_time () < deadline)
+            g_main_context_iteration (NULL, TRUE);
+
+        /* Let any retry that would have been queued run */
+        while (g_main_context_iteration (NULL, FALSE));
+        g_usleep (10000);
+        while (g_main_context_iteration (NULL, FALSE));
+
+        g_assert_cmpuint (failed, ==, update);
+        g_assert_cmpint (g_atomic_int_get (&attempts), ==, (gint)update);
+        g_assert_cmpuint (lrg_sector_streamer_get_loading_count (streamer), ==, 0);
+        g_assert_false (lrg_sector_streamer_is_sector_loaded (streamer, "s0"));
+    }
+}
+
 /* =============================================================================
  * Main
  * =============================================================================
@@ -580,6 +965,10 @@ main (int   argc,
     g_test_add_func ("/world3d/octree/insert", test_octree_insert);
     g_test_add_func ("/world3d/octree/query-box", test_octree_query_box);
     g_test_add_func ("/world3d/octree/remove", test_octree_remove);
+    g_test_add_func ("/world3d/octree/k-nearest", test_octree_k_nearest);
+    g_test_add_func ("/world3d/octree/frustum", test_octree_frustum);
+    g_test_add_func ("/world3d/octree/raycast", test_octree_raycast);
+    g_test_add_func ("/world3d/octree/loose-update", test_octree_loose_update);
 
     /* Portal tests */
     g_test_add_func ("/world3d/portal/new", test_portal_new);
@@ -601,6 +990,13 @@ main (int   argc,
     g_test_add_func ("/world3d/portal-system/sectors", test_portal_system_sectors);
     g_test_add_func ("/world3d/portal-system/visibility", test_portal_system_visibility);
     g_test_add_func ("/world3d/portal-system/clear", test_portal_system_clear);
+    g_test_add_func ("/world3d/portal-system/adjacent-sectors", test_portal_system_adjacent_sectors);
+
+    /* SectorStreamer tests */
+    g_test_add_func ("/world3d/sector-streamer/prefetch", test_sector_streamer_prefetch);
+    g_test_add_func ("/world3d/sector-streamer/budget", test_sector_streamer_budget);
+    g_test_add_func ("/world3d/sector-streamer/async", test_sector_streamer_async);
+    g_test_add_func ("/world3d/sector-streamer/load-failed", test_sector_streamer_load_failed);
 
     return g_test_run ();
 }